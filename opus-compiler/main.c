@@ -5,42 +5,160 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include "parser.h"
-#include "analyzer.h"
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include "module.h"
+#include "pass.h"
+#include "toolchain.h"
+#include "prepared.h"
+#include "image.h"
+#include "exporter.h"
+
+// Writes the bytecode of a program compiled on its own into a module, which is '<source_file>.opusc' by default
+static int emitBytecodeModule(const char *sourcePath, const CompileOptions *options, const char *bytecodePath) {
+    char defaultPath[FILENAME_MAX];
+    size_t length = strlen(sourcePath);
+
+    if (!bytecodePath) {
+        int isOpus = length >= 5 && strcmp(sourcePath + length - 5, ".opus") == 0;
+        if (length + 7 > sizeof(defaultPath)) return 0;
+        snprintf(defaultPath, sizeof(defaultPath), "%s%s", sourcePath, isOpus ? "c" : ".opusc");
+        bytecodePath = defaultPath;
+    }
+
+    DiagnosticList *diagnostics = initDiagnosticList();
+    PreparedProgram *program = prepareOpusProgram(sourcePath, options->level, options->isOverflowChecked, NULL,
+                                                  diagnostics);
+    displayDiagnostics(diagnostics);
+    freeDiagnosticList(diagnostics);
+
+    size_t size = program ? writeVMImage(program->bytecode, NULL, 0, bytecodePath) : 0;
+    if (size > 0) printf("[Bytecode] Wrote %zu bytes into '%s'.\n", size, bytecodePath);
+
+    freePreparedProgram(program);
+    return size > 0;
+}
+
+// Maps a bytecode module and executes it on the virtual machine, which is only given inputs by 'opus-run'
+static int runBytecodeModule(const char *bytecodePath) {
+    PreparedProgram *program = restorePreparedProgram(bytecodePath);
+    if (!program) return 0;
+
+    if (program->bytecode->inputCount > 0 && !program->snapshot) {
+        fprintf(stderr, "[RunError]: Module '%s' has %d inputs, which are given by 'opus-run'.\n", bytecodePath,
+                program->bytecode->inputCount);
+        freePreparedProgram(program);
+        return 0;
+    }
+
+    PreparedExecution *execution = initPreparedExecution(program);
+    int result = execution && executePreparedProgram(execution);
+
+    if (result) displayPreparedGlobals(execution);
+    else if (execution) {
+        Location location = execution->context.errorLocation;
+        fprintf(stderr, "[RuntimeError]: %s at location %d:%d.\n", execution->context.errorMessage, location.line,
+                location.column);
+    }
+
+    freePreparedExecution(execution);
+    freePreparedProgram(program);
+    return result;
+}
 
 int main(int argc, char *argv[]) {
+    CompileOptions options = {PASS_DEFAULT_LEVEL, NULL, 0, 1, NULL, NULL, 0};
+    const char *sourcePath = NULL;
+    int isWatching = 0;
+    int isBytecodeEmitted = 0;
+    const char *bytecodePath = NULL;
+    const char *metricsSocketPath = NULL;
+
+#ifndef _WIN32
+    // Independent modules are compiled on every processor by default
+    long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+    if (processorCount > 0) options.jobCount = (int) processorCount;
+#endif
+
+    // Options come before the file to compile, and the last optimization level given wins
+    for (int index = 1; index < argc; index++) {
+        const char *argument = argv[index];
+
+        if (argument[0] == '-' && argument[1] == 'O' && argument[2] >= '0' && argument[2] <= '0' + PASS_MAX_LEVEL &&
+            argument[3] == '\0') options.level = argument[2] - '0';
+        else if (strncmp(argument, "--passes=", 9) == 0) options.passList = argument + 9;
+        else if (strcmp(argument, "--stats") == 0) options.isStatisticsDisplayed = 1;
+        else if (strcmp(argument, "--watch") == 0) isWatching = 1;
+        else if (strcmp(argument, "--checked") == 0) options.isOverflowChecked = 1;
+        else if (strncmp(argument, "--emit-c=", 9) == 0 && argument[9]) options.cDirectory = argument + 9;
+        else if (strcmp(argument, "--emit-bytecode") == 0) isBytecodeEmitted = 1;
+        else if (strncmp(argument, "--emit-bytecode=", 16) == 0 && argument[16]) {
+            isBytecodeEmitted = 1;
+            bytecodePath = argument + 16;
+        }
+        else if (strncmp(argument, "--metrics-socket=", 17) == 0 && argument[17]) metricsSocketPath = argument + 17;
+        else if (strncmp(argument, "-j", 2) == 0 && atoi(argument + 2) > 0) options.jobCount = atoi(argument + 2);
+        else if (argument[0] != '-' && !sourcePath) sourcePath = argument;
+        else {
+            sourcePath = NULL;
+            break;
+        }
+    }
+
     // Ensure the user provides a file as an argument to compile
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <source_file.opus>\n", argv[0]);
+    if (!sourcePath) {
+        fprintf(stderr, "Usage: %s [-O0|-O1|-O2|-O3] [--passes=fold,peephole,...] [--stats] [-j<jobs>] [--watch] "
+                        "[--checked] [--emit-c=<directory>] [--emit-bytecode[=<module.opusc>]] "
+                        "[--metrics-socket=<path>] <source_file.opus|module.opusc>\n", argv[0]);
         return EXIT_FAILURE;
     }
 
-    // Safely open given Opus source code by using function openOpusSourceCode()
-    FILE *sourceCode = openOpusSourceCode(argv[1]);
-    if (!sourceCode) return EXIT_FAILURE;
-    
-    printf("Compiling...\n");
+    // A module of bytecode is executed directly from its mapping, without being compiled again
+    if (isVMImage(sourcePath)) return runBytecodeModule(sourcePath) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    // The passes named explicitly are checked once, before any module is compiled
+    PassManager *passManager = initPassManager(options.level);
+    int isPipelineValid = passManager && (!options.passList || parsePassPipeline(passManager, options.passList));
+    freePassManager(passManager);
+    if (!isPipelineValid) return EXIT_FAILURE;
+
+    // A program emitted as bytecode is compiled on its own, since the virtual machine links no other module
+    if (isBytecodeEmitted) {
+        return emitBytecodeModule(sourcePath, &options, bytecodePath) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Every module is emitted as C into the same directory, which keeps the objects compiled from it
+    if (options.cDirectory && !prepareCDirectory(options.cDirectory)) return EXIT_FAILURE;
 
-    // Initialize the Parser and try to generate the AST for the provided sourceCode
-    Parser *parser = initParser(); 
-    parser->currentToken = advanceParser(parser, sourceCode);
-    ASTNode *root = parseProgram(parser, sourceCode);
+    // Compile the file again on every change, where only the statements affected by an edit are analyzed again, and
+    // serve the metrics of the compilations for as long as the file is watched
+    if (isWatching) {
+        MetricsExporter *exporter = metricsSocketPath ? startMetricsExporter(metricsSocketPath) : NULL;
+        if (metricsSocketPath && !exporter) return EXIT_FAILURE;
+
+        int isWatched = watchModules(sourcePath, &options);
+        stopMetricsExporter(exporter);
+        return isWatched ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
-    // Perform semantic analyze only if there is no parsing error 
-    if (parser->parseError != PARSE_ERROR_NONE) return EXIT_FAILURE;
+    // Compile the imported modules first, so that the compiled file only needs their interfaces
+    ModuleGraph *graph = discoverModules(sourcePath);
+    if (!graph) return EXIT_FAILURE;
+    if (options.isStatisticsDisplayed) displaySourceLoadStatistics(&graph->loadStatistics);
+
+    if (!buildModules(graph, &options)) {
+        freeModuleGraph(graph);
+        return EXIT_FAILURE;
+    }
 
-    // Semantically analyze the Opus AST generated by the Opus parser
-    SymbolTable *symbolTable = initSymbolTable();
-    Analyzer *analyzer = initAnalyzer(root, symbolTable);
-    printf("Analyzing...\n");
+    // Only a file that could not be opened or parsed fails, while semantic errors are reported by the compilation
+    int result = compileModule(graph, 0, &options);
 
-    // Display the symbol table if semantic analysis was successful
-    if (analyzeProgram(analyzer, root)) displaySymbolTable(symbolTable);
-    else printf("Semantic analysis failed. Errors detected.\n");
+    // The C code of every module is compiled into an executable, which fails unless every module has been emitted
+    if (options.cDirectory) result = (result == 1 && linkModules(graph, &options)) ? 1 : -1;
+    freeModuleGraph(graph);
 
-    // Close the provided sourceCode after parsing and free resources
-    fclose(sourceCode);
-    freeAST(root);
-    
-    return EXIT_SUCCESS;
+    return result < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
 }
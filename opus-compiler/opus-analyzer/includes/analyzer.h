@@ -13,15 +13,17 @@
 
 #include "ast.h"
 #include "symbol.h"
+#include "diagnostic.h"
 
 /// Enumerates possible semantic errors encountered during analysis.
 typedef enum {
     ANALYZER_ERROR_NONE,                       /// No semantic error occurred.
     ANALYZER_ERROR_UNDECLARED_VARIABLE,        /// An undeclared variable was referenced in the source code.
     ANALYZER_ERROR_REDECLARED_VARIABLE,        /// A variable was declared more than once in the same scope.
-    ANALYZER_ERROR_IMMUTABLE_MODIFICATION,     /// Modifying an immutable instance like a constant.
     ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH,   /// Type missmatch for operators.
     ANALYZER_ERROR_INVALID_CONDITION,          /// Invalid condition statement.
+    ANALYZER_ERROR_INVALID_CONVERSION,         /// Invalid conversion into an integer type (e.g. "Int8(x)").
+    ANALYZER_ERROR_INVALID_VECTOR,             /// Invalid construction of a vector (e.g. "Vec4f(x: 1.0)").
 } AnalyzerError;
 
 /// Represents the semantic analyzer, which holds context for analyzing
@@ -29,6 +31,9 @@ typedef enum {
 typedef struct {
     SymbolTable *symbolTable;      /// Pointer to the symbol table used during semantic analysis.
     AnalyzerError analyzerError;   /// Holds the current error state of the analyzer.
+    int dynamicNamespace;          /// The innermost namespace that might not be executed, or 0 if there is none.
+    struct QueryMemo *recording;   /// The memo of the top-level statement being executed incrementally (if any).
+    DiagnosticList *diagnostics;   /// The list receiving the errors, or NULL to print them (see diagnostic.h).
 } Analyzer;
 
 /// Analyzes the semantic correctness of an entire Opus program AST.
@@ -65,9 +70,10 @@ int analyzeDeclarationStatement(Analyzer *analyzer, ASTNode *node);
 
 /// Analyzes an assignment statement for semantic correctness.
 ///
-/// This function verifies that the target identifier exists and is mutable (if reassigned),
-/// and that the right-hand expression is type compatible. If the RHS is a constant expression,
-/// the value may be propagated into the symbol table.
+/// This function verifies that the target identifier exists and that the right-hand expression is type
+/// compatible. If the RHS is a constant expression and the assignment is executed on every path that reaches
+/// the following statements, the value is propagated into the symbol table. Whether an immutable symbol is
+/// assigned twice depends on control flow, so it is checked by the definite assignment analysis over the IR.
 ///
 /// @param analyzer Pointer to the Analyzer instance.
 /// @param node Pointer to the AST node representing the assignment.
@@ -85,10 +91,32 @@ int analyzeAssignmentStatement(Analyzer *analyzer, ASTNode *node);
 ///
 int analyzeExpression(Analyzer *analyzer, ASTNode *node);
 
+/// Analyzes each statement of a code block in order.
+///
+/// @param analyzer Pointer to the Analyzer instance.
+/// @param node Pointer to the AST node representing the code block.
+/// @return 1 (True) if every statement is semantically valid; 0 (False) if an error occurs.
+///
 int analyzeCodeBlock(Analyzer *analyzer, ASTNode *node);
 
+/// Analyzes a conditional statement, where a branch is eliminated if the condition is folded. Otherwise both
+/// branches are analyzed as dynamic namespaces, so that the values assigned inside are not propagated afterward.
+/// The branches of an invalid condition are analyzed as well, so that their errors are reported in the same pass.
+///
+/// @param analyzer Pointer to the Analyzer instance.
+/// @param node Pointer to the AST node representing the conditional statement.
+/// @return 1 (True) if the statement is semantically valid; 0 (False) if an error occurs.
+///
 int analyzeConditionalStatement(Analyzer *analyzer, ASTNode *node);
 
+/// Marks every symbol that might be assigned by a statement as not foldable, which is used for the statements that
+/// are not analyzed (e.g. loops) and for function calls, since a function could assign any mutable global.
+///
+/// @param analyzer Pointer to the Analyzer instance.
+/// @param node Pointer to the AST node representing the statement.
+///
+void invalidateAssignedSymbols(Analyzer *analyzer, ASTNode *node);
+
 /// Evaluates a binary expression at compile time and folds it into a constant node.
 ///
 /// This function assumes the expression is valid and both child nodes are constant.
@@ -125,12 +153,35 @@ void reportAnalyzerError(Analyzer *analyzer, ASTNode *node);
 Analyzer *initAnalyzer(ASTNode *node, SymbolTable *symbolTable);
 
 /// Determines whether a given type name represents a numeric type.
-/// This helper checks if the type is "Int" or "Float", which are considered numeric
-/// and usable in arithmetic expressions in the Opus language.
+/// This helper checks if the type is "Float" or an integer ("Int" or a sized integer such as "UInt8"),
+/// which are considered numeric and usable in arithmetic expressions in the Opus language.
 ///
 /// @param type A string representing a type name.
 /// @return 1 (True) if the type is numeric; 0 (False) otherwise.
 ///
 int isNumeric(const char* type);
 
+/// Gets the width of an integer type in bits, where "Int32" is another name of "Int".
+///
+/// @param type A string representing a type name.
+/// @return The width (32 for an Int), or 0 if the type is not an integer.
+///
+int getIntegerWidth(const char *type);
+
+/// Gets the value of an integer from the 32 bits holding it, where a UInt32 above Int.max has the sign bit set.
+///
+/// @param type The integer type.
+/// @param bits The bits holding the integer (e.g. `symbolValue.integerValue`).
+/// @return The value of the integer.
+///
+long long getIntegerValue(const char *type, int bits);
+
+/// Gets the number of lanes of a vector type ("Vec4f", "Vec8f", "Vec4i" or "Vec8i", whose lanes are Float or Int) or
+/// of a mask type ("Mask4" or "Mask8", whose lanes are Bool and which are given by comparing vectors).
+///
+/// @param type A string representing a type name.
+/// @return The number of lanes (4 or 8), or 0 if the type is neither a vector nor a mask.
+///
+int getVectorLanes(const char *type);
+
 #endif
@@ -0,0 +1,147 @@
+// query.h
+//
+// Incremental semantic analysis for the Opus programming language. The analysis of each top-level statement is a
+// memoized query, whose result is the state of the symbols it declares or assigns, the types and the folded values of
+// its expressions, and the errors it reports. While a query is executed it records what it reads: the revision of each
+// symbol it looks up (or its absence), and the revisions of the mutable globals if it calls a function. Analyzing the
+// program again (e.g. after an edit) reuses the memo of a statement whose syntax is unchanged and whose reads still
+// have the same revisions, and only executes the other statements. A symbol keeps its revision as long as its state
+// is the same, so re-executing an edited statement that ends up assigning the same values invalidates nothing after
+// it, and the work done after a local edit is proportional to the statements depending on it.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <stdint.h>
+#include "analyzer.h"
+
+#define QUERY_SCOPE_IDENTIFIER   "<scope>"
+
+/// A dependency of a query, that is a symbol it has looked up, or the mutable globals a call could assign.
+typedef struct {
+    char identifier[LEXEME_LENGTH];   /// The symbol looked up, or QUERY_SCOPE_IDENTIFIER for the mutable globals.
+    uint64_t revision;                /// The revision of the symbol (0 if undeclared), or the hash of the revisions.
+} QueryRead;
+
+/// The state of a symbol after a query has declared or assigned it.
+typedef struct {
+    Symbol symbol;       /// The state of the symbol, whose revision is the revision of this state.
+    int isDeclared;      /// Whether the query has declared the symbol (rather than assigned an existing one).
+    Symbol *source;      /// The symbol in the symbol table, only valid while the query is executed.
+} QueryWrite;
+
+/// The type and the folded value of an AST node, as annotated by the analyzer.
+typedef struct {
+    char inferredType[LEXEME_LENGTH];
+    int isFoldable;
+    union {
+        int integerValue;
+        float floatingValue;
+        int booleanValue;
+        char stringLiteral[LEXEME_LENGTH];
+        int integerLanes[8];
+        float floatingLanes[8];
+    } nodeValue;
+} QueryAnnotation;
+
+/// An error reported by a query, located by the pre-order index of its node within the statement.
+typedef struct {
+    AnalyzerError error;
+    int nodeIndex;
+    ASTNode *node;       /// The reported node, only valid while the query is executed.
+} QueryDiagnostic;
+
+/// The memoized analysis of a top-level statement.
+typedef struct QueryMemo {
+    uint64_t syntaxHash;              /// The hash of the tokens of the statement, relative to its first line.
+    int line;                         /// The first line of the statement when it was executed.
+    int result;                       /// Whether the statement is semantically valid.
+    uint64_t scopeHash;               /// The hash of the revisions of the mutable globals before the statement.
+
+    QueryRead *reads;                 /// The dependencies of the statement.
+    int readCount, readCapacity;
+    QueryWrite *writes;               /// The symbols declared or assigned by the statement.
+    int writeCount, writeCapacity;
+    QueryAnnotation *annotations;     /// The annotation of each node of the statement in pre-order.
+    int nodeCount;
+    QueryDiagnostic *diagnostics;     /// The errors reported by the statement.
+    int diagnosticCount, diagnosticCapacity;
+} QueryMemo;
+
+/// The memos of the statements of a program, kept from one analysis to the next.
+typedef struct {
+    uint64_t revision;        /// The latest revision, incremented by each new state of a symbol.
+    QueryMemo **memos;        /// The memos of the statements analyzed last, in order.
+    int memoCount;
+    int memoCapacity;
+    QueryWrite *inputs;       /// The symbols declared before the analysis (e.g. imported constants).
+    int inputCount;
+    Symbol **index;           /// The top-level symbols by identifier, so that a memo is validated in constant time.
+    int indexCapacity;
+    int indexCount;
+    int hasIndexFailed;       /// Whether the index could not grow, in which case the symbol table is searched.
+    uint64_t scopeHash;       /// The hash of the revisions of the mutable globals, updated after each statement.
+    int executedCount;        /// The number of statements executed by the last analysis.
+    int reusedCount;          /// The number of statements reused by the last analysis.
+} QueryDatabase;
+
+/// Initializes an empty query database, where the first analysis executes every statement.
+/// @return A pointer to the newly allocated QueryDatabase, or NULL if memory allocation fails.
+///
+QueryDatabase *initQueryDatabase();
+
+/// Analyzes a program like analyzeProgram(), reusing the memo of each top-level statement that is still valid. The
+/// symbols already in the symbol table are the inputs of the analysis. A reused statement reports its errors again at
+/// its current location, while the propagated values and the removed namespaces are only displayed when executed.
+///
+/// @param database The query database, kept from one analysis of the program to the next.
+/// @param analyzer Pointer to the Analyzer instance.
+/// @param node Pointer to the root AST node representing the program.
+/// @return 1 (True) if semantic analysis succeeds; 0 (False) if an error occurs.
+///
+int analyzeProgramIncrementally(QueryDatabase *database, Analyzer *analyzer, ASTNode *node);
+
+/// Records that the statement being executed has looked up a symbol, unless the statement has declared it itself.
+///
+/// @param memo The memo of the statement being executed.
+/// @param identifier The identifier looked up.
+/// @param symbol The symbol found, or NULL if it is undeclared.
+///
+void recordQueryRead(QueryMemo *memo, const char *identifier, Symbol *symbol);
+
+/// Records that the statement being executed declares or assigns a top-level symbol, whose state is memoized once
+/// the statement has been executed.
+///
+/// @param memo The memo of the statement being executed.
+/// @param symbol The symbol declared or assigned.
+/// @param isDeclared Whether the statement declares the symbol.
+///
+void recordQueryWrite(QueryMemo *memo, Symbol *symbol, int isDeclared);
+
+/// Records that the statement being executed depends on the mutable globals, which a function call could assign.
+/// @param memo The memo of the statement being executed.
+///
+void recordQueryScope(QueryMemo *memo);
+
+/// Records an error reported by the statement being executed.
+///
+/// @param memo The memo of the statement being executed.
+/// @param error The error reported.
+/// @param node The node where the error occurred.
+///
+void recordQueryDiagnostic(QueryMemo *memo, AnalyzerError error, ASTNode *node);
+
+/// Reports how many statements the last analysis has executed and reused.
+/// @param database The query database.
+///
+void displayQueryStatistics(QueryDatabase *database);
+
+/// Frees a query database and its memos.
+/// @param database The database to free.
+///
+void freeQueryDatabase(QueryDatabase *database);
+
+#endif
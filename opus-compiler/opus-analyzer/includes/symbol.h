@@ -10,6 +10,7 @@
 #ifndef SYMBOL_H
 #define SYMBOL_H
 
+#include <stdint.h>
 #include "token.h"
 
 /// Represents a symbol in the symbol table.
@@ -17,9 +18,11 @@ typedef struct Symbol {
     char identifier[LEXEME_LENGTH];   /// The name of the variable, constant and function.
     char type[LEXEME_LENGTH];         /// The type name of the identifier or of the label.
     int namespace;                    /// The namespace (i.e. scope level) of the symbol.
-    int hasInitialized;               /// Whether the symbol has been initialized.
+    int hasInitialized;               /// Whether the symbol has been assigned on some path.
+    int isFoldable;                   /// Whether the value of the symbol is known at compile time.
     int isMutable;                    /// Whether it is a constant.
     Location declarationLocation;     /// The location where the symbol declarated.
+    uint64_t revision;                /// The revision of its state in an incremental analysis (see query.h), or 0.
 
     /// Value evaluated for the symbol
     union { 
@@ -27,6 +30,8 @@ typedef struct Symbol {
         float floatingValue; 
         int booleanValue; 
         char stringLiteral[LEXEME_LENGTH]; 
+        int integerLanes[8]; 
+        float floatingLanes[8]; 
     } symbolValue;
 
     struct Symbol *nextSymbol;        /// Pointer to the next symbol for linked list implementation.
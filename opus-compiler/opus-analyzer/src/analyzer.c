@@ -6,8 +6,371 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <math.h>
 #include "analyzer.h"
+#include "query.h"
+
+/// Looks up a symbol from the current namespace, recording the lookup as a dependency of the statement being
+/// executed incrementally (if any).
+static Symbol *resolveSymbol(Analyzer *analyzer, const char *identifier) {
+    Symbol *symbol = lookupSymbolFromCurrentNamespace(analyzer->symbolTable, identifier);
+    if (analyzer->recording) recordQueryRead(analyzer->recording, identifier, symbol);
+    return symbol;
+}
+
+/// Checks if an integer type is unsigned (UInt8, UInt16 or UInt32).
+static int isUnsignedInteger(const char *type) {
+    return strncmp(type, "UInt", 4) == 0 && getIntegerWidth(type);
+}
+
+/// Checks if an integer is a value of an integer type.
+static int isIntegerInRange(const char *type, long long value) {
+    int width = getIntegerWidth(type);
+    if (!width) return 0;
+    if (isUnsignedInteger(type)) return value >= 0 && value < (1LL << width);
+    return value >= -(1LL << (width - 1)) && value < (1LL << (width - 1));
+}
+
+/// Wraps an integer around to the width of an integer type, returning the 32 bits holding it.
+static int wrapInteger(const char *type, unsigned long long value) {
+    int width = getIntegerWidth(type);
+    if (width == 32) return (int) (unsigned int) value;
+    if (isUnsignedInteger(type)) return (int) (value & ((1ULL << width) - 1));
+    return (int) ((long long) (value << (64 - width)) >> (64 - width));
+}
+
+/// Checks if every value of an integer type is a value of another one, so that it is converted implicitly (e.g. an
+/// Int8 into an Int16, or a UInt8 into an Int16).
+static int isIntegerWidened(const char *from, const char *to) {
+    if (strcmp(from, to) == 0) return 1;
+    if (!getIntegerWidth(from) || getIntegerWidth(from) >= getIntegerWidth(to)) return 0;
+    return isUnsignedInteger(from) || !isUnsignedInteger(to);
+}
+
+/// Checks if an expression is an integer literal, which might be negated or computed from other literals.
+static int isIntegerLiteral(ASTNode *node) {
+    if (!node || !node->token) return 0;
+    TokenType operator = node->token->tokenType;
+
+    if (node->nodeType == AST_LITERAL) return operator == TOKEN_NUMERIC && !strchr(node->token->lexeme, '.');
+    if (node->nodeType == AST_UNARY_EXPRESSION) return operator == TOKEN_ARITHMETIC_SUBTRACTION &&
+                                                       isIntegerLiteral(node->left);
+    if (node->nodeType != AST_BINARY_EXPRESSION) return 0;
+
+    return (operator == TOKEN_ARITHMETIC_ADDITION || operator == TOKEN_ARITHMETIC_SUBTRACTION ||
+            operator == TOKEN_ARITHMETIC_MULTIPLICATION) && isIntegerLiteral(node->left) &&
+           isIntegerLiteral(node->right);
+}
+
+/// Checks if an expression is an integer literal (see isIntegerLiteral()) whose value is held by an integer type.
+static int isIntegerLiteralOf(ASTNode *node, const char *type) {
+    return strcmp(node->inferredType, "Int") == 0 && isIntegerLiteral(node) && node->isFoldable &&
+           isIntegerInRange(type, node->nodeValue.integerValue);
+}
+
+/// Gets the type of an arithmetic or a comparison on two integers, which is the type of both operands, the type of
+/// the other operand if one of them is a literal that the type holds, or the type one operand is widened into.
+static const char *joinIntegerTypes(ASTNode *lhs, ASTNode *rhs) {
+    const char *lhsType = lhs->inferredType;
+    const char *rhsType = rhs->inferredType;
+    if (!getIntegerWidth(lhsType) || !getIntegerWidth(rhsType)) return NULL;
+    if (strcmp(lhsType, rhsType) == 0) return lhsType;
+
+    // An integer literal is an Int, unless the other operand is a type holding its value
+    if (isIntegerLiteralOf(lhs, rhsType)) return rhsType;
+    if (isIntegerLiteralOf(rhs, lhsType)) return lhsType;
+
+    if (isIntegerWidened(lhsType, rhsType)) return rhsType;
+    if (isIntegerWidened(rhsType, lhsType)) return lhsType;
+    return NULL;
+}
+
+/// Analyzes the conversion of an integer into an integer type (e.g. "Int8(clamping: x)"), which takes a single
+/// integer labeled 'truncating' (wrapping the value around) or 'clamping' (saturating it at the bounds of the type).
+static int analyzeIntegerConversion(Analyzer *analyzer, ASTNode *node) {
+    const char *type = strcmp(node->left->token->lexeme, "Int32") == 0 ? "Int" : node->left->token->lexeme;
+    ASTNode *list = node->right;
+    ASTNode *argument = list && list->left ? list->left : NULL;
+    const char *label = argument && argument->left && argument->left->token ? argument->left->token->lexeme : "";
+    int isClamping = (strcmp(label, "clamping") == 0);
+
+    strcpy(node->inferredType, type);
+    node->isFoldable = 0;
+
+    if (!argument || (list->right && list->right->left) || (!isClamping && strcmp(label, "truncating") != 0)) {
+        analyzer->analyzerError = ANALYZER_ERROR_INVALID_CONVERSION;
+        reportAnalyzerError(analyzer, node->left);
+        return 0;
+    }
+
+    ASTNode *value = argument->right;
+    if (!analyzeExpression(analyzer, value)) return 0;
+
+    // The type of a value only known at runtime (e.g. returned by a call) is checked once the conversion is lowered
+    if (!getIntegerWidth(value->inferredType)) {
+        if (strcmp(value->inferredType, "Any") == 0) return 1;
+
+        analyzer->analyzerError = ANALYZER_ERROR_INVALID_CONVERSION;
+        reportAnalyzerError(analyzer, node->left);
+        return 0;
+    }
+
+    if (!value->isFoldable) return 1;
+
+    long long integer = getIntegerValue(value->inferredType, value->nodeValue.integerValue);
+    int width = getIntegerWidth(type);
+    long long low = isUnsignedInteger(type) ? 0 : -(1LL << (width - 1));
+    long long high = isUnsignedInteger(type) ? (1LL << width) - 1 : (1LL << (width - 1)) - 1;
+
+    if (isClamping) integer = integer < low ? low : integer > high ? high : integer;
+    node->nodeValue.integerValue = wrapInteger(type, (unsigned long long) integer);
+    node->isFoldable = 1;
+    return 1;
+}
+
+/// Gets the type of the lanes of a vector or a mask type ("Float", "Int" or "Bool").
+static const char *getVectorLaneType(const char *type) {
+    if (strncmp(type, "Mask", 4) == 0) return "Bool";
+    return type[strlen(type) - 1] == 'f' ? "Float" : "Int";
+}
+
+/// Checks if a value is given to a lane of a type, where an integer is converted into a Float lane, and the type of a
+/// value only known at runtime (e.g. returned by a call) is checked once it is lowered.
+static int isLaneValue(ASTNode *node, const char *laneType) {
+    const char *type = node->inferredType;
+    if (strcmp(type, "Any") == 0 || strcmp(type, laneType) == 0) return 1;
+    if (strcmp(laneType, "Float") == 0) return isNumeric(type);
+    return strcmp(laneType, "Int") == 0 && isIntegerWidened(type, "Int");
+}
+
+/// Gets a Float lane of a folded operand of a vector operation, where a scalar is broadcast into every lane.
+static float getFloatingLane(ASTNode *node, int lane) {
+    if (getVectorLanes(node->inferredType)) return node->nodeValue.floatingLanes[lane];
+    if (strcmp(node->inferredType, "Float") == 0) return node->nodeValue.floatingValue;
+    return (float) getIntegerValue(node->inferredType, node->nodeValue.integerValue);
+}
+
+/// Gets an Int or a Bool lane of a folded operand of a vector operation, where a scalar is broadcast into every lane.
+static int getIntegerLane(ASTNode *node, int lane) {
+    if (getVectorLanes(node->inferredType)) return node->nodeValue.integerLanes[lane];
+    return node->nodeValue.integerValue;
+}
+
+/// Analyzes a binary expression on a vector, which works lane by lane on two vectors of the same type or on a vector
+/// and a scalar broadcast into every lane, where a comparison gives a mask of the same number of lanes, and a mask
+/// is only compared for equality.
+static int analyzeVectorExpression(Analyzer *analyzer, ASTNode *node) {
+    TokenType operator = node->token->tokenType;
+    int isLhsVector = getVectorLanes(node->left->inferredType) > 0;
+    const char *type = isLhsVector ? node->left->inferredType : node->right->inferredType;
+    ASTNode *other = isLhsVector ? node->right : node->left;
+
+    int isArithmetic = operator == TOKEN_ARITHMETIC_ADDITION || operator == TOKEN_ARITHMETIC_SUBTRACTION ||
+                       operator == TOKEN_ARITHMETIC_MULTIPLICATION || operator == TOKEN_ARITHMETIC_DIVISION ||
+                       operator == TOKEN_ARITHMETIC_MODULO;
+    int isEquality = operator == TOKEN_LOGICAL_EQUIVALENCE || operator == TOKEN_NOT_EQUAL_TO_OPERATOR;
+    int isRelational = operator == TOKEN_GREATER_THAN_OPERATOR || operator == TOKEN_LESS_THAN_OPERATOR ||
+                       operator == TOKEN_GREATER_OR_EQUAL_TO_OPERATOR || operator == TOKEN_LESS_OR_EQUAL_TO_OPERATOR;
+
+    int isValid = getVectorLanes(other->inferredType) ? strcmp(other->inferredType, type) == 0
+                                                      : isLaneValue(other, getVectorLaneType(type));
+
+    if (strcmp(getVectorLaneType(type), "Bool") == 0) isValid = isValid && isEquality;
+    else isValid = isValid && (isArithmetic || isEquality || isRelational);
+
+    if (!isValid) {
+        analyzer->analyzerError = ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH;
+        reportAnalyzerError(analyzer, node);
+        return 0;
+    }
+
+    strcpy(node->inferredType, isArithmetic ? type : getVectorLanes(type) == 4 ? "Mask4" : "Mask8");
+    return 1;
+}
+
+/// Analyzes the construction of a vector or a mask, from a value labeled 'splat' broadcast into every lane (e.g.
+/// "Vec4f(splat: 0.5)"), or from a value labeled 'lane' for each lane.
+static int analyzeVectorConstruction(Analyzer *analyzer, ASTNode *node) {
+    const char *type = node->left->token->lexeme;
+    int lanes = getVectorLanes(type);
+    int count = 0;
+    int isSplat = 0;
+    int isValid = 1;
+
+    strcpy(node->inferredType, type);
+    node->isFoldable = 0;
+
+    for (ASTNode *list = node->right; list && list->left; list = list->right, count++) {
+        ASTNode *label = list->left->left;
+        const char *lexeme = label && label->token ? label->token->lexeme : "";
+        int isLast = !list->right || !list->right->left;
+
+        if (strcmp(lexeme, "splat") == 0 && count == 0 && isLast) isSplat = 1;
+        else if (strcmp(lexeme, "lane") != 0) isValid = 0;
+    }
+
+    if (!isValid || (!isSplat && count != lanes)) {
+        analyzer->analyzerError = ANALYZER_ERROR_INVALID_VECTOR;
+        reportAnalyzerError(analyzer, node->left);
+        return 0;
+    }
+
+    int isFoldable = 1;
+    int lane = 0;
+
+    for (ASTNode *list = node->right; list && list->left; list = list->right, lane++) {
+        ASTNode *value = list->left->right;
+        if (!analyzeExpression(analyzer, value)) return 0;
+
+        if (!isLaneValue(value, getVectorLaneType(type))) {
+            analyzer->analyzerError = ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH;
+            reportAnalyzerError(analyzer, node->left);
+            return 0;
+        }
+
+        isFoldable = isFoldable && value->isFoldable;
+        if (!isFoldable) continue;
+
+        // A splat fills every lane with its value
+        for (int filled = lane; filled < (isSplat ? lanes : lane + 1); filled++) {
+            if (strcmp(getVectorLaneType(type), "Float") == 0) {
+                node->nodeValue.floatingLanes[filled] = getFloatingLane(value, filled);
+            } else node->nodeValue.integerLanes[filled] = getIntegerLane(value, filled);
+        }
+    }
+
+    node->isFoldable = isFoldable;
+    return 1;
+}
+
+/// Analyzes a call of a reduction of a vector into a scalar, which is 'sum', 'min' or 'max' of a vector, or 'any' or
+/// 'all' of a mask, taking a single value labeled 'of', and returns 0 (False) for any other call. The lanes are
+/// reduced by halves (lane i with lane i + 4, then i + 2, then i + 1), which is the order the reduction is lowered in.
+static int analyzeVectorReduction(Analyzer *analyzer, ASTNode *node, int *result) {
+    static const char *reductions[] = {"sum", "min", "max", "any", "all"};
+    const char *callee = node->left->token->lexeme;
+    ASTNode *list = node->right;
+    int reduction = -1;
+
+    for (int index = 0; index < (int) (sizeof(reductions) / sizeof(reductions[0])); index++) {
+        if (strcmp(callee, reductions[index]) == 0) reduction = index;
+    }
+
+    // Any other call, or a call of a function of the program taking a scalar, is not a reduction
+    if (reduction < 0 || !list || !list->left || (list->right && list->right->left)) return 0;
+    if (!list->left->left || strcmp(list->left->left->token->lexeme, "of") != 0) return 0;
+
+    ASTNode *value = list->left->right;
+    *result = analyzeExpression(analyzer, value);
+    if (!*result || !getVectorLanes(value->inferredType)) return !*result;
+
+    const char *laneType = getVectorLaneType(value->inferredType);
+    int isMaskReduction = (reduction >= 3);
+
+    if (isMaskReduction != (strcmp(laneType, "Bool") == 0)) {
+        analyzer->analyzerError = ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH;
+        reportAnalyzerError(analyzer, node->left);
+        *result = 0;
+        return 1;
+    }
+
+    strcpy(node->inferredType, laneType);
+    node->isFoldable = value->isFoldable;
+    if (!node->isFoldable) return 1;
+
+    int integers[8];
+    float floats[8];
+    memcpy(integers, value->nodeValue.integerLanes, sizeof(integers));
+    memcpy(floats, value->nodeValue.floatingLanes, sizeof(floats));
+
+    for (int width = getVectorLanes(value->inferredType) / 2; width >= 1; width /= 2) {
+        for (int lane = 0; lane < width && node->isFoldable; lane++) {
+            int rhs = integers[lane + width];
+            float rhsFloat = floats[lane + width];
+
+            if (reduction == 3) integers[lane] = integers[lane] || rhs;
+            else if (reduction == 4) integers[lane] = integers[lane] && rhs;
+            else if (strcmp(laneType, "Float") == 0) {
+                if (reduction == 0) floats[lane] = floats[lane] + rhsFloat;
+                else if (reduction == 1 ? rhsFloat < floats[lane] : rhsFloat > floats[lane]) floats[lane] = rhsFloat;
+            }
+
+            // An Int sum overflowing is left to the runtime, which either wraps around or fails
+            else if (reduction == 0) node->isFoldable = !__builtin_add_overflow(integers[lane], rhs, &integers[lane]);
+            else if (reduction == 1 ? rhs < integers[lane] : rhs > integers[lane]) integers[lane] = rhs;
+        }
+    }
+
+    if (strcmp(laneType, "Float") == 0) node->nodeValue.floatingValue = floats[0];
+    else node->nodeValue.integerValue = integers[0];
+    return 1;
+}
+
+/// Folds a binary expression on vectors lane by lane (see analyzeVectorExpression()), where an Int lane overflowing
+/// or divided by zero is left to the runtime, which either wraps around or fails.
+static void foldVectorExpression(ASTNode *node) {
+    TokenType operator = node->token->tokenType;
+    ASTNode *lhs = node->left;
+    ASTNode *rhs = node->right;
+    const char *type = getVectorLanes(lhs->inferredType) ? lhs->inferredType : rhs->inferredType;
+    const char *laneType = getVectorLaneType(type);
+    int isFloat = strcmp(laneType, "Float") == 0;
+
+    node->isFoldable = 1;
+
+    for (int lane = 0; lane < getVectorLanes(type) && node->isFoldable; lane++) {
+        float lhsFloat = isFloat ? getFloatingLane(lhs, lane) : 0.0f;
+        float rhsFloat = isFloat ? getFloatingLane(rhs, lane) : 0.0f;
+        int lhsValue = isFloat ? 0 : getIntegerLane(lhs, lane);
+        int rhsValue = isFloat ? 0 : getIntegerLane(rhs, lane);
+        int result = 0;
+
+        switch (operator) {
+            case TOKEN_LOGICAL_EQUIVALENCE: result = isFloat ? lhsFloat == rhsFloat : lhsValue == rhsValue; break;
+            case TOKEN_NOT_EQUAL_TO_OPERATOR: result = isFloat ? lhsFloat != rhsFloat : lhsValue != rhsValue; break;
+            case TOKEN_LESS_THAN_OPERATOR: result = isFloat ? lhsFloat < rhsFloat : lhsValue < rhsValue; break;
+            case TOKEN_LESS_OR_EQUAL_TO_OPERATOR: result = isFloat ? lhsFloat <= rhsFloat : lhsValue <= rhsValue; break;
+            case TOKEN_GREATER_THAN_OPERATOR: result = isFloat ? lhsFloat > rhsFloat : lhsValue > rhsValue; break;
+            case TOKEN_GREATER_OR_EQUAL_TO_OPERATOR: {
+                result = isFloat ? lhsFloat >= rhsFloat : lhsValue >= rhsValue;
+                break;
+            }
+
+            default: {
+                if (isFloat) {
+                    if (operator == TOKEN_ARITHMETIC_ADDITION) lhsFloat += rhsFloat;
+                    else if (operator == TOKEN_ARITHMETIC_SUBTRACTION) lhsFloat -= rhsFloat;
+                    else if (operator == TOKEN_ARITHMETIC_MULTIPLICATION) lhsFloat *= rhsFloat;
+                    else if (operator == TOKEN_ARITHMETIC_DIVISION) lhsFloat /= rhsFloat;
+                    else lhsFloat = fmodf(lhsFloat, rhsFloat);
+
+                    node->nodeValue.floatingLanes[lane] = lhsFloat;
+                    continue;
+                }
+
+                int isFailed = 0;
+                if (operator == TOKEN_ARITHMETIC_ADDITION) {
+                    isFailed = __builtin_add_overflow(lhsValue, rhsValue, &result);
+                }
+                else if (operator == TOKEN_ARITHMETIC_SUBTRACTION) {
+                    isFailed = __builtin_sub_overflow(lhsValue, rhsValue, &result);
+                }
+                else if (operator == TOKEN_ARITHMETIC_MULTIPLICATION) {
+                    isFailed = __builtin_mul_overflow(lhsValue, rhsValue, &result);
+                }
+                else if (rhsValue == 0 || (lhsValue == INT_MIN && rhsValue == -1)) isFailed = 1;
+                else if (operator == TOKEN_ARITHMETIC_DIVISION) result = lhsValue / rhsValue;
+                else result = lhsValue % rhsValue;
+
+                node->isFoldable = !isFailed;
+                break;
+            }
+        }
+
+        node->nodeValue.integerLanes[lane] = result;
+    }
+}
 
 int analyzeProgram(Analyzer *analyzer, ASTNode *node) {
     // Return successful indication (True) if there is no node to analyze
@@ -36,7 +399,11 @@ int analyzeStatement(Analyzer *analyzer, ASTNode *node) {
     // Try to analyze a conditional statement
     else if (node->nodeType == AST_CONDITIONAL_STATEMENT) return analyzeConditionalStatement(analyzer, node);
 
-    // Return successful indication (True) if there is no node to analyze
+    // Imports have been resolved before the analysis, which has declared the constants of the imported modules
+    else if (node->nodeType == AST_IMPORT_DECLARATION) return 1;
+
+    // Other statements are not analyzed yet, but the values they might assign are no longer known
+    invalidateAssignedSymbols(analyzer, node);
     return 1;
 }
 
@@ -45,8 +412,11 @@ int analyzeDeclarationStatement(Analyzer *analyzer, ASTNode *node) {
     const char *identifier = node->left->token->lexeme;
     const char *type = node->right->token->lexeme;
 
+    // Int32 is another name of Int, so the values of both types are the same
+    if (strcmp(type, "Int32") == 0) type = "Int";
+
     // Check if the declaration already exists, report error
-    if (lookupSymbolFromCurrentNamespace(analyzer->symbolTable, identifier)) {
+    if (resolveSymbol(analyzer, identifier)) {
         analyzer->analyzerError = ANALYZER_ERROR_REDECLARED_VARIABLE;
         reportAnalyzerError(analyzer, node->left);
         return 0;
@@ -58,6 +428,7 @@ int analyzeDeclarationStatement(Analyzer *analyzer, ASTNode *node) {
     // Check if it is mutable and update the symbol table
     if (node->nodeType == AST_VARIABLE_DECLARATION) analyzer->symbolTable->headSymbol->isMutable = 1;
 
+    if (analyzer->recording) recordQueryWrite(analyzer->recording, analyzer->symbolTable->headSymbol, 1);
     return 1;
 }
 
@@ -78,7 +449,7 @@ int analyzeAssignmentStatement(Analyzer *analyzer, ASTNode *node) {
     }  
 
     // Then check if the identifier exist
-    Symbol* symbol = lookupSymbolFromCurrentNamespace(analyzer->symbolTable, identifier);
+    Symbol* symbol = resolveSymbol(analyzer, identifier);
 
     // Check if trying to assign to an undeclared variable or constant 
     if (!symbol) {
@@ -87,29 +458,32 @@ int analyzeAssignmentStatement(Analyzer *analyzer, ASTNode *node) {
         return 0;
     }
 
-    // Check if trying to modify a constant
-    if (!symbol->isMutable && symbol->hasInitialized) {
-        analyzer->analyzerError = ANALYZER_ERROR_IMMUTABLE_MODIFICATION;
-        reportAnalyzerError(analyzer, node->left);
-        return 0;
-    }
-
-    // Analyze the rhs expression
-    result = analyzeExpression(analyzer, node->right) && result;
+    // Analyze the rhs expression, whose errors (or the errors parsing it) have already been reported if it fails
+    if (!analyzeExpression(analyzer, node->right)) return 0;
 
-    // Perform type checkinig for the assignment statement (type-check lhs and rhs)
-    if (strcmp(symbol->type, node->right->inferredType)) {
+    // Perform type checkinig for the assignment statement (type-check lhs and rhs), where the type of a value only
+    // known at runtime (e.g. returned by a call) is checked once the call is lowered, and an integer is given to a
+    // wider integer type or is a literal that the type holds
+    if (strcmp(symbol->type, node->right->inferredType) && strcmp(node->right->inferredType, "Any") &&
+        !isIntegerWidened(node->right->inferredType, symbol->type) && !isIntegerLiteralOf(node->right, symbol->type)) {
         analyzer->analyzerError = ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH;
         reportAnalyzerError(analyzer, node);
         return 0;
     }
 
+    // An assignment inside a namespace that might not be executed (e.g. one branch of a conditional statement)
+    // leaves the value of an outer symbol unknown afterward
+    int isPathDependent = symbol->namespace < analyzer->dynamicNamespace;
+    if (analyzer->recording) recordQueryWrite(analyzer->recording, symbol, 0);
+    symbol->isFoldable = node->right->isFoldable && !isPathDependent;
+
     // If the right-hand side is foldable, propagate its value to the symbol 
-    if (node->right->isFoldable) {
-        if (strcmp(node->right->inferredType, "Int") == 0) {
+    if (symbol->isFoldable) {
+        if (getIntegerWidth(node->right->inferredType)) {
             int value = node->right->nodeValue.integerValue;
             symbol->symbolValue.integerValue = value;
-            printf("[Analyzer] Symbol '%s' may be assigned with integer '%d'.\n", symbol->identifier, value);
+            printf("[Analyzer] Symbol '%s' may be assigned with integer '%lld'.\n", symbol->identifier,
+                   getIntegerValue(node->right->inferredType, value));
         }
 
         else if (strcmp(node->right->inferredType, "Float") == 0) {
@@ -130,6 +504,24 @@ int analyzeAssignmentStatement(Analyzer *analyzer, ASTNode *node) {
             strcpy(symbol->symbolValue.stringLiteral, value);
             printf("[Analyzer] Symbol '%s' may be assigned with string '%s'.\n", symbol->identifier, value);
         }
+
+        else if (getVectorLanes(node->right->inferredType)) {
+            const char *laneType = getVectorLaneType(node->right->inferredType);
+            memcpy(&symbol->symbolValue, &node->right->nodeValue, sizeof(symbol->symbolValue.integerLanes));
+            printf("[Analyzer] Symbol '%s' may be assigned with %s '(", symbol->identifier,
+                   strcmp(laneType, "Bool") == 0 ? "mask" : "vector");
+
+            for (int lane = 0; lane < getVectorLanes(node->right->inferredType); lane++) {
+                int value = symbol->symbolValue.integerLanes[lane];
+                if (lane > 0) printf(", ");
+
+                if (strcmp(laneType, "Float") == 0) printf("%f", symbol->symbolValue.floatingLanes[lane]);
+                else if (strcmp(laneType, "Int") == 0) printf("%d", value);
+                else printf("%s", value == 0 ? "false" : "true");
+            }
+
+            printf(")'.\n");
+        }
     }
 
     // Initialize symbol by assigning a value to it
@@ -181,7 +573,7 @@ int analyzeExpression(Analyzer *analyzer, ASTNode *node) {
 
         // Determine if a symbol is referenced
         case AST_IDENTIFIER: {
-            Symbol* symbol = lookupSymbolFromCurrentNamespace(analyzer->symbolTable, node->token->lexeme);
+            Symbol* symbol = resolveSymbol(analyzer, node->token->lexeme);
 
             // If an undeclared symbol is referenced
             if (!symbol) {
@@ -191,34 +583,41 @@ int analyzeExpression(Analyzer *analyzer, ASTNode *node) {
             }
 
             strcpy(node->inferredType, symbol->type);
+            node->isFoldable = 0;
+
+            // If its value is known on every path reaching here, we can perform constant fold
+            if (symbol->isFoldable) {
+                node->isFoldable = 1;
 
-            // If it has been initialized, we can perform constant fold
-            if (symbol->hasInitialized) {
                 // Handle string literal 
-                if (strcmp(symbol->type, "String")) {
+                if (strcmp(symbol->type, "String") == 0) {
                     strcpy(node->nodeValue.stringLiteral, symbol->symbolValue.stringLiteral);
                 }
 
                 // Handle float 
-                else if (strcmp(symbol->type, "Float")) {
+                else if (strcmp(symbol->type, "Float") == 0) {
                     node->nodeValue.floatingValue = symbol->symbolValue.floatingValue;
                 }
 
                 // Handle integer
-                else if (strcmp(symbol->type, "Int")) {
+                else if (getIntegerWidth(symbol->type)) {
                     node->nodeValue.integerValue = symbol->symbolValue.integerValue;
                 }
 
                 // Handle boolean
-                else if (strcmp(symbol->type, "Bool")) {
+                else if (strcmp(symbol->type, "Bool") == 0) {
                     node->nodeValue.booleanValue = symbol->symbolValue.booleanValue;
                 }
 
+                // Handle vector and mask
+                else if (getVectorLanes(symbol->type)) {
+                    memcpy(&node->nodeValue, &symbol->symbolValue, sizeof(node->nodeValue.integerLanes));
+                }
+
                 // If unable to reference value from the identifier
                 else node->isFoldable = 0;
             }
 
-            else node->isFoldable = 0;
             return 1;
         }
 
@@ -232,8 +631,13 @@ int analyzeExpression(Analyzer *analyzer, ASTNode *node) {
             ASTNode* lhs = node->left;
             ASTNode* rhs = node->right;
 
+            // An operation on a vector works lane by lane
+            if (getVectorLanes(lhs->inferredType) || getVectorLanes(rhs->inferredType)) {
+                if (!analyzeVectorExpression(analyzer, node)) return 0;
+            }
+
             // For arithmetic operators, both operands must be numeric 
-            if (operator == TOKEN_ARITHMETIC_ADDITION || operator == TOKEN_ARITHMETIC_SUBTRACTION ||
+            else if (operator == TOKEN_ARITHMETIC_ADDITION || operator == TOKEN_ARITHMETIC_SUBTRACTION ||
                 operator == TOKEN_ARITHMETIC_MULTIPLICATION || operator == TOKEN_ARITHMETIC_DIVISION ||
                 operator == TOKEN_ARITHMETIC_MODULO) {
 
@@ -249,42 +653,66 @@ int analyzeExpression(Analyzer *analyzer, ASTNode *node) {
                     strcpy(node->inferredType, "Float");
                 }
 
-                // Otherwise the result is an Int
-                else strcpy(node->inferredType, "Int");    
+                // Otherwise the result is the integer type both operands are given to
+                else if (joinIntegerTypes(lhs, rhs)) strcpy(node->inferredType, joinIntegerTypes(lhs, rhs));
+
+                // Handle missmatched integer types (e.g. an Int8 and a UInt8)
+                else {
+                    analyzer->analyzerError = ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH;
+                    reportAnalyzerError(analyzer, node);
+                    return 0;
+                }
             }
 
-            // For logical operators 'and' and 'or', both operands must be boolean
+            // For logical operators 'and' and 'or', both operands must be boolean (or only known at runtime, e.g. calls)
             else if (operator == TOKEN_LOGICAL_AND_OPERATOR || operator == TOKEN_LOGICAL_OR_OPERATOR) {
-                if (strcmp(lhs->inferredType, "Bool") != 0 || strcmp(rhs->inferredType, "Bool") != 0) {
+                if ((strcmp(lhs->inferredType, "Bool") != 0 && strcmp(lhs->inferredType, "Any") != 0) ||
+                    (strcmp(rhs->inferredType, "Bool") != 0 && strcmp(rhs->inferredType, "Any") != 0)) {
                     analyzer->analyzerError = ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH;
                     reportAnalyzerError(analyzer, node);
                     return 0;
                 }
+                strcpy(node->inferredType, "Bool");
             }
 
-            // For logical operators '==' and '!=', both operands must be the same type 
+            // For logical operators '==' and '!=', both operands must be the same type (or integers given to one type)
             else if (operator == TOKEN_LOGICAL_EQUIVALENCE || operator == TOKEN_NOT_EQUAL_TO_OPERATOR) {
-                if (strcmp(lhs->inferredType, rhs->inferredType) != 0) {
+                if (strcmp(lhs->inferredType, rhs->inferredType) != 0 && !joinIntegerTypes(lhs, rhs)) {
                     analyzer->analyzerError = ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH;
                     reportAnalyzerError(analyzer, node);
                     return 0;
                 }
+                strcpy(node->inferredType, "Bool");
             }
 
-            // For relational operators '>', '<', '>=' and '<=', both operands must be numeric
+            // For relational operators '>', '<', '>=' and '<=', both operands must be numeric, where two integers
+            // must be given to one type
             else if (operator == TOKEN_GREATER_THAN_OPERATOR || operator == TOKEN_LESS_THAN_OPERATOR ||
                      operator == TOKEN_GREATER_OR_EQUAL_TO_OPERATOR || operator == TOKEN_LESS_OR_EQUAL_TO_OPERATOR) {
-                if (!(isNumeric(lhs->inferredType) && isNumeric(rhs->inferredType))) {
+                int isFloat = strcmp(lhs->inferredType, "Float") == 0 || strcmp(rhs->inferredType, "Float") == 0;
+
+                if (!(isNumeric(lhs->inferredType) && isNumeric(rhs->inferredType)) ||
+                    (!isFloat && !joinIntegerTypes(lhs, rhs))) {
                     analyzer->analyzerError = ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH;
                     reportAnalyzerError(analyzer, node);
                     return 0;
                 }
+                strcpy(node->inferredType, "Bool");
             }
 
-            // Perform constant fold if both lhs and rhs are foldable 
+            // Perform constant fold if both lhs and rhs are foldable, otherwise the value is only known at runtime
             if (node->left->isFoldable && node->right->isFoldable) foldBinaryExpression(node);
 
-            // TODO:  Support relational and logical operators
+            // A folded lhs deciding 'and' or 'or' on its own folds the expression, since the rhs is never evaluated
+            else if ((operator == TOKEN_LOGICAL_AND_OPERATOR || operator == TOKEN_LOGICAL_OR_OPERATOR) &&
+                     lhs->isFoldable && strcmp(lhs->inferredType, "Bool") == 0 &&
+                     lhs->nodeValue.booleanValue == (operator == TOKEN_LOGICAL_OR_OPERATOR)) {
+                node->isFoldable = 1;
+                node->nodeValue.booleanValue = lhs->nodeValue.booleanValue;
+            }
+
+            else node->isFoldable = 0;
+
             return 1;
         }
 
@@ -296,9 +724,11 @@ int analyzeExpression(Analyzer *analyzer, ASTNode *node) {
             TokenType operator = node->token->tokenType;
             ASTNode* operand = node->left;
 
-            // Unary minus only applies on numeric value
+            int isMask = getVectorLanes(operand->inferredType) && strncmp(operand->inferredType, "Mask", 4) == 0;
+
+            // Unary minus only applies on numeric value (or a vector)
             if (operator == TOKEN_ARITHMETIC_SUBTRACTION) {
-                if (!isNumeric(operand->inferredType)) {
+                if (!isNumeric(operand->inferredType) && (!getVectorLanes(operand->inferredType) || isMask)) {
                     analyzer->analyzerError = ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH;
                     reportAnalyzerError(analyzer, node);
                     return 0;
@@ -306,14 +736,15 @@ int analyzeExpression(Analyzer *analyzer, ASTNode *node) {
                 strcpy(node->inferredType, operand->inferredType);
             }
 
-            // Unary negation only applies on boolean value 
+            // Unary negation only applies on boolean value (or a mask, or a value only known at runtime)
             else if (operator == TOKEN_LOGICAL_NEGATION) {
-                if (strcmp(operand->inferredType, "Bool") != 0) {
+                if (strcmp(operand->inferredType, "Bool") != 0 && strcmp(operand->inferredType, "Any") != 0 &&
+                    !isMask) {
                     analyzer->analyzerError = ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH;
                     reportAnalyzerError(analyzer, node);
                     return 0;
                 }
-                strcpy(node->inferredType, "Bool");
+                strcpy(node->inferredType, isMask ? operand->inferredType : "Bool");
             }
 
             // Unary factorial only applies on positive integers
@@ -327,26 +758,40 @@ int analyzeExpression(Analyzer *analyzer, ASTNode *node) {
             }
 
             if (operand->isFoldable) foldUnaryExpression(node);
+            else node->isFoldable = 0;
+            return 1;
+        }
+
+        // A function call might assign any mutable global, and its value is only known at runtime
+        case AST_FUNCTION_CALL: {
+            const char *callee = node->left && node->left->token ? node->left->token->lexeme : "";
+            if (getIntegerWidth(callee)) return analyzeIntegerConversion(analyzer, node);
+            if (getVectorLanes(callee)) return analyzeVectorConstruction(analyzer, node);
+
+            int result;
+            if (analyzeVectorReduction(analyzer, node, &result)) return result;
+
+            invalidateAssignedSymbols(analyzer, node);
+            node->isFoldable = 0;
             return 1;
         }
 
-        // TODO: Support function call and other node types 
-        default: return 1;
+        // An expression failing to parse has been reported by the parser, so nothing is checked against it
+        case AST_ERROR: node->isFoldable = 0; return 0;
+
+        // TODO: Support other node types 
+        default: node->isFoldable = 0; return 1;
     }
 }
 
 int analyzeCodeBlock(Analyzer *analyzer, ASTNode *node) {
     int result = 1;
 
-    // Process each statement within the code block
-    ASTNode *statement = node->left;
-    while (statement != NULL) {
-        result = analyzeStatement(analyzer, statement) && result;
-        statement = statement->right;
+    // Each code block node holds a statement on its left and the rest of the block on its right
+    for (ASTNode *statement = node; statement != NULL; statement = statement->right) {
+        if (statement->left) result = analyzeStatement(analyzer, statement->left) && result;
     }
 
-    // Recursively handle code blocks
-    if (node->right) result = analyzeCodeBlock(analyzer, node->right) && result;
     return result;
 }
 
@@ -356,13 +801,16 @@ int analyzeConditionalStatement(Analyzer *analyzer, ASTNode *node) {
 
     int result = analyzeExpression(analyzer, condition);
     
-    // Condition must be a boolean value 
-    if (!result || strcmp(condition->inferredType, "Bool")) {
+    // Condition must be a boolean value, where a condition failing to analyze has reported its own error
+    if (result && strcmp(condition->inferredType, "Bool")) {
         analyzer->analyzerError = ANALYZER_ERROR_INVALID_CONDITION;
         reportAnalyzerError(analyzer, node);
-        return 0;
+        result = 0;
     }
 
+    // The bodies of an invalid condition are still analyzed for their own errors, as if either might be executed
+    if (!result) condition->isFoldable = 0;
+
     // If the condition is foldable, we can statically determine which condition body to execute
     int safeEliminateFirstCodeBlock = 0;
     int safeEliminateSecondCodeBlock = 0;
@@ -372,6 +820,10 @@ int analyzeConditionalStatement(Analyzer *analyzer, ASTNode *node) {
         else safeEliminateFirstCodeBlock = 1;
     }
 
+    // Otherwise either body might not be executed, so the namespaces of the bodies are dynamic
+    int dynamicNamespace = analyzer->dynamicNamespace;
+    if (!condition->isFoldable) analyzer->dynamicNamespace = analyzer->symbolTable->currentNamespace + 1;
+
     if (conditionalBody->nodeType == AST_CONDITIONAL_BODY) {
         // Analyze if-body
         if (conditionalBody->left && !safeEliminateFirstCodeBlock) { 
@@ -380,22 +832,62 @@ int analyzeConditionalStatement(Analyzer *analyzer, ASTNode *node) {
             exitNamespace(analyzer->symbolTable);
         }
 
+        // Try to analyze else-if statement if exists, which opens its own namespaces
+        if (conditionalBody->right && conditionalBody->right->nodeType == AST_CONDITIONAL_STATEMENT) {
+            if (!safeEliminateSecondCodeBlock) result = analyzeConditionalStatement(analyzer, conditionalBody->right) && result;
+        }
+
         // Try to analyze else statement body if exists
-        if (conditionalBody->right && !safeEliminateSecondCodeBlock) {
+        else if (conditionalBody->right && !safeEliminateSecondCodeBlock) {
             enterNamespace(analyzer->symbolTable);
             result = analyzeCodeBlock(analyzer, conditionalBody->right) && result;
             exitNamespace(analyzer->symbolTable);
         }
     }
 
+    analyzer->dynamicNamespace = dynamicNamespace;
     return result;
 }
 
+void invalidateAssignedSymbols(Analyzer *analyzer, ASTNode *node) {
+    if (!node) return;
+
+    // The assigned symbol is resolved from the current namespace, which is conservative for shadowed symbols
+    if (node->nodeType == AST_ASSIGNMENT_STATEMENT && node->left && node->left->nodeType == AST_IDENTIFIER) {
+        Symbol *symbol = resolveSymbol(analyzer, node->left->token->lexeme);
+        if (symbol && symbol->isFoldable && analyzer->recording) recordQueryWrite(analyzer->recording, symbol, 0);
+        if (symbol) symbol->isFoldable = 0;
+    }
+
+    // A function could only assign the mutable globals
+    else if (node->nodeType == AST_FUNCTION_CALL) {
+        if (analyzer->recording) recordQueryScope(analyzer->recording);
+
+        for (Symbol *symbol = analyzer->symbolTable->headSymbol; symbol; symbol = symbol->nextSymbol) {
+            if (symbol->namespace != 0 || !symbol->isMutable) continue;
+            if (analyzer->recording && symbol->isFoldable) recordQueryWrite(analyzer->recording, symbol, 0);
+            symbol->isFoldable = 0;
+        }
+    }
+
+    // The body of a function implementation is only executed when the function is called
+    if (node->nodeType == AST_FUNCTION_IMPLEMENTATION) return;
+
+    invalidateAssignedSymbols(analyzer, node->left);
+    invalidateAssignedSymbols(analyzer, node->right);
+}
+
 void foldBinaryExpression(ASTNode* node) {
     TokenType operator = node->token->tokenType;
     ASTNode *lhs = node->left;
     ASTNode *rhs = node->right;
 
+    // Check for the binary expression on a vector, which is folded lane by lane
+    if (getVectorLanes(lhs->inferredType) || getVectorLanes(rhs->inferredType)) {
+        foldVectorExpression(node);
+        return;
+    }
+
     // Check for the arithmetic binary expression
     if (operator == TOKEN_ARITHMETIC_ADDITION || operator == TOKEN_ARITHMETIC_SUBTRACTION ||
         operator == TOKEN_ARITHMETIC_MULTIPLICATION || operator == TOKEN_ARITHMETIC_DIVISION ||
@@ -408,9 +900,11 @@ void foldBinaryExpression(ASTNode* node) {
         if (isFloat) {
             // Get the value from the lhs and rhs
             float lhsValue = (strcmp(lhs->inferredType, "Float") == 0) ? 
-                             lhs->nodeValue.floatingValue : (float) lhs->nodeValue.integerValue;
+                             lhs->nodeValue.floatingValue : (float) getIntegerValue(lhs->inferredType,
+                                                                                    lhs->nodeValue.integerValue);
             float rhsValue = (strcmp(rhs->inferredType, "Float") == 0) ? 
-                             rhs->nodeValue.floatingValue : (float) rhs->nodeValue.integerValue;
+                             rhs->nodeValue.floatingValue : (float) getIntegerValue(rhs->inferredType,
+                                                                                    rhs->nodeValue.integerValue);
             float result = 0.0f;
 
             // Perform arithmetic operation
@@ -425,21 +919,48 @@ void foldBinaryExpression(ASTNode* node) {
             strcpy(node->inferredType, "Float");
         }
 
+        // A sized integer wraps around to its width, where a division by zero is left to the runtime, which fails
+        else if (strcmp(node->inferredType, "Int") != 0) {
+            unsigned long long lhsValue = (unsigned long long) getIntegerValue(lhs->inferredType,
+                                                                               lhs->nodeValue.integerValue);
+            unsigned long long rhsValue = (unsigned long long) getIntegerValue(rhs->inferredType,
+                                                                               rhs->nodeValue.integerValue);
+            unsigned long long result = 0;
+
+            if (operator == TOKEN_ARITHMETIC_ADDITION) result = lhsValue + rhsValue;
+            else if (operator == TOKEN_ARITHMETIC_SUBTRACTION) result = lhsValue - rhsValue;
+            else if (operator == TOKEN_ARITHMETIC_MULTIPLICATION) result = lhsValue * rhsValue;
+            else if (rhsValue == 0) result = 0;
+            else if (operator == TOKEN_ARITHMETIC_DIVISION) result = (long long) lhsValue / (long long) rhsValue;
+            else if (operator == TOKEN_ARITHMETIC_MODULO) result = (long long) lhsValue % (long long) rhsValue;
+
+            node->isFoldable = rhsValue != 0 || operator == TOKEN_ARITHMETIC_ADDITION ||
+                               operator == TOKEN_ARITHMETIC_SUBTRACTION || operator == TOKEN_ARITHMETIC_MULTIPLICATION;
+            node->nodeValue.integerValue = wrapInteger(node->inferredType, result);
+        }
+
         // Otherwise, perform integer operation
         else {
             // Get the value from the lhs and rhs
             int lhsValue = lhs->nodeValue.integerValue;
             int rhsValue = rhs->nodeValue.integerValue;
             int result = 0;
+            int isFailed = 0;
 
-            // Perform arithmetic operation
-            if (operator == TOKEN_ARITHMETIC_ADDITION) result = lhsValue + rhsValue;
-            else if (operator == TOKEN_ARITHMETIC_SUBTRACTION) result = lhsValue - rhsValue;
-            else if (operator == TOKEN_ARITHMETIC_MULTIPLICATION) result = lhsValue * rhsValue;
+            // Perform arithmetic operation, where an overflow or a division by zero is left to the runtime, which
+            // either wraps around or fails
+            if (operator == TOKEN_ARITHMETIC_ADDITION) isFailed = __builtin_add_overflow(lhsValue, rhsValue, &result);
+            else if (operator == TOKEN_ARITHMETIC_SUBTRACTION) {
+                isFailed = __builtin_sub_overflow(lhsValue, rhsValue, &result);
+            }
+            else if (operator == TOKEN_ARITHMETIC_MULTIPLICATION) {
+                isFailed = __builtin_mul_overflow(lhsValue, rhsValue, &result);
+            }
+            else if (rhsValue == 0 || (lhsValue == INT_MIN && rhsValue == -1)) isFailed = 1;
             else if (operator == TOKEN_ARITHMETIC_DIVISION) result = lhsValue / rhsValue;
             else if (operator == TOKEN_ARITHMETIC_MODULO) result = lhsValue % rhsValue;
 
-            node->isFoldable = 1;
+            node->isFoldable = !isFailed;
             node->nodeValue.integerValue = result;
             strcpy(node->inferredType, "Int");
         }
@@ -464,8 +985,9 @@ void foldBinaryExpression(ASTNode* node) {
         
         int result = 0;
 
-        if (strcmp(lhs->inferredType, "Int") == 0) 
-            result = (lhs->nodeValue.integerValue == rhs->nodeValue.integerValue);
+        if (getIntegerWidth(lhs->inferredType)) 
+            result = (getIntegerValue(lhs->inferredType, lhs->nodeValue.integerValue) ==
+                      getIntegerValue(rhs->inferredType, rhs->nodeValue.integerValue));
 
         else if (strcmp(lhs->inferredType, "Float") == 0)
             result = (lhs->nodeValue.floatingValue == rhs->nodeValue.floatingValue);
@@ -486,11 +1008,16 @@ void foldBinaryExpression(ASTNode* node) {
              operator == TOKEN_GREATER_OR_EQUAL_TO_OPERATOR || operator == TOKEN_LESS_OR_EQUAL_TO_OPERATOR) {
         strcpy(node->inferredType, "Bool");
 
-        float lhsValue = (strcmp(lhs->inferredType, "Float") == 0) ?
-                         lhs->nodeValue.floatingValue : (float) lhs->nodeValue.integerValue;
+        // Two integers are compared exactly, since a Float does not hold every value of an Int
+        int isFloat = (strcmp(lhs->inferredType, "Float") == 0 || strcmp(rhs->inferredType, "Float") == 0);
+
+        double lhsValue = (strcmp(lhs->inferredType, "Float") == 0) ? lhs->nodeValue.floatingValue
+                        : isFloat ? (float) getIntegerValue(lhs->inferredType, lhs->nodeValue.integerValue)
+                        : (double) getIntegerValue(lhs->inferredType, lhs->nodeValue.integerValue);
 
-        float rhsValue = (strcmp(rhs->inferredType, "Float") == 0) ?
-                         rhs->nodeValue.floatingValue : (float) rhs->nodeValue.integerValue;
+        double rhsValue = (strcmp(rhs->inferredType, "Float") == 0) ? rhs->nodeValue.floatingValue
+                        : isFloat ? (float) getIntegerValue(rhs->inferredType, rhs->nodeValue.integerValue)
+                        : (double) getIntegerValue(rhs->inferredType, rhs->nodeValue.integerValue);
         
         int result = 0;
 
@@ -508,6 +1035,24 @@ void foldUnaryExpression(ASTNode* node) {
     TokenType operator = node->token->tokenType;
     ASTNode* operand = node->left;
 
+    // Unary minus of a vector and negation of a mask work lane by lane, where negating Int.min is left to the runtime
+    if (getVectorLanes(operand->inferredType)) {
+        int isFloat = strcmp(getVectorLaneType(operand->inferredType), "Float") == 0;
+        node->isFoldable = 1;
+
+        for (int lane = 0; lane < getVectorLanes(operand->inferredType); lane++) {
+            int value = operand->nodeValue.integerLanes[lane];
+
+            if (isFloat) node->nodeValue.floatingLanes[lane] = -operand->nodeValue.floatingLanes[lane];
+            else if (operator == TOKEN_LOGICAL_NEGATION) node->nodeValue.integerLanes[lane] = !value;
+            else if (value == INT_MIN) node->isFoldable = 0;
+            else node->nodeValue.integerLanes[lane] = -value;
+        }
+
+        strcpy(node->inferredType, operand->inferredType);
+        return;
+    }
+
     // Unary minus for getting the negation of an numeric value
     if (operator == TOKEN_ARITHMETIC_SUBTRACTION) {
         if (strcmp(operand->inferredType, "Float") == 0) {
@@ -517,10 +1062,17 @@ void foldUnaryExpression(ASTNode* node) {
         } 
 
         else if (strcmp(operand->inferredType, "Int") == 0) {
-            node->isFoldable = 1;
-            node->nodeValue.integerValue = -(operand->nodeValue.integerValue);
+            node->isFoldable = operand->nodeValue.integerValue != INT_MIN;
+            node->nodeValue.integerValue = node->isFoldable ? -(operand->nodeValue.integerValue) : 0;
             strcpy(node->inferredType, "Int");
         }
+
+        // A sized integer wraps around to its width (e.g. the negation of Int8.min is Int8.min)
+        else if (getIntegerWidth(operand->inferredType)) {
+            long long value = getIntegerValue(operand->inferredType, operand->nodeValue.integerValue);
+            node->isFoldable = 1;
+            node->nodeValue.integerValue = wrapInteger(operand->inferredType, 0ULL - (unsigned long long) value);
+        }
     }
 
     // Unary negation for getting the inverse of a boolean value
@@ -536,57 +1088,42 @@ void foldUnaryExpression(ASTNode* node) {
     else if (operator == TOKEN_ARITHMETIC_FACTORIAL) {
         int number = operand->nodeValue.integerValue;
         int result = 1;
+        int isFailed = 0;
 
-        // Perform factorial operation
-        for (int term = 1; term <= number; term++) result *= term;
+        // Perform factorial operation, where an overflow is left to the runtime
+        for (int term = 2; term <= number && !isFailed; term++) {
+            isFailed = __builtin_mul_overflow(result, term, &result);
+        }
         
-        node->isFoldable = 1;
+        node->isFoldable = !isFailed;
         node->nodeValue.integerValue = result;
         strcpy(node->inferredType, "Int");
     }
 }
 
 void reportAnalyzerError(Analyzer *analyzer, ASTNode *node) {
-    switch (analyzer->analyzerError) {
-        case ANALYZER_ERROR_REDECLARED_VARIABLE: {
-            const char *identifier = node->token->lexeme;
-            int line = node->token->location.line;
-            int column = node->token->location.column;
-            printf("[ERROR] Redeclared symbol '%s' at location %d:%d.\n", identifier, line, column); 
-            break;
-        }
-
-        case ANALYZER_ERROR_UNDECLARED_VARIABLE: {
-            const char *identifier = node->token->lexeme;
-            int line = node->token->location.line;
-            int column = node->token->location.column;
-            printf("[ERROR] Undeclared symbol '%s' at location %d:%d.\n", identifier, line, column); 
-            break;
-        }
+    // An error reported while executing a statement incrementally is reported again whenever its memo is reused
+    if (analyzer->recording) recordQueryDiagnostic(analyzer->recording, analyzer->analyzerError, node);
 
-        case ANALYZER_ERROR_IMMUTABLE_MODIFICATION: {
-            const char *identifier = node->token->lexeme;
-            int line = node->token->location.line;
-            int column = node->token->location.column;
-            printf("[ERROR] Symbol '%s' is immutable at location %d:%d.\n", identifier, line, column); 
-            break;
-        }
-
-        case ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH: {
-            const char *operator = node->token->lexeme;
-            int line = node->token->location.line;
-            int column = node->token->location.column;
-            printf("[ERROR] Unable to perform '%s' due to type missmatch at location %d:%d.\n", operator, line, column);
-            break;
-        }
+    DiagnosticList *diagnostics = analyzer->diagnostics;
+    const char *lexeme = node->token->lexeme;
+    Location location = node->token->location;
 
-        case ANALYZER_ERROR_INVALID_CONDITION: {
-            const char *statement = node->token->lexeme;
-            int line = node->token->location.line;
-            int column = node->token->location.column;
-            printf("[ERROR] Invalid condition for '%s' statement at location %d:%d.\n", statement, line, column);
-            break;
-        }
+    switch (analyzer->analyzerError) {
+        case ANALYZER_ERROR_REDECLARED_VARIABLE:
+            reportDiagnostic(diagnostics, location, "Redeclared symbol '%s'", lexeme); break;
+        case ANALYZER_ERROR_UNDECLARED_VARIABLE:
+            reportDiagnostic(diagnostics, location, "Undeclared symbol '%s'", lexeme); break;
+        case ANALYZER_ERROR_OPERATION_TYPE_MISSMATCH:
+            reportDiagnostic(diagnostics, location, "Unable to perform '%s' due to type missmatch", lexeme); break;
+        case ANALYZER_ERROR_INVALID_CONDITION:
+            reportDiagnostic(diagnostics, location, "Invalid condition for '%s' statement", lexeme); break;
+        case ANALYZER_ERROR_INVALID_CONVERSION:
+            reportDiagnostic(diagnostics, location, "Conversion into '%s' takes a single integer labeled "
+                             "'truncating' or 'clamping'", lexeme); break;
+        case ANALYZER_ERROR_INVALID_VECTOR:
+            reportDiagnostic(diagnostics, location, "Vector '%s' takes a value labeled 'splat' or a value labeled "
+                             "'lane' for each lane", lexeme); break;
         default: printf("Unknown error!\n"); break;
     }
 }
@@ -597,6 +1134,9 @@ Analyzer *initAnalyzer(ASTNode *node, SymbolTable *symbolTable) {
     if (analyzer) {
         analyzer->symbolTable = symbolTable;
         analyzer->analyzerError = ANALYZER_ERROR_NONE;
+        analyzer->dynamicNamespace = 0;
+        analyzer->recording = NULL;
+        analyzer->diagnostics = NULL;
     }
 
     return analyzer;
@@ -622,7 +1162,9 @@ void addSymbol(SymbolTable *symbolTable, const char *identifier, const char *typ
         symbol->namespace = symbolTable->currentNamespace;
         symbol->declarationLocation = location;
         symbol->hasInitialized = 0;
+        symbol->isFoldable = 0;
         symbol->isMutable = 0;
+        symbol->revision = 0;
 
         // Add to the beginning of the linked list
         symbol->nextSymbol = symbolTable->headSymbol;
@@ -740,5 +1282,33 @@ void displaySymbolTable(SymbolTable *symbolTable) {
 
 int isNumeric(const char* type) {
     // Checks if the given type is numeric
-    return (strcmp(type, "Int") == 0 || strcmp(type, "Float") == 0);
+    return (getIntegerWidth(type) || strcmp(type, "Float") == 0);
+}
+
+int getIntegerWidth(const char *type) {
+    static const struct { const char *name; int width; } integers[] = {
+        {"Int", 32}, {"Int32", 32}, {"UInt32", 32}, {"Int8", 8}, {"UInt8", 8}, {"Int16", 16}, {"UInt16", 16}
+    };
+
+    for (int index = 0; index < (int) (sizeof(integers) / sizeof(integers[0])); index++) {
+        if (strcmp(type, integers[index].name) == 0) return integers[index].width;
+    }
+
+    return 0;
+}
+
+long long getIntegerValue(const char *type, int bits) {
+    return strcmp(type, "UInt32") == 0 ? (long long) (unsigned int) bits : (long long) bits;
+}
+
+int getVectorLanes(const char *type) {
+    static const struct { const char *name; int lanes; } vectors[] = {
+        {"Vec4f", 4}, {"Vec8f", 8}, {"Vec4i", 4}, {"Vec8i", 8}, {"Mask4", 4}, {"Mask8", 8}
+    };
+
+    for (int index = 0; index < (int) (sizeof(vectors) / sizeof(vectors[0])); index++) {
+        if (strcmp(type, vectors[index].name) == 0) return vectors[index].lanes;
+    }
+
+    return 0;
 }
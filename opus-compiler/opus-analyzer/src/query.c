@@ -0,0 +1,537 @@
+// query.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "query.h"
+#include "metrics.h"
+
+#define QUERY_HASH_SEED    0xcbf29ce484222325ULL
+#define QUERY_HASH_PRIME   0x100000001b3ULL
+
+static uint64_t hashQueryBytes(uint64_t hash, const void *bytes, size_t length) {
+    const unsigned char *data = (const unsigned char*) bytes;
+
+    for (size_t index = 0; index < length; index++) {
+        hash ^= data[index];
+        hash *= QUERY_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+static uint64_t hashQueryInteger(uint64_t hash, int64_t value) {
+    return hashQueryBytes(hash, &value, sizeof(value));
+}
+
+// A missing child is hashed as well, so that two statements with the same hash have the same shape, and the lines
+// are relative to the first line of the statement, so that moving a statement keeps its hash
+static uint64_t hashStatementSyntax(ASTNode *node, int line, uint64_t hash) {
+    if (!node) return hashQueryInteger(hash, -1);
+
+    hash = hashQueryInteger(hash, node->nodeType);
+
+    if (node->token) {
+        hash = hashQueryInteger(hash, node->token->tokenType);
+        hash = hashQueryInteger(hash, node->token->location.line - line);
+        hash = hashQueryInteger(hash, node->token->location.column);
+        hash = hashQueryBytes(hash, node->token->lexeme, strlen(node->token->lexeme));
+    }
+
+    hash = hashStatementSyntax(node->left, line, hash);
+    return hashStatementSyntax(node->right, line, hash);
+}
+
+static int findStatementLine(ASTNode *node) {
+    if (!node) return INT_MAX;
+
+    int line = node->token ? node->token->location.line : INT_MAX;
+    int left = findStatementLine(node->left);
+    int right = findStatementLine(node->right);
+
+    if (left < line) line = left;
+    return right < line ? right : line;
+}
+
+static int countStatementNodes(ASTNode *node) {
+    return node ? 1 + countStatementNodes(node->left) + countStatementNodes(node->right) : 0;
+}
+
+static void collectAnnotations(ASTNode *node, QueryAnnotation *annotations, int *index) {
+    if (!node) return;
+
+    QueryAnnotation *annotation = &annotations[(*index)++];
+    strcpy(annotation->inferredType, node->inferredType);
+    annotation->isFoldable = node->isFoldable;
+    memcpy(&annotation->nodeValue, &node->nodeValue, sizeof(annotation->nodeValue));
+
+    collectAnnotations(node->left, annotations, index);
+    collectAnnotations(node->right, annotations, index);
+}
+
+static void applyAnnotations(ASTNode *node, QueryAnnotation *annotations, int *index) {
+    if (!node) return;
+
+    QueryAnnotation *annotation = &annotations[(*index)++];
+    strcpy(node->inferredType, annotation->inferredType);
+    node->isFoldable = annotation->isFoldable;
+    memcpy(&node->nodeValue, &annotation->nodeValue, sizeof(node->nodeValue));
+
+    applyAnnotations(node->left, annotations, index);
+    applyAnnotations(node->right, annotations, index);
+}
+
+// Restores the annotations a node has once parsed, so that a statement executed again infers nothing from the
+// annotations of its previous execution
+static void clearAnnotations(ASTNode *node) {
+    if (!node) return;
+
+    strcpy(node->inferredType, "Any");
+    node->isFoldable = 1;
+
+    clearAnnotations(node->left);
+    clearAnnotations(node->right);
+}
+
+// Finds the pre-order index of a node, or the node at a pre-order index (if the target node is NULL)
+static ASTNode *findStatementNode(ASTNode *node, ASTNode *target, int *index, int targetIndex) {
+    if (!node) return NULL;
+    if (target ? node == target : *index == targetIndex) return node;
+
+    (*index)++;
+    ASTNode *found = findStatementNode(node->left, target, index, targetIndex);
+    return found ? found : findStatementNode(node->right, target, index, targetIndex);
+}
+
+// Whether two states of a symbol are the same, where the location only matters for display
+static int isSameSymbolState(Symbol *lhs, Symbol *rhs) {
+    if (strcmp(lhs->identifier, rhs->identifier) || strcmp(lhs->type, rhs->type)) return 0;
+    if (lhs->namespace != rhs->namespace || lhs->isMutable != rhs->isMutable) return 0;
+    if (lhs->hasInitialized != rhs->hasInitialized || lhs->isFoldable != rhs->isFoldable) return 0;
+    if (!lhs->isFoldable) return 1;
+
+    if (strcmp(lhs->type, "String") == 0) return strcmp(lhs->symbolValue.stringLiteral, rhs->symbolValue.stringLiteral) == 0;
+    int lanes = getVectorLanes(lhs->type);
+    if (lanes) return memcmp(lhs->symbolValue.integerLanes, rhs->symbolValue.integerLanes, lanes * sizeof(int)) == 0;
+    return lhs->symbolValue.integerValue == rhs->symbolValue.integerValue;
+}
+
+// The hash of the mutable globals combines the hash of each of them by exclusive or, so that it is updated in
+// constant time whenever one of them changes
+static uint64_t hashScopeEntry(Symbol *symbol) {
+    if (symbol->namespace != 0 || !symbol->isMutable) return 0;
+
+    uint64_t hash = hashQueryBytes(QUERY_HASH_SEED, symbol->identifier, strlen(symbol->identifier));
+    return hashQueryInteger(hash, (int64_t) symbol->revision);
+}
+
+// The latest symbol declared with an identifier replaces the previous one, like the lookups of the symbol table
+static int indexQuerySymbol(QueryDatabase *database, Symbol *symbol) {
+    if (2 * (database->indexCount + 1) > database->indexCapacity) {
+        int capacity = database->indexCapacity ? database->indexCapacity * 2 : 64;
+        Symbol **index = (Symbol**) calloc(capacity, sizeof(Symbol*));
+        if (!index) return 0;
+
+        Symbol **oldIndex = database->index;
+        int oldCapacity = database->indexCapacity;
+        database->index = index;
+        database->indexCapacity = capacity;
+        database->indexCount = 0;
+
+        for (int slot = 0; slot < oldCapacity; slot++) {
+            if (oldIndex[slot]) indexQuerySymbol(database, oldIndex[slot]);
+        }
+
+        free(oldIndex);
+    }
+
+    uint64_t hash = hashQueryBytes(QUERY_HASH_SEED, symbol->identifier, strlen(symbol->identifier));
+    int slot = (int) (hash & (uint64_t) (database->indexCapacity - 1));
+
+    while (database->index[slot] && strcmp(database->index[slot]->identifier, symbol->identifier)) {
+        slot = (slot + 1) & (database->indexCapacity - 1);
+    }
+
+    if (!database->index[slot]) database->indexCount++;
+    database->index[slot] = symbol;
+    return 1;
+}
+
+static Symbol *findQuerySymbol(QueryDatabase *database, const char *identifier) {
+    if (!database->indexCapacity) return NULL;
+
+    uint64_t hash = hashQueryBytes(QUERY_HASH_SEED, identifier, strlen(identifier));
+    int slot = (int) (hash & (uint64_t) (database->indexCapacity - 1));
+
+    while (database->index[slot] && strcmp(database->index[slot]->identifier, identifier)) {
+        slot = (slot + 1) & (database->indexCapacity - 1);
+    }
+
+    return database->index[slot];
+}
+
+// Gives a top-level symbol the revision of its new state once a statement has declared or assigned it
+static void settleQuerySymbol(QueryDatabase *database, Symbol *symbol, uint64_t revision, int isDeclared) {
+    if (!isDeclared) database->scopeHash ^= hashScopeEntry(symbol);
+
+    symbol->revision = revision;
+    database->scopeHash ^= hashScopeEntry(symbol);
+
+    if (isDeclared && !indexQuerySymbol(database, symbol)) database->hasIndexFailed = 1;
+}
+
+// Most statements read and write a couple of symbols, and the memos stay small so that they do not scatter the
+// symbols allocated in between, which the lookups of the symbol table traverse
+static int growQueryArray(void **array, int *capacity, int count, size_t size) {
+    if (count < *capacity) return 1;
+
+    int grownCapacity = *capacity ? *capacity * 2 : 1;
+    void *grown = realloc(*array, grownCapacity * size);
+    if (!grown) return 0;
+
+    *array = grown;
+    *capacity = grownCapacity;
+    return 1;
+}
+
+static void freeQueryMemo(QueryMemo *memo) {
+    if (!memo) return;
+
+    free(memo->reads);
+    free(memo->writes);
+    free(memo->annotations);
+    free(memo->diagnostics);
+    free(memo);
+}
+
+// A memo is valid if every symbol it has read still has the same revision
+static int isQueryMemoValid(QueryDatabase *database, QueryMemo *memo, SymbolTable *symbolTable) {
+    for (int index = 0; index < memo->readCount; index++) {
+        QueryRead *read = &memo->reads[index];
+
+        if (strcmp(read->identifier, QUERY_SCOPE_IDENTIFIER) == 0) {
+            if (database->scopeHash != read->revision) return 0;
+            continue;
+        }
+
+        Symbol *symbol = database->hasIndexFailed ? lookupSymbolFromCurrentNamespace(symbolTable, read->identifier) :
+                         findQuerySymbol(database, read->identifier);
+        if ((symbol ? symbol->revision : 0) != read->revision) return 0;
+    }
+
+    return 1;
+}
+
+static QueryWrite *findQueryWrite(QueryMemo *memo, const char *identifier, int isDeclared) {
+    for (int index = 0; memo && index < memo->writeCount; index++) {
+        QueryWrite *write = &memo->writes[index];
+        if (write->isDeclared == isDeclared && strcmp(write->symbol.identifier, identifier) == 0) return write;
+    }
+
+    return NULL;
+}
+
+// Executes a statement while recording its memo, where a symbol keeps the revision it had in the previous memo of
+// the same statement if its new state is the same
+static void executeStatement(QueryDatabase *database, Analyzer *analyzer, ASTNode *statement, QueryMemo *memo,
+                             QueryMemo *previous) {
+    memo->scopeHash = database->scopeHash;
+    clearAnnotations(statement);
+    analyzer->recording = memo;
+    memo->result = analyzeStatement(analyzer, statement);
+    analyzer->recording = NULL;
+
+    memo->nodeCount = countStatementNodes(statement);
+    memo->annotations = (QueryAnnotation*) malloc(memo->nodeCount * sizeof(QueryAnnotation));
+
+    int index = 0;
+    if (memo->annotations) collectAnnotations(statement, memo->annotations, &index);
+    else memo->nodeCount = 0;
+
+    for (int diagnostic = 0; diagnostic < memo->diagnosticCount; diagnostic++) {
+        index = 0;
+        findStatementNode(statement, memo->diagnostics[diagnostic].node, &index, 0);
+        memo->diagnostics[diagnostic].nodeIndex = index;
+        memo->diagnostics[diagnostic].node = NULL;
+    }
+
+    // The new state of an assigned symbol depends on its previous state, which is a read of the statement as well
+    for (int write = 0; write < memo->writeCount; write++) {
+        Symbol *symbol = memo->writes[write].source;
+        if (!memo->writes[write].isDeclared) recordQueryRead(memo, symbol->identifier, symbol);
+    }
+
+    for (int write = 0; write < memo->writeCount; write++) {
+        QueryWrite *current = &memo->writes[write];
+        QueryWrite *old = findQueryWrite(previous, current->source->identifier, current->isDeclared);
+
+        Symbol *symbol = current->source;
+        uint64_t revision = old && isSameSymbolState(&old->symbol, symbol) ? old->symbol.revision : ++database->revision;
+        settleQuerySymbol(database, symbol, revision, current->isDeclared);
+
+        current->symbol = *symbol;
+        current->symbol.nextSymbol = NULL;
+        current->source = NULL;
+    }
+}
+
+// Applies the memo of a statement whose reads are still valid, as if the statement had been executed again
+static void replayStatement(QueryDatabase *database, Analyzer *analyzer, ASTNode *statement, QueryMemo *memo,
+                            int line) {
+    SymbolTable *symbolTable = analyzer->symbolTable;
+
+    for (int index = 0; index < memo->writeCount; index++) {
+        QueryWrite *write = &memo->writes[index];
+        Symbol *symbol;
+
+        // A declared symbol follows the statement, wherever it has moved since it was executed
+        if (write->isDeclared) {
+            Location location = write->symbol.declarationLocation;
+            location.line += line - memo->line;
+            addSymbol(symbolTable, write->symbol.identifier, write->symbol.type, location);
+            symbol = symbolTable->headSymbol;
+        }
+
+        else if (database->hasIndexFailed) symbol = lookupSymbolFromCurrentNamespace(symbolTable, write->symbol.identifier);
+        else symbol = findQuerySymbol(database, write->symbol.identifier);
+        if (!symbol) continue;
+
+        symbol->hasInitialized = write->symbol.hasInitialized;
+        symbol->isFoldable = write->symbol.isFoldable;
+        symbol->isMutable = write->symbol.isMutable;
+        symbol->symbolValue = write->symbol.symbolValue;
+        settleQuerySymbol(database, symbol, write->symbol.revision, write->isDeclared);
+    }
+
+    int index = 0;
+    applyAnnotations(statement, memo->annotations, &index);
+
+    for (int diagnostic = 0; diagnostic < memo->diagnosticCount; diagnostic++) {
+        index = 0;
+        ASTNode *node = findStatementNode(statement, NULL, &index, memo->diagnostics[diagnostic].nodeIndex);
+        if (!node) continue;
+
+        analyzer->analyzerError = memo->diagnostics[diagnostic].error;
+        reportAnalyzerError(analyzer, node);
+    }
+}
+
+// The symbols declared before the analysis are its inputs, which keep their revisions while they are the same
+static void settleQueryInputs(QueryDatabase *database, SymbolTable *symbolTable) {
+    if (database->index) memset(database->index, 0, database->indexCapacity * sizeof(Symbol*));
+    database->indexCount = 0;
+    database->hasIndexFailed = 0;
+    database->scopeHash = 0;
+
+    int inputCount = 0;
+    for (Symbol *symbol = symbolTable->headSymbol; symbol; symbol = symbol->nextSymbol) inputCount++;
+
+    QueryWrite *inputs = (QueryWrite*) calloc(inputCount ? inputCount : 1, sizeof(QueryWrite));
+    int index = 0;
+
+    for (Symbol *symbol = symbolTable->headSymbol; symbol; symbol = symbol->nextSymbol) {
+        QueryWrite *input = NULL;
+
+        for (int old = 0; old < database->inputCount && !input; old++) {
+            if (isSameSymbolState(&database->inputs[old].symbol, symbol)) input = &database->inputs[old];
+        }
+
+        symbol->revision = input ? input->symbol.revision : ++database->revision;
+        database->scopeHash ^= hashScopeEntry(symbol);
+
+        // The symbol table lists the latest symbols first, which are the ones found by a lookup
+        if (!findQuerySymbol(database, symbol->identifier) && !indexQuerySymbol(database, symbol)) {
+            database->hasIndexFailed = 1;
+        }
+
+        if (inputs) {
+            inputs[index].symbol = *symbol;
+            inputs[index++].symbol.nextSymbol = NULL;
+        }
+    }
+
+    free(database->inputs);
+    database->inputs = inputs;
+    database->inputCount = index;
+}
+
+QueryDatabase *initQueryDatabase() {
+    return (QueryDatabase*) calloc(1, sizeof(QueryDatabase));
+}
+
+int analyzeProgramIncrementally(QueryDatabase *database, Analyzer *analyzer, ASTNode *node) {
+    int result = 1;
+    database->executedCount = 0;
+    database->reusedCount = 0;
+    settleQueryInputs(database, analyzer->symbolTable);
+
+    // The memos of the previous analysis are indexed by the hash of their syntax, and each is used at most once
+    QueryMemo **oldMemos = database->memos;
+    int oldCount = database->memoCount;
+    int bucketCount = 16;
+    while (bucketCount < 2 * oldCount) bucketCount *= 2;
+
+    int *buckets = (int*) malloc(bucketCount * sizeof(int));
+    int *chain = (int*) malloc((oldCount ? oldCount : 1) * sizeof(int));
+
+    if (!buckets || !chain) {
+        free(buckets);
+        free(chain);
+        return analyzeProgram(analyzer, node);
+    }
+
+    for (int bucket = 0; bucket < bucketCount; bucket++) buckets[bucket] = -1;
+
+    for (int slot = oldCount - 1; slot >= 0; slot--) {
+        int bucket = (int) (oldMemos[slot]->syntaxHash & (uint64_t) (bucketCount - 1));
+        chain[slot] = buckets[bucket];
+        buckets[bucket] = slot;
+    }
+
+    database->memos = NULL;
+    database->memoCount = 0;
+    database->memoCapacity = 0;
+
+    for (ASTNode *program = node; program && program->nodeType == AST_PROGRAM; program = program->right) {
+        ASTNode *statement = program->left;
+        if (!statement) continue;
+
+        int line = findStatementLine(statement);
+        uint64_t syntaxHash = hashStatementSyntax(statement, line, QUERY_HASH_SEED);
+        int bucket = (int) (syntaxHash & (uint64_t) (bucketCount - 1));
+
+        // Reuse the first valid memo of the same statement, otherwise execute it against the first invalid one
+        QueryMemo *memo = NULL;
+        int previousSlot = -1;
+
+        for (int slot = buckets[bucket]; slot >= 0 && !memo; slot = chain[slot]) {
+            if (!oldMemos[slot] || oldMemos[slot]->syntaxHash != syntaxHash) continue;
+
+            if (isQueryMemoValid(database, oldMemos[slot], analyzer->symbolTable)) {
+                memo = oldMemos[slot];
+                oldMemos[slot] = NULL;
+            }
+
+            else if (previousSlot < 0) previousSlot = slot;
+        }
+
+        if (memo) {
+            replayStatement(database, analyzer, statement, memo, line);
+            database->reusedCount++;
+            addMetricCounter(METRIC_QUERY_CACHE_HITS, 1);
+        }
+
+        else {
+            QueryMemo *previous = previousSlot >= 0 ? oldMemos[previousSlot] : NULL;
+            if (previousSlot >= 0) oldMemos[previousSlot] = NULL;
+
+            memo = (QueryMemo*) calloc(1, sizeof(QueryMemo));
+
+            // Without memory for the memo, the statement is only analyzed
+            if (!memo) {
+                result = analyzeStatement(analyzer, statement) && result;
+                freeQueryMemo(previous);
+                continue;
+            }
+
+            memo->syntaxHash = syntaxHash;
+            memo->line = line;
+            executeStatement(database, analyzer, statement, memo, previous);
+            freeQueryMemo(previous);
+            database->executedCount++;
+            addMetricCounter(METRIC_QUERY_CACHE_MISSES, 1);
+        }
+
+        result = memo->result && result;
+
+        if (growQueryArray((void**) &database->memos, &database->memoCapacity, database->memoCount, sizeof(QueryMemo*))) {
+            database->memos[database->memoCount++] = memo;
+        }
+
+        else freeQueryMemo(memo);
+    }
+
+    // The memos of the statements that no longer exist are dropped
+    for (int slot = 0; slot < oldCount; slot++) freeQueryMemo(oldMemos[slot]);
+    free(oldMemos);
+    free(buckets);
+    free(chain);
+
+    return result;
+}
+
+void recordQueryRead(QueryMemo *memo, const char *identifier, Symbol *symbol) {
+    // A symbol declared by the statement itself is not settled yet, and does not depend on any other statement
+    if (symbol && symbol->revision == 0) return;
+
+    uint64_t revision = symbol ? symbol->revision : 0;
+
+    for (int index = 0; index < memo->readCount; index++) {
+        if (memo->reads[index].revision == revision && strcmp(memo->reads[index].identifier, identifier) == 0) return;
+    }
+
+    if (!growQueryArray((void**) &memo->reads, &memo->readCapacity, memo->readCount, sizeof(QueryRead))) return;
+
+    QueryRead *read = &memo->reads[memo->readCount++];
+    strcpy(read->identifier, identifier);
+    read->revision = revision;
+}
+
+void recordQueryWrite(QueryMemo *memo, Symbol *symbol, int isDeclared) {
+    // The symbols of the inner namespaces are removed before the end of the statement
+    if (symbol->namespace != 0) return;
+
+    for (int index = 0; index < memo->writeCount; index++) {
+        if (memo->writes[index].source == symbol) return;
+    }
+
+    if (!growQueryArray((void**) &memo->writes, &memo->writeCapacity, memo->writeCount, sizeof(QueryWrite))) return;
+
+    QueryWrite *write = &memo->writes[memo->writeCount++];
+    memset(write, 0, sizeof(QueryWrite));
+    write->isDeclared = isDeclared;
+    write->source = symbol;
+}
+
+void recordQueryScope(QueryMemo *memo) {
+    for (int index = 0; index < memo->readCount; index++) {
+        if (strcmp(memo->reads[index].identifier, QUERY_SCOPE_IDENTIFIER) == 0) return;
+    }
+
+    if (!growQueryArray((void**) &memo->reads, &memo->readCapacity, memo->readCount, sizeof(QueryRead))) return;
+
+    QueryRead *read = &memo->reads[memo->readCount++];
+    strcpy(read->identifier, QUERY_SCOPE_IDENTIFIER);
+    read->revision = memo->scopeHash;
+}
+
+void recordQueryDiagnostic(QueryMemo *memo, AnalyzerError error, ASTNode *node) {
+    if (!growQueryArray((void**) &memo->diagnostics, &memo->diagnosticCapacity, memo->diagnosticCount,
+                        sizeof(QueryDiagnostic))) return;
+
+    QueryDiagnostic *diagnostic = &memo->diagnostics[memo->diagnosticCount++];
+    diagnostic->error = error;
+    diagnostic->nodeIndex = -1;
+    diagnostic->node = node;
+}
+
+void displayQueryStatistics(QueryDatabase *database) {
+    int statementCount = database->executedCount + database->reusedCount;
+    printf("[Query] Analyzed %d statement%s, %d executed and %d reused (revision %llu).\n", statementCount,
+           statementCount == 1 ? "" : "s", database->executedCount, database->reusedCount,
+           (unsigned long long) database->revision);
+}
+
+void freeQueryDatabase(QueryDatabase *database) {
+    if (!database) return;
+
+    for (int index = 0; index < database->memoCount; index++) freeQueryMemo(database->memos[index]);
+    free(database->memos);
+    free(database->inputs);
+    free(database->index);
+    free(database);
+}
@@ -0,0 +1,71 @@
+// emitter.h
+//
+// The C backend of the Opus programming language. Once optimized, the IR of a module is emitted as portable C into
+// an output directory: a shared header declares the globals and the prototype of every function of the module, while
+// the functions are grouped into several translation units, so that a C compiler could compile the units in
+// parallel and only compile again the units whose code has changed (see toolchain.h). A unit ends after a function
+// chosen by the hash of its name, so adding or editing a function leaves the units around it as they were.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef EMITTER_H
+#define EMITTER_H
+
+#include <stdint.h>
+#include "ir.h"
+
+#define EMITTER_RUNTIME_HEADER       "opus-runtime.h"
+#define EMITTER_MANIFEST_EXTENSION   ".units"
+#define EMITTER_PATH_LENGTH          1024
+#define EMITTER_NAME_LENGTH          (LEXEME_LENGTH + 16)
+#define EMITTER_MAX_UNITS            256
+#define EMITTER_UNIT_FUNCTIONS       8
+#define EMITTER_UNIT_INSTRUCTIONS    4096
+
+/// The files emitted for a module, as listed by its manifest '<module>.units' in the output directory.
+typedef struct {
+    uint64_t stamp;                                      /// What the module has been emitted from (see emitCModule()).
+    char header[EMITTER_NAME_LENGTH];                    /// The file name of the shared header.
+    char units[EMITTER_MAX_UNITS][EMITTER_NAME_LENGTH];  /// The file name of each translation unit.
+    int unitCount;                                       /// The number of translation units.
+} CManifest;
+
+/// Emits an optimized module as C into a directory, that is the runtime header shared by every module, the header of
+/// the module, its translation units and its manifest. The unit 0 holds the globals and the top-level statements,
+/// which become `main()` for the compiled file and an initializer called by `main()` for an imported module. A file
+/// is only written if its content has changed, and the units left over from the last emission are removed.
+///
+/// @param program The optimized program of the module.
+/// @param moduleName The name of the module, which prefixes every symbol of the module in C.
+/// @param initializers The names of the imported modules (directly or not) in the order they are initialized, which
+///        are only called by the compiled file.
+/// @param initializerCount The number of imported modules, or 0 for an imported module.
+/// @param isEntry Whether the module is the compiled file.
+/// @param directory The output directory, which must exist.
+/// @param stamp What the module has been emitted from, recorded by the manifest.
+/// @return 1 (True) if the module has been emitted, 0 (False) if it uses a value the backend could not represent (which
+///         is reported) or a file could not be written.
+///
+int emitCModule(IRProgram *program, const char *moduleName, char initializers[][LEXEME_LENGTH], int initializerCount,
+                int isEntry, const char *directory, uint64_t stamp);
+
+/// Reads the manifest of a module emitted into a directory.
+///
+/// @param directory The output directory.
+/// @param moduleName The name of the module.
+/// @param manifest The manifest receiving the files of the module.
+/// @return 1 (True) if the manifest has been read, 0 (False) if the module has not been emitted.
+///
+int readCManifest(const char *directory, const char *moduleName, CManifest *manifest);
+
+/// Converts a name of Opus into a C identifier, where letters and digits are kept, an underscore is doubled and any
+/// other byte (e.g. of a non-ASCII character) is written as '_x' followed by its hexadecimal value.
+///
+/// @param identifier The name to convert.
+/// @param buffer The buffer receiving the C identifier.
+/// @param capacity The capacity of the buffer.
+///
+void mangleCIdentifier(const char *identifier, char *buffer, size_t capacity);
+
+#endif
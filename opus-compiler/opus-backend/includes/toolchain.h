@@ -0,0 +1,46 @@
+// toolchain.h
+//
+// Building the C code emitted by the backend (see emitter.h) into an executable with the system C compiler. Every
+// translation unit listed by the manifests of the modules is compiled into an object, where up to `jobCount`
+// compilers run at the same time. An object is kept in the cache of the output directory under the hash of
+// everything it is compiled from, that is the unit, the headers it includes, the compiler and its flags, so a unit
+// is only compiled again once its code has changed. The objects are then linked together into the executable.
+// The compiler and its flags are taken from the environment variables CC and CFLAGS, if they are set. The default
+// flags leave out the note of GCC on every function passing an 8-lane vector, which is passed in memory (rather than
+// in an AVX register) unless AVX is enabled (e.g. CFLAGS="-O2 -mavx2 -Wno-psabi").
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef TOOLCHAIN_H
+#define TOOLCHAIN_H
+
+#include "emitter.h"
+
+#define TOOLCHAIN_COMPILER           "cc"
+#define TOOLCHAIN_FLAGS              "-O2 -Wno-psabi"
+#define TOOLCHAIN_CACHE_DIRECTORY    "cache"
+#define TOOLCHAIN_OBJECT_EXTENSION   ".o"
+#define TOOLCHAIN_MAX_WORDS          64
+
+/// Creates the output directory of the C code and its object cache, unless they exist.
+///
+/// @param directory The output directory.
+/// @return 1 (True) if both directories exist, 0 (False) otherwise (which is reported).
+///
+int prepareCDirectory(const char *directory);
+
+/// Compiles the translation units of every module emitted into a directory, reusing the cached object of any unit
+/// compiled before from the same code, then links all objects into an executable.
+///
+/// @param directory The output directory, where each module has been emitted.
+/// @param moduleNames The names of the modules to link.
+/// @param moduleCount The number of modules.
+/// @param outputPath The path of the executable.
+/// @param jobCount The maximum number of compilers running at the same time.
+/// @return 1 (True) if the executable has been linked, 0 (False) otherwise.
+///
+int buildCExecutable(const char *directory, char moduleNames[][LEXEME_LENGTH], int moduleCount, const char *outputPath,
+                     int jobCount);
+
+#endif
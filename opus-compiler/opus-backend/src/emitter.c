@@ -0,0 +1,1138 @@
+// emitter.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <inttypes.h>
+#include <math.h>
+#include "emitter.h"
+#include "dataflow.h"
+#include "interface.h"
+#include "integer.h"
+#include "vector.h"
+
+/// The C code of a file being emitted.
+typedef struct {
+    char *text;         /// The code emitted so far.
+    size_t length;      /// The length of the code.
+    size_t capacity;    /// The allocated capacity of the code.
+    int isFailed;       /// Whether memory allocation has failed, so the code is incomplete.
+} CBuffer;
+
+/// The state of emitting the functions of a module.
+typedef struct {
+    IRProgram *program;                   /// The program being emitted.
+    char module[2 * LEXEME_LENGTH];       /// The mangled name of the module.
+    int isEntry;                          /// Whether the module is the compiled file.
+    CBuffer *buffer;                      /// The file receiving the code.
+} CEmitter;
+
+// The types and the operations of the runtime, which every module includes through its own header
+static const char *runtimeHeader =
+    "// " EMITTER_RUNTIME_HEADER "\n"
+    "//\n"
+    "// Generated by the Opus compiler.\n"
+    "//\n"
+    "\n"
+    "#ifndef OPUS_RUNTIME_H\n"
+    "#define OPUS_RUNTIME_H\n"
+    "\n"
+    "#include <stdio.h>\n"
+    "#include <stdlib.h>\n"
+    "#include <stdint.h>\n"
+    "#include <string.h>\n"
+    "#include <math.h>\n"
+    "\n"
+    "typedef int32_t OpusInt;\n"
+    "typedef int8_t OpusInt8;\n"
+    "typedef int16_t OpusInt16;\n"
+    "typedef uint8_t OpusUInt8;\n"
+    "typedef uint16_t OpusUInt16;\n"
+    "typedef uint32_t OpusUInt32;\n"
+    "typedef float OpusFloat;\n"
+    "typedef int OpusBool;\n"
+    "typedef const char *OpusString;\n"
+    "\n"
+    "// The vectors are the vector types of GCC and Clang, held in SSE registers (or in AVX registers for 8\n"
+    "// lanes once AVX is enabled), where a mask holds -1 in a lane that holds and 0 in a lane that does not,\n"
+    "// as comparisons give\n"
+    "typedef OpusFloat OpusVec4f __attribute__((vector_size(16)));\n"
+    "typedef OpusFloat OpusVec8f __attribute__((vector_size(32)));\n"
+    "typedef OpusInt OpusVec4i __attribute__((vector_size(16)));\n"
+    "typedef OpusInt OpusVec8i __attribute__((vector_size(32)));\n"
+    "typedef OpusUInt32 OpusVec4u __attribute__((vector_size(16)));\n"
+    "typedef OpusUInt32 OpusVec8u __attribute__((vector_size(32)));\n"
+    "typedef OpusInt OpusMask4 __attribute__((vector_size(16)));\n"
+    "typedef OpusInt OpusMask8 __attribute__((vector_size(32)));\n"
+    "\n"
+    "static inline void opusTrap(const char *message, int line, int column) {\n"
+    "    fprintf(stderr, \"[RuntimeError]: %s at location %d:%d.\\n\", message, line, column);\n"
+    "    exit(EXIT_FAILURE);\n"
+    "}\n"
+    "\n"
+    "static inline OpusInt opusDivide(OpusInt lhs, OpusInt rhs, int line, int column) {\n"
+    "    if (rhs == 0) opusTrap(\"Division by zero\", line, column);\n"
+    "    return rhs == -1 ? (OpusInt) (0u - (uint32_t) lhs) : lhs / rhs;\n"
+    "}\n"
+    "\n"
+    "static inline OpusInt opusModulo(OpusInt lhs, OpusInt rhs, int line, int column) {\n"
+    "    if (rhs == 0) opusTrap(\"Division by zero\", line, column);\n"
+    "    return rhs == -1 ? 0 : lhs % rhs;\n"
+    "}\n"
+    "\n"
+    "static inline OpusUInt32 opusDivideUnsigned(OpusUInt32 lhs, OpusUInt32 rhs, int line, int column) {\n"
+    "    if (rhs == 0) opusTrap(\"Division by zero\", line, column);\n"
+    "    return lhs / rhs;\n"
+    "}\n"
+    "\n"
+    "static inline OpusUInt32 opusModuloUnsigned(OpusUInt32 lhs, OpusUInt32 rhs, int line, int column) {\n"
+    "    if (rhs == 0) opusTrap(\"Division by zero\", line, column);\n"
+    "    return lhs % rhs;\n"
+    "}\n"
+    "\n"
+    "static inline OpusInt opusFactorial(OpusInt operand) {\n"
+    "    uint32_t result = 1;\n"
+    "    for (OpusInt term = 2; term <= operand; term++) result *= (uint32_t) term;\n"
+    "    return (OpusInt) result;\n"
+    "}\n"
+    "\n"
+    "// The hash of a String switched over by a perfect hash, computed as the compiler does (FNV-1a from a seed)\n"
+    "static inline OpusInt opusHashString(OpusString string, OpusInt seed) {\n"
+    "    uint32_t hash = 2166136261u ^ (uint32_t) seed;\n"
+    "    for (const unsigned char *character = (const unsigned char*) string; *character; character++) {\n"
+    "        hash = (hash ^ *character) * 16777619u;\n"
+    "    }\n"
+    "    return (OpusInt) hash;\n"
+    "}\n"
+    "\n"
+    "// Every checked operation branches on the overflow flag to the same cold stub, out of the way of its hot path\n"
+    "static __attribute__((cold, noinline, noreturn, unused)) void opusOverflow(int line, int column) {\n"
+    "    opusTrap(\"Integer overflow\", line, column);\n"
+    "    exit(EXIT_FAILURE);\n"
+    "}\n"
+    "\n"
+    "static inline OpusInt opusAddChecked(OpusInt lhs, OpusInt rhs, int line, int column) {\n"
+    "    OpusInt result;\n"
+    "    if (__builtin_add_overflow(lhs, rhs, &result)) opusOverflow(line, column);\n"
+    "    return result;\n"
+    "}\n"
+    "\n"
+    "static inline OpusInt opusSubtractChecked(OpusInt lhs, OpusInt rhs, int line, int column) {\n"
+    "    OpusInt result;\n"
+    "    if (__builtin_sub_overflow(lhs, rhs, &result)) opusOverflow(line, column);\n"
+    "    return result;\n"
+    "}\n"
+    "\n"
+    "static inline OpusInt opusMultiplyChecked(OpusInt lhs, OpusInt rhs, int line, int column) {\n"
+    "    OpusInt result;\n"
+    "    if (__builtin_mul_overflow(lhs, rhs, &result)) opusOverflow(line, column);\n"
+    "    return result;\n"
+    "}\n"
+    "\n"
+    "static inline OpusInt opusDivideChecked(OpusInt lhs, OpusInt rhs, int line, int column) {\n"
+    "    if (rhs == 0) opusTrap(\"Division by zero\", line, column);\n"
+    "    if (rhs == -1 && lhs == INT32_MIN) opusOverflow(line, column);\n"
+    "    return lhs / rhs;\n"
+    "}\n"
+    "\n"
+    "static inline OpusInt opusNegateChecked(OpusInt operand, int line, int column) {\n"
+    "    return opusSubtractChecked(0, operand, line, column);\n"
+    "}\n"
+    "\n"
+    "static inline OpusInt opusFactorialChecked(OpusInt operand, int line, int column) {\n"
+    "    OpusInt result = 1;\n"
+    "    for (OpusInt term = 2; term <= operand; term++) result = opusMultiplyChecked(result, term, line, column);\n"
+    "    return result;\n"
+    "}\n"
+    "\n"
+    "static inline OpusFloat opusModuloFloat(OpusFloat lhs, OpusFloat rhs, int line, int column) {\n"
+    "    (void) line;\n"
+    "    (void) column;\n"
+    "    return fmodf(lhs, rhs);\n"
+    "}\n"
+    "\n"
+    "// The operations on vectors with no SIMD instruction (or which trap on a lane) are computed lane by lane\n"
+    "#define OPUS_LANEWISE(name, type, lanes, operation) \\\n"
+    "    static inline type name(type lhs, type rhs, int line, int column) { \\\n"
+    "        type result; \\\n"
+    "        for (int lane = 0; lane < lanes; lane++) { \\\n"
+    "            result[lane] = operation(lhs[lane], rhs[lane], line, column); \\\n"
+    "        } \\\n"
+    "        return result; \\\n"
+    "    }\n"
+    "\n"
+    "OPUS_LANEWISE(opusDivideVec4i, OpusVec4i, 4, opusDivide)\n"
+    "OPUS_LANEWISE(opusDivideVec8i, OpusVec8i, 8, opusDivide)\n"
+    "OPUS_LANEWISE(opusModuloVec4i, OpusVec4i, 4, opusModulo)\n"
+    "OPUS_LANEWISE(opusModuloVec8i, OpusVec8i, 8, opusModulo)\n"
+    "OPUS_LANEWISE(opusModuloVec4f, OpusVec4f, 4, opusModuloFloat)\n"
+    "OPUS_LANEWISE(opusModuloVec8f, OpusVec8f, 8, opusModuloFloat)\n"
+    "OPUS_LANEWISE(opusAddCheckedVec4i, OpusVec4i, 4, opusAddChecked)\n"
+    "OPUS_LANEWISE(opusAddCheckedVec8i, OpusVec8i, 8, opusAddChecked)\n"
+    "OPUS_LANEWISE(opusSubtractCheckedVec4i, OpusVec4i, 4, opusSubtractChecked)\n"
+    "OPUS_LANEWISE(opusSubtractCheckedVec8i, OpusVec8i, 8, opusSubtractChecked)\n"
+    "OPUS_LANEWISE(opusMultiplyCheckedVec4i, OpusVec4i, 4, opusMultiplyChecked)\n"
+    "OPUS_LANEWISE(opusMultiplyCheckedVec8i, OpusVec8i, 8, opusMultiplyChecked)\n"
+    "OPUS_LANEWISE(opusDivideCheckedVec4i, OpusVec4i, 4, opusDivideChecked)\n"
+    "OPUS_LANEWISE(opusDivideCheckedVec8i, OpusVec8i, 8, opusDivideChecked)\n"
+    "\n"
+    "#endif\n";
+
+// Appends formatted code to a buffer, which grows as needed
+static void appendC(CBuffer *buffer, const char *format, ...) {
+    if (buffer->isFailed) return;
+
+    va_list arguments;
+    va_start(arguments, format);
+    int length = vsnprintf(NULL, 0, format, arguments);
+    va_end(arguments);
+
+    if (buffer->length + length + 1 > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+        while (buffer->length + length + 1 > capacity) capacity *= 2;
+
+        char *text = (char*) realloc(buffer->text, capacity);
+
+        if (!text) {
+            buffer->isFailed = 1;
+            return;
+        }
+
+        buffer->text = text;
+        buffer->capacity = capacity;
+    }
+
+    va_start(arguments, format);
+    vsnprintf(buffer->text + buffer->length, length + 1, format, arguments);
+    va_end(arguments);
+    buffer->length += length;
+}
+
+// Writes a file of the output directory unless it already holds the same code, so that its time stamp is kept
+static int writeCFile(const char *directory, const char *name, const char *text, size_t length) {
+    char path[EMITTER_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/%s", directory, name);
+
+    FILE *file = fopen(path, "rb");
+
+    if (file) {
+        char *existing = (char*) malloc(length + 1);
+        size_t existingLength = existing ? fread(existing, 1, length + 1, file) : 0;
+        int isSame = existing && existingLength == length && memcmp(existing, text, length) == 0;
+
+        free(existing);
+        fclose(file);
+        if (isSame) return 1;
+    }
+
+    file = fopen(path, "wb");
+
+    if (!file || fwrite(text, 1, length, file) != length) {
+        if (file) fclose(file);
+        fprintf(stderr, "[AccessError]: File '%s' could not be written.\n", path);
+        return 0;
+    }
+
+    return fclose(file) == 0;
+}
+
+void mangleCIdentifier(const char *identifier, char *buffer, size_t capacity) {
+    size_t length = 0;
+
+    for (const unsigned char *cursor = (const unsigned char*) identifier; *cursor && length + 5 < capacity; cursor++) {
+        int isAlphanumeric = (*cursor >= 'a' && *cursor <= 'z') || (*cursor >= 'A' && *cursor <= 'Z') ||
+                             (*cursor >= '0' && *cursor <= '9');
+
+        if (isAlphanumeric) buffer[length++] = (char) *cursor;
+        else if (*cursor == '_') {
+            buffer[length++] = '_';
+            buffer[length++] = '_';
+        }
+        else length += snprintf(buffer + length, capacity - length, "_x%02X", *cursor);
+    }
+
+    buffer[length] = '\0';
+}
+
+// Gets the C type of an IR type, where a value of an unknown type could not be represented
+static const char *getCTypeName(IRType type) {
+    switch (type) {
+        case IR_TYPE_VOID: return "void";
+        case IR_TYPE_INT: return "OpusInt";
+        case IR_TYPE_FLOAT: return "OpusFloat";
+        case IR_TYPE_BOOL: return "OpusBool";
+        case IR_TYPE_STRING: return "OpusString";
+        case IR_TYPE_INT8: return "OpusInt8";
+        case IR_TYPE_INT16: return "OpusInt16";
+        case IR_TYPE_UINT8: return "OpusUInt8";
+        case IR_TYPE_UINT16: return "OpusUInt16";
+        case IR_TYPE_UINT32: return "OpusUInt32";
+        case IR_TYPE_VEC4F: return "OpusVec4f";
+        case IR_TYPE_VEC8F: return "OpusVec8f";
+        case IR_TYPE_VEC4I: return "OpusVec4i";
+        case IR_TYPE_VEC8I: return "OpusVec8i";
+        case IR_TYPE_MASK4: return "OpusMask4";
+        case IR_TYPE_MASK8: return "OpusMask8";
+        default: return NULL;
+    }
+}
+
+// Appends the C symbol of a function or a global of a module, e.g. 'opus_geometry_area'
+static void appendCSymbol(CBuffer *buffer, const char *module, const char *identifier) {
+    char mangled[2 * LEXEME_LENGTH];
+    mangleCIdentifier(identifier, mangled, sizeof(mangled));
+    appendC(buffer, "opus_%s_%s", module, mangled);
+}
+
+// Appends a register, where a global of the entry function is the C global of the module
+static void appendCRegister(CEmitter *emitter, IRFunction *function, int reg) {
+    if (function == emitter->program->functions[0] && reg < function->localCount && function->locals[reg].isGlobal) {
+        appendCSymbol(emitter->buffer, emitter->module, function->locals[reg].identifier);
+    } else appendC(emitter->buffer, "r%d", reg);
+}
+
+// Appends a string of the string table as a C literal, where every byte that is not printable ASCII is escaped
+static void appendCString(CBuffer *buffer, const char *string) {
+    appendC(buffer, "\"");
+
+    for (const unsigned char *cursor = (const unsigned char*) string; *cursor; cursor++) {
+        if (*cursor == '"' || *cursor == '\\') appendC(buffer, "\\%c", *cursor);
+        else if (*cursor < 0x20 || *cursor >= 0x7F || *cursor == '?') appendC(buffer, "\\%03o", *cursor);
+        else appendC(buffer, "%c", *cursor);
+    }
+
+    appendC(buffer, "\"");
+}
+
+// Appends a Float constant exactly, as a hexadecimal floating constant
+static void appendCFloat(CBuffer *buffer, float value) {
+    if (isnan(value)) appendC(buffer, "NAN");
+    else if (isinf(value)) appendC(buffer, value < 0 ? "-INFINITY" : "INFINITY");
+    else appendC(buffer, "%af", (double) value);
+}
+
+// Appends the prototype of a function, naming its parameters after their registers for a definition
+static void appendCPrototype(CBuffer *buffer, const char *module, const char *name, IRType returnType,
+                             const IRType *parameterTypes, int parameterCount, int isDefinition) {
+    appendC(buffer, "%s ", getCTypeName(returnType));
+    appendCSymbol(buffer, module, name);
+    appendC(buffer, "(");
+
+    for (int parameter = 0; parameter < parameterCount; parameter++) {
+        appendC(buffer, parameter > 0 ? ", %s" : "%s", getCTypeName(parameterTypes[parameter]));
+        if (isDefinition) appendC(buffer, " r%d", parameter);
+    }
+
+    appendC(buffer, parameterCount == 0 ? "void)" : ")");
+}
+
+// Gets the parameter types of a function of the program, which are the types of its first locals
+static void getCParameterTypes(IRFunction *function, IRType *parameterTypes) {
+    for (int parameter = 0; parameter < function->parameterCount; parameter++) {
+        parameterTypes[parameter] = function->locals[parameter].type;
+    }
+}
+
+// Checks that every value of a function has a type the C backend could represent, and that every called function
+// is implemented by the program or by an imported module (the runtime provides no function)
+static int checkCFunction(IRProgram *program, IRFunction *function, const char *moduleName) {
+    if (function != program->functions[0] && !getCTypeName(function->returnType)) {
+        fprintf(stderr, "[BackendError]: Function '%s' at location %d:%d of module '%s' returns a value of an unknown "
+                        "type.\n", function->name, function->location.line, function->location.column, moduleName);
+        return 0;
+    }
+
+    if (function->parameterCount > IR_MAX_PARAMETERS) {
+        fprintf(stderr, "[BackendError]: Function '%s' of module '%s' has more than %d parameters.\n", function->name,
+                moduleName, IR_MAX_PARAMETERS);
+        return 0;
+    }
+
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            Location location = instruction->location;
+
+            if (instruction->opcode == IR_CALL) {
+                const char *callee = program->strings[instruction->constant.stringIndex];
+
+                if (findIRFunction(program, callee) <= 0 && findIRExternal(program, callee, 1) < 0) {
+                    fprintf(stderr, "[BackendError]: Function '%s' called at location %d:%d of module '%s' is not "
+                                    "implemented.\n", callee, location.line, location.column, moduleName);
+                    return 0;
+                }
+            }
+
+            int destination = instruction->destination;
+            int isUnknown = destination != IR_NO_REGISTER && !getCTypeName(function->registerTypes[destination]);
+
+            for (int operand = 0; operand < 2; operand++) {
+                int reg = instruction->operands[operand];
+                isUnknown |= reg != IR_NO_REGISTER && !getCTypeName(function->registerTypes[reg]);
+            }
+
+            if (isUnknown) {
+                fprintf(stderr, "[BackendError]: The value at location %d:%d of module '%s' has an unknown type.\n",
+                        location.line, location.column, moduleName);
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+// Appends the declarations of the registers used by a function (except its parameters and the globals), grouped by
+// type, where a register left unused by the optimizer is not declared
+static void appendCRegisterDeclarations(CEmitter *emitter, IRFunction *function) {
+    static const IRType types[] = {IR_TYPE_INT, IR_TYPE_FLOAT, IR_TYPE_BOOL, IR_TYPE_STRING, IR_TYPE_INT8,
+                                   IR_TYPE_INT16, IR_TYPE_UINT8, IR_TYPE_UINT16, IR_TYPE_UINT32, IR_TYPE_VEC4F,
+                                   IR_TYPE_VEC8F, IR_TYPE_VEC4I, IR_TYPE_VEC8I, IR_TYPE_MASK4, IR_TYPE_MASK8};
+    int isEntryFunction = (function == emitter->program->functions[0]);
+    int isDeclared = 0;
+
+    unsigned char *isUsed = (unsigned char*) calloc(function->registerCount + 1, 1);
+    if (!isUsed) return;
+
+    for (int block = 0; block < function->blockCount; block++) {
+        for (int index = 0; index < function->blocks[block]->instructionCount; index++) {
+            IRInstruction *instruction = &function->blocks[block]->instructions[index];
+            if (instruction->opcode == IR_DECLARE) continue;
+            if (instruction->destination != IR_NO_REGISTER) isUsed[instruction->destination] = 1;
+            if (instruction->operands[0] != IR_NO_REGISTER) isUsed[instruction->operands[0]] = 1;
+            if (instruction->operands[1] != IR_NO_REGISTER) isUsed[instruction->operands[1]] = 1;
+        }
+    }
+
+    for (int type = 0; type < (int) (sizeof(types) / sizeof(types[0])); type++) {
+        int count = 0;
+
+        for (int reg = function->parameterCount; reg < function->registerCount; reg++) {
+            if (function->registerTypes[reg] != types[type] || !isUsed[reg]) continue;
+            if (isEntryFunction && reg < function->localCount && function->locals[reg].isGlobal) continue;
+
+            // A long list is continued by another declaration
+            const char *format = count == 0 ? "    %s r%d" : ";\n    %s r%d";
+            if (count % 16 == 0) appendC(emitter->buffer, format, getCTypeName(types[type]), reg);
+            else appendC(emitter->buffer, ", r%d", reg);
+            count++;
+        }
+
+        if (count > 0) appendC(emitter->buffer, ";\n");
+        isDeclared |= count > 0;
+    }
+
+    if (isDeclared) appendC(emitter->buffer, "\n");
+    free(isUsed);
+}
+
+// Appends a call to a checked operation of the runtime, which is given the location to report an overflow at
+static void appendCCheckedCall(CEmitter *emitter, IRFunction *function, const char *name, int lhs, int rhs,
+                               Location location) {
+    appendC(emitter->buffer, "%s(", name);
+    appendCRegister(emitter, function, lhs);
+
+    if (rhs != IR_NO_REGISTER) {
+        appendC(emitter->buffer, ", ");
+        appendCRegister(emitter, function, rhs);
+    }
+
+    appendC(emitter->buffer, ", %d, %d)", location.line, location.column);
+}
+
+// Appends an operation on vectors, which the C compiler emits as SIMD instructions, where Int lanes wrap around on
+// unsigned lanes like an Int (unless their overflow is checked) and a division is computed lane by lane
+static void appendCVectorOperation(CEmitter *emitter, IRFunction *function, IRInstruction *instruction) {
+    static const char *operators[] = {"+", "-", "*", "/", "%"};
+    static const char *comparisons[] = {"==", "!=", "<", "<=", ">", ">="};
+    static const char *checked[] = {"opusAddChecked", "opusSubtractChecked", "opusMultiplyChecked",
+                                    "opusDivideChecked"};
+    CBuffer *buffer = emitter->buffer;
+    int lhs = instruction->operands[0];
+    int rhs = instruction->operands[1];
+    IRType type = function->registerTypes[lhs];
+    int lanes = getIRVectorLanes(type);
+    int isFloat = getIRLaneType(type) == IR_TYPE_FLOAT;
+    int isChecked = emitter->program->isOverflowChecked && getIRLaneType(type) == IR_TYPE_INT;
+    IROpcode opcode = instruction->opcode;
+    Location location = instruction->location;
+
+    if (opcode >= IR_EQUAL) {
+        appendCRegister(emitter, function, lhs);
+        appendC(buffer, " %s ", comparisons[opcode - IR_EQUAL]);
+        appendCRegister(emitter, function, rhs);
+    } else if (opcode == IR_NOT) {
+        appendC(buffer, "~");
+        appendCRegister(emitter, function, lhs);
+    } else if (opcode == IR_NEGATE) {
+        if (isChecked) appendC(buffer, "opusSubtractCheckedVec%di((OpusVec%di) {0}, ", lanes, lanes);
+        else appendC(buffer, isFloat ? "-" : "(OpusVec%di) -(OpusVec%du) ", lanes, lanes);
+        appendCRegister(emitter, function, lhs);
+        if (isChecked) appendC(buffer, ", %d, %d)", location.line, location.column);
+    } else if (isChecked || opcode == IR_MODULO || (opcode == IR_DIVIDE && !isFloat)) {
+        char name[LEXEME_LENGTH];
+        snprintf(name, sizeof(name), "%sVec%d%c", opcode == IR_MODULO ? "opusModulo"
+                                                : isChecked ? checked[opcode - IR_ADD] : "opusDivide",
+                 lanes, isFloat ? 'f' : 'i');
+        appendCCheckedCall(emitter, function, name, lhs, rhs, location);
+    } else if (isFloat) {
+        appendCRegister(emitter, function, lhs);
+        appendC(buffer, " %s ", operators[opcode - IR_ADD]);
+        appendCRegister(emitter, function, rhs);
+    } else {
+        appendC(buffer, "(OpusVec%di) ((OpusVec%du) ", lanes, lanes);
+        appendCRegister(emitter, function, lhs);
+        appendC(buffer, " %s (OpusVec%du) ", operators[opcode - IR_ADD], lanes);
+        appendCRegister(emitter, function, rhs);
+        appendC(buffer, ")");
+    }
+}
+
+// Appends an instruction (except a terminator), where arguments are held until the call that passes them
+static void appendCInstruction(CEmitter *emitter, IRFunction *function, IRInstruction *instruction, int *arguments,
+                               int *argumentCount) {
+    CBuffer *buffer = emitter->buffer;
+    IRProgram *program = emitter->program;
+    int lhs = instruction->operands[0];
+    int rhs = instruction->operands[1];
+    int immediate = instruction->constant.integerValue;
+    int isFloat = lhs != IR_NO_REGISTER && function->registerTypes[lhs] == IR_TYPE_FLOAT;
+    int isChecked = program->isOverflowChecked && instruction->type == IR_TYPE_INT;
+    Location location = instruction->location;
+
+    switch (instruction->opcode) {
+        case IR_DECLARE: return;
+
+        case IR_ARGUMENT: {
+            if (*argumentCount < LEXEME_LENGTH) arguments[(*argumentCount)++] = lhs;
+            return;
+        }
+
+        case IR_STORE_GLOBAL: {
+            appendC(buffer, "    ");
+            appendCSymbol(buffer, emitter->module, program->functions[0]->locals[immediate].identifier);
+            appendC(buffer, " = ");
+            appendCRegister(emitter, function, lhs);
+            appendC(buffer, ";\n");
+            return;
+        }
+
+        // A lane is replaced in a copy of the vector, where a lane of a mask holding is -1
+        case IR_INSERT_LANE: {
+            if (instruction->destination != lhs) {
+                appendC(buffer, "    ");
+                appendCRegister(emitter, function, instruction->destination);
+                appendC(buffer, " = ");
+                appendCRegister(emitter, function, lhs);
+                appendC(buffer, ";\n");
+            }
+
+            appendC(buffer, "    ");
+            appendCRegister(emitter, function, instruction->destination);
+            appendC(buffer, getIRLaneType(instruction->type) == IR_TYPE_BOOL ? "[%d] = -" : "[%d] = ", immediate);
+            appendCRegister(emitter, function, rhs);
+            appendC(buffer, ";\n");
+            return;
+        }
+
+        default: break;
+    }
+
+    appendC(buffer, "    ");
+
+    if (instruction->destination != IR_NO_REGISTER) {
+        appendCRegister(emitter, function, instruction->destination);
+        appendC(buffer, " = ");
+    }
+
+    IROpcode opcode = instruction->opcode;
+    if (lhs != IR_NO_REGISTER && isIRVectorType(function->registerTypes[lhs]) && opcode != IR_COPY &&
+        opcode != IR_EXTRACT_LANE) {
+        appendCVectorOperation(emitter, function, instruction);
+        appendC(buffer, ";\n");
+        return;
+    }
+
+    switch (opcode) {
+        case IR_CONSTANT: {
+            if (instruction->type == IR_TYPE_FLOAT) appendCFloat(buffer, instruction->constant.floatingValue);
+            else if (instruction->type == IR_TYPE_BOOL) appendC(buffer, "%d", instruction->constant.booleanValue != 0);
+            else if (instruction->type == IR_TYPE_STRING) {
+                appendCString(buffer, program->strings[instruction->constant.stringIndex]);
+            }
+            else appendC(buffer, "%d", instruction->constant.integerValue);
+            break;
+        }
+
+        case IR_LOAD_GLOBAL: {
+            appendCSymbol(buffer, emitter->module, program->functions[0]->locals[immediate].identifier);
+            break;
+        }
+
+        case IR_COPY: appendCRegister(emitter, function, lhs); break;
+
+        // A vector is built by a compound literal, which the C compiler emits as a broadcast
+        case IR_SPLAT: {
+            int isMask = getIRLaneType(instruction->type) == IR_TYPE_BOOL;
+            appendC(buffer, "(%s) {", getCTypeName(instruction->type));
+
+            for (int lane = 0; lane < getIRVectorLanes(instruction->type); lane++) {
+                appendC(buffer, lane > 0 ? (isMask ? ", -" : ", ") : (isMask ? "-" : ""));
+                appendCRegister(emitter, function, lhs);
+            }
+
+            appendC(buffer, "}");
+            break;
+        }
+
+        case IR_EXTRACT_LANE: {
+            appendCRegister(emitter, function, lhs);
+            appendC(buffer, instruction->type == IR_TYPE_BOOL ? "[%d] != 0" : "[%d]", immediate);
+            break;
+        }
+        case IR_CONVERT: appendC(buffer, "(OpusFloat) "); appendCRegister(emitter, function, lhs); break;
+
+        // Int arithmetic wraps around (unless its overflow is checked), which is computed on unsigned integers since a
+        // signed overflow is undefined in C
+        case IR_ADD: case IR_SUBTRACT: case IR_MULTIPLY: {
+            const char *operator = instruction->opcode == IR_ADD ? "+" : instruction->opcode == IR_SUBTRACT ? "-" : "*";
+
+            if (isChecked) {
+                const char *name = instruction->opcode == IR_ADD ? "opusAddChecked"
+                                 : instruction->opcode == IR_SUBTRACT ? "opusSubtractChecked" : "opusMultiplyChecked";
+                appendCCheckedCall(emitter, function, name, lhs, rhs, location);
+            } else if (isFloat) {
+                appendCRegister(emitter, function, lhs);
+                appendC(buffer, " %s ", operator);
+                appendCRegister(emitter, function, rhs);
+            } else {
+                appendC(buffer, "(OpusInt) ((uint32_t) ");
+                appendCRegister(emitter, function, lhs);
+                appendC(buffer, " %s (uint32_t) ", operator);
+                appendCRegister(emitter, function, rhs);
+                appendC(buffer, ")");
+            }
+
+            break;
+        }
+
+        // An Int division checks its divisor at runtime, while a Float division follows IEEE 754
+        case IR_DIVIDE: case IR_MODULO: {
+            int isDivision = (instruction->opcode == IR_DIVIDE);
+
+            if (isIRUnsigned(function, instruction)) {
+                appendC(buffer, isDivision ? "opusDivideUnsigned(" : "opusModuloUnsigned(");
+                appendCRegister(emitter, function, lhs);
+                appendC(buffer, ", ");
+                appendCRegister(emitter, function, rhs);
+                appendC(buffer, ", %d, %d)", location.line, location.column);
+            } else if (isFloat) {
+                if (!isDivision) appendC(buffer, "fmodf(");
+                appendCRegister(emitter, function, lhs);
+                appendC(buffer, isDivision ? " / " : ", ");
+                appendCRegister(emitter, function, rhs);
+                if (!isDivision) appendC(buffer, ")");
+            } else if (isChecked && isDivision) {
+                appendCCheckedCall(emitter, function, "opusDivideChecked", lhs, rhs, location);
+            } else {
+                appendC(buffer, isDivision ? "opusDivide(" : "opusModulo(");
+                appendCRegister(emitter, function, lhs);
+                appendC(buffer, ", ");
+                appendCRegister(emitter, function, rhs);
+                appendC(buffer, ", %d, %d)", location.line, location.column);
+            }
+
+            break;
+        }
+
+        case IR_NEGATE: {
+            if (isChecked) {
+                appendCCheckedCall(emitter, function, "opusNegateChecked", lhs, IR_NO_REGISTER, location);
+                break;
+            }
+
+            appendC(buffer, isFloat ? "-" : "(OpusInt) (0u - (uint32_t) ");
+            appendCRegister(emitter, function, lhs);
+            if (!isFloat) appendC(buffer, ")");
+            break;
+        }
+
+        case IR_NOT: appendC(buffer, "!"); appendCRegister(emitter, function, lhs); break;
+
+        case IR_FACTORIAL: {
+            if (isChecked) {
+                appendCCheckedCall(emitter, function, "opusFactorialChecked", lhs, IR_NO_REGISTER, location);
+                break;
+            }
+
+            appendC(buffer, "opusFactorial(");
+            appendCRegister(emitter, function, lhs);
+            appendC(buffer, ")");
+            break;
+        }
+
+        // Shifts, masks and high multiplications take an immediate as their second operand
+        case IR_SHIFT_LEFT: case IR_SHIFT_RIGHT_LOGICAL: {
+            appendC(buffer, "(OpusInt) ((uint32_t) ");
+            appendCRegister(emitter, function, lhs);
+            appendC(buffer, instruction->opcode == IR_SHIFT_LEFT ? " << %d)" : " >> %d)", immediate);
+            break;
+        }
+
+        case IR_SHIFT_RIGHT: appendCRegister(emitter, function, lhs); appendC(buffer, " >> %d", immediate); break;
+        case IR_BITWISE_AND: appendCRegister(emitter, function, lhs); appendC(buffer, " & %d", immediate); break;
+
+        case IR_MULTIPLY_HIGH: {
+            appendC(buffer, "(OpusInt) (((int64_t) ");
+            appendCRegister(emitter, function, lhs);
+            appendC(buffer, " * %d) >> 32)", immediate);
+            break;
+        }
+
+        // A value below the first value of the mask wraps around to a large bit, so a single test bounds it
+        case IR_BIT_TEST: {
+            appendC(buffer, "(uint32_t) ");
+            appendCRegister(emitter, function, lhs);
+            appendC(buffer, " - (uint32_t) ");
+            appendCRegister(emitter, function, rhs);
+            appendC(buffer, " < 32u && (%uu >> ((uint32_t) ", (unsigned) immediate);
+            appendCRegister(emitter, function, lhs);
+            appendC(buffer, " - (uint32_t) ");
+            appendCRegister(emitter, function, rhs);
+            appendC(buffer, ") & 1u)");
+            break;
+        }
+
+        case IR_STRING_HASH: {
+            appendC(buffer, "opusHashString(");
+            appendCRegister(emitter, function, lhs);
+            appendC(buffer, ", %d)", immediate);
+            break;
+        }
+
+        // Strings are compared by their content
+        case IR_EQUAL: case IR_NOT_EQUAL: case IR_LESS_THAN: case IR_LESS_OR_EQUAL:
+        case IR_GREATER_THAN: case IR_GREATER_OR_EQUAL: {
+            static const char *operators[] = {"==", "!=", "<", "<=", ">", ">="};
+            const char *operator = operators[instruction->opcode - IR_EQUAL];
+
+            if (function->registerTypes[lhs] == IR_TYPE_STRING) {
+                appendC(buffer, "strcmp(");
+                appendCRegister(emitter, function, lhs);
+                appendC(buffer, ", ");
+                appendCRegister(emitter, function, rhs);
+                appendC(buffer, ") %s 0", operator);
+            } else {
+                appendCRegister(emitter, function, lhs);
+                appendC(buffer, " %s ", operator);
+                appendCRegister(emitter, function, rhs);
+            }
+
+            break;
+        }
+
+        // A function of the program is called before an imported function of the same name
+        case IR_CALL: {
+            const char *callee = program->strings[instruction->constant.stringIndex];
+
+            if (findIRFunction(program, callee) > 0) appendCSymbol(buffer, emitter->module, callee);
+            else {
+                IRExternal *external = &program->externals[findIRExternal(program, callee, 1)];
+                char module[2 * LEXEME_LENGTH];
+                mangleCIdentifier(external->module, module, sizeof(module));
+                appendCSymbol(buffer, module, callee);
+            }
+
+            appendC(buffer, "(");
+
+            // The arguments of a call are the last ones passed before it
+            int first = *argumentCount - instruction->argumentCount;
+
+            for (int argument = first < 0 ? 0 : first; argument < *argumentCount; argument++) {
+                if (argument > first) appendC(buffer, ", ");
+                appendCRegister(emitter, function, arguments[argument]);
+            }
+
+            *argumentCount = first < 0 ? 0 : first;
+            appendC(buffer, ")");
+            break;
+        }
+
+        default: break;
+    }
+
+    appendC(buffer, ";\n");
+}
+
+// Appends a terminator, where a jump to the block emitted next falls through
+static void appendCTerminator(CEmitter *emitter, IRFunction *function, IRInstruction *instruction, int nextBlock) {
+    CBuffer *buffer = emitter->buffer;
+    int isEntryFunction = (function == emitter->program->functions[0]);
+
+    switch (instruction->opcode) {
+        case IR_JUMP: {
+            if (instruction->targets[0] != nextBlock) appendC(buffer, "    goto b%d;\n", instruction->targets[0]);
+            break;
+        }
+
+        case IR_BRANCH: {
+            int trueBlock = instruction->targets[0];
+            int falseBlock = instruction->targets[1];
+
+            appendC(buffer, trueBlock == nextBlock ? "    if (!" : "    if (");
+            appendCRegister(emitter, function, instruction->operands[0]);
+            appendC(buffer, ") goto b%d;\n", trueBlock == nextBlock ? falseBlock : trueBlock);
+            if (trueBlock != nextBlock && falseBlock != nextBlock) appendC(buffer, "    goto b%d;\n", falseBlock);
+            break;
+        }
+
+        // The C compiler chooses how to dispatch the cases, leaving out those going to the default block
+        case IR_SWITCH: {
+            IRSwitchTable *table = &function->switchTables[instruction->constant.integerValue];
+
+            appendC(buffer, "    switch (");
+            appendCRegister(emitter, function, instruction->operands[0]);
+            appendC(buffer, ") {\n");
+
+            for (int entry = 0; entry < table->count; entry++) {
+                if (table->targets[entry] == instruction->targets[0]) continue;
+                appendC(buffer, "        case %d: goto b%d;\n", (int) ((uint32_t) table->low + (uint32_t) entry),
+                        table->targets[entry]);
+            }
+
+            appendC(buffer, "        default: goto b%d;\n    }\n", instruction->targets[0]);
+            break;
+        }
+
+        // The top-level statements of the compiled file are the body of main(), which succeeds once they have run
+        default: {
+            if (isEntryFunction) appendC(buffer, emitter->isEntry ? "    return 0;\n" : "    return;\n");
+            else if (instruction->operands[0] != IR_NO_REGISTER) {
+                appendC(buffer, "    return ");
+                appendCRegister(emitter, function, instruction->operands[0]);
+                appendC(buffer, ";\n");
+            }
+            else if (isIRVectorType(function->returnType)) {
+                appendC(buffer, "    return (%s) {0};\n", getCTypeName(function->returnType));
+            }
+            else appendC(buffer, function->returnType == IR_TYPE_VOID ? "    return;\n" : "    return 0;\n");
+            break;
+        }
+    }
+}
+
+// Appends the body of a function, whose reachable blocks are emitted in their layout order with a label for each
+// block reached by a jump
+static int appendCFunctionBody(CEmitter *emitter, IRFunction *function) {
+    int *order = (int*) malloc((function->blockCount + 1) * sizeof(int));
+    int *isLabeled = (int*) calloc(function->blockCount + 1, sizeof(int));
+    int *arguments = (int*) malloc(LEXEME_LENGTH * sizeof(int));
+
+    if (!order || !isLabeled || !arguments) {
+        free(order); free(isLabeled); free(arguments);
+        return 0;
+    }
+
+    int orderCount = computeLayoutOrder(function, order);
+
+    // A block needs a label unless it is only reached by falling through from the block emitted before it
+    for (int position = 0; position < orderCount; position++) {
+        BasicBlock *block = function->blocks[order[position]];
+        if (!isIRBlockTerminated(block)) continue;
+
+        IRInstruction *terminator = &block->instructions[block->instructionCount - 1];
+        int nextBlock = position + 1 < orderCount ? order[position + 1] : IR_NO_BLOCK;
+
+        if (terminator->opcode == IR_JUMP && terminator->targets[0] != nextBlock) isLabeled[terminator->targets[0]] = 1;
+
+        if (terminator->opcode == IR_BRANCH) {
+            if (terminator->targets[0] == nextBlock) isLabeled[terminator->targets[1]] = 1;
+            else {
+                isLabeled[terminator->targets[0]] = 1;
+                if (terminator->targets[1] != nextBlock) isLabeled[terminator->targets[1]] = 1;
+            }
+        }
+
+        if (terminator->opcode == IR_SWITCH) {
+            IRSwitchTable *table = &function->switchTables[terminator->constant.integerValue];
+            isLabeled[terminator->targets[0]] = 1;
+            for (int entry = 0; entry < table->count; entry++) isLabeled[table->targets[entry]] = 1;
+        }
+    }
+
+    appendCRegisterDeclarations(emitter, function);
+
+    for (int position = 0; position < orderCount; position++) {
+        BasicBlock *block = function->blocks[order[position]];
+        int nextBlock = position + 1 < orderCount ? order[position + 1] : IR_NO_BLOCK;
+        int argumentCount = 0;
+
+        if (isLabeled[block->index]) appendC(emitter->buffer, "b%d:\n", block->index);
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+
+            if (isIRTerminator(instruction->opcode)) appendCTerminator(emitter, function, instruction, nextBlock);
+            else appendCInstruction(emitter, function, instruction, arguments, &argumentCount);
+        }
+
+        // A block left unterminated by the optimizer ends the function
+        if (!isIRBlockTerminated(block)) {
+            IRInstruction terminator = {IR_RETURN, IR_TYPE_VOID, IR_NO_REGISTER, {IR_NO_REGISTER, IR_NO_REGISTER},
+                                        {IR_NO_BLOCK, IR_NO_BLOCK}, {0}, 0, function->location};
+            appendCTerminator(emitter, function, &terminator, IR_NO_BLOCK);
+        }
+    }
+
+    free(order);
+    free(isLabeled);
+    free(arguments);
+    return 1;
+}
+
+// Appends the comment heading an emitted file
+static void appendCFileHeading(CBuffer *buffer, const char *name, const char *moduleName) {
+    appendC(buffer, "// %s\n//\n// Generated by the Opus compiler from module '%s'.\n//\n\n", name, moduleName);
+}
+
+// Appends the header of a module, declaring its globals, its functions and the imported functions it calls
+static void appendCModuleHeader(CEmitter *emitter, const char *name, const char *moduleName) {
+    CBuffer *buffer = emitter->buffer;
+    IRProgram *program = emitter->program;
+    IRFunction *entry = program->functions[0];
+    IRType parameterTypes[IR_MAX_PARAMETERS];
+
+    appendCFileHeading(buffer, name, moduleName);
+    appendC(buffer, "#ifndef OPUS_%s_H\n#define OPUS_%s_H\n\n#include \"%s\"\n\n", emitter->module, emitter->module,
+            EMITTER_RUNTIME_HEADER);
+
+    for (int local = 0; local < entry->localCount; local++) {
+        if (!entry->locals[local].isGlobal) continue;
+
+        appendC(buffer, "extern %s ", getCTypeName(entry->locals[local].type));
+        appendCSymbol(buffer, emitter->module, entry->locals[local].identifier);
+        appendC(buffer, ";\n");
+    }
+
+    for (int index = 1; index < program->functionCount; index++) {
+        IRFunction *function = program->functions[index];
+        getCParameterTypes(function, parameterTypes);
+        appendCPrototype(buffer, emitter->module, function->name, function->returnType, parameterTypes,
+                         function->parameterCount, 0);
+        appendC(buffer, ";\n");
+    }
+
+    // An imported function is only declared if its signature could be represented, otherwise it is never called
+    for (int index = 0; index < program->externalCount; index++) {
+        IRExternal *external = &program->externals[index];
+        int isRepresentable = external->isFunction && getCTypeName(external->type);
+        for (int parameter = 0; parameter < external->parameterCount; parameter++) {
+            isRepresentable = isRepresentable && getCTypeName(external->parameterTypes[parameter]);
+        }
+
+        if (!isRepresentable) continue;
+
+        char module[2 * LEXEME_LENGTH];
+        mangleCIdentifier(external->module, module, sizeof(module));
+        appendCPrototype(buffer, module, external->identifier, external->type, external->parameterTypes,
+                         external->parameterCount, 0);
+        appendC(buffer, ";\n");
+    }
+
+    if (!emitter->isEntry) appendC(buffer, "void opusInit_%s(void);\n", emitter->module);
+    appendC(buffer, "\n#endif\n");
+}
+
+// Appends the unit 0 of a module, that is its globals and its top-level statements
+static int appendCEntryUnit(CEmitter *emitter, const char *name, const char *moduleName, const char *header,
+                            char initializers[][LEXEME_LENGTH], int initializerCount) {
+    CBuffer *buffer = emitter->buffer;
+    IRFunction *entry = emitter->program->functions[0];
+
+    appendCFileHeading(buffer, name, moduleName);
+    appendC(buffer, "#include \"%s\"\n\n", header);
+
+    int globalCount = 0;
+
+    for (int local = 0; local < entry->localCount; local++) {
+        if (!entry->locals[local].isGlobal) continue;
+
+        appendC(buffer, "%s ", getCTypeName(entry->locals[local].type));
+        appendCSymbol(buffer, emitter->module, entry->locals[local].identifier);
+        appendC(buffer, ";\n");
+        globalCount++;
+    }
+
+    if (globalCount > 0) appendC(buffer, "\n");
+
+    // The imported modules initialize their globals before the top-level statements of the compiled file run, where
+    // a module imported indirectly is not declared by any header the compiled file includes
+    if (emitter->isEntry) {
+        char module[2 * LEXEME_LENGTH];
+
+        for (int index = 0; index < initializerCount; index++) {
+            mangleCIdentifier(initializers[index], module, sizeof(module));
+            appendC(buffer, "void opusInit_%s(void);\n", module);
+        }
+
+        appendC(buffer, "%sint main(void) {\n", initializerCount > 0 ? "\n" : "");
+
+        for (int index = 0; index < initializerCount; index++) {
+            mangleCIdentifier(initializers[index], module, sizeof(module));
+            appendC(buffer, "    opusInit_%s();\n", module);
+        }
+
+        if (initializerCount > 0) appendC(buffer, "\n");
+    } else appendC(buffer, "void opusInit_%s(void) {\n", emitter->module);
+
+    int isEmitted = appendCFunctionBody(emitter, entry);
+    appendC(buffer, "}\n");
+    return isEmitted;
+}
+
+int emitCModule(IRProgram *program, const char *moduleName, char initializers[][LEXEME_LENGTH], int initializerCount,
+                int isEntry, const char *directory, uint64_t stamp) {
+    for (int index = 0; index < program->functionCount; index++) {
+        if (!checkCFunction(program, program->functions[index], moduleName)) return 0;
+    }
+
+    CBuffer buffer = {NULL, 0, 0, 0};
+    CEmitter emitter;
+    emitter.program = program;
+    emitter.isEntry = isEntry;
+    emitter.buffer = &buffer;
+    mangleCIdentifier(moduleName, emitter.module, sizeof(emitter.module));
+
+    CManifest *manifest = (CManifest*) calloc(1, sizeof(CManifest));
+    CManifest *previous = (CManifest*) calloc(1, sizeof(CManifest));
+    int *units = (int*) malloc(program->functionCount * sizeof(int));
+
+    if (!manifest || !previous || !units) {
+        free(manifest); free(previous); free(units);
+        return 0;
+    }
+
+    int hasPrevious = readCManifest(directory, moduleName, previous);
+    manifest->stamp = stamp;
+    snprintf(manifest->header, EMITTER_NAME_LENGTH, "%s.h", moduleName);
+
+    // A unit ends after a function whose name hashes to a multiple of EMITTER_UNIT_FUNCTIONS (or once it is large),
+    // so the boundaries only move around a function that has been added, removed or renamed
+    int current = 0;
+    int instructionCount = 0;
+    units[0] = 0;
+    manifest->unitCount = 1;
+
+    for (int index = 1; index < program->functionCount; index++) {
+        IRFunction *function = program->functions[index];
+
+        if (current == 0) {
+            current = manifest->unitCount++;
+            instructionCount = 0;
+        }
+
+        units[index] = current;
+        for (int block = 0; block < function->blockCount; block++) {
+            instructionCount += function->blocks[block]->instructionCount;
+        }
+
+        uint64_t hash = hashBytes(function->name, strlen(function->name), INTERFACE_HASH_SEED);
+        int isBoundary = hash % EMITTER_UNIT_FUNCTIONS == 0 || instructionCount >= EMITTER_UNIT_INSTRUCTIONS;
+        if (isBoundary && manifest->unitCount < EMITTER_MAX_UNITS) current = 0;
+    }
+
+    for (int unit = 0; unit < manifest->unitCount; unit++) {
+        snprintf(manifest->units[unit], EMITTER_NAME_LENGTH, "%s_%d.c", moduleName, unit);
+    }
+
+    int result = writeCFile(directory, EMITTER_RUNTIME_HEADER, runtimeHeader, strlen(runtimeHeader));
+
+    appendCModuleHeader(&emitter, manifest->header, moduleName);
+    result = result && !buffer.isFailed && writeCFile(directory, manifest->header, buffer.text, buffer.length);
+
+    // Every unit includes the header of its module, which declares whatever another unit defines
+    for (int unit = 0; unit < manifest->unitCount && result; unit++) {
+        buffer.length = 0;
+
+        if (unit == 0) {
+            result = appendCEntryUnit(&emitter, manifest->units[0], moduleName, manifest->header, initializers,
+                                      initializerCount);
+        } else {
+            appendCFileHeading(&buffer, manifest->units[unit], moduleName);
+            appendC(&buffer, "#include \"%s\"\n", manifest->header);
+
+            for (int index = 1; index < program->functionCount && result; index++) {
+                if (units[index] != unit) continue;
+
+                IRFunction *function = program->functions[index];
+                IRType parameterTypes[IR_MAX_PARAMETERS];
+                getCParameterTypes(function, parameterTypes);
+
+                appendC(&buffer, "\n");
+                appendCPrototype(&buffer, emitter.module, function->name, function->returnType, parameterTypes,
+                                 function->parameterCount, 1);
+                appendC(&buffer, " {\n");
+                result = appendCFunctionBody(&emitter, function);
+                appendC(&buffer, "}\n");
+            }
+        }
+
+        result = result && !buffer.isFailed && writeCFile(directory, manifest->units[unit], buffer.text, buffer.length);
+    }
+
+    // The units left over from the last emission of the module would only confuse whoever reads the directory
+    for (int unit = manifest->unitCount; hasPrevious && result && unit < previous->unitCount; unit++) {
+        char path[EMITTER_PATH_LENGTH];
+        snprintf(path, sizeof(path), "%s/%s", directory, previous->units[unit]);
+        remove(path);
+    }
+
+    // The manifest is written last, so that it only lists a complete emission
+    if (result) {
+        buffer.length = 0;
+        appendC(&buffer, "stamp %016" PRIx64 "\nheader %s\n", manifest->stamp, manifest->header);
+        for (int unit = 0; unit < manifest->unitCount; unit++) appendC(&buffer, "unit %s\n", manifest->units[unit]);
+
+        char name[EMITTER_NAME_LENGTH];
+        snprintf(name, sizeof(name), "%s%s", moduleName, EMITTER_MANIFEST_EXTENSION);
+        result = !buffer.isFailed && writeCFile(directory, name, buffer.text, buffer.length);
+    }
+
+    free(buffer.text);
+    free(manifest);
+    free(previous);
+    free(units);
+    return result;
+}
+
+int readCManifest(const char *directory, const char *moduleName, CManifest *manifest) {
+    char path[EMITTER_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/%s%s", directory, moduleName, EMITTER_MANIFEST_EXTENSION);
+
+    FILE *file = fopen(path, "rb");
+    if (!file) return 0;
+
+    char line[EMITTER_PATH_LENGTH];
+    int isStamped = 0;
+    manifest->unitCount = 0;
+    manifest->header[0] = '\0';
+
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (strncmp(line, "stamp ", 6) == 0) isStamped = sscanf(line + 6, "%" SCNx64, &manifest->stamp) == 1;
+        else if (strncmp(line, "header ", 7) == 0) snprintf(manifest->header, EMITTER_NAME_LENGTH, "%s", line + 7);
+        else if (strncmp(line, "unit ", 5) == 0 && manifest->unitCount < EMITTER_MAX_UNITS) {
+            snprintf(manifest->units[manifest->unitCount++], EMITTER_NAME_LENGTH, "%s", line + 5);
+        }
+    }
+
+    fclose(file);
+    return isStamped && manifest->header[0] != '\0' && manifest->unitCount > 0;
+}
@@ -0,0 +1,278 @@
+// toolchain.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#else
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#endif
+#include "toolchain.h"
+#include "interface.h"
+#include "metrics.h"
+
+/// A translation unit to compile into the object cache.
+typedef struct {
+    char source[EMITTER_PATH_LENGTH];   /// The path of the unit.
+    char object[EMITTER_PATH_LENGTH];   /// The path of its object in the cache.
+    uint64_t key;                       /// The hash of everything the object is compiled from.
+    int isCached;                       /// Whether the object is already in the cache (or compiled by another unit).
+    long pid;                           /// The process compiling the unit, or 0.
+} CUnit;
+
+/// The compiler and its flags, split into the words starting every command.
+typedef struct {
+    char text[EMITTER_PATH_LENGTH];          /// The compiler and its flags, separated by blanks.
+    char *words[TOOLCHAIN_MAX_WORDS];        /// The words of the text.
+    int wordCount;                           /// The number of words.
+} CCompiler;
+
+// Reads the compiler and its flags from the environment, where a blank separates two words
+static void initCCompiler(CCompiler *compiler) {
+    const char *name = getenv("CC") && *getenv("CC") ? getenv("CC") : TOOLCHAIN_COMPILER;
+    const char *flags = getenv("CFLAGS") ? getenv("CFLAGS") : TOOLCHAIN_FLAGS;
+    snprintf(compiler->text, sizeof(compiler->text), "%s %s", name, flags);
+
+    // The words are split from a copy, since the text is hashed into every key as it is
+    static char words[EMITTER_PATH_LENGTH];
+    strcpy(words, compiler->text);
+    compiler->wordCount = 0;
+
+    for (char *word = strtok(words, " \t"); word; word = strtok(NULL, " \t")) {
+        if (compiler->wordCount < TOOLCHAIN_MAX_WORDS) compiler->words[compiler->wordCount++] = word;
+    }
+}
+
+// Hashes a whole file into a hash, where a missing file fails
+static int hashCFile(const char *path, uint64_t *hash) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return 0;
+
+    unsigned char bytes[4096];
+    size_t length;
+
+    while ((length = fread(bytes, 1, sizeof(bytes), file)) > 0) *hash = hashBytes(bytes, length, *hash);
+    fclose(file);
+    return 1;
+}
+
+// Runs a command (a NULL-terminated list of words) and waits for it to finish
+static int runCCommand(char **arguments) {
+#ifndef _WIN32
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+
+    if (pid == 0) {
+        execvp(arguments[0], arguments);
+        fprintf(stderr, "[BackendError]: C compiler '%s' could not be run.\n", arguments[0]);
+        _exit(EXIT_FAILURE);
+    }
+
+    int status = 0;
+    return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+#else
+    char command[8 * EMITTER_PATH_LENGTH] = "";
+    size_t length = 0;
+
+    for (int index = 0; arguments[index] && length < sizeof(command); index++) {
+        length += snprintf(command + length, sizeof(command) - length, index ? " \"%s\"" : "%s", arguments[index]);
+    }
+
+    return system(command) == 0;
+#endif
+}
+
+// Moves the object compiled by a process into the cache, where the temporary object is named after the process
+static int finishCUnit(CUnit *unit, long pid, int isSucceeded) {
+    char temporary[EMITTER_PATH_LENGTH + 32];
+    snprintf(temporary, sizeof(temporary), "%s.%ld.tmp", unit->object, pid);
+    unit->pid = 0;
+
+    // Renaming is atomic, so another build sharing the cache never reads half an object
+    if (isSucceeded && rename(temporary, unit->object) == 0) return 1;
+
+    remove(temporary);
+    fprintf(stderr, "[BackendError]: Unit '%s' could not be compiled.\n", unit->source);
+    return 0;
+}
+
+// Compiles every unit missing from the cache, running up to `jobCount` compilers at the same time
+static int compileCUnits(CCompiler *compiler, CUnit *units, int unitCount, int jobCount) {
+    char *arguments[TOOLCHAIN_MAX_WORDS + 8];
+    char temporary[EMITTER_PATH_LENGTH + 32];
+    int runningCount = 0;
+    int result = 1;
+
+    memcpy(arguments, compiler->words, compiler->wordCount * sizeof(char*));
+    arguments[compiler->wordCount] = "-c";
+    arguments[compiler->wordCount + 2] = "-o";
+    arguments[compiler->wordCount + 3] = temporary;
+    arguments[compiler->wordCount + 4] = NULL;
+
+    for (int index = 0; index <= unitCount; index++) {
+        // Once every job is busy (or every unit has started), wait for a compiler to finish
+        while (runningCount > 0 && (runningCount >= jobCount || index == unitCount)) {
+#ifndef _WIN32
+            int status = 0;
+            pid_t pid = wait(&status);
+            int isSucceeded = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+
+            for (int other = 0; other < unitCount; other++) {
+                // No child is left, which only happens if the children have been reaped elsewhere
+                if (pid < 0 && units[other].pid) result = finishCUnit(&units[other], units[other].pid, 0) && result;
+                if (pid < 0 || units[other].pid != (long) pid) continue;
+
+                result = finishCUnit(&units[other], (long) pid, isSucceeded) && result;
+                runningCount--;
+                break;
+            }
+
+            if (pid < 0) runningCount = 0;
+#endif
+        }
+
+        if (index == unitCount || units[index].isCached || !result) continue;
+
+        arguments[compiler->wordCount + 1] = units[index].source;
+
+        // The child names its object after itself, so that concurrent builds never write the same file
+#ifndef _WIN32
+        fflush(stdout);
+        fflush(stderr);
+        pid_t pid = fork();
+
+        if (pid == 0) {
+            snprintf(temporary, sizeof(temporary), "%s.%ld.tmp", units[index].object, (long) getpid());
+            execvp(arguments[0], arguments);
+            fprintf(stderr, "[BackendError]: C compiler '%s' could not be run.\n", arguments[0]);
+            _exit(EXIT_FAILURE);
+        }
+
+        if (pid > 0) {
+            units[index].pid = (long) pid;
+            runningCount++;
+            continue;
+        }
+#endif
+
+        // Without processes, the unit is compiled right away
+        snprintf(temporary, sizeof(temporary), "%s.0.tmp", units[index].object);
+        result = finishCUnit(&units[index], 0, runCCommand(arguments));
+    }
+
+    return result;
+}
+
+int prepareCDirectory(const char *directory) {
+    char path[EMITTER_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/%s", directory, TOOLCHAIN_CACHE_DIRECTORY);
+    const char *paths[] = {directory, path};
+
+    for (int index = 0; index < 2; index++) {
+        if (mkdir(paths[index], 0755) != 0 && errno != EEXIST) {
+            fprintf(stderr, "[AccessError]: Directory '%s' could not be created.\n", paths[index]);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int buildCExecutable(const char *directory, char moduleNames[][LEXEME_LENGTH], int moduleCount, const char *outputPath,
+                     int jobCount) {
+    CCompiler compiler;
+    initCCompiler(&compiler);
+
+    CManifest *manifest = (CManifest*) malloc(sizeof(CManifest));
+    CUnit *units = NULL;
+    int unitCount = 0;
+    int result = manifest != NULL;
+
+    // Everything a unit includes goes into its key, together with the compiler and its flags
+    char path[EMITTER_PATH_LENGTH];
+    uint64_t runtimeHash = hashBytes(compiler.text, strlen(compiler.text), INTERFACE_HASH_SEED);
+    snprintf(path, sizeof(path), "%s/%s", directory, EMITTER_RUNTIME_HEADER);
+    result = result && hashCFile(path, &runtimeHash);
+
+    for (int module = 0; module < moduleCount && result; module++) {
+        if (!readCManifest(directory, moduleNames[module], manifest)) {
+            fprintf(stderr, "[BackendError]: Module '%s' has not been emitted into '%s'.\n", moduleNames[module],
+                    directory);
+            result = 0;
+            break;
+        }
+
+        uint64_t headerHash = runtimeHash;
+        snprintf(path, sizeof(path), "%s/%s", directory, manifest->header);
+        result = hashCFile(path, &headerHash);
+
+        CUnit *grown = (CUnit*) realloc(units, (unitCount + manifest->unitCount) * sizeof(CUnit));
+        if (!grown) result = 0;
+        else units = grown;
+
+        for (int index = 0; index < manifest->unitCount && result; index++) {
+            CUnit *unit = &units[unitCount++];
+            snprintf(unit->source, sizeof(unit->source), "%s/%s", directory, manifest->units[index]);
+            unit->key = headerHash;
+            unit->pid = 0;
+            result = hashCFile(unit->source, &unit->key);
+
+            snprintf(unit->object, sizeof(unit->object), "%s/%s/%016" PRIx64 "%s", directory,
+                     TOOLCHAIN_CACHE_DIRECTORY, unit->key, TOOLCHAIN_OBJECT_EXTENSION);
+
+            // Units of the same code (e.g. two empty modules) share their object
+            FILE *object = fopen(unit->object, "rb");
+            unit->isCached = object != NULL;
+            if (object) fclose(object);
+            for (int other = 0; other < unitCount - 1; other++) unit->isCached |= units[other].key == unit->key;
+        }
+    }
+
+    if (!result) fprintf(stderr, "[BackendError]: The C code in '%s' could not be read.\n", directory);
+
+    int compiledCount = 0;
+    for (int index = 0; index < unitCount; index++) compiledCount += !units[index].isCached;
+
+    result = result && compileCUnits(&compiler, units, unitCount, jobCount > 0 ? jobCount : 1);
+    addMetricCounter(METRIC_OBJECT_CACHE_HITS, (uint64_t) (unitCount - compiledCount));
+    addMetricCounter(METRIC_OBJECT_CACHE_MISSES, (uint64_t) compiledCount);
+    if (result) addMetricCounter(METRIC_NATIVE_COMPILATIONS, (uint64_t) compiledCount);
+
+    if (result) {
+        printf("[Backend] Compiled %d of %d units, reusing the others from the cache.\n", compiledCount, unitCount);
+    }
+
+    // The objects are linked in the order of the modules, where the math library holds fmodf() on Unix-like systems
+    char **arguments = result ? (char**) malloc((compiler.wordCount + unitCount + 4) * sizeof(char*)) : NULL;
+
+    if (arguments) {
+        int argumentCount = 0;
+        for (int word = 0; word < compiler.wordCount; word++) arguments[argumentCount++] = compiler.words[word];
+        for (int index = 0; index < unitCount; index++) arguments[argumentCount++] = units[index].object;
+        arguments[argumentCount++] = "-o";
+        arguments[argumentCount++] = (char*) outputPath;
+#ifndef _WIN32
+        arguments[argumentCount++] = "-lm";
+#endif
+        arguments[argumentCount] = NULL;
+
+        result = runCCommand(arguments);
+        if (result) printf("[Backend] Linked executable '%s'.\n", outputPath);
+        else fprintf(stderr, "[BackendError]: Executable '%s' could not be linked.\n", outputPath);
+    } else result = 0;
+
+    free(arguments);
+    free(manifest);
+    free(units);
+    return result;
+}
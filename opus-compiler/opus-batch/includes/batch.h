@@ -0,0 +1,97 @@
+// batch.h
+//
+// Batch evaluation of an Opus expression over columns of values (e.g. the formula "price * quantity > 100.0" over
+// millions of rows). The expression is compiled once against the names and the types of its inputs, through the same
+// parser, analyzer, lowering and optimizations as a program, into a function whose parameters are the inputs. The
+// function is then evaluated over a chunk of rows at a time, where each instruction runs as one loop over the whole
+// chunk (which the C compiler turns into SIMD code) rather than once per row. A branch (e.g. for '&&' and '||')
+// splits the rows of its block into a selection vector for each target, so that a block only runs on the rows
+// reaching it, and the right operand of '&&' is never evaluated on a row where the left operand is false.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdint.h>
+#include "ir.h"
+
+#define BATCH_FUNCTION        "formula"
+#define BATCH_MAX_INPUTS      IR_MAX_PARAMETERS
+#define BATCH_CHUNK_ROWS      1024
+
+/// An input of an expression, that is a name together with its type (Int, Float or Bool).
+typedef struct {
+    char name[LEXEME_LENGTH];   /// The name of the input, as it is referred to in the expression.
+    IRType type;                /// The type of its values.
+} BatchInput;
+
+/// A column of values, where an Int is an int32_t, a Float is a float and a Bool is an int32_t holding 0 or 1.
+typedef union {
+    int32_t *integers;      /// The values of an Int or a Bool column.
+    float *floats;          /// The values of a Float column.
+    void *values;           /// The values of any column.
+} BatchColumn;
+
+/// The value of a row in a register, whose member in use depends on the type of the register.
+typedef union {
+    int32_t integer;
+    float floating;
+} BatchLane;
+
+/// An expression compiled for batch evaluation.
+typedef struct {
+    IRProgram *program;               /// The program holding the function of the expression.
+    IRFunction *function;             /// The function evaluating the expression, whose parameters are the inputs.
+    IRType type;                      /// The type of the value of the expression.
+    int inputCount;                   /// The number of inputs.
+    int *order;                       /// The blocks in reverse post-order, where every branch jumps forward.
+    int blockCount;                   /// The number of blocks in the order.
+    int *definitionCounts;            /// The number of instructions defining each register.
+    IRConstant *values;               /// The registers of evaluateBatchRow(), which is therefore not reentrant.
+} BatchExpression;
+
+/// Compiles an expression over named inputs for batch evaluation. Any error (e.g. a syntax error, an undeclared
+/// input, a mismatched type or a value that is not an Int, a Float or a Bool) is reported into the list of
+/// diagnostics, at a location counted from the start of the expression.
+///
+/// @param expression The source code of the expression.
+/// @param inputs The inputs of the expression, in the order of the columns given to evaluateBatchExpression().
+/// @param inputCount The number of inputs, at most BATCH_MAX_INPUTS.
+/// @param diagnostics The list receiving the errors, or NULL to print them.
+/// @return A pointer to the compiled expression, or NULL if there is any error.
+///
+BatchExpression *compileBatchExpression(const char *expression, const BatchInput *inputs, int inputCount,
+                                        DiagnosticList *diagnostics);
+
+/// Evaluates an expression over every row of its input columns, BATCH_CHUNK_ROWS rows at a time, where each
+/// instruction runs over all the rows of its block in a chunk before the next instruction runs.
+///
+/// @param expression The compiled expression.
+/// @param columns The column of each input, each holding `rowCount` values.
+/// @param rowCount The number of rows.
+/// @param result The column receiving the value of the expression for each row.
+/// @return 1 (True) if every row has been evaluated, 0 (False) if a row fails (e.g. a division by zero, which is
+///         reported together with the row).
+///
+int evaluateBatchExpression(BatchExpression *expression, const BatchColumn *columns, int64_t rowCount,
+                            BatchColumn result);
+
+/// Evaluates an expression over a single row, by interpreting its instructions one at a time. It gives the same
+/// values as evaluateBatchExpression(), which it is measured against, but it could not run on two threads at once.
+///
+/// @param expression The compiled expression.
+/// @param columns The column of each input.
+/// @param row The index of the row to evaluate.
+/// @param result The column receiving the value of the expression at the same row.
+/// @return 1 (True) if the row has been evaluated, 0 (False) if it fails (which is reported).
+///
+int evaluateBatchRow(BatchExpression *expression, const BatchColumn *columns, int64_t row, BatchColumn result);
+
+/// Frees a compiled expression.
+/// @param expression The expression to free.
+///
+void freeBatchExpression(BatchExpression *expression);
+
+#endif
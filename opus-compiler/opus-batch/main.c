@@ -0,0 +1,101 @@
+// main.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "batch.h"
+
+#define BENCHMARK_DEFAULT_ROWS   4000000
+
+// Fills a column with pseudo-random values (xorshift), where an Int is never 0 so that it could divide any row
+static void fillBenchmarkColumn(BatchColumn column, IRType type, int64_t rowCount, uint32_t *seed) {
+    for (int64_t row = 0; row < rowCount; row++) {
+        *seed ^= *seed << 13;
+        *seed ^= *seed >> 17;
+        *seed ^= *seed << 5;
+
+        if (type == IR_TYPE_FLOAT) column.floats[row] = (float) (*seed % 100000) / 100.0f;
+        else if (type == IR_TYPE_BOOL) column.integers[row] = (int32_t) (*seed & 1);
+        else column.integers[row] = (int32_t) (*seed % 1000) + 1;
+    }
+}
+
+// Reads an input given as '<name>:<Type>'
+static int parseBenchmarkInput(const char *argument, BatchInput *input) {
+    const char *colon = strchr(argument, ':');
+    if (!colon || colon == argument || (size_t) (colon - argument) >= sizeof(input->name)) return 0;
+
+    memcpy(input->name, argument, colon - argument);
+    input->name[colon - argument] = '\0';
+    input->type = getIRType(colon + 1);
+    return input->type != IR_TYPE_ANY;
+}
+
+int main(int argc, char *argv[]) {
+    const char *expression = NULL;
+    BatchInput inputs[BATCH_MAX_INPUTS];
+    int inputCount = 0;
+    int64_t rowCount = BENCHMARK_DEFAULT_ROWS;
+    int isValid = 1;
+
+    for (int index = 1; index < argc && isValid; index++) {
+        if (strncmp(argv[index], "--rows=", 7) == 0) rowCount = atoll(argv[index] + 7);
+        else if (!expression) expression = argv[index];
+        else isValid = inputCount < BATCH_MAX_INPUTS && parseBenchmarkInput(argv[index], &inputs[inputCount++]);
+    }
+
+    if (!isValid || !expression || rowCount <= 0) {
+        fprintf(stderr, "Usage: %s [--rows=<count>] <expression> [<name>:<Int|Float|Bool> ...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    BatchExpression *compiled = compileBatchExpression(expression, inputs, inputCount, NULL);
+    if (!compiled) return EXIT_FAILURE;
+
+    BatchColumn columns[BATCH_MAX_INPUTS];
+    BatchColumn rowResults = {.values = malloc(rowCount * sizeof(BatchLane))};
+    BatchColumn batchResults = {.values = malloc(rowCount * sizeof(BatchLane))};
+    int result = rowResults.values && batchResults.values;
+    uint32_t seed = 2463534242u;
+
+    for (int input = 0; input < inputCount; input++) {
+        columns[input].values = result ? malloc(rowCount * sizeof(BatchLane)) : NULL;
+        if (columns[input].values) fillBenchmarkColumn(columns[input], inputs[input].type, rowCount, &seed);
+        else result = 0;
+    }
+
+    if (!result) fprintf(stderr, "[BatchError]: Unable to allocate memory for %lld rows.\n", (long long) rowCount);
+
+    // The same rows are evaluated one at a time by interpreting the instructions, then a chunk at a time
+    clock_t start = clock();
+    for (int64_t row = 0; row < rowCount && result; row++) result = evaluateBatchRow(compiled, columns, row, rowResults);
+    double rowSeconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    result = result && evaluateBatchExpression(compiled, columns, rowCount, batchResults);
+    double batchSeconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    if (result && memcmp(rowResults.values, batchResults.values, rowCount * sizeof(BatchLane)) != 0) {
+        fprintf(stderr, "[BatchError]: The batch evaluation differs from the evaluation of each row.\n");
+        result = 0;
+    }
+
+    if (result) {
+        printf("[Batch] Expression of type %s over %lld rows, %d blocks.\n", getIRTypeName(compiled->type),
+               (long long) rowCount, compiled->blockCount);
+        printf("[Batch] Per-row interpreter: %.1f ms, %.1f million rows per second.\n", 1000.0 * rowSeconds,
+               rowSeconds > 0 ? rowCount / rowSeconds / 1e6 : 0.0);
+        printf("[Batch] Batch evaluation: %.1f ms, %.1f million rows per second (%.1fx).\n", 1000.0 * batchSeconds,
+               batchSeconds > 0 ? rowCount / batchSeconds / 1e6 : 0.0, batchSeconds > 0 ? rowSeconds / batchSeconds : 0.0);
+    }
+
+    for (int input = 0; input < inputCount; input++) free(columns[input].values);
+    free(rowResults.values);
+    free(batchResults.values);
+    freeBatchExpression(compiled);
+    return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
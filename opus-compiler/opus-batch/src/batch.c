@@ -0,0 +1,574 @@
+// batch.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <inttypes.h>
+#include <math.h>
+#include "batch.h"
+#include "parser.h"
+#include "analyzer.h"
+#include "dataflow.h"
+#include "fold.h"
+#include "pass.h"
+#include "vector.h"
+
+// Runs a statement on each row `k` of a block in a chunk, that is every row of the chunk if there is no selection,
+// where the loop over every row is the one the C compiler turns into SIMD code
+#define BATCH_LOOP(statement) \
+    if (!rows) { for (int k = 0; k < count; k++) { statement; } } \
+    else { for (int selected = 0; selected < count; selected++) { int k = rows[selected]; statement; } }
+
+/// The memory evaluating the chunks of an expression, allocated once for all of them.
+typedef struct {
+    BatchLane *storage;      /// The values of every register for the rows of a chunk.
+    BatchLane **lanes;       /// The values of each register, which might be the column of an input.
+    uint16_t *selections;    /// The rows reaching each block, BATCH_CHUNK_ROWS per block.
+    int *selectionCounts;    /// The number of rows reaching each block.
+} BatchState;
+
+// Opens a stream reading a text in memory, which the lexer reads like a file
+static FILE *openBatchStream(const char *text, size_t length) {
+#ifdef _WIN32
+    FILE *stream = tmpfile();
+    if (!stream) return NULL;
+
+    if (fwrite(text, 1, length, stream) != length) {
+        fclose(stream);
+        return NULL;
+    }
+
+    rewind(stream);
+    return stream;
+#else
+    return fmemopen((void*) text, length, "r");
+#endif
+}
+
+// Checks that every value of the function could be held by a lane, and that nothing is called, where a vector is
+// split into its lanes beforehand (so only the value of the expression could not be a vector)
+static int checkBatchFunction(IRProgram *program, IRFunction *function) {
+    if (isIRVectorType(function->returnType)) {
+        reportDiagnostic(program->diagnostics, function->location, "Value of type %s could not be evaluated in a "
+                         "batch, which only holds Int, Float and Bool values", getIRTypeName(function->returnType));
+        return 0;
+    }
+
+    if (!scalarizeIRProgram(program)) return 0;
+
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+
+            if (instruction->opcode == IR_CALL) {
+                reportDiagnostic(program->diagnostics, instruction->location, "Function '%s' could not be called "
+                                 "from a batch expression", program->strings[instruction->constant.stringIndex]);
+                return 0;
+            }
+
+            IRType type = instruction->destination >= 0 ? function->registerTypes[instruction->destination]
+                        : IR_TYPE_INT;
+
+            if (type != IR_TYPE_INT && type != IR_TYPE_FLOAT && type != IR_TYPE_BOOL) {
+                reportDiagnostic(program->diagnostics, instruction->location, "Value of type %s could not be "
+                                 "evaluated in a batch, which only holds Int, Float and Bool values",
+                                 getIRTypeName(type));
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+// Lowers an analyzed expression into a function returning its value, whose parameters are the inputs
+static IRProgram *lowerBatchExpression(ASTNode *root, const BatchInput *inputs, int inputCount,
+                                       DiagnosticList *diagnostics) {
+    Location location = {1, 1};
+    IRProgram *program = initIRProgram();
+    IRFunction *function = initIRFunction(BATCH_FUNCTION, IR_TYPE_VOID, location);
+
+    if (!program || !function) {
+        free(program);
+        if (function) freeIRFunction(function);
+        return NULL;
+    }
+
+    program->diagnostics = diagnostics;
+    addIRFunction(program, function);
+
+    for (int input = 0; input < inputCount; input++) {
+        int local = addIRLocal(function, inputs[input].name, inputs[input].type, location);
+        function->locals[local].isParameter = 1;
+        function->parameterCount++;
+    }
+
+    // The inputs are bound like the parameters of a function being built at depth 1
+    IRBuilder builder = {program, function, 0, NULL, 0, 0, 1, 0, 1, 1, NULL, -1, INT_MAX};
+    for (int local = 0; local < function->parameterCount; local++) bindIRLocal(&builder, local);
+
+    int value = lowerExpression(&builder, root);
+    IRInstruction *instruction = emitIRInstruction(function, builder.currentBlock, IR_RETURN, IR_TYPE_VOID, location);
+    instruction->operands[0] = value;
+    if (value != IR_NO_REGISTER) function->returnType = function->registerTypes[value];
+
+    orderIRRegisters(function);
+    computeIRPredecessors(function);
+    free(builder.bindings);
+
+    if (value == IR_NO_REGISTER && program->errorCount == 0) program->errorCount++;
+    return program;
+}
+
+BatchExpression *compileBatchExpression(const char *expression, const BatchInput *inputs, int inputCount,
+                                        DiagnosticList *diagnostics) {
+    Location location = {1, 1};
+
+    if (inputCount > BATCH_MAX_INPUTS) {
+        reportDiagnostic(diagnostics, location, "An expression takes at most %d inputs", BATCH_MAX_INPUTS);
+        return NULL;
+    }
+
+    for (int input = 0; input < inputCount; input++) {
+        IRType type = inputs[input].type;
+        if (type == IR_TYPE_INT || type == IR_TYPE_FLOAT || type == IR_TYPE_BOOL) continue;
+
+        reportDiagnostic(diagnostics, location, "Input '%s' of type %s must be an Int, a Float or a Bool",
+                         inputs[input].name, getIRTypeName(type));
+        return NULL;
+    }
+
+    FILE *stream = openBatchStream(expression, strlen(expression));
+    if (!stream) return NULL;
+
+    // The expression is parsed on its own, where anything left after it is an error
+    Parser *parser = initParser();
+    parser->diagnostics = parser->lexer->diagnostics = diagnostics;
+    parser->currentToken = advanceParser(parser, stream);
+    ASTNode *root = parseExpression(parser, stream);
+    int result = root && parser->parseError == PARSE_ERROR_NONE;
+
+    while (result && matchTokenType(parser, TOKEN_DELIMITER)) parser->currentToken = advanceParser(parser, stream);
+
+    if (result && !matchTokenType(parser, TOKEN_EOF)) {
+        reportDiagnostic(diagnostics, parser->currentToken->location, "Unexpected '%s' after the expression",
+                         parser->currentToken->lexeme);
+        result = 0;
+    }
+
+    fclose(stream);
+    free(parser->lexer);
+    free(parser);
+
+    // The inputs are symbols assigned before the expression, whose values are only known at runtime
+    SymbolTable *symbolTable = initSymbolTable();
+    Analyzer *analyzer = symbolTable ? initAnalyzer(root, symbolTable) : NULL;
+    result = result && analyzer;
+
+    for (int input = 0; input < inputCount && result; input++) {
+        if (lookupSymbol(symbolTable, inputs[input].name)) {
+            reportDiagnostic(diagnostics, location, "Redeclared symbol '%s'", inputs[input].name);
+            result = 0;
+            break;
+        }
+
+        addSymbol(symbolTable, inputs[input].name, getIRTypeName(inputs[input].type), location);
+        if (symbolTable->headSymbol) symbolTable->headSymbol->hasInitialized = 1;
+    }
+
+    if (result) {
+        analyzer->diagnostics = diagnostics;
+        result = analyzeExpression(analyzer, root);
+    }
+
+    // The function is optimized like any other, except that its frame is not allocated, since each register keeps a
+    // column of its own
+    IRProgram *program = result ? lowerBatchExpression(root, inputs, inputCount, diagnostics) : NULL;
+    result = program && program->errorCount == 0 && analyzeDefiniteAssignment(program) &&
+             checkBatchFunction(program, program->functions[0]);
+
+    PassManager *manager = result ? initPassManager(2) : NULL;
+
+    if (manager) {
+        if (manager->pipelineCount > 0 && manager->pipeline[manager->pipelineCount - 1] == findPass("frame")) {
+            manager->pipelineCount--;
+        }
+
+        result = runPassManager(manager, program);
+        freePassManager(manager);
+    } else result = 0;
+
+    BatchExpression *compiled = result ? (BatchExpression*) calloc(1, sizeof(BatchExpression)) : NULL;
+
+    if (compiled) {
+        IRFunction *function = program->functions[0];
+        compiled->program = program;
+        compiled->function = function;
+        compiled->type = function->returnType;
+        compiled->inputCount = inputCount;
+        compiled->order = (int*) malloc((function->blockCount + 1) * sizeof(int));
+        compiled->definitionCounts = (int*) calloc(function->registerCount + 1, sizeof(int));
+        compiled->values = (IRConstant*) calloc(function->registerCount + 1, sizeof(IRConstant));
+
+        if (!compiled->order || !compiled->definitionCounts || !compiled->values) {
+            freeBatchExpression(compiled);
+            compiled = NULL;
+            program = NULL;
+        }
+    }
+
+    if (compiled) {
+        IRFunction *function = compiled->function;
+        compiled->blockCount = computeReversePostOrder(function, compiled->order);
+
+        for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+            BasicBlock *block = function->blocks[blockIndex];
+
+            for (int index = 0; index < block->instructionCount; index++) {
+                int destination = block->instructions[index].destination;
+                if (destination >= 0) compiled->definitionCounts[destination]++;
+            }
+        }
+    } else if (program) freeIRProgram(program);
+
+    freeAST(root);
+    free(analyzer);
+    freeSymbolTable(symbolTable);
+    return compiled;
+}
+
+// Reports that a row could not be evaluated
+static void reportBatchError(const char *message, Location location, int64_t row) {
+    fprintf(stderr, "[RuntimeError]: %s at location %d:%d of row %" PRId64 ".\n", message, location.line,
+            location.column, row);
+}
+
+// Appends the rows of a block to the rows reaching one of its successors
+static void appendBatchRows(BatchState *state, int target, const uint16_t *rows, int count) {
+    uint16_t *targetRows = state->selections + (size_t) target * BATCH_CHUNK_ROWS + state->selectionCounts[target];
+
+    if (rows) memcpy(targetRows, rows, count * sizeof(uint16_t));
+    else for (int k = 0; k < count; k++) targetRows[k] = (uint16_t) k;
+
+    state->selectionCounts[target] += count;
+}
+
+// Runs an instruction on the rows of its block, where `rows` is NULL if every row of the chunk reaches the block
+static int runBatchInstruction(BatchExpression *expression, BatchState *state, IRInstruction *instruction,
+                               const uint16_t *rows, int count, int64_t start, BatchColumn result) {
+    IRFunction *function = expression->function;
+    BatchLane **lanes = state->lanes;
+    BatchLane *d = instruction->destination >= 0 ? lanes[instruction->destination] : NULL;
+    BatchLane *a = instruction->operands[0] >= 0 ? lanes[instruction->operands[0]] : NULL;
+    BatchLane *b = instruction->operands[1] >= 0 ? lanes[instruction->operands[1]] : NULL;
+    int isFloat = instruction->operands[0] >= 0 && function->registerTypes[instruction->operands[0]] == IR_TYPE_FLOAT;
+    int32_t immediate = instruction->constant.integerValue;
+    IRConstant constant = instruction->constant;
+
+    switch (instruction->opcode) {
+        case IR_CONSTANT: {
+            if (instruction->type == IR_TYPE_FLOAT) { BATCH_LOOP(d[k].floating = constant.floatingValue) }
+            else { BATCH_LOOP(d[k].integer = constant.integerValue) }
+            return 1;
+        }
+
+        // A register defined once takes the values of the copied register, rather than copying them
+        case IR_COPY: {
+            if (expression->definitionCounts[instruction->destination] == 1 &&
+                expression->definitionCounts[instruction->operands[0]] <= 1) {
+                lanes[instruction->destination] = a;
+                return 1;
+            }
+
+            BATCH_LOOP(d[k] = a[k])
+            return 1;
+        }
+
+        case IR_CONVERT: BATCH_LOOP(d[k].floating = (float) a[k].integer) return 1;
+
+        // Int arithmetic wraps around, which is computed on unsigned integers
+        case IR_ADD: {
+            if (isFloat) { BATCH_LOOP(d[k].floating = a[k].floating + b[k].floating) }
+            else { BATCH_LOOP(d[k].integer = (int32_t) ((uint32_t) a[k].integer + (uint32_t) b[k].integer)) }
+            return 1;
+        }
+
+        case IR_SUBTRACT: {
+            if (isFloat) { BATCH_LOOP(d[k].floating = a[k].floating - b[k].floating) }
+            else { BATCH_LOOP(d[k].integer = (int32_t) ((uint32_t) a[k].integer - (uint32_t) b[k].integer)) }
+            return 1;
+        }
+
+        case IR_MULTIPLY: {
+            if (isFloat) { BATCH_LOOP(d[k].floating = a[k].floating * b[k].floating) }
+            else { BATCH_LOOP(d[k].integer = (int32_t) ((uint32_t) a[k].integer * (uint32_t) b[k].integer)) }
+            return 1;
+        }
+
+        // An Int division by zero fails on the first row dividing by zero, which is found before dividing any row
+        case IR_DIVIDE: case IR_MODULO: {
+            int isDivision = (instruction->opcode == IR_DIVIDE);
+
+            if (isFloat) {
+                if (isDivision) { BATCH_LOOP(d[k].floating = a[k].floating / b[k].floating) }
+                else { BATCH_LOOP(d[k].floating = fmodf(a[k].floating, b[k].floating)) }
+                return 1;
+            }
+
+            int zeroCount = 0;
+            BATCH_LOOP(zeroCount += (b[k].integer == 0))
+
+            if (zeroCount > 0) {
+                int64_t row = INT64_MAX;
+                BATCH_LOOP(if (b[k].integer == 0 && start + k < row) row = start + k)
+                reportBatchError("Division by zero", instruction->location, row);
+                return 0;
+            }
+
+            // Dividing by -1 negates (which wraps around for the smallest Int), and the remainder is 0
+            if (isDivision) {
+                BATCH_LOOP(d[k].integer = b[k].integer == -1 ? (int32_t) (0u - (uint32_t) a[k].integer)
+                                                               : a[k].integer / b[k].integer)
+            } else {
+                BATCH_LOOP(d[k].integer = b[k].integer == -1 ? 0 : a[k].integer % b[k].integer)
+            }
+
+            return 1;
+        }
+
+        case IR_NEGATE: {
+            if (isFloat) { BATCH_LOOP(d[k].floating = -a[k].floating) }
+            else { BATCH_LOOP(d[k].integer = (int32_t) (0u - (uint32_t) a[k].integer)) }
+            return 1;
+        }
+
+        case IR_NOT: BATCH_LOOP(d[k].integer = !a[k].integer) return 1;
+
+        case IR_FACTORIAL: {
+            BATCH_LOOP(uint32_t product = 1;
+                       for (int32_t term = 2; term <= a[k].integer; term++) product *= (uint32_t) term;
+                       d[k].integer = (int32_t) product)
+            return 1;
+        }
+
+        case IR_SHIFT_LEFT: BATCH_LOOP(d[k].integer = (int32_t) ((uint32_t) a[k].integer << immediate)) return 1;
+        case IR_SHIFT_RIGHT: BATCH_LOOP(d[k].integer = a[k].integer >> immediate) return 1;
+        case IR_SHIFT_RIGHT_LOGICAL: BATCH_LOOP(d[k].integer = (int32_t) ((uint32_t) a[k].integer >> immediate)) return 1;
+        case IR_BITWISE_AND: BATCH_LOOP(d[k].integer = a[k].integer & immediate) return 1;
+        case IR_MULTIPLY_HIGH: BATCH_LOOP(d[k].integer = (int32_t) (((int64_t) a[k].integer * immediate) >> 32)) return 1;
+
+        // A comparison involving NaN is only true for '!=', as the comparisons of C
+        case IR_EQUAL: {
+            if (isFloat) { BATCH_LOOP(d[k].integer = a[k].floating == b[k].floating) }
+            else { BATCH_LOOP(d[k].integer = a[k].integer == b[k].integer) }
+            return 1;
+        }
+
+        case IR_NOT_EQUAL: {
+            if (isFloat) { BATCH_LOOP(d[k].integer = a[k].floating != b[k].floating) }
+            else { BATCH_LOOP(d[k].integer = a[k].integer != b[k].integer) }
+            return 1;
+        }
+
+        case IR_LESS_THAN: {
+            if (isFloat) { BATCH_LOOP(d[k].integer = a[k].floating < b[k].floating) }
+            else { BATCH_LOOP(d[k].integer = a[k].integer < b[k].integer) }
+            return 1;
+        }
+
+        case IR_LESS_OR_EQUAL: {
+            if (isFloat) { BATCH_LOOP(d[k].integer = a[k].floating <= b[k].floating) }
+            else { BATCH_LOOP(d[k].integer = a[k].integer <= b[k].integer) }
+            return 1;
+        }
+
+        case IR_GREATER_THAN: {
+            if (isFloat) { BATCH_LOOP(d[k].integer = a[k].floating > b[k].floating) }
+            else { BATCH_LOOP(d[k].integer = a[k].integer > b[k].integer) }
+            return 1;
+        }
+
+        case IR_GREATER_OR_EQUAL: {
+            if (isFloat) { BATCH_LOOP(d[k].integer = a[k].floating >= b[k].floating) }
+            else { BATCH_LOOP(d[k].integer = a[k].integer >= b[k].integer) }
+            return 1;
+        }
+
+        // A branch splits the rows of its block into the rows of each target, without branching on any row
+        case IR_BRANCH: {
+            int targets[2] = {instruction->targets[0], instruction->targets[1]};
+            uint16_t *taken = state->selections + (size_t) targets[0] * BATCH_CHUNK_ROWS + state->selectionCounts[targets[0]];
+            uint16_t *other = state->selections + (size_t) targets[1] * BATCH_CHUNK_ROWS + state->selectionCounts[targets[1]];
+            int takenCount = 0, otherCount = 0;
+
+            if (targets[0] == targets[1]) {
+                appendBatchRows(state, targets[0], rows, count);
+                return 1;
+            }
+
+            BATCH_LOOP(int isTaken = a[k].integer != 0;
+                       taken[takenCount] = (uint16_t) k;
+                       other[otherCount] = (uint16_t) k;
+                       takenCount += isTaken;
+                       otherCount += !isTaken)
+
+            state->selectionCounts[targets[0]] += takenCount;
+            state->selectionCounts[targets[1]] += otherCount;
+            return 1;
+        }
+
+        case IR_JUMP: appendBatchRows(state, instruction->targets[0], rows, count); return 1;
+
+        case IR_RETURN: {
+            BatchLane *values = (BatchLane*) result.values + start;
+            BATCH_LOOP(values[k] = a[k])
+            return 1;
+        }
+
+        default: return 1;
+    }
+}
+
+// Evaluates the rows of a chunk, block by block in reverse post-order, so that every block has received all of its
+// rows from its predecessors before it runs
+static int evaluateBatchChunk(BatchExpression *expression, BatchState *state, const BatchColumn *columns,
+                              int64_t start, int count, BatchColumn result) {
+    IRFunction *function = expression->function;
+
+    // The inputs are read right from their columns
+    for (int reg = 0; reg < function->registerCount; reg++) {
+        state->lanes[reg] = reg < expression->inputCount ? (BatchLane*) columns[reg].values + start
+                          : state->storage + (size_t) reg * BATCH_CHUNK_ROWS;
+    }
+
+    memset(state->selectionCounts, 0, function->blockCount * sizeof(int));
+    state->selectionCounts[0] = count;
+
+    for (int position = 0; position < expression->blockCount; position++) {
+        int blockIndex = expression->order[position];
+        int blockCount = state->selectionCounts[blockIndex];
+        if (blockCount == 0) continue;
+
+        // A block reached by every row of the chunk runs over all of them, whatever the order of its selection
+        const uint16_t *rows = blockCount == count ? NULL : state->selections + (size_t) blockIndex * BATCH_CHUNK_ROWS;
+        BasicBlock *block = function->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            if (!runBatchInstruction(expression, state, &block->instructions[index], rows, blockCount, start,
+                                     result)) return 0;
+        }
+    }
+
+    return 1;
+}
+
+int evaluateBatchExpression(BatchExpression *expression, const BatchColumn *columns, int64_t rowCount,
+                            BatchColumn result) {
+    IRFunction *function = expression->function;
+    BatchState state;
+    state.storage = (BatchLane*) malloc(((size_t) function->registerCount + 1) * BATCH_CHUNK_ROWS * sizeof(BatchLane));
+    state.lanes = (BatchLane**) malloc((function->registerCount + 1) * sizeof(BatchLane*));
+    state.selections = (uint16_t*) malloc((size_t) function->blockCount * BATCH_CHUNK_ROWS * sizeof(uint16_t));
+    state.selectionCounts = (int*) malloc(function->blockCount * sizeof(int));
+    int isEvaluated = state.storage && state.lanes && state.selections && state.selectionCounts;
+
+    for (int64_t start = 0; start < rowCount && isEvaluated; start += BATCH_CHUNK_ROWS) {
+        int count = rowCount - start < BATCH_CHUNK_ROWS ? (int) (rowCount - start) : BATCH_CHUNK_ROWS;
+        isEvaluated = evaluateBatchChunk(expression, &state, columns, start, count, result);
+    }
+
+    free(state.storage);
+    free(state.lanes);
+    free(state.selections);
+    free(state.selectionCounts);
+    return isEvaluated;
+}
+
+int evaluateBatchRow(BatchExpression *expression, const BatchColumn *columns, int64_t row, BatchColumn result) {
+    IRFunction *function = expression->function;
+    IRConstant *values = expression->values;
+
+    for (int input = 0; input < expression->inputCount; input++) {
+        if (expression->function->registerTypes[input] == IR_TYPE_FLOAT) values[input].floatingValue = columns[input].floats[row];
+        else values[input].integerValue = columns[input].integers[row];
+    }
+
+    int blockIndex = 0;
+
+    for (;;) {
+        BasicBlock *block = function->blocks[blockIndex];
+        int next = IR_NO_BLOCK;
+
+        for (int index = 0; index < block->instructionCount && next == IR_NO_BLOCK; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            IRConstant lhs = instruction->operands[0] >= 0 ? values[instruction->operands[0]] : instruction->constant;
+            IRConstant rhs = instruction->operands[1] >= 0 ? values[instruction->operands[1]] : instruction->constant;
+
+            switch (instruction->opcode) {
+                case IR_CONSTANT: values[instruction->destination] = instruction->constant; break;
+                case IR_JUMP: next = instruction->targets[0]; break;
+                case IR_BRANCH: next = instruction->targets[lhs.booleanValue ? 0 : 1]; break;
+
+                case IR_RETURN: {
+                    BatchLane *value = (BatchLane*) result.values + row;
+                    if (expression->type == IR_TYPE_FLOAT) value->floating = lhs.floatingValue;
+                    else value->integer = lhs.integerValue;
+                    return 1;
+                }
+
+                // A division by zero fails, while the other values follow the folding of constants
+                case IR_DIVIDE: case IR_MODULO: {
+                    IRType type = function->registerTypes[instruction->operands[0]];
+
+                    if (type == IR_TYPE_INT && rhs.integerValue == 0) {
+                        reportBatchError("Division by zero", instruction->location, row);
+                        return 0;
+                    }
+
+                    if (type == IR_TYPE_INT && rhs.integerValue == -1) {
+                        values[instruction->destination].integerValue =
+                            instruction->opcode == IR_DIVIDE ? (int32_t) (0u - (uint32_t) lhs.integerValue) : 0;
+                        break;
+                    }
+
+                    evaluateIRInstruction(instruction, type, lhs, rhs, 0, &values[instruction->destination]);
+                    break;
+                }
+
+                case IR_FACTORIAL: {
+                    uint32_t product = 1;
+                    for (int32_t term = 2; term <= lhs.integerValue; term++) product *= (uint32_t) term;
+                    values[instruction->destination].integerValue = (int32_t) product;
+                    break;
+                }
+
+                default: {
+                    if (instruction->destination < 0) break;
+                    IRType type = instruction->operands[0] >= 0 ? function->registerTypes[instruction->operands[0]]
+                                : instruction->type;
+                    evaluateIRInstruction(instruction, type, lhs, rhs, 0, &values[instruction->destination]);
+                    break;
+                }
+            }
+        }
+
+        if (next == IR_NO_BLOCK) return 0;
+        blockIndex = next;
+    }
+}
+
+void freeBatchExpression(BatchExpression *expression) {
+    if (!expression) return;
+
+    freeIRProgram(expression->program);
+    free(expression->order);
+    free(expression->definitionCounts);
+    free(expression->values);
+    free(expression);
+}
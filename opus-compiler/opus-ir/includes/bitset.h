@@ -0,0 +1,128 @@
+// bitset.h
+//
+// Dense bitsets for the data flow analyses over the IR. A bitset holds one bit per element of a fixed universe
+// (e.g. one bit per local of a function) packed into 64-bit words, so that a join or a meet of two sets is a single
+// pass over their words, which keeps the analyses fast on functions with thousands of locals.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <stdint.h>
+
+#define BITSET_WORD_BITS 64
+
+/// A fixed-size set of integers in [0, size).
+typedef struct {
+    int size;          /// The number of bits (i.e. the size of the universe).
+    int wordCount;     /// The number of 64-bit words holding the bits.
+    uint64_t *words;   /// The words, where bit i lives in words[i / 64].
+} Bitset;
+
+/// Initializes an empty bitset.
+///
+/// @param size The number of bits of the bitset.
+/// @return A pointer to the newly allocated Bitset, or NULL if memory allocation fails.
+///
+Bitset *initBitset(int size);
+
+/// Initializes an array of empty bitsets of the same size, which share a single allocation of words.
+///
+/// @param count The number of bitsets.
+/// @param size The number of bits of each bitset.
+/// @return A pointer to the array of bitsets, or NULL if memory allocation fails.
+///
+Bitset *initBitsetArray(int count, int size);
+
+/// Frees a bitset created by initBitset().
+/// @param bitset The bitset to free.
+///
+void freeBitset(Bitset *bitset);
+
+/// Frees an array of bitsets created by initBitsetArray().
+/// @param bitsets The array of bitsets to free.
+///
+void freeBitsetArray(Bitset *bitsets);
+
+/// Adds an element to the bitset.
+///
+/// @param bitset The bitset to update.
+/// @param index The element to add.
+///
+void setBit(Bitset *bitset, int index);
+
+/// Removes an element from the bitset.
+///
+/// @param bitset The bitset to update.
+/// @param index The element to remove.
+///
+void clearBit(Bitset *bitset, int index);
+
+/// Checks if an element is in the bitset.
+///
+/// @param bitset The bitset to check.
+/// @param index The element to check.
+/// @return 1 (True) if the element is in the bitset, 0 (False) otherwise.
+///
+int testBit(const Bitset *bitset, int index);
+
+/// Adds every element of the universe to the bitset.
+/// @param bitset The bitset to fill.
+///
+void fillBitset(Bitset *bitset);
+
+/// Removes every element from the bitset.
+/// @param bitset The bitset to clear.
+///
+void clearBitset(Bitset *bitset);
+
+/// Copies a bitset into another one of the same size.
+///
+/// @param destination The bitset to overwrite.
+/// @param source The bitset to copy.
+/// @return 1 (True) if the destination has changed, 0 (False) otherwise.
+///
+int copyBitset(Bitset *destination, const Bitset *source);
+
+/// Computes the union (join) of two bitsets in place, that is destination |= source.
+///
+/// @param destination The bitset to update.
+/// @param source The other bitset.
+/// @return 1 (True) if the destination has changed, 0 (False) otherwise.
+///
+int unionBitset(Bitset *destination, const Bitset *source);
+
+/// Computes the intersection (meet) of two bitsets in place, that is destination &= source.
+///
+/// @param destination The bitset to update.
+/// @param source The other bitset.
+/// @return 1 (True) if the destination has changed, 0 (False) otherwise.
+///
+int intersectBitset(Bitset *destination, const Bitset *source);
+
+/// Computes the difference of two bitsets in place, that is destination &= ~source.
+///
+/// @param destination The bitset to update.
+/// @param source The bitset to subtract.
+/// @return 1 (True) if the destination has changed, 0 (False) otherwise.
+///
+int subtractBitset(Bitset *destination, const Bitset *source);
+
+/// Finds the smallest element of the bitset that is not less than the given one.
+///
+/// @param bitset The bitset to search.
+/// @param from The element to start from.
+/// @return The element found, or -1 if there is none.
+///
+int findNextBit(const Bitset *bitset, int from);
+
+/// Counts the elements of the bitset.
+///
+/// @param bitset The bitset to count.
+/// @return The number of elements in the bitset.
+///
+int countBits(const Bitset *bitset);
+
+#endif
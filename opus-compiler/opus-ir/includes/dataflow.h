@@ -0,0 +1,110 @@
+// dataflow.h
+//
+// Data flow analyses over the control flow graph of the IR. A data flow problem is described by the direction in
+// which facts flow, the meet operator applied where control flow joins, and the gen and kill sets of each block,
+// where every fact is a bit in a dense bitset. The solver visits the blocks with a worklist ordered by the reverse
+// post-order of the CFG, so that a block is usually visited after its predecessors, and converges in a few passes
+// even for functions with thousands of locals and branches.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef DATAFLOW_H
+#define DATAFLOW_H
+
+#include "ir.h"
+#include "bitset.h"
+
+/// The direction in which the facts flow through the CFG.
+typedef enum {
+    DATAFLOW_FORWARD,    /// Facts flow from the entry block to the exits (e.g. definite assignment).
+    DATAFLOW_BACKWARD,   /// Facts flow from the exits to the entry block (e.g. liveness).
+} DataflowDirection;
+
+/// The operator combining the facts where control flow joins.
+typedef enum {
+    DATAFLOW_MEET_INTERSECTION,   /// A fact holds only if it holds on every path (a "must" problem).
+    DATAFLOW_MEET_UNION,          /// A fact holds if it holds on any path (a "may" problem).
+} DataflowMeet;
+
+/// A data flow problem over a function, together with its solution.
+///
+/// The transfer function of each block is out = gen | (in & ~kill) for a forward problem, and
+/// in = gen | (out & ~kill) for a backward problem, where in and out are the facts at the entry and
+/// the exit of the block.
+typedef struct {
+    DataflowDirection direction;   /// The direction of the problem.
+    DataflowMeet meet;             /// The meet operator of the problem.
+    int universe;                  /// The number of facts (bits) of each set.
+    int blockCount;                /// The number of blocks of the function.
+    Bitset *in;                    /// The facts at the entry of each block.
+    Bitset *out;                   /// The facts at the exit of each block.
+    Bitset *gen;                   /// The facts generated by each block.
+    Bitset *kill;                  /// The facts killed by each block.
+    Bitset *boundary;              /// The facts at the entry block (forward) or the exit blocks (backward).
+    int *order;                    /// The reachable blocks in reverse post-order.
+    int orderCount;                /// The number of reachable blocks.
+    int visitCount;                /// The number of block visits needed to reach the fixed point.
+} DataflowProblem;
+
+/// Computes the reverse post-order of the blocks reachable from the entry block, using an explicit stack so that
+/// deeply nested control flow could not overflow the C stack.
+///
+/// @param function The function whose CFG is traversed.
+/// @param order An array of at least `function->blockCount` integers receiving the blocks.
+/// @return The number of reachable blocks.
+///
+int computeReversePostOrder(IRFunction *function, int *order);
+
+/// Computes the order in which the reachable blocks of a function are emitted: their order in the function once it
+/// has been laid out by the optimizer (see cfg.h), otherwise the reverse post-order.
+///
+/// @param function The function to emit.
+/// @param order An array of at least `function->blockCount` integers receiving the blocks.
+/// @return The number of reachable blocks.
+///
+int computeLayoutOrder(IRFunction *function, int *order);
+
+/// Initializes a data flow problem over a function with empty gen, kill and boundary sets.
+///
+/// @param function The function to analyze.
+/// @param direction The direction of the problem.
+/// @param meet The meet operator of the problem.
+/// @param universe The number of facts.
+/// @return A pointer to the newly allocated DataflowProblem, or NULL if memory allocation fails.
+///
+DataflowProblem *initDataflowProblem(IRFunction *function, DataflowDirection direction, DataflowMeet meet, int universe);
+
+/// Solves a data flow problem to its maximal fixed point, where the blocks that are unreachable from the entry block
+/// are not visited (their in and out sets are left as the top element of the meet).
+///
+/// @param function The function to analyze.
+/// @param problem The problem to solve, whose gen, kill and boundary sets have been computed.
+///
+void solveDataflow(IRFunction *function, DataflowProblem *problem);
+
+/// Frees all memory associated with a data flow problem.
+/// @param problem The problem to free.
+///
+void freeDataflowProblem(DataflowProblem *problem);
+
+/// Checks that every local of every function of the program is definitely assigned before it is read, and that
+/// no immutable local might be assigned twice.
+///
+/// @param program The program to check.
+/// @return 1 (True) if there is no error, 0 (False) otherwise.
+///
+int analyzeDefiniteAssignment(IRProgram *program);
+
+/// Checks the definite assignment of the locals of a function with two forward problems: a local is definitely
+/// assigned if it is assigned on every path (intersection), and possibly assigned if it is assigned on any path
+/// (union). Reading a local that is not definitely assigned, or assigning an immutable local that is possibly
+/// assigned, is reported as an error.
+///
+/// @param program The program owning the function.
+/// @param function The function to check.
+/// @return 1 (True) if there is no error, 0 (False) otherwise.
+///
+int analyzeFunctionAssignment(IRProgram *program, IRFunction *function);
+
+#endif
@@ -0,0 +1,72 @@
+// frame.h
+//
+// Frame allocation for the functions of the IR. Naively, every register (each declared variable and each temporary)
+// would get a frame slot of its own for the whole function, so large functions would have huge frames with poor
+// cache locality. A liveness analysis computes where each register holds a value that might still be read, which
+// gives a live interval for each register, and the intervals are colored so that registers with disjoint lifetimes
+// share the same frame slot (and the same register of the VM).
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include "ir.h"
+#include "dataflow.h"
+
+/// The interval of positions where a register is live, where the instructions of the reachable blocks are numbered in
+/// reverse post-order and each instruction takes two positions: its uses are at the even position and its definition
+/// is at the odd position right after, so that an operand dying at an instruction could share its slot with the
+/// result of that instruction.
+typedef struct {
+    int reg;     /// The register of the interval.
+    int start;   /// The first position where the register is live (-1 for parameters, which are live on entry).
+    int end;     /// The last position where the register is live.
+} LiveInterval;
+
+/// Computes the liveness of the registers of a function, which is a backward problem where the meet is the union:
+/// a register is live at a point if it might be read on some path before being redefined.
+///
+/// @param function The function to analyze.
+/// @return The solved problem, where `in` and `out` are the registers live at the entry and the exit of each block,
+///         or NULL if memory allocation fails.
+///
+DataflowProblem *computeLiveness(IRFunction *function);
+
+/// Computes the live interval of each register that is defined or used by a reachable instruction, where each
+/// interval covers every position where the register is live.
+///
+/// @param function The function to analyze.
+/// @param liveness The solved liveness of the function.
+/// @param intervals An array of `function->registerCount` intervals receiving the result, where a register that is
+///                  never live has an empty interval (start > end).
+///
+void computeLiveIntervals(IRFunction *function, DataflowProblem *liveness, LiveInterval *intervals);
+
+/// Allocates the frame of a function from its liveness, computed here.
+///
+/// @param function The function to allocate.
+/// @return 1 (True) on success, 0 (False) if memory allocation fails.
+///
+int allocateFrame(IRFunction *function);
+
+/// Allocates the frame of a function by interval coloring: the intervals are visited by their start, and each one
+/// takes the lowest slot released by an interval that has ended. Parameters are live on entry so that the parameter
+/// i takes the slot i, and the globals of the entry function are pinned to the first slots since other functions
+/// access them at any time. A register only computed to be passed as the argument i of a call, with no other call in
+/// between, takes the slot i past the frame (the slot i of the callee) rather than a slot of the frame. The result is
+/// stored in `function->slots` and `function->frameSize`, which does not count the slots past the frame.
+///
+/// @param function The function to allocate.
+/// @param liveness The solved liveness of the function, which must be up to date.
+/// @return 1 (True) on success, 0 (False) if memory allocation fails.
+///
+int assignFrameSlots(IRFunction *function, DataflowProblem *liveness);
+
+/// Reports the size of the allocated frame of a function compared with one slot per register.
+/// @param function The function to report.
+///
+void displayFrameReduction(IRFunction *function);
+
+#endif
@@ -0,0 +1,132 @@
+// generic.h
+//
+// Generic functions of the Opus programming language (e.g. "func max<T: Numeric>(a: T, b: T) -> T"). A generic
+// function is never lowered on its own: each call infers the type arguments from the types of its arguments, and
+// the function is specialized for them into a function of its own (e.g. 'max<Int>'), whose body is lowered with every
+// type parameter replaced by its type argument. Specializations are cached under the generic function and its type
+// arguments, so all calls with the same type arguments share one specialization, lowered, optimized and emitted once.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef GENERIC_H
+#define GENERIC_H
+
+#include "ir.h"
+
+#define IR_MAX_TYPE_PARAMETERS      8
+#define IR_SPECIALIZATION_BUCKETS   64
+
+/// Constraints on the type argument of a type parameter.
+typedef enum {
+    IR_CONSTRAINT_NONE,         /// Any type, if the type parameter has no constraint.
+    IR_CONSTRAINT_NUMERIC,      /// 'Numeric', that is an integer (Int or a sized integer) or Float.
+    IR_CONSTRAINT_COMPARABLE,   /// 'Comparable', that is an integer, Float or String.
+    IR_CONSTRAINT_EQUATABLE,    /// 'Equatable', that is Int, Float, Bool or String.
+    IR_CONSTRAINT_UNKNOWN,      /// A constraint that does not exist.
+} IRConstraint;
+
+/// A generic function, whose implementation is only lowered once specialized.
+typedef struct {
+    char name[LEXEME_LENGTH];                                /// The name of the function.
+    ASTNode *implementation;                                 /// The implementation of the function in the AST.
+    char parameters[IR_MAX_TYPE_PARAMETERS][LEXEME_LENGTH];  /// The name of each type parameter.
+    IRConstraint constraints[IR_MAX_TYPE_PARAMETERS];        /// The constraint of each type parameter.
+    int parameterCount;                                      /// The number of type parameters.
+    int bindingCount;                                        /// The bindings visible to the body (the globals before it).
+    int isValid;                                             /// Whether its definition is valid (otherwise it is reported).
+} IRGeneric;
+
+/// A generic function specialized for some type arguments.
+typedef struct {
+    int generic;                                 /// The index of the generic function.
+    IRType arguments[IR_MAX_TYPE_PARAMETERS];    /// The type argument of each type parameter.
+    int function;                                /// The index of the specialized function in the program.
+    int isLowered;                               /// Whether the body of the specialization has been lowered.
+    int callCount;                               /// The number of calls sharing the specialization.
+    int next;                                    /// The next specialization in the same bucket, or -1.
+} IRSpecialization;
+
+/// The generic functions of a program, together with the cache of their specializations.
+typedef struct IRGenericTable {
+    IRGeneric *generics;                          /// The generic functions.
+    int genericCount;                             /// The number of generic functions.
+    int genericCapacity;                          /// The allocated capacity of the generic function array.
+    IRSpecialization *specializations;            /// The specializations, in the order they are requested.
+    int specializationCount;                      /// The number of specializations.
+    int specializationCapacity;                   /// The allocated capacity of the specialization array.
+    int buckets[IR_SPECIALIZATION_BUCKETS];       /// The first specialization of each hash bucket, or -1.
+} IRGenericTable;
+
+/// Initializes a new table without any generic function.
+/// @return A pointer to the newly allocated IRGenericTable, or NULL if memory allocation fails.
+///
+IRGenericTable *initIRGenericTable();
+
+/// Checks if a function definition declares type parameters.
+///
+/// @param definition Pointer to the AST node representing the function definition.
+/// @return 1 (True) if the function is generic, 0 (False) otherwise.
+///
+int isIRGenericDefinition(ASTNode *definition);
+
+/// Declares a generic function from its implementation, checking that every constraint exists and that every type
+/// parameter is the type of a parameter (since type arguments are only inferred from the arguments).
+///
+/// @param builder Pointer to the IRBuilder instance, which reports the errors.
+/// @param implementation Pointer to the AST node representing the function implementation.
+/// @return The index of the generic function, or -1 if memory allocation fails.
+///
+int declareIRGeneric(IRBuilder *builder, ASTNode *implementation);
+
+/// Finds a generic function by its name.
+///
+/// @param table The table to search.
+/// @param name The name of the function.
+/// @return The index of the generic function, or -1 if not found.
+///
+int findIRGeneric(IRGenericTable *table, const char *name);
+
+/// Specializes a generic function for a call, where the type arguments are inferred from the arguments and checked
+/// against the constraints, together with the number of arguments and their labels. The specialization is taken from
+/// the cache if the function has been specialized for the same type arguments, otherwise it is declared and its body
+/// is lowered later (see lowerIRSpecializations()).
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param generic The index of the generic function.
+/// @param node Pointer to the AST node representing the function call.
+/// @param arguments The registers holding the arguments.
+/// @param argumentCount The number of arguments.
+/// @return The index of the specialized function in the program, or -1 if the call is invalid (which is reported).
+///
+int specializeIRGeneric(IRBuilder *builder, int generic, ASTNode *node, int *arguments, int argumentCount);
+
+/// Lowers the body of every specialization that has not been lowered, including the specializations requested while
+/// lowering them. The body only sees the globals declared before the generic function, as any other function.
+///
+/// @param builder Pointer to the IRBuilder instance, once the top-level statements have been lowered.
+///
+void lowerIRSpecializations(IRBuilder *builder);
+
+/// Converts a type name into an IR type, where a type parameter of the specialization being lowered (if any) is
+/// replaced by its type argument.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param typeName The type name to convert.
+/// @return The corresponding IR type, or IR_TYPE_ANY if the type is not a native type.
+///
+IRType resolveIRType(IRBuilder *builder, const char *typeName);
+
+/// Displays how many calls share each specialization.
+///
+/// @param table The table of the generic functions.
+/// @param program The program owning the specialized functions.
+///
+void displayIRSpecializations(IRGenericTable *table, IRProgram *program);
+
+/// Frees all memory associated with a table of generic functions.
+/// @param table The table to free.
+///
+void freeIRGenericTable(IRGenericTable *table);
+
+#endif
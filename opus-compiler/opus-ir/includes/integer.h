@@ -0,0 +1,99 @@
+// integer.h
+//
+// Sized integer types of the Opus programming language (Int8, Int16, UInt8, UInt16 and UInt32, where Int32 is
+// another name of Int). A value of a sized integer is held in 32 bits like an Int, always within the range of its
+// type, so an operation of the VM or of the C runtime on an Int gives the same result on it:
+//
+// - An addition, a subtraction, a multiplication or a negation of a type narrower than an Int is computed as an Int,
+//   then wrapped around to the width of the type, by shifting the value up to the sign bit and back down for a
+//   signed type (e.g. "shift_left 24" and "shift_right 24" for an Int8), or by masking its bits for an unsigned one
+//   (e.g. "bitwise_and 255" for a UInt8). The operation on an Int still goes through the peephole optimizer, so a
+//   multiplication by a power of 2 becomes a shift whatever the width.
+// - A UInt32 needs no wrapping, but its values above Int.max have the sign bit set, so it is divided, compared and
+//   converted into a Float as unsigned (see isIRUnsigned()).
+//
+// A value is converted implicitly into a type holding every value of its type (e.g. an Int8 into an Int16, a UInt8
+// into an Int16), and an integer literal takes the type of the other operand if the type holds its value. Any other
+// conversion is explicit, either wrapping around ('Int8(truncating: x)') or saturating ('Int8(clamping: x)').
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef INTEGER_H
+#define INTEGER_H
+
+#include "ir.h"
+
+/// Gets the width of an integer type in bits.
+///
+/// @param type The type.
+/// @return The width (32 for an Int), or 0 if the type is not an integer.
+///
+int getIRIntegerWidth(IRType type);
+
+/// Checks if a type is an unsigned integer (UInt8, UInt16 or UInt32).
+///
+/// @param type The type.
+/// @return 1 (True) if the type is unsigned, 0 (False) otherwise.
+///
+int isIRUnsignedType(IRType type);
+
+/// Checks if every value of an integer type is a value of another one, so that it is converted implicitly.
+///
+/// @param from The type of the value.
+/// @param to The type the value is converted into.
+/// @return 1 (True) if the types are the same or the value is widened, 0 (False) otherwise.
+///
+int isIRIntegerWidened(IRType from, IRType to);
+
+/// Checks if an integer is a value of an integer type.
+///
+/// @param type The integer type.
+/// @param value The integer.
+/// @return 1 (True) if the type holds the value, 0 (False) otherwise.
+///
+int isIRIntegerInRange(IRType type, long long value);
+
+/// Checks if an instruction operates on UInt32 values, which are divided, compared and converted as unsigned. An
+/// operand might be an Int literal given to a UInt32 (e.g. "x < 10").
+///
+/// @param function The function holding the instruction.
+/// @param instruction The instruction.
+/// @return 1 (True) if either operand is a UInt32, 0 (False) otherwise.
+///
+int isIRUnsigned(IRFunction *function, IRInstruction *instruction);
+
+/// Gets the type of an arithmetic or a comparison on two integers, which is the type of both operands, the type of
+/// the other operand if one of them is a literal that the type holds, or the type one operand is widened into.
+///
+/// @param lhs The node of the left operand.
+/// @param lhsType The type of the left operand.
+/// @param rhs The node of the right operand.
+/// @param rhsType The type of the right operand.
+/// @return The type of the operation, or IR_TYPE_ANY if the types are not converted into each other implicitly.
+///
+IRType joinIRIntegerTypes(ASTNode *lhs, IRType lhsType, ASTNode *rhs, IRType rhsType);
+
+/// Wraps an integer computed as an Int around to the width of a sized integer type, into a new register of the
+/// current block.
+///
+/// @param builder The state of the lowering.
+/// @param value The register holding the integer.
+/// @param type The sized integer type, narrower than an Int.
+/// @param location The location of the operation.
+/// @return The register holding the wrapped integer.
+///
+int wrapIRInteger(IRBuilder *builder, int value, IRType type, Location location);
+
+/// Lowers the conversion of an integer into another integer type (e.g. "Int8(clamping: x)"), which either wraps the
+/// value around ('truncating') or saturates it at the bounds of the type ('clamping').
+///
+/// @param builder The state of the lowering.
+/// @param node The AST_FUNCTION_CALL node, whose callee is the name of the type.
+/// @param type The type the value is converted into.
+/// @return The register holding the converted value, or IR_NO_REGISTER if the conversion is invalid (which is
+///         reported).
+///
+int lowerIntegerConversion(IRBuilder *builder, ASTNode *node, IRType type);
+
+#endif
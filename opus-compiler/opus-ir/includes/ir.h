@@ -0,0 +1,605 @@
+// ir.h
+//
+// Intermediate Representation (IR) for the Opus programming language. After the semantic analysis, the AST is
+// lowered into a Control Flow Graph (CFG) of basic blocks for each function, where each basic block is a sequence
+// of three-address instructions operating on virtual registers and ending with a single terminator. The IR is the
+// common ground for the data flow analyses, the optimizations and the code generation.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef IR_H
+#define IR_H
+
+#include "ast.h"
+#include "diagnostic.h"
+
+#define IR_ENTRY_FUNCTION      "main"
+#define IR_ITERATOR_HAS_NEXT   "iterator.hasNext"
+#define IR_ITERATOR_NEXT       "iterator.next"
+#define IR_NO_REGISTER         -1
+#define IR_NO_BLOCK            -1
+#define IR_MAX_PARAMETERS      16
+
+/// Types of the values in the IR.
+typedef enum {
+    IR_TYPE_ANY,      /// The type is unknown (e.g. the result of calling an external function).
+    IR_TYPE_VOID,     /// No value (e.g. the return type of the entry function).
+    IR_TYPE_INT,      /// Integer values.
+    IR_TYPE_FLOAT,    /// Floating point values.
+    IR_TYPE_BOOL,     /// Boolean values.
+    IR_TYPE_STRING,   /// String literals, referred by their index in the string table.
+    IR_TYPE_INT8,     /// Integers of 8 bits, held in 32 bits like an Int (see integer.h).
+    IR_TYPE_INT16,    /// Integers of 16 bits.
+    IR_TYPE_UINT8,    /// Unsigned integers of 8 bits.
+    IR_TYPE_UINT16,   /// Unsigned integers of 16 bits.
+    IR_TYPE_UINT32,   /// Unsigned integers of 32 bits, which are divided, compared and converted as unsigned.
+    IR_TYPE_VEC4F,    /// Vectors of 4 Float lanes, held in a single register (see vector.h).
+    IR_TYPE_VEC8F,    /// Vectors of 8 Float lanes.
+    IR_TYPE_VEC4I,    /// Vectors of 4 Int lanes.
+    IR_TYPE_VEC8I,    /// Vectors of 8 Int lanes.
+    IR_TYPE_MASK4,    /// Masks of 4 Bool lanes, given by comparing two vectors of 4 lanes.
+    IR_TYPE_MASK8,    /// Masks of 8 Bool lanes.
+} IRType;
+
+/// Operation codes of the IR instructions.
+typedef enum {
+    IR_CONSTANT,            /// destination = constant
+    IR_COPY,                /// destination = operands[0]
+    IR_CONVERT,             /// destination = (Float) operands[0]
+    IR_DECLARE,             /// Starts the lifetime of the local at destination (no value is assigned).
+    IR_LOAD_GLOBAL,         /// destination = globals[constant.integerValue]
+    IR_STORE_GLOBAL,        /// globals[constant.integerValue] = operands[0]
+    IR_ADD,                 /// destination = operands[0] + operands[1]
+    IR_SUBTRACT,            /// destination = operands[0] - operands[1]
+    IR_MULTIPLY,            /// destination = operands[0] * operands[1]
+    IR_DIVIDE,              /// destination = operands[0] / operands[1]
+    IR_MODULO,              /// destination = operands[0] % operands[1]
+    IR_NEGATE,              /// destination = -operands[0]
+    IR_NOT,                 /// destination = !operands[0]
+    IR_FACTORIAL,           /// destination = operands[0]!
+    IR_SHIFT_LEFT,          /// destination = operands[0] << constant.integerValue
+    IR_SHIFT_RIGHT,         /// destination = operands[0] >> constant.integerValue (arithmetic, the sign is kept)
+    IR_SHIFT_RIGHT_LOGICAL, /// destination = (unsigned) operands[0] >> constant.integerValue
+    IR_BITWISE_AND,         /// destination = operands[0] & constant.integerValue
+    IR_MULTIPLY_HIGH,       /// destination = the high 32 bits of the 64-bit product operands[0] * constant.integerValue
+    IR_BIT_TEST,            /// destination = bit (operands[0] - operands[1]) of constant.integerValue, or false if the
+                            /// difference is not in [0, 32).
+    IR_STRING_HASH,         /// destination = the hash of the string operands[0] seeded by constant.integerValue.
+    IR_EQUAL,               /// destination = operands[0] == operands[1]
+    IR_NOT_EQUAL,           /// destination = operands[0] != operands[1]
+    IR_LESS_THAN,           /// destination = operands[0] < operands[1]
+    IR_LESS_OR_EQUAL,       /// destination = operands[0] <= operands[1]
+    IR_GREATER_THAN,        /// destination = operands[0] > operands[1]
+    IR_GREATER_OR_EQUAL,    /// destination = operands[0] >= operands[1]
+    IR_SPLAT,               /// destination = the vector holding operands[0] in every lane
+    IR_INSERT_LANE,         /// destination = operands[0] with its lane constant.integerValue replaced by operands[1]
+    IR_EXTRACT_LANE,        /// destination = the lane constant.integerValue of operands[0]
+    IR_ARGUMENT,            /// Passes operands[0] as the next argument of the following call.
+    IR_CALL,                /// destination = call the function named by constant.stringIndex with the arguments.
+    IR_LOAD_RESULT,         /// destination = the lane constant.integerValue of the vector returned by the last call,
+                            /// once the vectors have been split into their lanes (see scalarizeIRProgram()).
+    IR_STORE_RESULT,        /// Returns operands[0] as the lane constant.integerValue of the vector returned by the
+                            /// following return, whose operand is the lane 0.
+    IR_JUMP,                /// Terminator: jumps to targets[0].
+    IR_BRANCH,              /// Terminator: jumps to targets[0] if operands[0] is true, otherwise to targets[1].
+    IR_SWITCH,              /// Terminator: jumps through the table constant.integerValue of the function by the value
+                            /// operands[0], or to targets[0] if the value is not in the table.
+    IR_RETURN,              /// Terminator: returns operands[0] (or nothing if there is no register).
+} IROpcode;
+
+/// Immediate value of an instruction, where the member in use depends on the type of the instruction.
+typedef union {
+    int integerValue;
+    float floatingValue;
+    int booleanValue;
+    int stringIndex;
+} IRConstant;
+
+/// A three-address instruction.
+typedef struct {
+    IROpcode opcode;        /// The operation of the instruction.
+    IRType type;            /// The type of the value defined by the instruction.
+    int destination;        /// The register defined by the instruction, or IR_NO_REGISTER.
+    int operands[2];        /// The registers used by the instruction, or IR_NO_REGISTER.
+    int targets[2];         /// The successor blocks of a terminator, or IR_NO_BLOCK.
+    IRConstant constant;    /// The immediate value of the instruction.
+    int argumentCount;      /// The number of IR_ARGUMENT instructions right before an IR_CALL.
+    Location location;      /// The location in the source code, used for diagnostics.
+} IRInstruction;
+
+/// A basic block, that is a sequence of instructions with a single entry and a single terminator at the end.
+typedef struct {
+    int index;                      /// The index of the block in its function.
+    IRInstruction *instructions;    /// The instructions of the block.
+    int instructionCount;           /// The number of instructions in the block.
+    int instructionCapacity;        /// The allocated capacity of the instruction array.
+    int *predecessors;              /// The indices of the predecessor blocks.
+    int predecessorCount;           /// The number of predecessor blocks.
+} BasicBlock;
+
+/// The table of an IR_SWITCH, which goes to a block for each value of a range.
+typedef struct {
+    int low;          /// The value going to the first block.
+    int count;        /// The number of values in the range.
+    int *targets;     /// The block each value goes to.
+} IRSwitchTable;
+
+/// A named local variable or constant, where each declaration gets its own local even if the names are the same.
+typedef struct {
+    char identifier[LEXEME_LENGTH];   /// The name of the local.
+    int registerIndex;                /// The register holding the local (equal to its index once lowered).
+    IRType type;                      /// The type of the local.
+    int isMutable;                    /// Whether it is declared by 'var' (or it is a parameter).
+    int isParameter;                  /// Whether it is a parameter of the function.
+    int isGlobal;                     /// Whether it is declared at the top level of the program.
+    Location declarationLocation;     /// The location where the local is declared.
+} IRLocal;
+
+/// A function lowered into a control flow graph, where the block 0 is the entry block.
+/// Registers [0, localCount) hold the locals (parameters first), and the rest hold temporaries.
+typedef struct {
+    char name[LEXEME_LENGTH];   /// The name of the function.
+    IRType returnType;          /// The type of the returned value.
+    Location location;          /// The location where the function is defined.
+    IRLocal *locals;            /// The locals of the function.
+    int localCount;             /// The number of locals.
+    int localCapacity;          /// The allocated capacity of the local array.
+    int parameterCount;         /// The number of parameters, which are the first locals.
+    IRType *registerTypes;      /// The type of each register.
+    int registerCount;          /// The number of registers.
+    int registerCapacity;       /// The allocated capacity of the register type array.
+    BasicBlock **blocks;        /// The basic blocks of the function.
+    int blockCount;             /// The number of basic blocks.
+    int blockCapacity;          /// The allocated capacity of the block array.
+    int *slots;                 /// The frame slot of each register, or NULL if the frame has not been allocated.
+    int frameSize;              /// The number of frame slots once the frame has been allocated.
+    int isLaidOut;              /// Whether the blocks are in the order they are emitted (see cfg.h).
+    IRSwitchTable *switchTables;   /// The tables of the switches of the function.
+    int switchTableCount;       /// The number of switch tables.
+    int switchTableCapacity;    /// The allocated capacity of the switch table array.
+} IRFunction;
+
+/// A function or a constant exported by an imported module, which is only known by the interface of the module.
+typedef struct {
+    char identifier[LEXEME_LENGTH];                        /// The name of the function or the constant.
+    char module[LEXEME_LENGTH];                            /// The name of the module exporting it.
+    int isFunction;                                        /// Whether it is a function (otherwise a constant).
+    IRType type;                                           /// The returned type, or the type of the constant.
+    int parameterCount;                                    /// The number of parameters of a function.
+    char parameterLabels[IR_MAX_PARAMETERS][LEXEME_LENGTH];   /// The label of each parameter.
+    IRType parameterTypes[IR_MAX_PARAMETERS];              /// The type of each parameter.
+    IRConstant value;                                      /// The value of a constant (except for a string).
+    char stringValue[LEXEME_LENGTH];                       /// The value of a String constant.
+} IRExternal;
+
+/// A whole Opus program in the IR, where the function 0 is the entry function that runs the top-level statements.
+/// The locals of the entry function declared at the top level are the globals of the program.
+typedef struct {
+    IRFunction **functions;        /// The functions of the program.
+    int functionCount;             /// The number of functions.
+    int functionCapacity;          /// The allocated capacity of the function array.
+    char **strings;                /// The string table, where each string literal is stored once.
+    int stringCount;               /// The number of strings.
+    int stringCapacity;            /// The allocated capacity of the string table.
+    int errorCount;                /// The number of errors found while lowering.
+    IRExternal *externals;         /// The functions and constants of the imported modules.
+    int externalCount;             /// The number of externals.
+    int externalCapacity;          /// The allocated capacity of the external array.
+    DiagnosticList *diagnostics;   /// The list receiving the errors, or NULL to print them (see diagnostic.h).
+    int isOverflowChecked;         /// Whether Int arithmetic fails on overflow at runtime instead of wrapping around.
+} IRProgram;
+
+/// A name visible to the lowering, that is a local of the function being lowered or a global.
+typedef struct {
+    char identifier[LEXEME_LENGTH];   /// The name of the local.
+    int local;                        /// The index of the local in its function.
+    int depth;                        /// The depth of the code block declaring the local.
+    int isGlobal;                     /// Whether it is a global, accessed by loading and storing.
+} IRBinding;
+
+/// The state of lowering an AST into the IR.
+typedef struct {
+    IRProgram *program;       /// The program being built.
+    IRFunction *function;     /// The function being built.
+    int currentBlock;         /// The block where instructions are appended.
+    IRBinding *bindings;      /// The visible names, where the innermost ones are at the end.
+    int bindingCount;         /// The number of visible names.
+    int bindingCapacity;      /// The allocated capacity of the binding array.
+    int depth;                /// The depth of the current code block, where 0 is the top level.
+    int functionBinding;      /// The first binding of the function being built (globals are visible below it).
+    int nextFunction;         /// The next function declared ahead for a top-level implementation.
+    int isFoldingEnabled;     /// Whether the expressions folded by the analyzer are lowered into constants.
+    struct IRGenericTable *generics;   /// The generic functions and their specializations (see generic.h).
+    int specialization;       /// The specialization being built, or -1.
+    int globalBinding;        /// The end of the globals visible to the function being built.
+} IRBuilder;
+
+/// Lowers an analyzed AST into the IR.
+///
+/// The top-level statements are lowered into the entry function, while every function implementation is lowered
+/// into a function of its own. If folding is enabled, any expression that has been folded by the analyzer is lowered
+/// into a constant. A conditional statement whose condition has been folded only lowers the branch that will be
+/// executed in any case, since the definite assignment must not depend on whether the program is optimized.
+///
+/// @param root Pointer to the root node of the AST.
+/// @param isFoldingEnabled Whether the expressions folded by the analyzer are lowered into constants.
+/// @return A pointer to the lowered program, or NULL if memory allocation fails.
+///
+IRProgram *lowerProgram(ASTNode *root, int isFoldingEnabled);
+
+/// Lowers an analyzed AST into a program that has been initialized, so that the externals of the imported modules
+/// could be declared beforehand. A call to an external function is checked against its signature, and reading an
+/// external constant loads its value.
+///
+/// @param program The program to lower into, which must not have any function yet.
+/// @param root Pointer to the root node of the AST.
+/// @param isFoldingEnabled Whether the expressions folded by the analyzer are lowered into constants.
+///
+void lowerIntoIRProgram(IRProgram *program, ASTNode *root, int isFoldingEnabled);
+
+/// Lowers a statement into the current block of the builder.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the statement.
+///
+void lowerStatement(IRBuilder *builder, ASTNode *node);
+
+/// Lowers a variable or constant declaration by creating a new local and starting its lifetime.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the declaration.
+/// @return The register of the declared local.
+///
+int lowerDeclaration(IRBuilder *builder, ASTNode *node);
+
+/// Lowers an assignment statement (and the declaration that comes together with it).
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the assignment.
+/// @return The register holding the assigned value, or IR_NO_REGISTER if nothing is assigned.
+///
+int lowerAssignmentStatement(IRBuilder *builder, ASTNode *node);
+
+/// Lowers a code block, where the locals declared inside are invisible after the block.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the code block.
+///
+void lowerCodeBlock(IRBuilder *builder, ASTNode *node);
+
+/// Lowers a conditional statement into a branch to the if-block and the else-block, which join afterward.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the conditional statement.
+///
+void lowerConditionalStatement(IRBuilder *builder, ASTNode *node);
+
+/// Lowers a repeat-until loop, where the body is executed before checking the condition.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the loop.
+///
+void lowerRepeatUntilStatement(IRBuilder *builder, ASTNode *node);
+
+/// Lowers a for-in loop, where the body might be executed zero or more times.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the loop.
+///
+void lowerForInStatement(IRBuilder *builder, ASTNode *node);
+
+/// Lowers a return statement, and continues lowering in a new unreachable block.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the return statement.
+///
+void lowerReturnStatement(IRBuilder *builder, ASTNode *node);
+
+/// Declares a function from its definition (name, parameters and return type) without lowering its body, so that
+/// calls appearing before the implementation know the returned type.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the function definition.
+/// @return The index of the declared function in the program.
+///
+int lowerFunctionDefinition(IRBuilder *builder, ASTNode *node);
+
+/// Lowers a function implementation into a function of the program, which is declared ahead for the top level.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the function implementation.
+///
+void lowerFunctionImplementation(IRBuilder *builder, ASTNode *node);
+
+/// Lowers the body of a declared function, whose parameters are visible to the body, together with the globals.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param index The index of the function in the program.
+/// @param body Pointer to the AST node representing the code block of the function.
+///
+void lowerFunctionBody(IRBuilder *builder, int index, ASTNode *body);
+
+/// Lowers an expression and returns the register holding its value.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the expression.
+/// @return The register holding the value of the expression, or IR_NO_REGISTER if there is no value.
+///
+int lowerExpression(IRBuilder *builder, ASTNode *node);
+
+/// Checks a call to a function of an imported module against the signature in its interface, that is the number of
+/// arguments, their labels and their types (where a value of an unknown type is accepted).
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the function call.
+/// @param external The called function.
+/// @param arguments The registers holding the arguments.
+/// @param argumentCount The number of arguments.
+/// @return 1 (True) if the call matches the signature, 0 (False) otherwise.
+///
+int checkIRExternalCall(IRBuilder *builder, ASTNode *node, IRExternal *external, int *arguments, int argumentCount);
+
+/// Lowers a logical 'and' or 'or' whose value is needed, where the right operand is only evaluated if the left
+/// operand does not decide the result, and each outcome assigns the result in a block of its own.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the binary expression.
+/// @return The register holding the value of the expression, or IR_NO_REGISTER if there is no value.
+///
+int lowerLogicalExpression(IRBuilder *builder, ASTNode *node);
+
+/// Lowers a condition directly into conditional jumps, so that no boolean is materialized for the logical operators:
+/// 'and' and 'or' branch on their left operand before evaluating the right operand, and '!' swaps the targets.
+/// The current block is terminated, and each target is reached exactly when the condition has that outcome.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param node Pointer to the AST node representing the condition.
+/// @param trueBlock The block to execute if the condition holds.
+/// @param falseBlock The block to execute otherwise.
+///
+void lowerCondition(IRBuilder *builder, ASTNode *node, int trueBlock, int falseBlock);
+
+/// Makes a local of the function being built visible to the statements that follow in the current code block.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param local The index of the local in the function being built.
+///
+void bindIRLocal(IRBuilder *builder, int local);
+
+/// Looks up the innermost visible name, where the locals of an enclosing function are invisible except for globals.
+///
+/// @param builder Pointer to the IRBuilder instance.
+/// @param identifier The name to look up.
+/// @return A pointer to the binding, or NULL if the name is not visible.
+///
+IRBinding *lookupIRBinding(IRBuilder *builder, const char *identifier);
+
+/// Initializes a new, empty IR program.
+/// @return A pointer to the newly allocated IRProgram, or NULL if memory allocation fails.
+///
+IRProgram *initIRProgram();
+
+/// Initializes a new function with an empty entry block.
+///
+/// @param name The name of the function.
+/// @param returnType The type of the returned value.
+/// @param location The location where the function is defined.
+/// @return A pointer to the newly allocated IRFunction, or NULL if memory allocation fails.
+///
+IRFunction *initIRFunction(const char *name, IRType returnType, Location location);
+
+/// Adds a function to the program.
+///
+/// @param program The program to add the function to.
+/// @param function The function to add.
+/// @return The index of the function in the program.
+///
+int addIRFunction(IRProgram *program, IRFunction *function);
+
+/// Finds a function of the program by its name, where the entry function could not be called.
+///
+/// @param program The program to search.
+/// @param name The name of the function.
+/// @return The index of the function, or -1 if not found.
+///
+int findIRFunction(IRProgram *program, const char *name);
+
+/// Declares a function or a constant exported by an imported module.
+///
+/// @param program The program importing the module.
+/// @param external The external to declare, which is copied.
+/// @return The index of the external, or -1 if memory allocation fails.
+///
+int addIRExternal(IRProgram *program, const IRExternal *external);
+
+/// Finds an external of the program by its name.
+///
+/// @param program The program to search.
+/// @param identifier The name of the external.
+/// @param isFunction Whether to look for a function (otherwise a constant).
+/// @return The index of the external, or -1 if not found.
+///
+int findIRExternal(IRProgram *program, const char *identifier, int isFunction);
+
+/// Adds a new empty basic block to the function.
+///
+/// @param function The function to add the block to.
+/// @return The index of the new block.
+///
+int addIRBlock(IRFunction *function);
+
+/// Adds a new local to the function and allocates a register for it.
+///
+/// @param function The function to add the local to.
+/// @param identifier The name of the local.
+/// @param type The type of the local.
+/// @param location The location where the local is declared.
+/// @return The index of the local.
+///
+int addIRLocal(IRFunction *function, const char *identifier, IRType type, Location location);
+
+/// Renumbers the registers of a lowered function, so that the local i is held by the register i and the
+/// temporaries follow the locals in the order they were allocated.
+///
+/// @param function The function to renumber.
+///
+void orderIRRegisters(IRFunction *function);
+
+/// Allocates a new register of the given type.
+///
+/// @param function The function to allocate the register in.
+/// @param type The type of the value held by the register.
+/// @return The index of the new register.
+///
+int addIRRegister(IRFunction *function, IRType type);
+
+/// Appends a new instruction at the end of a block, where all registers and targets are initially unused.
+///
+/// @param function The function owning the block.
+/// @param block The index of the block.
+/// @param opcode The operation of the instruction.
+/// @param type The type of the value defined by the instruction.
+/// @param location The location in the source code.
+/// @return A pointer to the new instruction, which is valid until the next instruction is appended to the block.
+///
+IRInstruction *emitIRInstruction(IRFunction *function, int block, IROpcode opcode, IRType type, Location location);
+
+/// Stores a string in the string table of the program if it has not been stored.
+///
+/// @param program The program owning the string table.
+/// @param string The string to store.
+/// @return The index of the string in the string table.
+///
+int internIRString(IRProgram *program, const char *string);
+
+/// Checks if an instruction ends a basic block.
+///
+/// @param opcode The operation of the instruction.
+/// @return 1 (True) if it is a terminator, 0 (False) otherwise.
+///
+int isIRTerminator(IROpcode opcode);
+
+/// Checks if a block has been terminated (that is, its last instruction is a terminator).
+///
+/// @param block The block to check.
+/// @return 1 (True) if the block is terminated, 0 (False) otherwise.
+///
+int isIRBlockTerminated(BasicBlock *block);
+
+/// Checks if an instruction only computes its destination, that is it has no side effect and could not trap at
+/// runtime (divisions might divide by zero), so that it could be removed once its value is unused.
+///
+/// @param opcode The operation of the instruction.
+/// @return 1 (True) if the instruction is pure, 0 (False) otherwise.
+///
+int isIRPure(IROpcode opcode);
+
+/// Checks if a register of a function holds a global, which any call might read or assign.
+///
+/// @param program The program owning the function.
+/// @param function The function owning the register.
+/// @param reg The register to check.
+/// @return 1 (True) if the register is a global, 0 (False) otherwise.
+///
+int isIRGlobal(IRProgram *program, IRFunction *function, int reg);
+
+/// Gets the registers used by an instruction.
+///
+/// @param instruction The instruction to inspect.
+/// @param uses An array receiving up to two used registers.
+/// @return The number of used registers.
+///
+int getIRUses(IRInstruction *instruction, int uses[2]);
+
+/// Gets the successors of a block, according to its terminator, where a block reached by several targets is a single
+/// successor.
+///
+/// @param function The function owning the block, which holds the table of a switch.
+/// @param block The block to inspect.
+/// @param successors An array receiving the successor blocks, which holds as many blocks as the function.
+/// @return The number of successors.
+///
+int getIRSuccessors(IRFunction *function, BasicBlock *block, int *successors);
+
+/// Renumbers the targets of every terminator and switch table of a function, after its blocks have been moved.
+///
+/// @param function The function whose targets are renumbered.
+/// @param renumbered The new index of each block, or IR_NO_BLOCK if it has been removed.
+///
+void renumberIRTargets(IRFunction *function, const int *renumbered);
+
+/// Adds a switch table to a function, whose values all go to the given block until they are assigned.
+///
+/// @param function The function owning the table.
+/// @param low The value going to the first block.
+/// @param count The number of values.
+/// @param target The block every value goes to at first.
+/// @return The index of the table, or -1 if memory allocation fails.
+///
+int addIRSwitchTable(IRFunction *function, int low, int count, int target);
+
+/// Hashes a string for IR_STRING_HASH (FNV-1a from a seed), which every backend computes the same way.
+///
+/// @param string The string to hash.
+/// @param seed The seed of the hash.
+/// @return The hash of the string.
+///
+int hashIRString(const char *string, int seed);
+
+/// Computes the predecessors of every block of the function, which must be recomputed after the CFG changes.
+/// @param function The function whose blocks are updated.
+///
+void computeIRPredecessors(IRFunction *function);
+
+/// Converts a type name of Opus (e.g. "Int" or "UInt8") into an IR type, where "Int32" is another name of "Int".
+///
+/// @param typeName The type name to convert.
+/// @return The corresponding IR type, or IR_TYPE_ANY if the type is not a native type.
+///
+IRType getIRType(const char *typeName);
+
+/// Converts an IR type into the type name of Opus.
+///
+/// @param type The IR type to convert.
+/// @return The corresponding type name.
+///
+const char *getIRTypeName(IRType type);
+
+/// Gets the mnemonic of an operation code for displaying.
+///
+/// @param opcode The operation code.
+/// @return The mnemonic of the operation code.
+///
+const char *getIROpcodeName(IROpcode opcode);
+
+/// Displays all functions of the program in a readable format.
+/// @param program The program to display.
+///
+void displayIRProgram(IRProgram *program);
+
+/// Displays a single instruction in a readable format (without a newline).
+///
+/// @param program The program owning the instruction (for the string table).
+/// @param instruction The instruction to display.
+///
+void displayIRInstruction(IRProgram *program, IRInstruction *instruction);
+
+/// Displays a function, including its locals and all its basic blocks.
+///
+/// @param program The program owning the function (for the string table).
+/// @param function The function to display.
+///
+void displayIRFunction(IRProgram *program, IRFunction *function);
+
+/// Frees all memory associated with a function.
+/// @param function The function to free.
+///
+void freeIRFunction(IRFunction *function);
+
+/// Frees all memory associated with a program, including all its functions.
+/// @param program The program to free.
+///
+void freeIRProgram(IRProgram *program);
+
+#endif
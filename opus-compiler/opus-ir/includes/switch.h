@@ -0,0 +1,84 @@
+// switch.h
+//
+// Lowering of the switch statement of the Opus programming language (e.g. "switch grade { case 1, 2 { ... } }"). A
+// switch only matches literal values, so its cases are known while lowering, and the dispatch is chosen from their
+// values rather than testing each case in turn:
+//
+// - A switch over an Int whose values are dense enough becomes a jump table (IR_SWITCH), going straight to the case
+//   of the value, and to the default case for the holes of the table or a value outside of it.
+// - Values spread over at most 32 integers and going to a few cases are tested as bits of a mask (IR_BIT_TEST), a
+//   test for each case rather than for each value.
+// - Sparse values are searched by comparing the value with the middle value, which splits the values in two halves
+//   dispatched the same way, so a dense cluster among sparse values still gets its own table.
+// - A switch over a String hashes the value with a seed chosen so that every case lands in a slot of its own in a
+//   table of a power of 2 (a perfect hash), and the slot compares the value with the only string that might match.
+// - Only a few values are compared one after another, which takes less than any of the above.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef SWITCH_H
+#define SWITCH_H
+
+#include "ir.h"
+
+#define IR_SWITCH_LINEAR_CASES         3      // The most values compared one after another
+#define IR_SWITCH_TABLE_CASES          4      // The fewest values of a jump table
+#define IR_SWITCH_TABLE_DENSITY        3      // The most entries of a jump table for each value
+#define IR_SWITCH_TABLE_RANGE          1024   // The most entries of a jump table
+#define IR_SWITCH_BIT_TEST_TARGETS     3      // The most cases tested as bits of a mask
+#define IR_SWITCH_HASH_SEEDS           256    // The seeds tried for each size of a perfect hash
+
+/// A value matched by a case of a switch.
+typedef struct {
+    int value;           /// The Int or Bool value, or the index of the String in the string table.
+    int target;          /// The block of the case.
+    Location location;   /// The location of the value in the source code.
+} IRSwitchEntry;
+
+/// Lowers a switch statement, where the body of each case is a block of its own, followed by the block where the
+/// cases join. A case value must be a literal of the type of the switched value, matched by a single case, and a
+/// switch must have a 'default' case unless it matches both values of a Bool.
+///
+/// @param builder The state of the lowering.
+/// @param node The AST_SWITCH_STATEMENT node.
+///
+void lowerSwitchStatement(IRBuilder *builder, ASTNode *node);
+
+/// Lowers the dispatch of a switch over an Int into the current block (see the strategies above).
+///
+/// @param builder The state of the lowering.
+/// @param value The register holding the switched value.
+/// @param entries The values of the cases, sorted by their values.
+/// @param count The number of values.
+/// @param defaultBlock The block of the default case.
+/// @param location The location of the switch.
+///
+void lowerIntSwitch(IRBuilder *builder, int value, IRSwitchEntry *entries, int count, int defaultBlock,
+                    Location location);
+
+/// Lowers the dispatch of a switch over a String into the current block, through a perfect hash if there are more
+/// than a few cases.
+///
+/// @param builder The state of the lowering.
+/// @param value The register holding the switched value.
+/// @param entries The values of the cases.
+/// @param count The number of values.
+/// @param defaultBlock The block of the default case.
+/// @param location The location of the switch.
+///
+void lowerStringSwitch(IRBuilder *builder, int value, IRSwitchEntry *entries, int count, int defaultBlock,
+                       Location location);
+
+/// Finds a perfect hash of the strings of a switch, that is a seed and a power of 2 for which the hash of each string
+/// (see hashIRString()) modulo the power of 2 is different.
+///
+/// @param program The program holding the string table.
+/// @param entries The values of the cases, which are indices in the string table.
+/// @param count The number of values.
+/// @param seed Receives the seed of the hash.
+/// @return The size of the table, or 0 if no perfect hash has been found.
+///
+int findPerfectHash(IRProgram *program, const IRSwitchEntry *entries, int count, int *seed);
+
+#endif
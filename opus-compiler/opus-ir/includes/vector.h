@@ -0,0 +1,133 @@
+// vector.h
+//
+// Fixed-width vector types of the Opus programming language (Vec4f, Vec8f, Vec4i and Vec8i, with 4 or 8 lanes of
+// Float or Int), and the masks given by comparing them (Mask4 and Mask8, with lanes of Bool). A vector is a value of
+// its own in the IR, held in a single register, so it is declared, assigned, passed and returned like a scalar, and
+// each operation on it is a single instruction on every lane at once, which the C backend emits on the vector types
+// of GCC and Clang, mapping them to SSE or AVX registers (see the README):
+//
+// - A vector is built from one value for each lane ('Vec4f(lane: 1.0, lane: 2.0, lane: 3.0, lane: 4.0)'), or from a
+//   value broadcast into every lane ('Vec4f(splat: 0.5)').
+// - Arithmetic works lane by lane on two vectors of the same type, or on a vector and a scalar, which is broadcast.
+// - A comparison gives a mask holding the comparison of each lane ('a < b' of two Vec4f is a Mask4), which is only
+//   compared for equality or negated by '!'.
+// - A reduction gives a scalar: 'sum(of:)', 'min(of:)' and 'max(of:)' of a vector, 'any(of:)' and 'all(of:)' of a
+//   mask. The lanes are reduced by halves (lane i with lane i + 4, then i + 2, then i + 1), which is the order of a
+//   horizontal reduction in SIMD registers, and the order the analyzer folds them in.
+//
+// The virtual machine holds a single 32-bit value in each slot, so the vectors of a program it runs are split into
+// their lanes beforehand (see scalarizeIRProgram()).
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef VECTOR_H
+#define VECTOR_H
+
+#include "ir.h"
+
+#define IR_VECTOR_MAX_LANES   8   // The most lanes of a vector
+
+/// Checks if a type is a vector or a mask.
+///
+/// @param type The type to check.
+/// @return 1 (True) if the type is a vector or a mask, 0 (False) otherwise.
+///
+int isIRVectorType(IRType type);
+
+/// Gets the number of lanes of a vector type.
+///
+/// @param type The vector type.
+/// @return The number of lanes (4 or 8), or 0 if the type is not a vector type.
+///
+int getIRVectorLanes(IRType type);
+
+/// Gets the type of the lanes of a vector type.
+///
+/// @param type The vector type.
+/// @return Float or Int for a vector, Bool for a mask, or IR_TYPE_ANY if the type is not a vector type.
+///
+IRType getIRLaneType(IRType type);
+
+/// Gets the mask given by comparing two vectors of a type.
+///
+/// @param type The vector type.
+/// @return The mask with as many lanes as the vector (e.g. Mask8 for a Vec8f).
+///
+IRType getIRMaskType(IRType type);
+
+/// Lowers a vector folded by the analyzer, which broadcasts its first lane and replaces the lanes that differ.
+///
+/// @param builder The state of the lowering.
+/// @param node The folded expression.
+/// @param type The vector type of the expression.
+/// @return The register holding the vector.
+///
+int lowerVectorConstant(IRBuilder *builder, ASTNode *node, IRType type);
+
+/// Lowers the construction of a vector, from a value for each lane or from a value broadcast into every lane.
+///
+/// @param builder The state of the lowering.
+/// @param node The AST_FUNCTION_CALL node named by the vector type.
+/// @param type The vector type.
+/// @return The register holding the vector, or IR_NO_REGISTER if the construction is invalid (which is reported).
+///
+int lowerVectorConstruction(IRBuilder *builder, ASTNode *node, IRType type);
+
+/// Lowers a binary operation on a vector, where a scalar operand is broadcast into every lane and a comparison gives
+/// a mask.
+///
+/// @param builder The state of the lowering.
+/// @param node The AST_BINARY_EXPRESSION node.
+/// @param opcode The operation on each lane.
+/// @param lhs The register holding the left operand.
+/// @param rhs The register holding the right operand.
+/// @return The register holding the result, or IR_NO_REGISTER if the operation is invalid (which is reported).
+///
+int lowerVectorBinary(IRBuilder *builder, ASTNode *node, IROpcode opcode, int lhs, int rhs);
+
+/// Lowers a negation of a vector, that is '-' of a vector and '!' of a mask.
+///
+/// @param builder The state of the lowering.
+/// @param node The AST_UNARY_EXPRESSION node.
+/// @param opcode The operation on each lane.
+/// @param operand The register holding the vector.
+/// @return The register holding the result, or IR_NO_REGISTER if the operation is invalid (which is reported).
+///
+int lowerVectorUnary(IRBuilder *builder, ASTNode *node, IROpcode opcode, int operand);
+
+/// Lowers a reduction of a vector into a scalar (e.g. "sum(of: v)"), if a call is one.
+///
+/// @param builder The state of the lowering.
+/// @param node The AST_FUNCTION_CALL node.
+/// @param value Receives the register holding the reduced value, or IR_NO_REGISTER if the reduction is invalid
+///              (which is reported).
+/// @return 1 (True) if the call is a reduction of a vector, 0 (False) if it is a call of a function.
+///
+int lowerVectorReduction(IRBuilder *builder, ASTNode *node, int *value);
+
+/// Checks the arguments of a call to a function of the program where a vector is involved, since the bodies of
+/// functions are not analyzed, while a vector could only be given to a parameter of the same type.
+///
+/// @param builder The state of the lowering.
+/// @param node The AST_FUNCTION_CALL node.
+/// @param callee The called function.
+/// @param arguments The registers holding the arguments.
+/// @param argumentCount The number of arguments.
+/// @return 1 (True) if every vector matches its parameter, 0 (False) otherwise (which is reported).
+///
+int checkVectorArguments(IRBuilder *builder, ASTNode *node, IRFunction *callee, const int *arguments,
+                         int argumentCount);
+
+/// Splits every vector of a program into its lanes, for a backend holding a single scalar in each register: a vector
+/// local becomes a local for each lane (e.g. "v[0]" to "v[3]" for a Vec4f named 'v'), and an operation on a vector
+/// the same operation on each lane. A vector argument is passed as an argument for each lane, while a vector is
+/// returned as its lane 0, its other lanes being stored by IR_STORE_RESULT before the return and loaded by
+/// IR_LOAD_RESULT after the call.
+///
+/// @param program The lowered program, whose registers are renumbered.
+/// @return 1 (True) if the program has been split, 0 (False) if memory allocation fails.
+///
+int scalarizeIRProgram(IRProgram *program);
+
+#endif
@@ -0,0 +1,155 @@
+// bitset.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include "bitset.h"
+
+Bitset *initBitset(int size) {
+    Bitset *bitset = (Bitset*) malloc(sizeof(Bitset));
+    if (!bitset) return NULL;
+
+    bitset->size = size;
+    bitset->wordCount = (size + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+    bitset->words = (uint64_t*) calloc(bitset->wordCount ? bitset->wordCount : 1, sizeof(uint64_t));
+
+    if (!bitset->words) {
+        free(bitset);
+        return NULL;
+    }
+
+    return bitset;
+}
+
+Bitset *initBitsetArray(int count, int size) {
+    Bitset *bitsets = (Bitset*) malloc((count ? count : 1) * sizeof(Bitset));
+    if (!bitsets) return NULL;
+
+    // All words live in one allocation owned by the first bitset, so that the sets of neighbouring blocks are
+    // also neighbours in memory
+    int wordCount = (size + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+    uint64_t *words = (uint64_t*) calloc((size_t) count * wordCount + 1, sizeof(uint64_t));
+
+    if (!words) {
+        free(bitsets);
+        return NULL;
+    }
+
+    for (int index = 0; index < count; index++) {
+        bitsets[index].size = size;
+        bitsets[index].wordCount = wordCount;
+        bitsets[index].words = words + (size_t) index * wordCount;
+    }
+
+    // Keep the allocation reachable even for an empty array
+    if (count == 0) bitsets[0].words = words;
+    return bitsets;
+}
+
+void freeBitset(Bitset *bitset) {
+    if (!bitset) return;
+    free(bitset->words);
+    free(bitset);
+}
+
+void freeBitsetArray(Bitset *bitsets) {
+    if (!bitsets) return;
+    free(bitsets[0].words);
+    free(bitsets);
+}
+
+void setBit(Bitset *bitset, int index) {
+    bitset->words[index / BITSET_WORD_BITS] |= (uint64_t) 1 << (index % BITSET_WORD_BITS);
+}
+
+void clearBit(Bitset *bitset, int index) {
+    bitset->words[index / BITSET_WORD_BITS] &= ~((uint64_t) 1 << (index % BITSET_WORD_BITS));
+}
+
+int testBit(const Bitset *bitset, int index) {
+    return (bitset->words[index / BITSET_WORD_BITS] >> (index % BITSET_WORD_BITS)) & 1;
+}
+
+void fillBitset(Bitset *bitset) {
+    if (bitset->wordCount == 0) return;
+    memset(bitset->words, 0xFF, bitset->wordCount * sizeof(uint64_t));
+
+    // Bits beyond the size must stay cleared, otherwise counting and searching would see them
+    int remainder = bitset->size % BITSET_WORD_BITS;
+    if (remainder) bitset->words[bitset->wordCount - 1] = ((uint64_t) 1 << remainder) - 1;
+}
+
+void clearBitset(Bitset *bitset) {
+    if (bitset->wordCount) memset(bitset->words, 0, bitset->wordCount * sizeof(uint64_t));
+}
+
+int copyBitset(Bitset *destination, const Bitset *source) {
+    uint64_t changed = 0;
+
+    for (int index = 0; index < destination->wordCount; index++) {
+        changed |= destination->words[index] ^ source->words[index];
+        destination->words[index] = source->words[index];
+    }
+
+    return changed != 0;
+}
+
+int unionBitset(Bitset *destination, const Bitset *source) {
+    uint64_t changed = 0;
+
+    for (int index = 0; index < destination->wordCount; index++) {
+        uint64_t word = destination->words[index] | source->words[index];
+        changed |= word ^ destination->words[index];
+        destination->words[index] = word;
+    }
+
+    return changed != 0;
+}
+
+int intersectBitset(Bitset *destination, const Bitset *source) {
+    uint64_t changed = 0;
+
+    for (int index = 0; index < destination->wordCount; index++) {
+        uint64_t word = destination->words[index] & source->words[index];
+        changed |= word ^ destination->words[index];
+        destination->words[index] = word;
+    }
+
+    return changed != 0;
+}
+
+int subtractBitset(Bitset *destination, const Bitset *source) {
+    uint64_t changed = 0;
+
+    for (int index = 0; index < destination->wordCount; index++) {
+        uint64_t word = destination->words[index] & ~source->words[index];
+        changed |= word ^ destination->words[index];
+        destination->words[index] = word;
+    }
+
+    return changed != 0;
+}
+
+int findNextBit(const Bitset *bitset, int from) {
+    if (from < 0) from = 0;
+    if (from >= bitset->size) return -1;
+
+    // Mask off the bits before 'from' in the first word, then skip the empty words
+    int wordIndex = from / BITSET_WORD_BITS;
+    uint64_t word = bitset->words[wordIndex] & (~(uint64_t) 0 << (from % BITSET_WORD_BITS));
+
+    while (!word) {
+        if (++wordIndex >= bitset->wordCount) return -1;
+        word = bitset->words[wordIndex];
+    }
+
+    return wordIndex * BITSET_WORD_BITS + __builtin_ctzll(word);
+}
+
+int countBits(const Bitset *bitset) {
+    int count = 0;
+    for (int index = 0; index < bitset->wordCount; index++) count += __builtin_popcountll(bitset->words[index]);
+    return count;
+}
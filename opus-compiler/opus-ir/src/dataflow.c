@@ -0,0 +1,321 @@
+// dataflow.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "dataflow.h"
+
+int computeReversePostOrder(IRFunction *function, int *order) {
+    int blockCount = function->blockCount;
+    int *visited = (int*) calloc(blockCount + 1, sizeof(int));
+    int *stack = (int*) malloc((blockCount + 1) * sizeof(int));
+    int *nextSuccessor = (int*) calloc(blockCount + 1, sizeof(int));
+    int *successors = (int*) malloc((blockCount + 1) * sizeof(int));
+    int count = 0;
+
+    if (!visited || !stack || !nextSuccessor || !successors) {
+        free(visited); free(stack); free(nextSuccessor); free(successors);
+        return 0;
+    }
+
+    // Depth-first search from the entry block, where a block is finished once all its successors are finished
+    int top = 0;
+    stack[top++] = 0;
+    visited[0] = 1;
+
+    while (top > 0) {
+        int block = stack[top - 1];
+        int successorCount = getIRSuccessors(function, function->blocks[block], successors);
+
+        if (nextSuccessor[block] < successorCount) {
+            int successor = successors[nextSuccessor[block]++];
+
+            if (!visited[successor]) {
+                visited[successor] = 1;
+                stack[top++] = successor;
+            }
+        }
+
+        // The post-order is written from the end, so that the array ends up in reverse post-order
+        else {
+            top--;
+            order[blockCount - 1 - count++] = block;
+        }
+    }
+
+    // Move the reachable blocks to the beginning of the array
+    for (int index = 0; index < count; index++) order[index] = order[blockCount - count + index];
+
+    free(visited);
+    free(stack);
+    free(nextSuccessor);
+    free(successors);
+    return count;
+}
+
+int computeLayoutOrder(IRFunction *function, int *order) {
+    int orderCount = computeReversePostOrder(function, order);
+    if (!function->isLaidOut || orderCount == 0) return orderCount;
+
+    unsigned char *isReachable = (unsigned char*) calloc(function->blockCount + 1, 1);
+    if (!isReachable) return orderCount;
+
+    // A pass run after the layout might have left unreachable blocks behind, which are still skipped
+    for (int position = 0; position < orderCount; position++) isReachable[order[position]] = 1;
+
+    int count = 0;
+    for (int block = 0; block < function->blockCount; block++) if (isReachable[block]) order[count++] = block;
+
+    free(isReachable);
+    return count;
+}
+
+DataflowProblem *initDataflowProblem(IRFunction *function, DataflowDirection direction, DataflowMeet meet, int universe) {
+    DataflowProblem *problem = (DataflowProblem*) malloc(sizeof(DataflowProblem));
+    if (!problem) return NULL;
+
+    problem->direction = direction;
+    problem->meet = meet;
+    problem->universe = universe;
+    problem->blockCount = function->blockCount;
+    problem->in = initBitsetArray(function->blockCount, universe);
+    problem->out = initBitsetArray(function->blockCount, universe);
+    problem->gen = initBitsetArray(function->blockCount, universe);
+    problem->kill = initBitsetArray(function->blockCount, universe);
+    problem->boundary = initBitset(universe);
+    problem->order = (int*) malloc((function->blockCount + 1) * sizeof(int));
+    problem->orderCount = problem->order ? computeReversePostOrder(function, problem->order) : 0;
+    problem->visitCount = 0;
+
+    if (!problem->in || !problem->out || !problem->gen || !problem->kill || !problem->boundary || !problem->order) {
+        freeDataflowProblem(problem);
+        return NULL;
+    }
+
+    return problem;
+}
+
+void solveDataflow(IRFunction *function, DataflowProblem *problem) {
+    int isForward = (problem->direction == DATAFLOW_FORWARD);
+    int count = problem->orderCount;
+
+    // Facts are combined at the entry of a block for a forward problem, and at its exit for a backward problem
+    Bitset *joined = isForward ? problem->in : problem->out;
+    Bitset *transferred = isForward ? problem->out : problem->in;
+
+    // Forward problems visit the blocks in reverse post-order, and backward problems visit them in post-order
+    int *position = (int*) malloc((problem->blockCount + 1) * sizeof(int));
+    Bitset *pending = initBitset(count);
+    Bitset *scratch = initBitset(problem->universe);
+    int *successors = (int*) malloc((problem->blockCount + 1) * sizeof(int));
+
+    if (!position || !pending || !scratch || !successors) {
+        free(position); freeBitset(pending); freeBitset(scratch); free(successors);
+        return;
+    }
+
+    for (int block = 0; block < problem->blockCount; block++) position[block] = -1;
+    for (int index = 0; index < count; index++) position[problem->order[isForward ? index : count - 1 - index]] = index;
+
+    // Start from the top element of the meet, which is the full set for an intersection and the empty set for a union
+    for (int block = 0; block < problem->blockCount; block++) {
+        if (problem->meet == DATAFLOW_MEET_INTERSECTION) {
+            fillBitset(&problem->in[block]);
+            fillBitset(&problem->out[block]);
+        }
+
+        else {
+            clearBitset(&problem->in[block]);
+            clearBitset(&problem->out[block]);
+        }
+    }
+
+    // Every reachable block is visited at least once, then only the blocks whose inputs have changed
+    fillBitset(pending);
+    int cursor = 0;
+
+    while (1) {
+        int index = findNextBit(pending, cursor);
+        if (index < 0) index = findNextBit(pending, 0);
+        if (index < 0) break;
+
+        clearBit(pending, index);
+        cursor = index + 1;
+        problem->visitCount++;
+
+        int block = problem->order[isForward ? index : count - 1 - index];
+        BasicBlock *basicBlock = function->blocks[block];
+
+        // The edges whose facts are combined, and the edges whose facts depend on this block
+        int successorCount = getIRSuccessors(function, basicBlock, successors);
+        int *sources = isForward ? basicBlock->predecessors : successors;
+        int sourceCount = isForward ? basicBlock->predecessorCount : successorCount;
+        int *targets = isForward ? successors : basicBlock->predecessors;
+        int targetCount = isForward ? successorCount : basicBlock->predecessorCount;
+
+        // Combine the facts from the boundary (if any) and from every reachable source
+        int isBoundary = isForward ? (block == 0) : (successorCount == 0);
+        int isFirst = 1;
+
+        if (isBoundary) {
+            copyBitset(&joined[block], problem->boundary);
+            isFirst = 0;
+        }
+
+        for (int edge = 0; edge < sourceCount; edge++) {
+            if (position[sources[edge]] < 0) continue;
+
+            if (isFirst) copyBitset(&joined[block], &transferred[sources[edge]]);
+            else if (problem->meet == DATAFLOW_MEET_INTERSECTION) intersectBitset(&joined[block], &transferred[sources[edge]]);
+            else unionBitset(&joined[block], &transferred[sources[edge]]);
+
+            isFirst = 0;
+        }
+
+        // Apply the transfer function, and revisit the dependent blocks only if the result has changed
+        copyBitset(scratch, &joined[block]);
+        subtractBitset(scratch, &problem->kill[block]);
+        unionBitset(scratch, &problem->gen[block]);
+
+        if (copyBitset(&transferred[block], scratch)) {
+            for (int edge = 0; edge < targetCount; edge++) {
+                if (position[targets[edge]] >= 0) setBit(pending, position[targets[edge]]);
+            }
+        }
+    }
+
+    free(position);
+    freeBitset(pending);
+    freeBitset(scratch);
+    free(successors);
+}
+
+void freeDataflowProblem(DataflowProblem *problem) {
+    if (!problem) return;
+
+    freeBitsetArray(problem->in);
+    freeBitsetArray(problem->out);
+    freeBitsetArray(problem->gen);
+    freeBitsetArray(problem->kill);
+    freeBitset(problem->boundary);
+    free(problem->order);
+    free(problem);
+}
+
+int analyzeDefiniteAssignment(IRProgram *program) {
+    int result = 1;
+
+    for (int index = 0; index < program->functionCount; index++) {
+        result = analyzeFunctionAssignment(program, program->functions[index]) && result;
+    }
+
+    return result;
+}
+
+int analyzeFunctionAssignment(IRProgram *program, IRFunction *function) {
+    int universe = function->localCount;
+    DataflowProblem *definite = initDataflowProblem(function, DATAFLOW_FORWARD, DATAFLOW_MEET_INTERSECTION, universe);
+    DataflowProblem *possible = initDataflowProblem(function, DATAFLOW_FORWARD, DATAFLOW_MEET_UNION, universe);
+
+    if (!definite || !possible) {
+        freeDataflowProblem(definite);
+        freeDataflowProblem(possible);
+        return 1;
+    }
+
+    // An assignment generates the local, and a declaration kills it since the local is fresh again
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            int local = block->instructions[index].destination;
+            if (local < 0 || local >= universe) continue;
+
+            if (block->instructions[index].opcode == IR_DECLARE) {
+                clearBit(&definite->gen[blockIndex], local);
+                setBit(&definite->kill[blockIndex], local);
+            }
+
+            else setBit(&definite->gen[blockIndex], local);
+        }
+
+        copyBitset(&possible->gen[blockIndex], &definite->gen[blockIndex]);
+        copyBitset(&possible->kill[blockIndex], &definite->kill[blockIndex]);
+    }
+
+    // Parameters are assigned by the caller
+    for (int local = 0; local < function->parameterCount; local++) {
+        setBit(definite->boundary, local);
+        setBit(possible->boundary, local);
+    }
+
+    solveDataflow(function, definite);
+    solveDataflow(function, possible);
+
+    // Replay each reachable block from its entry facts to find the offending instructions
+    Bitset *assigned = initBitset(universe);
+    Bitset *maybeAssigned = initBitset(universe);
+    Bitset *reported = initBitset(universe);
+    IRFunction *entry = program->functions[0];
+    int result = 1;
+
+    for (int order = 0; order < definite->orderCount && assigned && maybeAssigned && reported; order++) {
+        int blockIndex = definite->order[order];
+        BasicBlock *block = function->blocks[blockIndex];
+
+        copyBitset(assigned, &definite->in[blockIndex]);
+        copyBitset(maybeAssigned, &possible->in[blockIndex]);
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            int uses[2];
+            int useCount = getIRUses(instruction, uses);
+
+            // Reading a local that is not assigned on every path, which is reported once for each local
+            for (int use = 0; use < useCount; use++) {
+                int local = uses[use];
+                if (local >= universe || testBit(assigned, local) || testBit(reported, local)) continue;
+
+                reportDiagnostic(program->diagnostics, instruction->location,
+                                 "Symbol '%s' might be used before being initialized", function->locals[local].identifier);
+                setBit(reported, local);
+                result = 0;
+            }
+
+            // Assigning a global from another function is only allowed if it is mutable
+            if (instruction->opcode == IR_STORE_GLOBAL && !entry->locals[instruction->constant.integerValue].isMutable) {
+                reportDiagnostic(program->diagnostics, instruction->location, "Symbol '%s' is immutable",
+                                 entry->locals[instruction->constant.integerValue].identifier);
+                result = 0;
+            }
+
+            int local = instruction->destination;
+            if (local < 0 || local >= universe) continue;
+
+            if (instruction->opcode == IR_DECLARE) {
+                clearBit(assigned, local);
+                clearBit(maybeAssigned, local);
+                continue;
+            }
+
+            // Assigning an immutable local that might have been assigned on some path
+            if (!function->locals[local].isMutable && testBit(maybeAssigned, local)) {
+                reportDiagnostic(program->diagnostics, instruction->location, "Symbol '%s' is immutable",
+                                 function->locals[local].identifier);
+                result = 0;
+            }
+
+            setBit(assigned, local);
+            setBit(maybeAssigned, local);
+        }
+    }
+
+    freeBitset(assigned);
+    freeBitset(maybeAssigned);
+    freeBitset(reported);
+    freeDataflowProblem(definite);
+    freeDataflowProblem(possible);
+    return result;
+}
@@ -0,0 +1,282 @@
+// frame.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "frame.h"
+
+DataflowProblem *computeLiveness(IRFunction *function) {
+    DataflowProblem *liveness = initDataflowProblem(function, DATAFLOW_BACKWARD, DATAFLOW_MEET_UNION,
+                                                    function->registerCount);
+    if (!liveness) return NULL;
+
+    // Walk each block backward: a definition kills the register, and a use generates it again
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+
+        for (int index = block->instructionCount - 1; index >= 0; index--) {
+            IRInstruction *instruction = &block->instructions[index];
+            int uses[2];
+            int useCount = getIRUses(instruction, uses);
+
+            if (instruction->destination >= 0) {
+                clearBit(&liveness->gen[blockIndex], instruction->destination);
+                setBit(&liveness->kill[blockIndex], instruction->destination);
+            }
+
+            for (int use = 0; use < useCount; use++) setBit(&liveness->gen[blockIndex], uses[use]);
+        }
+    }
+
+    // Nothing is live after returning, so the boundary is empty
+    solveDataflow(function, liveness);
+    return liveness;
+}
+
+void computeLiveIntervals(IRFunction *function, DataflowProblem *liveness, LiveInterval *intervals) {
+    for (int reg = 0; reg < function->registerCount; reg++) {
+        intervals[reg].reg = reg;
+        intervals[reg].start = INT_MAX;
+        intervals[reg].end = INT_MIN;
+    }
+
+    // Extends the interval of a register to cover a position
+    #define extendInterval(interval, position) do {                        \
+        if ((position) < (interval).start) (interval).start = (position);   \
+        if ((position) > (interval).end) (interval).end = (position);       \
+    } while (0)
+
+    // Parameters hold the arguments from the very beginning
+    for (int local = 0; local < function->parameterCount; local++) extendInterval(intervals[local], -1);
+
+    int position = 0;
+
+    for (int order = 0; order < liveness->orderCount; order++) {
+        int blockIndex = liveness->order[order];
+        BasicBlock *block = function->blocks[blockIndex];
+        if (block->instructionCount == 0) continue;
+
+        int blockStart = position;
+        int blockEnd = position + 2 * block->instructionCount - 1;
+
+        // A register live across the boundary of the block is live from the start or until the end of the block
+        for (int reg = findNextBit(&liveness->in[blockIndex], 0); reg >= 0; reg = findNextBit(&liveness->in[blockIndex], reg + 1)) {
+            extendInterval(intervals[reg], blockStart);
+        }
+
+        for (int reg = findNextBit(&liveness->out[blockIndex], 0); reg >= 0; reg = findNextBit(&liveness->out[blockIndex], reg + 1)) {
+            extendInterval(intervals[reg], blockEnd);
+        }
+
+        // Uses are at the even position of an instruction, and the definition is at the odd position
+        for (int index = 0; index < block->instructionCount; index++, position += 2) {
+            IRInstruction *instruction = &block->instructions[index];
+            int uses[2];
+            int useCount = getIRUses(instruction, uses);
+
+            for (int use = 0; use < useCount; use++) extendInterval(intervals[uses[use]], position);
+
+            // A declaration writes no value, so the local only takes a slot once it is assigned
+            if (instruction->destination >= 0 && instruction->opcode != IR_DECLARE) {
+                extendInterval(intervals[instruction->destination], position + 1);
+            }
+        }
+    }
+
+    #undef extendInterval
+}
+
+/// Orders the intervals by their start, then by their register so that parameters come in order.
+static int compareIntervals(const void *lhs, const void *rhs) {
+    const LiveInterval *left = (const LiveInterval*) lhs;
+    const LiveInterval *right = (const LiveInterval*) rhs;
+
+    if (left->start != right->start) return left->start < right->start ? -1 : 1;
+    return left->reg - right->reg;
+}
+
+/// Inserts an interval into a min-heap of active intervals ordered by their end.
+static void pushActiveInterval(LiveInterval *heap, int *count, LiveInterval interval) {
+    int child = (*count)++;
+
+    while (child > 0 && heap[(child - 1) / 2].end > interval.end) {
+        heap[child] = heap[(child - 1) / 2];
+        child = (child - 1) / 2;
+    }
+
+    heap[child] = interval;
+}
+
+/// Removes the active interval that ends first from the min-heap.
+static LiveInterval popActiveInterval(LiveInterval *heap, int *count) {
+    LiveInterval first = heap[0];
+    LiveInterval last = heap[--(*count)];
+    int parent = 0;
+
+    while (2 * parent + 1 < *count) {
+        int child = 2 * parent + 1;
+        if (child + 1 < *count && heap[child + 1].end < heap[child].end) child++;
+        if (heap[child].end >= last.end) break;
+
+        heap[parent] = heap[child];
+        parent = child;
+    }
+
+    if (*count > 0) heap[parent] = last;
+    return first;
+}
+
+/// Finds the registers computed right before being passed to a call, which are computed right into the frame of the
+/// callee rather than copied there: a register defined once and only read as the argument i of a call takes the
+/// outgoing slot i if nothing between its definition and the call writes or reads past the frame (a call, or the lanes
+/// of a returned vector). `outgoing` receives the outgoing slot of each register, or -1.
+static void findOutgoingArguments(IRFunction *function, int *definitionCounts, int *useCounts, int *outgoing) {
+    for (int reg = 0; reg < function->registerCount; reg++) definitionCounts[reg] = useCounts[reg] = 0;
+
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            int uses[2];
+            int useCount = getIRUses(instruction, uses);
+
+            if (instruction->destination >= 0) definitionCounts[instruction->destination]++;
+            for (int use = 0; use < useCount; use++) useCounts[uses[use]]++;
+        }
+    }
+
+    for (int reg = 0; reg < function->registerCount; reg++) outgoing[reg] = -1;
+
+    // The arguments of a call come right before it, so an argument is numbered from the last call of its block
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+        int argumentIndex = 0;
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+
+            if (instruction->opcode == IR_CALL) argumentIndex = 0;
+            if (instruction->opcode != IR_ARGUMENT) continue;
+
+            int reg = instruction->operands[0];
+            int slot = argumentIndex++;
+            if (reg < function->parameterCount || definitionCounts[reg] != 1 || useCounts[reg] != 1) continue;
+
+            for (int previous = index - 1; previous >= 0; previous--) {
+                IRInstruction *definition = &block->instructions[previous];
+
+                if (definition->destination == reg) {
+                    if (definition->opcode != IR_DECLARE) outgoing[reg] = slot;
+                    break;
+                }
+
+                if (definition->opcode == IR_CALL || definition->opcode == IR_LOAD_RESULT ||
+                    definition->opcode == IR_STORE_RESULT) break;
+            }
+        }
+    }
+}
+
+int allocateFrame(IRFunction *function) {
+    DataflowProblem *liveness = computeLiveness(function);
+    int result = liveness && assignFrameSlots(function, liveness);
+
+    freeDataflowProblem(liveness);
+    return result;
+}
+
+int assignFrameSlots(IRFunction *function, DataflowProblem *liveness) {
+    int registerCount = function->registerCount;
+    LiveInterval *intervals = (LiveInterval*) malloc((registerCount + 1) * sizeof(LiveInterval));
+    LiveInterval *active = (LiveInterval*) malloc((registerCount + 1) * sizeof(LiveInterval));
+    int *slots = (int*) malloc((registerCount + 1) * sizeof(int));
+    int *definitionCounts = (int*) malloc((registerCount + 1) * sizeof(int));
+    int *useCounts = (int*) malloc((registerCount + 1) * sizeof(int));
+    int *outgoing = (int*) malloc((registerCount + 1) * sizeof(int));
+    Bitset *freeSlots = initBitset(registerCount + 1);
+
+    if (!intervals || !active || !slots || !definitionCounts || !useCounts || !outgoing || !freeSlots) {
+        free(intervals); free(active); free(slots); free(definitionCounts); free(useCounts); free(outgoing);
+        freeBitset(freeSlots);
+        return 0;
+    }
+
+    computeLiveIntervals(function, liveness, intervals);
+    findOutgoingArguments(function, definitionCounts, useCounts, outgoing);
+    for (int reg = 0; reg < registerCount; reg++) slots[reg] = -1;
+
+    // Globals are pinned to the first slots, since other functions might access them at any time
+    int frameSize = 0;
+
+    for (int local = 0; local < function->localCount; local++) {
+        if (function->locals[local].isGlobal) {
+            slots[local] = frameSize++;
+            outgoing[local] = -1;
+        }
+    }
+
+    // Only the live registers that are neither pinned nor outgoing arguments are colored
+    int intervalCount = 0;
+
+    for (int reg = 0; reg < registerCount; reg++) {
+        if (slots[reg] < 0 && outgoing[reg] < 0 && intervals[reg].start <= intervals[reg].end) {
+            intervals[intervalCount++] = intervals[reg];
+        }
+    }
+
+    qsort(intervals, intervalCount, sizeof(LiveInterval), compareIntervals);
+
+    // Release the slots of the intervals that have ended, then take the lowest free slot (or a new one)
+    int activeCount = 0;
+
+    for (int index = 0; index < intervalCount; index++) {
+        LiveInterval interval = intervals[index];
+
+        while (activeCount > 0 && active[0].end < interval.start) {
+            setBit(freeSlots, slots[popActiveInterval(active, &activeCount).reg]);
+        }
+
+        int slot = findNextBit(freeSlots, 0);
+        if (slot < 0) slot = frameSize++;
+        else clearBit(freeSlots, slot);
+
+        slots[interval.reg] = slot;
+        pushActiveInterval(active, &activeCount, interval);
+    }
+
+    // Registers that are never live (e.g. in unreachable blocks) could be written anywhere
+    for (int reg = 0; reg < registerCount; reg++) {
+        if (slots[reg] >= 0 || outgoing[reg] >= 0) continue;
+        if (frameSize == 0) frameSize = 1;
+        slots[reg] = 0;
+    }
+
+    // An outgoing argument is past the frame, where the frame of the callee starts
+    for (int reg = 0; reg < registerCount; reg++) {
+        if (outgoing[reg] >= 0) slots[reg] = frameSize + outgoing[reg];
+    }
+
+    free(function->slots);
+    function->slots = slots;
+    function->frameSize = frameSize;
+
+    free(intervals);
+    free(active);
+    free(definitionCounts);
+    free(useCounts);
+    free(outgoing);
+    freeBitset(freeSlots);
+    return 1;
+}
+
+void displayFrameReduction(IRFunction *function) {
+    int naiveSize = function->registerCount;
+    double reduction = naiveSize ? 100.0 * (naiveSize - function->frameSize) / naiveSize : 0.0;
+
+    printf("[Frame] Function '%s' needs %d slots instead of %d (%.1f%% smaller).\n",
+           function->name, function->frameSize, naiveSize, reduction);
+}
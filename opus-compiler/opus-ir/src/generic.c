@@ -0,0 +1,365 @@
+// generic.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "generic.h"
+#include "integer.h"
+
+// Converts the name of a constraint into a constraint
+static IRConstraint getIRConstraint(const char *name) {
+    if (strcmp(name, "Numeric") == 0) return IR_CONSTRAINT_NUMERIC;
+    if (strcmp(name, "Comparable") == 0) return IR_CONSTRAINT_COMPARABLE;
+    if (strcmp(name, "Equatable") == 0) return IR_CONSTRAINT_EQUATABLE;
+    return IR_CONSTRAINT_UNKNOWN;
+}
+
+// Converts a constraint into its name
+static const char *getIRConstraintName(IRConstraint constraint) {
+    switch (constraint) {
+        case IR_CONSTRAINT_NUMERIC: return "Numeric";
+        case IR_CONSTRAINT_COMPARABLE: return "Comparable";
+        case IR_CONSTRAINT_EQUATABLE: return "Equatable";
+        default: return "Any";
+    }
+}
+
+// Checks if a type argument satisfies a constraint, where a type only known at runtime never does
+static int satisfiesIRConstraint(IRType type, IRConstraint constraint) {
+    switch (constraint) {
+        case IR_CONSTRAINT_NUMERIC: return getIRIntegerWidth(type) > 0 || type == IR_TYPE_FLOAT;
+        case IR_CONSTRAINT_COMPARABLE: {
+            return getIRIntegerWidth(type) > 0 || type == IR_TYPE_FLOAT || type == IR_TYPE_STRING;
+        }
+        default: return type != IR_TYPE_ANY && type != IR_TYPE_VOID;
+    }
+}
+
+// Finds a type parameter of a generic function by its name
+static int findIRTypeParameter(IRGeneric *generic, const char *name) {
+    for (int index = 0; index < generic->parameterCount; index++) {
+        if (strcmp(generic->parameters[index], name) == 0) return index;
+    }
+
+    return -1;
+}
+
+// Hashes a generic function together with its type arguments (FNV-1a)
+static unsigned int hashIRSpecialization(int generic, const IRType *arguments, int argumentCount) {
+    unsigned int hash = 2166136261u;
+    hash = (hash ^ (unsigned int) generic) * 16777619u;
+
+    for (int index = 0; index < argumentCount; index++) hash = (hash ^ (unsigned int) arguments[index]) * 16777619u;
+    return hash;
+}
+
+// Substitutes the type arguments of a specialization for the type parameters in a type name
+static IRType substituteIRType(IRGeneric *generic, const IRType *arguments, const char *typeName) {
+    int parameter = findIRTypeParameter(generic, typeName);
+    return parameter >= 0 ? arguments[parameter] : getIRType(typeName);
+}
+
+// Declares the function of a new specialization, whose name lists its type arguments (e.g. 'max<Int>')
+static int declareIRSpecialization(IRBuilder *builder, int genericIndex, const IRType *arguments) {
+    IRGenericTable *table = builder->generics;
+    IRGeneric *generic = &table->generics[genericIndex];
+    ASTNode *definition = generic->implementation->left;
+    ASTNode *signature = definition->right;
+
+    char name[LEXEME_LENGTH];
+    size_t length = (size_t) snprintf(name, sizeof(name), "%s<", generic->name);
+
+    for (int index = 0; index < generic->parameterCount && length < sizeof(name); index++) {
+        length += (size_t) snprintf(name + length, sizeof(name) - length, "%s%s", index ? ", " : "",
+                                    getIRTypeName(arguments[index]));
+    }
+
+    if (length < sizeof(name)) snprintf(name + length, sizeof(name) - length, ">");
+
+    IRType returnType = substituteIRType(generic, arguments, signature->right->token->lexeme);
+    IRFunction *function = initIRFunction(name, returnType, definition->token->location);
+    if (!function) return -1;
+
+    for (ASTNode *parameters = signature->left; parameters && parameters->left; parameters = parameters->right) {
+        ASTNode *parameter = parameters->left;
+        IRType type = substituteIRType(generic, arguments, parameter->right->token->lexeme);
+        int local = addIRLocal(function, parameter->left->token->lexeme, type, parameter->left->token->location);
+        function->locals[local].isParameter = 1;
+        function->parameterCount++;
+    }
+
+    return addIRFunction(builder->program, function);
+}
+
+IRGenericTable *initIRGenericTable() {
+    IRGenericTable *table = (IRGenericTable*) calloc(1, sizeof(IRGenericTable));
+    if (!table) return NULL;
+
+    for (int bucket = 0; bucket < IR_SPECIALIZATION_BUCKETS; bucket++) table->buckets[bucket] = -1;
+    return table;
+}
+
+int isIRGenericDefinition(ASTNode *definition) {
+    return definition && definition->left && definition->left->left &&
+           definition->left->left->nodeType == AST_GENERIC_PARAMETER_LIST;
+}
+
+int declareIRGeneric(IRBuilder *builder, ASTNode *implementation) {
+    IRGenericTable *table = builder->generics;
+    DiagnosticList *diagnostics = builder->program->diagnostics;
+    ASTNode *definition = implementation->left;
+
+    if (table->genericCount == table->genericCapacity) {
+        int capacity = table->genericCapacity ? table->genericCapacity * 2 : 8;
+        IRGeneric *generics = (IRGeneric*) realloc(table->generics, capacity * sizeof(IRGeneric));
+        if (!generics) return -1;
+
+        table->generics = generics;
+        table->genericCapacity = capacity;
+    }
+
+    IRGeneric *generic = &table->generics[table->genericCount];
+    strcpy(generic->name, definition->left->token->lexeme);
+    generic->implementation = implementation;
+    generic->parameterCount = 0;
+    generic->bindingCount = 0;
+    generic->isValid = 1;
+
+    for (ASTNode *list = definition->left->left; list && list->left; list = list->right) {
+        ASTNode *parameter = list->left;
+        const char *constraint = parameter->left ? parameter->left->token->lexeme : NULL;
+
+        if (generic->parameterCount == IR_MAX_TYPE_PARAMETERS) {
+            reportDiagnostic(diagnostics, parameter->token->location, "Function '%s' has more than %d type parameters",
+                             generic->name, IR_MAX_TYPE_PARAMETERS);
+            builder->program->errorCount++;
+            generic->isValid = 0;
+            break;
+        }
+
+        if (findIRTypeParameter(generic, parameter->token->lexeme) >= 0) {
+            reportDiagnostic(diagnostics, parameter->token->location, "Type parameter '%s' of function '%s' is declared "
+                             "twice", parameter->token->lexeme, generic->name);
+            builder->program->errorCount++;
+            generic->isValid = 0;
+        }
+
+        IRConstraint kind = constraint ? getIRConstraint(constraint) : IR_CONSTRAINT_NONE;
+
+        if (kind == IR_CONSTRAINT_UNKNOWN) {
+            reportDiagnostic(diagnostics, parameter->left->token->location, "Unknown constraint '%s' of type parameter "
+                             "'%s', which must be Numeric, Comparable or Equatable", constraint, parameter->token->lexeme);
+            builder->program->errorCount++;
+            generic->isValid = 0;
+        }
+
+        strcpy(generic->parameters[generic->parameterCount], parameter->token->lexeme);
+        generic->constraints[generic->parameterCount++] = kind;
+    }
+
+    // Type arguments are only inferred from the arguments, so every type parameter must type some parameter
+    for (ASTNode *list = definition->left->left; list && list->left; list = list->right) {
+        int isInferred = 0;
+
+        for (ASTNode *parameters = definition->right->left; parameters && parameters->left;
+             parameters = parameters->right) {
+            isInferred |= strcmp(parameters->left->right->token->lexeme, list->left->token->lexeme) == 0;
+        }
+
+        if (!isInferred) {
+            reportDiagnostic(diagnostics, list->left->token->location, "Type parameter '%s' of function '%s' is not the "
+                             "type of any parameter, so it could not be inferred", list->left->token->lexeme,
+                             generic->name);
+            builder->program->errorCount++;
+            generic->isValid = 0;
+        }
+    }
+
+    return table->genericCount++;
+}
+
+int findIRGeneric(IRGenericTable *table, const char *name) {
+    for (int index = 0; index < table->genericCount; index++) {
+        if (strcmp(table->generics[index].name, name) == 0) return index;
+    }
+
+    return -1;
+}
+
+int specializeIRGeneric(IRBuilder *builder, int genericIndex, ASTNode *node, int *arguments, int argumentCount) {
+    IRGenericTable *table = builder->generics;
+    IRGeneric *generic = &table->generics[genericIndex];
+    ASTNode *signature = generic->implementation->left->right;
+    DiagnosticList *diagnostics = builder->program->diagnostics;
+    Location location = node->left->token->location;
+
+    // An invalid generic function has been reported where it is defined
+    if (!generic->isValid) return -1;
+
+    int parameterCount = 0;
+    for (ASTNode *list = signature->left; list && list->left; list = list->right) parameterCount++;
+
+    if (argumentCount != parameterCount) {
+        reportDiagnostic(diagnostics, location, "Function '%s' takes %d argument%s but %d given", generic->name,
+                         parameterCount, parameterCount == 1 ? "" : "s", argumentCount);
+        builder->program->errorCount++;
+        return -1;
+    }
+
+    // Each type argument is the type of the first argument passed to a parameter of that type
+    IRType typeArguments[IR_MAX_TYPE_PARAMETERS];
+    int isBound[IR_MAX_TYPE_PARAMETERS] = {0};
+    int result = 1;
+
+    ASTNode *list = node->right;
+    ASTNode *parameters = signature->left;
+
+    for (int index = 0; index < argumentCount; index++, list = list->right, parameters = parameters->right) {
+        const char *label = list->left->left->token->lexeme;
+        const char *expectedLabel = parameters->left->left->token->lexeme;
+        const char *typeName = parameters->left->right->token->lexeme;
+        IRType type = builder->function->registerTypes[arguments[index]];
+        int parameter = findIRTypeParameter(generic, typeName);
+
+        if (strcmp(label, expectedLabel) != 0) {
+            reportDiagnostic(diagnostics, location, "Expecting label '%s' rather than '%s' for function '%s'",
+                             expectedLabel, label, generic->name);
+            builder->program->errorCount++;
+            result = 0;
+        }
+
+        else if (parameter >= 0 && type == IR_TYPE_ANY) {
+            reportDiagnostic(diagnostics, location, "Type parameter '%s' of function '%s' could not be inferred from "
+                             "argument '%s', whose type is only known at runtime", typeName, generic->name, label);
+            builder->program->errorCount++;
+            result = 0;
+        }
+
+        else if (parameter >= 0 && !isBound[parameter]) {
+            typeArguments[parameter] = type;
+            isBound[parameter] = 1;
+        }
+
+        // Otherwise the argument must have the type of its parameter, or the type inferred by an earlier argument
+        else {
+            IRType expected = parameter >= 0 ? typeArguments[parameter] : getIRType(typeName);
+
+            if (type != expected && type != IR_TYPE_ANY && expected != IR_TYPE_ANY) {
+                reportDiagnostic(diagnostics, location, "Argument '%s' of function '%s' must be %s rather than %s",
+                                 label, generic->name, getIRTypeName(expected), getIRTypeName(type));
+                builder->program->errorCount++;
+                result = 0;
+            }
+        }
+    }
+
+    if (!result) return -1;
+
+    for (int index = 0; index < generic->parameterCount; index++) {
+        if (satisfiesIRConstraint(typeArguments[index], generic->constraints[index])) continue;
+
+        reportDiagnostic(diagnostics, location, "Type %s does not conform to '%s' required by type parameter '%s' of "
+                         "function '%s'", getIRTypeName(typeArguments[index]),
+                         getIRConstraintName(generic->constraints[index]), generic->parameters[index], generic->name);
+        builder->program->errorCount++;
+        result = 0;
+    }
+
+    if (!result) return -1;
+
+    // A specialization for the same type arguments is shared by every call
+    unsigned int bucket = hashIRSpecialization(genericIndex, typeArguments, generic->parameterCount)
+                        % IR_SPECIALIZATION_BUCKETS;
+
+    for (int index = table->buckets[bucket]; index >= 0; index = table->specializations[index].next) {
+        IRSpecialization *specialization = &table->specializations[index];
+        if (specialization->generic != genericIndex) continue;
+        if (memcmp(specialization->arguments, typeArguments, generic->parameterCount * sizeof(IRType)) != 0) continue;
+
+        specialization->callCount++;
+        return specialization->function;
+    }
+
+    if (table->specializationCount == table->specializationCapacity) {
+        int capacity = table->specializationCapacity ? table->specializationCapacity * 2 : 8;
+        IRSpecialization *specializations = (IRSpecialization*) realloc(table->specializations,
+                                                                        capacity * sizeof(IRSpecialization));
+        if (!specializations) return -1;
+
+        table->specializations = specializations;
+        table->specializationCapacity = capacity;
+    }
+
+    int function = declareIRSpecialization(builder, genericIndex, typeArguments);
+    if (function < 0) return -1;
+
+    // The body is lowered later, since the call might come before the generic function is implemented
+    IRSpecialization *specialization = &table->specializations[table->specializationCount];
+    specialization->generic = genericIndex;
+    memcpy(specialization->arguments, typeArguments, generic->parameterCount * sizeof(IRType));
+    specialization->function = function;
+    specialization->isLowered = 0;
+    specialization->callCount = 1;
+    specialization->next = table->buckets[bucket];
+    table->buckets[bucket] = table->specializationCount++;
+
+    return function;
+}
+
+void lowerIRSpecializations(IRBuilder *builder) {
+    IRGenericTable *table = builder->generics;
+    int specialization = builder->specialization;
+    int globalBinding = builder->globalBinding;
+
+    // Lowering a specialization might request new ones, which are appended and lowered by the same loop
+    for (int index = 0; index < table->specializationCount; index++) {
+        if (table->specializations[index].isLowered) continue;
+        table->specializations[index].isLowered = 1;
+
+        IRGeneric *generic = &table->generics[table->specializations[index].generic];
+        IRFunction *function = builder->program->functions[table->specializations[index].function];
+
+        // The errors of a body are reported once, rather than once by every specialization of the generic function
+        if (!generic->isValid) {
+            emitIRInstruction(function, 0, IR_RETURN, IR_TYPE_VOID, function->location)->operands[0] = IR_NO_REGISTER;
+            continue;
+        }
+
+        int errorCount = builder->program->errorCount;
+        builder->specialization = index;
+        builder->globalBinding = generic->bindingCount;
+        lowerFunctionBody(builder, table->specializations[index].function, generic->implementation->right);
+
+        if (builder->program->errorCount > errorCount) generic->isValid = 0;
+    }
+
+    builder->specialization = specialization;
+    builder->globalBinding = globalBinding;
+}
+
+IRType resolveIRType(IRBuilder *builder, const char *typeName) {
+    if (builder->specialization < 0) return getIRType(typeName);
+
+    IRSpecialization *specialization = &builder->generics->specializations[builder->specialization];
+    return substituteIRType(&builder->generics->generics[specialization->generic], specialization->arguments, typeName);
+}
+
+void displayIRSpecializations(IRGenericTable *table, IRProgram *program) {
+    for (int index = 0; index < table->specializationCount; index++) {
+        IRSpecialization *specialization = &table->specializations[index];
+        printf("[Generic] Specialization '%s' is shared by %d call%s.\n",
+               program->functions[specialization->function]->name, specialization->callCount,
+               specialization->callCount == 1 ? "" : "s");
+    }
+}
+
+void freeIRGenericTable(IRGenericTable *table) {
+    if (!table) return;
+
+    free(table->generics);
+    free(table->specializations);
+    free(table);
+}
@@ -0,0 +1,224 @@
+// integer.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "integer.h"
+
+// Gets the smallest and the largest values of an integer type
+static void getIRIntegerRange(IRType type, long long *low, long long *high) {
+    int width = getIRIntegerWidth(type);
+    *low = isIRUnsignedType(type) ? 0 : -(1LL << (width - 1));
+    *high = isIRUnsignedType(type) ? (1LL << width) - 1 : (1LL << (width - 1)) - 1;
+}
+
+// Reads the value of an integer literal, which might be negated or computed from other literals (e.g. "-(2 * 64)"),
+// or returns 0 (False) if the node is not such a literal or its value overflows an Int
+static int readIRIntegerLiteral(ASTNode *node, long long *value) {
+    if (!node || !node->token) return 0;
+    TokenType operator = node->token->tokenType;
+
+    if (node->nodeType == AST_LITERAL) {
+        if (operator != TOKEN_NUMERIC || strchr(node->token->lexeme, '.')) return 0;
+        *value = atoll(node->token->lexeme);
+    }
+
+    else if (node->nodeType == AST_UNARY_EXPRESSION && operator == TOKEN_ARITHMETIC_SUBTRACTION) {
+        if (!readIRIntegerLiteral(node->left, value)) return 0;
+        *value = -*value;
+    }
+
+    else if (node->nodeType == AST_BINARY_EXPRESSION && (operator == TOKEN_ARITHMETIC_ADDITION ||
+             operator == TOKEN_ARITHMETIC_SUBTRACTION || operator == TOKEN_ARITHMETIC_MULTIPLICATION)) {
+        long long rhs;
+        if (!readIRIntegerLiteral(node->left, value) || !readIRIntegerLiteral(node->right, &rhs)) return 0;
+
+        if (operator == TOKEN_ARITHMETIC_ADDITION) *value += rhs;
+        else if (operator == TOKEN_ARITHMETIC_SUBTRACTION) *value -= rhs;
+        else *value *= rhs;
+    }
+
+    else return 0;
+
+    return *value >= INT_MIN && *value <= INT_MAX;
+}
+
+int getIRIntegerWidth(IRType type) {
+    switch (type) {
+        case IR_TYPE_INT8: case IR_TYPE_UINT8: return 8;
+        case IR_TYPE_INT16: case IR_TYPE_UINT16: return 16;
+        case IR_TYPE_INT: case IR_TYPE_UINT32: return 32;
+        default: return 0;
+    }
+}
+
+int isIRUnsignedType(IRType type) {
+    return type == IR_TYPE_UINT8 || type == IR_TYPE_UINT16 || type == IR_TYPE_UINT32;
+}
+
+int isIRIntegerWidened(IRType from, IRType to) {
+    if (from == to) return 1;
+    if (!getIRIntegerWidth(from) || getIRIntegerWidth(from) >= getIRIntegerWidth(to)) return 0;
+
+    // A wider unsigned type holds no negative value, while a wider signed type holds every unsigned value
+    return isIRUnsignedType(from) || !isIRUnsignedType(to);
+}
+
+int isIRIntegerInRange(IRType type, long long value) {
+    if (!getIRIntegerWidth(type)) return 0;
+
+    long long low, high;
+    getIRIntegerRange(type, &low, &high);
+    return value >= low && value <= high;
+}
+
+int isIRUnsigned(IRFunction *function, IRInstruction *instruction) {
+    for (int operand = 0; operand < 2; operand++) {
+        int reg = instruction->operands[operand];
+        if (reg >= 0 && function->registerTypes[reg] == IR_TYPE_UINT32) return 1;
+    }
+
+    return 0;
+}
+
+IRType joinIRIntegerTypes(ASTNode *lhs, IRType lhsType, ASTNode *rhs, IRType rhsType) {
+    if (!getIRIntegerWidth(lhsType) || !getIRIntegerWidth(rhsType)) return IR_TYPE_ANY;
+    if (lhsType == rhsType) return lhsType;
+
+    // An integer literal is an Int, unless the other operand is a type holding its value
+    long long value;
+    if (lhsType == IR_TYPE_INT && readIRIntegerLiteral(lhs, &value) && isIRIntegerInRange(rhsType, value)) {
+        return rhsType;
+    }
+
+    if (rhsType == IR_TYPE_INT && readIRIntegerLiteral(rhs, &value) && isIRIntegerInRange(lhsType, value)) {
+        return lhsType;
+    }
+
+    if (isIRIntegerWidened(lhsType, rhsType)) return rhsType;
+    if (isIRIntegerWidened(rhsType, lhsType)) return lhsType;
+    return IR_TYPE_ANY;
+}
+
+int wrapIRInteger(IRBuilder *builder, int value, IRType type, Location location) {
+    IRFunction *function = builder->function;
+    int width = getIRIntegerWidth(type);
+    int destination = addIRRegister(function, type);
+
+    // An unsigned type keeps its low bits
+    if (isIRUnsignedType(type)) {
+        IRInstruction *mask = emitIRInstruction(function, builder->currentBlock, IR_BITWISE_AND, type, location);
+        mask->destination = destination;
+        mask->operands[0] = value;
+        mask->constant.integerValue = (1 << width) - 1;
+        return destination;
+    }
+
+    // A signed type extends the sign of its highest bit, by shifting it up to the sign bit of an Int and back down
+    int shifted = addIRRegister(function, IR_TYPE_INT);
+    IRInstruction *left = emitIRInstruction(function, builder->currentBlock, IR_SHIFT_LEFT, IR_TYPE_INT, location);
+    left->destination = shifted;
+    left->operands[0] = value;
+    left->constant.integerValue = 32 - width;
+
+    IRInstruction *right = emitIRInstruction(function, builder->currentBlock, IR_SHIFT_RIGHT, type, location);
+    right->destination = destination;
+    right->operands[0] = shifted;
+    right->constant.integerValue = 32 - width;
+    return destination;
+}
+
+int lowerIntegerConversion(IRBuilder *builder, ASTNode *node, IRType type) {
+    IRProgram *program = builder->program;
+    IRFunction *function = builder->function;
+    Location location = node->left->token->location;
+
+    ASTNode *list = node->right;
+    ASTNode *argument = list && list->left ? list->left : NULL;
+    const char *label = argument ? argument->left->token->lexeme : "";
+    int isClamping = (strcmp(label, "clamping") == 0);
+    int isSingle = argument && (!list->right || !list->right->left);
+
+    if (!isSingle || (!isClamping && strcmp(label, "truncating") != 0)) {
+        reportDiagnostic(program->diagnostics, location, "Conversion into %s takes a single integer labeled "
+                         "'truncating' or 'clamping'", getIRTypeName(type));
+        program->errorCount++;
+        return IR_NO_REGISTER;
+    }
+
+    int value = lowerExpression(builder, argument->right);
+    if (value == IR_NO_REGISTER) return IR_NO_REGISTER;
+
+    IRType valueType = function->registerTypes[value];
+
+    if (!getIRIntegerWidth(valueType)) {
+        reportDiagnostic(program->diagnostics, location, "Conversion into %s takes an integer rather than a value of "
+                         "type %s", getIRTypeName(type), getIRTypeName(valueType));
+        program->errorCount++;
+        return IR_NO_REGISTER;
+    }
+
+    // A value the type holds is kept as it is, and so are the bits of a value truncated into 32 bits (e.g. a UInt32
+    // above Int.max truncated into a negative Int)
+    if (isIRIntegerWidened(valueType, type) || (!isClamping && getIRIntegerWidth(type) == 32)) {
+        int destination = addIRRegister(function, type);
+        IRInstruction *copy = emitIRInstruction(function, builder->currentBlock, IR_COPY, type, location);
+        copy->destination = destination;
+        copy->operands[0] = value;
+        return destination;
+    }
+
+    if (!isClamping) return wrapIRInteger(builder, value, type, location);
+
+    // A value out of the range of the type is replaced by the bound it is beyond, where only the bounds that the
+    // type of the value goes beyond are tested
+    long long bounds[2], valueBounds[2];
+    getIRIntegerRange(type, &bounds[0], &bounds[1]);
+    getIRIntegerRange(valueType, &valueBounds[0], &valueBounds[1]);
+
+    int destination = addIRRegister(function, type);
+    int joinBlock = addIRBlock(function);
+
+    for (int bound = 0; bound < 2; bound++) {
+        if (bound == 0 ? valueBounds[0] >= bounds[0] : valueBounds[1] <= bounds[1]) continue;
+
+        int limit = addIRRegister(function, IR_TYPE_INT);
+        IRInstruction *constant = emitIRInstruction(function, builder->currentBlock, IR_CONSTANT, IR_TYPE_INT,
+                                                    location);
+        constant->destination = limit;
+        constant->constant.integerValue = (int) bounds[bound];
+
+        int condition = addIRRegister(function, IR_TYPE_BOOL);
+        IRInstruction *compare = emitIRInstruction(function, builder->currentBlock,
+                                                   bound == 0 ? IR_LESS_THAN : IR_GREATER_THAN, IR_TYPE_BOOL, location);
+        compare->destination = condition;
+        compare->operands[0] = value;
+        compare->operands[1] = limit;
+
+        int boundBlock = addIRBlock(function);
+        int otherwise = addIRBlock(function);
+        IRInstruction *branch = emitIRInstruction(function, builder->currentBlock, IR_BRANCH, IR_TYPE_VOID, location);
+        branch->operands[0] = condition;
+        branch->targets[0] = boundBlock;
+        branch->targets[1] = otherwise;
+
+        IRInstruction *saturated = emitIRInstruction(function, boundBlock, IR_CONSTANT, type, location);
+        saturated->destination = destination;
+        saturated->constant.integerValue = (int) bounds[bound];
+        emitIRInstruction(function, boundBlock, IR_JUMP, IR_TYPE_VOID, location)->targets[0] = joinBlock;
+
+        builder->currentBlock = otherwise;
+    }
+
+    IRInstruction *copy = emitIRInstruction(function, builder->currentBlock, IR_COPY, type, location);
+    copy->destination = destination;
+    copy->operands[0] = value;
+    emitIRInstruction(function, builder->currentBlock, IR_JUMP, IR_TYPE_VOID, location)->targets[0] = joinBlock;
+
+    builder->currentBlock = joinBlock;
+    return destination;
+}
@@ -0,0 +1,1409 @@
+// ir.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "ir.h"
+#include "generic.h"
+#include "switch.h"
+#include "integer.h"
+#include "vector.h"
+
+IRProgram *lowerProgram(ASTNode *root, int isFoldingEnabled) {
+    IRProgram *program = initIRProgram();
+    if (program) lowerIntoIRProgram(program, root, isFoldingEnabled);
+    return program;
+}
+
+void lowerIntoIRProgram(IRProgram *program, ASTNode *root, int isFoldingEnabled) {
+    // The top-level statements are executed by the entry function
+    Location location = {1, 1};
+    IRFunction *entry = initIRFunction(IR_ENTRY_FUNCTION, IR_TYPE_VOID, location);
+    if (!entry) return;
+    addIRFunction(program, entry);
+
+    IRGenericTable *generics = initIRGenericTable();
+    IRBuilder builder = {program, entry, 0, NULL, 0, 0, 0, 0, 1, isFoldingEnabled, generics, -1, INT_MAX};
+
+    // Declare the top-level functions ahead, so that they could be called before being implemented, where a generic
+    // function only declares its specializations once they are called
+    for (ASTNode *statement = root; statement; statement = statement->right) {
+        if (!statement->left || statement->left->nodeType != AST_FUNCTION_IMPLEMENTATION) continue;
+
+        if (!isIRGenericDefinition(statement->left->left)) lowerFunctionDefinition(&builder, statement->left->left);
+        else if (generics) declareIRGeneric(&builder, statement->left);
+    }
+
+    // Lower each top-level statement in order, then return from the entry function
+    for (ASTNode *statement = root; statement; statement = statement->right) {
+        if (statement->left) lowerStatement(&builder, statement->left);
+    }
+
+    IRInstruction *instruction = emitIRInstruction(entry, builder.currentBlock, IR_RETURN, IR_TYPE_VOID, location);
+    instruction->operands[0] = IR_NO_REGISTER;
+
+    // The specializations called anywhere in the program are lowered once every global has been bound
+    if (generics) {
+        lowerIRSpecializations(&builder);
+        displayIRSpecializations(generics, program);
+        freeIRGenericTable(generics);
+    }
+
+    orderIRRegisters(entry);
+    for (int index = 0; index < program->functionCount; index++) computeIRPredecessors(program->functions[index]);
+
+    free(builder.bindings);
+}
+
+void lowerStatement(IRBuilder *builder, ASTNode *node) {
+    switch (node->nodeType) {
+        case AST_VARIABLE_DECLARATION: case AST_CONSTANT_DECLARATION: lowerDeclaration(builder, node); break;
+        case AST_ASSIGNMENT_STATEMENT: lowerAssignmentStatement(builder, node); break;
+        case AST_CONDITIONAL_STATEMENT: lowerConditionalStatement(builder, node); break;
+        case AST_REPEAT_UNTIL_STATEMENT: lowerRepeatUntilStatement(builder, node); break;
+        case AST_SWITCH_STATEMENT: lowerSwitchStatement(builder, node); break;
+        case AST_FOR_IN_STATEMENT: lowerForInStatement(builder, node); break;
+        case AST_RETURN_STATEMENT: lowerReturnStatement(builder, node); break;
+        case AST_FUNCTION_IMPLEMENTATION: {
+            if (!isIRGenericDefinition(node->left)) {
+                lowerFunctionImplementation(builder, node);
+                break;
+            }
+
+            // A generic function sees the globals declared so far, which are kept until the end of the program
+            int generic = builder->generics ? findIRGeneric(builder->generics, node->left->left->token->lexeme) : -1;
+            int isTopLevel = (builder->function == builder->program->functions[0] && builder->depth == 0);
+
+            if (isTopLevel && generic >= 0) builder->generics->generics[generic].bindingCount = builder->bindingCount;
+            else if (!isTopLevel) {
+                reportDiagnostic(builder->program->diagnostics, node->left->left->token->location,
+                                 "Generic function '%s' must be implemented at the top level",
+                                 node->left->left->token->lexeme);
+                builder->program->errorCount++;
+            }
+
+            break;
+        }
+
+        // A function definition without a body is an external function, imports have been declared as externals,
+        // and erroneous statements are skipped
+        case AST_FUNCTION_DEFINITION: case AST_IMPORT_DECLARATION: case AST_ERROR: break;
+
+        // Otherwise it is an expression statement, where the value is discarded
+        default: lowerExpression(builder, node); break;
+    }
+}
+
+int lowerDeclaration(IRBuilder *builder, ASTNode *node) {
+    IRFunction *function = builder->function;
+    const char *identifier = node->left->token->lexeme;
+
+    int local = addIRLocal(function, identifier, resolveIRType(builder, node->right->token->lexeme),
+                           node->token->location);
+    function->locals[local].isMutable = (node->nodeType == AST_VARIABLE_DECLARATION);
+    function->locals[local].isGlobal = (builder->function == builder->program->functions[0] && builder->depth == 0);
+    bindIRLocal(builder, local);
+
+    // Every execution of a declaration creates a fresh (uninitialized) local, which matters inside loops
+    IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_DECLARE,
+                                                   function->locals[local].type, node->left->token->location);
+    instruction->destination = function->locals[local].registerIndex;
+
+    return function->locals[local].registerIndex;
+}
+
+int lowerAssignmentStatement(IRBuilder *builder, ASTNode *node) {
+    // Declare the local first if the declaration comes together with the assignment
+    if (node->left->nodeType == AST_VARIABLE_DECLARATION || node->left->nodeType == AST_CONSTANT_DECLARATION) {
+        lowerDeclaration(builder, node->left);
+    }
+
+    // A local declared here is already the innermost binding, so reading it on the right-hand side (e.g. in
+    // "var x: Int = x + 1") reads the uninitialized local, which is reported by the definite assignment analysis
+    Token *token = node->left->nodeType == AST_IDENTIFIER ? node->left->token : node->left->left->token;
+    IRBinding *binding = lookupIRBinding(builder, token->lexeme);
+
+    if (!binding) {
+        reportDiagnostic(builder->program->diagnostics, token->location, "Undeclared symbol '%s'", token->lexeme);
+        builder->program->errorCount++;
+        return IR_NO_REGISTER;
+    }
+
+    // Copy the binding since lowering the right-hand side might grow the binding array
+    IRBinding target = *binding;
+
+    int value = lowerExpression(builder, node->right);
+    if (value == IR_NO_REGISTER) return IR_NO_REGISTER;
+
+    IRFunction *function = builder->function;
+    IRFunction *entry = builder->program->functions[0];
+
+    // The analyzer accepts any value only known at runtime (e.g. returned by a call), whose type is checked here, as
+    // is a vector in the body of a function, which is not analyzed
+    IRType targetType = target.isGlobal ? entry->locals[target.local].type : function->locals[target.local].type;
+    IRType valueType = function->registerTypes[value];
+    int isChecked = node->right->nodeType == AST_FUNCTION_CALL || isIRVectorType(targetType) ||
+                    isIRVectorType(valueType);
+
+    if (targetType != valueType && targetType != IR_TYPE_ANY && valueType != IR_TYPE_ANY &&
+        !isIRIntegerWidened(valueType, targetType) && isChecked) {
+        reportDiagnostic(builder->program->diagnostics, token->location, "Symbol '%s' of type %s could not be "
+                         "assigned a value of type %s", token->lexeme, getIRTypeName(targetType),
+                         getIRTypeName(valueType));
+        builder->program->errorCount++;
+        return IR_NO_REGISTER;
+    }
+
+    // Globals are stored through the entry function when assigned from another function
+    if (target.isGlobal && function != entry) {
+        IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_STORE_GLOBAL,
+                                                       entry->locals[target.local].type, token->location);
+        instruction->operands[0] = value;
+        instruction->constant.integerValue = target.local;
+    }
+
+    else {
+        IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_COPY,
+                                                       function->locals[target.local].type, token->location);
+        instruction->destination = function->locals[target.local].registerIndex;
+        instruction->operands[0] = value;
+    }
+
+    return value;
+}
+
+void lowerCodeBlock(IRBuilder *builder, ASTNode *node) {
+    int bindingCount = builder->bindingCount;
+    builder->depth++;
+
+    // Each code block node holds a statement on its left and the rest of the block on its right
+    for (ASTNode *statement = node; statement; statement = statement->right) {
+        if (statement->left) lowerStatement(builder, statement->left);
+    }
+
+    // Locals declared inside the block are no longer visible
+    builder->bindingCount = bindingCount;
+    builder->depth--;
+}
+
+void lowerConditionalStatement(IRBuilder *builder, ASTNode *node) {
+    ASTNode *condition = node->left;
+    ASTNode *ifBody = node->right->left;
+    ASTNode *elseBody = node->right->right;
+
+    // If the analyzer has folded the condition, only the branch that will be executed is lowered
+    if (condition->isFoldable && strcmp(condition->inferredType, "Bool") == 0) {
+        if (condition->nodeValue.booleanValue) lowerCodeBlock(builder, ifBody);
+        else if (elseBody && elseBody->nodeType == AST_CONDITIONAL_STATEMENT) lowerConditionalStatement(builder, elseBody);
+        else if (elseBody) lowerCodeBlock(builder, elseBody);
+        return;
+    }
+
+    IRFunction *function = builder->function;
+    int ifBlock = addIRBlock(function);
+    int elseBlock = elseBody ? addIRBlock(function) : IR_NO_BLOCK;
+    int joinBlock = addIRBlock(function);
+
+    // Jump to the if-block when the condition holds, otherwise to the else-block (or directly to the join block)
+    lowerCondition(builder, condition, ifBlock, elseBody ? elseBlock : joinBlock);
+
+    builder->currentBlock = ifBlock;
+    lowerCodeBlock(builder, ifBody);
+
+    if (!isIRBlockTerminated(function->blocks[builder->currentBlock])) {
+        emitIRInstruction(function, builder->currentBlock, IR_JUMP, IR_TYPE_VOID, node->token->location)->targets[0] = joinBlock;
+    }
+
+    // An else-if is a conditional statement nested in the else-block
+    if (elseBody) {
+        builder->currentBlock = elseBlock;
+
+        if (elseBody->nodeType == AST_CONDITIONAL_STATEMENT) lowerConditionalStatement(builder, elseBody);
+        else lowerCodeBlock(builder, elseBody);
+
+        if (!isIRBlockTerminated(function->blocks[builder->currentBlock])) {
+            emitIRInstruction(function, builder->currentBlock, IR_JUMP, IR_TYPE_VOID, node->token->location)->targets[0] = joinBlock;
+        }
+    }
+
+    builder->currentBlock = joinBlock;
+}
+
+void lowerRepeatUntilStatement(IRBuilder *builder, ASTNode *node) {
+    IRFunction *function = builder->function;
+    int bodyBlock = addIRBlock(function);
+    int exitBlock = addIRBlock(function);
+
+    emitIRInstruction(function, builder->currentBlock, IR_JUMP, IR_TYPE_VOID, node->token->location)->targets[0] = bodyBlock;
+
+    // The body is executed before checking the condition, and the loop exits once the condition holds
+    builder->currentBlock = bodyBlock;
+    lowerCodeBlock(builder, node->right);
+
+    lowerCondition(builder, node->left, exitBlock, bodyBlock);
+    builder->currentBlock = exitBlock;
+}
+
+void lowerForInStatement(IRBuilder *builder, ASTNode *node) {
+    IRFunction *function = builder->function;
+    ASTNode *element = node->left->left;
+    Location location = node->token->location;
+
+    int sequence = lowerExpression(builder, node->left->right);
+    if (sequence == IR_NO_REGISTER) return;
+
+    int headerBlock = addIRBlock(function);
+    int bodyBlock = addIRBlock(function);
+    int exitBlock = addIRBlock(function);
+
+    emitIRInstruction(function, builder->currentBlock, IR_JUMP, IR_TYPE_VOID, location)->targets[0] = headerBlock;
+
+    // Sequences are iterated through the iterator protocol of the runtime, so the body runs zero or more times
+    builder->currentBlock = headerBlock;
+    emitIRInstruction(function, headerBlock, IR_ARGUMENT, IR_TYPE_VOID, location)->operands[0] = sequence;
+
+    int hasNext = addIRRegister(function, IR_TYPE_BOOL);
+    IRInstruction *call = emitIRInstruction(function, headerBlock, IR_CALL, IR_TYPE_BOOL, location);
+    call->destination = hasNext;
+    call->constant.stringIndex = internIRString(builder->program, IR_ITERATOR_HAS_NEXT);
+    call->argumentCount = 1;
+
+    IRInstruction *branch = emitIRInstruction(function, headerBlock, IR_BRANCH, IR_TYPE_VOID, location);
+    branch->operands[0] = hasNext;
+    branch->targets[0] = bodyBlock;
+    branch->targets[1] = exitBlock;
+
+    // The element is a fresh local of the body, assigned by the next element of the sequence
+    int bindingCount = builder->bindingCount;
+    builder->currentBlock = bodyBlock;
+    builder->depth++;
+
+    int local = addIRLocal(function, element->token->lexeme, IR_TYPE_ANY, element->token->location);
+    function->locals[local].isMutable = 1;
+    bindIRLocal(builder, local);
+
+    int elementRegister = function->locals[local].registerIndex;
+    emitIRInstruction(function, bodyBlock, IR_DECLARE, IR_TYPE_ANY, element->token->location)->destination = elementRegister;
+    emitIRInstruction(function, bodyBlock, IR_ARGUMENT, IR_TYPE_VOID, location)->operands[0] = sequence;
+
+    int next = addIRRegister(function, IR_TYPE_ANY);
+    call = emitIRInstruction(function, bodyBlock, IR_CALL, IR_TYPE_ANY, location);
+    call->destination = next;
+    call->constant.stringIndex = internIRString(builder->program, IR_ITERATOR_NEXT);
+    call->argumentCount = 1;
+
+    IRInstruction *copy = emitIRInstruction(function, bodyBlock, IR_COPY, IR_TYPE_ANY, element->token->location);
+    copy->destination = elementRegister;
+    copy->operands[0] = next;
+
+    lowerCodeBlock(builder, node->right);
+
+    if (!isIRBlockTerminated(function->blocks[builder->currentBlock])) {
+        emitIRInstruction(function, builder->currentBlock, IR_JUMP, IR_TYPE_VOID, location)->targets[0] = headerBlock;
+    }
+
+    builder->bindingCount = bindingCount;
+    builder->depth--;
+    builder->currentBlock = exitBlock;
+}
+
+void lowerReturnStatement(IRBuilder *builder, ASTNode *node) {
+    IRFunction *function = builder->function;
+    int value = node->left ? lowerExpression(builder, node->left) : IR_NO_REGISTER;
+
+    IRType type = value == IR_NO_REGISTER ? IR_TYPE_VOID : function->registerTypes[value];
+
+    // A vector is returned as it is declared, since the body of a function is not analyzed
+    if (type != function->returnType && type != IR_TYPE_ANY && type != IR_TYPE_VOID &&
+        (isIRVectorType(type) || isIRVectorType(function->returnType))) {
+        reportDiagnostic(builder->program->diagnostics, node->token->location, "Function '%s' must return %s rather "
+                         "than %s", function->name, getIRTypeName(function->returnType), getIRTypeName(type));
+        builder->program->errorCount++;
+    }
+
+    IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_RETURN, type,
+                                                   node->token->location);
+    instruction->operands[0] = value;
+
+    // Statements after a return are unreachable, but they are still lowered into a block of their own
+    builder->currentBlock = addIRBlock(function);
+}
+
+int lowerFunctionDefinition(IRBuilder *builder, ASTNode *node) {
+    ASTNode *signature = node->right;
+    IRFunction *function = initIRFunction(node->left->token->lexeme, getIRType(signature->right->token->lexeme),
+                                          node->token->location);
+    if (!function) return -1;
+
+    // Parameters are the first locals, which are assigned by the caller
+    for (ASTNode *parameters = signature->left; parameters && parameters->left; parameters = parameters->right) {
+        ASTNode *parameter = parameters->left;
+        int local = addIRLocal(function, parameter->left->token->lexeme, getIRType(parameter->right->token->lexeme),
+                               parameter->left->token->location);
+        function->locals[local].isParameter = 1;
+        function->parameterCount++;
+    }
+
+    return addIRFunction(builder->program, function);
+}
+
+void lowerFunctionImplementation(IRBuilder *builder, ASTNode *node) {
+    IRProgram *program = builder->program;
+
+    // Top-level functions have been declared ahead in the same order, while nested functions are declared now
+    int isTopLevel = (builder->function == program->functions[0] && builder->depth == 0);
+
+    // Every specialization of a generic function would implement a function of the same name
+    if (builder->specialization >= 0 && !isTopLevel) {
+        IRGenericTable *generics = builder->generics;
+        IRGeneric *generic = &generics->generics[generics->specializations[builder->specialization].generic];
+
+        reportDiagnostic(program->diagnostics, node->left->left->token->location, "Function '%s' could not be "
+                         "implemented inside the generic function '%s'", node->left->left->token->lexeme, generic->name);
+        program->errorCount++;
+        return;
+    }
+
+    int index = isTopLevel ? builder->nextFunction++ : lowerFunctionDefinition(builder, node->left);
+    if (index < 0 || index >= program->functionCount) return;
+
+    lowerFunctionBody(builder, index, node->right);
+}
+
+void lowerFunctionBody(IRBuilder *builder, int index, ASTNode *body) {
+    // Save the state of the enclosing function
+    IRBuilder enclosing = *builder;
+    IRFunction *function = builder->program->functions[index];
+
+    builder->function = function;
+    builder->currentBlock = 0;
+    builder->functionBinding = builder->bindingCount;
+    builder->depth++;
+
+    for (int local = 0; local < function->parameterCount; local++) bindIRLocal(builder, local);
+    lowerCodeBlock(builder, body);
+
+    // Return nothing if the control reaches the end of the function
+    if (!isIRBlockTerminated(function->blocks[builder->currentBlock])) {
+        IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_RETURN, IR_TYPE_VOID,
+                                                       function->location);
+        instruction->operands[0] = IR_NO_REGISTER;
+    }
+
+    orderIRRegisters(function);
+
+    // Restore the state of the enclosing function, except for the bindings which might have been reallocated
+    builder->function = enclosing.function;
+    builder->currentBlock = enclosing.currentBlock;
+    builder->bindingCount = enclosing.bindingCount;
+    builder->depth = enclosing.depth;
+    builder->functionBinding = enclosing.functionBinding;
+}
+
+int lowerExpression(IRBuilder *builder, ASTNode *node) {
+    if (!node) return IR_NO_REGISTER;
+
+    IRFunction *function = builder->function;
+    Location location = node->token ? node->token->location : function->location;
+
+    // Any expression folded by the analyzer is a constant
+    IRType foldedType = getIRType(node->inferredType);
+
+    if (builder->isFoldingEnabled && node->isFoldable && isIRVectorType(foldedType)) {
+        return lowerVectorConstant(builder, node, foldedType);
+    }
+
+    if (builder->isFoldingEnabled && node->isFoldable && foldedType != IR_TYPE_ANY) {
+        int destination = addIRRegister(function, foldedType);
+        IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_CONSTANT, foldedType, location);
+        instruction->destination = destination;
+
+        if (getIRIntegerWidth(foldedType)) instruction->constant.integerValue = node->nodeValue.integerValue;
+        else if (foldedType == IR_TYPE_FLOAT) instruction->constant.floatingValue = node->nodeValue.floatingValue;
+        else if (foldedType == IR_TYPE_BOOL) instruction->constant.booleanValue = node->nodeValue.booleanValue;
+        else instruction->constant.stringIndex = internIRString(builder->program, node->nodeValue.stringLiteral);
+
+        return destination;
+    }
+
+    switch (node->nodeType) {
+        // Literals that have not been analyzed are evaluated here
+        case AST_LITERAL: case AST_BOOLEAN_LITERAL: {
+            const char *lexeme = node->token->lexeme;
+            IRType type = node->nodeType == AST_BOOLEAN_LITERAL ? IR_TYPE_BOOL
+                        : node->token->tokenType == TOKEN_STRING_LITERAL ? IR_TYPE_STRING
+                        : strchr(lexeme, '.') ? IR_TYPE_FLOAT : IR_TYPE_INT;
+
+            int destination = addIRRegister(function, type);
+            IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_CONSTANT, type, location);
+            instruction->destination = destination;
+
+            if (type == IR_TYPE_BOOL) instruction->constant.booleanValue = (strcmp(lexeme, "true") == 0);
+            else if (type == IR_TYPE_STRING) instruction->constant.stringIndex = internIRString(builder->program, lexeme);
+            else if (type == IR_TYPE_FLOAT) instruction->constant.floatingValue = (float) atof(lexeme);
+            else instruction->constant.integerValue = atoi(lexeme);
+
+            return destination;
+        }
+
+        // Reading a local copies it into a temporary at the location of the identifier
+        case AST_IDENTIFIER: {
+            IRBinding *binding = lookupIRBinding(builder, node->token->lexeme);
+
+            // A name that is not bound might be a constant of an imported module
+            int external = binding ? -1 : findIRExternal(builder->program, node->token->lexeme, 0);
+
+            if (external >= 0) {
+                IRExternal *constant = &builder->program->externals[external];
+                int destination = addIRRegister(function, constant->type);
+                IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_CONSTANT,
+                                                               constant->type, location);
+                instruction->destination = destination;
+
+                if (constant->type == IR_TYPE_STRING) {
+                    instruction->constant.stringIndex = internIRString(builder->program, constant->stringValue);
+                } else instruction->constant = constant->value;
+
+                return destination;
+            }
+
+            if (!binding) {
+                reportDiagnostic(builder->program->diagnostics, location, "Undeclared symbol '%s'", node->token->lexeme);
+                builder->program->errorCount++;
+                return IR_NO_REGISTER;
+            }
+
+            IRFunction *entry = builder->program->functions[0];
+
+            if (binding->isGlobal && function != entry) {
+                IRType type = entry->locals[binding->local].type;
+                int destination = addIRRegister(function, type);
+                IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_LOAD_GLOBAL, type, location);
+                instruction->destination = destination;
+                instruction->constant.integerValue = binding->local;
+                return destination;
+            }
+
+            IRLocal *local = &function->locals[binding->local];
+            int destination = addIRRegister(function, local->type);
+            IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_COPY, local->type, location);
+            instruction->destination = destination;
+            instruction->operands[0] = function->locals[binding->local].registerIndex;
+            return destination;
+        }
+
+        // An assignment used as an expression evaluates to the assigned value
+        case AST_ASSIGNMENT_STATEMENT: return lowerAssignmentStatement(builder, node);
+
+        case AST_BINARY_EXPRESSION: {
+            TokenType operator = node->token->tokenType;
+
+            // The right operand of a logical operator might not be evaluated at all
+            if (operator == TOKEN_LOGICAL_AND_OPERATOR || operator == TOKEN_LOGICAL_OR_OPERATOR) {
+                return lowerLogicalExpression(builder, node);
+            }
+
+            int lhs = lowerExpression(builder, node->left);
+            int rhs = lowerExpression(builder, node->right);
+            if (lhs == IR_NO_REGISTER || rhs == IR_NO_REGISTER) return IR_NO_REGISTER;
+
+            IROpcode opcode;
+            switch (operator) {
+                case TOKEN_ARITHMETIC_ADDITION: opcode = IR_ADD; break;
+                case TOKEN_ARITHMETIC_SUBTRACTION: opcode = IR_SUBTRACT; break;
+                case TOKEN_ARITHMETIC_MULTIPLICATION: opcode = IR_MULTIPLY; break;
+                case TOKEN_ARITHMETIC_DIVISION: opcode = IR_DIVIDE; break;
+                case TOKEN_ARITHMETIC_MODULO: opcode = IR_MODULO; break;
+                case TOKEN_LOGICAL_EQUIVALENCE: opcode = IR_EQUAL; break;
+                case TOKEN_NOT_EQUAL_TO_OPERATOR: opcode = IR_NOT_EQUAL; break;
+                case TOKEN_LESS_THAN_OPERATOR: opcode = IR_LESS_THAN; break;
+                case TOKEN_LESS_OR_EQUAL_TO_OPERATOR: opcode = IR_LESS_OR_EQUAL; break;
+                case TOKEN_GREATER_THAN_OPERATOR: opcode = IR_GREATER_THAN; break;
+                default: opcode = IR_GREATER_OR_EQUAL; break;
+            }
+
+            // An operation on a vector works on every lane at once (see vector.h)
+            IRType lhsType = function->registerTypes[lhs];
+            IRType rhsType = function->registerTypes[rhs];
+
+            if (isIRVectorType(lhsType) || isIRVectorType(rhsType)) {
+                return lowerVectorBinary(builder, node, opcode, lhs, rhs);
+            }
+
+            // Mixing an integer with a Float converts the integer into a Float first
+            if ((lhsType == IR_TYPE_FLOAT) != (rhsType == IR_TYPE_FLOAT) &&
+                (getIRIntegerWidth(lhsType) || getIRIntegerWidth(rhsType))) {
+                int *operand = getIRIntegerWidth(lhsType) ? &lhs : &rhs;
+                int converted = addIRRegister(function, IR_TYPE_FLOAT);
+                IRInstruction *conversion = emitIRInstruction(function, builder->currentBlock, IR_CONVERT, IR_TYPE_FLOAT, location);
+                conversion->destination = converted;
+                conversion->operands[0] = *operand;
+                *operand = converted;
+                lhsType = rhsType = IR_TYPE_FLOAT;
+            }
+
+            // Two integers of different types are computed in the type both of them are converted into
+            IRType type = IR_TYPE_BOOL;
+            IRType joinedType = joinIRIntegerTypes(node->left, lhsType, node->right, rhsType);
+            if (opcode <= IR_MODULO) {
+                type = joinedType != IR_TYPE_ANY ? joinedType
+                     : (lhsType == rhsType && lhsType != IR_TYPE_BOOL) ? lhsType : IR_TYPE_ANY;
+            }
+
+            // A sized integer narrower than an Int is computed as an Int, then wrapped around to its width unless the
+            // result is always in its range (a remainder, or a quotient of unsigned integers)
+            int isWrapped = getIRIntegerWidth(type) > 0 && getIRIntegerWidth(type) < 32 && opcode != IR_MODULO &&
+                            !(opcode == IR_DIVIDE && isIRUnsignedType(type));
+            IRType computedType = isWrapped ? IR_TYPE_INT : type;
+
+            int destination = addIRRegister(function, computedType);
+            IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, opcode, computedType,
+                                                           location);
+            instruction->destination = destination;
+            instruction->operands[0] = lhs;
+            instruction->operands[1] = rhs;
+            return isWrapped ? wrapIRInteger(builder, destination, type, location) : destination;
+        }
+
+        case AST_UNARY_EXPRESSION: {
+            int operand = lowerExpression(builder, node->left);
+            if (operand == IR_NO_REGISTER) return IR_NO_REGISTER;
+
+            TokenType operator = node->token->tokenType;
+            IROpcode opcode = operator == TOKEN_ARITHMETIC_SUBTRACTION ? IR_NEGATE
+                            : operator == TOKEN_LOGICAL_NEGATION ? IR_NOT : IR_FACTORIAL;
+            IRType type = opcode == IR_NEGATE ? function->registerTypes[operand]
+                        : opcode == IR_NOT ? IR_TYPE_BOOL : IR_TYPE_INT;
+
+            if (isIRVectorType(function->registerTypes[operand])) {
+                return lowerVectorUnary(builder, node, opcode, operand);
+            }
+
+            // Like a condition, the operand of '!' only known at runtime is checked here (see lowerCondition())
+            IRType operandType = function->registerTypes[operand];
+
+            if (opcode == IR_NOT && operandType != IR_TYPE_BOOL && operandType != IR_TYPE_ANY) {
+                reportDiagnostic(builder->program->diagnostics, location, "Expecting a Bool rather than a value of "
+                                 "type %s", getIRTypeName(operandType));
+                builder->program->errorCount++;
+                return IR_NO_REGISTER;
+            }
+
+            // Negating a sized integer narrower than an Int wraps around like the arithmetic on it
+            int isWrapped = opcode == IR_NEGATE && getIRIntegerWidth(type) > 0 && getIRIntegerWidth(type) < 32;
+            IRType computedType = isWrapped ? IR_TYPE_INT : type;
+
+            int destination = addIRRegister(function, computedType);
+            IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, opcode, computedType,
+                                                           location);
+            instruction->destination = destination;
+            instruction->operands[0] = operand;
+            return isWrapped ? wrapIRInteger(builder, destination, type, location) : destination;
+        }
+
+        case AST_FUNCTION_CALL: {
+            // A call named by an integer type converts its argument into the type (e.g. "Int8(clamping: x)")
+            IRType conversion = getIRType(node->left->token->lexeme);
+            if (getIRIntegerWidth(conversion)) return lowerIntegerConversion(builder, node, conversion);
+
+            // A call named by a vector type builds a vector (e.g. "Vec4f(splat: 0.5)"), and a reduction of a vector
+            // gives a single value (e.g. "sum(of: v)")
+            if (isIRVectorType(conversion)) return lowerVectorConstruction(builder, node, conversion);
+
+            int reduced;
+            if (lowerVectorReduction(builder, node, &reduced)) return reduced;
+
+            // Evaluate all arguments first, so that the arguments of nested calls do not interleave
+            int arguments[LEXEME_LENGTH];
+            int argumentCount = 0;
+
+            for (ASTNode *list = node->right; list && list->left && argumentCount < LEXEME_LENGTH; list = list->right) {
+                int argument = lowerExpression(builder, list->left->right);
+                if (argument == IR_NO_REGISTER) return IR_NO_REGISTER;
+                arguments[argumentCount++] = argument;
+            }
+
+            for (int index = 0; index < argumentCount; index++) {
+                emitIRInstruction(function, builder->currentBlock, IR_ARGUMENT, IR_TYPE_VOID, location)->operands[0] = arguments[index];
+            }
+
+            // The returned type is known for the functions of the program (including the specializations of the
+            // generic functions) and the imported functions, otherwise it is an external function of the runtime
+            const char *name = node->left->token->lexeme;
+            int callee = findIRFunction(builder->program, name);
+            int generic = callee > 0 || !builder->generics ? -1 : findIRGeneric(builder->generics, name);
+
+            if (generic >= 0) {
+                callee = specializeIRGeneric(builder, generic, node, arguments, argumentCount);
+                if (callee < 0) return IR_NO_REGISTER;
+                name = builder->program->functions[callee]->name;
+            }
+
+            int external = callee > 0 ? -1 : findIRExternal(builder->program, name, 1);
+            IRType type = callee > 0 ? builder->program->functions[callee]->returnType
+                        : external >= 0 ? builder->program->externals[external].type : IR_TYPE_ANY;
+
+            if (external >= 0 && !checkIRExternalCall(builder, node, &builder->program->externals[external],
+                                                      arguments, argumentCount)) return IR_NO_REGISTER;
+            if (callee > 0 && !checkVectorArguments(builder, node, builder->program->functions[callee], arguments,
+                                                    argumentCount)) return IR_NO_REGISTER;
+            int destination = type == IR_TYPE_VOID ? IR_NO_REGISTER : addIRRegister(function, type);
+
+            IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_CALL, type, location);
+            instruction->destination = destination;
+            instruction->constant.stringIndex = internIRString(builder->program, name);
+            instruction->argumentCount = argumentCount;
+            return destination;
+        }
+
+        default: return IR_NO_REGISTER;
+    }
+}
+
+int checkIRExternalCall(IRBuilder *builder, ASTNode *node, IRExternal *external, int *arguments, int argumentCount) {
+    DiagnosticList *diagnostics = builder->program->diagnostics;
+    Location location = node->left->token->location;
+
+    if (argumentCount != external->parameterCount) {
+        reportDiagnostic(diagnostics, location, "Function '%s' of module '%s' takes %d argument%s but %d given",
+                         external->identifier, external->module, external->parameterCount,
+                         external->parameterCount == 1 ? "" : "s", argumentCount);
+        builder->program->errorCount++;
+        return 0;
+    }
+
+    int result = 1;
+    ASTNode *list = node->right;
+
+    for (int index = 0; index < argumentCount; index++, list = list->right) {
+        const char *label = list->left->left->token->lexeme;
+        IRType type = builder->function->registerTypes[arguments[index]];
+        IRType expected = external->parameterTypes[index];
+
+        if (strcmp(label, external->parameterLabels[index]) != 0) {
+            reportDiagnostic(diagnostics, location, "Expecting label '%s' rather than '%s' for function '%s'",
+                             external->parameterLabels[index], label, external->identifier);
+            result = 0;
+        }
+
+        else if (type != expected && type != IR_TYPE_ANY && expected != IR_TYPE_ANY &&
+                 !isIRIntegerWidened(type, expected)) {
+            reportDiagnostic(diagnostics, location, "Argument '%s' of function '%s' must be %s rather than %s",
+                             label, external->identifier, getIRTypeName(expected), getIRTypeName(type));
+            result = 0;
+        }
+    }
+
+    if (!result) builder->program->errorCount++;
+    return result;
+}
+
+int lowerLogicalExpression(IRBuilder *builder, ASTNode *node) {
+    IRFunction *function = builder->function;
+    Location location = node->token->location;
+
+    int trueBlock = addIRBlock(function);
+    int falseBlock = addIRBlock(function);
+    int joinBlock = addIRBlock(function);
+
+    lowerCondition(builder, node, trueBlock, falseBlock);
+
+    // Each outcome assigns the same temporary, which is read after both outcomes join
+    int destination = addIRRegister(function, IR_TYPE_BOOL);
+    int outcomes[2] = {trueBlock, falseBlock};
+
+    for (int outcome = 0; outcome < 2; outcome++) {
+        IRInstruction *instruction = emitIRInstruction(function, outcomes[outcome], IR_CONSTANT, IR_TYPE_BOOL, location);
+        instruction->destination = destination;
+        instruction->constant.booleanValue = (outcome == 0);
+        emitIRInstruction(function, outcomes[outcome], IR_JUMP, IR_TYPE_VOID, location)->targets[0] = joinBlock;
+    }
+
+    builder->currentBlock = joinBlock;
+    return destination;
+}
+
+void lowerCondition(IRBuilder *builder, ASTNode *node, int trueBlock, int falseBlock) {
+    IRFunction *function = builder->function;
+    Location location = node->token ? node->token->location : function->location;
+    TokenType operator = node->token ? node->token->tokenType : TOKEN_ERROR;
+
+    // A condition folded by the analyzer always takes the same target
+    if (node->isFoldable && strcmp(node->inferredType, "Bool") == 0) {
+        int target = node->nodeValue.booleanValue ? trueBlock : falseBlock;
+        emitIRInstruction(function, builder->currentBlock, IR_JUMP, IR_TYPE_VOID, location)->targets[0] = target;
+        return;
+    }
+
+    // For 'and', the right operand is only evaluated if the left operand holds, and conversely for 'or'
+    if (node->nodeType == AST_BINARY_EXPRESSION &&
+        (operator == TOKEN_LOGICAL_AND_OPERATOR || operator == TOKEN_LOGICAL_OR_OPERATOR)) {
+        int isAnd = (operator == TOKEN_LOGICAL_AND_OPERATOR);
+        ASTNode *lhs = node->left;
+
+        // A folded left operand either decides the result, or leaves only the right operand (e.g. "true && f()")
+        if (lhs->isFoldable && strcmp(lhs->inferredType, "Bool") == 0) {
+            if (lhs->nodeValue.booleanValue != isAnd) {
+                emitIRInstruction(function, builder->currentBlock, IR_JUMP, IR_TYPE_VOID, location)->targets[0] =
+                    isAnd ? falseBlock : trueBlock;
+                return;
+            }
+        }
+
+        else {
+            int rhsBlock = addIRBlock(function);
+            lowerCondition(builder, lhs, isAnd ? rhsBlock : trueBlock, isAnd ? falseBlock : rhsBlock);
+            builder->currentBlock = rhsBlock;
+        }
+
+        lowerCondition(builder, node->right, trueBlock, falseBlock);
+        return;
+    }
+
+    // Negating a condition swaps its targets
+    if (node->nodeType == AST_UNARY_EXPRESSION && operator == TOKEN_LOGICAL_NEGATION) {
+        lowerCondition(builder, node->left, falseBlock, trueBlock);
+        return;
+    }
+
+    // Otherwise the value of the condition is computed and tested, and an erroneous condition is never taken, where
+    // the analyzer accepts any value only known at runtime (e.g. returned by a call), whose type is checked here
+    int value = lowerExpression(builder, node);
+    IRType type = value == IR_NO_REGISTER ? IR_TYPE_BOOL : function->registerTypes[value];
+
+    if (type != IR_TYPE_BOOL && type != IR_TYPE_ANY) {
+        reportDiagnostic(builder->program->diagnostics, location, "Expecting a Bool rather than a value of type %s",
+                         getIRTypeName(type));
+        builder->program->errorCount++;
+        value = IR_NO_REGISTER;
+    }
+
+    if (value == IR_NO_REGISTER) {
+        emitIRInstruction(function, builder->currentBlock, IR_JUMP, IR_TYPE_VOID, location)->targets[0] = falseBlock;
+        return;
+    }
+
+    IRInstruction *branch = emitIRInstruction(function, builder->currentBlock, IR_BRANCH, IR_TYPE_VOID, location);
+    branch->operands[0] = value;
+    branch->targets[0] = trueBlock;
+    branch->targets[1] = falseBlock;
+}
+
+void bindIRLocal(IRBuilder *builder, int local) {
+    // Grow the binding array if needed
+    if (builder->bindingCount == builder->bindingCapacity) {
+        int capacity = builder->bindingCapacity ? builder->bindingCapacity * 2 : 16;
+        IRBinding *bindings = (IRBinding*) realloc(builder->bindings, capacity * sizeof(IRBinding));
+        if (!bindings) return;
+
+        builder->bindings = bindings;
+        builder->bindingCapacity = capacity;
+    }
+
+    IRBinding *binding = &builder->bindings[builder->bindingCount++];
+    strcpy(binding->identifier, builder->function->locals[local].identifier);
+    binding->local = local;
+    binding->depth = builder->depth;
+    binding->isGlobal = builder->function->locals[local].isGlobal;
+}
+
+IRBinding *lookupIRBinding(IRBuilder *builder, const char *identifier) {
+    // Search from the innermost binding, where only globals are visible below the function being built
+    for (int index = builder->bindingCount - 1; index >= 0; index--) {
+        IRBinding *binding = &builder->bindings[index];
+        if (index < builder->functionBinding && (!binding->isGlobal || index >= builder->globalBinding)) continue;
+        if (strcmp(binding->identifier, identifier) == 0) return binding;
+    }
+
+    return NULL;
+}
+
+IRProgram *initIRProgram() {
+    IRProgram *program = (IRProgram*) malloc(sizeof(IRProgram));
+    if (!program) return NULL;
+
+    program->functions = NULL;
+    program->functionCount = 0;
+    program->functionCapacity = 0;
+    program->strings = NULL;
+    program->stringCount = 0;
+    program->stringCapacity = 0;
+    program->errorCount = 0;
+    program->externals = NULL;
+    program->externalCount = 0;
+    program->externalCapacity = 0;
+    program->diagnostics = NULL;
+    program->isOverflowChecked = 0;
+
+    return program;
+}
+
+IRFunction *initIRFunction(const char *name, IRType returnType, Location location) {
+    IRFunction *function = (IRFunction*) malloc(sizeof(IRFunction));
+    if (!function) return NULL;
+
+    strcpy(function->name, name);
+    function->returnType = returnType;
+    function->location = location;
+    function->locals = NULL;
+    function->localCount = 0;
+    function->localCapacity = 0;
+    function->parameterCount = 0;
+    function->registerTypes = NULL;
+    function->registerCount = 0;
+    function->registerCapacity = 0;
+    function->blocks = NULL;
+    function->blockCount = 0;
+    function->blockCapacity = 0;
+    function->slots = NULL;
+    function->frameSize = 0;
+    function->isLaidOut = 0;
+    function->switchTables = NULL;
+    function->switchTableCount = 0;
+    function->switchTableCapacity = 0;
+
+    // Every function has an entry block
+    addIRBlock(function);
+    return function;
+}
+
+int addIRFunction(IRProgram *program, IRFunction *function) {
+    if (program->functionCount == program->functionCapacity) {
+        int capacity = program->functionCapacity ? program->functionCapacity * 2 : 8;
+        IRFunction **functions = (IRFunction**) realloc(program->functions, capacity * sizeof(IRFunction*));
+        if (!functions) return -1;
+
+        program->functions = functions;
+        program->functionCapacity = capacity;
+    }
+
+    program->functions[program->functionCount] = function;
+    return program->functionCount++;
+}
+
+int findIRFunction(IRProgram *program, const char *name) {
+    for (int index = 1; index < program->functionCount; index++) {
+        if (strcmp(program->functions[index]->name, name) == 0) return index;
+    }
+
+    return -1;
+}
+
+int addIRExternal(IRProgram *program, const IRExternal *external) {
+    if (program->externalCount == program->externalCapacity) {
+        int capacity = program->externalCapacity ? program->externalCapacity * 2 : 8;
+        IRExternal *externals = (IRExternal*) realloc(program->externals, capacity * sizeof(IRExternal));
+        if (!externals) return -1;
+
+        program->externals = externals;
+        program->externalCapacity = capacity;
+    }
+
+    program->externals[program->externalCount] = *external;
+    return program->externalCount++;
+}
+
+int findIRExternal(IRProgram *program, const char *identifier, int isFunction) {
+    for (int index = 0; index < program->externalCount; index++) {
+        IRExternal *external = &program->externals[index];
+        if (external->isFunction == isFunction && strcmp(external->identifier, identifier) == 0) return index;
+    }
+
+    return -1;
+}
+
+int addIRBlock(IRFunction *function) {
+    if (function->blockCount == function->blockCapacity) {
+        int capacity = function->blockCapacity ? function->blockCapacity * 2 : 8;
+        BasicBlock **blocks = (BasicBlock**) realloc(function->blocks, capacity * sizeof(BasicBlock*));
+        if (!blocks) return IR_NO_BLOCK;
+
+        function->blocks = blocks;
+        function->blockCapacity = capacity;
+    }
+
+    BasicBlock *block = (BasicBlock*) malloc(sizeof(BasicBlock));
+    if (!block) return IR_NO_BLOCK;
+
+    block->index = function->blockCount;
+    block->instructions = NULL;
+    block->instructionCount = 0;
+    block->instructionCapacity = 0;
+    block->predecessors = NULL;
+    block->predecessorCount = 0;
+
+    function->blocks[function->blockCount] = block;
+    return function->blockCount++;
+}
+
+int addIRLocal(IRFunction *function, const char *identifier, IRType type, Location location) {
+    if (function->localCount == function->localCapacity) {
+        int capacity = function->localCapacity ? function->localCapacity * 2 : 8;
+        IRLocal *locals = (IRLocal*) realloc(function->locals, capacity * sizeof(IRLocal));
+        if (!locals) return -1;
+
+        function->locals = locals;
+        function->localCapacity = capacity;
+    }
+
+    IRLocal *local = &function->locals[function->localCount];
+    strcpy(local->identifier, identifier);
+    local->registerIndex = addIRRegister(function, type);
+    local->type = type;
+    local->isMutable = 0;
+    local->isParameter = 0;
+    local->isGlobal = 0;
+    local->declarationLocation = location;
+
+    return function->localCount++;
+}
+
+void orderIRRegisters(IRFunction *function) {
+    int *mapping = (int*) malloc((function->registerCount + 1) * sizeof(int));
+    IRType *types = (IRType*) malloc((function->registerCount + 1) * sizeof(IRType));
+    if (!mapping || !types) { free(mapping); free(types); return; }
+
+    // Locals come first in the order they were declared, followed by the temporaries
+    for (int index = 0; index < function->registerCount; index++) mapping[index] = -1;
+    for (int local = 0; local < function->localCount; local++) mapping[function->locals[local].registerIndex] = local;
+
+    int next = function->localCount;
+    for (int index = 0; index < function->registerCount; index++) if (mapping[index] < 0) mapping[index] = next++;
+
+    for (int index = 0; index < function->registerCount; index++) types[mapping[index]] = function->registerTypes[index];
+    for (int local = 0; local < function->localCount; local++) function->locals[local].registerIndex = local;
+
+    // Rename every register defined or used by the instructions
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            if (instruction->destination >= 0) instruction->destination = mapping[instruction->destination];
+            if (instruction->operands[0] >= 0) instruction->operands[0] = mapping[instruction->operands[0]];
+            if (instruction->operands[1] >= 0) instruction->operands[1] = mapping[instruction->operands[1]];
+        }
+    }
+
+    free(function->registerTypes);
+    function->registerTypes = types;
+    function->registerCapacity = function->registerCount + 1;
+    free(mapping);
+}
+
+int addIRRegister(IRFunction *function, IRType type) {
+    if (function->registerCount == function->registerCapacity) {
+        int capacity = function->registerCapacity ? function->registerCapacity * 2 : 16;
+        IRType *types = (IRType*) realloc(function->registerTypes, capacity * sizeof(IRType));
+        if (!types) return IR_NO_REGISTER;
+
+        function->registerTypes = types;
+        function->registerCapacity = capacity;
+    }
+
+    function->registerTypes[function->registerCount] = type;
+    return function->registerCount++;
+}
+
+IRInstruction *emitIRInstruction(IRFunction *function, int blockIndex, IROpcode opcode, IRType type, Location location) {
+    BasicBlock *block = function->blocks[blockIndex];
+
+    if (block->instructionCount == block->instructionCapacity) {
+        int capacity = block->instructionCapacity ? block->instructionCapacity * 2 : 8;
+        IRInstruction *instructions = (IRInstruction*) realloc(block->instructions, capacity * sizeof(IRInstruction));
+
+        // There is no way to recover from running out of memory in the middle of lowering
+        if (!instructions) {
+            fprintf(stderr, "[IRError]: Unable to allocate memory for instructions.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        block->instructions = instructions;
+        block->instructionCapacity = capacity;
+    }
+
+    IRInstruction *instruction = &block->instructions[block->instructionCount++];
+    instruction->opcode = opcode;
+    instruction->type = type;
+    instruction->destination = IR_NO_REGISTER;
+    instruction->operands[0] = IR_NO_REGISTER;
+    instruction->operands[1] = IR_NO_REGISTER;
+    instruction->targets[0] = IR_NO_BLOCK;
+    instruction->targets[1] = IR_NO_BLOCK;
+    instruction->constant.integerValue = 0;
+    instruction->argumentCount = 0;
+    instruction->location = location;
+
+    return instruction;
+}
+
+int internIRString(IRProgram *program, const char *string) {
+    for (int index = 0; index < program->stringCount; index++) {
+        if (strcmp(program->strings[index], string) == 0) return index;
+    }
+
+    if (program->stringCount == program->stringCapacity) {
+        int capacity = program->stringCapacity ? program->stringCapacity * 2 : 8;
+        char **strings = (char**) realloc(program->strings, capacity * sizeof(char*));
+        if (!strings) return -1;
+
+        program->strings = strings;
+        program->stringCapacity = capacity;
+    }
+
+    program->strings[program->stringCount] = strdup(string);
+    return program->stringCount++;
+}
+
+int isIRTerminator(IROpcode opcode) {
+    return opcode == IR_JUMP || opcode == IR_BRANCH || opcode == IR_SWITCH || opcode == IR_RETURN;
+}
+
+int isIRBlockTerminated(BasicBlock *block) {
+    return block->instructionCount > 0 && isIRTerminator(block->instructions[block->instructionCount - 1].opcode);
+}
+
+int isIRPure(IROpcode opcode) {
+    switch (opcode) {
+        case IR_DIVIDE: case IR_MODULO: case IR_DECLARE: case IR_STORE_GLOBAL: case IR_ARGUMENT: case IR_CALL:
+        case IR_STORE_RESULT: case IR_JUMP: case IR_BRANCH: case IR_SWITCH: case IR_RETURN: return 0;
+        default: return 1;
+    }
+}
+
+int isIRGlobal(IRProgram *program, IRFunction *function, int reg) {
+    return function == program->functions[0] && reg >= 0 && reg < function->localCount && function->locals[reg].isGlobal;
+}
+
+int getIRUses(IRInstruction *instruction, int uses[2]) {
+    int count = 0;
+
+    // Declarations, constants, loads and calls read no register, and jumps have no operand
+    if (instruction->operands[0] >= 0) uses[count++] = instruction->operands[0];
+    if (instruction->operands[1] >= 0) uses[count++] = instruction->operands[1];
+
+    return count;
+}
+
+int getIRSuccessors(IRFunction *function, BasicBlock *block, int *successors) {
+    if (!isIRBlockTerminated(block)) return 0;
+
+    IRInstruction *terminator = &block->instructions[block->instructionCount - 1];
+    int count = 0;
+
+    if (terminator->targets[0] != IR_NO_BLOCK) successors[count++] = terminator->targets[0];
+
+    // Both targets of a branch might be the same block, which is a single successor
+    if (terminator->targets[1] != IR_NO_BLOCK && terminator->targets[1] != terminator->targets[0]) {
+        successors[count++] = terminator->targets[1];
+    }
+
+    // The values of a switch mostly go to a few blocks, so a block is looked up among the successors found so far
+    if (terminator->opcode == IR_SWITCH) {
+        IRSwitchTable *table = &function->switchTables[terminator->constant.integerValue];
+
+        for (int index = 0; index < table->count; index++) {
+            int target = table->targets[index], isFound = 0;
+            for (int successor = 0; successor < count && !isFound; successor++) {
+                isFound = (successors[successor] == target);
+            }
+
+            if (!isFound) successors[count++] = target;
+        }
+    }
+
+    return count;
+}
+
+void renumberIRTargets(IRFunction *function, const int *renumbered) {
+    for (int index = 0; index < function->blockCount; index++) {
+        BasicBlock *block = function->blocks[index];
+        if (!isIRBlockTerminated(block)) continue;
+
+        IRInstruction *terminator = &block->instructions[block->instructionCount - 1];
+
+        for (int target = 0; target < 2; target++) {
+            int block = terminator->targets[target];
+            if (block != IR_NO_BLOCK) terminator->targets[target] = renumbered[block];
+        }
+    }
+
+    // A table left behind by a removed switch is renumbered as well, and never read again
+    for (int index = 0; index < function->switchTableCount; index++) {
+        IRSwitchTable *table = &function->switchTables[index];
+
+        for (int value = 0; value < table->count; value++) {
+            if (table->targets[value] != IR_NO_BLOCK) table->targets[value] = renumbered[table->targets[value]];
+        }
+    }
+}
+
+int addIRSwitchTable(IRFunction *function, int low, int count, int target) {
+    if (function->switchTableCount == function->switchTableCapacity) {
+        int capacity = function->switchTableCapacity ? function->switchTableCapacity * 2 : 4;
+        IRSwitchTable *tables = (IRSwitchTable*) realloc(function->switchTables, capacity * sizeof(IRSwitchTable));
+        if (!tables) return -1;
+
+        function->switchTables = tables;
+        function->switchTableCapacity = capacity;
+    }
+
+    int *targets = (int*) malloc((count + 1) * sizeof(int));
+    if (!targets) return -1;
+
+    for (int value = 0; value < count; value++) targets[value] = target;
+    function->switchTables[function->switchTableCount] = (IRSwitchTable) {low, count, targets};
+    return function->switchTableCount++;
+}
+
+int hashIRString(const char *string, int seed) {
+    uint32_t hash = 2166136261u ^ (uint32_t) seed;
+
+    for (const unsigned char *character = (const unsigned char*) string; *character; character++) {
+        hash = (hash ^ *character) * 16777619u;
+    }
+
+    return (int) hash;
+}
+
+void computeIRPredecessors(IRFunction *function) {
+    // Count the predecessors first, so that each array is allocated once
+    int *counts = (int*) calloc(function->blockCount + 1, sizeof(int));
+    int *successors = (int*) malloc((function->blockCount + 1) * sizeof(int));
+
+    if (!counts || !successors) {
+        free(counts); free(successors);
+        return;
+    }
+
+    for (int index = 0; index < function->blockCount; index++) {
+        int count = getIRSuccessors(function, function->blocks[index], successors);
+        for (int successor = 0; successor < count; successor++) counts[successors[successor]]++;
+    }
+
+    for (int index = 0; index < function->blockCount; index++) {
+        BasicBlock *block = function->blocks[index];
+        free(block->predecessors);
+        block->predecessors = (int*) malloc((counts[index] + 1) * sizeof(int));
+        block->predecessorCount = 0;
+    }
+
+    for (int index = 0; index < function->blockCount; index++) {
+        int count = getIRSuccessors(function, function->blocks[index], successors);
+
+        for (int successor = 0; successor < count; successor++) {
+            BasicBlock *block = function->blocks[successors[successor]];
+            block->predecessors[block->predecessorCount++] = index;
+        }
+    }
+
+    free(counts);
+    free(successors);
+}
+
+IRType getIRType(const char *typeName) {
+    if (strcmp(typeName, "Int") == 0 || strcmp(typeName, "Int32") == 0) return IR_TYPE_INT;
+    if (strcmp(typeName, "Float") == 0) return IR_TYPE_FLOAT;
+    if (strcmp(typeName, "Bool") == 0) return IR_TYPE_BOOL;
+    if (strcmp(typeName, "String") == 0) return IR_TYPE_STRING;
+    if (strcmp(typeName, "Void") == 0) return IR_TYPE_VOID;
+    if (strcmp(typeName, "Int8") == 0) return IR_TYPE_INT8;
+    if (strcmp(typeName, "Int16") == 0) return IR_TYPE_INT16;
+    if (strcmp(typeName, "UInt8") == 0) return IR_TYPE_UINT8;
+    if (strcmp(typeName, "UInt16") == 0) return IR_TYPE_UINT16;
+    if (strcmp(typeName, "UInt32") == 0) return IR_TYPE_UINT32;
+    if (strcmp(typeName, "Vec4f") == 0) return IR_TYPE_VEC4F;
+    if (strcmp(typeName, "Vec8f") == 0) return IR_TYPE_VEC8F;
+    if (strcmp(typeName, "Vec4i") == 0) return IR_TYPE_VEC4I;
+    if (strcmp(typeName, "Vec8i") == 0) return IR_TYPE_VEC8I;
+    if (strcmp(typeName, "Mask4") == 0) return IR_TYPE_MASK4;
+    if (strcmp(typeName, "Mask8") == 0) return IR_TYPE_MASK8;
+    return IR_TYPE_ANY;
+}
+
+const char *getIRTypeName(IRType type) {
+    switch (type) {
+        case IR_TYPE_VOID: return "Void";
+        case IR_TYPE_INT: return "Int";
+        case IR_TYPE_FLOAT: return "Float";
+        case IR_TYPE_BOOL: return "Bool";
+        case IR_TYPE_STRING: return "String";
+        case IR_TYPE_INT8: return "Int8";
+        case IR_TYPE_INT16: return "Int16";
+        case IR_TYPE_UINT8: return "UInt8";
+        case IR_TYPE_UINT16: return "UInt16";
+        case IR_TYPE_UINT32: return "UInt32";
+        case IR_TYPE_VEC4F: return "Vec4f";
+        case IR_TYPE_VEC8F: return "Vec8f";
+        case IR_TYPE_VEC4I: return "Vec4i";
+        case IR_TYPE_VEC8I: return "Vec8i";
+        case IR_TYPE_MASK4: return "Mask4";
+        case IR_TYPE_MASK8: return "Mask8";
+        default: return "Any";
+    }
+}
+
+const char *getIROpcodeName(IROpcode opcode) {
+    static const char *names[] = {
+        "constant", "copy", "convert", "declare", "load_global", "store_global", "add", "subtract", "multiply",
+        "divide", "modulo", "negate", "not", "factorial", "shift_left", "shift_right", "shift_right_logical",
+        "bitwise_and", "multiply_high", "bit_test", "string_hash", "equal", "not_equal", "less_than", "less_or_equal",
+        "greater_than", "greater_or_equal", "splat", "insert_lane", "extract_lane", "argument", "call", "load_result",
+        "store_result", "jump", "branch", "switch", "return",
+    };
+
+    return names[opcode];
+}
+
+void displayIRProgram(IRProgram *program) {
+    for (int index = 0; index < program->functionCount; index++) displayIRFunction(program, program->functions[index]);
+}
+
+void displayIRInstruction(IRProgram *program, IRInstruction *instruction) {
+    const char *name = getIROpcodeName(instruction->opcode);
+
+    // Instructions defining a register are displayed as an assignment to the register
+    if (instruction->destination != IR_NO_REGISTER) {
+        printf("r%d = ", instruction->destination);
+    }
+
+    switch (instruction->opcode) {
+        case IR_CONSTANT: {
+            printf("%s %s ", name, getIRTypeName(instruction->type));
+            if (instruction->type == IR_TYPE_FLOAT) printf("%f", instruction->constant.floatingValue);
+            else if (instruction->type == IR_TYPE_BOOL) printf("%s", instruction->constant.booleanValue ? "true" : "false");
+            else if (instruction->type == IR_TYPE_STRING) printf("%s", program->strings[instruction->constant.stringIndex]);
+            else printf("%d", instruction->constant.integerValue);
+            break;
+        }
+
+        case IR_DECLARE: printf("%s %s", name, getIRTypeName(instruction->type)); break;
+        case IR_LOAD_GLOBAL: printf("%s g%d", name, instruction->constant.integerValue); break;
+        case IR_STORE_GLOBAL: printf("%s g%d, r%d", name, instruction->constant.integerValue, instruction->operands[0]); break;
+
+        case IR_CALL: {
+            printf("%s %s(%d)", name, program->strings[instruction->constant.stringIndex], instruction->argumentCount);
+            break;
+        }
+
+        // Shifts, masks and high multiplications take an immediate as their second operand
+        case IR_SHIFT_LEFT: case IR_SHIFT_RIGHT: case IR_SHIFT_RIGHT_LOGICAL: case IR_BITWISE_AND: case IR_MULTIPLY_HIGH: {
+            printf("%s r%d, %d", name, instruction->operands[0], instruction->constant.integerValue);
+            break;
+        }
+
+        case IR_BIT_TEST: {
+            printf("%s r%d, r%d, 0x%x", name, instruction->operands[0], instruction->operands[1],
+                   (unsigned int) instruction->constant.integerValue);
+            break;
+        }
+
+        case IR_STRING_HASH: case IR_EXTRACT_LANE: {
+            printf("%s r%d, %d", name, instruction->operands[0], instruction->constant.integerValue);
+            break;
+        }
+
+        case IR_INSERT_LANE: {
+            printf("%s r%d, %d, r%d", name, instruction->operands[0], instruction->constant.integerValue,
+                   instruction->operands[1]);
+            break;
+        }
+
+        case IR_LOAD_RESULT: printf("%s %d", name, instruction->constant.integerValue); break;
+
+        case IR_STORE_RESULT: {
+            printf("%s %d, r%d", name, instruction->constant.integerValue, instruction->operands[0]);
+            break;
+        }
+
+        case IR_JUMP: printf("%s block%d", name, instruction->targets[0]); break;
+
+        case IR_SWITCH: {
+            printf("%s r%d, table%d, block%d", name, instruction->operands[0], instruction->constant.integerValue,
+                   instruction->targets[0]);
+            break;
+        }
+
+        case IR_BRANCH: {
+            printf("%s r%d, block%d, block%d", name, instruction->operands[0], instruction->targets[0],
+                   instruction->targets[1]);
+            break;
+        }
+
+        default: {
+            printf("%s", name);
+            if (instruction->operands[0] != IR_NO_REGISTER) printf(" r%d", instruction->operands[0]);
+            if (instruction->operands[1] != IR_NO_REGISTER) printf(", r%d", instruction->operands[1]);
+            break;
+        }
+    }
+}
+
+void displayIRFunction(IRProgram *program, IRFunction *function) {
+    printf("\n------------------------------ IR Function '%s' -> %s ------------------------------\n",
+           function->name, getIRTypeName(function->returnType));
+    printf("%-8s %-20s %-10s %-8s %s\n", "Register", "Local", "Type", "Mutable", "Location");
+
+    for (int local = 0; local < function->localCount; local++) {
+        IRLocal *entry = &function->locals[local];
+        printf("r%-7d %-20s %-10s %-8s %d:%d\n", entry->registerIndex, entry->identifier,
+               getIRTypeName(entry->type), entry->isMutable ? "Yes" : "No",
+               entry->declarationLocation.line, entry->declarationLocation.column);
+    }
+
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+        printf("block%d:\n", block->index);
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            printf("    ");
+            displayIRInstruction(program, &block->instructions[index]);
+            printf("\n");
+        }
+    }
+
+    for (int index = 0; index < function->switchTableCount; index++) {
+        IRSwitchTable *table = &function->switchTables[index];
+        printf("table%d [%d, %d]:", index, table->low, table->low + table->count - 1);
+        for (int value = 0; value < table->count; value++) printf(" block%d", table->targets[value]);
+        printf("\n");
+    }
+
+    printf("-----------------------------------------------------------------------------------\n");
+}
+
+void freeIRFunction(IRFunction *function) {
+    if (!function) return;
+
+    for (int index = 0; index < function->blockCount; index++) {
+        free(function->blocks[index]->instructions);
+        free(function->blocks[index]->predecessors);
+        free(function->blocks[index]);
+    }
+
+    for (int index = 0; index < function->switchTableCount; index++) free(function->switchTables[index].targets);
+
+    free(function->blocks);
+    free(function->switchTables);
+    free(function->slots);
+    free(function->locals);
+    free(function->registerTypes);
+    free(function);
+}
+
+void freeIRProgram(IRProgram *program) {
+    if (!program) return;
+
+    for (int index = 0; index < program->functionCount; index++) freeIRFunction(program->functions[index]);
+    for (int index = 0; index < program->stringCount; index++) free(program->strings[index]);
+
+    free(program->functions);
+    free(program->strings);
+    free(program->externals);
+    free(program);
+}
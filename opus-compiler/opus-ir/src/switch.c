@@ -0,0 +1,417 @@
+// switch.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "switch.h"
+#include "integer.h"
+
+// Jumps from the current block to a target
+static void emitSwitchJump(IRBuilder *builder, int target, Location location) {
+    emitIRInstruction(builder->function, builder->currentBlock, IR_JUMP, IR_TYPE_VOID, location)->targets[0] = target;
+}
+
+// Branches from the current block on a condition, and continues in a new block if it does not hold
+static void emitSwitchBranch(IRBuilder *builder, int condition, int target, int otherwise, Location location) {
+    IRInstruction *branch = emitIRInstruction(builder->function, builder->currentBlock, IR_BRANCH, IR_TYPE_VOID,
+                                              location);
+    branch->operands[0] = condition;
+    branch->targets[0] = target;
+    branch->targets[1] = otherwise;
+    builder->currentBlock = otherwise;
+}
+
+// Loads a constant into a new register of the current block
+static int emitSwitchConstant(IRBuilder *builder, IRType type, int value, Location location) {
+    int destination = addIRRegister(builder->function, type);
+    IRInstruction *instruction = emitIRInstruction(builder->function, builder->currentBlock, IR_CONSTANT, type,
+                                                   location);
+    instruction->destination = destination;
+    instruction->constant.integerValue = value;
+    return destination;
+}
+
+// Compares the value with a constant of the same type in the current block
+static int emitSwitchEqual(IRBuilder *builder, int value, IRType type, int constant, Location location) {
+    int operand = emitSwitchConstant(builder, type, constant, location);
+    int destination = addIRRegister(builder->function, IR_TYPE_BOOL);
+    IRInstruction *equal = emitIRInstruction(builder->function, builder->currentBlock, IR_EQUAL, IR_TYPE_BOOL,
+                                             location);
+    equal->destination = destination;
+    equal->operands[0] = value;
+    equal->operands[1] = operand;
+    return destination;
+}
+
+// Compares the value with each entry in turn, ending with the default block
+static void lowerLinearSwitch(IRBuilder *builder, int value, IRType type, IRSwitchEntry *entries, int count,
+                              int defaultBlock) {
+    for (int index = 0; index < count; index++) {
+        int isLast = (index == count - 1);
+        int condition = emitSwitchEqual(builder, value, type, entries[index].value, entries[index].location);
+        int otherwise = isLast ? defaultBlock : addIRBlock(builder->function);
+
+        emitSwitchBranch(builder, condition, entries[index].target, otherwise, entries[index].location);
+    }
+}
+
+// Reads the literal value of a case, where an Int might be negated (e.g. "case -1"), or returns 0 (False) if the
+// value is not a literal
+static int readSwitchValue(IRBuilder *builder, ASTNode *node, IRType *type, int *value) {
+    int isNegated = 0;
+
+    if (node->nodeType == AST_UNARY_EXPRESSION && node->token->tokenType == TOKEN_ARITHMETIC_SUBTRACTION) {
+        isNegated = 1;
+        node = node->left;
+        if (node->nodeType != AST_LITERAL || node->token->tokenType != TOKEN_NUMERIC) return 0;
+    }
+
+    if (node->nodeType == AST_BOOLEAN_LITERAL) {
+        *type = IR_TYPE_BOOL;
+        *value = (strcmp(node->token->lexeme, "true") == 0);
+        return 1;
+    }
+
+    if (node->nodeType != AST_LITERAL) return 0;
+
+    if (node->token->tokenType == TOKEN_STRING_LITERAL) {
+        *type = IR_TYPE_STRING;
+        *value = internIRString(builder->program, node->token->lexeme);
+        return 1;
+    }
+
+    // A Float is not matched by a switch, since its values are never compared for equality
+    *type = strchr(node->token->lexeme, '.') ? IR_TYPE_FLOAT : IR_TYPE_INT;
+    *value = isNegated ? -atoi(node->token->lexeme) : atoi(node->token->lexeme);
+    return 1;
+}
+
+// Sorts the entries of an Int switch by their values
+static int compareSwitchEntries(const void *lhs, const void *rhs) {
+    int left = ((const IRSwitchEntry*) lhs)->value;
+    int right = ((const IRSwitchEntry*) rhs)->value;
+    return (left > right) - (left < right);
+}
+
+void lowerSwitchStatement(IRBuilder *builder, ASTNode *node) {
+    IRFunction *function = builder->function;
+    IRProgram *program = builder->program;
+    Location location = node->token->location;
+
+    int value = lowerExpression(builder, node->left);
+    if (value == IR_NO_REGISTER) return;
+
+    IRType type = function->registerTypes[value];
+
+    // A sized integer is ordered like an Int, except a UInt32 above Int.max
+    int isInteger = getIRIntegerWidth(type) > 0 && type != IR_TYPE_UINT32;
+
+    if (!isInteger && type != IR_TYPE_STRING && type != IR_TYPE_BOOL) {
+        reportDiagnostic(program->diagnostics, location, "A switch matches a value of type Int, String or Bool (or an "
+                         "integer of up to 16 bits) rather than a value of type %s", getIRTypeName(type));
+        program->errorCount++;
+        return;
+    }
+
+    int errorCount = program->errorCount;
+    int joinBlock = addIRBlock(function);
+    int defaultBlock = IR_NO_BLOCK;
+    Location defaultLocation = location;
+
+    IRSwitchEntry *entries = NULL;
+    int entryCount = 0, entryCapacity = 0;
+
+    // Each case gets a block of its own, in the order of the cases, and each of its values is an entry
+    for (ASTNode *caseNode = node->right; caseNode; caseNode = caseNode->right->right) {
+        int caseBlock = addIRBlock(function);
+
+        if (caseNode->token->tokenType == TOKEN_KEYWORD_DEFAULT) {
+            if (defaultBlock != IR_NO_BLOCK) {
+                reportDiagnostic(program->diagnostics, caseNode->token->location, "The switch already has a "
+                                 "'default' case at line %d", defaultLocation.line);
+                program->errorCount++;
+            }
+
+            else {
+                defaultBlock = caseBlock;
+                defaultLocation = caseNode->token->location;
+            }
+        }
+
+        for (ASTNode *pattern = caseNode->left; pattern; pattern = pattern->right) {
+            ASTNode *literal = pattern->left;
+            Location valueLocation = literal->token ? literal->token->location : caseNode->token->location;
+            IRType valueType;
+            int caseValue;
+
+            if (!readSwitchValue(builder, literal, &valueType, &caseValue)) {
+                reportDiagnostic(program->diagnostics, valueLocation, "The value of a case must be a literal");
+                program->errorCount++;
+                continue;
+            }
+
+            // An Int literal matches a sized integer holding its value
+            if (valueType == IR_TYPE_INT && isInteger && isIRIntegerInRange(type, caseValue)) valueType = type;
+
+            if (valueType != type) {
+                reportDiagnostic(program->diagnostics, valueLocation, "A case of type %s cannot match a value of "
+                                 "type %s", getIRTypeName(valueType), getIRTypeName(type));
+                program->errorCount++;
+                continue;
+            }
+
+            // A value matched by an earlier case would never reach this one
+            int duplicate = -1;
+            for (int index = 0; index < entryCount && duplicate < 0; index++) {
+                if (entries[index].value == caseValue) duplicate = index;
+            }
+
+            if (duplicate >= 0) {
+                char lexeme[LEXEME_LENGTH + 1];
+                snprintf(lexeme, sizeof(lexeme), "%s%s", literal->nodeType == AST_UNARY_EXPRESSION ? "-" : "",
+                         literal->nodeType == AST_UNARY_EXPRESSION ? literal->left->token->lexeme
+                                                                   : literal->token->lexeme);
+
+                reportDiagnostic(program->diagnostics, valueLocation, "The value '%s' is already matched by the "
+                                 "case at line %d", lexeme, entries[duplicate].location.line);
+                program->errorCount++;
+                continue;
+            }
+
+            if (entryCount == entryCapacity) {
+                entryCapacity = entryCapacity ? entryCapacity * 2 : 8;
+                IRSwitchEntry *grown = (IRSwitchEntry*) realloc(entries, entryCapacity * sizeof(IRSwitchEntry));
+                if (!grown) { free(entries); return; }
+                entries = grown;
+            }
+
+            entries[entryCount++] = (IRSwitchEntry) {caseValue, caseBlock, valueLocation};
+        }
+    }
+
+    // Without a default case, every value must be matched, which only a Bool can be
+    if (defaultBlock == IR_NO_BLOCK && (type != IR_TYPE_BOOL || entryCount < 2)) {
+        const char *missing = "'default'";
+        if (type == IR_TYPE_BOOL && entryCount == 1) missing = entries[0].value ? "'false'" : "'true'";
+
+        reportDiagnostic(program->diagnostics, location, "The switch does not match every value of type %s, a case "
+                         "%s is missing", getIRTypeName(type), missing);
+        program->errorCount++;
+    }
+
+    // Dispatch the value to the block of its case, unless the cases are erroneous
+    if (defaultBlock == IR_NO_BLOCK) defaultBlock = joinBlock;
+
+    if (program->errorCount > errorCount) emitSwitchJump(builder, defaultBlock, location);
+
+    else if (type == IR_TYPE_BOOL) {
+        int trueBlock = defaultBlock, falseBlock = defaultBlock;
+
+        for (int index = 0; index < entryCount; index++) {
+            if (entries[index].value) trueBlock = entries[index].target;
+            else falseBlock = entries[index].target;
+        }
+
+        IRInstruction *branch = emitIRInstruction(function, builder->currentBlock, IR_BRANCH, IR_TYPE_VOID, location);
+        branch->operands[0] = value;
+        branch->targets[0] = trueBlock;
+        branch->targets[1] = falseBlock;
+    }
+
+    else if (type == IR_TYPE_STRING) lowerStringSwitch(builder, value, entries, entryCount, defaultBlock, location);
+
+    else {
+        qsort(entries, entryCount, sizeof(IRSwitchEntry), compareSwitchEntries);
+        lowerIntSwitch(builder, value, entries, entryCount, defaultBlock, location);
+    }
+
+    free(entries);
+
+    // Each body continues at the join block, where the blocks of the cases are numbered from the join block on
+    int caseBlock = joinBlock + 1;
+
+    for (ASTNode *caseNode = node->right; caseNode; caseNode = caseNode->right->right) {
+        builder->currentBlock = caseBlock++;
+        lowerCodeBlock(builder, caseNode->right->left);
+
+        if (!isIRBlockTerminated(function->blocks[builder->currentBlock])) {
+            emitSwitchJump(builder, joinBlock, location);
+        }
+    }
+
+    builder->currentBlock = joinBlock;
+}
+
+void lowerIntSwitch(IRBuilder *builder, int value, IRSwitchEntry *entries, int count, int defaultBlock,
+                    Location location) {
+    IRFunction *function = builder->function;
+
+    if (count == 0) {
+        emitSwitchJump(builder, defaultBlock, location);
+        return;
+    }
+
+    long long low = entries[0].value;
+    long long range = (long long) entries[count - 1].value - low + 1;
+
+    // The distinct cases of the values, in the order they are first matched
+    int targets[IR_SWITCH_BIT_TEST_TARGETS + 1];
+    int targetCount = 0;
+
+    for (int index = 0; index < count && targetCount <= IR_SWITCH_BIT_TEST_TARGETS; index++) {
+        int isKnown = 0;
+        for (int target = 0; target < targetCount; target++) isKnown |= (targets[target] == entries[index].target);
+        if (!isKnown) targets[targetCount++] = entries[index].target;
+    }
+
+    // A few cases over at most 32 values are tested as bits of a mask, one test for each case
+    if (count > IR_SWITCH_LINEAR_CASES && range <= 32 && targetCount <= IR_SWITCH_BIT_TEST_TARGETS) {
+        int lowRegister = emitSwitchConstant(builder, IR_TYPE_INT, (int) low, location);
+
+        for (int target = 0; target < targetCount; target++) {
+            unsigned mask = 0;
+            Location testLocation = location;
+
+            for (int index = count - 1; index >= 0; index--) {
+                if (entries[index].target != targets[target]) continue;
+                mask |= 1u << (entries[index].value - low);
+                testLocation = entries[index].location;
+            }
+
+            int condition = addIRRegister(function, IR_TYPE_BOOL);
+            IRInstruction *test = emitIRInstruction(function, builder->currentBlock, IR_BIT_TEST, IR_TYPE_BOOL,
+                                                    testLocation);
+            test->destination = condition;
+            test->operands[0] = value;
+            test->operands[1] = lowRegister;
+            test->constant.integerValue = (int) mask;
+
+            int otherwise = target == targetCount - 1 ? defaultBlock : addIRBlock(function);
+            emitSwitchBranch(builder, condition, targets[target], otherwise, testLocation);
+        }
+
+        return;
+    }
+
+    // Dense values are dispatched by a jump table, whose holes go to the default case
+    if (count >= IR_SWITCH_TABLE_CASES && range <= IR_SWITCH_TABLE_RANGE && range <= (long long) count *
+        IR_SWITCH_TABLE_DENSITY) {
+        int table = addIRSwitchTable(function, (int) low, (int) range, defaultBlock);
+
+        if (table >= 0) {
+            for (int index = 0; index < count; index++) {
+                function->switchTables[table].targets[entries[index].value - low] = entries[index].target;
+            }
+
+            IRInstruction *dispatch = emitIRInstruction(function, builder->currentBlock, IR_SWITCH, IR_TYPE_VOID,
+                                                        location);
+            dispatch->operands[0] = value;
+            dispatch->constant.integerValue = table;
+            dispatch->targets[0] = defaultBlock;
+            return;
+        }
+    }
+
+    if (count <= IR_SWITCH_LINEAR_CASES) {
+        lowerLinearSwitch(builder, value, IR_TYPE_INT, entries, count, defaultBlock);
+        return;
+    }
+
+    // Otherwise the values below the middle value and the others are dispatched on their own
+    int middle = count / 2;
+    int lowerBlock = addIRBlock(function);
+    int upperBlock = addIRBlock(function);
+
+    int pivot = emitSwitchConstant(builder, IR_TYPE_INT, entries[middle].value, location);
+    int condition = addIRRegister(function, IR_TYPE_BOOL);
+    IRInstruction *compare = emitIRInstruction(function, builder->currentBlock, IR_LESS_THAN, IR_TYPE_BOOL, location);
+    compare->destination = condition;
+    compare->operands[0] = value;
+    compare->operands[1] = pivot;
+
+    emitSwitchBranch(builder, condition, lowerBlock, upperBlock, location);
+
+    builder->currentBlock = lowerBlock;
+    lowerIntSwitch(builder, value, entries, middle, defaultBlock, location);
+
+    builder->currentBlock = upperBlock;
+    lowerIntSwitch(builder, value, entries + middle, count - middle, defaultBlock, location);
+}
+
+void lowerStringSwitch(IRBuilder *builder, int value, IRSwitchEntry *entries, int count, int defaultBlock,
+                       Location location) {
+    IRFunction *function = builder->function;
+    int seed = 0;
+    int size = count > IR_SWITCH_LINEAR_CASES ? findPerfectHash(builder->program, entries, count, &seed) : 0;
+    int table = size > 0 ? addIRSwitchTable(function, 0, size, defaultBlock) : -1;
+
+    if (table < 0) {
+        if (count == 0) emitSwitchJump(builder, defaultBlock, location);
+        else lowerLinearSwitch(builder, value, IR_TYPE_STRING, entries, count, defaultBlock);
+        return;
+    }
+
+    // The slot of the value is its hash modulo the size of the table
+    int hash = addIRRegister(function, IR_TYPE_INT);
+    IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_STRING_HASH, IR_TYPE_INT,
+                                                   location);
+    instruction->destination = hash;
+    instruction->operands[0] = value;
+    instruction->constant.integerValue = seed;
+
+    int slot = addIRRegister(function, IR_TYPE_INT);
+    instruction = emitIRInstruction(function, builder->currentBlock, IR_BITWISE_AND, IR_TYPE_INT, location);
+    instruction->destination = slot;
+    instruction->operands[0] = hash;
+    instruction->constant.integerValue = size - 1;
+
+    IRInstruction *dispatch = emitIRInstruction(function, builder->currentBlock, IR_SWITCH, IR_TYPE_VOID, location);
+    dispatch->operands[0] = slot;
+    dispatch->constant.integerValue = table;
+    dispatch->targets[0] = defaultBlock;
+
+    // Any other string might land in the slot of a case as well, so the slot compares the value with its string
+    for (int index = 0; index < count; index++) {
+        const char *string = builder->program->strings[entries[index].value];
+        int checkBlock = addIRBlock(function);
+        function->switchTables[table].targets[hashIRString(string, seed) & (size - 1)] = checkBlock;
+
+        builder->currentBlock = checkBlock;
+        lowerLinearSwitch(builder, value, IR_TYPE_STRING, &entries[index], 1, defaultBlock);
+    }
+}
+
+int findPerfectHash(IRProgram *program, const IRSwitchEntry *entries, int count, int *seed) {
+    int size = 1;
+    while (size < count) size *= 2;
+
+    // Larger tables leave more room to the strings, until a table is much larger than the strings it holds
+    for (; size <= count * 8 && size <= IR_SWITCH_TABLE_RANGE; size *= 2) {
+        unsigned char *isUsed = (unsigned char*) malloc(size);
+        if (!isUsed) return 0;
+
+        for (int candidate = 0; candidate < IR_SWITCH_HASH_SEEDS; candidate++) {
+            int index = 0;
+            memset(isUsed, 0, size);
+
+            for (; index < count; index++) {
+                int slot = hashIRString(program->strings[entries[index].value], candidate) & (size - 1);
+                if (isUsed[slot]) break;
+                isUsed[slot] = 1;
+            }
+
+            if (index == count) {
+                free(isUsed);
+                *seed = candidate;
+                return size;
+            }
+        }
+
+        free(isUsed);
+    }
+
+    return 0;
+}
@@ -0,0 +1,616 @@
+// vector.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vector.h"
+#include "integer.h"
+
+static const struct {
+    IRType type;
+    int lanes;
+    IRType laneType;
+    IRType maskType;
+} vectorTypes[] = {
+    {IR_TYPE_VEC4F, 4, IR_TYPE_FLOAT, IR_TYPE_MASK4}, {IR_TYPE_VEC8F, 8, IR_TYPE_FLOAT, IR_TYPE_MASK8},
+    {IR_TYPE_VEC4I, 4, IR_TYPE_INT, IR_TYPE_MASK4}, {IR_TYPE_VEC8I, 8, IR_TYPE_INT, IR_TYPE_MASK8},
+    {IR_TYPE_MASK4, 4, IR_TYPE_BOOL, IR_TYPE_MASK4}, {IR_TYPE_MASK8, 8, IR_TYPE_BOOL, IR_TYPE_MASK8}
+};
+
+// Finds a vector type in the table of vector types, or -1 if the type is not a vector type
+static int findIRVectorType(IRType type) {
+    for (int index = 0; index < (int) (sizeof(vectorTypes) / sizeof(vectorTypes[0])); index++) {
+        if (vectorTypes[index].type == type) return index;
+    }
+
+    return -1;
+}
+
+// Gets the single argument of a call if it is labeled as expected, otherwise NULL
+static ASTNode *getIRSingleArgument(ASTNode *node, const char *label) {
+    ASTNode *list = node->right;
+    if (!list || !list->left || (list->right && list->right->left)) return NULL;
+    return strcmp(list->left->left->token->lexeme, label) == 0 ? list->left : NULL;
+}
+
+// Gets the operation of a binary operator on each lane, or -1 if the operator does not work lane by lane
+static int getIRLaneOpcode(TokenType operator) {
+    switch (operator) {
+        case TOKEN_ARITHMETIC_ADDITION: return IR_ADD;
+        case TOKEN_ARITHMETIC_SUBTRACTION: return IR_SUBTRACT;
+        case TOKEN_ARITHMETIC_MULTIPLICATION: return IR_MULTIPLY;
+        case TOKEN_ARITHMETIC_DIVISION: return IR_DIVIDE;
+        case TOKEN_ARITHMETIC_MODULO: return IR_MODULO;
+        case TOKEN_LOGICAL_EQUIVALENCE: return IR_EQUAL;
+        case TOKEN_NOT_EQUAL_TO_OPERATOR: return IR_NOT_EQUAL;
+        case TOKEN_LESS_THAN_OPERATOR: return IR_LESS_THAN;
+        case TOKEN_LESS_OR_EQUAL_TO_OPERATOR: return IR_LESS_OR_EQUAL;
+        case TOKEN_GREATER_THAN_OPERATOR: return IR_GREATER_THAN;
+        case TOKEN_GREATER_OR_EQUAL_TO_OPERATOR: return IR_GREATER_OR_EQUAL;
+        default: return -1;
+    }
+}
+
+// Emits an operation into a new register of the current block
+static int emitIRLane(IRBuilder *builder, IROpcode opcode, IRType type, int lhs, int rhs, Location location) {
+    int destination = addIRRegister(builder->function, type);
+    IRInstruction *instruction = emitIRInstruction(builder->function, builder->currentBlock, opcode, type, location);
+    instruction->destination = destination;
+    instruction->operands[0] = lhs;
+    instruction->operands[1] = rhs;
+    return destination;
+}
+
+// Emits the extraction or the insertion of a lane of a vector into a new register of the current block
+static int accessIRLane(IRBuilder *builder, IROpcode opcode, IRType type, int vector, int value, int lane,
+                        Location location) {
+    int destination = emitIRLane(builder, opcode, type, vector, value, location);
+    BasicBlock *block = builder->function->blocks[builder->currentBlock];
+    block->instructions[block->instructionCount - 1].constant.integerValue = lane;
+    return destination;
+}
+
+// Converts a scalar into the type of the lanes of a vector, where an integer becomes a Float for a Float lane, and a
+// sized integer is held like an Int for an Int lane
+static int convertIRLane(IRBuilder *builder, int value, IRType laneType, Location location) {
+    IRType type = builder->function->registerTypes[value];
+    if (type == laneType || type == IR_TYPE_ANY) return value;
+
+    if (laneType == IR_TYPE_FLOAT && getIRIntegerWidth(type)) {
+        return emitIRLane(builder, IR_CONVERT, IR_TYPE_FLOAT, value, IR_NO_REGISTER, location);
+    }
+
+    if (laneType == IR_TYPE_INT && isIRIntegerWidened(type, IR_TYPE_INT)) {
+        return emitIRLane(builder, IR_COPY, IR_TYPE_INT, value, IR_NO_REGISTER, location);
+    }
+
+    reportDiagnostic(builder->program->diagnostics, location, "Lane of type %s could not be given a value of type %s",
+                     getIRTypeName(laneType), getIRTypeName(type));
+    builder->program->errorCount++;
+    return IR_NO_REGISTER;
+}
+
+// Broadcasts a scalar into every lane of a vector
+static int splatIRLane(IRBuilder *builder, int value, IRType type, Location location) {
+    value = convertIRLane(builder, value, getIRLaneType(type), location);
+    return value == IR_NO_REGISTER ? IR_NO_REGISTER : emitIRLane(builder, IR_SPLAT, type, value, IR_NO_REGISTER,
+                                                                 location);
+}
+
+// Infers the vector type of an expression without lowering it, from the analyzer for an analyzed expression and from
+// the locals and the functions otherwise, since the bodies of functions are not analyzed
+static IRType inferIRVectorType(IRBuilder *builder, ASTNode *node) {
+    if (!node || !node->token) return IR_TYPE_ANY;
+
+    IRType type = getIRType(node->inferredType);
+    if (isIRVectorType(type)) return type;
+
+    TokenType operator = node->token->tokenType;
+
+    switch (node->nodeType) {
+        case AST_IDENTIFIER: {
+            IRBinding *binding = lookupIRBinding(builder, node->token->lexeme);
+            IRFunction *owner = binding && binding->isGlobal ? builder->program->functions[0] : builder->function;
+            return binding ? owner->locals[binding->local].type : IR_TYPE_ANY;
+        }
+
+        case AST_FUNCTION_CALL: {
+            int callee = findIRFunction(builder->program, node->left->token->lexeme);
+            return callee > 0 ? builder->program->functions[callee]->returnType : getIRType(node->left->token->lexeme);
+        }
+
+        case AST_BINARY_EXPRESSION: {
+            if (getIRLaneOpcode(operator) < 0) return IR_TYPE_ANY;
+
+            type = inferIRVectorType(builder, node->left);
+            if (!isIRVectorType(type)) type = inferIRVectorType(builder, node->right);
+            if (isIRVectorType(type) && getIRLaneOpcode(operator) >= IR_EQUAL) type = getIRMaskType(type);
+            return type;
+        }
+
+        case AST_UNARY_EXPRESSION: {
+            if (operator != TOKEN_ARITHMETIC_SUBTRACTION && operator != TOKEN_LOGICAL_NEGATION) return IR_TYPE_ANY;
+            return inferIRVectorType(builder, node->left);
+        }
+
+        default: return IR_TYPE_ANY;
+    }
+}
+
+// Selects the lesser or the greater of two lanes through a branch, whose outcomes assign the same temporary
+static int selectIRLane(IRBuilder *builder, int lhs, int rhs, int isMinimum, Location location) {
+    IRFunction *function = builder->function;
+    IRType type = function->registerTypes[lhs];
+    int condition = emitIRLane(builder, isMinimum ? IR_LESS_THAN : IR_GREATER_THAN, IR_TYPE_BOOL, rhs, lhs, location);
+
+    int rhsBlock = addIRBlock(function);
+    int lhsBlock = addIRBlock(function);
+    int joinBlock = addIRBlock(function);
+    IRInstruction *branch = emitIRInstruction(function, builder->currentBlock, IR_BRANCH, IR_TYPE_VOID, location);
+    branch->operands[0] = condition;
+    branch->targets[0] = rhsBlock;
+    branch->targets[1] = lhsBlock;
+
+    int destination = addIRRegister(function, type);
+    int outcomes[2] = {rhsBlock, lhsBlock};
+
+    for (int outcome = 0; outcome < 2; outcome++) {
+        IRInstruction *copy = emitIRInstruction(function, outcomes[outcome], IR_COPY, type, location);
+        copy->destination = destination;
+        copy->operands[0] = outcome == 0 ? rhs : lhs;
+        emitIRInstruction(function, outcomes[outcome], IR_JUMP, IR_TYPE_VOID, location)->targets[0] = joinBlock;
+    }
+
+    builder->currentBlock = joinBlock;
+    return destination;
+}
+
+// Reduces a mask into whether any (or all) of its lanes hold, stopping at the first lane that decides it
+static int reduceIRMask(IRBuilder *builder, const int *lanes, int count, int isAny, Location location) {
+    IRFunction *function = builder->function;
+    int decidedBlock = addIRBlock(function);
+    int joinBlock = addIRBlock(function);
+    int destination = addIRRegister(function, IR_TYPE_BOOL);
+
+    for (int lane = 0; lane < count; lane++) {
+        int nextBlock = addIRBlock(function);
+        IRInstruction *branch = emitIRInstruction(function, builder->currentBlock, IR_BRANCH, IR_TYPE_VOID, location);
+        branch->operands[0] = lanes[lane];
+        branch->targets[0] = isAny ? decidedBlock : nextBlock;
+        branch->targets[1] = isAny ? nextBlock : decidedBlock;
+        builder->currentBlock = nextBlock;
+    }
+
+    int outcomes[2] = {decidedBlock, builder->currentBlock};
+
+    for (int outcome = 0; outcome < 2; outcome++) {
+        IRInstruction *instruction = emitIRInstruction(function, outcomes[outcome], IR_CONSTANT, IR_TYPE_BOOL,
+                                                       location);
+        instruction->destination = destination;
+        instruction->constant.booleanValue = (outcome == 0) == isAny;
+        emitIRInstruction(function, outcomes[outcome], IR_JUMP, IR_TYPE_VOID, location)->targets[0] = joinBlock;
+    }
+
+    builder->currentBlock = joinBlock;
+    return destination;
+}
+
+int isIRVectorType(IRType type) {
+    return findIRVectorType(type) >= 0;
+}
+
+int getIRVectorLanes(IRType type) {
+    int index = findIRVectorType(type);
+    return index >= 0 ? vectorTypes[index].lanes : 0;
+}
+
+IRType getIRLaneType(IRType type) {
+    int index = findIRVectorType(type);
+    return index >= 0 ? vectorTypes[index].laneType : IR_TYPE_ANY;
+}
+
+IRType getIRMaskType(IRType type) {
+    int index = findIRVectorType(type);
+    return index >= 0 ? vectorTypes[index].maskType : IR_TYPE_ANY;
+}
+
+int lowerVectorConstant(IRBuilder *builder, ASTNode *node, IRType type) {
+    IRFunction *function = builder->function;
+    Location location = node->token ? node->token->location : function->location;
+    IRType laneType = getIRLaneType(type);
+    int vector = IR_NO_REGISTER;
+
+    // The lanes are compared by their bits, so that a lane of -0.0 is not taken for a lane of 0.0
+    for (int lane = 0; lane < getIRVectorLanes(type); lane++) {
+        if (lane > 0 && node->nodeValue.integerLanes[lane] == node->nodeValue.integerLanes[0]) continue;
+
+        int value = addIRRegister(function, laneType);
+        IRInstruction *instruction = emitIRInstruction(function, builder->currentBlock, IR_CONSTANT, laneType,
+                                                       location);
+        instruction->destination = value;
+
+        if (laneType == IR_TYPE_FLOAT) instruction->constant.floatingValue = node->nodeValue.floatingLanes[lane];
+        else instruction->constant.integerValue = node->nodeValue.integerLanes[lane];
+
+        vector = lane == 0 ? emitIRLane(builder, IR_SPLAT, type, value, IR_NO_REGISTER, location)
+                           : accessIRLane(builder, IR_INSERT_LANE, type, vector, value, lane, location);
+    }
+
+    return vector;
+}
+
+int lowerVectorConstruction(IRBuilder *builder, ASTNode *node, IRType type) {
+    const char *name = node->left->token->lexeme;
+    Location location = node->left->token->location;
+    ASTNode *splat = getIRSingleArgument(node, "splat");
+
+    if (splat) {
+        int value = lowerExpression(builder, splat->right);
+        return value == IR_NO_REGISTER ? IR_NO_REGISTER : splatIRLane(builder, value, type, location);
+    }
+
+    // The first lane is broadcast, and each other lane is inserted into the vector
+    int vector = IR_NO_REGISTER;
+    int count = 0;
+
+    for (ASTNode *list = node->right; list && list->left; list = list->right) {
+        if (count == getIRVectorLanes(type) || strcmp(list->left->left->token->lexeme, "lane") != 0) {
+            count = -1;
+            break;
+        }
+
+        int value = lowerExpression(builder, list->left->right);
+        if (value != IR_NO_REGISTER) value = convertIRLane(builder, value, getIRLaneType(type), location);
+        if (value == IR_NO_REGISTER) return IR_NO_REGISTER;
+
+        vector = count == 0 ? emitIRLane(builder, IR_SPLAT, type, value, IR_NO_REGISTER, location)
+                            : accessIRLane(builder, IR_INSERT_LANE, type, vector, value, count, location);
+        count++;
+    }
+
+    if (count != getIRVectorLanes(type)) {
+        reportDiagnostic(builder->program->diagnostics, location, "Vector '%s' takes a value labeled 'splat' or a "
+                         "value labeled 'lane' for each lane", name);
+        builder->program->errorCount++;
+        return IR_NO_REGISTER;
+    }
+
+    return vector;
+}
+
+int lowerVectorBinary(IRBuilder *builder, ASTNode *node, IROpcode opcode, int lhs, int rhs) {
+    Location location = node->token->location;
+    IRType lhsType = builder->function->registerTypes[lhs];
+    IRType rhsType = builder->function->registerTypes[rhs];
+    IRType type = isIRVectorType(lhsType) ? lhsType : rhsType;
+    int isEquality = opcode == IR_EQUAL || opcode == IR_NOT_EQUAL;
+
+    if ((isIRVectorType(lhsType) && isIRVectorType(rhsType) && lhsType != rhsType) ||
+        (getIRLaneType(type) == IR_TYPE_BOOL && !isEquality)) {
+        reportDiagnostic(builder->program->diagnostics, location, "Unable to perform '%s' on a vector of type %s",
+                         node->token->lexeme, getIRTypeName(type));
+        builder->program->errorCount++;
+        return IR_NO_REGISTER;
+    }
+
+    // A scalar operand is broadcast into every lane
+    if (!isIRVectorType(lhsType)) lhs = splatIRLane(builder, lhs, type, location);
+    if (!isIRVectorType(rhsType) && lhs != IR_NO_REGISTER) rhs = splatIRLane(builder, rhs, type, location);
+    if (lhs == IR_NO_REGISTER || rhs == IR_NO_REGISTER) return IR_NO_REGISTER;
+
+    return emitIRLane(builder, opcode, opcode >= IR_EQUAL ? getIRMaskType(type) : type, lhs, rhs, location);
+}
+
+int lowerVectorUnary(IRBuilder *builder, ASTNode *node, IROpcode opcode, int operand) {
+    IRType type = builder->function->registerTypes[operand];
+
+    // '-' negates the lanes of a vector, and '!' the lanes of a mask
+    if (opcode == IR_FACTORIAL || (opcode == IR_NOT) != (getIRLaneType(type) == IR_TYPE_BOOL)) {
+        reportDiagnostic(builder->program->diagnostics, node->token->location, "Unable to perform '%s' on a vector "
+                         "of type %s", node->token->lexeme, getIRTypeName(type));
+        builder->program->errorCount++;
+        return IR_NO_REGISTER;
+    }
+
+    return emitIRLane(builder, opcode, type, operand, IR_NO_REGISTER, node->token->location);
+}
+
+int lowerVectorReduction(IRBuilder *builder, ASTNode *node, int *value) {
+    static const char *reductions[] = {"sum", "min", "max", "any", "all"};
+    const char *name = node->left->token->lexeme;
+    Location location = node->left->token->location;
+    int reduction = -1;
+
+    for (int index = 0; index < (int) (sizeof(reductions) / sizeof(reductions[0])); index++) {
+        if (strcmp(name, reductions[index]) == 0) reduction = index;
+    }
+
+    // A call of a function of the program taking a scalar is not a reduction
+    ASTNode *argument = getIRSingleArgument(node, "of");
+    if (reduction < 0 || !argument) return 0;
+
+    IRType type = inferIRVectorType(builder, argument->right);
+    if (!isIRVectorType(type)) return 0;
+
+    *value = IR_NO_REGISTER;
+    IRType laneType = getIRLaneType(type);
+    int isMaskReduction = (reduction >= 3);
+
+    if (isMaskReduction != (laneType == IR_TYPE_BOOL)) {
+        reportDiagnostic(builder->program->diagnostics, location, "Reduction '%s' could not be applied to a value of "
+                         "type %s", name, getIRTypeName(type));
+        builder->program->errorCount++;
+        return 1;
+    }
+
+    int vector = lowerExpression(builder, argument->right);
+    if (vector == IR_NO_REGISTER) return 1;
+
+    int lanes[IR_VECTOR_MAX_LANES];
+    for (int lane = 0; lane < getIRVectorLanes(type); lane++) {
+        lanes[lane] = accessIRLane(builder, IR_EXTRACT_LANE, laneType, vector, IR_NO_REGISTER, lane, location);
+    }
+
+    if (isMaskReduction) {
+        *value = reduceIRMask(builder, lanes, getIRVectorLanes(type), reduction == 3, location);
+        return 1;
+    }
+
+    // The lanes are reduced by halves, as a horizontal reduction in SIMD registers
+    for (int width = getIRVectorLanes(type) / 2; width >= 1; width /= 2) {
+        for (int lane = 0; lane < width; lane++) {
+            if (reduction == 0) {
+                lanes[lane] = emitIRLane(builder, IR_ADD, laneType, lanes[lane], lanes[lane + width], location);
+            } else lanes[lane] = selectIRLane(builder, lanes[lane], lanes[lane + width], reduction == 1, location);
+        }
+    }
+
+    *value = lanes[0];
+    return 1;
+}
+
+int checkVectorArguments(IRBuilder *builder, ASTNode *node, IRFunction *callee, const int *arguments,
+                         int argumentCount) {
+    ASTNode *list = node->right;
+    int result = 1;
+
+    for (int index = 0; index < argumentCount && index < callee->parameterCount; index++, list = list->right) {
+        IRType type = builder->function->registerTypes[arguments[index]];
+        IRType expected = callee->locals[index].type;
+        if (type == expected || type == IR_TYPE_ANY || (!isIRVectorType(type) && !isIRVectorType(expected))) continue;
+
+        reportDiagnostic(builder->program->diagnostics, node->left->token->location, "Argument '%s' of function '%s' "
+                         "must be %s rather than %s", list->left->left->token->lexeme, callee->name,
+                         getIRTypeName(expected), getIRTypeName(type));
+        result = 0;
+    }
+
+    if (!result) builder->program->errorCount++;
+    return result;
+}
+
+// Gets the register holding a lane of a split register, where a scalar is its only lane
+static int getIRSplitRegister(IRFunction *function, const int *first, int reg, int lane) {
+    if (reg == IR_NO_REGISTER) return IR_NO_REGISTER;
+    return first[reg] + (isIRVectorType(function->registerTypes[reg]) ? lane : 0);
+}
+
+// Appends a copy of an instruction on a lane of its vectors to a block being rebuilt
+static IRInstruction *splitIRInstruction(IRFunction *function, int block, const IRInstruction *instruction,
+                                         const int *first, int lane) {
+    IRType type = isIRVectorType(instruction->type) ? getIRLaneType(instruction->type) : instruction->type;
+    IRInstruction *split = emitIRInstruction(function, block, instruction->opcode, type, instruction->location);
+
+    *split = *instruction;
+    split->type = type;
+    split->destination = getIRSplitRegister(function, first, instruction->destination, lane);
+    split->operands[0] = getIRSplitRegister(function, first, instruction->operands[0], lane);
+    split->operands[1] = getIRSplitRegister(function, first, instruction->operands[1], lane);
+    return split;
+}
+
+// Rebuilds a block of a function on the lanes of its vectors, where the registers keep their old types until the
+// whole function has been rebuilt
+static void scalarizeIRBlock(IRFunction *function, int blockIndex, const int *first, const int *globals) {
+    BasicBlock *block = function->blocks[blockIndex];
+    IRInstruction *instructions = block->instructions;
+    int instructionCount = block->instructionCount;
+    int extraArguments = 0;
+
+    block->instructions = NULL;
+    block->instructionCount = block->instructionCapacity = 0;
+
+    for (int index = 0; index < instructionCount; index++) {
+        IRInstruction *instruction = &instructions[index];
+        int destination = instruction->destination;
+        int lhs = instruction->operands[0];
+        IRType vector = destination >= 0 && isIRVectorType(function->registerTypes[destination])
+                      ? function->registerTypes[destination]
+                      : lhs >= 0 && isIRVectorType(function->registerTypes[lhs]) ? function->registerTypes[lhs]
+                      : IR_TYPE_ANY;
+        int lanes = isIRVectorType(vector) ? getIRVectorLanes(vector) : 1;
+        int lane = instruction->constant.integerValue;
+
+        switch (instruction->opcode) {
+            // Broadcasting, inserting and extracting a lane copy the lanes, where a lane left in place is not copied
+            case IR_SPLAT: case IR_INSERT_LANE: case IR_EXTRACT_LANE: {
+                for (int target = 0; target < lanes; target++) {
+                    int source = instruction->opcode == IR_SPLAT ? first[lhs]
+                               : instruction->opcode == IR_EXTRACT_LANE ? first[lhs] + lane
+                               : target == lane ? first[instruction->operands[1]] : first[lhs] + target;
+                    int copy = instruction->opcode == IR_EXTRACT_LANE ? first[destination]
+                             : first[destination] + target;
+                    if (copy == source) continue;
+
+                    IRInstruction *split = emitIRInstruction(function, blockIndex, IR_COPY,
+                                                             getIRLaneType(vector), instruction->location);
+                    split->destination = copy;
+                    split->operands[0] = source;
+                    if (instruction->opcode == IR_EXTRACT_LANE) break;
+                }
+
+                break;
+            }
+
+            // A global is split like any other local of the entry function
+            case IR_LOAD_GLOBAL: case IR_STORE_GLOBAL: {
+                for (int target = 0; target < lanes; target++) {
+                    splitIRInstruction(function, blockIndex, instruction, first, target)->constant.integerValue =
+                        globals[instruction->constant.integerValue] + target;
+                }
+
+                break;
+            }
+
+            // The arguments of a call come right before it, so the lanes of a vector add to the arguments of the call
+            case IR_ARGUMENT: {
+                for (int target = 0; target < lanes; target++) {
+                    splitIRInstruction(function, blockIndex, instruction, first, target);
+                }
+
+                extraArguments += lanes - 1;
+                break;
+            }
+
+            case IR_CALL: {
+                splitIRInstruction(function, blockIndex, instruction, first, 0)->argumentCount += extraArguments;
+                extraArguments = 0;
+
+                for (int target = 1; target < lanes; target++) {
+                    IRInstruction *split = emitIRInstruction(function, blockIndex, IR_LOAD_RESULT,
+                                                             getIRLaneType(vector), instruction->location);
+                    split->destination = first[destination] + target;
+                    split->constant.integerValue = target;
+                }
+
+                break;
+            }
+
+            case IR_RETURN: {
+                for (int target = 1; target < lanes; target++) {
+                    IRInstruction *split = emitIRInstruction(function, blockIndex, IR_STORE_RESULT,
+                                                             getIRLaneType(vector), instruction->location);
+                    split->operands[0] = first[lhs] + target;
+                    split->constant.integerValue = target;
+                }
+
+                splitIRInstruction(function, blockIndex, instruction, first, 0);
+                break;
+            }
+
+            default: {
+                for (int target = 0; target < lanes; target++) {
+                    splitIRInstruction(function, blockIndex, instruction, first, target);
+                }
+
+                break;
+            }
+        }
+    }
+
+    free(instructions);
+}
+
+// Splits the vectors of a function into their lanes, whose locals and registers follow each other
+static int scalarizeIRFunction(IRFunction *function, const int *globals) {
+    int *first = (int*) malloc((function->registerCount + 1) * sizeof(int));
+    if (!first) return 0;
+
+    int registerCount = 0;
+    for (int reg = 0; reg < function->registerCount; reg++) {
+        first[reg] = registerCount;
+        registerCount += isIRVectorType(function->registerTypes[reg]) ? getIRVectorLanes(function->registerTypes[reg])
+                                                                        : 1;
+    }
+
+    int localCount = function->localCount < function->registerCount ? first[function->localCount] : registerCount;
+    IRLocal *locals = (IRLocal*) malloc((localCount + 1) * sizeof(IRLocal));
+    IRType *types = (IRType*) malloc((registerCount + 1) * sizeof(IRType));
+
+    if (!locals || !types) {
+        free(first); free(locals); free(types);
+        return 0;
+    }
+
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        scalarizeIRBlock(function, blockIndex, first, globals);
+    }
+
+    // Each lane of a vector local is a local of its own, named after the vector and the lane (e.g. "v[0]")
+    int parameterCount = 0;
+
+    for (int local = 0; local < function->localCount; local++) {
+        IRLocal *vector = &function->locals[local];
+        int lanes = isIRVectorType(vector->type) ? getIRVectorLanes(vector->type) : 1;
+
+        for (int lane = 0; lane < lanes; lane++) {
+            IRLocal *split = &locals[first[local] + lane];
+            *split = *vector;
+            split->registerIndex = first[local] + lane;
+
+            if (lanes > 1) {
+                snprintf(split->identifier, sizeof(split->identifier), "%.*s[%c]", LEXEME_LENGTH - 4,
+                         vector->identifier, '0' + lane);
+                split->type = getIRLaneType(vector->type);
+            }
+        }
+
+        if (local < function->parameterCount) parameterCount += lanes;
+    }
+
+    for (int reg = 0; reg < function->registerCount; reg++) {
+        IRType type = function->registerTypes[reg];
+        int lanes = isIRVectorType(type) ? getIRVectorLanes(type) : 1;
+        for (int lane = 0; lane < lanes; lane++) types[first[reg] + lane] = lanes > 1 ? getIRLaneType(type) : type;
+    }
+
+    free(function->locals);
+    free(function->registerTypes);
+    free(function->slots);
+    function->locals = locals;
+    function->localCount = function->localCapacity = localCount;
+    function->registerTypes = types;
+    function->registerCount = registerCount;
+    function->registerCapacity = registerCount + 1;
+    function->parameterCount = parameterCount;
+    function->slots = NULL;
+    if (isIRVectorType(function->returnType)) function->returnType = getIRLaneType(function->returnType);
+
+    free(first);
+    return 1;
+}
+
+int scalarizeIRProgram(IRProgram *program) {
+    int hasVectors = 0;
+
+    for (int index = 0; index < program->functionCount && !hasVectors; index++) {
+        IRFunction *function = program->functions[index];
+        hasVectors = isIRVectorType(function->returnType);
+        for (int reg = 0; reg < function->registerCount; reg++) {
+            hasVectors |= isIRVectorType(function->registerTypes[reg]);
+        }
+    }
+
+    if (!hasVectors) return 1;
+
+    // The globals of every function are the locals of the entry function, which are split first
+    IRFunction *entry = program->functions[0];
+    int *globals = (int*) malloc((entry->localCount + 1) * sizeof(int));
+    if (!globals) return 0;
+
+    for (int local = 0, global = 0; local < entry->localCount; local++) {
+        globals[local] = global;
+        global += isIRVectorType(entry->locals[local].type) ? getIRVectorLanes(entry->locals[local].type) : 1;
+    }
+
+    int result = 1;
+    for (int index = 0; index < program->functionCount && result; index++) {
+        result = scalarizeIRFunction(program->functions[index], globals);
+    }
+
+    free(globals);
+    return result;
+}
@@ -0,0 +1,75 @@
+// diagnostic.h
+//
+// The errors of a compilation, collected from every phase of the compiler. The lexer, the parser, the analyzer and
+// the IR each report an error into the list given to them rather than printing it, so that a phase goes on after an
+// error (e.g. the parser synchronizes at the next delimiter and the analyzer skips the AST_ERROR nodes). Once the
+// compilation has ended, the errors are sorted by their location and displayed at once. A phase without a list
+// prints each error right away, in the same format.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef DIAGNOSTIC_H
+#define DIAGNOSTIC_H
+
+#include <stdio.h>
+#include "token.h"
+
+#define DIAGNOSTIC_MESSAGE_LENGTH    256
+
+/// An error reported by a phase of the compiler.
+typedef struct {
+    Location location;                          /// Where the error has occurred.
+    int sequence;                               /// The order in which the error has been reported.
+    char message[DIAGNOSTIC_MESSAGE_LENGTH];    /// The description of the error, without its location.
+} Diagnostic;
+
+/// The errors reported during a compilation.
+typedef struct {
+    Diagnostic *diagnostics;   /// The errors in the order they have been reported (until sorted).
+    int diagnosticCount;
+    int diagnosticCapacity;
+} DiagnosticList;
+
+/// Initializes an empty list of errors.
+/// @return A pointer to the newly allocated DiagnosticList, or NULL if memory allocation fails.
+///
+DiagnosticList *initDiagnosticList();
+
+/// Reports an error into a list, or prints it right away if there is no list (see displayDiagnostics()).
+///
+/// @param list The list receiving the error, or NULL.
+/// @param location Where the error has occurred.
+/// @param format The description of the error as a format of printf(), without its location.
+///
+void reportDiagnostic(DiagnosticList *list, Location location, const char *format, ...);
+
+/// Sorts the errors by their location, where errors at the same location keep the order they have been reported in.
+/// @param list The list to sort.
+///
+void sortDiagnostics(DiagnosticList *list);
+
+/// Turns the columns of the errors of a list, which are counted in bytes like every Location, into columns counted in
+/// code points, as they are displayed. Only the lines up to the last error are read again.
+///
+/// @param list The list to locate, which is sorted (see sortDiagnostics()).
+/// @param sourceCode The source code the errors have been reported in, still opened.
+///
+void locateDiagnostics(DiagnosticList *list, FILE *sourceCode);
+
+/// Displays each error of a list as '[ERROR] <message> at location <line>:<column>.'
+/// @param list The list to display.
+///
+void displayDiagnostics(const DiagnosticList *list);
+
+/// Removes every error from a list, keeping its memory for the next compilation.
+/// @param list The list to clear.
+///
+void clearDiagnosticList(DiagnosticList *list);
+
+/// Frees a list of errors.
+/// @param list The list to free.
+///
+void freeDiagnosticList(DiagnosticList *list);
+
+#endif
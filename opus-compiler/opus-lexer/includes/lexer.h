@@ -18,6 +18,7 @@
 
 #include <stdio.h>
 #include "token.h"
+#include "diagnostic.h"
 
 /// All possible error types encountered during lexing.
 typedef enum {
@@ -33,6 +34,8 @@ typedef struct {
     Location location;             // Location information for error tracking
     TokenType previousTokenType;   // Store the previous token type for postfix operator (like factorial `!`)
     int isInClosure[3];      // A vector to indicate if the lexer is inside a closure (between [...], (...) or {...})
+    Location closureLocations[3];  // The bracket opening the outermost closure of each kind, to locate it if unclosed
+    DiagnosticList *diagnostics;   // The list receiving the errors, or NULL to print them (see diagnostic.h)
 } Lexer;
 
 /// Reads the next token from the source code.
@@ -62,6 +65,16 @@ Token *parseNumeric(Lexer *lexer, FILE *sourceCode, char *lexeme);
 ///
 int skipCurrenToken(Lexer *lexer, FILE* sourceCode, char *lexeme, char *skippedSequence);
 
+/// Consumes the remaining bytes of a multi-byte character, whose leading byte has been stored in the lexeme.
+///
+/// @param lexer A pointer to the Lexer structure, which maintains the current position in the source file.
+/// @param sourceCode A pointer to the source file to be read.
+/// @param lexeme A character buffer where the leading byte is stored at `lexeme[*position - 1]`.
+/// @param position The position after the leading byte, which is advanced past the consumed bytes.
+/// @return The code point of the multi-byte character.
+///
+int consumeCodePoint(Lexer *lexer, FILE *sourceCode, char *lexeme, int *position);
+
 /// Updates the location of the lexer to the start of the next token and return the current pointing character.
 ///
 /// @param lexer A pointer to the Lexer instance to update.
@@ -93,7 +106,8 @@ int consumeNextCharacter(Lexer *lexer, FILE *sourceCode);
 ///
 int peekNextCharacter(FILE *sourceCode);
 
-/// Report any error occurred during lexing process.
+/// Report any error occurred during lexing process. The end of the file might be read more than once, while each
+/// closure left unclosed is only reported once, at the bracket opening it.
 ///
 /// @param lexer A pointer to the Lexer structure, which maintains the current position in the source file.
 ///
@@ -151,6 +165,16 @@ Token *initUnsafeToken(TokenError tokenError, Lexer *lexer, const char *lexeme);
 ///
 FILE *openOpusSourceCode(const char *filename);
 
+/// Opens an Opus source file that has already been loaded into memory (see loader.h), as a stream over its bytes,
+/// which is validated like a file opened by openOpusSourceCode().
+///
+/// @param filename The name of the file, which is checked and reported.
+/// @param bytes The bytes of the file, which must outlive the stream.
+/// @param length The length of the file in bytes.
+/// @return A pointer to the opened stream (FILE*) if successful, or NULL if an error occurred.
+///
+FILE *openOpusSourceBytes(const char *filename, const char *bytes, size_t length);
+
 /// Checks if the given file to compile has the '.opus' extension.
 ///
 /// @param filename The name of the file to check.
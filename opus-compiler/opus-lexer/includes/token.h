@@ -83,6 +83,10 @@ typedef enum {
     TOKEN_KEYWORD_CLASS,                  // (Experimental) Defines a reference type
     TOKEN_KEYWORD_STRUCT,                 // (Experimental) Defines a value type
     TOKEN_KEYWORD_FUNC,                   // Declares a function.
+    TOKEN_KEYWORD_IMPORT,                 // Imports the exports of another module
+    TOKEN_KEYWORD_SWITCH,                 // Begins a switch statement over a value
+    TOKEN_KEYWORD_CASE,                   // Introduces the values matched by a case of `switch`
+    TOKEN_KEYWORD_DEFAULT,                // Introduces the case of `switch` matching any other value
     TOKEN_KEYWORD_TRUE,                   // Boolean literal representing logical `true`
     TOKEN_KEYWORD_FALSE,                  // Boolean literal representing logical `false`
     TOKEN_STRING_LITERAL,                 // A string literal wrapped by quotes
@@ -101,7 +105,7 @@ typedef enum {
     ERROR_UNTERMINATED_STRING,   // Missing closing double quote
 } TokenError;
 
-/// The location of a token in the source code.
+/// The location of a token in the source code, where the column is counted in bytes (see locateDiagnostics()).
 typedef struct {
     int line, column;   /// The line and the column where the token begins (both starting from 1).
 } Location;
@@ -0,0 +1,83 @@
+// utf8.h
+//
+// UTF-8 support for the Opus lexer. Opus source code is encoded in UTF-8, so that identifiers and string literals
+// may contain any Unicode character. The lexer keeps working on raw bytes (no transcoding to code points), while this
+// header provides the validation of the whole source code before lexing, the decoding of multi-byte sequences, and
+// the classification of identifier characters using the Unicode XID_Start and XID_Continue properties.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define UTF8_CHUNK_SIZE         65536
+#define UTF8_MAX_SEQUENCE       4
+#define UTF8_REPLACEMENT        0xFFFD
+#define UTF8_BYTE_ORDER_MARK    "\xEF\xBB\xBF"
+
+/// Checks if the given byte is a continuation byte (`10xxxxxx`) of a multi-byte sequence.
+/// Continuation bytes never start a new code point, so they are discounted from the column of a displayed error.
+#define isContinuationByte(byte) (((byte) & 0xC0) == 0x80)
+
+/// Validates that a buffer is well-formed UTF-8 as defined by RFC 3629 (no overlong encodings,
+/// no surrogates and no code points above U+10FFFF). ASCII runs are skipped 16 bytes at a time.
+///
+/// @param buffer The bytes to validate.
+/// @param length The number of bytes in the buffer.
+/// @param errorOffset Receives the offset of the first byte of the invalid sequence (may be NULL).
+/// @return 1 (true) if the whole buffer is valid, 0 (false) otherwise.
+///
+int validateUTF8(const unsigned char *buffer, size_t length, size_t *errorOffset);
+
+/// Validates the whole Opus source code up front, so that the lexer could assume well-formed input.
+/// The file is read in chunks of `UTF8_CHUNK_SIZE` bytes, and a sequence split across two chunks is carried over.
+/// On failure, the location of the invalid sequence is computed (only then) and an error is reported.
+///
+/// @param sourceCode A pointer to the opened source code, which is rewound to the beginning on success.
+/// @param filename The name of the file, used for error reporting.
+/// @return 1 (true) if the source code is valid UTF-8, 0 (false) otherwise.
+///
+int validateOpusSourceCode(FILE *sourceCode, const char *filename);
+
+/// Returns the number of bytes of a sequence given its leading byte.
+///
+/// @param leadingByte The first byte of a UTF-8 sequence.
+/// @return The length of the sequence (1 to 4), or 0 if the byte cannot start a sequence.
+///
+int getSequenceLength(int leadingByte);
+
+/// Decodes a single code point from a well-formed UTF-8 sequence.
+///
+/// @param sequence The bytes of the sequence, starting from its leading byte.
+/// @return The decoded code point, or `UTF8_REPLACEMENT` if the leading byte is invalid.
+///
+int decodeCodePoint(const char *sequence);
+
+/// Counts the number of code points of a null-terminated UTF-8 string.
+///
+/// @param string The UTF-8 string to measure.
+/// @return The number of code points in the string.
+///
+int countCodePoints(const char *string);
+
+/// Checks if a code point could start an identifier, that is an ASCII letter, an underscore,
+/// or any code point with the Unicode XID_Start property.
+///
+/// @param codePoint The code point to check.
+/// @return 1 (true) if the code point could start an identifier, 0 (false) otherwise.
+///
+int isIdentifierStart(int codePoint);
+
+/// Checks if a code point could continue an identifier, that is an ASCII letter, a digit, an underscore,
+/// or any code point with the Unicode XID_Continue property.
+///
+/// @param codePoint The code point to check.
+/// @return 1 (true) if the code point could continue an identifier, 0 (false) otherwise.
+///
+int isIdentifierContinue(int codePoint);
+
+#endif
@@ -0,0 +1,112 @@
+// diagnostic.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include "diagnostic.h"
+#include "utf8.h"
+
+DiagnosticList *initDiagnosticList() {
+    return (DiagnosticList*) calloc(1, sizeof(DiagnosticList));
+}
+
+void reportDiagnostic(DiagnosticList *list, Location location, const char *format, ...) {
+    Diagnostic diagnostic;
+    diagnostic.location = location;
+
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(diagnostic.message, DIAGNOSTIC_MESSAGE_LENGTH, format, arguments);
+    va_end(arguments);
+
+    // Without a list (or if it could not grow), the error is not lost but printed at once
+    if (list && list->diagnosticCount == list->diagnosticCapacity) {
+        int capacity = list->diagnosticCapacity ? list->diagnosticCapacity * 2 : 16;
+        Diagnostic *diagnostics = (Diagnostic*) realloc(list->diagnostics, capacity * sizeof(Diagnostic));
+
+        if (diagnostics) {
+            list->diagnostics = diagnostics;
+            list->diagnosticCapacity = capacity;
+        }
+    }
+
+    if (!list || list->diagnosticCount == list->diagnosticCapacity) {
+        printf("[ERROR] %s at location %d:%d.\n", diagnostic.message, location.line, location.column);
+        return;
+    }
+
+    diagnostic.sequence = list->diagnosticCount;
+    list->diagnostics[list->diagnosticCount++] = diagnostic;
+}
+
+static int compareDiagnostics(const void *left, const void *right) {
+    const Diagnostic *lhs = (const Diagnostic*) left;
+    const Diagnostic *rhs = (const Diagnostic*) right;
+
+    if (lhs->location.line != rhs->location.line) return lhs->location.line < rhs->location.line ? -1 : 1;
+    if (lhs->location.column != rhs->location.column) return lhs->location.column < rhs->location.column ? -1 : 1;
+    return (lhs->sequence > rhs->sequence) - (lhs->sequence < rhs->sequence);
+}
+
+void sortDiagnostics(DiagnosticList *list) {
+    if (list && list->diagnosticCount > 1) {
+        qsort(list->diagnostics, list->diagnosticCount, sizeof(Diagnostic), compareDiagnostics);
+    }
+}
+
+void locateDiagnostics(DiagnosticList *list, FILE *sourceCode) {
+    if (!list || list->diagnosticCount == 0 || !sourceCode) return;
+
+    // The errors are visited in the order of the source code, so that it is read once up to the last of them
+    sortDiagnostics(list);
+    rewind(sourceCode);
+
+    // The lexer starts counting after the byte order mark
+    char byteOrderMark[sizeof(UTF8_BYTE_ORDER_MARK)] = {0};
+    if (fread(byteOrderMark, 1, sizeof(byteOrderMark) - 1, sourceCode) != sizeof(byteOrderMark) - 1 ||
+        strcmp(byteOrderMark, UTF8_BYTE_ORDER_MARK) != 0) rewind(sourceCode);
+
+    int line = 1, column = 1, continuations = 0, character = 0;
+
+    for (int index = 0; index < list->diagnosticCount && character != EOF; index++) {
+        Location *location = &list->diagnostics[index].location;
+
+        // Read up to the byte of the error, without going past the end of its line
+        while (line < location->line || (line == location->line && column < location->column)) {
+            character = fgetc(sourceCode);
+            if (character == EOF) break;
+
+            if (character != '\n') { column++; continuations += isContinuationByte(character); }
+            else if (line == location->line) { ungetc(character, sourceCode); break; }
+            else { line++; column = 1; continuations = 0; }
+        }
+
+        // A column of bytes becomes a column of code points once the continuation bytes before it are discounted
+        if (line == location->line) location->column -= continuations;
+    }
+}
+
+void displayDiagnostics(const DiagnosticList *list) {
+    if (!list) return;
+
+    for (int index = 0; index < list->diagnosticCount; index++) {
+        const Diagnostic *diagnostic = &list->diagnostics[index];
+        printf("[ERROR] %s at location %d:%d.\n", diagnostic->message, diagnostic->location.line,
+               diagnostic->location.column);
+    }
+}
+
+void clearDiagnosticList(DiagnosticList *list) {
+    if (list) list->diagnosticCount = 0;
+}
+
+void freeDiagnosticList(DiagnosticList *list) {
+    if (!list) return;
+
+    free(list->diagnostics);
+    free(list);
+}
@@ -7,6 +7,15 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include "lexer.h"
+#include "utf8.h"
+
+// Moves the lexer into or out of a closure, where the bracket entering a closure from outside of any closure of its
+// kind is kept, so that a closure left unclosed (or a closing bracket without its opening one) could be located
+static Token *updateClosure(Lexer *lexer, int closure, int depth, Token *token) {
+    if (token && lexer->isInClosure[closure] == 0) lexer->closureLocations[closure] = token->location;
+    lexer->isInClosure[closure] += depth;
+    return token;
+}
 
 Token *getNextToken(Lexer *lexer, FILE* sourceCode) {
     // Skip whitespaces and comments to reach the first character of the next token
@@ -239,38 +248,38 @@ Token *getNextToken(Lexer *lexer, FILE* sourceCode) {
 
     // If the lexer has reached an opening bracket
     if (character == OPENING_BRACKET) {
-        lexer->isInClosure[BRACKET_CLOSURE]++;
-        return initSafeToken(TOKEN_OPENING_BRACKET, lexer, lexeme);
+        Token *token = initSafeToken(TOKEN_OPENING_BRACKET, lexer, lexeme);
+        return updateClosure(lexer, BRACKET_CLOSURE, 1, token);
     }
 
     // If the lexer has reached an opening bracket
     if (character == CLOSING_BRACKET) {
-        lexer->isInClosure[BRACKET_CLOSURE]--;
-        return initSafeToken(TOKEN_CLOSING_BRACKET, lexer, lexeme);
+        Token *token = initSafeToken(TOKEN_CLOSING_BRACKET, lexer, lexeme);
+        return updateClosure(lexer, BRACKET_CLOSURE, -1, token);
     }
 
     // If the lexer has reached an opening curly bracket
     if (character == OPENING_CURLY_BRACKET) {
-        lexer->isInClosure[CURLY_BRACKET_CLOSURE]++;
-        return initSafeToken(TOKEN_OPENING_CURLY_BRACKET, lexer, lexeme);
+        Token *token = initSafeToken(TOKEN_OPENING_CURLY_BRACKET, lexer, lexeme);
+        return updateClosure(lexer, CURLY_BRACKET_CLOSURE, 1, token);
     }
 
     // If the lexer has reached a closing curly bracket
     if (character == CLOSING_CURLY_BRACKET) {
-        lexer->isInClosure[CURLY_BRACKET_CLOSURE]--;
-        return initSafeToken(TOKEN_CLOSING_CURLY_BRACKET, lexer, lexeme);
+        Token *token = initSafeToken(TOKEN_CLOSING_CURLY_BRACKET, lexer, lexeme);
+        return updateClosure(lexer, CURLY_BRACKET_CLOSURE, -1, token);
     }
 
     // If the lexer has reached an opening square bracket
     if (character == OPENING_SQUARE_BRACKET) {
-        lexer->isInClosure[SQUARE_BRACKET_CLOSURE]++;
-        return initSafeToken(TOKEN_OPENING_SQUARE_BRACKET, lexer, lexeme);
+        Token *token = initSafeToken(TOKEN_OPENING_SQUARE_BRACKET, lexer, lexeme);
+        return updateClosure(lexer, SQUARE_BRACKET_CLOSURE, 1, token);
     }
 
     // If the lexer has reached a closing square bracket
     if (character == CLOSING_SQUARE_BRACKET) {
-        lexer->isInClosure[SQUARE_BRACKET_CLOSURE]--;
-        return initSafeToken(TOKEN_CLOSING_SQUARE_BRACKET, lexer, lexeme);
+        Token *token = initSafeToken(TOKEN_CLOSING_SQUARE_BRACKET, lexer, lexeme);
+        return updateClosure(lexer, SQUARE_BRACKET_CLOSURE, -1, token);
     }
 
     // If the lexer has reached a logical and operator
@@ -317,7 +326,7 @@ Token *getNextToken(Lexer *lexer, FILE* sourceCode) {
         character = consumeNextCharacter(lexer, sourceCode);
         int position = 0;
 
-        while (character != DOUBLE_QUOTE && character != '\0' && character != EOF && position < LEXEME_LENGTH) {
+        while (character != DOUBLE_QUOTE && character != '\0' && character != EOF && position < LEXEME_LENGTH - 1) {
             // Check for the escape character
             if (character == '\\') lexeme[position++] = '\\';
             else lexeme[position++] = (char) character;
@@ -333,22 +342,49 @@ Token *getNextToken(Lexer *lexer, FILE* sourceCode) {
     }
 
     // If an underscore stands alone, it cannot be any operator nor an identifier (but `__` is valid)
+    // Any non-ASCII character followed by it is classified when the identifier is collected
     int nextCharacter = peekNextCharacter(sourceCode);
-    if (character == UNDERSCORE && !isalpha(nextCharacter) && nextCharacter != UNDERSCORE) {
+    if (character == UNDERSCORE && !isalpha(nextCharacter) && nextCharacter != UNDERSCORE && nextCharacter < 0x80) {
         return initUnsafeToken(ERROR_ORPHAN_UNDERSCORE, lexer, lexeme);
     }
 
-    // The first character of an identifier or a keyword must be a letter or an underscore
-    if (isalpha(character) || character == UNDERSCORE) {
-        int position = (int) strlen(lexeme);
+    // A non-ASCII character is collected as a whole code point, since the source code is valid UTF-8, after which the
+    // next character is the one following its continuation bytes
+    int position = 1;
+    int codePoint = character;
+
+    if (character >= 0x80) {
+        codePoint = consumeCodePoint(lexer, sourceCode, lexeme, &position);
+        nextCharacter = peekNextCharacter(sourceCode);
+    }
+
+    // The first character of an identifier or a keyword must be a letter, an underscore, or any XID_Start character
+    if (isIdentifierStart(codePoint)) {
+        TokenError tokenError = ERROR_TOKEN_NONE;
+
+        // Collect all valid characters for an identifier, where ASCII characters take the fast path
+        while (nextCharacter >= 0x80 || isalnum(nextCharacter) || nextCharacter == UNDERSCORE) {
+            // Keep consuming a too long identifier without storing it, since it would cause a buffer overflow
+            if (position + UTF8_MAX_SEQUENCE >= LEXEME_LENGTH) {
+                consumeNextCharacter(lexer, sourceCode);
+                tokenError = ERROR_OVERFLOW;
+            }
+
+            else if (nextCharacter < 0x80) lexeme[position++] = (char) consumeNextCharacter(lexer, sourceCode);
+
+            // A non-ASCII character without the XID_Continue property makes the identifier unrecognizable
+            else {
+                lexeme[position++] = (char) consumeNextCharacter(lexer, sourceCode);
+                if (!isIdentifierContinue(consumeCodePoint(lexer, sourceCode, lexeme, &position)))
+                    tokenError = ERROR_UNRECOGNIZABLE;
+            }
 
-        // Collect all valid characters for an identifier
-        while (isalnum(nextCharacter) || nextCharacter == UNDERSCORE) {
-            lexeme[position++]  = (char) consumeNextCharacter(lexer, sourceCode);
             nextCharacter = peekNextCharacter(sourceCode);
         }
 
         lexeme[position] = '\0';
+        if (tokenError != ERROR_TOKEN_NONE) return initUnsafeToken(tokenError, lexer, lexeme);
+
         TokenType tokenType = TOKEN_IDENTIFIER;
 
         // Compare the collected lexeme to known keywords
@@ -364,6 +400,10 @@ Token *getNextToken(Lexer *lexer, FILE* sourceCode) {
         else if (strcmp(lexeme, "class") == 0) { tokenType = TOKEN_KEYWORD_CLASS; }
         else if (strcmp(lexeme, "struct") == 0) { tokenType = TOKEN_KEYWORD_STRUCT; }
         else if (strcmp(lexeme, "func") == 0) { tokenType = TOKEN_KEYWORD_FUNC; }
+        else if (strcmp(lexeme, "import") == 0) { tokenType = TOKEN_KEYWORD_IMPORT; }
+        else if (strcmp(lexeme, "switch") == 0) { tokenType = TOKEN_KEYWORD_SWITCH; }
+        else if (strcmp(lexeme, "case") == 0) { tokenType = TOKEN_KEYWORD_CASE; }
+        else if (strcmp(lexeme, "default") == 0) { tokenType = TOKEN_KEYWORD_DEFAULT; }
         else if (strcmp(lexeme, "true") == 0) { tokenType = TOKEN_KEYWORD_TRUE; }
         else if (strcmp(lexeme, "false") == 0) { tokenType = TOKEN_KEYWORD_FALSE; }
 
@@ -437,6 +477,17 @@ int skipCurrenToken(Lexer *lexer, FILE* sourceCode, char *lexeme, char *skippedS
     return peekNextCharacter(sourceCode);
 }
 
+int consumeCodePoint(Lexer *lexer, FILE *sourceCode, char *lexeme, int *position) {
+    int start = *position - 1;
+    int length = getSequenceLength((unsigned char) lexeme[start]);
+
+    // The source code has been validated, so all continuation bytes are guaranteed to follow the leading byte
+    for (int index = 1; index < length; index++) lexeme[(*position)++] = (char) consumeNextCharacter(lexer, sourceCode);
+
+    lexeme[*position] = '\0';
+    return decodeCodePoint(lexeme + start);
+}
+
 int locateStartOfNextToken(Lexer *lexer, FILE *sourceCode) {
     int character = consumeNextCharacter(lexer, sourceCode);
 
@@ -463,6 +514,7 @@ int locateStartOfNextLine(Lexer *lexer, FILE *sourceCode) {
 int consumeNextCharacter(Lexer *lexer, FILE *sourceCode) {
     int character = fgetc(sourceCode);
 
+    // Columns are counted in bytes, and turned into code points only for the errors displayed (see locateDiagnostics())
     if (character != '\n') lexer->location.column++;
     else { lexer->location.line++; lexer->location.column = 1; }
 
@@ -477,15 +529,22 @@ int peekNextCharacter(FILE *sourceCode) {
 }
 
 void reportLexerError(Lexer *lexer) {
-    if (lexer->isInClosure[BRACKET_CLOSURE] != 0) lexer->lexerError = ERROR_UNCLOSED_BRACKET;
-    if (lexer->isInClosure[CURLY_BRACKET_CLOSURE] != 0) lexer->lexerError = ERROR_UNCLOSED_CURLY_BRACKET;
-    if (lexer->isInClosure[SQUARE_BRACKET_CLOSURE] != 0) lexer->lexerError = ERROR_UNCLOSED_SQUARE_BRACKET;
-
-    switch (lexer->lexerError) {
-        case ERROR_UNCLOSED_BRACKET: printf("[ERROR]: Unclosed bracket occurs!"); break;
-        case ERROR_UNCLOSED_CURLY_BRACKET: printf("[ERROR]: Unclosed curly bracket occurs!"); break;
-        case ERROR_UNCLOSED_SQUARE_BRACKET: printf("[ERROR]: Unclosed square bracket occurs!"); break;
-        default:;
+    if (lexer->lexerError != ERROR_LEXER_NONE) return;
+
+    if (lexer->isInClosure[BRACKET_CLOSURE] != 0) {
+        lexer->lexerError = ERROR_UNCLOSED_BRACKET;
+        reportDiagnostic(lexer->diagnostics, lexer->closureLocations[BRACKET_CLOSURE], "Unclosed bracket");
+    }
+
+    if (lexer->isInClosure[CURLY_BRACKET_CLOSURE] != 0) {
+        lexer->lexerError = ERROR_UNCLOSED_CURLY_BRACKET;
+        reportDiagnostic(lexer->diagnostics, lexer->closureLocations[CURLY_BRACKET_CLOSURE], "Unclosed curly bracket");
+    }
+
+    if (lexer->isInClosure[SQUARE_BRACKET_CLOSURE] != 0) {
+        lexer->lexerError = ERROR_UNCLOSED_SQUARE_BRACKET;
+        reportDiagnostic(lexer->diagnostics, lexer->closureLocations[SQUARE_BRACKET_CLOSURE],
+                         "Unclosed square bracket");
     }
 }
 
@@ -509,7 +568,12 @@ Lexer *initLexer() {
     lexer->lexerError = ERROR_LEXER_NONE;
     lexer->location = location;
     lexer->previousTokenType = TOKEN_ERROR;
-    for (int index = 0; index < 3; index++) lexer->isInClosure[index] = 0;
+    lexer->diagnostics = NULL;
+
+    for (int index = 0; index < 3; index++) {
+        lexer->isInClosure[index] = 0;
+        lexer->closureLocations[index] = location;
+    }
 
     return lexer;
 }
@@ -522,12 +586,12 @@ Token *initSafeToken(TokenType tokenType, Lexer *lexer, const char *lexeme) {
     token->tokenType = tokenType;
 
     int lexemeLength = (int) strlen(lexeme);
-    strncpy(token->lexeme, lexeme, lexemeLength);
+    memcpy(token->lexeme, lexeme, lexemeLength);
     token->lexeme[lexemeLength] = '\0';
 
-    // Get the beginning location of the current token
+    // Get the beginning location of the current token, where columns are counted in bytes
     token->location.line = lexer->location.line;
-    token->location.column = lexer->location.column - (int) lexemeLength + 1;
+    token->location.column = lexer->location.column - lexemeLength + 1;
 
     lexer->previousTokenType = tokenType;
     return token;
@@ -541,13 +605,13 @@ Token *initUnsafeToken(TokenError tokenError, Lexer *lexer, const char *lexeme)
     token->tokenError = tokenError;
 
     int lexemeLength = (int) strlen(lexeme);
-    strncpy(token->lexeme, lexeme, lexemeLength);
+    memcpy(token->lexeme, lexeme, lexemeLength);
     token->lexeme[lexemeLength] = '\0';
 
     // Get the beginning location of the current token
     token->location.line = lexer->location.line;
 
-    int column = lexer->location.column - (int) lexemeLength + 1;
+    int column = lexer->location.column - lexemeLength + 1;
     if (tokenError == ERROR_UNTERMINATED_STRING) column = lexer->location.column - 1;
     token->location.column = column;
 
@@ -555,6 +619,23 @@ Token *initUnsafeToken(TokenError tokenError, Lexer *lexer, const char *lexeme)
     return token;
 }
 
+// Validates an opened source code and skips its byte order mark, or closes it if it is not valid
+static FILE *prepareOpusSourceCode(FILE *file, const char *filename) {
+    // Validate the encoding of the whole source code up front, so that the lexer could assume valid UTF-8
+    if (!validateOpusSourceCode(file, filename)) {
+        fclose(file);
+        return NULL;
+    }
+
+    // Skip the byte order mark if presents, since it is not a part of the source code
+    char byteOrderMark[sizeof(UTF8_BYTE_ORDER_MARK)] = {0};
+    if (fread(byteOrderMark, 1, sizeof(byteOrderMark) - 1, file) != sizeof(byteOrderMark) - 1 ||
+        strcmp(byteOrderMark, UTF8_BYTE_ORDER_MARK) != 0) rewind(file);
+
+    // Return the pointer to the file only if the file is successfully loaded
+    return file;
+}
+
 FILE *openOpusSourceCode(const char *filename) {
     // Check if the file is Opus source code (with .opus extension)
     if (!isOpusSourceCode(filename)) {
@@ -570,8 +651,28 @@ FILE *openOpusSourceCode(const char *filename) {
         return NULL;
     }
 
-    // Return the pointer to the file only if the file is successfully loaded
-    return file;
+    return prepareOpusSourceCode(file, filename);
+}
+
+FILE *openOpusSourceBytes(const char *filename, const char *bytes, size_t length) {
+    if (!isOpusSourceCode(filename)) {
+        fprintf(stderr, "[FileTypeError]: File '%s' is not the Opus source code. (Must be .opus files)\n", filename);
+        return NULL;
+    }
+
+    // The bytes are read as a stream in memory, except that an empty stream could not be opened on every platform
+#ifndef _WIN32
+    FILE *file = length > 0 ? fmemopen((void*) bytes, length, READONLY_ACCESS) : NULL;
+#else
+    FILE *file = length > 0 ? tmpfile() : NULL;
+    if (file && fwrite(bytes, 1, length, file) == length) rewind(file);
+    else if (file) {
+        fclose(file);
+        file = NULL;
+    }
+#endif
+
+    return file ? prepareOpusSourceCode(file, filename) : openOpusSourceCode(filename);
 }
 
 int isOpusSourceCode(const char *filename) {
@@ -630,6 +731,10 @@ void displayToken(Token token) {
         case TOKEN_KEYWORD_CLASS:
         case TOKEN_KEYWORD_STRUCT:
         case TOKEN_KEYWORD_FUNC:
+        case TOKEN_KEYWORD_IMPORT:
+        case TOKEN_KEYWORD_SWITCH:
+        case TOKEN_KEYWORD_CASE:
+        case TOKEN_KEYWORD_DEFAULT:
         case TOKEN_KEYWORD_TRUE:
         case TOKEN_KEYWORD_FALSE: printf("Keyword"); break;
         case TOKEN_STRING_LITERAL: printf("StringLiteral"); break;
@@ -0,0 +1,157 @@
+// document.h
+//
+// The documents opened by the language server, kept in memory with their AST and their analysis. Every top-level
+// statement owns its AST and its tokens, and an edit only marks the statements whose lines it touches. Analyzing the
+// document again then only parses the edited statements (from the beginning of the first one to the end of the last
+// one) and splices them into the program, while the statements after them are only moved by the lines inserted or
+// deleted. The program is then analyzed incrementally (see query.h), so the analysis only executes the statements
+// depending on the edit. A statement failing to parse stays edited, so that its errors are reported again by the next
+// analysis, while the rest of the program (and the AST of the statement up to its error) is analyzed all the same.
+// The whole document is parsed again if the edited statements do not parse on their own, e.g. once an edit has left
+// a bracket unclosed.
+//
+// Positions are counted the way the Language Server Protocol counts them, that is lines and UTF-16 code units from 0,
+// while a Location of the compiler counts lines from 1 and its columns in bytes (see token.h).
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef DOCUMENT_H
+#define DOCUMENT_H
+
+#include <stddef.h>
+#include "parser.h"
+#include "query.h"
+#include "interface.h"
+
+/// A position in a document, as counted by the Language Server Protocol.
+typedef struct {
+    int line;        /// The line, starting from 0.
+    int character;   /// The UTF-16 code units before the position in its line.
+} DocumentPosition;
+
+/// A top-level statement of a document.
+typedef struct {
+    ASTNode *program;    /// The AST_PROGRAM node linking the statement into the program, whose left is the statement.
+    int line;            /// The line where the statement begins.
+    int lineShift;       /// The lines the statement has moved since its tokens were located.
+    int isEdited;        /// Whether an edit has touched the lines of the statement since it was parsed.
+    int hasErrors;       /// Whether the statement has failed to parse.
+    Token **tokens;      /// The tokens read while parsing the statement, which it owns.
+    int tokenCount;
+} DocumentStatement;
+
+/// A document opened by the client.
+typedef struct {
+    char *uri;                          /// The URI identifying the document.
+    char *path;                         /// The path of the file, or NULL if the URI is not a local file.
+    int version;                        /// The version given by the client, increased by each change.
+
+    char *text;                         /// The content of the document, terminated by '\0'.
+    size_t length;
+    size_t capacity;
+    size_t *lineOffsets;                /// The offset where each line begins, from line 1.
+    int lineCount;
+    int lineCapacity;
+
+    DocumentStatement *statements;      /// The top-level statements in order.
+    int statementCount;
+    int statementCapacity;
+    ASTNode *terminal;                  /// The empty AST_PROGRAM node ending the program.
+    int isParsed;                       /// Whether the statements are the parse of the text, with its brackets closed.
+    int parsedCount;                    /// The number of statements parsed by the last analysis.
+
+    QueryDatabase *database;            /// The memoized analysis of the statements.
+    SymbolTable *symbolTable;           /// The top-level symbols after the last analysis, or NULL if it has failed.
+    DiagnosticList *diagnostics;        /// The errors of the last analysis, sorted by their location.
+    ModuleInterface **interfaces;       /// The interfaces of the imported modules found next to the document.
+    int interfaceCount;
+} Document;
+
+/// Opens a document.
+///
+/// @param uri The URI of the document.
+/// @param text The content of the document.
+/// @param length The length of the content in bytes.
+/// @param version The version of the document.
+/// @return The document, or NULL if memory allocation fails.
+///
+Document *openDocument(const char *uri, const char *text, size_t length, int version);
+
+/// Replaces a range of a document with a text, or the whole document if no range is given. The positions are
+/// clamped to the document, and the statements whose lines the range touches are marked as edited.
+///
+/// @param document The document to edit.
+/// @param start The start of the range, or NULL to replace the whole document.
+/// @param end The end of the range, or NULL to replace the whole document.
+/// @param text The text replacing the range.
+/// @param length The length of the text in bytes.
+/// @return 1 (True) if the document has been edited, or 0 (False) if memory allocation fails.
+///
+int editDocument(Document *document, const DocumentPosition *start, const DocumentPosition *end, const char *text,
+                 size_t length);
+
+/// Parses the edited statements of a document (or the whole document) and analyzes it incrementally, even if some
+/// statements fail to parse. The errors of every phase are collected into the diagnostics of the document.
+///
+/// @param document The document to analyze.
+/// @return 1 (True) if the document has been parsed and analyzed, or 0 (False) if it has failed to parse.
+///
+int analyzeDocument(Document *document);
+
+/// Reads the interfaces of the modules a document imports again, e.g. once the document has been saved.
+/// @param document The document.
+///
+void reloadDocumentInterfaces(Document *document);
+
+/// Converts a position into an offset of the text, where a position past the end of its line is at the end of it.
+///
+/// @param document The document.
+/// @param position The position.
+/// @return The offset of the position.
+///
+size_t getDocumentOffset(const Document *document, DocumentPosition position);
+
+/// Converts an offset of the text into a position.
+///
+/// @param document The document.
+/// @param offset The offset.
+/// @return The position of the offset.
+///
+DocumentPosition getDocumentPosition(const Document *document, size_t offset);
+
+/// Converts the location of a token into an offset of the text. A location before the first column (e.g. of a
+/// delimiter, which the lexer locates on the next line) is at the end of the previous line.
+///
+/// @param document The document.
+/// @param location The location, as given by the lexer.
+/// @return The offset of the location.
+///
+size_t getLocationOffset(const Document *document, Location location);
+
+/// Finds the deepest AST node whose token covers a position, together with its parent and its top-level statement.
+///
+/// @param document The document.
+/// @param position The position.
+/// @param parent Receives the parent of the node, or NULL for a top-level statement.
+/// @param statement Receives the top-level statement containing the node.
+/// @return The node found, or NULL if no token covers the position.
+///
+ASTNode *findDocumentNode(const Document *document, DocumentPosition position, ASTNode **parent, ASTNode **statement);
+
+/// Finds the top-level declaration or function definition of a name.
+///
+/// @param document The document.
+/// @param identifier The name declared.
+/// @param location The location of the declaration (see Symbol.declarationLocation), or NULL for a function.
+/// @return The declaration or the function definition (whose left is the identifier declared), or NULL if the name
+///         is not declared by the document.
+///
+ASTNode *findDocumentDeclaration(const Document *document, const char *identifier, const Location *location);
+
+/// Closes a document and frees everything it owns.
+/// @param document The document to close.
+///
+void closeDocument(Document *document);
+
+#endif
@@ -0,0 +1,107 @@
+// json.h
+//
+// A minimal JSON reader and writer for the messages of the Language Server Protocol. A message is parsed into a tree
+// of JsonValue, whose members are looked up by a dotted path (e.g. "params.textDocument.uri"), and a message is
+// written into a JsonWriter, which escapes strings and grows as needed.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef JSON_H
+#define JSON_H
+
+#include <stddef.h>
+
+#define JSON_MAX_DEPTH   128
+
+/// The type of a JSON value.
+typedef enum {
+    JSON_NULL,
+    JSON_BOOLEAN,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT,
+} JsonType;
+
+/// A JSON value, where an array or an object keeps its items in order.
+typedef struct JsonValue {
+    JsonType type;
+    double number;              /// The value of a number, or 1 (True) and 0 (False) for a boolean.
+    char *string;               /// The UTF-8 content of a string, terminated by '\0'.
+    size_t length;              /// The length of the string in bytes, which could contain '\0'.
+    char **keys;                /// The key of each item of an object.
+    struct JsonValue **items;   /// The items of an array or the values of an object.
+    int count;
+    int capacity;
+} JsonValue;
+
+/// A growable buffer a JSON message is written into.
+typedef struct {
+    char *bytes;
+    size_t length;
+    size_t capacity;
+    int hasFailed;              /// Whether memory allocation has failed, in which case the message is incomplete.
+} JsonWriter;
+
+/// Parses a JSON text.
+///
+/// @param text The JSON text, which does not need to be terminated by '\0'.
+/// @param length The length of the text in bytes.
+/// @return The parsed value, or NULL if the text is not valid JSON or memory allocation fails.
+///
+JsonValue *parseJson(const char *text, size_t length);
+
+/// Looks up a value by a path of object keys separated by '.'.
+///
+/// @param value The value to start from.
+/// @param path The path, e.g. "params.position.line".
+/// @return The value found, or NULL if any key along the path is missing.
+///
+JsonValue *getJsonPath(const JsonValue *value, const char *path);
+
+/// Gets the string at a path.
+/// @return The string, or NULL if it is missing or not a string.
+///
+const char *getJsonString(const JsonValue *value, const char *path);
+
+/// Gets the integer at a path.
+/// @return The number truncated to an integer, or the fallback if it is missing or not a number.
+///
+int getJsonInteger(const JsonValue *value, const char *path, int fallback);
+
+/// Frees a JSON value and everything it contains.
+/// @param value The value to free.
+///
+void freeJson(JsonValue *value);
+
+/// Appends raw text to a JSON message, which must already be valid JSON at that point.
+///
+/// @param writer The writer to append to.
+/// @param text The text, terminated by '\0'.
+///
+void writeJsonRaw(JsonWriter *writer, const char *text);
+
+/// Appends a string as a quoted and escaped JSON string.
+///
+/// @param writer The writer to append to.
+/// @param string The UTF-8 string.
+/// @param length The length of the string in bytes.
+///
+void writeJsonString(JsonWriter *writer, const char *string, size_t length);
+
+/// Appends an integer as a JSON number.
+///
+/// @param writer The writer to append to.
+/// @param number The integer.
+///
+void writeJsonInteger(JsonWriter *writer, long number);
+
+/// Appends a parsed value, e.g. to echo the id of a request in its response.
+///
+/// @param writer The writer to append to.
+/// @param value The value, where NULL is written as null.
+///
+void writeJsonValue(JsonWriter *writer, const JsonValue *value);
+
+#endif
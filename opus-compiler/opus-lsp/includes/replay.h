@@ -0,0 +1,35 @@
+// replay.h
+//
+// Replays a recorded editing session against the language server, to measure how long each message takes to handle.
+// A session is a file with one JSON-RPC message per line, as written by 'opus-lsp --record'. The time spent on each
+// message is grouped by its method, and the median, the 95th percentile and the maximum of each method are reported.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+#include "server.h"
+
+#define REPLAY_MAX_METHODS    32
+
+/// The times spent on the messages of a method.
+typedef struct {
+    char method[64];         /// The method of the messages.
+    double *milliseconds;    /// The time spent on each message.
+    int count;
+    int capacity;
+} ReplayTiming;
+
+/// Replays a session against a language server, and reports the time spent on each method.
+///
+/// @param server The language server, whose output receives the responses.
+/// @param sessionPath The path of the session to replay.
+/// @param report The stream the timings are reported to.
+/// @return 1 (True) if the whole session has been replayed, or 0 (False) if it could not be read.
+///
+int replayLanguageServerSession(LanguageServer *server, const char *sessionPath, FILE *report);
+
+#endif
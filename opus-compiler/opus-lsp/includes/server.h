@@ -0,0 +1,66 @@
+// server.h
+//
+// A language server for the Opus programming language, speaking the Language Server Protocol over the standard input
+// and output. Each message is a JSON-RPC request or notification, framed by a 'Content-Length' header. The server
+// keeps the opened documents in sync with the incremental edits of the client, publishes the errors of the lexer, the
+// parser and the analyzer after each change, shows the type of a symbol on hover, and finds where a symbol is declared.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdio.h>
+#include "document.h"
+
+#define LSP_HEADER_LENGTH              256
+#define LSP_MAX_MESSAGE_LENGTH         (64 * 1024 * 1024)
+
+#define LSP_ERROR_PARSE                -32700
+#define LSP_ERROR_INVALID_REQUEST      -32600
+#define LSP_ERROR_METHOD_NOT_FOUND     -32601
+#define LSP_ERROR_INVALID_PARAMS       -32602
+#define LSP_ERROR_NOT_INITIALIZED      -32002
+
+/// The state of the language server.
+typedef struct {
+    FILE *output;             /// Where the messages to the client are written.
+    Document **documents;     /// The documents opened by the client.
+    int documentCount;
+    int documentCapacity;
+    int isInitialized;        /// Whether the client has sent 'initialize'.
+    int isShutdown;           /// Whether the client has sent 'shutdown', after which only 'exit' is expected.
+    int hasExited;            /// Whether the client has sent 'exit'.
+} LanguageServer;
+
+/// Initializes a language server without any document.
+///
+/// @param output The stream the messages to the client are written to.
+/// @return A pointer to the newly allocated LanguageServer, or NULL if memory allocation fails.
+///
+LanguageServer *initLanguageServer(FILE *output);
+
+/// Reads the next message from the client, that is its headers and then its content.
+///
+/// @param input The stream the messages are read from.
+/// @param length Receives the length of the content.
+/// @return The content of the message, which the caller frees, or NULL once the input has ended or is malformed.
+///
+char *readLanguageServerMessage(FILE *input, size_t *length);
+
+/// Handles a message from the client, and writes the response (and any notification) to the output.
+///
+/// @param server The language server.
+/// @param message The content of the message.
+/// @param length The length of the content.
+/// @return 1 (True) to keep serving, or 0 (False) once the client has sent 'exit'.
+///
+int handleLanguageServerMessage(LanguageServer *server, const char *message, size_t length);
+
+/// Frees a language server and closes its documents.
+/// @param server The language server to free.
+///
+void freeLanguageServer(LanguageServer *server);
+
+#endif
@@ -0,0 +1,107 @@
+// main.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "server.h"
+#include "replay.h"
+
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define fdopen _fdopen
+#define STDOUT_FILENO 1
+#define NULL_DEVICE "NUL"
+#else
+#include <unistd.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// Moves the standard output aside for the protocol, while whatever the compiler prints (e.g. the values propagated by
+// the analyzer) is discarded, since its errors are collected into the diagnostics of each document instead
+static FILE *openProtocolStream() {
+    fflush(stdout);
+    int descriptor = dup(STDOUT_FILENO);
+    FILE *protocol = descriptor >= 0 ? fdopen(descriptor, "wb") : NULL;
+
+    if (protocol && !freopen(NULL_DEVICE, "wb", stdout)) {
+        fclose(protocol);
+        return NULL;
+    }
+
+    return protocol;
+}
+
+// Appends a message to a session as one line, where a line break in the JSON can only be whitespace
+static void recordMessage(FILE *session, char *message, size_t length) {
+    for (size_t index = 0; index < length; index++) {
+        if (message[index] == '\r' || message[index] == '\n') message[index] = ' ';
+    }
+
+    fwrite(message, 1, length, session);
+    fputc('\n', session);
+    fflush(session);
+}
+
+int main(int argc, char *argv[]) {
+    const char *recordPath = NULL, *replayPath = NULL;
+
+    for (int index = 1; index < argc; index++) {
+        if (strncmp(argv[index], "--record=", 9) == 0) recordPath = argv[index] + 9;
+        else if (strncmp(argv[index], "--replay=", 9) == 0) replayPath = argv[index] + 9;
+        else if (strcmp(argv[index], "--stdio") == 0) continue;
+        else {
+            fprintf(stderr, "Usage: %s [--stdio] [--record=<session.jsonl>] [--replay=<session.jsonl>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE *protocol = openProtocolStream();
+
+    if (!protocol) {
+        fprintf(stderr, "[ServerError]: Cannot move the standard output aside for the protocol.\n");
+        return EXIT_FAILURE;
+    }
+
+    // A replayed session only reports its timings, while its responses are discarded
+    if (replayPath) {
+        FILE *discarded = fopen(NULL_DEVICE, "wb");
+        LanguageServer *server = discarded ? initLanguageServer(discarded) : NULL;
+        int isReplayed = server && replayLanguageServerSession(server, replayPath, protocol);
+
+        freeLanguageServer(server);
+        if (discarded) fclose(discarded);
+        fclose(protocol);
+        return isReplayed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    FILE *session = recordPath ? fopen(recordPath, "wb") : NULL;
+
+    if (recordPath && !session) {
+        fprintf(stderr, "[ServerError]: Cannot record the session to '%s'.\n", recordPath);
+        return EXIT_FAILURE;
+    }
+
+    LanguageServer *server = initLanguageServer(protocol);
+    if (!server) return EXIT_FAILURE;
+
+    int isServing = 1;
+    size_t length;
+
+    for (char *message; isServing && (message = readLanguageServerMessage(stdin, &length));) {
+        if (session) recordMessage(session, message, length);
+        isServing = handleLanguageServerMessage(server, message, length);
+        free(message);
+    }
+
+    // The client is expected to shut the server down before it exits
+    int isShutdown = server->isShutdown;
+    freeLanguageServer(server);
+    if (session) fclose(session);
+    fclose(protocol);
+
+    return isShutdown ? EXIT_SUCCESS : EXIT_FAILURE;
+}
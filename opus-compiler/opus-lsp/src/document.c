@@ -0,0 +1,732 @@
+// document.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "document.h"
+#include "module.h"
+#include "utf8.h"
+
+#define FILE_URI_SCHEME   "file://"
+
+// Opens a stream reading a text in memory, which the lexer reads like a file
+static FILE *openTextStream(const char *text, size_t length) {
+#ifdef _WIN32
+    FILE *stream = tmpfile();
+    if (!stream) return NULL;
+
+    if (fwrite(text, 1, length, stream) != length) {
+        fclose(stream);
+        return NULL;
+    }
+
+    rewind(stream);
+    return stream;
+#else
+    return fmemopen((void*) text, length, "r");
+#endif
+}
+
+// Decodes the path of a local file from its URI (e.g. 'file:///home/a%20b.opus' into '/home/a b.opus')
+static char *decodeDocumentPath(const char *uri) {
+    if (strncmp(uri, FILE_URI_SCHEME, strlen(FILE_URI_SCHEME)) != 0) return NULL;
+    const char *encoded = uri + strlen(FILE_URI_SCHEME);
+
+    char *path = (char*) malloc(strlen(encoded) + 1);
+    if (!path) return NULL;
+    size_t length = 0;
+
+    for (const char *character = encoded; *character; character++) {
+        unsigned value;
+
+        if (*character == '%' && character[1] && character[2] && sscanf(character + 1, "%2x", &value) == 1) {
+            path[length++] = (char) value;
+            character += 2;
+        }
+
+        else path[length++] = *character;
+    }
+
+    path[length] = '\0';
+
+#ifdef _WIN32
+    // A drive letter follows the slash of the URI (e.g. 'file:///C:/a.opus')
+    if (path[0] == '/' && path[1] && path[2] == ':') memmove(path, path + 1, length);
+#endif
+
+    return path;
+}
+
+// Finds where each line of the text begins
+static int indexDocumentLines(Document *document) {
+    document->lineCount = 0;
+    size_t offset = 0;
+
+    while (1) {
+        if (document->lineCount == document->lineCapacity) {
+            int capacity = document->lineCapacity ? document->lineCapacity * 2 : 64;
+            size_t *lineOffsets = (size_t*) realloc(document->lineOffsets, capacity * sizeof(size_t));
+            if (!lineOffsets) return 0;
+
+            document->lineOffsets = lineOffsets;
+            document->lineCapacity = capacity;
+        }
+
+        document->lineOffsets[document->lineCount++] = offset;
+
+        const char *newline = memchr(document->text + offset, '\n', document->length - offset);
+        if (!newline) return 1;
+        offset = (size_t) (newline - document->text) + 1;
+    }
+}
+
+// Returns the offset where a line (from 1) ends, before its newline (and the carriage return before it)
+static size_t getLineEnd(const Document *document, int line) {
+    size_t end = line >= document->lineCount ? document->length : document->lineOffsets[line] - 1;
+    if (end > document->lineOffsets[line - 1] && document->text[end - 1] == '\r') end--;
+    return end;
+}
+
+// Returns the offset where a line (from 1) begins, after the byte order mark of the first line
+static size_t getLineStart(const Document *document, int line) {
+    if (line > document->lineCount) return document->length;
+
+    size_t offset = document->lineOffsets[line - 1];
+    if (line == 1 && document->length >= 3 && strncmp(document->text, UTF8_BYTE_ORDER_MARK, 3) == 0) offset = 3;
+    return offset;
+}
+
+// Returns the length of the character at an offset, where an invalid byte is a character of its own
+static size_t getCharacterLength(const Document *document, size_t offset) {
+    size_t length = (size_t) getSequenceLength((unsigned char) document->text[offset]);
+    if (length == 0 || offset + length > document->length) length = 1;
+    return length;
+}
+
+static void freeDocumentStatement(DocumentStatement *statement) {
+    statement->program->right = NULL;
+    freeAST(statement->program);
+
+    for (int index = 0; index < statement->tokenCount; index++) free(statement->tokens[index]);
+    free(statement->tokens);
+}
+
+// Moves the tokens of a statement by the lines inserted or deleted before it since it was parsed
+static void shiftDocumentStatement(DocumentStatement *statement) {
+    if (statement->lineShift == 0) return;
+
+    for (int index = 0; index < statement->tokenCount; index++) {
+        statement->tokens[index]->location.line += statement->lineShift;
+    }
+
+    statement->lineShift = 0;
+}
+
+// Links the statements into a program, which ends with the terminal node like a parsed program
+static void linkDocumentStatements(Document *document) {
+    for (int index = 0; index < document->statementCount; index++) {
+        document->statements[index].program->right = index + 1 < document->statementCount
+            ? document->statements[index + 1].program : document->terminal;
+    }
+}
+
+
+// Returns the last line of a statement, that is the line of its last token except for the delimiters read after it
+static int getStatementEndLine(const DocumentStatement *statement) {
+    for (int index = statement->tokenCount - 1; index >= 0; index--) {
+        Token *token = statement->tokens[index];
+        if (token->tokenType != TOKEN_DELIMITER && token->tokenType != TOKEN_EOF)
+            return token->location.line + statement->lineShift;
+    }
+
+    return statement->tokenCount > 0 ? statement->line : INT_MAX;
+}
+
+// Parses the statements of a text one by one like parseProgram(), so that each statement owns the tokens read while
+// parsing it, where the tokens read before the first statement belong to it and the delimiters after a statement too.
+// A statement failing to parse is marked as edited, so that it is parsed again (and its errors reported again) by
+// the next analysis, and the parse has overrun the text if such a statement has been parsed up to its end.
+static int parseDocumentStatements(const char *text, size_t length, int line, DiagnosticList *diagnostics,
+                                   DocumentStatement **statements, int *statementCount, int *isClosed,
+                                   int *hasOverrun) {
+    *statements = NULL;
+    *statementCount = 0;
+    *isClosed = 1;
+    *hasOverrun = 0;
+    if (length == 0) return 1;
+
+    FILE *stream = openTextStream(text, length);
+    Parser *parser = stream ? initParser() : NULL;
+
+    if (!parser) {
+        if (stream) fclose(stream);
+        return 0;
+    }
+
+    parser->lexer->location.line = line;
+    parser->diagnostics = parser->lexer->diagnostics = diagnostics;
+    trackParserTokens(parser);
+    parser->currentToken = advanceParser(parser, stream);
+
+    int capacity = 0, isParsed = 1;
+
+    while (parser->currentToken && !matchTokenType(parser, TOKEN_EOF)) {
+        if (matchTokenType(parser, TOKEN_DELIMITER)) {
+            parser->currentToken = advanceParser(parser, stream);
+            continue;
+        }
+
+        if (*statementCount == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            DocumentStatement *grown = (DocumentStatement*) realloc(*statements, capacity * sizeof(DocumentStatement));
+
+            if (!grown) {
+                isParsed = 0;
+                break;
+            }
+
+            *statements = grown;
+        }
+
+        // The first token of the statement is the current one, whose index is kept until the tokens are assigned
+        DocumentStatement *statement = &(*statements)[(*statementCount)++];
+        statement->line = parser->currentToken->location.line;
+        statement->lineShift = 0;
+        statement->isEdited = statement->hasErrors = 0;
+        statement->tokens = NULL;
+        statement->tokenCount = parser->tokens ? parser->tokenCount - 1 : 0;
+
+        statement->program = initASTNode(AST_PROGRAM, NULL);
+
+        if (!statement->program) {
+            isParsed = 0;
+            break;
+        }
+
+        // The parser only reports its errors, so that it goes on with the next statement like parseProgram()
+        parser->parseError = PARSE_ERROR_NONE;
+        statement->program->left = parseStatement(parser, stream);
+        statement->hasErrors = statement->isEdited = parser->parseError != PARSE_ERROR_NONE;
+        if (statement->hasErrors && parser->currentToken && matchTokenType(parser, TOKEN_EOF)) *hasOverrun = 1;
+    }
+
+    for (int closure = 0; closure < 3; closure++) *isClosed = *isClosed && parser->lexer->isInClosure[closure] == 0;
+
+    // Each statement owns the tokens from its first token to the first token of the next statement
+    for (int index = 0; index < *statementCount; index++) {
+        DocumentStatement *statement = &(*statements)[index];
+        int first = index == 0 ? 0 : statement->tokenCount;
+        int last = index + 1 < *statementCount ? (*statements)[index + 1].tokenCount : parser->tokenCount;
+
+        statement->tokens = NULL;
+        statement->tokenCount = 0;
+        if (!parser->tokens || last <= first) continue;
+
+        statement->tokens = (Token**) malloc((last - first) * sizeof(Token*));
+        if (!statement->tokens) continue;
+
+        memcpy(statement->tokens, parser->tokens + first, (last - first) * sizeof(Token*));
+        statement->tokenCount = last - first;
+    }
+
+    // The tokens of a text without any statement (e.g. only comments) belong to nothing
+    if (*statementCount == 0 && parser->tokens) {
+        for (int index = 0; index < parser->tokenCount; index++) free(parser->tokens[index]);
+    }
+
+    if (!*statements && *statementCount > 0) isParsed = 0;
+
+    fclose(stream);
+    free(parser->tokens);
+    free(parser->lexer);
+    free(parser);
+    return isParsed;
+}
+
+static void freeDocumentStatements(DocumentStatement *statements, int statementCount) {
+    for (int index = 0; index < statementCount; index++) {
+        if (statements[index].program) freeDocumentStatement(&statements[index]);
+        else for (int token = 0; token < statements[index].tokenCount; token++) free(statements[index].tokens[token]);
+    }
+
+    free(statements);
+}
+
+// Replaces the statements from first to last (both included) by the statements parsed again
+static int spliceDocumentStatements(Document *document, int first, int last, DocumentStatement *statements,
+                                    int statementCount) {
+    int count = document->statementCount - (last - first + 1) + statementCount;
+
+    if (count > document->statementCapacity) {
+        int capacity = document->statementCapacity ? document->statementCapacity : 16;
+        while (capacity < count) capacity *= 2;
+
+        DocumentStatement *grown = (DocumentStatement*) realloc(document->statements,
+                                                                capacity * sizeof(DocumentStatement));
+        if (!grown) return 0;
+
+        document->statements = grown;
+        document->statementCapacity = capacity;
+    }
+
+    for (int index = first; index <= last; index++) freeDocumentStatement(&document->statements[index]);
+
+    memmove(document->statements + first + statementCount, document->statements + last + 1,
+            (document->statementCount - last - 1) * sizeof(DocumentStatement));
+    if (statementCount > 0) memcpy(document->statements + first, statements, statementCount * sizeof(DocumentStatement));
+
+    document->statementCount = count;
+    return 1;
+}
+
+// Returns whether any statement has failed to parse
+static int hasDocumentErrors(const Document *document) {
+    for (int index = 0; index < document->statementCount; index++) {
+        if (document->statements[index].hasErrors) return 1;
+    }
+
+    return 0;
+}
+
+// Parses the edited statements again if they parse on their own, otherwise the whole document
+static int parseDocument(Document *document) {
+    int first = -1, last = -1;
+
+    for (int index = 0; index < document->statementCount; index++) {
+        if (!document->statements[index].isEdited) continue;
+        if (first < 0) first = index;
+        last = index;
+    }
+
+    document->parsedCount = 0;
+    if (document->isParsed && first < 0 && document->statementCount > 0) return 1;
+
+    DocumentStatement *statements;
+    int statementCount, isClosed, hasOverrun;
+
+    if (document->isParsed && first >= 0) {
+        // The edited statements span from the line where the first one begins to the line where the next one begins
+        int startLine = first == 0 ? 1 : document->statements[first].line;
+        int endLine = last + 1 < document->statementCount ? document->statements[last + 1].line
+                                                          : document->lineCount + 1;
+
+        // A statement ending on the line where the edited ones begin could not be parsed apart from them
+        if (first == 0 || getStatementEndLine(&document->statements[first - 1]) < startLine) {
+            size_t start = getLineStart(document, startLine);
+            size_t end = endLine > document->lineCount ? document->length : document->lineOffsets[endLine - 1];
+
+            int isParsed = parseDocumentStatements(document->text + start, end - start, startLine,
+                                                   document->diagnostics, &statements, &statementCount, &isClosed,
+                                                   &hasOverrun);
+
+            // A statement failing to parse up to the end of the edited lines might have gone on in the whole document
+            int isBounded = !hasOverrun || endLine > document->lineCount;
+
+            if (isParsed && isClosed && isBounded &&
+                spliceDocumentStatements(document, first, last, statements, statementCount)) {
+                free(statements);
+
+                for (int index = 0; index < document->statementCount; index++) {
+                    shiftDocumentStatement(&document->statements[index]);
+                }
+
+                linkDocumentStatements(document);
+                document->parsedCount = statementCount;
+                return !hasDocumentErrors(document);
+            }
+
+            // The errors of the edited statements are reported again by parsing the whole document
+            freeDocumentStatements(statements, statementCount);
+            clearDiagnosticList(document->diagnostics);
+        }
+    }
+
+    freeDocumentStatements(document->statements, document->statementCount);
+    document->statements = NULL;
+    document->statementCount = document->statementCapacity = 0;
+
+    size_t start = getLineStart(document, 1);
+    int isParsed = parseDocumentStatements(document->text + start, document->length - start, 1, document->diagnostics,
+                                           &statements, &statementCount, &isClosed, &hasOverrun);
+
+    document->statements = statements;
+    document->statementCount = document->statementCapacity = statementCount;
+    document->parsedCount = statementCount;
+    document->isParsed = isParsed && isClosed;
+
+    // A statement left without its AST (if memory allocation has failed) is dropped
+    for (int index = 0; index < document->statementCount; index++) {
+        if (document->statements[index].program) continue;
+
+        for (int token = 0; token < document->statements[index].tokenCount; token++) {
+            free(document->statements[index].tokens[token]);
+        }
+
+        free(document->statements[index].tokens);
+        memmove(document->statements + index, document->statements + index + 1,
+                (document->statementCount - index - 1) * sizeof(DocumentStatement));
+        document->statementCount--;
+        index--;
+    }
+
+    linkDocumentStatements(document);
+    return document->isParsed && !hasDocumentErrors(document);
+}
+
+Document *openDocument(const char *uri, const char *text, size_t length, int version) {
+    Document *document = (Document*) calloc(1, sizeof(Document));
+    if (!document) return NULL;
+
+    document->uri = (char*) malloc(strlen(uri) + 1);
+    document->terminal = initASTNode(AST_PROGRAM, NULL);
+    document->database = initQueryDatabase();
+    document->diagnostics = initDiagnosticList();
+
+    if (!document->uri || !document->terminal || !document->database || !document->diagnostics) {
+        closeDocument(document);
+        return NULL;
+    }
+
+    strcpy(document->uri, uri);
+    document->path = decodeDocumentPath(uri);
+    document->version = version;
+
+    if (!editDocument(document, NULL, NULL, text, length)) {
+        closeDocument(document);
+        return NULL;
+    }
+
+    reloadDocumentInterfaces(document);
+    return document;
+}
+
+int editDocument(Document *document, const DocumentPosition *start, const DocumentPosition *end, const char *text,
+                 size_t length) {
+    size_t startOffset = 0, endOffset = document->length;
+    if (start && end) {
+        startOffset = getDocumentOffset(document, *start);
+        endOffset = getDocumentOffset(document, *end);
+
+        if (endOffset < startOffset) {
+            size_t offset = startOffset;
+            startOffset = endOffset;
+            endOffset = offset;
+        }
+    }
+
+    size_t size = document->length - (endOffset - startOffset) + length;
+
+    if (size + 1 > document->capacity) {
+        size_t capacity = document->capacity ? document->capacity : 256;
+        while (capacity < size + 1) capacity *= 2;
+
+        char *grown = (char*) realloc(document->text, capacity);
+        if (!grown) return 0;
+
+        document->text = grown;
+        document->capacity = capacity;
+    }
+
+    // The lines of the range, counted from 1 before the edit
+    int startLine = document->lineCount ? getDocumentPosition(document, startOffset).line + 1 : 1;
+    int endLine = document->lineCount ? getDocumentPosition(document, endOffset).line + 1 : 1;
+    int insertedLines = 0;
+    for (size_t index = 0; index < length; index++) insertedLines += text[index] == '\n';
+
+    memmove(document->text + startOffset + length, document->text + endOffset, document->length - endOffset);
+    memcpy(document->text + startOffset, text, length);
+    document->length = size;
+    document->text[size] = '\0';
+
+    if (!indexDocumentLines(document)) {
+        document->isParsed = 0;
+        return 0;
+    }
+
+    // Replacing the whole document parses it again, where nothing could be reused but the analysis
+    if (!start || !end) {
+        document->isParsed = 0;
+        return 1;
+    }
+
+    // A statement is edited if the range touches any line from its first line to the line before the next statement
+    for (int index = 0; index < document->statementCount; index++) {
+        DocumentStatement *statement = &document->statements[index];
+        int regionStart = index == 0 ? 1 : statement->line;
+        int regionEnd = index + 1 < document->statementCount ? document->statements[index + 1].line - 1 : INT_MAX;
+
+        if (regionStart <= endLine && regionEnd >= startLine) statement->isEdited = 1;
+    }
+
+    // The statements after the range move by the lines inserted or deleted, and the ones inside it are edited anyway
+    int shift = insertedLines - (endLine - startLine);
+
+    for (int index = 0; index < document->statementCount; index++) {
+        DocumentStatement *statement = &document->statements[index];
+
+        if (statement->line > endLine) {
+            statement->line += shift;
+            statement->lineShift += shift;
+        }
+
+        else if (statement->line > startLine) statement->line = startLine;
+    }
+
+    return 1;
+}
+
+// Declares the exports of the imported modules whose interfaces have been found, like compileModule()
+static void declareDocumentImports(Document *document, SymbolTable *symbolTable, IRProgram *program) {
+    for (int index = 0; index < document->interfaceCount; index++) {
+        declareModuleInterface(document->interfaces[index], symbolTable, program);
+    }
+}
+
+// Checks whether the imports of the document are still the modules whose interfaces have been read
+static int hasDocumentImportsChanged(Document *document) {
+    int importCount = 0;
+
+    for (int index = 0; index < document->statementCount; index++) {
+        ASTNode *statement = document->statements[index].program->left;
+        if (!statement || statement->nodeType != AST_IMPORT_DECLARATION || !statement->left) continue;
+
+        int isRead = 0;
+        for (int interface = 0; interface < document->interfaceCount && !isRead; interface++) {
+            isRead = strcmp(document->interfaces[interface]->name, statement->left->token->lexeme) == 0;
+        }
+
+        // A module whose interface was missing is looked for again, in case it has been compiled since
+        if (!isRead) return 1;
+        importCount++;
+    }
+
+    return importCount != document->interfaceCount;
+}
+
+int analyzeDocument(Document *document) {
+    // The symbols of the last analysis would no longer match the text of the document
+    if (document->symbolTable) freeSymbolTable(document->symbolTable);
+    document->symbolTable = NULL;
+    clearDiagnosticList(document->diagnostics);
+
+    // The lexer assumes valid UTF-8, so an invalid sequence is reported before anything is parsed
+    size_t errorOffset;
+
+    if (!validateUTF8((const unsigned char*) document->text, document->length, &errorOffset)) {
+        DocumentPosition position = getDocumentPosition(document, errorOffset);
+        int column = 2 + (int) (errorOffset - getLineStart(document, position.line + 1));
+        Location location = {position.line + 1, column};
+
+        reportDiagnostic(document->diagnostics, location, "Invalid UTF-8 sequence");
+        document->isParsed = 0;
+        return 0;
+    }
+
+    // The statements failing to parse are analyzed as well, where their AST_ERROR nodes are skipped
+    int isParsed = parseDocument(document);
+
+    if (hasDocumentImportsChanged(document)) reloadDocumentInterfaces(document);
+
+    // The imported constants are the inputs of the analysis, which could reuse the memo of any statement
+    SymbolTable *symbolTable = initSymbolTable();
+    IRProgram *program = initIRProgram();
+    ASTNode *root = document->statementCount ? document->statements[0].program : document->terminal;
+    Analyzer *analyzer = symbolTable ? initAnalyzer(root, symbolTable) : NULL;
+
+    if (!analyzer || !program) {
+        if (symbolTable) freeSymbolTable(symbolTable);
+        if (program) freeIRProgram(program);
+        free(analyzer);
+        return 0;
+    }
+
+    analyzer->diagnostics = document->diagnostics;
+    declareDocumentImports(document, symbolTable, program);
+    analyzeProgramIncrementally(document->database, analyzer, root);
+    document->symbolTable = symbolTable;
+    sortDiagnostics(document->diagnostics);
+
+    freeIRProgram(program);
+    free(analyzer);
+    return isParsed;
+}
+
+void reloadDocumentInterfaces(Document *document) {
+    for (int index = 0; index < document->interfaceCount; index++) freeModuleInterface(document->interfaces[index]);
+    free(document->interfaces);
+    document->interfaces = NULL;
+    document->interfaceCount = 0;
+    if (!document->path) return;
+
+    // The interfaces live next to the document, whose directory ends with its last separator
+    const char *separator = strrchr(document->path, '/');
+#ifdef _WIN32
+    const char *backslash = strrchr(document->path, '\\');
+    if (backslash > separator) separator = backslash;
+#endif
+    int directoryLength = separator ? (int) (separator - document->path + 1) : 0;
+
+    for (int index = 0; index < document->statementCount; index++) {
+        ASTNode *statement = document->statements[index].program->left;
+        if (!statement || statement->nodeType != AST_IMPORT_DECLARATION || !statement->left) continue;
+
+        char interfacePath[MODULE_PATH_LENGTH];
+        snprintf(interfacePath, sizeof(interfacePath), "%.*s%s%s", directoryLength, document->path,
+                 statement->left->token->lexeme, MODULE_INTERFACE_EXTENSION);
+
+        ModuleInterface *interface = readModuleInterface(interfacePath);
+        if (!interface) continue;
+
+        ModuleInterface **interfaces = (ModuleInterface**) realloc(document->interfaces,
+                                                                   (document->interfaceCount + 1) * sizeof(ModuleInterface*));
+        if (!interfaces) {
+            freeModuleInterface(interface);
+            return;
+        }
+
+        document->interfaces = interfaces;
+        document->interfaces[document->interfaceCount++] = interface;
+    }
+}
+
+size_t getDocumentOffset(const Document *document, DocumentPosition position) {
+    if (position.line < 0) return 0;
+    if (position.line >= document->lineCount) return document->length;
+
+    size_t offset = document->lineOffsets[position.line];
+    size_t end = getLineEnd(document, position.line + 1);
+
+    // A character outside the Basic Multilingual Plane is two UTF-16 code units
+    for (int units = 0; offset < end && units < position.character;) {
+        size_t length = getCharacterLength(document, offset);
+        units += length == 4 ? 2 : 1;
+        offset += length;
+    }
+
+    return offset < end ? offset : end;
+}
+
+DocumentPosition getDocumentPosition(const Document *document, size_t offset) {
+    if (offset > document->length) offset = document->length;
+
+    // Find the last line beginning before the offset
+    int low = 0, high = document->lineCount - 1;
+
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (document->lineOffsets[middle] <= offset) low = middle;
+        else high = middle - 1;
+    }
+
+    DocumentPosition position = {low, 0};
+
+    for (size_t index = document->lineOffsets[low]; index < offset;) {
+        size_t length = getCharacterLength(document, index);
+        position.character += length == 4 ? 2 : 1;
+        index += length;
+    }
+
+    return position;
+}
+
+size_t getLocationOffset(const Document *document, Location location) {
+    if (location.line < 1) return 0;
+    if (location.line > document->lineCount) return document->length;
+
+    // The lexer counts a column once it has read the character, so the first character of a line is at column 2
+    if (location.column < 2) {
+        return location.line > 1 ? getLineEnd(document, location.line - 1) : getLineStart(document, 1);
+    }
+
+    // Columns are counted in bytes, so the offset is only kept within the line
+    size_t offset = getLineStart(document, location.line) + (size_t) (location.column - 2);
+    size_t end = getLineEnd(document, location.line);
+    return offset < end ? offset : end;
+}
+
+// Finds the deepest node of a subtree whose token covers an offset
+static ASTNode *findNodeAtOffset(const Document *document, ASTNode *node, ASTNode *parent, size_t offset,
+                                 ASTNode **foundParent) {
+    if (!node) return NULL;
+
+    // The children are searched first, since a node could share its token with a child (e.g. a call and its callee)
+    ASTNode *found = findNodeAtOffset(document, node->left, node, offset, foundParent);
+    if (!found) found = findNodeAtOffset(document, node->right, node, offset, foundParent);
+    if (found || !node->token || node->token->tokenType == TOKEN_DELIMITER) return found;
+
+    size_t start = getLocationOffset(document, node->token->location);
+    size_t end = start + strlen(node->token->lexeme);
+
+    if (offset < start || offset > end) return NULL;
+
+    *foundParent = parent;
+    return node;
+}
+
+ASTNode *findDocumentNode(const Document *document, DocumentPosition position, ASTNode **parent, ASTNode **statement) {
+    *parent = *statement = NULL;
+    size_t offset = getDocumentOffset(document, position);
+    int line = position.line + 1;
+
+    // Find the last statement beginning before the line, which might span it
+    int low = 0, high = document->statementCount - 1;
+    if (high < 0) return NULL;
+
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (document->statements[middle].line <= line) low = middle;
+        else high = middle - 1;
+    }
+
+    *statement = document->statements[low].program->left;
+    return findNodeAtOffset(document, *statement, NULL, offset, parent);
+}
+
+ASTNode *findDocumentDeclaration(const Document *document, const char *identifier, const Location *location) {
+    for (int index = 0; index < document->statementCount; index++) {
+        ASTNode *statement = document->statements[index].program->left;
+        if (!statement) continue;
+
+        // A function with a body is the definition wrapped by its implementation, and an initialized declaration is
+        // the declaration wrapped by its assignment
+        if (statement->nodeType == AST_FUNCTION_IMPLEMENTATION) statement = statement->left;
+        else if (statement->nodeType == AST_ASSIGNMENT_STATEMENT && statement->left &&
+                 (statement->left->nodeType == AST_VARIABLE_DECLARATION ||
+                  statement->left->nodeType == AST_CONSTANT_DECLARATION)) statement = statement->left;
+        if (!statement || !statement->left || !statement->left->token) continue;
+
+        int isDeclaration = statement->nodeType == AST_VARIABLE_DECLARATION ||
+                            statement->nodeType == AST_CONSTANT_DECLARATION;
+        int isFunction = statement->nodeType == AST_FUNCTION_DEFINITION;
+        if ((location && !isDeclaration) || (!location && !isFunction)) continue;
+
+        if (strcmp(statement->left->token->lexeme, identifier) != 0) continue;
+        if (location && (statement->token->location.line != location->line ||
+                         statement->token->location.column != location->column)) continue;
+
+        return statement;
+    }
+
+    return NULL;
+}
+
+void closeDocument(Document *document) {
+    if (!document) return;
+
+    if (document->statements) freeDocumentStatements(document->statements, document->statementCount);
+    for (int index = 0; index < document->interfaceCount; index++) freeModuleInterface(document->interfaces[index]);
+    if (document->symbolTable) freeSymbolTable(document->symbolTable);
+    if (document->database) freeQueryDatabase(document->database);
+    freeDiagnosticList(document->diagnostics);
+
+    free(document->interfaces);
+    free(document->terminal);
+    free(document->lineOffsets);
+    free(document->text);
+    free(document->path);
+    free(document->uri);
+    free(document);
+}
@@ -0,0 +1,428 @@
+// json.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "json.h"
+#include "utf8.h"
+
+/// The state of parsing a JSON text.
+typedef struct {
+    const char *text;
+    size_t length;
+    size_t position;
+    int depth;
+} JsonReader;
+
+static JsonValue *parseJsonValue(JsonReader *reader);
+
+static void skipJsonWhitespace(JsonReader *reader) {
+    while (reader->position < reader->length) {
+        char character = reader->text[reader->position];
+        if (character != ' ' && character != '\t' && character != '\n' && character != '\r') return;
+        reader->position++;
+    }
+}
+
+static int matchJsonCharacter(JsonReader *reader, char expected) {
+    skipJsonWhitespace(reader);
+    if (reader->position >= reader->length || reader->text[reader->position] != expected) return 0;
+
+    reader->position++;
+    return 1;
+}
+
+static int matchJsonKeyword(JsonReader *reader, const char *keyword) {
+    size_t length = strlen(keyword);
+    if (reader->length - reader->position < length || strncmp(reader->text + reader->position, keyword, length) != 0)
+        return 0;
+
+    reader->position += length;
+    return 1;
+}
+
+static JsonValue *initJsonValue(JsonType type) {
+    JsonValue *value = (JsonValue*) calloc(1, sizeof(JsonValue));
+    if (value) value->type = type;
+    return value;
+}
+
+// Appends an item (with its key for an object) to an array or an object, which takes the ownership of both
+static int addJsonItem(JsonValue *container, char *key, JsonValue *item) {
+    if (container->count == container->capacity) {
+        int capacity = container->capacity ? container->capacity * 2 : 4;
+        JsonValue **items = (JsonValue**) realloc(container->items, capacity * sizeof(JsonValue*));
+        if (!items) return 0;
+        container->items = items;
+
+        char **keys = (char**) realloc(container->keys, capacity * sizeof(char*));
+        if (!keys) return 0;
+        container->keys = keys;
+        container->capacity = capacity;
+    }
+
+    container->keys[container->count] = key;
+    container->items[container->count++] = item;
+    return 1;
+}
+
+static int parseHexadecimal(JsonReader *reader, unsigned *codeUnit) {
+    if (reader->length - reader->position < 4) return 0;
+    *codeUnit = 0;
+
+    for (int index = 0; index < 4; index++) {
+        char digit = reader->text[reader->position++];
+        *codeUnit <<= 4;
+
+        if (digit >= '0' && digit <= '9') *codeUnit |= digit - '0';
+        else if (digit >= 'a' && digit <= 'f') *codeUnit |= digit - 'a' + 10;
+        else if (digit >= 'A' && digit <= 'F') *codeUnit |= digit - 'A' + 10;
+        else return 0;
+    }
+
+    return 1;
+}
+
+static size_t encodeUTF8(unsigned codePoint, char *bytes) {
+    if (codePoint < 0x80) { bytes[0] = (char) codePoint; return 1; }
+
+    if (codePoint < 0x800) {
+        bytes[0] = (char) (0xC0 | (codePoint >> 6));
+        bytes[1] = (char) (0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+
+    if (codePoint < 0x10000) {
+        bytes[0] = (char) (0xE0 | (codePoint >> 12));
+        bytes[1] = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+        bytes[2] = (char) (0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+
+    bytes[0] = (char) (0xF0 | (codePoint >> 18));
+    bytes[1] = (char) (0x80 | ((codePoint >> 12) & 0x3F));
+    bytes[2] = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+    bytes[3] = (char) (0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+// Parses a string after its opening quote, where the decoded string is never longer than the escaped one
+static char *parseJsonString(JsonReader *reader, size_t *length) {
+    size_t end = reader->position;
+    while (end < reader->length && reader->text[end] != '"') end += reader->text[end] == '\\' ? 2 : 1;
+
+    char *string = (char*) malloc(end - reader->position + 1);
+    if (!string) return NULL;
+    size_t size = 0;
+
+    while (reader->position < reader->length) {
+        char character = reader->text[reader->position++];
+
+        if (character == '"') {
+            string[size] = '\0';
+            if (length) *length = size;
+            return string;
+        }
+
+        if ((unsigned char) character < 0x20) break;
+
+        if (character != '\\') {
+            string[size++] = character;
+            continue;
+        }
+
+        if (reader->position >= reader->length) break;
+        char escaped = reader->text[reader->position++];
+
+        if (escaped == '"' || escaped == '\\' || escaped == '/') string[size++] = escaped;
+        else if (escaped == 'b') string[size++] = '\b';
+        else if (escaped == 'f') string[size++] = '\f';
+        else if (escaped == 'n') string[size++] = '\n';
+        else if (escaped == 'r') string[size++] = '\r';
+        else if (escaped == 't') string[size++] = '\t';
+
+        else if (escaped == 'u') {
+            unsigned codePoint;
+            if (!parseHexadecimal(reader, &codePoint)) break;
+
+            // A character outside the Basic Multilingual Plane is escaped as a surrogate pair
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                unsigned lowSurrogate;
+                if (reader->length - reader->position < 6 || reader->text[reader->position] != '\\' ||
+                    reader->text[reader->position + 1] != 'u') break;
+
+                reader->position += 2;
+                if (!parseHexadecimal(reader, &lowSurrogate) || lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF) break;
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+            }
+
+            size += encodeUTF8(codePoint, string + size);
+        }
+
+        else break;
+    }
+
+    free(string);
+    return NULL;
+}
+
+static JsonValue *parseJsonNumber(JsonReader *reader) {
+    char digits[64];
+    size_t size = 0;
+
+    while (reader->position < reader->length && size < sizeof(digits) - 1 &&
+           strchr("+-0123456789.eE", reader->text[reader->position])) digits[size++] = reader->text[reader->position++];
+
+    digits[size] = '\0';
+    char *end;
+    double number = strtod(digits, &end);
+    if (size == 0 || *end != '\0') return NULL;
+
+    JsonValue *value = initJsonValue(JSON_NUMBER);
+    if (value) value->number = number;
+    return value;
+}
+
+static JsonValue *parseJsonContainer(JsonReader *reader, int isObject) {
+    JsonValue *container = initJsonValue(isObject ? JSON_OBJECT : JSON_ARRAY);
+    if (!container) return NULL;
+
+    char closing = isObject ? '}' : ']';
+    if (matchJsonCharacter(reader, closing)) return container;
+
+    do {
+        char *key = NULL;
+
+        if (isObject) {
+            if (!matchJsonCharacter(reader, '"') || !(key = parseJsonString(reader, NULL)) ||
+                !matchJsonCharacter(reader, ':')) {
+                free(key);
+                freeJson(container);
+                return NULL;
+            }
+        }
+
+        JsonValue *item = parseJsonValue(reader);
+
+        if (!item || !addJsonItem(container, key, item)) {
+            free(key);
+            freeJson(item);
+            freeJson(container);
+            return NULL;
+        }
+    } while (matchJsonCharacter(reader, ','));
+
+    if (matchJsonCharacter(reader, closing)) return container;
+
+    freeJson(container);
+    return NULL;
+}
+
+static JsonValue *parseJsonValue(JsonReader *reader) {
+    skipJsonWhitespace(reader);
+    if (reader->position >= reader->length || reader->depth >= JSON_MAX_DEPTH) return NULL;
+
+    char character = reader->text[reader->position];
+    JsonValue *value = NULL;
+
+    if (character == '{' || character == '[') {
+        reader->position++;
+        reader->depth++;
+        value = parseJsonContainer(reader, character == '{');
+        reader->depth--;
+    }
+
+    else if (character == '"') {
+        reader->position++;
+        size_t length;
+        char *string = parseJsonString(reader, &length);
+        if (!string) return NULL;
+
+        value = initJsonValue(JSON_STRING);
+        if (!value) free(string);
+        else {
+            value->string = string;
+            value->length = length;
+        }
+    }
+
+    else if (matchJsonKeyword(reader, "true") || matchJsonKeyword(reader, "false")) {
+        value = initJsonValue(JSON_BOOLEAN);
+        if (value) value->number = character == 't';
+    }
+
+    else if (matchJsonKeyword(reader, "null")) value = initJsonValue(JSON_NULL);
+    else value = parseJsonNumber(reader);
+
+    return value;
+}
+
+JsonValue *parseJson(const char *text, size_t length) {
+    JsonReader reader = {text, length, 0, 0};
+    JsonValue *value = parseJsonValue(&reader);
+
+    // Nothing but whitespace could follow the value
+    skipJsonWhitespace(&reader);
+    if (value && reader.position == reader.length) return value;
+
+    freeJson(value);
+    return NULL;
+}
+
+JsonValue *getJsonPath(const JsonValue *value, const char *path) {
+    while (value && *path) {
+        const char *separator = strchr(path, '.');
+        size_t length = separator ? (size_t) (separator - path) : strlen(path);
+        if (value->type != JSON_OBJECT) return NULL;
+
+        const JsonValue *member = NULL;
+        for (int index = 0; index < value->count && !member; index++) {
+            if (strncmp(value->keys[index], path, length) == 0 && value->keys[index][length] == '\0')
+                member = value->items[index];
+        }
+
+        value = member;
+        path += separator ? length + 1 : length;
+    }
+
+    return (JsonValue*) value;
+}
+
+const char *getJsonString(const JsonValue *value, const char *path) {
+    JsonValue *member = getJsonPath(value, path);
+    return member && member->type == JSON_STRING ? member->string : NULL;
+}
+
+int getJsonInteger(const JsonValue *value, const char *path, int fallback) {
+    JsonValue *member = getJsonPath(value, path);
+    return member && member->type == JSON_NUMBER ? (int) member->number : fallback;
+}
+
+void freeJson(JsonValue *value) {
+    if (!value) return;
+
+    for (int index = 0; index < value->count; index++) {
+        if (value->keys) free(value->keys[index]);
+        freeJson(value->items[index]);
+    }
+
+    free(value->keys);
+    free(value->items);
+    free(value->string);
+    free(value);
+}
+
+static void writeJsonBytes(JsonWriter *writer, const char *bytes, size_t length) {
+    if (writer->hasFailed) return;
+
+    if (writer->length + length + 1 > writer->capacity) {
+        size_t capacity = writer->capacity ? writer->capacity : 256;
+        while (writer->length + length + 1 > capacity) capacity *= 2;
+
+        char *grown = (char*) realloc(writer->bytes, capacity);
+        if (!grown) {
+            writer->hasFailed = 1;
+            return;
+        }
+
+        writer->bytes = grown;
+        writer->capacity = capacity;
+    }
+
+    memcpy(writer->bytes + writer->length, bytes, length);
+    writer->length += length;
+    writer->bytes[writer->length] = '\0';
+}
+
+void writeJsonRaw(JsonWriter *writer, const char *text) {
+    writeJsonBytes(writer, text, strlen(text));
+}
+
+void writeJsonString(JsonWriter *writer, const char *string, size_t length) {
+    writeJsonBytes(writer, "\"", 1);
+    size_t start = 0;
+
+    // Runs of characters that need no escape are copied at once
+    for (size_t index = 0; index < length; index++) {
+        unsigned char character = (unsigned char) string[index];
+
+        // A byte out of a valid UTF-8 sequence (e.g. of a message cut short) is replaced, so that the JSON stays valid
+        if (character >= 0x80) {
+            size_t sequenceLength = (size_t) getSequenceLength(character), errorOffset;
+
+            if (sequenceLength > 1 && index + sequenceLength <= length &&
+                validateUTF8((const unsigned char*) string + index, sequenceLength, &errorOffset)) {
+                index += sequenceLength - 1;
+                continue;
+            }
+
+            writeJsonBytes(writer, string + start, index - start);
+            writeJsonRaw(writer, "\\ufffd");
+            start = index + 1;
+            continue;
+        }
+
+        if (character >= 0x20 && character != '"' && character != '\\') continue;
+
+        writeJsonBytes(writer, string + start, index - start);
+        start = index + 1;
+
+        char escaped[8];
+        if (character == '"') strcpy(escaped, "\\\"");
+        else if (character == '\\') strcpy(escaped, "\\\\");
+        else if (character == '\n') strcpy(escaped, "\\n");
+        else if (character == '\r') strcpy(escaped, "\\r");
+        else if (character == '\t') strcpy(escaped, "\\t");
+        else snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+        writeJsonRaw(writer, escaped);
+    }
+
+    writeJsonBytes(writer, string + start, length - start);
+    writeJsonBytes(writer, "\"", 1);
+}
+
+void writeJsonInteger(JsonWriter *writer, long number) {
+    char digits[32];
+    snprintf(digits, sizeof(digits), "%ld", number);
+    writeJsonRaw(writer, digits);
+}
+
+void writeJsonValue(JsonWriter *writer, const JsonValue *value) {
+    if (!value || value->type == JSON_NULL) {
+        writeJsonRaw(writer, "null");
+        return;
+    }
+
+    switch (value->type) {
+        case JSON_BOOLEAN: writeJsonRaw(writer, value->number ? "true" : "false"); break;
+        case JSON_STRING: writeJsonString(writer, value->string, value->length); break;
+
+        case JSON_NUMBER: {
+            char digits[32];
+            snprintf(digits, sizeof(digits), "%.17g", value->number);
+            writeJsonRaw(writer, digits);
+            break;
+        }
+
+        default: {
+            int isObject = value->type == JSON_OBJECT;
+            writeJsonRaw(writer, isObject ? "{" : "[");
+
+            for (int index = 0; index < value->count; index++) {
+                if (index > 0) writeJsonRaw(writer, ",");
+
+                if (isObject) {
+                    writeJsonString(writer, value->keys[index], strlen(value->keys[index]));
+                    writeJsonRaw(writer, ":");
+                }
+
+                writeJsonValue(writer, value->items[index]);
+            }
+
+            writeJsonRaw(writer, isObject ? "}" : "]");
+        }
+    }
+}
@@ -0,0 +1,121 @@
+// replay.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "replay.h"
+#include "json.h"
+
+// Finds the timings of a method, adding them on its first message
+static ReplayTiming *findReplayTiming(ReplayTiming *timings, int *count, const char *method) {
+    for (int index = 0; index < *count; index++) {
+        if (strcmp(timings[index].method, method) == 0) return &timings[index];
+    }
+
+    if (*count == REPLAY_MAX_METHODS) return NULL;
+
+    ReplayTiming *timing = &timings[(*count)++];
+    snprintf(timing->method, sizeof(timing->method), "%s", method);
+    timing->milliseconds = NULL;
+    timing->count = timing->capacity = 0;
+    return timing;
+}
+
+static int addReplayTime(ReplayTiming *timing, double milliseconds) {
+    if (timing->count == timing->capacity) {
+        int capacity = timing->capacity ? timing->capacity * 2 : 64;
+        double *times = (double*) realloc(timing->milliseconds, capacity * sizeof(double));
+        if (!times) return 0;
+
+        timing->milliseconds = times;
+        timing->capacity = capacity;
+    }
+
+    timing->milliseconds[timing->count++] = milliseconds;
+    return 1;
+}
+
+static int compareTimes(const void *left, const void *right) {
+    double difference = *(const double*) left - *(const double*) right;
+    return (difference > 0) - (difference < 0);
+}
+
+// Reads a whole line of any length, without its line break
+static char *readSessionLine(FILE *session, size_t *length) {
+    size_t capacity = 4096;
+    char *line = (char*) malloc(capacity);
+    *length = 0;
+
+    for (int character; line && (character = fgetc(session)) != EOF && character != '\n';) {
+        if (*length + 1 == capacity) {
+            char *grown = (char*) realloc(line, capacity *= 2);
+            if (!grown) free(line);
+            line = grown;
+            if (!line) break;
+        }
+
+        line[(*length)++] = (char) character;
+    }
+
+    if (line && *length == 0 && feof(session)) {
+        free(line);
+        return NULL;
+    }
+
+    if (line) line[*length] = '\0';
+    return line;
+}
+
+int replayLanguageServerSession(LanguageServer *server, const char *sessionPath, FILE *report) {
+    FILE *session = fopen(sessionPath, "rb");
+
+    if (!session) {
+        fprintf(stderr, "[ReplayError]: Cannot open session '%s'.\n", sessionPath);
+        return 0;
+    }
+
+    ReplayTiming timings[REPLAY_MAX_METHODS];
+    int timingCount = 0, isServing = 1;
+    size_t length;
+
+    for (char *line; isServing && (line = readSessionLine(session, &length));) {
+        if (length == 0) {
+            free(line);
+            continue;
+        }
+
+        // The method is read before the message is timed, so that only the handling of the message is measured
+        JsonValue *message = parseJson(line, length);
+        const char *method = getJsonString(message, "method");
+        ReplayTiming *timing = findReplayTiming(timings, &timingCount, method ? method : "(response)");
+        freeJson(message);
+
+        clock_t start = clock();
+        isServing = handleLanguageServerMessage(server, line, length);
+        double milliseconds = 1000.0 * (double) (clock() - start) / CLOCKS_PER_SEC;
+
+        if (timing) addReplayTime(timing, milliseconds);
+        free(line);
+    }
+
+    fclose(session);
+
+    // The messages of each method in the order they have first appeared
+    fprintf(report, "%-36s %8s %10s %10s %10s\n", "Method", "Count", "Median", "P95", "Max");
+
+    for (int index = 0; index < timingCount; index++) {
+        ReplayTiming *timing = &timings[index];
+        if (timing->count == 0) continue;
+
+        qsort(timing->milliseconds, timing->count, sizeof(double), compareTimes);
+        fprintf(report, "%-36s %8d %7.3f ms %7.3f ms %7.3f ms\n", timing->method, timing->count,
+                timing->milliseconds[timing->count / 2], timing->milliseconds[(timing->count * 95 - 1) / 100],
+                timing->milliseconds[timing->count - 1]);
+        free(timing->milliseconds);
+    }
+
+    return 1;
+}
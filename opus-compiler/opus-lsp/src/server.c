@@ -0,0 +1,483 @@
+// server.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#ifdef _WIN32
+#define strncasecmp _strnicmp
+#else
+#include <strings.h>
+#endif
+#include "server.h"
+#include "json.h"
+#include "utf8.h"
+
+#define HOVER_LENGTH   1024
+
+LanguageServer *initLanguageServer(FILE *output) {
+    LanguageServer *server = (LanguageServer*) calloc(1, sizeof(LanguageServer));
+    if (server) server->output = output;
+    return server;
+}
+
+char *readLanguageServerMessage(FILE *input, size_t *length) {
+    char header[LSP_HEADER_LENGTH];
+    long contentLength = -1;
+
+    // The headers end with an empty line, where only 'Content-Length' matters
+    while (fgets(header, sizeof(header), input)) {
+        if (strcmp(header, "\r\n") == 0 || strcmp(header, "\n") == 0) {
+            if (contentLength >= 0) break;
+            continue;
+        }
+
+        if (strncasecmp(header, "Content-Length:", 15) == 0) contentLength = strtol(header + 15, NULL, 10);
+    }
+
+    if (contentLength < 0 || contentLength > LSP_MAX_MESSAGE_LENGTH) return NULL;
+
+    char *message = (char*) malloc((size_t) contentLength + 1);
+    if (!message) return NULL;
+
+    if (fread(message, 1, (size_t) contentLength, input) != (size_t) contentLength) {
+        free(message);
+        return NULL;
+    }
+
+    message[contentLength] = '\0';
+    *length = (size_t) contentLength;
+    return message;
+}
+
+// Writes a message framed by its header, once it has been completely written
+static void sendMessage(LanguageServer *server, JsonWriter *writer) {
+    if (!writer->hasFailed) {
+        fprintf(server->output, "Content-Length: %zu\r\n\r\n", writer->length);
+        fwrite(writer->bytes, 1, writer->length, server->output);
+        fflush(server->output);
+    }
+
+    free(writer->bytes);
+}
+
+static void beginResponse(JsonWriter *writer, const JsonValue *id) {
+    writeJsonRaw(writer, "{\"jsonrpc\":\"2.0\",\"id\":");
+    writeJsonValue(writer, id);
+    writeJsonRaw(writer, ",\"result\":");
+}
+
+static void sendError(LanguageServer *server, const JsonValue *id, int code, const char *message) {
+    JsonWriter writer = {NULL, 0, 0, 0};
+    writeJsonRaw(&writer, "{\"jsonrpc\":\"2.0\",\"id\":");
+    writeJsonValue(&writer, id);
+    writeJsonRaw(&writer, ",\"error\":{\"code\":");
+    writeJsonInteger(&writer, code);
+    writeJsonRaw(&writer, ",\"message\":");
+    writeJsonString(&writer, message, strlen(message));
+    writeJsonRaw(&writer, "}}");
+    sendMessage(server, &writer);
+}
+
+static void writePosition(JsonWriter *writer, DocumentPosition position) {
+    writeJsonRaw(writer, "{\"line\":");
+    writeJsonInteger(writer, position.line);
+    writeJsonRaw(writer, ",\"character\":");
+    writeJsonInteger(writer, position.character);
+    writeJsonRaw(writer, "}");
+}
+
+static void writeRange(JsonWriter *writer, Document *document, size_t start, size_t end) {
+    writeJsonRaw(writer, "{\"start\":");
+    writePosition(writer, getDocumentPosition(document, start));
+    writeJsonRaw(writer, ",\"end\":");
+    writePosition(writer, getDocumentPosition(document, end));
+    writeJsonRaw(writer, "}");
+}
+
+// Returns where the token at an offset ends, that is the end of an identifier or a number, or the next character
+static size_t getTokenEnd(Document *document, size_t offset) {
+    size_t end = offset;
+
+    while (end < document->length && document->text[end] != '\n' && document->text[end] != '\r') {
+        int codePoint = decodeCodePoint(document->text + end);
+        int isWord = isIdentifierContinue(codePoint) || isdigit(codePoint);
+
+        if (!isWord && end > offset) break;
+        end += getSequenceLength((unsigned char) document->text[end]) ? getSequenceLength((unsigned char) document->text[end]) : 1;
+        if (!isWord) break;
+    }
+
+    return end;
+}
+
+static Document *findDocument(LanguageServer *server, const char *uri, int *index) {
+    if (!uri) return NULL;
+
+    for (int position = 0; position < server->documentCount; position++) {
+        if (strcmp(server->documents[position]->uri, uri) != 0) continue;
+        if (index) *index = position;
+        return server->documents[position];
+    }
+
+    return NULL;
+}
+
+// Analyzes a document again and publishes its errors, which replace the ones published before
+static void publishDiagnostics(LanguageServer *server, Document *document) {
+    analyzeDocument(document);
+
+    JsonWriter writer = {NULL, 0, 0, 0};
+    writeJsonRaw(&writer, "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":");
+    writeJsonString(&writer, document->uri, strlen(document->uri));
+    writeJsonRaw(&writer, ",\"version\":");
+    writeJsonInteger(&writer, document->version);
+    writeJsonRaw(&writer, ",\"diagnostics\":[");
+
+    for (int index = 0; index < document->diagnostics->diagnosticCount; index++) {
+        Diagnostic *diagnostic = &document->diagnostics->diagnostics[index];
+        size_t start = getLocationOffset(document, diagnostic->location);
+
+        if (index > 0) writeJsonRaw(&writer, ",");
+        writeJsonRaw(&writer, "{\"range\":");
+        writeRange(&writer, document, start, getTokenEnd(document, start));
+        writeJsonRaw(&writer, ",\"severity\":1,\"source\":\"opus\",\"message\":");
+        writeJsonString(&writer, diagnostic->message, strlen(diagnostic->message));
+        writeJsonRaw(&writer, "}");
+    }
+
+    writeJsonRaw(&writer, "]}}");
+    sendMessage(server, &writer);
+}
+
+static void handleInitialize(LanguageServer *server, const JsonValue *id) {
+    server->isInitialized = 1;
+
+    // Edits are synchronized incrementally (2), and positions are counted in UTF-16 code units
+    JsonWriter writer = {NULL, 0, 0, 0};
+    beginResponse(&writer, id);
+    writeJsonRaw(&writer, "{\"capabilities\":{\"positionEncoding\":\"utf-16\",\"textDocumentSync\":{\"openClose\":true,"
+                          "\"change\":2,\"save\":true},\"hoverProvider\":true,\"definitionProvider\":true},"
+                          "\"serverInfo\":{\"name\":\"opus-lsp\"}}}");
+    sendMessage(server, &writer);
+}
+
+static void handleDidOpen(LanguageServer *server, const JsonValue *params) {
+    const char *uri = getJsonString(params, "textDocument.uri");
+    JsonValue *text = getJsonPath(params, "textDocument.text");
+    if (!uri || !text || text->type != JSON_STRING) return;
+
+    // Opening a document again replaces it
+    int index;
+    Document *document = findDocument(server, uri, &index);
+
+    if (document) {
+        closeDocument(document);
+        server->documents[index] = server->documents[--server->documentCount];
+    }
+
+    if (server->documentCount == server->documentCapacity) {
+        int capacity = server->documentCapacity ? server->documentCapacity * 2 : 8;
+        Document **documents = (Document**) realloc(server->documents, capacity * sizeof(Document*));
+        if (!documents) return;
+
+        server->documents = documents;
+        server->documentCapacity = capacity;
+    }
+
+    document = openDocument(uri, text->string, text->length, getJsonInteger(params, "textDocument.version", 0));
+    if (!document) return;
+
+    server->documents[server->documentCount++] = document;
+    publishDiagnostics(server, document);
+}
+
+static void handleDidChange(LanguageServer *server, const JsonValue *params) {
+    Document *document = findDocument(server, getJsonString(params, "textDocument.uri"), NULL);
+    JsonValue *changes = getJsonPath(params, "contentChanges");
+    if (!document || !changes || changes->type != JSON_ARRAY) return;
+
+    // The changes are applied in order, each one to the document as left by the previous one
+    for (int index = 0; index < changes->count; index++) {
+        JsonValue *change = changes->items[index];
+        JsonValue *text = getJsonPath(change, "text");
+        if (!text || text->type != JSON_STRING) continue;
+
+        if (!getJsonPath(change, "range")) {
+            editDocument(document, NULL, NULL, text->string, text->length);
+            continue;
+        }
+
+        DocumentPosition start = {getJsonInteger(change, "range.start.line", 0),
+                                  getJsonInteger(change, "range.start.character", 0)};
+        DocumentPosition end = {getJsonInteger(change, "range.end.line", 0),
+                                getJsonInteger(change, "range.end.character", 0)};
+        editDocument(document, &start, &end, text->string, text->length);
+    }
+
+    document->version = getJsonInteger(params, "textDocument.version", document->version + 1);
+    publishDiagnostics(server, document);
+}
+
+static void handleDidSave(LanguageServer *server, const JsonValue *params) {
+    Document *document = findDocument(server, getJsonString(params, "textDocument.uri"), NULL);
+    if (!document) return;
+
+    // The imported modules might have been compiled since, so their interfaces are read again
+    reloadDocumentInterfaces(document);
+    publishDiagnostics(server, document);
+}
+
+static void handleDidClose(LanguageServer *server, const JsonValue *params) {
+    int index;
+    Document *document = findDocument(server, getJsonString(params, "textDocument.uri"), &index);
+    if (!document) return;
+
+    // The errors of a closed document are cleared
+    JsonWriter writer = {NULL, 0, 0, 0};
+    writeJsonRaw(&writer, "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":");
+    writeJsonString(&writer, document->uri, strlen(document->uri));
+    writeJsonRaw(&writer, ",\"diagnostics\":[]}}");
+    sendMessage(server, &writer);
+
+    closeDocument(document);
+    server->documents[index] = server->documents[--server->documentCount];
+}
+
+// Finds the parameter of the function being defined by a top-level statement, if the statement is a function
+static ASTNode *findParameter(ASTNode *statement, const char *identifier) {
+    if (!statement || statement->nodeType != AST_FUNCTION_IMPLEMENTATION || !statement->left) return NULL;
+
+    ASTNode *signature = statement->left->right;
+    for (ASTNode *list = signature ? signature->left : NULL; list && list->left; list = list->right) {
+        ASTNode *parameter = list->left;
+        if (parameter->left && strcmp(parameter->left->token->lexeme, identifier) == 0) return parameter;
+    }
+
+    return NULL;
+}
+
+// Describes a function by its signature, e.g. 'func area(width: Int, height: Int) -> Int'
+static void describeFunction(ASTNode *definition, char *description, size_t size) {
+    ASTNode *signature = definition->right;
+    size_t length = (size_t) snprintf(description, size, "func %s(", definition->left->token->lexeme);
+
+    for (ASTNode *list = signature ? signature->left : NULL; list && list->left && length < size; list = list->right) {
+        ASTNode *parameter = list->left;
+        length += (size_t) snprintf(description + length, size - length, "%s%s: %s", list == signature->left ? "" : ", ",
+                                    parameter->left->token->lexeme, parameter->right->token->lexeme);
+    }
+
+    if (length < size) {
+        snprintf(description + length, size - length, ") -> %s",
+                 signature && signature->right ? signature->right->token->lexeme : "Void");
+    }
+}
+
+static void describeExternal(IRExternal *external, char *description, size_t size) {
+    size_t length = (size_t) snprintf(description, size, "func %s(", external->identifier);
+
+    for (int index = 0; index < external->parameterCount && length < size; index++) {
+        length += (size_t) snprintf(description + length, size - length, "%s%s: %s", index ? ", " : "",
+                                    external->parameterLabels[index], getIRTypeName(external->parameterTypes[index]));
+    }
+
+    if (length < size) {
+        snprintf(description + length, size - length, ") -> %s  // from module '%s'", getIRTypeName(external->type),
+                 external->module);
+    }
+}
+
+// Describes a symbol by its declaration, with the value of a constant known while analyzing
+static void describeSymbol(Symbol *symbol, char *description, size_t size) {
+    size_t length = (size_t) snprintf(description, size, "%s %s: %s", symbol->isMutable ? "var" : "let",
+                                      symbol->identifier, symbol->type);
+    if (symbol->isMutable || !symbol->isFoldable || length >= size) return;
+
+    if (getIntegerWidth(symbol->type))
+        snprintf(description + length, size - length, " = %lld", getIntegerValue(symbol->type,
+                 symbol->symbolValue.integerValue));
+    else if (strcmp(symbol->type, "Float") == 0)
+        snprintf(description + length, size - length, " = %g", symbol->symbolValue.floatingValue);
+    else if (strcmp(symbol->type, "Bool") == 0)
+        snprintf(description + length, size - length, " = %s", symbol->symbolValue.booleanValue ? "true" : "false");
+    else if (strcmp(symbol->type, "String") == 0)
+        snprintf(description + length, size - length, " = \"%s\"", symbol->symbolValue.stringLiteral);
+}
+
+static IRExternal *findExternal(Document *document, const char *identifier) {
+    for (int index = 0; index < document->interfaceCount; index++) {
+        ModuleInterface *interface = document->interfaces[index];
+
+        for (int exported = 0; exported < interface->exportCount; exported++) {
+            if (strcmp(interface->exports[exported].identifier, identifier) == 0) return &interface->exports[exported];
+        }
+    }
+
+    return NULL;
+}
+
+// Resolves the identifier at a position, into either its declaration in the document, or a description of it
+static ASTNode *resolveIdentifier(Document *document, DocumentPosition position, ASTNode **node, char *description,
+                                  size_t size) {
+    ASTNode *parent, *statement;
+    *node = findDocumentNode(document, position, &parent, &statement);
+    description[0] = '\0';
+
+    if (!*node || (*node)->nodeType != AST_IDENTIFIER) return NULL;
+    const char *identifier = (*node)->token->lexeme;
+
+    // The name of a function being called or defined
+    if (parent && parent->left == *node &&
+        (parent->nodeType == AST_FUNCTION_CALL || parent->nodeType == AST_FUNCTION_DEFINITION)) {
+        ASTNode *definition = findDocumentDeclaration(document, identifier, NULL);
+        IRExternal *external = definition ? NULL : findExternal(document, identifier);
+
+        if (definition) describeFunction(definition, description, size);
+        else if (external && external->isFunction) describeExternal(external, description, size);
+        return definition ? definition->left : NULL;
+    }
+
+    // A parameter of the function whose body contains the identifier, which the analyzer does not visit yet
+    ASTNode *parameter = findParameter(statement, identifier);
+
+    if (parameter) {
+        snprintf(description, size, "%s: %s  // parameter", identifier, parameter->right->token->lexeme);
+        return parameter->left;
+    }
+
+    Symbol *symbol = document->symbolTable ? lookupSymbol(document->symbolTable, identifier) : NULL;
+
+    if (symbol) {
+        describeSymbol(symbol, description, size);
+        if (symbol->declarationLocation.line == 0) strncat(description, "  // imported", size - strlen(description) - 1);
+
+        ASTNode *declaration = findDocumentDeclaration(document, identifier, &symbol->declarationLocation);
+        return declaration ? declaration->left : NULL;
+    }
+
+    // An identifier the analyzer has typed, although it is no longer in scope at the end of the program, where the
+    // types inferred before the document has failed to parse are out of date
+    if (document->symbolTable && strcmp((*node)->inferredType, "Any") != 0) snprintf(description, size, "%s: %s", identifier,
+                                                             (*node)->inferredType);
+    return NULL;
+}
+
+static void handleHover(LanguageServer *server, const JsonValue *id, const JsonValue *params) {
+    Document *document = findDocument(server, getJsonString(params, "textDocument.uri"), NULL);
+    DocumentPosition position = {getJsonInteger(params, "position.line", -1),
+                                 getJsonInteger(params, "position.character", -1)};
+
+    char description[HOVER_LENGTH] = "";
+    ASTNode *node = NULL;
+    if (document) resolveIdentifier(document, position, &node, description, sizeof(description));
+
+    JsonWriter writer = {NULL, 0, 0, 0};
+    beginResponse(&writer, id);
+
+    if (!description[0]) writeJsonRaw(&writer, "null");
+
+    else {
+        char markdown[HOVER_LENGTH + 32];
+        snprintf(markdown, sizeof(markdown), "```opus\n%s\n```", description);
+
+        size_t start = getLocationOffset(document, node->token->location);
+        writeJsonRaw(&writer, "{\"contents\":{\"kind\":\"markdown\",\"value\":");
+        writeJsonString(&writer, markdown, strlen(markdown));
+        writeJsonRaw(&writer, "},\"range\":");
+        writeRange(&writer, document, start, getTokenEnd(document, start));
+        writeJsonRaw(&writer, "}");
+    }
+
+    writeJsonRaw(&writer, "}");
+    sendMessage(server, &writer);
+}
+
+static void handleDefinition(LanguageServer *server, const JsonValue *id, const JsonValue *params) {
+    Document *document = findDocument(server, getJsonString(params, "textDocument.uri"), NULL);
+    DocumentPosition position = {getJsonInteger(params, "position.line", -1),
+                                 getJsonInteger(params, "position.character", -1)};
+
+    char description[HOVER_LENGTH];
+    ASTNode *node = NULL;
+    ASTNode *declaration = document ? resolveIdentifier(document, position, &node, description, sizeof(description))
+                                    : NULL;
+
+    JsonWriter writer = {NULL, 0, 0, 0};
+    beginResponse(&writer, id);
+
+    if (!declaration) writeJsonRaw(&writer, "null");
+
+    else {
+        size_t start = getLocationOffset(document, declaration->token->location);
+        writeJsonRaw(&writer, "{\"uri\":");
+        writeJsonString(&writer, document->uri, strlen(document->uri));
+        writeJsonRaw(&writer, ",\"range\":");
+        writeRange(&writer, document, start, getTokenEnd(document, start));
+        writeJsonRaw(&writer, "}");
+    }
+
+    writeJsonRaw(&writer, "}");
+    sendMessage(server, &writer);
+}
+
+int handleLanguageServerMessage(LanguageServer *server, const char *message, size_t length) {
+    JsonValue *request = parseJson(message, length);
+
+    if (!request || request->type != JSON_OBJECT) {
+        sendError(server, NULL, LSP_ERROR_PARSE, "The message is not a JSON object.");
+        freeJson(request);
+        return 1;
+    }
+
+    const char *method = getJsonString(request, "method");
+    JsonValue *id = getJsonPath(request, "id");
+    JsonValue *params = getJsonPath(request, "params");
+
+    // A response from the client (to a request the server never sends) is ignored
+    if (!method) {
+        if (!id) sendError(server, NULL, LSP_ERROR_INVALID_REQUEST, "The message has no method.");
+        freeJson(request);
+        return 1;
+    }
+
+    if (strcmp(method, "exit") == 0) server->hasExited = 1;
+    else if (strcmp(method, "initialize") == 0 && id) handleInitialize(server, id);
+
+    // Before 'initialize' a request fails and a notification is dropped, and after 'shutdown' only 'exit' is expected
+    else if (!server->isInitialized || server->isShutdown) {
+        if (id) sendError(server, id, server->isShutdown ? LSP_ERROR_INVALID_REQUEST : LSP_ERROR_NOT_INITIALIZED,
+                          server->isShutdown ? "The server has been shut down." : "The server is not initialized.");
+    }
+
+    else if (strcmp(method, "shutdown") == 0 && id) {
+        JsonWriter writer = {NULL, 0, 0, 0};
+        beginResponse(&writer, id);
+        writeJsonRaw(&writer, "null}");
+        sendMessage(server, &writer);
+        server->isShutdown = 1;
+    }
+
+    else if (strcmp(method, "textDocument/didOpen") == 0) handleDidOpen(server, params);
+    else if (strcmp(method, "textDocument/didChange") == 0) handleDidChange(server, params);
+    else if (strcmp(method, "textDocument/didSave") == 0) handleDidSave(server, params);
+    else if (strcmp(method, "textDocument/didClose") == 0) handleDidClose(server, params);
+    else if (strcmp(method, "textDocument/hover") == 0 && id) handleHover(server, id, params);
+    else if (strcmp(method, "textDocument/definition") == 0 && id) handleDefinition(server, id, params);
+
+    // Any other notification (e.g. 'initialized' or '$/cancelRequest') needs no answer
+    else if (id) sendError(server, id, LSP_ERROR_METHOD_NOT_FOUND, "The method is not supported.");
+
+    freeJson(request);
+    return !server->hasExited;
+}
+
+void freeLanguageServer(LanguageServer *server) {
+    if (!server) return;
+
+    for (int index = 0; index < server->documentCount; index++) closeDocument(server->documents[index]);
+    free(server->documents);
+    free(server);
+}
@@ -0,0 +1,36 @@
+// exporter.h
+//
+// A tiny exporter of the metrics of the process (see metrics.h), which a long-running process (e.g. 'opus-run' or
+// 'Opus --watch') starts so that Prometheus, or any HTTP client, could scrape its metrics. The exporter listens on a
+// Unix domain socket rather than on a port, so only the users allowed to open the socket could read it, and it is
+// served by a thread of its own, one connection at a time: a request for '/metrics' is answered by the metrics in the
+// text exposition format, and any other request by 404. Every connection is closed once it has been answered.
+//
+//     curl --unix-socket opus.sock http://localhost/metrics
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#define EXPORTER_REQUEST_LENGTH   4096
+#define EXPORTER_TIMEOUT          1000
+#define EXPORTER_CONTENT_TYPE     "text/plain; version=0.0.4; charset=utf-8"
+
+typedef struct MetricsExporter MetricsExporter;
+
+/// Starts serving the metrics of the process on a Unix domain socket, where a socket left at the path by a previous
+/// process is replaced.
+///
+/// @param socketPath The path of the socket.
+/// @return A pointer to the exporter, or NULL if the socket could not be listened on (which is reported).
+///
+MetricsExporter *startMetricsExporter(const char *socketPath);
+
+/// Stops serving the metrics, once the connection being answered (if any) has been closed, and removes the socket.
+/// @param exporter The exporter to stop, which is freed.
+///
+void stopMetricsExporter(MetricsExporter *exporter);
+
+#endif
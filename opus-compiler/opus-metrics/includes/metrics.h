@@ -0,0 +1,117 @@
+// metrics.h
+//
+// Metrics of the compiler and of the virtual machine of the Opus programming language, for a service running them for
+// a long time. The registry is fixed and global to the process: each counter and each histogram is known in advance,
+// so recording a metric is a single atomic addition, without any lookup or lock. A metric is split into shards of
+// their own cache line, and each thread records into the shard it has been given, so threads executing programs at
+// the same time do not fight over a cache line; reading a metric adds its shards together.
+//
+// A histogram counts durations into buckets growing by powers of 2, from 128 ns up to about 4.3 s, so a duration
+// is counted by finding its highest bit. The registry is read by readMetricCounter() and readMetricHistogram(), or
+// rendered at once in the text exposition format of Prometheus (see exporter.h to serve it).
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define METRIC_SHARD_COUNT     16
+#define METRIC_BUCKET_COUNT    26
+#define METRIC_FIRST_BOUND     7
+
+/// The counters of the registry, where the counters sharing a name (with different labels) follow each other.
+typedef enum {
+    METRIC_COMPILES,                  /// The programs and modules compiled.
+    METRIC_COMPILE_FAILURES,          /// The compilations that have failed.
+    METRIC_QUERY_CACHE_HITS,          /// The statements whose memoized analysis has been reused (see query.h).
+    METRIC_INTERFACE_CACHE_HITS,      /// The imported modules whose interface is still valid (see module.h).
+    METRIC_OBJECT_CACHE_HITS,         /// The C units whose object has been reused (see toolchain.h).
+    METRIC_QUERY_CACHE_MISSES,        /// The statements that have been analyzed again.
+    METRIC_INTERFACE_CACHE_MISSES,    /// The imported modules that have been compiled again.
+    METRIC_OBJECT_CACHE_MISSES,       /// The C units that have been compiled again.
+    METRIC_EXECUTIONS,                /// The executions of prepared programs.
+    METRIC_EXECUTION_FAILURES,        /// The executions that have stopped on a runtime error.
+    METRIC_ALLOCATED_BYTES,           /// The bytes allocated by prepared programs and their executions.
+    METRIC_NATIVE_COMPILATIONS,       /// The C units compiled into native code by the system C compiler.
+    METRIC_COUNTER_COUNT,
+} MetricCounterKind;
+
+/// The histograms of the registry, where the histograms sharing a name (with different labels) follow each other.
+typedef enum {
+    METRIC_PARSE_SECONDS,             /// The time spent parsing a program.
+    METRIC_ANALYZE_SECONDS,           /// The time spent analyzing a program.
+    METRIC_LOWER_SECONDS,             /// The time spent lowering a program into the IR.
+    METRIC_OPTIMIZE_SECONDS,          /// The time spent running the passes (including the frame allocation).
+    METRIC_EMIT_SECONDS,              /// The time spent emitting a program as C or assembling it into bytecode.
+    METRIC_EXECUTION_SECONDS,         /// The time spent executing a prepared program.
+    METRIC_HISTOGRAM_COUNT,
+} MetricHistogramKind;
+
+/// A histogram as read from the registry.
+typedef struct {
+    uint64_t buckets[METRIC_BUCKET_COUNT + 1];   /// The durations in each bucket, where the last one is unbounded.
+    uint64_t count;                              /// The number of durations.
+    uint64_t sumNanoseconds;                     /// The sum of the durations in nanoseconds.
+} MetricHistogramReading;
+
+/// Adds an amount to a counter.
+///
+/// @param counter The counter.
+/// @param amount The amount to add.
+///
+void addMetricCounter(MetricCounterKind counter, uint64_t amount);
+
+/// Counts a duration into a histogram.
+///
+/// @param histogram The histogram.
+/// @param nanoseconds The duration in nanoseconds.
+///
+void observeMetricHistogram(MetricHistogramKind histogram, uint64_t nanoseconds);
+
+/// Counts the time elapsed since a start into a histogram, then moves the start to the current time, so that the
+/// phases of a compilation are timed one after another.
+///
+/// @param histogram The histogram.
+/// @param start The start in nanoseconds (see getMetricNanoseconds()), which is updated.
+///
+void observeMetricSince(MetricHistogramKind histogram, uint64_t *start);
+
+/// Gets the time of a monotonic clock, which only measures durations.
+/// @return The time in nanoseconds.
+///
+uint64_t getMetricNanoseconds(void);
+
+/// Reads a counter, whose shards might still be written by other threads.
+///
+/// @param counter The counter.
+/// @return The value of the counter.
+///
+uint64_t readMetricCounter(MetricCounterKind counter);
+
+/// Reads a histogram, whose shards might still be written by other threads.
+///
+/// @param histogram The histogram.
+/// @param reading Receives the buckets, the count and the sum of the histogram.
+///
+void readMetricHistogram(MetricHistogramKind histogram, MetricHistogramReading *reading);
+
+/// Gets the upper bound of a bucket of every histogram.
+///
+/// @param bucket The index of the bucket, which must be bounded.
+/// @return The upper bound of the bucket in nanoseconds.
+///
+uint64_t getMetricBucketBound(int bucket);
+
+/// Renders every metric in the text exposition format of Prometheus, like snprintf() would.
+///
+/// @param buffer The buffer receiving the text, or NULL to measure it.
+/// @param capacity The capacity of the buffer, where the text is truncated.
+/// @return The length of the whole text, which has only been written if it is less than the capacity.
+///
+size_t renderMetrics(char *buffer, size_t capacity);
+
+#endif
@@ -0,0 +1,174 @@
+// exporter.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#endif
+#include "exporter.h"
+#include "metrics.h"
+
+#ifndef _WIN32
+// A client going away while being answered raises SIGPIPE, unless the platform lets a socket ignore it
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/// An exporter serving the metrics on a socket.
+struct MetricsExporter {
+    char socketPath[sizeof(((struct sockaddr_un*) NULL)->sun_path)];   /// The path of the socket.
+    int listener;           /// The socket accepting the connections.
+    int wakeups[2];         /// A pipe whose end is written to stop the thread.
+    pthread_t thread;       /// The thread serving the connections.
+};
+
+// Writes a whole response, unless the client has gone away
+static void writeExporterBytes(int connection, const char *bytes, size_t length) {
+    while (length > 0) {
+        ssize_t written = send(connection, bytes, length, MSG_NOSIGNAL);
+        if (written <= 0 && errno == EINTR) continue;
+        if (written <= 0) return;
+
+        bytes += written;
+        length -= (size_t) written;
+    }
+}
+
+// Answers a connection, whose request is read until the end of its header (or until it is too long)
+static void answerExporterConnection(int connection) {
+    char request[EXPORTER_REQUEST_LENGTH];
+    size_t length = 0;
+    struct pollfd readable = {connection, POLLIN, 0};
+
+    while (length < sizeof(request) - 1 && poll(&readable, 1, EXPORTER_TIMEOUT) > 0) {
+        ssize_t received = recv(connection, request + length, sizeof(request) - 1 - length, 0);
+        if (received <= 0) break;
+
+        length += (size_t) received;
+        request[length] = '\0';
+        if (strstr(request, "\r\n\r\n")) break;
+    }
+
+    request[length] = '\0';
+    int isMetrics = strncmp(request, "GET /metrics ", 13) == 0 || strncmp(request, "GET /metrics?", 13) == 0;
+    char header[256];
+
+    if (!isMetrics) {
+        const char *body = "Only /metrics is served.\n";
+        int headerLength = snprintf(header, sizeof(header), "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n"
+                                    "Content-Length: %zu\r\nConnection: close\r\n\r\n", strlen(body));
+        writeExporterBytes(connection, header, (size_t) headerLength);
+        writeExporterBytes(connection, body, strlen(body));
+        return;
+    }
+
+    // The metrics are measured first, so the text is rendered into a buffer of its size
+    size_t capacity = renderMetrics(NULL, 0) + 1024;
+    char *body = (char*) malloc(capacity);
+    size_t bodyLength = body ? renderMetrics(body, capacity) : 0;
+    if (bodyLength >= capacity) bodyLength = strlen(body);
+
+    int headerLength = snprintf(header, sizeof(header), "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n"
+                                "Connection: close\r\n\r\n", body ? "200 OK" : "500 Internal Server Error",
+                                EXPORTER_CONTENT_TYPE, bodyLength);
+    writeExporterBytes(connection, header, (size_t) headerLength);
+    if (body) writeExporterBytes(connection, body, bodyLength);
+    free(body);
+}
+
+// Accepts the connections one at a time, until the pipe of the exporter is written
+static void *serveMetricsExporter(void *argument) {
+    MetricsExporter *exporter = (MetricsExporter*) argument;
+    struct pollfd sockets[2] = {{exporter->listener, POLLIN, 0}, {exporter->wakeups[0], POLLIN, 0}};
+
+    while (1) {
+        if (poll(sockets, 2, -1) < 0 && errno != EINTR) break;
+        if (sockets[1].revents) break;
+        if (!(sockets[0].revents & POLLIN)) continue;
+
+        int connection = accept(exporter->listener, NULL, NULL);
+        if (connection < 0) continue;
+
+#ifdef SO_NOSIGPIPE
+        int isIgnored = 1;
+        setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &isIgnored, sizeof(isIgnored));
+#endif
+
+        answerExporterConnection(connection);
+        close(connection);
+    }
+
+    return NULL;
+}
+
+MetricsExporter *startMetricsExporter(const char *socketPath) {
+    MetricsExporter *exporter = (MetricsExporter*) calloc(1, sizeof(MetricsExporter));
+    struct sockaddr_un address;
+    struct stat status;
+
+    if (!exporter || strlen(socketPath) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "[MetricsError]: Socket '%s' could not be listened on.\n", socketPath);
+        free(exporter);
+        return NULL;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath);
+    strcpy(exporter->socketPath, socketPath);
+
+    // A socket left by a process that has not stopped its exporter is replaced, but no other kind of file
+    if (stat(socketPath, &status) == 0 && S_ISSOCK(status.st_mode)) unlink(socketPath);
+
+    exporter->listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    exporter->wakeups[0] = exporter->wakeups[1] = -1;
+
+    int result = exporter->listener >= 0 && bind(exporter->listener, (struct sockaddr*) &address, sizeof(address)) == 0
+                 && listen(exporter->listener, 16) == 0 && pipe(exporter->wakeups) == 0 &&
+                 pthread_create(&exporter->thread, NULL, serveMetricsExporter, exporter) == 0;
+
+    if (!result) {
+        fprintf(stderr, "[MetricsError]: Socket '%s' could not be listened on.\n", socketPath);
+        if (exporter->listener >= 0) close(exporter->listener);
+        if (exporter->wakeups[0] >= 0) close(exporter->wakeups[0]);
+        if (exporter->wakeups[1] >= 0) close(exporter->wakeups[1]);
+        free(exporter);
+        return NULL;
+    }
+
+    return exporter;
+}
+
+void stopMetricsExporter(MetricsExporter *exporter) {
+    if (!exporter) return;
+
+    char wakeup = 1;
+    if (write(exporter->wakeups[1], &wakeup, 1) == 1) pthread_join(exporter->thread, NULL);
+
+    close(exporter->listener);
+    close(exporter->wakeups[0]);
+    close(exporter->wakeups[1]);
+    unlink(exporter->socketPath);
+    free(exporter);
+}
+#else
+MetricsExporter *startMetricsExporter(const char *socketPath) {
+    fprintf(stderr, "[MetricsError]: Socket '%s' could not be listened on, since Unix domain sockets are not "
+                    "supported.\n", socketPath);
+    return NULL;
+}
+
+void stopMetricsExporter(MetricsExporter *exporter) {
+    (void) exporter;
+}
+#endif
@@ -0,0 +1,209 @@
+// metrics.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "metrics.h"
+
+/// A shard of a counter, alone on its cache line.
+typedef struct {
+    _Alignas(64) atomic_uint_fast64_t value;
+} MetricShard;
+
+/// A shard of a histogram, starting on a cache line of its own.
+typedef struct {
+    _Alignas(64) atomic_uint_fast64_t buckets[METRIC_BUCKET_COUNT + 1];
+    atomic_uint_fast64_t count;
+    atomic_uint_fast64_t sumNanoseconds;
+} MetricHistogramShard;
+
+/// How a metric is rendered.
+typedef struct {
+    const char *name;     /// The name of the metric, shared by the metrics differing by their labels.
+    const char *labels;   /// The labels of the metric, or "".
+    const char *help;     /// The description of the metric.
+} MetricDefinition;
+
+static const MetricDefinition counterDefinitions[METRIC_COUNTER_COUNT] = {
+    {"opus_compiles_total", "", "Programs and modules compiled, whether they have succeeded or not."},
+    {"opus_compile_failures_total", "", "Compilations that have failed."},
+    {"opus_cache_hits_total", "cache=\"query\"", "Lookups served by a cache."},
+    {"opus_cache_hits_total", "cache=\"interface\"", NULL},
+    {"opus_cache_hits_total", "cache=\"object\"", NULL},
+    {"opus_cache_misses_total", "cache=\"query\"", "Lookups missing from a cache, whose work has been done again."},
+    {"opus_cache_misses_total", "cache=\"interface\"", NULL},
+    {"opus_cache_misses_total", "cache=\"object\"", NULL},
+    {"opus_executions_total", "", "Executions of prepared programs, whether they have succeeded or not."},
+    {"opus_execution_failures_total", "", "Executions that have stopped on a runtime error."},
+    {"opus_allocated_bytes_total", "", "Bytes allocated by prepared programs and their executions."},
+    {"opus_native_compilations_total", "", "C units compiled into native code by the system C compiler."},
+};
+
+static const MetricDefinition histogramDefinitions[METRIC_HISTOGRAM_COUNT] = {
+    {"opus_phase_seconds", "phase=\"parse\"", "Time spent in each phase of a compilation."},
+    {"opus_phase_seconds", "phase=\"analyze\"", NULL},
+    {"opus_phase_seconds", "phase=\"lower\"", NULL},
+    {"opus_phase_seconds", "phase=\"optimize\"", NULL},
+    {"opus_phase_seconds", "phase=\"emit\"", NULL},
+    {"opus_execution_seconds", "", "Time spent executing a prepared program."},
+};
+
+static MetricShard counters[METRIC_COUNTER_COUNT][METRIC_SHARD_COUNT];
+static MetricHistogramShard histograms[METRIC_HISTOGRAM_COUNT][METRIC_SHARD_COUNT];
+
+// The shard of each thread, given in turn to the threads as they record their first metric
+static atomic_int nextShard = 0;
+static _Thread_local int threadShard = -1;
+
+/// A text being rendered, which is written as long as it fits.
+typedef struct {
+    char *buffer;         /// The buffer receiving the text, or NULL.
+    size_t capacity;      /// The capacity of the buffer.
+    size_t length;        /// The length of the whole text so far.
+} MetricText;
+
+// Gets the shard of the calling thread
+static int getMetricShard(void) {
+    if (threadShard < 0) {
+        threadShard = atomic_fetch_add_explicit(&nextShard, 1, memory_order_relaxed) % METRIC_SHARD_COUNT;
+    }
+
+    return threadShard;
+}
+
+void addMetricCounter(MetricCounterKind counter, uint64_t amount) {
+    atomic_fetch_add_explicit(&counters[counter][getMetricShard()].value, amount, memory_order_relaxed);
+}
+
+void observeMetricHistogram(MetricHistogramKind histogram, uint64_t nanoseconds) {
+    MetricHistogramShard *shard = &histograms[histogram][getMetricShard()];
+
+    // The bucket of a duration is the power of 2 rounding it up, counted from the first bound
+    int bucket = 0;
+    if (nanoseconds > (1u << METRIC_FIRST_BOUND)) bucket = 64 - __builtin_clzll(nanoseconds - 1) - METRIC_FIRST_BOUND;
+    if (bucket > METRIC_BUCKET_COUNT) bucket = METRIC_BUCKET_COUNT;
+
+    atomic_fetch_add_explicit(&shard->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&shard->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&shard->sumNanoseconds, nanoseconds, memory_order_relaxed);
+}
+
+void observeMetricSince(MetricHistogramKind histogram, uint64_t *start) {
+    uint64_t now = getMetricNanoseconds();
+    observeMetricHistogram(histogram, now - *start);
+    *start = now;
+}
+
+uint64_t getMetricNanoseconds(void) {
+    struct timespec now;
+#ifndef _WIN32
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#else
+    timespec_get(&now, TIME_UTC);
+#endif
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+uint64_t readMetricCounter(MetricCounterKind counter) {
+    uint64_t value = 0;
+
+    for (int shard = 0; shard < METRIC_SHARD_COUNT; shard++) {
+        value += atomic_load_explicit(&counters[counter][shard].value, memory_order_relaxed);
+    }
+
+    return value;
+}
+
+void readMetricHistogram(MetricHistogramKind histogram, MetricHistogramReading *reading) {
+    memset(reading, 0, sizeof(MetricHistogramReading));
+
+    for (int index = 0; index < METRIC_SHARD_COUNT; index++) {
+        MetricHistogramShard *shard = &histograms[histogram][index];
+
+        for (int bucket = 0; bucket <= METRIC_BUCKET_COUNT; bucket++) {
+            reading->buckets[bucket] += atomic_load_explicit(&shard->buckets[bucket], memory_order_relaxed);
+        }
+
+        reading->count += atomic_load_explicit(&shard->count, memory_order_relaxed);
+        reading->sumNanoseconds += atomic_load_explicit(&shard->sumNanoseconds, memory_order_relaxed);
+    }
+}
+
+uint64_t getMetricBucketBound(int bucket) {
+    return (uint64_t) 1 << (bucket + METRIC_FIRST_BOUND);
+}
+
+// Appends formatted text, which is only written while it fits into the buffer
+static void appendMetricText(MetricText *text, const char *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    size_t room = text->buffer && text->length < text->capacity ? text->capacity - text->length : 0;
+    int length = vsnprintf(room > 0 ? text->buffer + text->length : NULL, room, format, arguments);
+    va_end(arguments);
+
+    if (length > 0) text->length += (size_t) length;
+}
+
+// Formats nanoseconds as exact decimal seconds (e.g. "0.000000512" rather than the "5.12e-07" of a double), where
+// the trailing zeros of the fraction are left out
+static void formatMetricSeconds(uint64_t nanoseconds, char *buffer, size_t capacity) {
+    int length = snprintf(buffer, capacity, "%llu.%09llu", (unsigned long long) (nanoseconds / 1000000000u),
+                          (unsigned long long) (nanoseconds % 1000000000u));
+    while (length > 0 && buffer[length - 1] == '0') buffer[--length] = '\0';
+    if (length > 0 && buffer[length - 1] == '.') buffer[--length] = '\0';
+}
+
+// Appends the description and the type of a metric before the first metric of its name
+static void appendMetricHeading(MetricText *text, const MetricDefinition *definition, const char *type) {
+    if (!definition->help) return;
+    appendMetricText(text, "# HELP %s %s\n# TYPE %s %s\n", definition->name, definition->help, definition->name, type);
+}
+
+size_t renderMetrics(char *buffer, size_t capacity) {
+    MetricText text = {buffer, capacity, 0};
+    if (buffer && capacity > 0) buffer[0] = '\0';
+
+    for (int counter = 0; counter < METRIC_COUNTER_COUNT; counter++) {
+        const MetricDefinition *definition = &counterDefinitions[counter];
+        appendMetricHeading(&text, definition, "counter");
+        appendMetricText(&text, "%s%s%s%s %llu\n", definition->name, definition->labels[0] ? "{" : "",
+                         definition->labels, definition->labels[0] ? "}" : "",
+                         (unsigned long long) readMetricCounter((MetricCounterKind) counter));
+    }
+
+    // The buckets of Prometheus are cumulative, each counting every duration up to its bound, where the count is that
+    // of the unbounded bucket, so both agree while the histogram is being written
+    for (int histogram = 0; histogram < METRIC_HISTOGRAM_COUNT; histogram++) {
+        const MetricDefinition *definition = &histogramDefinitions[histogram];
+        const char *separator = definition->labels[0] ? "," : "";
+        MetricHistogramReading reading;
+        uint64_t cumulative = 0;
+        char seconds[32];
+
+        readMetricHistogram((MetricHistogramKind) histogram, &reading);
+        appendMetricHeading(&text, definition, "histogram");
+
+        for (int bucket = 0; bucket < METRIC_BUCKET_COUNT; bucket++) {
+            cumulative += reading.buckets[bucket];
+            formatMetricSeconds(getMetricBucketBound(bucket), seconds, sizeof(seconds));
+            appendMetricText(&text, "%s_bucket{%s%sle=\"%s\"} %llu\n", definition->name, definition->labels,
+                             separator, seconds, (unsigned long long) cumulative);
+        }
+
+        cumulative += reading.buckets[METRIC_BUCKET_COUNT];
+        appendMetricText(&text, "%s_bucket{%s%sle=\"+Inf\"} %llu\n", definition->name, definition->labels,
+                         separator, (unsigned long long) cumulative);
+        formatMetricSeconds(reading.sumNanoseconds, seconds, sizeof(seconds));
+        appendMetricText(&text, "%s_sum%s%s%s %s\n", definition->name, definition->labels[0] ? "{" : "",
+                         definition->labels, definition->labels[0] ? "}" : "", seconds);
+        appendMetricText(&text, "%s_count%s%s%s %llu\n", definition->name, definition->labels[0] ? "{" : "",
+                         definition->labels, definition->labels[0] ? "}" : "", (unsigned long long) cumulative);
+    }
+
+    return text.length;
+}
@@ -0,0 +1,109 @@
+// interface.h
+//
+// Module interfaces of the Opus programming language. Once a module has been compiled, the signatures of its
+// top-level functions and the values of its top-level constants are summarized into a compact binary file next to
+// its source code (e.g. 'geometry.opusi' for 'geometry.opus'). A module importing it only reads the interface, so
+// the source code of a dependency is never parsed again. The interface also records the hash of the source code
+// and the hash of the interface of each dependency it has been compiled against, which tells whether it is stale.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef INTERFACE_H
+#define INTERFACE_H
+
+#include <stdint.h>
+#include "ir.h"
+#include "symbol.h"
+
+#define INTERFACE_MAGIC               "OPSI"
+#define INTERFACE_VERSION             1
+#define INTERFACE_MAX_DEPENDENCIES    64
+#define INTERFACE_HASH_SEED           14695981039346656037ULL
+
+/// The exports of a compiled module, together with what it has been compiled from.
+typedef struct {
+    char name[LEXEME_LENGTH];                                            /// The name of the module.
+    uint64_t sourceHash;                                                 /// The hash of the source code.
+    uint64_t interfaceHash;                                              /// The hash of the exports only.
+    char dependencyNames[INTERFACE_MAX_DEPENDENCIES][LEXEME_LENGTH];     /// The name of each imported module.
+    uint64_t dependencyHashes[INTERFACE_MAX_DEPENDENCIES];               /// The interface hash of each import.
+    int dependencyCount;                                                 /// The number of imported modules.
+    IRExternal *exports;                                                 /// The exported functions and constants.
+    int exportCount;                                                     /// The number of exports.
+    int exportCapacity;                                                  /// The allocated capacity of the exports.
+} ModuleInterface;
+
+/// Initializes an empty interface for a module.
+///
+/// @param name The name of the module.
+/// @return A pointer to the newly allocated ModuleInterface, or NULL if memory allocation fails.
+///
+ModuleInterface *initModuleInterface(const char *name);
+
+/// Adds an export to an interface.
+///
+/// @param interface The interface to add the export to.
+/// @param external The exported function or constant, which is copied.
+/// @return The index of the export, or -1 if memory allocation fails.
+///
+int addInterfaceExport(ModuleInterface *interface, const IRExternal *external);
+
+/// Summarizes the exports of a compiled module, that is every function implemented at the top level and every
+/// top-level constant whose value is known at compile time. The interface hash is computed from the exports.
+///
+/// @param name The name of the module.
+/// @param root Pointer to the root node of the analyzed AST of the module.
+/// @param symbolTable The symbol table of the analyzed module.
+/// @param program The lowered program of the module.
+/// @return A pointer to the newly allocated ModuleInterface, or NULL if memory allocation fails.
+///
+ModuleInterface *extractModuleInterface(const char *name, ASTNode *root, SymbolTable *symbolTable, IRProgram *program);
+
+/// Declares the exports of an imported module, where the constants are added to the symbol table as known values
+/// and every export becomes an external of the program.
+///
+/// @param interface The interface of the imported module.
+/// @param symbolTable The symbol table of the importing module.
+/// @param program The program of the importing module, before it is lowered.
+///
+void declareModuleInterface(ModuleInterface *interface, SymbolTable *symbolTable, IRProgram *program);
+
+/// Computes the hash of the exports of an interface, which only changes if a signature or a constant changes.
+///
+/// @param interface The interface to hash.
+/// @return The hash of the exports.
+///
+uint64_t hashInterfaceExports(ModuleInterface *interface);
+
+/// Computes the 64-bit FNV-1a hash of a sequence of bytes.
+///
+/// @param bytes The bytes to hash.
+/// @param length The number of bytes.
+/// @param hash The hash to continue from (e.g. INTERFACE_HASH_SEED).
+/// @return The hash of the bytes.
+///
+uint64_t hashBytes(const void *bytes, size_t length, uint64_t hash);
+
+/// Writes an interface into a binary file.
+///
+/// @param interface The interface to write.
+/// @param path The path of the interface file.
+/// @return 1 (True) on success, 0 (False) if the file could not be written.
+///
+int writeModuleInterface(ModuleInterface *interface, const char *path);
+
+/// Reads an interface from a binary file.
+///
+/// @param path The path of the interface file.
+/// @return A pointer to the newly allocated ModuleInterface, or NULL if the file is missing, malformed or written by
+///         another version of the interface format.
+///
+ModuleInterface *readModuleInterface(const char *path);
+
+/// Frees an interface and its exports.
+/// @param interface The interface to free.
+///
+void freeModuleInterface(ModuleInterface *interface);
+
+#endif
@@ -0,0 +1,66 @@
+// loader.h
+//
+// Loading the source files of a build into memory in batches, so that discovering thousands of modules does not wait
+// on an open, a read and a close of each file in turn. On Linux, the files of a batch are loaded through an io_uring:
+// the open and the size of every file are submitted at once, and the read of a file is submitted as soon as it has
+// been opened, so up to LOADER_OPEN_LIMIT files are in flight with a single system call per round of completions.
+// Elsewhere, or if io_uring is not available (e.g. it is disabled by the system, or 'OPUS_LOADER=pread' is set), a
+// pool of threads opens and reads the files with pread(). Either way, a file is handed over as soon as its read has
+// completed, so it is scanned while the other files of the batch are still being read.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stddef.h>
+
+#define LOADER_RING_ENTRIES    256
+#define LOADER_OPEN_LIMIT      64
+#define LOADER_THREAD_COUNT    8
+
+/// A source file loaded into memory.
+typedef struct {
+    char *bytes;      /// The bytes of the file followed by '\0', or NULL if the file could not be read.
+    size_t length;    /// The length of the file in bytes.
+} SourceFile;
+
+/// How the files of a batch have been loaded.
+typedef enum {
+    SOURCE_LOADER_IO_URING,   /// The opens and the reads have been submitted to an io_uring.
+    SOURCE_LOADER_PREAD,      /// A pool of threads has opened and read the files with pread().
+} SourceLoaderKind;
+
+/// The time taken to load the batches of a build.
+typedef struct {
+    SourceLoaderKind kind;    /// How the last batch has been loaded.
+    int fileCount;            /// The number of files loaded.
+    size_t byteCount;         /// The number of bytes read.
+    double firstSeconds;      /// The time until the first file of the first batch has been handed over.
+    double totalSeconds;      /// The time spent loading every batch.
+} SourceLoadStatistics;
+
+/// Receives a file as soon as it has been read, whose bytes are owned by the caller of loadSourceFiles() from then
+/// on. With a pool of threads, the handler is called from several threads at once, each time for a different file.
+typedef void (*SourceLoadedHandler)(void *context, int index, SourceFile *file);
+
+/// Loads a batch of files into memory, and hands each of them over as soon as it has been read. A file that could
+/// not be read is still handed over, without bytes.
+///
+/// @param paths The path of each file.
+/// @param count The number of files.
+/// @param files An array receiving each file, in the order of the paths.
+/// @param handler The handler receiving each file, or NULL.
+/// @param context The context passed to the handler.
+/// @param statistics The statistics the batch is added to, or NULL.
+///
+void loadSourceFiles(const char *const *paths, int count, SourceFile *files, SourceLoadedHandler handler,
+                     void *context, SourceLoadStatistics *statistics);
+
+/// Displays how many files have been loaded, how they have been loaded and how long it took.
+/// @param statistics The statistics of the batches.
+///
+void displaySourceLoadStatistics(const SourceLoadStatistics *statistics);
+
+#endif
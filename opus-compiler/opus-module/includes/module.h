@@ -0,0 +1,154 @@
+// module.h
+//
+// Modules and separate compilation of the Opus programming language. Each source file is a module named after the
+// file, and 'import geometry' makes the exports of 'geometry.opus' (next to the importing file) visible. The driver
+// discovers the modules reachable from the compiled file into a dependency graph, then compiles each dependency
+// once the modules it imports are ready, where independent modules are compiled in parallel by separate processes.
+// A module is only compiled again if its source code has changed or the interface of a module it imports has
+// changed, so editing the body of a function does not recompile the modules that import it. With an output
+// directory for C, each module is emitted as C as well (see emitter.h), and the modules are linked into an executable.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef MODULE_H
+#define MODULE_H
+
+#include <stdint.h>
+#include "interface.h"
+#include "query.h"
+#include "loader.h"
+
+#define MODULE_SOURCE_EXTENSION      ".opus"
+#define MODULE_INTERFACE_EXTENSION   ".opusi"
+#define MODULE_PATH_LENGTH           1024
+#define MODULE_MAX_IMPORTS           INTERFACE_MAX_DEPENDENCIES
+#define MODULE_WATCH_INTERVAL        250
+
+/// The options shared by every module being compiled.
+typedef struct {
+    int level;                     /// The optimization level.
+    const char *passList;          /// The passes named by '--passes=', or NULL for the level preset.
+    int isStatisticsDisplayed;     /// Whether the statistics of the passes are displayed.
+    int jobCount;                  /// The maximum number of modules compiled at the same time.
+    QueryDatabase *queryDatabase;  /// The memoized analysis of the compiled file kept between compilations, or NULL.
+    const char *cDirectory;        /// The directory receiving the C code of every module, or NULL.
+    int isOverflowChecked;         /// Whether Int arithmetic fails on overflow at runtime ('--checked').
+} CompileOptions;
+
+/// The progress of building a module.
+typedef enum {
+    MODULE_PENDING,      /// The module waits for the modules it imports.
+    MODULE_COMPILING,    /// The module is being compiled.
+    MODULE_UP_TO_DATE,   /// The interface of the module is still valid, so it is not compiled.
+    MODULE_COMPILED,     /// The module has been compiled and its interface has been written.
+    MODULE_FAILED,       /// The module (or a module it imports) could not be compiled.
+} ModuleState;
+
+/// A module of the dependency graph.
+typedef struct {
+    char name[LEXEME_LENGTH];                   /// The name of the module, that is its file name without extension.
+    char sourcePath[MODULE_PATH_LENGTH];        /// The path of the source code.
+    char interfacePath[MODULE_PATH_LENGTH];     /// The path of the interface file.
+    int imports[MODULE_MAX_IMPORTS];            /// The index of each imported module in the graph.
+    int importCount;                            /// The number of imported modules.
+    char *source;                               /// The source code loaded by discoverModules(), or NULL.
+    size_t sourceLength;                        /// The length of the source code in bytes.
+    uint64_t sourceHash;                        /// The hash of the source code.
+    ModuleState state;                          /// The progress of building the module.
+    ModuleInterface *interface;                 /// The interface, once the module is up to date or compiled.
+} Module;
+
+/// The modules reachable from the compiled file, where the module 0 is the compiled file itself.
+typedef struct {
+    Module *modules;      /// The modules of the graph.
+    int moduleCount;      /// The number of modules.
+    int moduleCapacity;   /// The allocated capacity of the module array.
+    int *pathTable;       /// The index of each module by the hash of its source path (open addressing), or -1.
+    int pathCapacity;     /// The capacity of the table, which is a power of 2 kept at most half full.
+    int *order;           /// The modules in topological order, where each module follows the modules it imports.
+    SourceLoadStatistics loadStatistics;   /// The time taken to load the source code of the modules.
+} ModuleGraph;
+
+/// Discovers the modules imported (directly or not) by a source file, and orders them topologically. The modules
+/// are discovered a level of imports at a time, where the source code of every module of a level is loaded in one
+/// batch (see loader.h) and kept in the graph, so that each file is read once by the whole build.
+///
+/// @param rootPath The path of the compiled source file.
+/// @return A pointer to the newly allocated ModuleGraph, or NULL if a module is missing or modules import each other
+///         (which is reported).
+///
+ModuleGraph *discoverModules(const char *rootPath);
+
+/// Scans the import declarations of a source code without parsing it, where each import is a statement of its own
+/// line, so that the graph is known before any module is compiled.
+///
+/// @param source The source code, terminated by '\0'.
+/// @param names An array receiving the names of the imported modules.
+/// @param capacity The capacity of the array.
+/// @return The number of imports, which might exceed the capacity.
+///
+int scanModuleImports(const char *source, char names[][LEXEME_LENGTH], int capacity);
+
+/// Checks if the interface file of a module is still valid, that is it has been compiled from the same source code
+/// against the same interfaces of the modules it imports. If so, the interface is loaded into the module.
+///
+/// @param graph The dependency graph.
+/// @param index The index of the module, whose imported modules must be ready.
+/// @return 1 (True) if the module is up to date, 0 (False) if it must be compiled.
+///
+int isModuleUpToDate(ModuleGraph *graph, int index);
+
+/// Builds every module imported by the compiled file in topological order, compiling up to `jobCount` independent
+/// modules in parallel. The output of a module is only displayed if it fails to compile.
+///
+/// @param graph The dependency graph.
+/// @param options The options of the compilation.
+/// @return 1 (True) if every imported module is ready, 0 (False) otherwise.
+///
+int buildModules(ModuleGraph *graph, CompileOptions *options);
+
+/// Compiles a module whose imported modules are ready, and writes its interface unless it is the compiled file.
+///
+/// @param graph The dependency graph.
+/// @param index The index of the module.
+/// @param options The options of the compilation.
+/// @return 1 (True) on success, 0 (False) if semantic errors are detected, or -1 if the module could not be parsed.
+///
+int compileModule(ModuleGraph *graph, int index, CompileOptions *options);
+
+/// Checks if the C code of a module in the output directory has been emitted from its current source code with the
+/// current optimization level and passes, so that an imported module whose interface is up to date is not compiled
+/// again only to emit its C code.
+///
+/// @param graph The dependency graph.
+/// @param index The index of the module.
+/// @param options The options of the compilation, whose output directory for C must be set.
+/// @return 1 (True) if the C code of the module is up to date, 0 (False) otherwise.
+///
+int isModuleCodeUpToDate(ModuleGraph *graph, int index, CompileOptions *options);
+
+/// Compiles the C code of every module of the graph, which has been emitted into the output directory, and links it
+/// into an executable named after the compiled file in the same directory (see toolchain.h).
+///
+/// @param graph The dependency graph, whose modules have all been compiled.
+/// @param options The options of the compilation, whose output directory for C must be set.
+/// @return 1 (True) if the executable has been linked, 0 (False) otherwise.
+///
+int linkModules(ModuleGraph *graph, CompileOptions *options);
+
+/// Compiles a source file each time it (or a module it imports) changes, until the process is interrupted. The
+/// analysis of the compiled file is incremental, so only the statements affected by an edit are analyzed again.
+///
+/// @param rootPath The path of the compiled source file.
+/// @param options The options of the compilation.
+/// @return 0 (False) if the compilation could not be watched, otherwise it does not return.
+///
+int watchModules(const char *rootPath, CompileOptions *options);
+
+/// Frees a dependency graph and the interfaces of its modules.
+/// @param graph The graph to free.
+///
+void freeModuleGraph(ModuleGraph *graph);
+
+#endif
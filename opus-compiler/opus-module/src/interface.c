@@ -0,0 +1,343 @@
+// interface.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "interface.h"
+#include "integer.h"
+#include "vector.h"
+
+/// A growable array of bytes, where multi-byte integers are stored in little-endian order so that an interface
+/// could be read on any machine.
+typedef struct {
+    unsigned char *bytes;
+    size_t length;
+    size_t capacity;
+    int hasFailed;
+} InterfaceBuffer;
+
+static void writeBufferBytes(InterfaceBuffer *buffer, const void *bytes, size_t length) {
+    if (buffer->hasFailed) return;
+
+    if (buffer->length + length > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 256;
+        while (capacity < buffer->length + length) capacity *= 2;
+
+        unsigned char *grown = (unsigned char*) realloc(buffer->bytes, capacity);
+        if (!grown) {
+            buffer->hasFailed = 1;
+            return;
+        }
+
+        buffer->bytes = grown;
+        buffer->capacity = capacity;
+    }
+
+    memcpy(buffer->bytes + buffer->length, bytes, length);
+    buffer->length += length;
+}
+
+static void writeBufferInteger(InterfaceBuffer *buffer, uint64_t value, int size) {
+    unsigned char bytes[8];
+    for (int index = 0; index < size; index++) bytes[index] = (unsigned char) (value >> (8 * index));
+    writeBufferBytes(buffer, bytes, size);
+}
+
+static void writeBufferString(InterfaceBuffer *buffer, const char *string) {
+    size_t length = strlen(string);
+    writeBufferInteger(buffer, length, 2);
+    writeBufferBytes(buffer, string, length);
+}
+
+/// A cursor over the bytes of an interface file, which fails instead of reading past the end.
+typedef struct {
+    const unsigned char *bytes;
+    size_t length;
+    size_t position;
+    int hasFailed;
+} InterfaceReader;
+
+static uint64_t readInteger(InterfaceReader *reader, int size) {
+    if (reader->hasFailed || reader->position + size > reader->length) {
+        reader->hasFailed = 1;
+        return 0;
+    }
+
+    uint64_t value = 0;
+    for (int index = 0; index < size; index++) value |= (uint64_t) reader->bytes[reader->position++] << (8 * index);
+    return value;
+}
+
+static void readString(InterfaceReader *reader, char *string) {
+    size_t length = (size_t) readInteger(reader, 2);
+
+    if (reader->hasFailed || length >= LEXEME_LENGTH || reader->position + length > reader->length) {
+        reader->hasFailed = 1;
+        string[0] = '\0';
+        return;
+    }
+
+    memcpy(string, reader->bytes + reader->position, length);
+    string[length] = '\0';
+    reader->position += length;
+}
+
+// Each export is its kind, its name and type, then either the parameters of a function or the value of a constant
+static void writeExports(InterfaceBuffer *buffer, ModuleInterface *interface) {
+    writeBufferInteger(buffer, interface->exportCount, 4);
+
+    for (int index = 0; index < interface->exportCount; index++) {
+        IRExternal *external = &interface->exports[index];
+        writeBufferInteger(buffer, external->isFunction, 1);
+        writeBufferString(buffer, external->identifier);
+        writeBufferInteger(buffer, external->type, 1);
+
+        if (external->isFunction) {
+            writeBufferInteger(buffer, external->parameterCount, 1);
+
+            for (int parameter = 0; parameter < external->parameterCount; parameter++) {
+                writeBufferString(buffer, external->parameterLabels[parameter]);
+                writeBufferInteger(buffer, external->parameterTypes[parameter], 1);
+            }
+        }
+
+        else if (external->type == IR_TYPE_STRING) writeBufferString(buffer, external->stringValue);
+        else writeBufferInteger(buffer, (uint32_t) external->value.integerValue, 4);
+    }
+}
+
+ModuleInterface *initModuleInterface(const char *name) {
+    ModuleInterface *interface = (ModuleInterface*) calloc(1, sizeof(ModuleInterface));
+    if (!interface) return NULL;
+
+    strncpy(interface->name, name, LEXEME_LENGTH - 1);
+    return interface;
+}
+
+int addInterfaceExport(ModuleInterface *interface, const IRExternal *external) {
+    if (interface->exportCount == interface->exportCapacity) {
+        int capacity = interface->exportCapacity ? interface->exportCapacity * 2 : 8;
+        IRExternal *exports = (IRExternal*) realloc(interface->exports, capacity * sizeof(IRExternal));
+        if (!exports) return -1;
+
+        interface->exports = exports;
+        interface->exportCapacity = capacity;
+    }
+
+    interface->exports[interface->exportCount] = *external;
+    return interface->exportCount++;
+}
+
+ModuleInterface *extractModuleInterface(const char *name, ASTNode *root, SymbolTable *symbolTable, IRProgram *program) {
+    ModuleInterface *interface = initModuleInterface(name);
+    if (!interface) return NULL;
+
+    // Export the functions implemented at the top level, in the order they are implemented, where a generic function
+    // is never found (only its specializations are functions), so it stays private to its module
+    for (ASTNode *statement = root; statement; statement = statement->right) {
+        if (!statement->left || statement->left->nodeType != AST_FUNCTION_IMPLEMENTATION) continue;
+
+        int index = findIRFunction(program, statement->left->left->left->token->lexeme);
+        if (index <= 0) continue;
+
+        IRFunction *function = program->functions[index];
+        IRExternal external = {0};
+
+        if (function->parameterCount > IR_MAX_PARAMETERS) {
+            printf("[ERROR] Function '%s' has more than %d parameters, which could not be exported.\n",
+                   function->name, IR_MAX_PARAMETERS);
+            continue;
+        }
+
+        strcpy(external.identifier, function->name);
+        strcpy(external.module, name);
+        external.isFunction = 1;
+        external.type = function->returnType;
+        external.parameterCount = function->parameterCount;
+
+        for (int parameter = 0; parameter < function->parameterCount; parameter++) {
+            strcpy(external.parameterLabels[parameter], function->locals[parameter].identifier);
+            external.parameterTypes[parameter] = function->locals[parameter].type;
+        }
+
+        addInterfaceExport(interface, &external);
+    }
+
+    // Export the top-level constants whose values are known, where the symbol table lists the latest ones first, and
+    // the imported constants (declared at line 0) are not exported again, nor are vectors (which a constant of an
+    // interface could not hold)
+    for (Symbol *symbol = symbolTable->headSymbol; symbol; symbol = symbol->nextSymbol) {
+        IRType type = getIRType(symbol->type);
+        if (symbol->namespace != 0 || symbol->isMutable || !symbol->isFoldable) continue;
+        if (symbol->declarationLocation.line == 0) continue;
+        if (type == IR_TYPE_ANY || type == IR_TYPE_VOID || isIRVectorType(type)) continue;
+
+        IRExternal external = {0};
+        strcpy(external.identifier, symbol->identifier);
+        strcpy(external.module, name);
+        external.type = type;
+
+        if (getIRIntegerWidth(type)) external.value.integerValue = symbol->symbolValue.integerValue;
+        else if (type == IR_TYPE_FLOAT) external.value.floatingValue = symbol->symbolValue.floatingValue;
+        else if (type == IR_TYPE_BOOL) external.value.booleanValue = symbol->symbolValue.booleanValue;
+        else strcpy(external.stringValue, symbol->symbolValue.stringLiteral);
+
+        addInterfaceExport(interface, &external);
+    }
+
+    interface->interfaceHash = hashInterfaceExports(interface);
+    return interface;
+}
+
+void declareModuleInterface(ModuleInterface *interface, SymbolTable *symbolTable, IRProgram *program) {
+    Location location = {0, 0};
+
+    for (int index = 0; index < interface->exportCount; index++) {
+        IRExternal *external = &interface->exports[index];
+        addIRExternal(program, external);
+        if (external->isFunction) continue;
+
+        // An imported constant is an initialized global whose value is known, so it is folded like a local one
+        addSymbol(symbolTable, external->identifier, getIRTypeName(external->type), location);
+        Symbol *symbol = symbolTable->headSymbol;
+        symbol->hasInitialized = 1;
+        symbol->isFoldable = 1;
+
+        if (getIRIntegerWidth(external->type)) symbol->symbolValue.integerValue = external->value.integerValue;
+        else if (external->type == IR_TYPE_FLOAT) symbol->symbolValue.floatingValue = external->value.floatingValue;
+        else if (external->type == IR_TYPE_BOOL) symbol->symbolValue.booleanValue = external->value.booleanValue;
+        else strcpy(symbol->symbolValue.stringLiteral, external->stringValue);
+    }
+}
+
+uint64_t hashInterfaceExports(ModuleInterface *interface) {
+    InterfaceBuffer buffer = {NULL, 0, 0, 0};
+    writeExports(&buffer, interface);
+
+    uint64_t hash = hashBytes(buffer.bytes, buffer.length, INTERFACE_HASH_SEED);
+    free(buffer.bytes);
+    return hash;
+}
+
+uint64_t hashBytes(const void *bytes, size_t length, uint64_t hash) {
+    const unsigned char *data = (const unsigned char*) bytes;
+
+    for (size_t index = 0; index < length; index++) {
+        hash ^= data[index];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+int writeModuleInterface(ModuleInterface *interface, const char *path) {
+    InterfaceBuffer buffer = {NULL, 0, 0, 0};
+
+    writeBufferBytes(&buffer, INTERFACE_MAGIC, strlen(INTERFACE_MAGIC));
+    writeBufferInteger(&buffer, INTERFACE_VERSION, 4);
+    writeBufferString(&buffer, interface->name);
+    writeBufferInteger(&buffer, interface->sourceHash, 8);
+    writeBufferInteger(&buffer, interface->interfaceHash, 8);
+    writeBufferInteger(&buffer, interface->dependencyCount, 4);
+
+    for (int index = 0; index < interface->dependencyCount; index++) {
+        writeBufferString(&buffer, interface->dependencyNames[index]);
+        writeBufferInteger(&buffer, interface->dependencyHashes[index], 8);
+    }
+
+    writeExports(&buffer, interface);
+
+    FILE *file = buffer.hasFailed ? NULL : fopen(path, "wb");
+    int result = file && fwrite(buffer.bytes, 1, buffer.length, file) == buffer.length;
+    if (file) result = (fclose(file) == 0) && result;
+
+    free(buffer.bytes);
+    return result;
+}
+
+ModuleInterface *readModuleInterface(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    // Interfaces are small, so the whole file is read at once
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    rewind(file);
+
+    unsigned char *bytes = length > 0 ? (unsigned char*) malloc(length) : NULL;
+    int isRead = bytes && length >= (long) strlen(INTERFACE_MAGIC) && fread(bytes, 1, length, file) == (size_t) length;
+    fclose(file);
+
+    if (!isRead || memcmp(bytes, INTERFACE_MAGIC, strlen(INTERFACE_MAGIC)) != 0) {
+        free(bytes);
+        return NULL;
+    }
+
+    InterfaceReader reader = {bytes, (size_t) length, strlen(INTERFACE_MAGIC), 0};
+    char name[LEXEME_LENGTH];
+    ModuleInterface *interface = NULL;
+
+    if (readInteger(&reader, 4) == INTERFACE_VERSION) {
+        readString(&reader, name);
+        interface = initModuleInterface(name);
+    }
+
+    if (!interface) {
+        free(bytes);
+        return NULL;
+    }
+
+    interface->sourceHash = readInteger(&reader, 8);
+    interface->interfaceHash = readInteger(&reader, 8);
+    interface->dependencyCount = (int) readInteger(&reader, 4);
+    if (interface->dependencyCount > INTERFACE_MAX_DEPENDENCIES) reader.hasFailed = 1;
+
+    for (int index = 0; index < interface->dependencyCount && !reader.hasFailed; index++) {
+        readString(&reader, interface->dependencyNames[index]);
+        interface->dependencyHashes[index] = readInteger(&reader, 8);
+    }
+
+    int exportCount = (int) readInteger(&reader, 4);
+
+    for (int index = 0; index < exportCount && !reader.hasFailed; index++) {
+        IRExternal external = {0};
+        strcpy(external.module, interface->name);
+        external.isFunction = (int) readInteger(&reader, 1);
+        readString(&reader, external.identifier);
+        external.type = (IRType) readInteger(&reader, 1);
+
+        if (external.isFunction) {
+            external.parameterCount = (int) readInteger(&reader, 1);
+            if (external.parameterCount > IR_MAX_PARAMETERS) reader.hasFailed = 1;
+
+            for (int parameter = 0; parameter < external.parameterCount && !reader.hasFailed; parameter++) {
+                readString(&reader, external.parameterLabels[parameter]);
+                external.parameterTypes[parameter] = (IRType) readInteger(&reader, 1);
+            }
+        }
+
+        else if (external.type == IR_TYPE_STRING) readString(&reader, external.stringValue);
+        else external.value.integerValue = (int) (uint32_t) readInteger(&reader, 4);
+
+        if (addInterfaceExport(interface, &external) < 0) reader.hasFailed = 1;
+    }
+
+    free(bytes);
+
+    if (reader.hasFailed) {
+        freeModuleInterface(interface);
+        return NULL;
+    }
+
+    return interface;
+}
+
+void freeModuleInterface(ModuleInterface *interface) {
+    if (!interface) return;
+
+    free(interface->exports);
+    free(interface);
+}
@@ -0,0 +1,452 @@
+// loader.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include <linux/stat.h>
+#endif
+#include "loader.h"
+#include "metrics.h"
+
+/// A batch of files being loaded, shared by the threads loading it.
+typedef struct {
+    const char *const *paths;                 /// The path of each file.
+    SourceFile *files;                        /// The array receiving each file.
+    const int *indices;                       /// The files left to load, or NULL for every file.
+    int count;                                /// The number of files left to load.
+    SourceLoadedHandler handler;              /// The handler receiving each file, or NULL.
+    void *context;                            /// The context passed to the handler.
+    unsigned char *isHandedOver;              /// Whether each file has been handed over.
+    uint64_t start;                           /// When the batch has started, in nanoseconds.
+    atomic_int next;                          /// The next file to load by a thread of the pool.
+    atomic_uint_fast64_t firstNanoseconds;    /// The time until the first file has been handed over, or 0.
+    atomic_size_t byteCount;                  /// The bytes read so far.
+} SourceBatch;
+
+// Hands a file over to the handler, once it has been read (or has failed to)
+static void handOverSourceFile(SourceBatch *batch, int index) {
+    uint_fast64_t none = 0;
+    uint64_t elapsed = getMetricNanoseconds() - batch->start;
+    atomic_compare_exchange_strong(&batch->firstNanoseconds, &none, elapsed > 0 ? elapsed : 1);
+    atomic_fetch_add(&batch->byteCount, batch->files[index].length);
+
+    batch->isHandedOver[index] = 1;
+    if (batch->handler) batch->handler(batch->context, index, &batch->files[index]);
+}
+
+// Reads a whole file into memory, where the file is sized first so that it is read by as few calls as possible
+static void readSourceFile(const char *path, SourceFile *file) {
+    file->bytes = NULL;
+    file->length = 0;
+
+#ifndef _WIN32
+    int descriptor = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat status;
+    if (descriptor < 0) return;
+
+    char *bytes = fstat(descriptor, &status) == 0 ? (char*) malloc((size_t) status.st_size + 1) : NULL;
+    size_t offset = 0;
+    ssize_t length = 1;
+
+    while (bytes && offset < (size_t) status.st_size) {
+        length = pread(descriptor, bytes + offset, (size_t) status.st_size - offset, (off_t) offset);
+        if (length < 0 && errno == EINTR) continue;
+        if (length <= 0) break;
+        offset += (size_t) length;
+    }
+
+    close(descriptor);
+#else
+    FILE *stream = fopen(path, "rb");
+    if (!stream) return;
+
+    long size = fseek(stream, 0, SEEK_END) == 0 ? ftell(stream) : -1;
+    char *bytes = size >= 0 ? (char*) malloc((size_t) size + 1) : NULL;
+    rewind(stream);
+
+    size_t offset = bytes ? fread(bytes, 1, (size_t) size, stream) : 0;
+    int length = ferror(stream) ? -1 : 1;
+    fclose(stream);
+#endif
+
+    if (!bytes || length < 0) {
+        free(bytes);
+        return;
+    }
+
+    bytes[offset] = '\0';
+    file->bytes = bytes;
+    file->length = offset;
+}
+
+// Loads the files of a batch one after another, until no file is left, on each thread of the pool
+static void *loadPooledSourceFiles(void *argument) {
+    SourceBatch *batch = (SourceBatch*) argument;
+
+    for (int position; (position = atomic_fetch_add(&batch->next, 1)) < batch->count;) {
+        int index = batch->indices ? batch->indices[position] : position;
+        readSourceFile(batch->paths[index], &batch->files[index]);
+        handOverSourceFile(batch, index);
+    }
+
+    return NULL;
+}
+
+// Loads a batch with a pool of threads, where the calling thread loads files as well
+static void loadSourceFilesWithPool(SourceBatch *batch) {
+#ifndef _WIN32
+    pthread_t threads[LOADER_THREAD_COUNT];
+    int threadCount = 0;
+
+    while (threadCount < LOADER_THREAD_COUNT - 1 && threadCount < batch->count - 1 &&
+           pthread_create(&threads[threadCount], NULL, loadPooledSourceFiles, batch) == 0) threadCount++;
+
+    loadPooledSourceFiles(batch);
+    for (int thread = 0; thread < threadCount; thread++) pthread_join(threads[thread], NULL);
+#else
+    loadPooledSourceFiles(batch);
+#endif
+}
+
+#ifdef __linux__
+/// The operations submitted for a file, which are kept in the lowest bits of their user data.
+typedef enum {
+    SOURCE_OPERATION_OPEN,
+    SOURCE_OPERATION_STATUS,
+    SOURCE_OPERATION_READ,
+    SOURCE_OPERATION_CLOSE,
+} SourceOperation;
+
+/// An io_uring mapped into the process.
+typedef struct {
+    int descriptor;                       /// The file descriptor of the ring.
+    unsigned entryCount;                  /// The number of entries of the submission queue.
+    void *submissionRing;                 /// The mapping of the submission queue.
+    void *completionRing;                 /// The mapping of the completion queue, which might be the same.
+    size_t submissionSize;                /// The size of the submission queue mapping.
+    size_t completionSize;                /// The size of the completion queue mapping.
+    struct io_uring_sqe *entries;         /// The entries of the submission queue.
+    unsigned *submissionTail;             /// The tail of the submission queue, written by the process.
+    unsigned *submissionMask;             /// The mask of the submission queue.
+    unsigned *submissionArray;            /// The indices of the entries submitted.
+    unsigned *completionHead;             /// The head of the completion queue, written by the process.
+    unsigned *completionTail;             /// The tail of the completion queue, written by the kernel.
+    unsigned *completionMask;             /// The mask of the completion queue.
+    struct io_uring_cqe *completions;     /// The entries of the completion queue.
+    unsigned queuedCount;                 /// The entries queued since the last submission.
+    unsigned pendingCount;                /// The operations queued or submitted whose completion has not been reaped.
+} SourceRing;
+
+/// A file in flight through the ring.
+typedef struct {
+    int index;                /// The index of the file, or -1 if the slot is free.
+    int descriptor;           /// The file descriptor, or -1 until the file has been opened.
+    int waitingCount;         /// The number of operations of the open and the size still waited for.
+    int isFailed;             /// Whether the file could not be read.
+    size_t size;              /// The size of the file.
+    size_t offset;            /// The number of bytes read so far.
+    struct statx status;      /// The status receiving the size of the file.
+} SourceSlot;
+
+// Unmaps a ring and closes it
+static void closeSourceRing(SourceRing *ring) {
+    if (ring->entries && ring->entries != MAP_FAILED) munmap(ring->entries, ring->entryCount * sizeof(*ring->entries));
+    if (ring->completionRing && ring->completionRing != MAP_FAILED && ring->completionRing != ring->submissionRing) {
+        munmap(ring->completionRing, ring->completionSize);
+    }
+    if (ring->submissionRing && ring->submissionRing != MAP_FAILED) munmap(ring->submissionRing, ring->submissionSize);
+    close(ring->descriptor);
+}
+
+// Sets up a ring and maps its queues, unless the kernel lacks io_uring or the operations loading a file
+static int openSourceRing(SourceRing *ring) {
+    struct io_uring_params parameters;
+    memset(&parameters, 0, sizeof(parameters));
+    memset(ring, 0, sizeof(SourceRing));
+
+    ring->descriptor = (int) syscall(__NR_io_uring_setup, LOADER_RING_ENTRIES, &parameters);
+    if (ring->descriptor < 0) return 0;
+
+    // The operations opening, sizing and reading a file only exist since Linux 5.6, as does the probe for them
+    size_t probeSize = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = (struct io_uring_probe*) calloc(1, probeSize);
+    int isSupported = probe &&
+                      syscall(__NR_io_uring_register, ring->descriptor, IORING_REGISTER_PROBE, probe, 256) == 0;
+    const int opcodes[] = {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE};
+
+    for (size_t opcode = 0; opcode < sizeof(opcodes) / sizeof(opcodes[0]) && isSupported; opcode++) {
+        isSupported = opcodes[opcode] < probe->ops_len && (probe->ops[opcodes[opcode]].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    free(probe);
+
+    if (!isSupported) {
+        close(ring->descriptor);
+        return 0;
+    }
+
+    ring->entryCount = parameters.sq_entries;
+    ring->submissionSize = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+    ring->completionSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(struct io_uring_cqe);
+
+    // Both queues might share a single mapping, as large as the larger of them
+    int isSingleMapping = (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (isSingleMapping && ring->completionSize > ring->submissionSize) ring->submissionSize = ring->completionSize;
+
+    ring->submissionRing = mmap(NULL, ring->submissionSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                ring->descriptor, IORING_OFF_SQ_RING);
+    ring->completionRing = isSingleMapping ? ring->submissionRing
+                                           : mmap(NULL, ring->completionSize, PROT_READ | PROT_WRITE,
+                                                  MAP_SHARED | MAP_POPULATE, ring->descriptor, IORING_OFF_CQ_RING);
+    ring->entries = (struct io_uring_sqe*) mmap(NULL, ring->entryCount * sizeof(struct io_uring_sqe),
+                                                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->descriptor,
+                                                IORING_OFF_SQES);
+
+    if (ring->submissionRing == MAP_FAILED || ring->completionRing == MAP_FAILED || ring->entries == MAP_FAILED) {
+        closeSourceRing(ring);
+        return 0;
+    }
+
+    char *submission = (char*) ring->submissionRing;
+    char *completion = (char*) ring->completionRing;
+    ring->submissionTail = (unsigned*) (submission + parameters.sq_off.tail);
+    ring->submissionMask = (unsigned*) (submission + parameters.sq_off.ring_mask);
+    ring->submissionArray = (unsigned*) (submission + parameters.sq_off.array);
+    ring->completionHead = (unsigned*) (completion + parameters.cq_off.head);
+    ring->completionTail = (unsigned*) (completion + parameters.cq_off.tail);
+    ring->completionMask = (unsigned*) (completion + parameters.cq_off.ring_mask);
+    ring->completions = (struct io_uring_cqe*) (completion + parameters.cq_off.cqes);
+    return 1;
+}
+
+// Queues an operation of a file, which is submitted by the next wait, where the flags are those of the operation
+// (i.e. the flags of an open or of a status, which share their field)
+static void queueSourceOperation(SourceRing *ring, int opcode, int descriptor, const void *address, unsigned length,
+                                 uint64_t offset, uint32_t flags, int slot, SourceOperation operation) {
+    unsigned tail = *ring->submissionTail;
+    unsigned position = tail & *ring->submissionMask;
+    struct io_uring_sqe *entry = &ring->entries[position];
+
+    memset(entry, 0, sizeof(struct io_uring_sqe));
+    entry->opcode = (uint8_t) opcode;
+    entry->fd = descriptor;
+    entry->addr = (uint64_t) (uintptr_t) address;
+    entry->len = length;
+    entry->off = offset;
+    entry->rw_flags = (__kernel_rwf_t) flags;
+    entry->user_data = (uint64_t) slot << 2 | operation;
+    ring->submissionArray[position] = position;
+
+    // The entry is only published to the kernel once it has been written
+    __atomic_store_n(ring->submissionTail, tail + 1, __ATOMIC_RELEASE);
+    ring->queuedCount++;
+    ring->pendingCount++;
+}
+
+// Submits the queued operations and waits for at least one completion
+static int waitSourceRing(SourceRing *ring) {
+    for (;;) {
+        long submitted = syscall(__NR_io_uring_enter, ring->descriptor, ring->queuedCount, 1, IORING_ENTER_GETEVENTS,
+                                 NULL, 0);
+
+        if (submitted >= 0) {
+            ring->queuedCount -= (unsigned) submitted;
+            return 1;
+        }
+
+        // A busy ring only takes more operations once its completions have been reaped
+        int isReapable = *ring->completionHead != __atomic_load_n(ring->completionTail, __ATOMIC_ACQUIRE);
+        if ((errno == EBUSY || errno == EAGAIN) && isReapable) return 1;
+        if (errno != EINTR && errno != EBUSY && errno != EAGAIN) return 0;
+    }
+}
+
+// Reads the rest of a file in flight, or hands it over once it has been read (or has failed) and closes it
+static void advanceSourceSlot(SourceBatch *batch, SourceRing *ring, SourceSlot *slots, int slot) {
+    SourceSlot *source = &slots[slot];
+    SourceFile *file = &batch->files[source->index];
+
+    if (!source->isFailed && !file->bytes) {
+        file->bytes = (char*) malloc(source->size + 1);
+        source->isFailed = file->bytes == NULL;
+    }
+
+    if (!source->isFailed && source->offset < source->size) {
+        size_t length = source->size - source->offset < 1u << 30 ? source->size - source->offset : 1u << 30;
+        queueSourceOperation(ring, IORING_OP_READ, source->descriptor, file->bytes + source->offset,
+                             (unsigned) length, source->offset, 0, slot, SOURCE_OPERATION_READ);
+        return;
+    }
+
+    if (source->descriptor >= 0) {
+        queueSourceOperation(ring, IORING_OP_CLOSE, source->descriptor, NULL, 0, 0, 0, slot, SOURCE_OPERATION_CLOSE);
+    }
+
+    if (source->isFailed) {
+        free(file->bytes);
+        file->bytes = NULL;
+        file->length = 0;
+    } else {
+        file->bytes[source->offset] = '\0';
+        file->length = source->offset;
+    }
+
+    handOverSourceFile(batch, source->index);
+    source->index = -1;
+}
+
+// Reaps every completion of the ring, where a file is read once both its open and its size have completed
+static void reapSourceRing(SourceBatch *batch, SourceRing *ring, SourceSlot *slots, int *activeCount) {
+    unsigned head = *ring->completionHead;
+    unsigned tail = __atomic_load_n(ring->completionTail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; head++) {
+        struct io_uring_cqe *completion = &ring->completions[head & *ring->completionMask];
+        int slot = (int) (completion->user_data >> 2);
+        SourceOperation operation = (SourceOperation) (completion->user_data & 3);
+        SourceSlot *source = &slots[slot];
+        int result = completion->res;
+        ring->pendingCount--;
+
+        if (operation == SOURCE_OPERATION_CLOSE) continue;
+
+        if (operation == SOURCE_OPERATION_OPEN) source->descriptor = result >= 0 ? result : -1;
+        if (operation == SOURCE_OPERATION_STATUS && result == 0) source->size = (size_t) source->status.stx_size;
+        if (operation != SOURCE_OPERATION_READ) {
+            source->isFailed |= result < 0;
+            if (--source->waitingCount > 0) continue;
+        }
+
+        // An interrupted read is submitted again, and a file shrinking while it is read ends where it has been read
+        if (operation == SOURCE_OPERATION_READ && result > 0) source->offset += (size_t) result;
+        if (operation == SOURCE_OPERATION_READ && result == 0) source->size = source->offset;
+        if (operation == SOURCE_OPERATION_READ && result < 0) source->isFailed = result != -EINTR && result != -EAGAIN;
+
+        advanceSourceSlot(batch, ring, slots, slot);
+        if (source->index < 0) (*activeCount)--;
+    }
+
+    __atomic_store_n(ring->completionHead, head, __ATOMIC_RELEASE);
+}
+
+// Loads a batch through a ring, and returns 0 if the ring has failed before every file has been handed over
+static int loadSourceFilesWithRing(SourceBatch *batch, SourceRing *ring) {
+    SourceSlot *slots = (SourceSlot*) calloc(LOADER_OPEN_LIMIT, sizeof(SourceSlot));
+    if (!slots) return 0;
+
+    for (int slot = 0; slot < LOADER_OPEN_LIMIT; slot++) slots[slot].index = -1;
+
+    int next = 0, activeCount = 0, result = 1;
+
+    while (next < batch->count || activeCount > 0) {
+        // A file is started with its open and its size together, as long as both fit into the ring
+        for (int slot = 0; slot < LOADER_OPEN_LIMIT && next < batch->count; slot++) {
+            if (slots[slot].index >= 0 || ring->pendingCount + 2 > ring->entryCount) continue;
+
+            SourceSlot *source = &slots[slot];
+            const char *path = batch->paths[next];
+            memset(source, 0, sizeof(SourceSlot));
+            source->index = next++;
+            source->descriptor = -1;
+            source->waitingCount = 2;
+            activeCount++;
+
+            queueSourceOperation(ring, IORING_OP_OPENAT, AT_FDCWD, path, 0, 0, O_RDONLY | O_CLOEXEC, slot,
+                                 SOURCE_OPERATION_OPEN);
+            queueSourceOperation(ring, IORING_OP_STATX, AT_FDCWD, path, STATX_SIZE,
+                                 (uint64_t) (uintptr_t) &source->status, 0, slot, SOURCE_OPERATION_STATUS);
+        }
+
+        if (!waitSourceRing(ring)) {
+            result = 0;
+            break;
+        }
+
+        reapSourceRing(batch, ring, slots, &activeCount);
+    }
+
+    // The closes are waited for as well, so that no file is left open once the batch has been loaded
+    while (result && ring->pendingCount > 0 && waitSourceRing(ring)) reapSourceRing(batch, ring, slots, &activeCount);
+
+    // The buffers of the files still in flight could be written by the kernel at any time, so they are abandoned
+    if (result) free(slots);
+    return result;
+}
+#endif
+
+void loadSourceFiles(const char *const *paths, int count, SourceFile *files, SourceLoadedHandler handler,
+                     void *context, SourceLoadStatistics *statistics) {
+    SourceBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.paths = paths;
+    batch.files = files;
+    batch.count = count;
+    batch.handler = handler;
+    batch.context = context;
+    batch.start = getMetricNanoseconds();
+    batch.isHandedOver = (unsigned char*) calloc(count > 0 ? count : 1, 1);
+    memset(files, 0, count * sizeof(SourceFile));
+
+    SourceLoaderKind kind = SOURCE_LOADER_PREAD;
+    int isLoaded = 0;
+
+#ifdef __linux__
+    // A single file is read right away, since setting up a ring would take longer than reading it
+    const char *loader = getenv("OPUS_LOADER");
+    SourceRing ring;
+
+    if (batch.isHandedOver && count > 1 && (!loader || strcmp(loader, "pread") != 0) && openSourceRing(&ring)) {
+        kind = SOURCE_LOADER_IO_URING;
+        isLoaded = loadSourceFilesWithRing(&batch, &ring);
+        closeSourceRing(&ring);
+    }
+#endif
+
+    // The files that the ring has not handed over (if any) are loaded by the pool
+    int *indices = !isLoaded && kind == SOURCE_LOADER_IO_URING ? (int*) malloc(count * sizeof(int)) : NULL;
+    int remainingCount = 0;
+
+    for (int index = 0; indices && index < count; index++) {
+        if (!batch.isHandedOver[index]) indices[remainingCount++] = index;
+    }
+
+    if (!isLoaded && batch.isHandedOver) {
+        batch.indices = indices;
+        batch.count = indices ? remainingCount : count;
+        loadSourceFilesWithPool(&batch);
+    }
+
+    free(indices);
+    free(batch.isHandedOver);
+
+    if (!statistics) return;
+
+    if (statistics->fileCount == 0) statistics->firstSeconds = atomic_load(&batch.firstNanoseconds) / 1e9;
+    statistics->kind = kind;
+    statistics->fileCount += count;
+    statistics->byteCount += atomic_load(&batch.byteCount);
+    statistics->totalSeconds += (getMetricNanoseconds() - batch.start) / 1e9;
+}
+
+void displaySourceLoadStatistics(const SourceLoadStatistics *statistics) {
+    printf("[Loader] Loaded %d file%s (%zu bytes) with %s in %.2f ms, where the first file was ready after %.2f ms.\n",
+           statistics->fileCount, statistics->fileCount == 1 ? "" : "s", statistics->byteCount,
+           statistics->kind == SOURCE_LOADER_IO_URING ? "io_uring" : "pread", 1000.0 * statistics->totalSeconds,
+           1000.0 * statistics->firstSeconds);
+}
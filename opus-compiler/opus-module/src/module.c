@@ -0,0 +1,727 @@
+// module.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#else
+#include <windows.h>
+#endif
+#include "module.h"
+#include "parser.h"
+#include "utf8.h"
+#include "analyzer.h"
+#include "dataflow.h"
+#include "peephole.h"
+#include "pass.h"
+#include "toolchain.h"
+#include "metrics.h"
+
+/// A module being compiled by a child process, whose output is kept aside until it has finished.
+typedef struct {
+    int module;    /// The index of the module.
+    long pid;      /// The process compiling the module.
+    FILE *log;     /// The output of the process.
+} ModuleJob;
+
+/// The imports of a module, scanned as soon as its source code has been loaded.
+typedef struct {
+    int importCount;                  /// The number of imports, or -1 if the source code could not be read.
+    char (*imports)[LEXEME_LENGTH];   /// The names of the imports, up to MODULE_MAX_IMPORTS of them.
+} ModuleScan;
+
+/// A level of the graph whose source code is being loaded.
+typedef struct {
+    ModuleGraph *graph;     /// The dependency graph.
+    int firstModule;        /// The index of the first module of the level.
+    ModuleScan *scans;      /// The imports of each module of the level.
+} ModuleLevel;
+
+// Hashes the whole source code of a module, where a missing file hashes as nothing
+static uint64_t hashSourceFile(const char *path) {
+    FILE *file = fopen(path, "rb");
+    uint64_t hash = INTERFACE_HASH_SEED;
+    if (!file) return hash;
+
+    unsigned char bytes[4096];
+    size_t length;
+
+    while ((length = fread(bytes, 1, sizeof(bytes), file)) > 0) hash = hashBytes(bytes, length, hash);
+    fclose(file);
+    return hash;
+}
+
+// Finds the slot of a source path in the table of the graph, which is either the slot of its module or a free one
+static int findModuleSlot(ModuleGraph *graph, const char *sourcePath) {
+    int mask = graph->pathCapacity - 1;
+    int slot = (int) (hashBytes(sourcePath, strlen(sourcePath), INTERFACE_HASH_SEED) & (uint64_t) mask);
+
+    while (graph->pathTable[slot] >= 0 && strcmp(graph->modules[graph->pathTable[slot]].sourcePath, sourcePath) != 0) {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+// Adds a module to the graph unless a module with the same source code is already there, where the modules are
+// looked up by their path, since a build might import thousands of them
+static int addModule(ModuleGraph *graph, const char *name, const char *sourcePath) {
+    if (graph->moduleCount * 2 >= graph->pathCapacity) {
+        int capacity = graph->pathCapacity ? graph->pathCapacity * 2 : 16;
+        int *table = (int*) malloc(capacity * sizeof(int));
+        if (!table) return -1;
+
+        free(graph->pathTable);
+        graph->pathTable = table;
+        graph->pathCapacity = capacity;
+        for (int slot = 0; slot < capacity; slot++) table[slot] = -1;
+
+        for (int index = 0; index < graph->moduleCount; index++) {
+            table[findModuleSlot(graph, graph->modules[index].sourcePath)] = index;
+        }
+    }
+
+    int slot = findModuleSlot(graph, sourcePath);
+    if (graph->pathTable[slot] >= 0) return graph->pathTable[slot];
+
+    if (graph->moduleCount == graph->moduleCapacity) {
+        int capacity = graph->moduleCapacity ? graph->moduleCapacity * 2 : 8;
+        Module *modules = (Module*) realloc(graph->modules, capacity * sizeof(Module));
+        if (!modules) return -1;
+
+        graph->modules = modules;
+        graph->moduleCapacity = capacity;
+    }
+
+    Module *module = &graph->modules[graph->moduleCount];
+    memset(module, 0, sizeof(Module));
+    strncpy(module->name, name, LEXEME_LENGTH - 1);
+    strncpy(module->sourcePath, sourcePath, MODULE_PATH_LENGTH - 1);
+
+    // The interface lives next to the source code, with the extension replaced
+    size_t stemLength = strlen(module->sourcePath) - strlen(MODULE_SOURCE_EXTENSION);
+    snprintf(module->interfacePath, MODULE_PATH_LENGTH, "%.*s%s", (int) stemLength, module->sourcePath,
+             MODULE_INTERFACE_EXTENSION);
+
+    module->state = MODULE_PENDING;
+    graph->pathTable[findModuleSlot(graph, module->sourcePath)] = graph->moduleCount;
+    return graph->moduleCount++;
+}
+
+// Visits the imported modules before the module itself, where reaching a module being visited closes a cycle
+static int orderModule(ModuleGraph *graph, int index, int *marks, int *orderCount) {
+    if (marks[index] == 2) return 1;
+
+    if (marks[index] == 1) {
+        fprintf(stderr, "[ModuleError]: Module '%s' imports itself through the modules it imports.\n",
+                graph->modules[index].name);
+        return 0;
+    }
+
+    marks[index] = 1;
+
+    for (int import = 0; import < graph->modules[index].importCount; import++) {
+        if (!orderModule(graph, graph->modules[index].imports[import], marks, orderCount)) return 0;
+    }
+
+    marks[index] = 2;
+    graph->order[(*orderCount)++] = index;
+    return 1;
+}
+
+// Hashes a module and scans its imports once its source code has been loaded, which might happen on any thread
+static void scanLoadedModule(void *context, int index, SourceFile *file) {
+    ModuleLevel *level = (ModuleLevel*) context;
+    Module *module = &level->graph->modules[level->firstModule + index];
+    ModuleScan *scan = &level->scans[index];
+    char imports[MODULE_MAX_IMPORTS][LEXEME_LENGTH];
+
+    module->source = file->bytes;
+    module->sourceLength = file->length;
+    module->sourceHash = INTERFACE_HASH_SEED;
+    scan->importCount = -1;
+    if (!file->bytes) return;
+
+    module->sourceHash = hashBytes(file->bytes, file->length, INTERFACE_HASH_SEED);
+    scan->importCount = scanModuleImports(file->bytes, imports, MODULE_MAX_IMPORTS);
+
+    // Only the names that fit are kept, since a module importing too many modules is reported anyway
+    int keptCount = scan->importCount < MODULE_MAX_IMPORTS ? scan->importCount : MODULE_MAX_IMPORTS;
+    scan->imports = keptCount > 0 ? (char (*)[LEXEME_LENGTH]) malloc(keptCount * LEXEME_LENGTH) : NULL;
+
+    if (scan->imports) memcpy(scan->imports, imports, keptCount * LEXEME_LENGTH);
+    else if (keptCount > 0) scan->importCount = -1;
+}
+
+// Loads the source code of a level of the graph in one batch, and returns the imports of each of its modules
+static ModuleScan *loadModuleLevel(ModuleGraph *graph, int firstModule, int lastModule) {
+    int count = lastModule - firstModule;
+    const char **paths = (const char**) malloc(count * sizeof(const char*));
+    SourceFile *files = (SourceFile*) malloc(count * sizeof(SourceFile));
+    ModuleScan *scans = (ModuleScan*) calloc(count, sizeof(ModuleScan));
+
+    if (paths && files && scans) {
+        ModuleLevel level = {graph, firstModule, scans};
+        for (int index = 0; index < count; index++) paths[index] = graph->modules[firstModule + index].sourcePath;
+        loadSourceFiles(paths, count, files, scanLoadedModule, &level, &graph->loadStatistics);
+    } else {
+        free(scans);
+        scans = NULL;
+    }
+
+    free(paths);
+    free(files);
+    return scans;
+}
+
+// Frees the imports scanned from a level of the graph
+static void freeModuleLevel(ModuleScan *scans, int count) {
+    if (!scans) return;
+    for (int index = 0; index < count; index++) free(scans[index].imports);
+    free(scans);
+}
+
+// Adds the modules imported by a module to the graph, unless they are already there
+static void addModuleImports(ModuleGraph *graph, int index, char (*imports)[LEXEME_LENGTH], int importCount) {
+    // Imported modules are looked up next to the importing module
+    const char *sourcePath = graph->modules[index].sourcePath;
+    const char *separator = strrchr(sourcePath, '/');
+    int directoryLength = separator ? (int) (separator - sourcePath + 1) : 0;
+
+    for (int import = 0; import < importCount; import++) {
+        char path[MODULE_PATH_LENGTH];
+        snprintf(path, sizeof(path), "%.*s%s%s", directoryLength, graph->modules[index].sourcePath,
+                 imports[import], MODULE_SOURCE_EXTENSION);
+
+        int imported = addModule(graph, imports[import], path);
+        if (imported < 0) continue;
+
+        Module *module = &graph->modules[index];
+        int isDuplicated = 0;
+        for (int other = 0; other < module->importCount; other++) isDuplicated |= (module->imports[other] == imported);
+        if (!isDuplicated) module->imports[module->importCount++] = imported;
+    }
+}
+
+ModuleGraph *discoverModules(const char *rootPath) {
+    ModuleGraph *graph = (ModuleGraph*) calloc(1, sizeof(ModuleGraph));
+    if (!graph) return NULL;
+
+    // The compiled file is named after its file name as well
+    const char *fileName = strrchr(rootPath, '/') ? strrchr(rootPath, '/') + 1 : rootPath;
+    char name[LEXEME_LENGTH];
+    snprintf(name, sizeof(name), "%.*s", (int) strcspn(fileName, "."), fileName);
+
+    if (addModule(graph, name, rootPath) < 0) {
+        freeModuleGraph(graph);
+        return NULL;
+    }
+
+    // Modules are appended while scanning, a level of imports at a time, so every module is scanned exactly once
+    for (int firstModule = 0, lastModule = 1; firstModule < graph->moduleCount; firstModule = lastModule) {
+        lastModule = graph->moduleCount;
+        ModuleScan *scans = loadModuleLevel(graph, firstModule, lastModule);
+
+        for (int index = firstModule; index < lastModule; index++) {
+            int importCount = scans ? scans[index - firstModule].importCount : -1;
+            char (*imports)[LEXEME_LENGTH] = scans ? scans[index - firstModule].imports : NULL;
+
+            // The compiled file reports its own access errors once it is compiled
+            if (importCount < 0 && index > 0) {
+                fprintf(stderr, "[ModuleError]: Module '%s' could not be found at '%s'.\n",
+                        graph->modules[index].name, graph->modules[index].sourcePath);
+                freeModuleLevel(scans, lastModule - firstModule);
+                freeModuleGraph(graph);
+                return NULL;
+            }
+
+            if (importCount > MODULE_MAX_IMPORTS) {
+                fprintf(stderr, "[ModuleError]: Module '%s' imports more than %d modules.\n",
+                        graph->modules[index].name, MODULE_MAX_IMPORTS);
+                freeModuleLevel(scans, lastModule - firstModule);
+                freeModuleGraph(graph);
+                return NULL;
+            }
+
+            addModuleImports(graph, index, imports, importCount);
+        }
+
+        freeModuleLevel(scans, lastModule - firstModule);
+    }
+
+    // Order the modules so that each one is compiled after the modules it imports
+    int *marks = (int*) calloc(graph->moduleCount, sizeof(int));
+    graph->order = (int*) malloc(graph->moduleCount * sizeof(int));
+    int orderCount = 0;
+
+    if (!marks || !graph->order || !orderModule(graph, 0, marks, &orderCount)) {
+        free(marks);
+        freeModuleGraph(graph);
+        return NULL;
+    }
+
+    free(marks);
+    return graph;
+}
+
+int scanModuleImports(const char *source, char names[][LEXEME_LENGTH], int capacity) {
+    int importCount = 0;
+
+    // Only the beginning of a line could start an import declaration
+    for (const char *line = source; line;) {
+        const char *cursor = line;
+        const char *end = strchr(line, '\n');
+        line = end ? end + 1 : NULL;
+
+        if (strncmp(cursor, UTF8_BYTE_ORDER_MARK, strlen(UTF8_BYTE_ORDER_MARK)) == 0) cursor += strlen(UTF8_BYTE_ORDER_MARK);
+        cursor += strspn(cursor, " \t");
+
+        if (strncmp(cursor, "import", 6) != 0 || !strchr(" \t", cursor[6]) || cursor[6] == '\0') continue;
+        cursor += 6 + strspn(cursor + 6, " \t");
+
+        // The module name runs until a blank, a comment or the end of the line
+        size_t length = strcspn(cursor, " \t\r\n/");
+        if (length == 0 || length >= LEXEME_LENGTH) continue;
+
+        if (importCount < capacity) snprintf(names[importCount], LEXEME_LENGTH, "%.*s", (int) length, cursor);
+        importCount++;
+    }
+
+    return importCount;
+}
+
+int isModuleUpToDate(ModuleGraph *graph, int index) {
+    Module *module = &graph->modules[index];
+    ModuleInterface *interface = readModuleInterface(module->interfacePath);
+    if (!interface) return 0;
+
+    int isUpToDate = interface->sourceHash == module->sourceHash && interface->dependencyCount == module->importCount;
+
+    for (int import = 0; import < module->importCount && isUpToDate; import++) {
+        Module *imported = &graph->modules[module->imports[import]];
+        isUpToDate = strcmp(interface->dependencyNames[import], imported->name) == 0 &&
+                     interface->dependencyHashes[import] == imported->interface->interfaceHash;
+    }
+
+    if (!isUpToDate) {
+        freeModuleInterface(interface);
+        return 0;
+    }
+
+    module->interface = interface;
+    return 1;
+}
+
+// Records the end of compiling a module, where the output of a failed module is displayed
+static void finishModule(ModuleGraph *graph, int index, int isCompiled, FILE *log) {
+    Module *module = &graph->modules[index];
+    if (isCompiled) module->interface = readModuleInterface(module->interfacePath);
+
+    if (module->interface) {
+        module->state = MODULE_COMPILED;
+        printf("[Module] Compiled module '%s' (%d export%s).\n", module->name, module->interface->exportCount,
+               module->interface->exportCount == 1 ? "" : "s");
+    } else {
+        char buffer[4096];
+        size_t length;
+
+        if (log) {
+            rewind(log);
+            while ((length = fread(buffer, 1, sizeof(buffer), log)) > 0) fwrite(buffer, 1, length, stdout);
+            fflush(stdout);
+        }
+
+        module->state = MODULE_FAILED;
+        fprintf(stderr, "[ModuleError]: Module '%s' could not be compiled.\n", module->name);
+    }
+
+    if (log) fclose(log);
+}
+
+// Starts compiling a module in a child process, or compiles it right away if processes could not be created
+static int startModuleJob(ModuleGraph *graph, int index, CompileOptions *options, ModuleJob *job) {
+    graph->modules[index].state = MODULE_COMPILING;
+
+#ifndef _WIN32
+    fflush(stdout);
+    fflush(stderr);
+
+    FILE *log = tmpfile();
+    pid_t pid = log ? fork() : -1;
+
+    if (pid == 0) {
+        dup2(fileno(log), STDOUT_FILENO);
+        dup2(fileno(log), STDERR_FILENO);
+
+        int result = compileModule(graph, index, options);
+        fflush(stdout);
+        fflush(stderr);
+        _exit(result == 1 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    if (pid > 0) {
+        job->module = index;
+        job->pid = (long) pid;
+        job->log = log;
+        return 1;
+    }
+
+    if (log) fclose(log);
+#endif
+
+    finishModule(graph, index, compileModule(graph, index, options) == 1, NULL);
+    return 0;
+}
+
+// Waits for any child process to finish, then removes its job
+static void waitModuleJob(ModuleGraph *graph, ModuleJob *jobs, int *jobCount) {
+#ifndef _WIN32
+    int status = 0;
+    pid_t pid = wait(&status);
+
+    for (int job = 0; job < *jobCount; job++) {
+        if (jobs[job].pid != (long) pid) continue;
+
+        int isCompiled = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+        finishModule(graph, jobs[job].module, isCompiled, jobs[job].log);
+        jobs[job] = jobs[--(*jobCount)];
+        return;
+    }
+
+    // No child is left, which only happens if the children have been reaped elsewhere
+    if (pid < 0) {
+        for (int job = 0; job < *jobCount; job++) finishModule(graph, jobs[job].module, 0, jobs[job].log);
+        *jobCount = 0;
+    }
+#else
+    (void) graph; (void) jobs;
+    *jobCount = 0;
+#endif
+}
+
+int buildModules(ModuleGraph *graph, CompileOptions *options) {
+    int jobLimit = options->jobCount > 0 ? options->jobCount : 1;
+    ModuleJob *jobs = (ModuleJob*) malloc(jobLimit * sizeof(ModuleJob));
+    if (!jobs) return 0;
+
+    int runningCount = 0;
+
+    while (1) {
+        // Start every module whose imported modules are ready, in topological order, as long as a job is free
+        for (int position = 0; position < graph->moduleCount; position++) {
+            int index = graph->order[position];
+            Module *module = &graph->modules[index];
+            if (index == 0 || module->state != MODULE_PENDING) continue;
+
+            int isReady = 1;
+            int failedImport = -1;
+
+            for (int import = 0; import < module->importCount; import++) {
+                ModuleState state = graph->modules[module->imports[import]].state;
+                if (state == MODULE_FAILED) failedImport = module->imports[import];
+                isReady = isReady && (state == MODULE_UP_TO_DATE || state == MODULE_COMPILED);
+            }
+
+            if (failedImport >= 0) {
+                module->state = MODULE_FAILED;
+                fprintf(stderr, "[ModuleError]: Module '%s' is not compiled since module '%s' has failed.\n",
+                        module->name, graph->modules[failedImport].name);
+                continue;
+            }
+
+            if (!isReady) continue;
+
+            // The C code of a module is emitted by compiling it, so it is compiled again once its C code is stale
+            int isCodeUpToDate = !options->cDirectory || isModuleCodeUpToDate(graph, index, options);
+
+            if (isCodeUpToDate && isModuleUpToDate(graph, index)) {
+                module->state = MODULE_UP_TO_DATE;
+                addMetricCounter(METRIC_INTERFACE_CACHE_HITS, 1);
+                printf("[Module] Module '%s' is up to date.\n", module->name);
+                continue;
+            }
+
+            // The metrics of a module compiled by a child process are lost with it, but its miss is still counted
+            if (runningCount < jobLimit && startModuleJob(graph, index, options, &jobs[runningCount])) {
+                addMetricCounter(METRIC_INTERFACE_CACHE_MISSES, 1);
+                runningCount++;
+            }
+        }
+
+        // Modules are started in topological order, so nothing is left to start once no job is running
+        if (runningCount == 0) break;
+        waitModuleJob(graph, jobs, &runningCount);
+    }
+
+    free(jobs);
+
+    int result = 1;
+    for (int index = 1; index < graph->moduleCount; index++) result = result && graph->modules[index].state != MODULE_FAILED;
+    return result;
+}
+
+// Hashes what the C code of a module is emitted from, that is its source code, the passes optimizing it and whether
+// its overflows are checked
+static uint64_t stampModuleCode(Module *module, CompileOptions *options) {
+    uint64_t stamp = hashBytes(&module->sourceHash, sizeof(module->sourceHash), INTERFACE_HASH_SEED);
+    stamp = hashBytes(&options->level, sizeof(options->level), stamp);
+    stamp = hashBytes(&options->isOverflowChecked, sizeof(options->isOverflowChecked), stamp);
+    if (options->passList) stamp = hashBytes(options->passList, strlen(options->passList), stamp);
+    return stamp;
+}
+
+// Emits a module as C, where the compiled file initializes every imported module (in topological order) first
+static int emitModuleCode(ModuleGraph *graph, int index, CompileOptions *options, IRProgram *program) {
+    char (*initializers)[LEXEME_LENGTH] = (char (*)[LEXEME_LENGTH]) malloc(graph->moduleCount * LEXEME_LENGTH);
+    if (!initializers) return 0;
+
+    int initializerCount = 0;
+
+    for (int position = 0; position < graph->moduleCount && index == 0; position++) {
+        int imported = graph->order[position];
+        if (imported != 0) strcpy(initializers[initializerCount++], graph->modules[imported].name);
+    }
+
+    Module *module = &graph->modules[index];
+    int result = emitCModule(program, module->name, initializers, initializerCount, index == 0, options->cDirectory,
+                             stampModuleCode(module, options));
+
+    free(initializers);
+    return result;
+}
+
+int isModuleCodeUpToDate(ModuleGraph *graph, int index, CompileOptions *options) {
+    CManifest *manifest = (CManifest*) malloc(sizeof(CManifest));
+    Module *module = &graph->modules[index];
+
+    int isUpToDate = manifest && readCManifest(options->cDirectory, module->name, manifest) &&
+                     manifest->stamp == stampModuleCode(module, options);
+
+    free(manifest);
+    return isUpToDate;
+}
+
+int linkModules(ModuleGraph *graph, CompileOptions *options) {
+    char (*names)[LEXEME_LENGTH] = (char (*)[LEXEME_LENGTH]) malloc(graph->moduleCount * LEXEME_LENGTH);
+    if (!names) return 0;
+
+    for (int position = 0; position < graph->moduleCount; position++) {
+        strcpy(names[position], graph->modules[graph->order[position]].name);
+    }
+
+    // The executable is named after the compiled file
+    char outputPath[MODULE_PATH_LENGTH];
+#ifndef _WIN32
+    snprintf(outputPath, sizeof(outputPath), "%s/%s", options->cDirectory, graph->modules[0].name);
+#else
+    snprintf(outputPath, sizeof(outputPath), "%s/%s.exe", options->cDirectory, graph->modules[0].name);
+#endif
+
+    int result = buildCExecutable(options->cDirectory, names, graph->moduleCount, outputPath, options->jobCount);
+    free(names);
+    return result;
+}
+
+int compileModule(ModuleGraph *graph, int index, CompileOptions *options) {
+    Module *module = &graph->modules[index];
+
+    PassManager *passManager = initPassManager(options->level);
+    if (!passManager) return -1;
+    if (options->passList) parsePassPipeline(passManager, options->passList);
+
+    // The source code loaded while discovering the modules is compiled, so that each file is read once by a build
+    FILE *sourceCode = module->source ? openOpusSourceBytes(module->sourcePath, module->source, module->sourceLength)
+                                      : openOpusSourceCode(module->sourcePath);
+
+    if (!sourceCode) {
+        freePassManager(passManager);
+        return -1;
+    }
+
+    printf("Compiling...\n");
+    uint64_t start = getMetricNanoseconds();
+
+    // Every phase reports its errors into the same list, so that all of them are displayed in order at the end
+    DiagnosticList *diagnostics = initDiagnosticList();
+
+    // Initialize the Parser and try to generate the AST for the provided sourceCode, where a statement failing to
+    // parse is left as an AST_ERROR node and the parser goes on with the next statement
+    Parser *parser = initParser();
+    parser->diagnostics = parser->lexer->diagnostics = diagnostics;
+    parser->currentToken = advanceParser(parser, sourceCode);
+    ASTNode *root = parseProgram(parser, sourceCode);
+    int isParsed = parser->parseError == PARSE_ERROR_NONE;
+    observeMetricSince(METRIC_PARSE_SECONDS, &start);
+
+    // The exports of the imported modules are declared before analyzing, since only their interfaces are known
+    SymbolTable *symbolTable = initSymbolTable();
+    Analyzer *analyzer = initAnalyzer(root, symbolTable);
+    IRProgram *program = initIRProgram();
+    analyzer->diagnostics = diagnostics;
+    if (program) program->diagnostics = diagnostics;
+    if (program) program->isOverflowChecked = options->isOverflowChecked;
+
+    for (int import = 0; import < module->importCount; import++) {
+        declareModuleInterface(graph->modules[module->imports[import]].interface, symbolTable, program);
+    }
+
+    printf("Analyzing...\n");
+
+    // The partial AST of a program failing to parse is still analyzed (skipping the AST_ERROR nodes), so that its
+    // semantic errors are reported together with its syntax errors, but it is not lowered.
+    // Lower the analyzed AST into the IR, where the initialization of each local is checked along every path.
+    // Expressions folded by the analyzer are only lowered into constants if the pipeline folds constants.
+    // While watching, the compiled file reuses the analysis of the statements unaffected by the last edit.
+    QueryDatabase *database = index == 0 ? options->queryDatabase : NULL;
+    int result = (database ? analyzeProgramIncrementally(database, analyzer, root) : analyzeProgram(analyzer, root)) &&
+                 program && isParsed;
+    observeMetricSince(METRIC_ANALYZE_SECONDS, &start);
+    if (database) displayQueryStatistics(database);
+    if (result) lowerIntoIRProgram(program, root, isPassScheduled(passManager, "fold"));
+    if (result) result = analyzeDefiniteAssignment(program) && program->errorCount == 0;
+    if (result) observeMetricSince(METRIC_LOWER_SECONDS, &start);
+
+    locateDiagnostics(diagnostics, sourceCode);
+    displayDiagnostics(diagnostics);
+
+    // Optimize the IR and allocate the frames, then report how many times each peephole rule has fired
+    if (result) {
+        start = getMetricNanoseconds();
+        runPassManager(passManager, program);
+        observeMetricSince(METRIC_OPTIMIZE_SECONDS, &start);
+        if (isPassScheduled(passManager, "peephole")) displayPeepholeReport(passManager->firedCounts);
+        if (options->isStatisticsDisplayed) displayPassStatistics(passManager);
+    }
+
+    // The optimized IR is emitted as C, whose units are only compiled once every module has been emitted
+    if (result && options->cDirectory) {
+        result = emitModuleCode(graph, index, options, program);
+        observeMetricSince(METRIC_EMIT_SECONDS, &start);
+    }
+
+    // An imported module summarizes its exports, together with what they have been compiled against
+    if (result && index > 0) {
+        ModuleInterface *interface = extractModuleInterface(module->name, root, symbolTable, program);
+        result = interface != NULL;
+
+        if (interface) {
+            interface->sourceHash = module->sourceHash;
+            interface->dependencyCount = module->importCount;
+
+            for (int import = 0; import < module->importCount; import++) {
+                Module *imported = &graph->modules[module->imports[import]];
+                strcpy(interface->dependencyNames[import], imported->name);
+                interface->dependencyHashes[import] = imported->interface->interfaceHash;
+            }
+
+            result = writeModuleInterface(interface, module->interfacePath);
+            if (!result) fprintf(stderr, "[AccessError]: File '%s' could not be written.\n", module->interfacePath);
+            freeModuleInterface(interface);
+        }
+    }
+
+    // Display the symbol table if semantic analysis was successful
+    if (result) displaySymbolTable(symbolTable);
+    else if (isParsed) printf("Semantic analysis failed. Errors detected.\n");
+    else printf("Parsing failed. Errors detected.\n");
+
+    // Close the provided sourceCode after parsing and free resources
+    fclose(sourceCode);
+    freePassManager(passManager);
+    freeIRProgram(program);
+    freeSymbolTable(symbolTable);
+    freeDiagnosticList(diagnostics);
+    free(analyzer);
+    freeAST(root);
+
+    addMetricCounter(METRIC_COMPILES, 1);
+    if (!isParsed || !result) addMetricCounter(METRIC_COMPILE_FAILURES, 1);
+    return isParsed ? result : -1;
+}
+
+// Hashes a source file as soon as it has been loaded, which is only kept until then
+static void hashLoadedSource(void *context, int index, SourceFile *file) {
+    uint64_t *hashes = (uint64_t*) context;
+    hashes[index] = file->bytes ? hashBytes(file->bytes, file->length, INTERFACE_HASH_SEED) : INTERFACE_HASH_SEED;
+    free(file->bytes);
+    file->bytes = NULL;
+}
+
+// Hashes the source code of every module of the graph, which changes whenever any of them is edited, where the
+// files are loaded in one batch
+static uint64_t stampModuleGraph(ModuleGraph *graph, const char *rootPath) {
+    if (!graph) return hashSourceFile(rootPath);
+
+    const char **paths = (const char**) malloc(graph->moduleCount * sizeof(const char*));
+    SourceFile *files = (SourceFile*) malloc(graph->moduleCount * sizeof(SourceFile));
+    uint64_t *hashes = (uint64_t*) malloc(graph->moduleCount * sizeof(uint64_t));
+    uint64_t stamp = INTERFACE_HASH_SEED;
+
+    if (paths && files && hashes) {
+        for (int index = 0; index < graph->moduleCount; index++) paths[index] = graph->modules[index].sourcePath;
+        loadSourceFiles(paths, graph->moduleCount, files, hashLoadedSource, hashes, NULL);
+    }
+
+    for (int index = 0; index < graph->moduleCount; index++) {
+        uint64_t hash = paths && files && hashes ? hashes[index] : hashSourceFile(graph->modules[index].sourcePath);
+        stamp = hashBytes(&hash, sizeof(hash), stamp);
+    }
+
+    free(paths);
+    free(files);
+    free(hashes);
+    return stamp;
+}
+
+int watchModules(const char *rootPath, CompileOptions *options) {
+    QueryDatabase *database = initQueryDatabase();
+    if (!database) return 0;
+
+    options->queryDatabase = database;
+    ModuleGraph *graph = NULL;
+    uint64_t stamp = 0;
+    int isCompiled = 0;
+
+    // The graph is only discovered again once a file has changed, so that a missing module is reported once
+    for (;;) {
+        if (!isCompiled || stampModuleGraph(graph, rootPath) != stamp) {
+            freeModuleGraph(graph);
+            graph = discoverModules(rootPath);
+            stamp = stampModuleGraph(graph, rootPath);
+            isCompiled = 1;
+            if (graph && options->isStatisticsDisplayed) displaySourceLoadStatistics(&graph->loadStatistics);
+
+            // The executable is linked again as well, where only the units whose C code has changed are compiled
+            if (graph && buildModules(graph, options) && compileModule(graph, 0, options) == 1 && options->cDirectory) {
+                linkModules(graph, options);
+            }
+            printf("[Module] Watching '%s' for changes...\n", rootPath);
+            fflush(stdout);
+        }
+
+#ifndef _WIN32
+        usleep(MODULE_WATCH_INTERVAL * 1000);
+#else
+        Sleep(MODULE_WATCH_INTERVAL);
+#endif
+    }
+}
+
+void freeModuleGraph(ModuleGraph *graph) {
+    if (!graph) return;
+
+    for (int index = 0; index < graph->moduleCount; index++) {
+        freeModuleInterface(graph->modules[index].interface);
+        free(graph->modules[index].source);
+    }
+
+    free(graph->modules);
+    free(graph->pathTable);
+    free(graph->order);
+    free(graph);
+}
@@ -0,0 +1,115 @@
+// cfg.h
+//
+// Simplification of the control flow graph. Folding a branch into a jump leaves the blocks of the untaken side
+// unreachable, and lowering leaves behind the blocks following a 'return'. They are never executed, but every later
+// pass still visits them and the frame allocation still numbers them, so they are removed from the function.
+//
+// Lowering a chain of 'if ... else if ...' or a nested conditional also leaves jumps to blocks that only jump
+// further (the end of an inner conditional jumping to the end of the outer one), and branches to blocks that only
+// branch again on a condition already known on the way there. Jump threading forwards such a jump or branch straight
+// to its final target, then merges a block into the block jumping to it if it has no other predecessor, so the
+// blocks left empty disappear. The entries of the jump table of a switch are threaded the same way, and a switch
+// whose entries all go to the same block becomes a jump.
+//
+// Finally, the blocks are laid out so that the likely successor of each block is placed right after it, where it is
+// reached by falling through rather than by a taken jump. The likely side of a branch is the one taken most often by
+// a branch profile of a previous run, if there is one, otherwise it is guessed: going back to the header of a loop
+// or staying in a loop is likely, and leaving a loop or going to a 'return' is not. The layout is kept by the
+// function, and followed by the bytecode assembler and the C emitter (see computeLayoutOrder() in dataflow.h).
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef CFG_H
+#define CFG_H
+
+#include "ir.h"
+
+/// The number of times a branch has gone to each of its targets in the runs of a program.
+typedef struct {
+    char function[LEXEME_LENGTH];   /// The name of the function holding the branch.
+    Location location;              /// The location of the branch in the source code, which identifies it.
+    long counts[2];                 /// The number of times the branch has gone to its true and its false targets.
+} BranchCount;
+
+/// The branch counts of a program, as written by 'opus-run --branch-profile=<path>'.
+typedef struct {
+    BranchCount *branches;          /// The counts of each branch.
+    int branchCount;                /// The number of branches.
+    int branchCapacity;             /// The allocated capacity of the branches.
+} BranchProfile;
+
+/// Removes the blocks that are not reachable from the entry block, keeping the remaining blocks in their order,
+/// then renumbers the targets of the terminators and recomputes the predecessors of the blocks.
+///
+/// @param function The function to simplify.
+/// @return The number of removed blocks.
+///
+int removeUnreachableBlocks(IRFunction *function);
+
+/// Forwards each jump and branch whose target only jumps further, or only branches on a condition already known, to
+/// the final target, turns a branch whose targets are the same block into a jump, merges each block into the block
+/// jumping to it if it has no other predecessor, and removes the blocks left unreachable.
+///
+/// @param program The program holding the function, whose globals might be changed by a call.
+/// @param function The function to simplify.
+/// @return The number of forwarded targets, merged blocks and removed blocks.
+///
+int threadJumps(IRProgram *program, IRFunction *function);
+
+/// Lays out the reachable blocks of a function so that the likely successor of each block follows it, and keeps
+/// the layout in the function. The entry block stays the block 0.
+///
+/// @param function The function to lay out.
+/// @param profile The branch counts of a previous run, or NULL to guess the likely side of each branch.
+/// @return The number of blocks that have been moved.
+///
+int layoutBlocks(IRFunction *function, const BranchProfile *profile);
+
+/// Initializes an empty branch profile.
+/// @return A pointer to the newly allocated BranchProfile, or NULL if memory allocation fails.
+///
+BranchProfile *initBranchProfile(void);
+
+/// Adds the counts of a branch to a profile, where the counts of a branch already in the profile are added together.
+///
+/// @param profile The profile.
+/// @param function The name of the function holding the branch.
+/// @param location The location of the branch.
+/// @param trueCount The number of times the branch has gone to its true target.
+/// @param falseCount The number of times the branch has gone to its false target.
+/// @return 1 (True) on success, 0 (False) if memory allocation fails.
+///
+int addBranchCount(BranchProfile *profile, const char *function, Location location, long trueCount, long falseCount);
+
+/// Finds the counts of a branch in a profile.
+///
+/// @param profile The profile.
+/// @param function The name of the function holding the branch.
+/// @param location The location of the branch.
+/// @return The counts of the branch, or NULL if the branch has not been profiled.
+///
+const BranchCount *findBranchCount(const BranchProfile *profile, const char *function, Location location);
+
+/// Reads a branch profile, written as a line '<function> <line>:<column> <true count> <false count>' per branch.
+///
+/// @param path The path of the profile.
+/// @return A pointer to the profile, or NULL if the file could not be opened, or is not a branch profile (which is
+///         reported).
+///
+BranchProfile *readBranchProfile(const char *path);
+
+/// Writes a branch profile (see readBranchProfile()).
+///
+/// @param profile The profile to write.
+/// @param path The path of the profile.
+/// @return 1 (True) if the profile has been written, 0 (False) otherwise (which is reported).
+///
+int writeBranchProfile(const BranchProfile *profile, const char *path);
+
+/// Frees a branch profile.
+/// @param profile The profile to free.
+///
+void freeBranchProfile(BranchProfile *profile);
+
+#endif
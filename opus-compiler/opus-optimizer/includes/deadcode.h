@@ -0,0 +1,28 @@
+// deadcode.h
+//
+// Dead store elimination over the IR. The peephole optimizer only removes a temporary that is never read, while an
+// assignment to a local is often overwritten before it is read again, or never read on any path after it (such as
+// the last increment of a loop counter). Liveness tells which registers might still be read after each instruction,
+// so any pure instruction assigning a register that is dead right after it is removed.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef DEADCODE_H
+#define DEADCODE_H
+
+#include "ir.h"
+#include "dataflow.h"
+
+/// Walks each block backward from the registers live at its exit, removing the pure instructions whose destination
+/// is dead, and dropping the destination of the calls whose value is dead (the call itself is kept). Globals are never
+/// dead, since any call might read them.
+///
+/// @param program The program owning the function.
+/// @param function The function to simplify.
+/// @param liveness The liveness of the registers of the function, which is no longer valid once anything is removed.
+/// @return The number of removed instructions and dropped destinations.
+///
+int eliminateDeadStores(IRProgram *program, IRFunction *function, DataflowProblem *liveness);
+
+#endif
@@ -0,0 +1,41 @@
+// fold.h
+//
+// Constant folding over the IR. The analyzer only folds the expressions whose operands are known while analyzing,
+// while lowering, the peephole optimizer and the other passes keep exposing new constants. A register assigned once
+// by a constant always holds that constant, so any pure instruction reading only such registers is evaluated at
+// compile time, and a branch or a switch on a constant becomes a jump.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef FOLD_H
+#define FOLD_H
+
+#include "ir.h"
+
+/// Evaluates an instruction whose operands are constants, following the runtime semantics of Opus: Int arithmetic
+/// wraps around (unless overflows are checked), and a division by zero (or of the smallest Int by -1) is never folded
+/// so that it still fails at runtime, as does an overflow that is checked.
+///
+/// @param instruction The instruction to evaluate.
+/// @param operandType The type of the operands, which are of the same type (except for a conversion), or
+///                    IR_TYPE_UINT32 if either operand is a UInt32, which is divided and compared as unsigned.
+/// @param lhs The value of the first operand (if any).
+/// @param rhs The value of the second operand (if any).
+/// @param isOverflowChecked Whether an Int overflow fails at runtime, in which case it is not folded.
+/// @param result The value computed by the instruction.
+/// @return 1 (True) if the instruction has been evaluated, 0 (False) if it could not be folded.
+///
+int evaluateIRInstruction(IRInstruction *instruction, IRType operandType, IRConstant lhs, IRConstant rhs,
+                          int isOverflowChecked, IRConstant *result);
+
+/// Folds the instructions of a function in reverse post-order, so that a folded value is known before it is read,
+/// and turns the branches and the switches on a constant into jumps (the predecessors are then recomputed).
+///
+/// @param program The program owning the function.
+/// @param function The function to fold.
+/// @return The number of folded instructions.
+///
+int foldConstants(IRProgram *program, IRFunction *function);
+
+#endif
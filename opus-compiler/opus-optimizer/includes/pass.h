@@ -0,0 +1,135 @@
+// pass.h
+//
+// Pass manager of the optimizer. Each transformation of the IR is a pass declared in a table together with the
+// analyses it keeps valid, and an optimization level is a preset pipeline of passes, which could be overridden by
+// naming the passes to run. The manager runs each pass of the pipeline over every function, caches the analyses
+// (such as liveness) between the passes that do not change the IR they depend on, and records the time and the
+// change of the size of the IR of every pass, so that the cost of each pass could be weighed against its effect.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef PASS_H
+#define PASS_H
+
+#include "ir.h"
+#include "dataflow.h"
+#include "cfg.h"
+
+#define PASS_MAX_PIPELINE       32
+#define PASS_DEFAULT_LEVEL      1
+#define PASS_MAX_LEVEL          3
+
+/// The analyses cached by the pass manager, where each one is a bit of an analysis mask.
+#define ANALYSIS_LIVENESS       1
+#define ANALYSIS_NONE           0
+#define ANALYSIS_ALL            ANALYSIS_LIVENESS
+
+typedef struct PassManager PassManager;
+
+/// A pass is given the index of the function to transform, and returns 1 (True) if it has changed the function, in
+/// which case the analyses it does not preserve are invalidated.
+typedef int (*PassAction)(PassManager *manager, int functionIndex);
+
+/// A transformation of the IR.
+typedef struct {
+    const char *name;          /// The name of the pass, as given to '--passes='.
+    PassAction run;            /// The transformation of the pass.
+    int preservedAnalyses;     /// The analyses still valid after the pass has changed a function.
+} Pass;
+
+/// The effect of running one entry of the pipeline over the whole program.
+typedef struct {
+    double milliseconds;       /// The processor time taken by the pass.
+    int instructionsBefore;    /// The number of instructions before the pass.
+    int instructionsAfter;     /// The number of instructions after the pass.
+    int blocksBefore;          /// The number of blocks before the pass.
+    int blocksAfter;           /// The number of blocks after the pass.
+    int changedCount;          /// The number of functions changed by the pass.
+} PassRecord;
+
+/// The state of running a pipeline over a program.
+struct PassManager {
+    IRProgram *program;                       /// The program being optimized, or NULL until it is run.
+    int pipeline[PASS_MAX_PIPELINE];          /// The index of each pass of the pipeline in the pass table.
+    int pipelineCount;                        /// The number of passes in the pipeline.
+    PassRecord records[PASS_MAX_PIPELINE];    /// The effect of each entry of the pipeline.
+    DataflowProblem **liveness;               /// The cached liveness of each function, or NULL if not computed.
+    int *validAnalyses;                       /// The mask of the cached analyses still valid for each function.
+    int computedCount;                        /// The number of analyses computed.
+    int reusedCount;                          /// The number of analyses served from the cache.
+    int *firedCounts;                         /// The number of times each peephole rule has fired.
+    const BranchProfile *branchProfile;       /// The branch counts guiding the layout of the blocks, or NULL.
+};
+
+/// The passes that could be named in a pipeline, where 'frame' allocates the frames and always runs last.
+extern const Pass passes[];
+extern const int passCount;
+
+/// Initializes a pass manager with the pipeline of an optimization level.
+///
+/// @param level The optimization level, from 0 to PASS_MAX_LEVEL.
+/// @return A pointer to the newly allocated PassManager, or NULL if memory allocation fails.
+///
+PassManager *initPassManager(int level);
+
+/// Replaces the pipeline of a pass manager by a comma-separated list of passes, where the frame allocation is
+/// appended if the list does not end with it.
+///
+/// @param manager The pass manager to configure.
+/// @param list The names of the passes, such as "fold,peephole".
+/// @return 1 (True) if every pass is known, 0 (False) otherwise.
+///
+int parsePassPipeline(PassManager *manager, const char *list);
+
+/// Finds a pass of the pass table by its name.
+///
+/// @param name The name of the pass.
+/// @return The index of the pass, or -1 if not found.
+///
+int findPass(const char *name);
+
+/// Checks if a pass is part of the pipeline of a pass manager.
+///
+/// @param manager The pass manager to inspect.
+/// @param name The name of the pass.
+/// @return 1 (True) if the pass is scheduled, 0 (False) otherwise.
+///
+int isPassScheduled(PassManager *manager, const char *name);
+
+/// Runs each pass of the pipeline over every function of the program, whose definite assignment has been checked.
+///
+/// @param manager The pass manager to run.
+/// @param program The program to optimize.
+/// @return 1 (True) on success, 0 (False) if memory allocation fails.
+///
+int runPassManager(PassManager *manager, IRProgram *program);
+
+/// Gets the liveness of a function, computing it only if the cached one has been invalidated.
+///
+/// @param manager The running pass manager.
+/// @param functionIndex The index of the function.
+/// @return The solved liveness, owned by the manager, or NULL if memory allocation fails.
+///
+DataflowProblem *getPassLiveness(PassManager *manager, int functionIndex);
+
+/// Invalidates the cached analyses of a function that a pass has not preserved.
+///
+/// @param manager The running pass manager.
+/// @param functionIndex The index of the function.
+/// @param preservedAnalyses The mask of the analyses still valid.
+///
+void invalidateAnalyses(PassManager *manager, int functionIndex, int preservedAnalyses);
+
+/// Reports the time and the change of the size of the IR of each entry of the pipeline, and how often the cached
+/// analyses have been reused.
+/// @param manager The pass manager that has been run.
+///
+void displayPassStatistics(PassManager *manager);
+
+/// Frees a pass manager and its cached analyses.
+/// @param manager The pass manager to free.
+///
+void freePassManager(PassManager *manager);
+
+#endif
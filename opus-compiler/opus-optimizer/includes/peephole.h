@@ -0,0 +1,107 @@
+// peephole.h
+//
+// Peephole optimizer over the IR. Lowering emits the same local patterns over and over, such as copying a local into
+// a temporary only to read it once, storing a global and loading it right back, testing the negation of a boolean,
+// or multiplying by a power of two. Each pattern is a rule declared in a table together with the opcode it matches,
+// and the optimizer rewrites every block as a stream: each instruction is offered to the rules, which look at the
+// instructions emitted just before it and emit its replacement (or nothing). The blocks are rewritten again until no
+// rule fires, and the number of times each rule has fired is reported.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "ir.h"
+
+#define PEEPHOLE_ANY_OPCODE   -1
+#define PEEPHOLE_MAX_ROUNDS   8
+#define PEEPHOLE_WINDOW       4
+
+/// The state of rewriting the blocks of a function.
+typedef struct {
+    IRProgram *program;            /// The program owning the function.
+    IRFunction *function;          /// The function being rewritten.
+    IRInstruction *output;         /// The instructions emitted so far for the current block.
+    int outputCount;               /// The number of emitted instructions.
+    int outputCapacity;            /// The allocated capacity of the output array.
+    int *useCounts;                /// The number of instructions reading each register.
+    int *definitionCounts;         /// The number of instructions assigning each register (declarations excluded).
+    int *isConstant;               /// Whether a register always holds the same constant.
+    IRConstant *constants;         /// The constant held by each register whose isConstant is set.
+    int registerCapacity;          /// The allocated capacity of the per-register arrays.
+    int isCFGChanged;              /// Whether a rule has changed the successors of a block.
+} PeepholeContext;
+
+/// A rule is given the instruction to rewrite, and returns 1 (True) if it has fired, in which case it has emitted
+/// the replacement of the instruction (possibly nothing), or 0 (False) otherwise, leaving everything untouched.
+typedef int (*PeepholeAction)(PeepholeContext *context, IRInstruction *instruction);
+
+/// A pattern of the peephole optimizer.
+typedef struct {
+    const char *name;          /// The name of the rule in the report.
+    int opcode;                /// The opcode of the instructions the rule is offered, or PEEPHOLE_ANY_OPCODE.
+    PeepholeAction apply;      /// The rewriting of the rule.
+} PeepholeRule;
+
+/// The rules in the order they are tried, where only the first rule that fires rewrites an instruction.
+extern const PeepholeRule peepholeRules[];
+extern const int peepholeRuleCount;
+
+/// Rewrites every function of the program with the peephole rules.
+///
+/// @param program The program to optimize, whose definite assignment has been checked.
+/// @param firedCounts An array of `peepholeRuleCount` counters, where each firing of a rule is counted.
+/// @return The number of times any rule has fired.
+///
+int optimizePeephole(IRProgram *program, int *firedCounts);
+
+/// Rewrites the blocks of a function until no rule fires (or PEEPHOLE_MAX_ROUNDS is reached), then recomputes the
+/// predecessors of the blocks if a branch has been turned into a jump.
+///
+/// @param program The program owning the function.
+/// @param function The function to optimize.
+/// @param firedCounts An array of `peepholeRuleCount` counters, where each firing of a rule is counted.
+/// @return The number of times any rule has fired.
+///
+int optimizeFunctionPeephole(IRProgram *program, IRFunction *function, int *firedCounts);
+
+/// Appends an instruction to the output of the current block, counting the registers it reads and assigns.
+///
+/// @param context The state of the rewriting.
+/// @param instruction The instruction to emit.
+///
+void emitPeepholeInstruction(PeepholeContext *context, IRInstruction instruction);
+
+/// Removes an emitted instruction from the output of the current block, so that a rule could fuse it into the
+/// instruction being rewritten.
+///
+/// @param context The state of the rewriting.
+/// @param index The index of the emitted instruction.
+/// @return The removed instruction.
+///
+IRInstruction removePeepholeInstruction(PeepholeContext *context, int index);
+
+/// Finds the instruction assigning a register among the last PEEPHOLE_WINDOW emitted instructions.
+///
+/// @param context The state of the rewriting.
+/// @param reg The register to look for.
+/// @return The index of the emitted instruction, or -1 if it is not in the window.
+///
+int findPeepholeDefinition(PeepholeContext *context, int reg);
+
+/// Adds a temporary register to the function, growing the per-register arrays of the context.
+///
+/// @param context The state of the rewriting.
+/// @param type The type of the register.
+/// @return The new register.
+///
+int addPeepholeRegister(PeepholeContext *context, IRType type);
+
+/// Reports how many times each rule has fired.
+/// @param firedCounts The counters filled by optimizePeephole().
+///
+void displayPeepholeReport(int *firedCounts);
+
+#endif
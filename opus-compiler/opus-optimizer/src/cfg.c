@@ -0,0 +1,430 @@
+// cfg.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cfg.h"
+#include "dataflow.h"
+
+int removeUnreachableBlocks(IRFunction *function) {
+    int blockCount = function->blockCount;
+    int *order = (int*) malloc((blockCount + 1) * sizeof(int));
+    int *renumbered = (int*) malloc((blockCount + 1) * sizeof(int));
+
+    if (!order || !renumbered) {
+        free(order); free(renumbered);
+        return 0;
+    }
+
+    // The blocks missing from the reverse post-order are unreachable
+    int orderCount = computeReversePostOrder(function, order);
+    for (int index = 0; index < blockCount; index++) renumbered[index] = IR_NO_BLOCK;
+    for (int position = 0; position < orderCount; position++) renumbered[order[position]] = 0;
+
+    if (orderCount == blockCount) {
+        free(order); free(renumbered);
+        return 0;
+    }
+
+    // Compact the reachable blocks in their original order, so that the entry block stays the block 0
+    int keptCount = 0;
+
+    for (int index = 0; index < blockCount; index++) {
+        BasicBlock *block = function->blocks[index];
+
+        if (renumbered[index] == IR_NO_BLOCK) {
+            free(block->instructions);
+            free(block->predecessors);
+            free(block);
+            continue;
+        }
+
+        renumbered[index] = keptCount;
+        block->index = keptCount;
+        function->blocks[keptCount++] = block;
+    }
+
+    function->blockCount = keptCount;
+
+    // A reachable block only jumps to reachable blocks
+    renumberIRTargets(function, renumbered);
+    computeIRPredecessors(function);
+
+    free(order);
+    free(renumbered);
+    return blockCount - keptCount;
+}
+
+// Checks if the condition of a branch is known on the way from a block through one of its targets, either because
+// the block branches on the same register, or because it last assigns a constant to the register
+static int isBranchConditionKnown(IRProgram *program, IRFunction *function, BasicBlock *block, int target,
+                                  int condition, int *value) {
+    IRInstruction *terminator = &block->instructions[block->instructionCount - 1];
+
+    if (terminator->opcode == IR_BRANCH) {
+        *value = target == 0;
+        return terminator->operands[0] == condition;
+    }
+
+    // A global of the entry function might be assigned by the function being called
+    for (int index = block->instructionCount - 2; index >= 0; index--) {
+        IRInstruction *instruction = &block->instructions[index];
+
+        if (instruction->opcode == IR_CALL && isIRGlobal(program, function, condition)) return 0;
+        if (instruction->destination != condition) continue;
+
+        *value = instruction->constant.booleanValue != 0;
+        return instruction->opcode == IR_CONSTANT;
+    }
+
+    return 0;
+}
+
+// Follows a target of a block through the blocks that only jump, or only branch on a condition known on the way there,
+// where the target is the side of a branch (or any target of a jump or a switch)
+static int findThreadedTarget(IRProgram *program, IRFunction *function, BasicBlock *block, int target, int current) {
+    // A cycle of such blocks (an empty infinite loop) is followed at most once around
+    for (int hop = 0; hop < function->blockCount; hop++) {
+        BasicBlock *next = function->blocks[current];
+        if (next->instructionCount != 1) break;
+
+        IRInstruction *only = &next->instructions[0];
+        int value = 0, forwarded = IR_NO_BLOCK;
+
+        if (only->opcode == IR_JUMP) forwarded = only->targets[0];
+        else if (only->opcode == IR_BRANCH &&
+                 isBranchConditionKnown(program, function, block, target, only->operands[0], &value)) {
+            forwarded = only->targets[value ? 0 : 1];
+        }
+
+        if (forwarded == IR_NO_BLOCK || forwarded == current) break;
+        current = forwarded;
+    }
+
+    return current;
+}
+
+// Appends the instructions of a block to the block jumping to it, which is left empty and unreachable
+static void mergeBlock(IRFunction *function, BasicBlock *block, BasicBlock *successor) {
+    block->instructionCount--;
+
+    for (int index = 0; index < successor->instructionCount; index++) {
+        IRInstruction *instruction = &successor->instructions[index];
+        *emitIRInstruction(function, block->index, instruction->opcode, instruction->type, instruction->location) =
+            *instruction;
+    }
+
+    successor->instructionCount = 0;
+}
+
+int threadJumps(IRProgram *program, IRFunction *function) {
+    int changedCount = 0;
+
+    for (int index = 0; index < function->blockCount; index++) {
+        BasicBlock *block = function->blocks[index];
+        if (!isIRBlockTerminated(block)) continue;
+
+        IRInstruction *terminator = &block->instructions[block->instructionCount - 1];
+        if (terminator->opcode == IR_RETURN) continue;
+
+        // Both targets are followed from the original terminator, whose condition is still the one branched on
+        int targets[2] = {terminator->targets[0], terminator->targets[1]};
+        for (int target = 0; target < 2; target++) {
+            if (targets[target] != IR_NO_BLOCK) {
+                targets[target] = findThreadedTarget(program, function, block, target, targets[target]);
+            }
+        }
+
+        for (int target = 0; target < 2; target++) {
+            if (targets[target] == terminator->targets[target]) continue;
+
+            terminator->targets[target] = targets[target];
+            changedCount++;
+        }
+
+        if (terminator->opcode == IR_BRANCH && terminator->targets[0] == terminator->targets[1]) {
+            terminator->opcode = IR_JUMP;
+            terminator->operands[0] = IR_NO_REGISTER;
+            terminator->targets[1] = IR_NO_BLOCK;
+            changedCount++;
+        }
+
+        // A switch whose values all go where its other values go is a jump
+        if (terminator->opcode == IR_SWITCH) {
+            IRSwitchTable *table = &function->switchTables[terminator->constant.integerValue];
+            int isJump = 1;
+
+            for (int value = 0; value < table->count; value++) {
+                int target = findThreadedTarget(program, function, block, 0, table->targets[value]);
+                if (target != table->targets[value]) changedCount++;
+
+                table->targets[value] = target;
+                isJump = isJump && target == terminator->targets[0];
+            }
+
+            if (isJump) {
+                terminator->opcode = IR_JUMP;
+                terminator->operands[0] = IR_NO_REGISTER;
+                changedCount++;
+            }
+        }
+    }
+
+    // A block reached only by a jump is merged into the block jumping to it, which then ends as the merged block did,
+    // so a chain of such blocks is merged at once
+    computeIRPredecessors(function);
+
+    for (int index = 0; index < function->blockCount; index++) {
+        BasicBlock *block = function->blocks[index];
+
+        while (block->instructionCount > 0 && block->instructions[block->instructionCount - 1].opcode == IR_JUMP) {
+            int target = block->instructions[block->instructionCount - 1].targets[0];
+            BasicBlock *successor = function->blocks[target];
+            if (target == 0 || target == index || successor->predecessorCount != 1) break;
+
+            mergeBlock(function, block, successor);
+            changedCount++;
+        }
+    }
+
+    return changedCount + removeUnreachableBlocks(function);
+}
+
+// Counts the loops holding each block, where the loop of a header holds the blocks reaching an edge going back to it
+// (from a block placed no earlier in the reverse post-order) without passing through the header
+static void computeLoopDepths(IRFunction *function, const int *positions, int *depths, int *marks, int *stack) {
+    for (int header = 0; header < function->blockCount; header++) {
+        BasicBlock *block = function->blocks[header];
+        int top = 0, isHeader = 0;
+        if (positions[header] < 0) continue;
+
+        // The walk stops at the header, which is marked before any block of its loop
+        marks[header] = header + 1;
+
+        for (int index = 0; index < block->predecessorCount; index++) {
+            int latch = block->predecessors[index];
+            if (positions[latch] < positions[header]) continue;
+
+            isHeader = 1;
+            if (marks[latch] == header + 1) continue;
+
+            marks[latch] = header + 1;
+            stack[top++] = latch;
+        }
+
+        if (isHeader) depths[header]++;
+
+        while (top > 0) {
+            BasicBlock *member = function->blocks[stack[--top]];
+            depths[member->index]++;
+
+            for (int index = 0; index < member->predecessorCount; index++) {
+                int predecessor = member->predecessors[index];
+                if (positions[predecessor] < 0 || marks[predecessor] == header + 1) continue;
+
+                marks[predecessor] = header + 1;
+                stack[top++] = predecessor;
+            }
+        }
+    }
+}
+
+// Scores how likely a branch goes to a target when it has not been profiled, where going back to the header of a loop
+// is the most likely, and leaving a loop is less likely than going to a 'return'
+static int scoreBranchTarget(IRFunction *function, int block, int target, const int *positions, const int *depths) {
+    BasicBlock *successor = function->blocks[target];
+    int score = 0;
+
+    if (positions[target] <= positions[block]) score += 4;
+    if (depths[target] < depths[block]) score -= 2;
+    int isReturning = !isIRBlockTerminated(successor) ||
+                      successor->instructions[successor->instructionCount - 1].opcode == IR_RETURN;
+
+    if (isReturning) score -= 1;
+
+    return score;
+}
+
+// Chooses the successor to place right after a block, which is its likely successor unless it has been placed
+static int chooseFallThrough(IRFunction *function, const BranchProfile *profile, int block, const int *positions,
+                             const int *depths, const unsigned char *isPlaced) {
+    BasicBlock *current = function->blocks[block];
+    if (!isIRBlockTerminated(current)) return IR_NO_BLOCK;
+
+    IRInstruction *terminator = &current->instructions[current->instructionCount - 1];
+    if (terminator->opcode == IR_JUMP) return isPlaced[terminator->targets[0]] ? IR_NO_BLOCK : terminator->targets[0];
+    if (terminator->opcode != IR_BRANCH) return IR_NO_BLOCK;
+
+    // The true side is kept first if both sides are as likely, which is the order of the source code
+    const BranchCount *counts = profile ? findBranchCount(profile, function->name, terminator->location) : NULL;
+    int likely = 0;
+
+    if (counts && counts->counts[0] + counts->counts[1] > 0) likely = counts->counts[1] > counts->counts[0];
+    else likely = scoreBranchTarget(function, block, terminator->targets[1], positions, depths) >
+                  scoreBranchTarget(function, block, terminator->targets[0], positions, depths);
+
+    if (!isPlaced[terminator->targets[likely]]) return terminator->targets[likely];
+    return isPlaced[terminator->targets[!likely]] ? IR_NO_BLOCK : terminator->targets[!likely];
+}
+
+int layoutBlocks(IRFunction *function, const BranchProfile *profile) {
+    int blockCount = function->blockCount;
+    int *order = (int*) malloc((blockCount + 1) * sizeof(int));
+    int *positions = (int*) malloc((blockCount + 1) * sizeof(int));
+    int *depths = (int*) calloc(blockCount + 1, sizeof(int));
+    int *marks = (int*) calloc(blockCount + 1, sizeof(int));
+    int *stack = (int*) malloc((blockCount + 1) * sizeof(int));
+    int *layout = (int*) malloc((blockCount + 1) * sizeof(int));
+    unsigned char *isPlaced = (unsigned char*) calloc(blockCount + 1, 1);
+    BasicBlock **blocks = (BasicBlock**) malloc((blockCount + 1) * sizeof(BasicBlock*));
+    int movedCount = 0;
+
+    if (!order || !positions || !depths || !marks || !stack || !layout || !isPlaced || !blocks) {
+        free(order); free(positions); free(depths); free(marks);
+        free(stack); free(layout); free(isPlaced); free(blocks);
+        return 0;
+    }
+
+    computeIRPredecessors(function);
+    int orderCount = computeReversePostOrder(function, order);
+
+    for (int block = 0; block < blockCount; block++) positions[block] = -1;
+    for (int position = 0; position < orderCount; position++) positions[order[position]] = position;
+    computeLoopDepths(function, positions, depths, marks, stack);
+
+    // Each chain starts from the first block not yet placed in the reverse post-order, and goes on through the likely
+    // successor of its last block, so the entry block starts the first chain
+    int layoutCount = 0;
+
+    for (int position = 0; position < orderCount; position++) {
+        int block = order[position];
+
+        while (block != IR_NO_BLOCK && !isPlaced[block]) {
+            isPlaced[block] = 1;
+            layout[layoutCount++] = block;
+            block = chooseFallThrough(function, profile, block, positions, depths, isPlaced);
+        }
+    }
+
+    // The unreachable blocks follow the layout, and are never emitted
+    for (int block = 0; block < blockCount; block++) if (!isPlaced[block]) layout[layoutCount++] = block;
+
+    for (int index = 0; index < blockCount; index++) {
+        blocks[index] = function->blocks[layout[index]];
+        positions[layout[index]] = index;
+        if (layout[index] != index) movedCount++;
+    }
+
+    for (int index = 0; index < blockCount; index++) {
+        blocks[index]->index = index;
+        function->blocks[index] = blocks[index];
+    }
+
+    renumberIRTargets(function, positions);
+    function->isLaidOut = 1;
+    if (movedCount > 0) computeIRPredecessors(function);
+
+    free(order); free(positions); free(depths); free(marks); free(stack); free(layout); free(isPlaced); free(blocks);
+    return movedCount;
+}
+
+BranchProfile *initBranchProfile(void) {
+    return (BranchProfile*) calloc(1, sizeof(BranchProfile));
+}
+
+int addBranchCount(BranchProfile *profile, const char *function, Location location, long trueCount, long falseCount) {
+    BranchCount *existing = (BranchCount*) findBranchCount(profile, function, location);
+
+    if (existing) {
+        existing->counts[0] += trueCount;
+        existing->counts[1] += falseCount;
+        return 1;
+    }
+
+    if (profile->branchCount == profile->branchCapacity) {
+        int capacity = profile->branchCapacity ? profile->branchCapacity * 2 : 16;
+        BranchCount *branches = (BranchCount*) realloc(profile->branches, capacity * sizeof(BranchCount));
+        if (!branches) return 0;
+
+        profile->branches = branches;
+        profile->branchCapacity = capacity;
+    }
+
+    BranchCount *branch = &profile->branches[profile->branchCount++];
+    snprintf(branch->function, sizeof(branch->function), "%s", function);
+    branch->location = location;
+    branch->counts[0] = trueCount;
+    branch->counts[1] = falseCount;
+    return 1;
+}
+
+const BranchCount *findBranchCount(const BranchProfile *profile, const char *function, Location location) {
+    for (int index = 0; index < profile->branchCount; index++) {
+        const BranchCount *branch = &profile->branches[index];
+
+        if (branch->location.line == location.line && branch->location.column == location.column &&
+            strcmp(branch->function, function) == 0) return branch;
+    }
+
+    return NULL;
+}
+
+BranchProfile *readBranchProfile(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) return NULL;
+
+    BranchProfile *profile = initBranchProfile();
+    char line[LEXEME_LENGTH + 128];
+    int result = profile != NULL;
+
+    // Each line holds the counts of a branch, after a line starting with '#' describing the format
+    while (result && fgets(line, sizeof(line), file)) {
+        char function[LEXEME_LENGTH];
+        Location location;
+        long trueCount, falseCount;
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        result = sscanf(line, "%127s %d:%d %ld %ld", function, &location.line, &location.column, &trueCount,
+                        &falseCount) == 5 && addBranchCount(profile, function, location, trueCount, falseCount);
+    }
+
+    fclose(file);
+
+    if (!result) {
+        fprintf(stderr, "[ProfileError]: File '%s' is not a branch profile.\n", path);
+        freeBranchProfile(profile);
+        return NULL;
+    }
+
+    return profile;
+}
+
+int writeBranchProfile(const BranchProfile *profile, const char *path) {
+    FILE *file = fopen(path, "w");
+    int result = file != NULL;
+
+    if (file) {
+        fprintf(file, "# <function> <line>:<column> <true count> <false count>\n");
+
+        for (int index = 0; index < profile->branchCount; index++) {
+            const BranchCount *branch = &profile->branches[index];
+            fprintf(file, "%s %d:%d %ld %ld\n", branch->function, branch->location.line, branch->location.column,
+                    branch->counts[0], branch->counts[1]);
+        }
+
+        result = fclose(file) == 0;
+    }
+
+    if (!result) fprintf(stderr, "[AccessError]: File '%s' could not be written.\n", path);
+    return result;
+}
+
+void freeBranchProfile(BranchProfile *profile) {
+    if (!profile) return;
+
+    free(profile->branches);
+    free(profile);
+}
@@ -0,0 +1,59 @@
+// deadcode.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "deadcode.h"
+
+int eliminateDeadStores(IRProgram *program, IRFunction *function, DataflowProblem *liveness) {
+    Bitset *live = initBitset(function->registerCount + 1);
+    if (!live) return 0;
+
+    int removedCount = 0;
+
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+        int keptCount = block->instructionCount;
+        copyBitset(live, &liveness->out[blockIndex]);
+
+        // Kept instructions are gathered at the end of the block while walking backward
+        for (int index = block->instructionCount - 1; index >= 0; index--) {
+            IRInstruction instruction = block->instructions[index];
+            int destination = instruction.destination;
+            int isDead = destination >= 0 && instruction.opcode != IR_DECLARE && !testBit(live, destination) &&
+                         !isIRGlobal(program, function, destination);
+
+            if (isDead && isIRPure(instruction.opcode)) {
+                removedCount++;
+                continue;
+            }
+
+            if (isDead && instruction.opcode == IR_CALL) {
+                instruction.destination = IR_NO_REGISTER;
+                removedCount++;
+            }
+
+            // Same transfer as the liveness: a definition kills the register, and a use generates it again
+            int uses[2];
+            int useCount = getIRUses(&instruction, uses);
+            if (instruction.destination >= 0) clearBit(live, instruction.destination);
+            for (int use = 0; use < useCount; use++) setBit(live, uses[use]);
+
+            block->instructions[--keptCount] = instruction;
+        }
+
+        // Move the kept instructions back to the beginning of the block
+        int removedFromBlock = keptCount;
+
+        for (int index = keptCount; index < block->instructionCount; index++) {
+            block->instructions[index - removedFromBlock] = block->instructions[index];
+        }
+
+        block->instructionCount -= removedFromBlock;
+    }
+
+    freeBitset(live);
+    return removedCount;
+}
@@ -0,0 +1,247 @@
+// fold.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+#include "fold.h"
+#include "dataflow.h"
+#include "integer.h"
+
+int evaluateIRInstruction(IRInstruction *instruction, IRType operandType, IRConstant lhs, IRConstant rhs,
+                          int isOverflowChecked, IRConstant *result) {
+    int isFloat = (operandType == IR_TYPE_FLOAT);
+    int isUnsigned = (operandType == IR_TYPE_UINT32);
+    unsigned int left = (unsigned int) lhs.integerValue;
+    unsigned int right = (unsigned int) rhs.integerValue;
+    int immediate = instruction->constant.integerValue;
+    result->integerValue = 0;
+
+    // Only the arithmetic on an Int is checked, while a sized integer always wraps around
+    int isChecked = isOverflowChecked && instruction->type == IR_TYPE_INT;
+
+    switch (instruction->opcode) {
+        case IR_COPY: *result = lhs; return 1;
+        case IR_CONVERT: result->floatingValue = isUnsigned ? (float) left : (float) lhs.integerValue; return 1;
+
+        // Int arithmetic wraps around, which is computed on unsigned integers, while a checked overflow is left to fail
+        // at runtime
+        case IR_ADD: {
+            if (isFloat) result->floatingValue = lhs.floatingValue + rhs.floatingValue;
+            else if (isChecked) return !__builtin_add_overflow(lhs.integerValue, rhs.integerValue,
+                                                                       &result->integerValue);
+            else result->integerValue = (int) (left + right);
+            return 1;
+        }
+
+        case IR_SUBTRACT: {
+            if (isFloat) result->floatingValue = lhs.floatingValue - rhs.floatingValue;
+            else if (isChecked) return !__builtin_sub_overflow(lhs.integerValue, rhs.integerValue,
+                                                                       &result->integerValue);
+            else result->integerValue = (int) (left - right);
+            return 1;
+        }
+
+        case IR_MULTIPLY: {
+            if (isFloat) result->floatingValue = lhs.floatingValue * rhs.floatingValue;
+            else if (isChecked) return !__builtin_mul_overflow(lhs.integerValue, rhs.integerValue,
+                                                                       &result->integerValue);
+            else result->integerValue = (int) (left * right);
+            return 1;
+        }
+
+        // An Int division that fails at runtime is left to fail there
+        case IR_DIVIDE: case IR_MODULO: {
+            int isDivision = (instruction->opcode == IR_DIVIDE);
+
+            if (isFloat) {
+                result->floatingValue = isDivision ? lhs.floatingValue / rhs.floatingValue
+                                                   : fmodf(lhs.floatingValue, rhs.floatingValue);
+                return 1;
+            }
+
+            if (rhs.integerValue == 0) return 0;
+
+            if (isUnsigned) {
+                result->integerValue = (int) (isDivision ? left / right : left % right);
+                return 1;
+            }
+
+            if (lhs.integerValue == INT_MIN && rhs.integerValue == -1) return 0;
+            result->integerValue = isDivision ? lhs.integerValue / rhs.integerValue : lhs.integerValue % rhs.integerValue;
+            return 1;
+        }
+
+        case IR_NEGATE: {
+            if (isFloat) result->floatingValue = -lhs.floatingValue;
+            else if (isChecked && lhs.integerValue == INT_MIN) return 0;
+            else result->integerValue = (int) (0u - left);
+            return 1;
+        }
+
+        case IR_NOT: result->booleanValue = !lhs.booleanValue; return 1;
+
+        // Larger factorials overflow an Int, which is left to the runtime
+        case IR_FACTORIAL: {
+            if (lhs.integerValue > 12) return 0;
+
+            result->integerValue = 1;
+            for (int term = 2; term <= lhs.integerValue; term++) result->integerValue *= term;
+            return 1;
+        }
+
+        case IR_SHIFT_LEFT: result->integerValue = (int) (left << immediate); return 1;
+        case IR_SHIFT_RIGHT: result->integerValue = lhs.integerValue >> immediate; return 1;
+        case IR_SHIFT_RIGHT_LOGICAL: result->integerValue = (int) (left >> immediate); return 1;
+        case IR_BITWISE_AND: result->integerValue = lhs.integerValue & immediate; return 1;
+        case IR_MULTIPLY_HIGH: result->integerValue = (int) (((long long) lhs.integerValue * immediate) >> 32); return 1;
+
+        // The bit is counted from the second operand, where a value out of the mask has no bit set
+        case IR_BIT_TEST: {
+            unsigned int bit = left - right;
+            result->booleanValue = bit < 32 && (((unsigned int) immediate >> bit) & 1u);
+            return 1;
+        }
+
+        // Booleans and interned strings are compared by their integer representation
+        case IR_EQUAL: case IR_NOT_EQUAL: case IR_LESS_THAN: case IR_LESS_OR_EQUAL:
+        case IR_GREATER_THAN: case IR_GREATER_OR_EQUAL: {
+            int comparison = isFloat ? (lhs.floatingValue > rhs.floatingValue) - (lhs.floatingValue < rhs.floatingValue)
+                           : isUnsigned ? (left > right) - (left < right)
+                                        : (lhs.integerValue > rhs.integerValue) - (lhs.integerValue < rhs.integerValue);
+
+            // A comparison involving NaN is only true for '!='
+            if (isFloat && (isnan(lhs.floatingValue) || isnan(rhs.floatingValue))) {
+                result->booleanValue = (instruction->opcode == IR_NOT_EQUAL);
+                return 1;
+            }
+
+            switch (instruction->opcode) {
+                case IR_EQUAL: result->booleanValue = (comparison == 0); break;
+                case IR_NOT_EQUAL: result->booleanValue = (comparison != 0); break;
+                case IR_LESS_THAN: result->booleanValue = (comparison < 0); break;
+                case IR_LESS_OR_EQUAL: result->booleanValue = (comparison <= 0); break;
+                case IR_GREATER_THAN: result->booleanValue = (comparison > 0); break;
+                default: result->booleanValue = (comparison >= 0); break;
+            }
+
+            return 1;
+        }
+
+        default: return 0;
+    }
+}
+
+int foldConstants(IRProgram *program, IRFunction *function) {
+    int registerCount = function->registerCount;
+    int *definitionCounts = (int*) calloc(registerCount + 1, sizeof(int));
+    int *isConstant = (int*) calloc(registerCount + 1, sizeof(int));
+    IRConstant *constants = (IRConstant*) malloc((registerCount + 1) * sizeof(IRConstant));
+    IRType *constantTypes = (IRType*) malloc((registerCount + 1) * sizeof(IRType));
+    int *order = (int*) malloc((function->blockCount + 1) * sizeof(int));
+
+    if (!definitionCounts || !isConstant || !constants || !constantTypes || !order) {
+        free(definitionCounts); free(isConstant); free(constants); free(constantTypes); free(order);
+        return 0;
+    }
+
+    // Only a register assigned once always holds the same value
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            if (instruction->destination >= 0 && instruction->opcode != IR_DECLARE) definitionCounts[instruction->destination]++;
+        }
+    }
+
+    int orderCount = computeReversePostOrder(function, order);
+    int foldedCount = 0;
+    int isCFGChanged = 0;
+
+    for (int position = 0; position < orderCount; position++) {
+        BasicBlock *block = function->blocks[order[position]];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            int uses[2];
+            int useCount = getIRUses(instruction, uses);
+
+            // A branch on a constant always takes the same target
+            if (instruction->opcode == IR_BRANCH && isConstant[uses[0]]) {
+                instruction->opcode = IR_JUMP;
+                instruction->targets[0] = constants[uses[0]].booleanValue ? instruction->targets[0] : instruction->targets[1];
+                instruction->targets[1] = IR_NO_BLOCK;
+                instruction->operands[0] = IR_NO_REGISTER;
+                isCFGChanged = 1;
+                foldedCount++;
+                continue;
+            }
+
+            // A switch on a constant always goes through the same entry of its table (or to its default target)
+            if (instruction->opcode == IR_SWITCH && isConstant[uses[0]]) {
+                IRSwitchTable *table = &function->switchTables[instruction->constant.integerValue];
+                unsigned int entry = (unsigned int) constants[uses[0]].integerValue - (unsigned int) table->low;
+
+                instruction->opcode = IR_JUMP;
+                if (entry < (unsigned int) table->count) instruction->targets[0] = table->targets[entry];
+                instruction->operands[0] = IR_NO_REGISTER;
+                isCFGChanged = 1;
+                foldedCount++;
+                continue;
+            }
+
+            // A string is only known by the program, so its hash is computed here rather than by the evaluation
+            if (instruction->opcode == IR_STRING_HASH && isConstant[uses[0]]) {
+                instruction->opcode = IR_CONSTANT;
+                instruction->constant.integerValue = hashIRString(program->strings[constants[uses[0]].stringIndex],
+                                                                  instruction->constant.integerValue);
+                instruction->operands[0] = IR_NO_REGISTER;
+                foldedCount++;
+            }
+
+            // Evaluate the instructions reading only constants, as long as the type of the result is known
+            if (instruction->opcode != IR_CONSTANT && useCount > 0 && instruction->destination >= 0) {
+                int isFoldable = (isIRPure(instruction->opcode) || instruction->opcode == IR_DIVIDE ||
+                                  instruction->opcode == IR_MODULO);
+                for (int use = 0; use < useCount; use++) isFoldable = isFoldable && isConstant[uses[use]];
+
+                IRType type = instruction->opcode == IR_COPY && isFoldable ? constantTypes[uses[0]] : instruction->type;
+                IRConstant result;
+
+                if (isFoldable && type != IR_TYPE_ANY && type != IR_TYPE_VOID &&
+                    evaluateIRInstruction(instruction, isIRUnsigned(function, instruction) ? IR_TYPE_UINT32
+                                                                                            : constantTypes[uses[0]],
+                                          constants[uses[0]],
+                                          constants[uses[useCount - 1]], program->isOverflowChecked, &result)) {
+                    instruction->opcode = IR_CONSTANT;
+                    instruction->type = type;
+                    instruction->operands[0] = IR_NO_REGISTER;
+                    instruction->operands[1] = IR_NO_REGISTER;
+                    instruction->constant = result;
+                    foldedCount++;
+                }
+            }
+
+            // A register assigned once by a constant always holds it, unless it is a global which any call might assign
+            if (instruction->opcode == IR_CONSTANT && definitionCounts[instruction->destination] == 1 &&
+                !isIRGlobal(program, function, instruction->destination)) {
+                isConstant[instruction->destination] = 1;
+                constants[instruction->destination] = instruction->constant;
+                constantTypes[instruction->destination] = instruction->type;
+            }
+        }
+    }
+
+    if (isCFGChanged) computeIRPredecessors(function);
+
+    free(definitionCounts);
+    free(isConstant);
+    free(constants);
+    free(constantTypes);
+    free(order);
+    return foldedCount;
+}
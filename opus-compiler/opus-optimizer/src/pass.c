@@ -0,0 +1,243 @@
+// pass.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pass.h"
+#include "fold.h"
+#include "peephole.h"
+#include "cfg.h"
+#include "deadcode.h"
+#include "frame.h"
+
+static int runFoldPass(PassManager *manager, int functionIndex) {
+    return foldConstants(manager->program, manager->program->functions[functionIndex]) > 0;
+}
+
+static int runPeepholePass(PassManager *manager, int functionIndex) {
+    return optimizeFunctionPeephole(manager->program, manager->program->functions[functionIndex],
+                                    manager->firedCounts) > 0;
+}
+
+static int runUnreachablePass(PassManager *manager, int functionIndex) {
+    return removeUnreachableBlocks(manager->program->functions[functionIndex]) > 0;
+}
+
+static int runThreadPass(PassManager *manager, int functionIndex) {
+    return threadJumps(manager->program, manager->program->functions[functionIndex]) > 0;
+}
+
+static int runLayoutPass(PassManager *manager, int functionIndex) {
+    return layoutBlocks(manager->program->functions[functionIndex], manager->branchProfile) > 0;
+}
+
+static int runDeadStorePass(PassManager *manager, int functionIndex) {
+    DataflowProblem *liveness = getPassLiveness(manager, functionIndex);
+    return liveness && eliminateDeadStores(manager->program, manager->program->functions[functionIndex], liveness) > 0;
+}
+
+// Allocating the frame only reads the IR, so it never reports a change
+static int runFramePass(PassManager *manager, int functionIndex) {
+    IRFunction *function = manager->program->functions[functionIndex];
+    DataflowProblem *liveness = getPassLiveness(manager, functionIndex);
+
+    if (liveness && assignFrameSlots(function, liveness)) displayFrameReduction(function);
+    return 0;
+}
+
+const Pass passes[] = {
+    {"fold", runFoldPass, ANALYSIS_NONE},
+    {"peephole", runPeepholePass, ANALYSIS_NONE},
+    {"unreachable", runUnreachablePass, ANALYSIS_NONE},
+    {"dse", runDeadStorePass, ANALYSIS_NONE},
+    {"thread", runThreadPass, ANALYSIS_NONE},
+    {"layout", runLayoutPass, ANALYSIS_NONE},
+    {"frame", runFramePass, ANALYSIS_ALL},
+};
+
+const int passCount = sizeof(passes) / sizeof(passes[0]);
+
+// The pipeline of each optimization level, where a later pass often exposes more work to an earlier one, and the
+// blocks are laid out once they are final
+static const char *passLevels[PASS_MAX_LEVEL + 1] = {
+    "frame",
+    "fold,peephole,frame",
+    "fold,peephole,unreachable,dse,peephole,thread,layout,frame",
+    "fold,peephole,unreachable,dse,peephole,fold,peephole,thread,dse,layout,frame",
+};
+
+PassManager *initPassManager(int level) {
+    PassManager *manager = (PassManager*) calloc(1, sizeof(PassManager));
+    if (!manager) return NULL;
+
+    manager->firedCounts = (int*) calloc(peepholeRuleCount, sizeof(int));
+
+    if (!manager->firedCounts) {
+        free(manager);
+        return NULL;
+    }
+
+    if (level < 0) level = 0;
+    if (level > PASS_MAX_LEVEL) level = PASS_MAX_LEVEL;
+
+    parsePassPipeline(manager, passLevels[level]);
+    return manager;
+}
+
+int parsePassPipeline(PassManager *manager, const char *list) {
+    char name[LEXEME_LENGTH];
+    int pipelineCount = 0;
+    int pipeline[PASS_MAX_PIPELINE];
+
+    while (*list) {
+        size_t length = strcspn(list, ",");
+
+        if (length == 0 || length >= LEXEME_LENGTH) {
+            printf("[ERROR] Invalid pass list near '%s'.\n", list);
+            return 0;
+        }
+
+        memcpy(name, list, length);
+        name[length] = '\0';
+        list += length + (list[length] == ',');
+
+        int pass = findPass(name);
+
+        if (pass < 0) {
+            printf("[ERROR] Unknown pass '%s'.\n", name);
+            return 0;
+        }
+
+        // Keep a slot for the frame allocation
+        if (pipelineCount == PASS_MAX_PIPELINE - 1) {
+            printf("[ERROR] Too many passes, at most %d passes could be run.\n", PASS_MAX_PIPELINE - 1);
+            return 0;
+        }
+
+        pipeline[pipelineCount++] = pass;
+    }
+
+    // Later stages rely on the frames, so they are always allocated once the IR is final
+    int framePass = findPass("frame");
+    if (pipelineCount == 0 || pipeline[pipelineCount - 1] != framePass) pipeline[pipelineCount++] = framePass;
+
+    memcpy(manager->pipeline, pipeline, pipelineCount * sizeof(int));
+    manager->pipelineCount = pipelineCount;
+    return 1;
+}
+
+int findPass(const char *name) {
+    for (int pass = 0; pass < passCount; pass++) if (strcmp(passes[pass].name, name) == 0) return pass;
+    return -1;
+}
+
+int isPassScheduled(PassManager *manager, const char *name) {
+    int pass = findPass(name);
+
+    for (int entry = 0; entry < manager->pipelineCount; entry++) if (manager->pipeline[entry] == pass) return 1;
+    return 0;
+}
+
+// Counts the instructions and the blocks of the whole program
+static void measureProgram(IRProgram *program, int *instructionCount, int *blockCount) {
+    *instructionCount = 0;
+    *blockCount = 0;
+
+    for (int index = 0; index < program->functionCount; index++) {
+        IRFunction *function = program->functions[index];
+        *blockCount += function->blockCount;
+
+        for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+            *instructionCount += function->blocks[blockIndex]->instructionCount;
+        }
+    }
+}
+
+int runPassManager(PassManager *manager, IRProgram *program) {
+    manager->program = program;
+    manager->liveness = (DataflowProblem**) calloc(program->functionCount + 1, sizeof(DataflowProblem*));
+    manager->validAnalyses = (int*) calloc(program->functionCount + 1, sizeof(int));
+    if (!manager->liveness || !manager->validAnalyses) return 0;
+
+    // Each pass runs over every function before the next pass starts, so that it is timed as a whole
+    for (int entry = 0; entry < manager->pipelineCount; entry++) {
+        const Pass *pass = &passes[manager->pipeline[entry]];
+        PassRecord *record = &manager->records[entry];
+        measureProgram(program, &record->instructionsBefore, &record->blocksBefore);
+
+        clock_t start = clock();
+
+        for (int index = 0; index < program->functionCount; index++) {
+            if (!pass->run(manager, index)) continue;
+
+            invalidateAnalyses(manager, index, pass->preservedAnalyses);
+            record->changedCount++;
+        }
+
+        record->milliseconds = 1000.0 * (double) (clock() - start) / CLOCKS_PER_SEC;
+        measureProgram(program, &record->instructionsAfter, &record->blocksAfter);
+    }
+
+    return 1;
+}
+
+DataflowProblem *getPassLiveness(PassManager *manager, int functionIndex) {
+    if (manager->validAnalyses[functionIndex] & ANALYSIS_LIVENESS) {
+        manager->reusedCount++;
+        return manager->liveness[functionIndex];
+    }
+
+    freeDataflowProblem(manager->liveness[functionIndex]);
+    manager->liveness[functionIndex] = computeLiveness(manager->program->functions[functionIndex]);
+    manager->computedCount++;
+
+    if (manager->liveness[functionIndex]) manager->validAnalyses[functionIndex] |= ANALYSIS_LIVENESS;
+    return manager->liveness[functionIndex];
+}
+
+void invalidateAnalyses(PassManager *manager, int functionIndex, int preservedAnalyses) {
+    manager->validAnalyses[functionIndex] &= preservedAnalyses;
+}
+
+void displayPassStatistics(PassManager *manager) {
+    double totalMilliseconds = 0.0;
+
+    printf("\n--------------------------------- Pass Statistics ---------------------------------\n");
+    printf("%-14s %-12s %-24s %-20s %s\n", "Pass", "Time (ms)", "Instructions", "Blocks", "Changed");
+
+    for (int entry = 0; entry < manager->pipelineCount; entry++) {
+        PassRecord *record = &manager->records[entry];
+        char instructions[32], blocks[32];
+
+        snprintf(instructions, sizeof(instructions), "%d -> %d (%+d)", record->instructionsBefore,
+                 record->instructionsAfter, record->instructionsAfter - record->instructionsBefore);
+        snprintf(blocks, sizeof(blocks), "%d -> %d (%+d)", record->blocksBefore, record->blocksAfter,
+                 record->blocksAfter - record->blocksBefore);
+
+        printf("%-14s %-12.3f %-24s %-20s %d\n", passes[manager->pipeline[entry]].name, record->milliseconds,
+               instructions, blocks, record->changedCount);
+        totalMilliseconds += record->milliseconds;
+    }
+
+    printf("Total %.3f ms, liveness computed %d time%s and reused %d time%s.\n", totalMilliseconds,
+           manager->computedCount, manager->computedCount == 1 ? "" : "s",
+           manager->reusedCount, manager->reusedCount == 1 ? "" : "s");
+    printf("-----------------------------------------------------------------------------------\n");
+}
+
+void freePassManager(PassManager *manager) {
+    if (!manager) return;
+
+    if (manager->liveness && manager->program) {
+        for (int index = 0; index < manager->program->functionCount; index++) freeDataflowProblem(manager->liveness[index]);
+    }
+
+    free(manager->liveness);
+    free(manager->validAnalyses);
+    free(manager->firedCounts);
+    free(manager);
+}
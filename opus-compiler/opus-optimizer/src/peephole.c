@@ -0,0 +1,548 @@
+// peephole.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "peephole.h"
+
+/// Whether a register is a temporary assigned once and read once, so that it could be fused away.
+static int isSingleUseTemporary(PeepholeContext *context, int reg) {
+    return reg >= context->function->localCount && context->useCounts[reg] == 1 && context->definitionCounts[reg] == 1;
+}
+
+/// Gets the value of a register always holding the same Int constant.
+static int getConstantInteger(PeepholeContext *context, int reg, int *value) {
+    if (reg < 0 || !context->isConstant[reg] || context->function->registerTypes[reg] != IR_TYPE_INT) return 0;
+
+    *value = context->constants[reg].integerValue;
+    return 1;
+}
+
+/// Gets k if the value is 2^k for some k >= 1, otherwise -1.
+static int getPowerOfTwo(int value) {
+    if (value < 2 || (value & (value - 1))) return -1;
+
+    int exponent = 0;
+    while ((1 << exponent) != value) exponent++;
+    return exponent;
+}
+
+/// Builds an instruction that is not emitted yet.
+static IRInstruction makePeepholeInstruction(IROpcode opcode, IRType type, int destination, int lhs, int rhs,
+                                             Location location) {
+    IRInstruction instruction;
+    memset(&instruction, 0, sizeof(IRInstruction));
+
+    instruction.opcode = opcode;
+    instruction.type = type;
+    instruction.destination = destination;
+    instruction.operands[0] = lhs;
+    instruction.operands[1] = rhs;
+    instruction.targets[0] = IR_NO_BLOCK;
+    instruction.targets[1] = IR_NO_BLOCK;
+    instruction.location = location;
+    return instruction;
+}
+
+/// Emits an Int instruction taking an immediate as its second operand.
+static void emitImmediateInstruction(PeepholeContext *context, IROpcode opcode, int destination, int operand,
+                                     int immediate, Location location) {
+    IRInstruction instruction = makePeepholeInstruction(opcode, IR_TYPE_INT, destination, operand, IR_NO_REGISTER, location);
+    instruction.constant.integerValue = immediate;
+    emitPeepholeInstruction(context, instruction);
+}
+
+/// Whether no emitted instruction from the index on assigns the register, so that reading it could be delayed.
+static int isUnchangedSince(PeepholeContext *context, int reg, int index) {
+    for (; index < context->outputCount; index++) {
+        if (context->output[index].destination == reg) return 0;
+        if (context->output[index].opcode == IR_CALL && isIRGlobal(context->program, context->function, reg)) return 0;
+    }
+
+    return 1;
+}
+
+/// Emits the bias added to a dividend before shifting it by k, which is 2^k - 1 for a negative dividend and 0
+/// otherwise, since the division of Int rounds toward zero while shifting rounds toward negative infinity.
+static int emitDivisionBias(PeepholeContext *context, int dividend, int exponent, Location location) {
+    int sign = addPeepholeRegister(context, IR_TYPE_INT);
+    emitImmediateInstruction(context, IR_SHIFT_RIGHT, sign, dividend, 31, location);
+
+    int bias = addPeepholeRegister(context, IR_TYPE_INT);
+    emitImmediateInstruction(context, IR_SHIFT_RIGHT_LOGICAL, bias, sign, 32 - exponent, location);
+    return bias;
+}
+
+/// Computes the magic number M and the shift s for dividing by a constant, so that the quotient is the high half of
+/// the product with M, corrected by the dividend if M has overflowed, shifted by s (Hacker's Delight, 10-1).
+/// The divisor must not be -1, 0, 1 or INT_MIN.
+static void computeMagicNumber(int divisor, int *multiplier, int *shift) {
+    const unsigned int twoPower31 = 0x80000000u;
+    unsigned int absolute = divisor < 0 ? 0u - (unsigned int) divisor : (unsigned int) divisor;
+    unsigned int threshold = twoPower31 + ((unsigned int) divisor >> 31);
+    unsigned int absoluteLimit = threshold - 1 - threshold % absolute;
+
+    int power = 31;
+    unsigned int quotientLimit = twoPower31 / absoluteLimit;
+    unsigned int remainderLimit = twoPower31 - quotientLimit * absoluteLimit;
+    unsigned int quotient = twoPower31 / absolute;
+    unsigned int remainder = twoPower31 - quotient * absolute;
+    unsigned int delta;
+
+    // Find the smallest power 2^p for which the approximation is exact for every dividend
+    do {
+        power++;
+        quotientLimit *= 2;
+        remainderLimit *= 2;
+
+        if (remainderLimit >= absoluteLimit) {
+            quotientLimit++;
+            remainderLimit -= absoluteLimit;
+        }
+
+        quotient *= 2;
+        remainder *= 2;
+
+        if (remainder >= absolute) {
+            quotient++;
+            remainder -= absolute;
+        }
+
+        delta = absolute - remainder;
+    } while (quotientLimit < delta || (quotientLimit == delta && remainderLimit == 0));
+
+    *multiplier = (int) (quotient + 1);
+    if (divisor < 0) *multiplier = -*multiplier;
+    *shift = power - 32;
+}
+
+/// "r = op ..." where r is never read: the instruction is removed.
+static int removeDeadTemporary(PeepholeContext *context, IRInstruction *instruction) {
+    int reg = instruction->destination;
+    return reg >= context->function->localCount && context->useCounts[reg] == 0 && isIRPure(instruction->opcode);
+}
+
+/// "x = copy x": the instruction is removed.
+static int removeSelfCopy(PeepholeContext *context, IRInstruction *instruction) {
+    (void) context;
+    return instruction->destination == instruction->operands[0];
+}
+
+/// "t = op ...; x = copy t": the operation assigns x directly.
+static int coalesceCopy(PeepholeContext *context, IRInstruction *instruction) {
+    int source = instruction->operands[0];
+    if (!isSingleUseTemporary(context, source) || context->outputCount == 0) return 0;
+
+    IRInstruction *previous = &context->output[context->outputCount - 1];
+    if (previous->destination != source || previous->opcode == IR_DECLARE) return 0;
+
+    IRInstruction definition = removePeepholeInstruction(context, context->outputCount - 1);
+    definition.destination = instruction->destination;
+    emitPeepholeInstruction(context, definition);
+    return 1;
+}
+
+/// "store_global g, r; t = load_global g": the stored register is copied instead of loading the global again.
+static int forwardStoredGlobal(PeepholeContext *context, IRInstruction *instruction) {
+    if (context->outputCount == 0) return 0;
+
+    IRInstruction *previous = &context->output[context->outputCount - 1];
+    if (previous->opcode != IR_STORE_GLOBAL || previous->constant.integerValue != instruction->constant.integerValue) return 0;
+
+    emitPeepholeInstruction(context, makePeepholeInstruction(IR_COPY, instruction->type, instruction->destination,
+                                                             previous->operands[0], IR_NO_REGISTER, instruction->location));
+    return 1;
+}
+
+/// "t = x == true" or "t = x != false" is a copy of x, and "t = x == false" or "t = x != true" is its negation.
+static int simplifyBooleanComparison(PeepholeContext *context, IRInstruction *instruction) {
+    if (instruction->opcode != IR_EQUAL && instruction->opcode != IR_NOT_EQUAL) return 0;
+
+    for (int side = 0; side < 2; side++) {
+        int constant = instruction->operands[side];
+        int operand = instruction->operands[1 - side];
+        if (!context->isConstant[constant] || context->function->registerTypes[constant] != IR_TYPE_BOOL) continue;
+        if (context->function->registerTypes[operand] != IR_TYPE_BOOL) continue;
+
+        int isKept = (context->constants[constant].booleanValue != 0) == (instruction->opcode == IR_EQUAL);
+        emitPeepholeInstruction(context, makePeepholeInstruction(isKept ? IR_COPY : IR_NOT, IR_TYPE_BOOL,
+                                                                 instruction->destination, operand, IR_NO_REGISTER,
+                                                                 instruction->location));
+        return 1;
+    }
+
+    return 0;
+}
+
+/// "t = not x; branch t, A, B": branches on x with the targets swapped.
+static int foldNegatedBranch(PeepholeContext *context, IRInstruction *instruction) {
+    int condition = instruction->operands[0];
+    if (!isSingleUseTemporary(context, condition) || context->outputCount == 0) return 0;
+
+    IRInstruction *previous = &context->output[context->outputCount - 1];
+    if (previous->opcode != IR_NOT || previous->destination != condition) return 0;
+
+    IRInstruction negation = removePeepholeInstruction(context, context->outputCount - 1);
+    IRInstruction branch = *instruction;
+    branch.operands[0] = negation.operands[0];
+    branch.targets[0] = instruction->targets[1];
+    branch.targets[1] = instruction->targets[0];
+    emitPeepholeInstruction(context, branch);
+    return 1;
+}
+
+/// "branch c, A, B" where c is a constant: jumps to the target that is always taken.
+static int foldConstantBranch(PeepholeContext *context, IRInstruction *instruction) {
+    int condition = instruction->operands[0];
+    if (!context->isConstant[condition] || context->function->registerTypes[condition] != IR_TYPE_BOOL) return 0;
+
+    IRInstruction jump = *instruction;
+    jump.opcode = IR_JUMP;
+    jump.operands[0] = IR_NO_REGISTER;
+    jump.targets[0] = context->constants[condition].booleanValue ? instruction->targets[0] : instruction->targets[1];
+    jump.targets[1] = IR_NO_BLOCK;
+    emitPeepholeInstruction(context, jump);
+
+    context->isCFGChanged = 1;
+    return 1;
+}
+
+/// "r = x * 2^k": shifts x to the left by k.
+static int reduceMultiplication(PeepholeContext *context, IRInstruction *instruction) {
+    // A shift never fails, so a multiplication whose overflow is checked is kept
+    if (instruction->type != IR_TYPE_INT || context->program->isOverflowChecked) return 0;
+
+    for (int side = 0; side < 2; side++) {
+        int value;
+        int exponent = getConstantInteger(context, instruction->operands[side], &value) ? getPowerOfTwo(value) : -1;
+        if (exponent < 0) continue;
+
+        emitImmediateInstruction(context, IR_SHIFT_LEFT, instruction->destination, instruction->operands[1 - side],
+                                 exponent, instruction->location);
+        return 1;
+    }
+
+    return 0;
+}
+
+/// "r = x / 2^k": shifts the biased x to the right by k.
+static int reduceDivisionByPowerOfTwo(PeepholeContext *context, IRInstruction *instruction) {
+    int value;
+    int exponent = instruction->type == IR_TYPE_INT && getConstantInteger(context, instruction->operands[1], &value)
+                 ? getPowerOfTwo(value) : -1;
+    if (exponent < 0) return 0;
+
+    Location location = instruction->location;
+    int dividend = instruction->operands[0];
+    int bias = emitDivisionBias(context, dividend, exponent, location);
+
+    int biased = addPeepholeRegister(context, IR_TYPE_INT);
+    emitPeepholeInstruction(context, makePeepholeInstruction(IR_ADD, IR_TYPE_INT, biased, dividend, bias, location));
+    emitImmediateInstruction(context, IR_SHIFT_RIGHT, instruction->destination, biased, exponent, location);
+    return 1;
+}
+
+/// "r = x % 2^k": masks the biased x, then removes the bias again, so that the remainder keeps the sign of x.
+static int reduceModuloByPowerOfTwo(PeepholeContext *context, IRInstruction *instruction) {
+    int value;
+    int exponent = instruction->type == IR_TYPE_INT && getConstantInteger(context, instruction->operands[1], &value)
+                 ? getPowerOfTwo(value) : -1;
+    if (exponent < 0) return 0;
+
+    Location location = instruction->location;
+    int dividend = instruction->operands[0];
+    int bias = emitDivisionBias(context, dividend, exponent, location);
+
+    int biased = addPeepholeRegister(context, IR_TYPE_INT);
+    emitPeepholeInstruction(context, makePeepholeInstruction(IR_ADD, IR_TYPE_INT, biased, dividend, bias, location));
+
+    int masked = addPeepholeRegister(context, IR_TYPE_INT);
+    emitImmediateInstruction(context, IR_BITWISE_AND, masked, biased, value - 1, location);
+    emitPeepholeInstruction(context, makePeepholeInstruction(IR_SUBTRACT, IR_TYPE_INT, instruction->destination,
+                                                             masked, bias, location));
+    return 1;
+}
+
+/// "r = x / c" for any other constant c: multiplies x by the magic number of c and keeps the high half.
+static int reduceDivisionByConstant(PeepholeContext *context, IRInstruction *instruction) {
+    int divisor;
+    if (instruction->type != IR_TYPE_INT || !getConstantInteger(context, instruction->operands[1], &divisor)) return 0;
+    if (divisor == INT_MIN || (divisor >= -1 && divisor <= 1) || getPowerOfTwo(divisor) >= 0) return 0;
+
+    int multiplier, shift;
+    computeMagicNumber(divisor, &multiplier, &shift);
+
+    Location location = instruction->location;
+    int dividend = instruction->operands[0];
+    int quotient = addPeepholeRegister(context, IR_TYPE_INT);
+    emitImmediateInstruction(context, IR_MULTIPLY_HIGH, quotient, dividend, multiplier, location);
+
+    // The magic number might have overflowed into the opposite sign, which is corrected by the dividend
+    if ((divisor > 0 && multiplier < 0) || (divisor < 0 && multiplier > 0)) {
+        int corrected = addPeepholeRegister(context, IR_TYPE_INT);
+        IROpcode opcode = divisor > 0 ? IR_ADD : IR_SUBTRACT;
+        emitPeepholeInstruction(context, makePeepholeInstruction(opcode, IR_TYPE_INT, corrected, quotient, dividend, location));
+        quotient = corrected;
+    }
+
+    if (shift > 0) {
+        int shifted = addPeepholeRegister(context, IR_TYPE_INT);
+        emitImmediateInstruction(context, IR_SHIFT_RIGHT, shifted, quotient, shift, location);
+        quotient = shifted;
+    }
+
+    // Add one to a negative quotient, so that it is rounded toward zero
+    int sign = addPeepholeRegister(context, IR_TYPE_INT);
+    emitImmediateInstruction(context, IR_SHIFT_RIGHT_LOGICAL, sign, quotient, 31, location);
+    emitPeepholeInstruction(context, makePeepholeInstruction(IR_ADD, IR_TYPE_INT, instruction->destination, quotient,
+                                                             sign, location));
+    return 1;
+}
+
+/// "t = copy x; ...; op t": the operation reads x directly, as long as x is not assigned in between.
+static int forwardCopiedOperands(PeepholeContext *context, IRInstruction *instruction) {
+    IRInstruction rewritten = *instruction;
+    int isForwarded = 0;
+
+    for (int side = 0; side < 2; side++) {
+        int operand = rewritten.operands[side];
+        if (operand < 0 || !isSingleUseTemporary(context, operand)) continue;
+
+        int index = findPeepholeDefinition(context, operand);
+        if (index < 0 || context->output[index].opcode != IR_COPY) continue;
+
+        int source = context->output[index].operands[0];
+        if (!isUnchangedSince(context, source, index + 1)) continue;
+
+        removePeepholeInstruction(context, index);
+        rewritten.operands[side] = source;
+        isForwarded = 1;
+    }
+
+    if (isForwarded) emitPeepholeInstruction(context, rewritten);
+    return isForwarded;
+}
+
+const PeepholeRule peepholeRules[] = {
+    {"dead-temporary", PEEPHOLE_ANY_OPCODE, removeDeadTemporary},
+    {"self-copy", IR_COPY, removeSelfCopy},
+    {"copy-coalesce", IR_COPY, coalesceCopy},
+    {"store-load", IR_LOAD_GLOBAL, forwardStoredGlobal},
+    {"compare-bool", PEEPHOLE_ANY_OPCODE, simplifyBooleanComparison},
+    {"branch-not", IR_BRANCH, foldNegatedBranch},
+    {"branch-constant", IR_BRANCH, foldConstantBranch},
+    {"multiply-shift", IR_MULTIPLY, reduceMultiplication},
+    {"divide-shift", IR_DIVIDE, reduceDivisionByPowerOfTwo},
+    {"divide-magic", IR_DIVIDE, reduceDivisionByConstant},
+    {"modulo-mask", IR_MODULO, reduceModuloByPowerOfTwo},
+    {"copy-forward", PEEPHOLE_ANY_OPCODE, forwardCopiedOperands},
+};
+
+const int peepholeRuleCount = sizeof(peepholeRules) / sizeof(PeepholeRule);
+
+/// Appends an instruction to the output of the current block without counting its registers.
+static void appendPeepholeInstruction(PeepholeContext *context, IRInstruction instruction) {
+    if (context->outputCount == context->outputCapacity) {
+        int capacity = context->outputCapacity ? context->outputCapacity * 2 : 8;
+        IRInstruction *output = (IRInstruction*) realloc(context->output, capacity * sizeof(IRInstruction));
+
+        // There is no way to recover from running out of memory in the middle of rewriting a block
+        if (!output) {
+            fprintf(stderr, "[PeepholeError]: Unable to allocate memory for instructions.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        context->output = output;
+        context->outputCapacity = capacity;
+    }
+
+    context->output[context->outputCount++] = instruction;
+}
+
+/// Adds (1) or removes (-1) the registers read and assigned by an instruction from the counts.
+static void countPeepholeInstruction(PeepholeContext *context, IRInstruction *instruction, int delta) {
+    int uses[2];
+    int useCount = getIRUses(instruction, uses);
+
+    for (int use = 0; use < useCount; use++) context->useCounts[uses[use]] += delta;
+    if (instruction->destination >= 0 && instruction->opcode != IR_DECLARE) {
+        context->definitionCounts[instruction->destination] += delta;
+    }
+}
+
+/// Grows the per-register arrays to hold every register of the function, where new registers are cleared.
+static int reservePeepholeRegisters(PeepholeContext *context) {
+    int registerCount = context->function->registerCount;
+    if (registerCount < context->registerCapacity) return 1;
+
+    int capacity = context->registerCapacity ? context->registerCapacity * 2 : 16;
+    while (capacity <= registerCount) capacity *= 2;
+
+    int *useCounts = (int*) realloc(context->useCounts, capacity * sizeof(int));
+    if (useCounts) context->useCounts = useCounts;
+    int *definitionCounts = (int*) realloc(context->definitionCounts, capacity * sizeof(int));
+    if (definitionCounts) context->definitionCounts = definitionCounts;
+    int *isConstant = (int*) realloc(context->isConstant, capacity * sizeof(int));
+    if (isConstant) context->isConstant = isConstant;
+    IRConstant *constants = (IRConstant*) realloc(context->constants, capacity * sizeof(IRConstant));
+    if (constants) context->constants = constants;
+
+    if (!useCounts || !definitionCounts || !isConstant || !constants) return 0;
+
+    int previous = context->registerCapacity;
+    memset(context->useCounts + previous, 0, (capacity - previous) * sizeof(int));
+    memset(context->definitionCounts + previous, 0, (capacity - previous) * sizeof(int));
+    memset(context->isConstant + previous, 0, (capacity - previous) * sizeof(int));
+
+    context->registerCapacity = capacity;
+    return 1;
+}
+
+/// Counts the reads and the assignments of every register, and finds the registers always holding the same
+/// constant, that is assigned by a single constant instruction (globals might be assigned by any call).
+static int countPeepholeRegisters(PeepholeContext *context) {
+    IRFunction *function = context->function;
+    if (!reservePeepholeRegisters(context)) return 0;
+
+    memset(context->useCounts, 0, context->registerCapacity * sizeof(int));
+    memset(context->definitionCounts, 0, context->registerCapacity * sizeof(int));
+    memset(context->isConstant, 0, context->registerCapacity * sizeof(int));
+
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            countPeepholeInstruction(context, instruction, 1);
+
+            if (instruction->opcode == IR_CONSTANT) {
+                context->isConstant[instruction->destination] = 1;
+                context->constants[instruction->destination] = instruction->constant;
+            }
+        }
+    }
+
+    for (int reg = 0; reg < function->registerCount; reg++) {
+        if (context->definitionCounts[reg] != 1 || isIRGlobal(context->program, function, reg)) context->isConstant[reg] = 0;
+    }
+
+    return 1;
+}
+
+int optimizePeephole(IRProgram *program, int *firedCounts) {
+    int firedCount = 0;
+
+    for (int index = 0; index < program->functionCount; index++) {
+        firedCount += optimizeFunctionPeephole(program, program->functions[index], firedCounts);
+    }
+
+    return firedCount;
+}
+
+int optimizeFunctionPeephole(IRProgram *program, IRFunction *function, int *firedCounts) {
+    PeepholeContext context = {program, function, NULL, 0, 0, NULL, NULL, NULL, NULL, 0, 0};
+    int firedCount = 0;
+
+    for (int round = 0; round < PEEPHOLE_MAX_ROUNDS && countPeepholeRegisters(&context); round++) {
+        int roundCount = 0;
+
+        for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+            BasicBlock *block = function->blocks[blockIndex];
+            context.outputCount = 0;
+
+            for (int index = 0; index < block->instructionCount; index++) {
+                IRInstruction instruction = block->instructions[index];
+                int rule = 0;
+
+                // Offer the instruction to the rules matching its opcode, until one of them fires
+                for (; rule < peepholeRuleCount; rule++) {
+                    int opcode = peepholeRules[rule].opcode;
+                    if (opcode != PEEPHOLE_ANY_OPCODE && opcode != (int) instruction.opcode) continue;
+                    if (peepholeRules[rule].apply(&context, &instruction)) break;
+                }
+
+                if (rule == peepholeRuleCount) {
+                    appendPeepholeInstruction(&context, instruction);
+                    continue;
+                }
+
+                // The instruction has been replaced by whatever the rule has emitted
+                countPeepholeInstruction(&context, &block->instructions[index], -1);
+                firedCounts[rule]++;
+                roundCount++;
+            }
+
+            // The output becomes the block, and the old instructions are reused as the output of the next block
+            IRInstruction *instructions = block->instructions;
+            int capacity = block->instructionCapacity;
+
+            block->instructions = context.output;
+            block->instructionCount = context.outputCount;
+            block->instructionCapacity = context.outputCapacity;
+            context.output = instructions;
+            context.outputCapacity = capacity;
+        }
+
+        firedCount += roundCount;
+        if (roundCount == 0) break;
+    }
+
+    // Turning a branch into a jump removes an edge of the CFG
+    if (context.isCFGChanged) computeIRPredecessors(function);
+
+    free(context.output);
+    free(context.useCounts);
+    free(context.definitionCounts);
+    free(context.isConstant);
+    free(context.constants);
+    return firedCount;
+}
+
+void emitPeepholeInstruction(PeepholeContext *context, IRInstruction instruction) {
+    appendPeepholeInstruction(context, instruction);
+    countPeepholeInstruction(context, &instruction, 1);
+}
+
+IRInstruction removePeepholeInstruction(PeepholeContext *context, int index) {
+    IRInstruction instruction = context->output[index];
+    countPeepholeInstruction(context, &instruction, -1);
+
+    memmove(&context->output[index], &context->output[index + 1],
+            (context->outputCount - index - 1) * sizeof(IRInstruction));
+    context->outputCount--;
+    return instruction;
+}
+
+int findPeepholeDefinition(PeepholeContext *context, int reg) {
+    int limit = context->outputCount > PEEPHOLE_WINDOW ? context->outputCount - PEEPHOLE_WINDOW : 0;
+
+    for (int index = context->outputCount - 1; index >= limit; index--) {
+        if (context->output[index].destination == reg) return index;
+    }
+
+    return -1;
+}
+
+int addPeepholeRegister(PeepholeContext *context, IRType type) {
+    int reg = addIRRegister(context->function, type);
+
+    // There is no way to recover from running out of memory in the middle of rewriting a block
+    if (reg == IR_NO_REGISTER || !reservePeepholeRegisters(context)) {
+        fprintf(stderr, "[PeepholeError]: Unable to allocate memory for registers.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return reg;
+}
+
+void displayPeepholeReport(int *firedCounts) {
+    for (int rule = 0; rule < peepholeRuleCount; rule++) {
+        if (firedCounts[rule] == 0) continue;
+        printf("[Peephole] Rule '%s' fired %d time%s.\n", peepholeRules[rule].name, firedCounts[rule],
+               firedCounts[rule] == 1 ? "" : "s");
+    }
+}
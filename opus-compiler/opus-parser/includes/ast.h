@@ -34,6 +34,8 @@ typedef enum {
     AST_PARAMETER_LIST,            /// Function parameter list (e.g. "(number: Int, ...)")
     AST_PARAMETER_LABEL,           /// The label of the parameter.
     AST_FUNCTION_RETURN_TYPE,      /// Function return type (e.g. "-> Bool").
+    AST_GENERIC_PARAMETER_LIST,    /// Type parameter list of a generic function (e.g. "<T: Numeric, U>").
+    AST_GENERIC_PARAMETER,         /// Type parameter and its optional constraint (e.g. "T: Numeric").
     AST_CODE_BLOCK,                /// A code block (e.g. "{...}").
     AST_RETURN_STATEMENT,          /// Return statement for the function body (e.g. "return 42").
     AST_CONDITIONAL_STATEMENT,     /// Conditional statement (e.g. "if").
@@ -41,6 +43,11 @@ typedef enum {
     AST_REPEAT_UNTIL_STATEMENT,    /// The repeat-until loop statement.
     AST_FOR_IN_STATEMENT,          /// For-in statement.
     AST_FOR_IN_CONTEXT,            /// The element and the iterated expression.
+    AST_SWITCH_STATEMENT,          /// Switch statement (e.g. "switch grade { ... }").
+    AST_SWITCH_CASE,               /// A case of the switch statement, or its default case.
+    AST_SWITCH_PATTERN,            /// A value matched by a case (e.g. "case 1, 2").
+    AST_SWITCH_BODY,               /// The body of a case, followed by the next case.
+    AST_IMPORT_DECLARATION,        /// Import declaration (e.g. "import geometry").
     AST_ERROR,                     /// The error node for panic mode recovery.
 } ASTNodeType;
 
@@ -61,6 +68,8 @@ typedef struct ASTNode {
         float floatingValue; 
         int booleanValue; 
         char stringLiteral[LEXEME_LENGTH]; 
+        int integerLanes[8]; 
+        float floatingLanes[8]; 
     } nodeValue;
 } ASTNode;
 
@@ -38,15 +38,24 @@ typedef enum {
     PARSE_ERROR_UNRESOLVABLE,                    /// An unresolvable token occurred.
     PARSE_ERROR_MISSING_OPERAND,                 /// A required operand is missing.
     PARSE_ERROR_MISSING_ARGUMENT,                /// A required argument is missing.
+    PARSE_ERROR_MISSING_MODULE_NAME,             /// A required module name is missing.
+    PARSE_ERROR_MISSING_TYPE_PARAMETER,          /// A required type parameter is missing.
+    PARSE_ERROR_MISSING_CLOSING_ANGLE_BRACKET,   /// A required '>' closing the type parameters is missing.
+    PARSE_ERROR_MISSING_CASE,                    /// A required 'case' or 'default' of a switch is missing.
+    PARSE_ERROR_MISSING_CASE_VALUE,              /// A required value matched by a case is missing.
 } ParseError;
 
 /// The parser for the Opus programming language.
 /// It processes tokens from the lexer and constructs an Abstract Syntax Tree (AST).
 typedef struct {
-    ParseError parseError;    /// Stores the current parsing error state, if any.
-    Lexer* lexer;             /// Pointer to the lexer instance responsible for tokenizing input.
-    Token* currentToken;      /// Pointer to the current token being processed by the parser.
-    Token* diagnosticToken;   /// Pointer to the previous token for generating diagnostic information.
+    ParseError parseError;        /// Stores the current parsing error state, if any.
+    Lexer* lexer;                 /// Pointer to the lexer instance responsible for tokenizing input.
+    Token* currentToken;          /// Pointer to the current token being processed by the parser.
+    Token* diagnosticToken;       /// Pointer to the previous token for generating diagnostic information.
+    Token** tokens;               /// Every token read so far in order if tracked (see trackParserTokens()), or NULL.
+    int tokenCount;               /// The number of tokens tracked.
+    int tokenCapacity;            /// The capacity of the tracked tokens.
+    DiagnosticList* diagnostics;  /// The list receiving the errors, or NULL to print them (see diagnostic.h).
 } Parser;
 
 /// Parses a Program in the Opus programming language.
@@ -146,7 +155,7 @@ ASTNode *parseAssignmentStatement(Parser *parser, FILE *sourceCode, ASTNode *lef
 /// This function handles function definitions, which include the function signature and optional body.
 /// It follows the grammar:
 ///
-///     FunctionDefinition -> "func" Identifier "(" ParameterList? ")" "->" ReturnType
+///     FunctionDefinition -> "func" Identifier ("<" GenericParameterList ">")? "(" ParameterList? ")" "->" ReturnType
 ///
 /// The resulting AST structure for a function definition ("func greeting() -> String") will be:
 ///
@@ -156,6 +165,8 @@ ASTNode *parseAssignmentStatement(Parser *parser, FILE *sourceCode, ASTNode *lef
 ///     │   │   ├── AST_PARAMETER_LIST
 ///     │   │   ├── AST_FUNCTION_RETURN_TYPE (String)
 ///
+/// The type parameters of a generic function (see parseGenericParameterList()) are the child of its identifier.
+///
 /// @param parser A pointer to the Parser instance, which maintains the token stream.
 /// @param sourceCode A file pointer to the source code (used for error reporting).
 /// @return A pointer to the ASTNode representing the parsed function definition, or NULL if a parsing error occurs.
@@ -188,6 +199,26 @@ ASTNode *parseFunctionDefinition(Parser *parser, FILE *sourceCode);
 ///
 ASTNode *parseParameterList(Parser *parser, FILE *sourceCode);
 
+/// Parses the type parameters of a generic function, after the opening '<' has been consumed, until the closing '>'
+/// which is consumed as well. It follows the grammar:
+///
+///     GenericParameterList -> GenericParameter (',' GenericParameter)*
+///     GenericParameter -> Identifier (':' Constraint)?
+///
+/// The resulting AST structure for "<T: Numeric, U>" will be:
+///
+/// AST_GENERIC_PARAMETER_LIST
+///    ├── AST_GENERIC_PARAMETER (T)
+///    │   ├── AST_TYPE_ANNOTATION (Numeric)
+///    ├── AST_GENERIC_PARAMETER_LIST
+///    │   ├── AST_GENERIC_PARAMETER (U)
+///
+/// @param parser A pointer to the Parser instance, which maintains the token stream.
+/// @param sourceCode A file pointer to the source code (used for error reporting).
+/// @return A pointer to the ASTNode representing the parsed type parameters, or an AST_ERROR node.
+///
+ASTNode *parseGenericParameterList(Parser *parser, FILE *sourceCode);
+
 /// Parses a code block in the Opus programming language.
 ///
 /// This function handles the parsing of statements inside a block, typically between opening and closing
@@ -229,6 +260,26 @@ ASTNode *parseCodeBlock(Parser *parser, FILE *sourceCode);
 ///
 ASTNode *parseReturnStatement(Parser *parser, FILE *sourceCode);
 
+/// Parses an import declaration in the Opus programming language.
+///
+/// This function handles import declarations, which name another module whose exported functions and constants
+/// become visible. It follows the grammar:
+///
+///     ImportDeclaration -> "import" Identifier Delimiter
+///
+/// The resulting AST structure for an import declaration ("import geometry") will be:
+///
+///     AST_PROGRAM
+///     ├── AST_IMPORT_DECLARATION (import)
+///     │   ├── AST_IDENTIFIER (geometry)
+///     ├── AST_PROGRAM
+///
+/// @param parser A pointer to the Parser instance, which maintains the token stream.
+/// @param sourceCode A file pointer to the source code (used for error reporting).
+/// @return A pointer to the ASTNode representing the parsed import declaration.
+///
+ASTNode *parseImportDeclaration(Parser *parser, FILE *sourceCode);
+
 /// Parses a conditional statement (if-else) in the Opus programming language.
 ///
 /// This function handles `if` statements with optional `else if` and `else` branches.
@@ -296,6 +347,37 @@ ASTNode *parseRepeatUntilStatement(Parser *parser, FILE *sourceCode);
 ///
 ASTNode *parseForInStatement(Parser *parser, FILE *sourceCode);
 
+/// Parses a switch statement in the Opus programming language.
+///
+/// This function handles `switch` statements, which execute the body of the case matching a value, or the body of
+/// the default case if no case matches it. It follows the grammar:
+///
+///     SwitchStatement -> "switch" Expression "{" { SwitchCase } "}"
+///     SwitchCase -> "case" Expression { "," Expression } CodeBlock | "default" CodeBlock
+///
+/// The resulting AST structure for a `switch` statement will be:
+///
+///     AST_PROGRAM
+///     ├── AST_SWITCH_STATEMENT (switch)
+///     │   ├── AST_IDENTIFIER (grade)
+///     │   ├── AST_SWITCH_CASE (case)
+///     │   │   ├── AST_SWITCH_PATTERN
+///     │   │   │   ├── AST_LITERAL (1)
+///     │   │   │   ├── AST_SWITCH_PATTERN
+///     │   │   │   │   ├── AST_LITERAL (2)
+///     │   │   ├── AST_SWITCH_BODY
+///     │   │   │   ├── AST_CODE_BLOCK
+///     │   │   │   ├── AST_SWITCH_CASE (default)
+///     │   │   │   │   ├── AST_SWITCH_BODY
+///     │   │   │   │   │   ├── AST_CODE_BLOCK
+///     ├── AST_PROGRAM
+///
+/// @param parser A pointer to the Parser instance, which maintains the token stream.
+/// @param sourceCode A file pointer to the source code (used for error reporting).
+/// @return A pointer to the ASTNode representing the parsed switch statement.
+///
+ASTNode *parseSwitchStatement(Parser *parser, FILE *sourceCode);
+
 /// Parses an expression in the Opus programming language.
 ///
 /// This function serves as the entry point for parsing expressions. It constructs an
@@ -548,6 +630,13 @@ int matchTokenType(Parser *parser, TokenType type);
 ///
 Token *advanceParser(Parser *parser, FILE *sourceCode); 
 
+/// Makes the parser keep every token it reads, including the tokens not referenced by the AST (e.g. delimiters),
+/// so that whoever keeps the AST could free its tokens later. Tracking silently stops if memory runs out.
+///
+/// @param parser Pointer to the Parser instance, before the first token is read.
+///
+void trackParserTokens(Parser *parser);
+
 /// Skips tokens until a delimiter is encountered, enabling error recovery.
 /// This function advances the parser until a `TOKEN_DELIMITER` is found, 
 /// allowing parsing to resume at a safe synchronization point. It is typically 
@@ -558,7 +647,7 @@ Token *advanceParser(Parser *parser, FILE *sourceCode);
 ///
 void escapeParseError(Parser *parser, FILE *sourceCode);
 
-/// Reports the current parsing error with diagnostic information.
+/// Reports the current parsing error with diagnostic information into the errors of the parser.
 /// @param parser Pointer to the Parser instance.
 ///
 void reportParseError(Parser *parser);
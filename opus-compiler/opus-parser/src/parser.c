@@ -46,6 +46,9 @@ ASTNode *parseStatement(Parser *parser, FILE *sourceCode) {
     // Try to parse function definition statement 
     else if (matchTokenType(parser, TOKEN_KEYWORD_FUNC)) return parseFunctionDefinition(parser, sourceCode); 
 
+    // Try to parse import declaration
+    else if (matchTokenType(parser, TOKEN_KEYWORD_IMPORT)) return parseImportDeclaration(parser, sourceCode);
+
     // Try to parse return statement for the function body
     else if (matchTokenType(parser, TOKEN_KEYWORD_RETURN)) return parseReturnStatement(parser, sourceCode);
 
@@ -57,6 +60,9 @@ ASTNode *parseStatement(Parser *parser, FILE *sourceCode) {
 
     // Try to parse for-in statement
     else if (matchTokenType(parser, TOKEN_KEYWORD_FOR)) return parseForInStatement(parser, sourceCode);
+
+    // Try to parse switch statement
+    else if (matchTokenType(parser, TOKEN_KEYWORD_SWITCH)) return parseSwitchStatement(parser, sourceCode);
     
     // Try to parse an primary expression 
     else if (isExpression(parser)) {
@@ -89,6 +95,7 @@ ASTNode *parseDeclaration(Parser *parser, FILE *sourceCode) {
         parser->diagnosticToken = root->token;
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(root);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -105,6 +112,8 @@ ASTNode *parseDeclaration(Parser *parser, FILE *sourceCode) {
 
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(root);
+        freeAST(identifierNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -117,6 +126,8 @@ ASTNode *parseDeclaration(Parser *parser, FILE *sourceCode) {
         parser->diagnosticToken = parser->currentToken;
         reportParseError(parser);        
         escapeParseError(parser, sourceCode);
+        freeAST(root);
+        freeAST(identifierNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -148,6 +159,7 @@ ASTNode *parseDeclaration(Parser *parser, FILE *sourceCode) {
         parser->diagnosticToken = typeAnnotationNode->token;
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(root);
         return initASTNode(AST_ERROR, NULL);
     }
 }
@@ -169,6 +181,7 @@ ASTNode *parseAssignmentStatement(Parser *parser, FILE *sourceCode, ASTNode *lef
 
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(root);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -191,6 +204,7 @@ ASTNode *parseFunctionDefinition(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(functionDefinitionNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -199,6 +213,19 @@ ASTNode *parseFunctionDefinition(Parser *parser, FILE *sourceCode) {
     // Consume the identifier token
     parser->currentToken = advanceParser(parser, sourceCode);
 
+    // A generic function lists its type parameters between '<' and '>' right after its name
+    if (matchTokenType(parser, TOKEN_LESS_THAN_OPERATOR)) {
+        parser->currentToken = advanceParser(parser, sourceCode);
+        ASTNode *genericParameterListNode = parseGenericParameterList(parser, sourceCode);
+
+        if (genericParameterListNode->nodeType == AST_ERROR) {
+            freeAST(functionDefinitionNode);
+            return genericParameterListNode;
+        }
+
+        functionDefinitionNode->left->left = genericParameterListNode;
+    }
+
     // Try to match the opening bracket token for the parameter list
     if (!matchTokenType(parser, TOKEN_OPENING_BRACKET)) {
         parser->parseError = PARSE_ERROR_MISSING_OPENING_BRACKET;
@@ -206,6 +233,7 @@ ASTNode *parseFunctionDefinition(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(functionDefinitionNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -213,11 +241,9 @@ ASTNode *parseFunctionDefinition(Parser *parser, FILE *sourceCode) {
     parser->currentToken = advanceParser(parser, sourceCode);
 
     // Try to match parameter list if present 
-    ASTNode *parameterListNode = initASTNode(AST_PARAMETER_LIST, NULL);
-
-    if (!matchTokenType(parser, TOKEN_CLOSING_BRACKET)) {
-        parameterListNode = parseParameterList(parser, sourceCode);
-    }
+    ASTNode *parameterListNode = matchTokenType(parser, TOKEN_CLOSING_BRACKET)
+        ? initASTNode(AST_PARAMETER_LIST, NULL)
+        : parseParameterList(parser, sourceCode);
 
     // Opus Lexer guaranteed that the opening and closing brackets match
     // Therefore we do not need to explicitly check if we could match the closing bracket
@@ -231,6 +257,8 @@ ASTNode *parseFunctionDefinition(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(functionDefinitionNode);
+        freeAST(parameterListNode);
         return initASTNode(AST_ERROR, NULL); 
     }
     
@@ -244,6 +272,8 @@ ASTNode *parseFunctionDefinition(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(functionDefinitionNode);
+        freeAST(parameterListNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -293,6 +323,9 @@ ASTNode *parseParameterList(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(parameterListNode);
+        freeAST(parameterNode);
+        freeAST(parameterLabelNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -305,6 +338,9 @@ ASTNode *parseParameterList(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(parameterListNode);
+        freeAST(parameterNode);
+        freeAST(parameterLabelNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -326,6 +362,72 @@ ASTNode *parseParameterList(Parser *parser, FILE *sourceCode) {
     return parameterListNode;
 }
 
+ASTNode *parseGenericParameterList(Parser *parser, FILE *sourceCode) {
+    // Each type parameter must be named, so try to match the first one
+    if (!matchTokenType(parser, TOKEN_IDENTIFIER)) {
+        parser->parseError = PARSE_ERROR_MISSING_TYPE_PARAMETER;
+        parser->diagnosticToken = parser->currentToken;
+
+        reportParseError(parser);
+        escapeParseError(parser, sourceCode);
+        return initASTNode(AST_ERROR, NULL);
+    }
+
+    ASTNode *genericParameterListNode = initASTNode(AST_GENERIC_PARAMETER_LIST, NULL);
+    ASTNode *genericParameterNode = initASTNode(AST_GENERIC_PARAMETER, parser->currentToken);
+    genericParameterListNode->left = genericParameterNode;
+
+    // Consume the type parameter
+    parser->currentToken = advanceParser(parser, sourceCode);
+
+    // The constraint is optional, where a type parameter without any constraint accepts every type
+    if (matchTokenType(parser, TOKEN_COLON)) {
+        parser->currentToken = advanceParser(parser, sourceCode);
+
+        if (!matchTokenType(parser, TOKEN_IDENTIFIER)) {
+            parser->parseError = PARSE_ERROR_MISSING_TYPE_NAME;
+            parser->diagnosticToken = parser->currentToken;
+
+            reportParseError(parser);
+            escapeParseError(parser, sourceCode);
+            freeAST(genericParameterListNode);
+            return initASTNode(AST_ERROR, NULL);
+        }
+
+        genericParameterNode->left = initASTNode(AST_TYPE_ANNOTATION, parser->currentToken);
+        parser->currentToken = advanceParser(parser, sourceCode);
+    }
+
+    // Check for additional type parameters separated by commas
+    if (matchTokenType(parser, TOKEN_COMMA)) {
+        parser->currentToken = advanceParser(parser, sourceCode);
+        ASTNode *restNode = parseGenericParameterList(parser, sourceCode);
+
+        if (restNode->nodeType == AST_ERROR) {
+            freeAST(genericParameterListNode);
+            return restNode;
+        }
+
+        genericParameterListNode->right = restNode;
+        return genericParameterListNode;
+    }
+
+    // Unlike brackets, angle brackets are not matched by the lexer, so the closing '>' is checked here
+    if (!matchTokenType(parser, TOKEN_GREATER_THAN_OPERATOR)) {
+        parser->parseError = PARSE_ERROR_MISSING_CLOSING_ANGLE_BRACKET;
+        parser->diagnosticToken = parser->currentToken;
+
+        reportParseError(parser);
+        escapeParseError(parser, sourceCode);
+        freeAST(genericParameterListNode);
+        return initASTNode(AST_ERROR, NULL);
+    }
+
+    // Consume the closing '>'
+    parser->currentToken = advanceParser(parser, sourceCode);
+    return genericParameterListNode;
+}
+
 ASTNode *parseCodeBlock(Parser *parser, FILE *sourceCode) {
     // Comsume the opening curly bracket
     parser->currentToken = advanceParser(parser, sourceCode);
@@ -373,6 +475,7 @@ ASTNode *parseReturnStatement(Parser *parser, FILE *sourceCode) {
 
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(root);
         return initASTNode(AST_ERROR, NULL);
     }
     
@@ -381,6 +484,41 @@ ASTNode *parseReturnStatement(Parser *parser, FILE *sourceCode) {
     return root;
 }
 
+ASTNode *parseImportDeclaration(Parser *parser, FILE *sourceCode) {
+    ASTNode *root = initASTNode(AST_IMPORT_DECLARATION, parser->currentToken);
+
+    // Consume the 'import' keyword
+    parser->currentToken = advanceParser(parser, sourceCode);
+
+    // Expect the name of the imported module
+    if (!matchTokenType(parser, TOKEN_IDENTIFIER)) {
+        parser->parseError = PARSE_ERROR_MISSING_MODULE_NAME;
+        parser->diagnosticToken = root->token;
+
+        reportParseError(parser);
+        escapeParseError(parser, sourceCode);
+        freeAST(root);
+        return initASTNode(AST_ERROR, NULL);
+    }
+
+    root->left = initASTNode(AST_IDENTIFIER, parser->currentToken);
+    parser->currentToken = advanceParser(parser, sourceCode);
+
+    // Expect a delimiter (or the end of the file) to terminate the import declaration
+    if (!matchTokenType(parser, TOKEN_DELIMITER) && !matchTokenType(parser, TOKEN_EOF)) {
+        parser->parseError = PARSE_ERROR_MISSING_DELIMITER;
+        parser->diagnosticToken = root->left->token;
+
+        reportParseError(parser);
+        escapeParseError(parser, sourceCode);
+        freeAST(root);
+        return initASTNode(AST_ERROR, NULL);
+    }
+
+    if (matchTokenType(parser, TOKEN_DELIMITER)) parser->currentToken = advanceParser(parser, sourceCode);
+    return root;
+}
+
 ASTNode *parseConditionalStatement(Parser *parser, FILE *sourceCode) {
     ASTNode *conditionalStatementNode = initASTNode(AST_CONDITIONAL_STATEMENT, parser->currentToken);
 
@@ -394,6 +532,7 @@ ASTNode *parseConditionalStatement(Parser *parser, FILE *sourceCode) {
 
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(conditionalStatementNode);
         return initASTNode(AST_ERROR, NULL);
     }
     
@@ -407,6 +546,8 @@ ASTNode *parseConditionalStatement(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(conditionalStatementNode);
+        freeAST(conditionNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -442,6 +583,7 @@ ASTNode *parseConditionalStatement(Parser *parser, FILE *sourceCode) {
                 
                 reportParseError(parser);
                 escapeParseError(parser, sourceCode);
+                freeAST(conditionalStatementNode);
                 return initASTNode(AST_ERROR, NULL);
             }
 
@@ -465,6 +607,7 @@ ASTNode *parseRepeatUntilStatement(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(repeatUntilStatementNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -482,6 +625,8 @@ ASTNode *parseRepeatUntilStatement(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(repeatUntilStatementNode);
+        freeAST(statementBodyNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -494,6 +639,8 @@ ASTNode *parseRepeatUntilStatement(Parser *parser, FILE *sourceCode) {
 
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(repeatUntilStatementNode);
+        freeAST(statementBodyNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -507,6 +654,7 @@ ASTNode *parseRepeatUntilStatement(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(repeatUntilStatementNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -527,6 +675,7 @@ ASTNode *parseForInStatement(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(forInStatementNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -540,6 +689,8 @@ ASTNode *parseForInStatement(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(forInStatementNode);
+        freeAST(identifierNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -552,6 +703,8 @@ ASTNode *parseForInStatement(Parser *parser, FILE *sourceCode) {
 
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(forInStatementNode);
+        freeAST(identifierNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -564,6 +717,9 @@ ASTNode *parseForInStatement(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(forInStatementNode);
+        freeAST(identifierNode);
+        freeAST(iterableNode);
         return initASTNode(AST_ERROR, NULL);
     }
     
@@ -578,6 +734,129 @@ ASTNode *parseForInStatement(Parser *parser, FILE *sourceCode) {
     return forInStatementNode;
 }
 
+// Skips the rest of a switch statement after an error up to its closing curly bracket, so that its cases are not
+// parsed again as statements
+static void escapeSwitchStatement(Parser *parser, FILE *sourceCode) {
+    int depth = 0;
+
+    while (!matchTokenType(parser, TOKEN_EOF)) {
+        if (matchTokenType(parser, TOKEN_OPENING_CURLY_BRACKET)) depth++;
+
+        else if (matchTokenType(parser, TOKEN_CLOSING_CURLY_BRACKET) && depth-- == 0) {
+            parser->currentToken = advanceParser(parser, sourceCode);
+            return;
+        }
+
+        parser->currentToken = advanceParser(parser, sourceCode);
+    }
+}
+
+ASTNode *parseSwitchStatement(Parser *parser, FILE *sourceCode) {
+    ASTNode *switchStatementNode = initASTNode(AST_SWITCH_STATEMENT, parser->currentToken);
+
+    // Consume the 'switch' keyword token
+    parser->currentToken = advanceParser(parser, sourceCode);
+
+    // Try to match the value to switch over
+    if (!isExpression(parser)) {
+        parser->parseError = PARSE_ERROR_MISSING_CONDITION;
+        parser->diagnosticToken = switchStatementNode->token;
+
+        reportParseError(parser);
+        escapeParseError(parser, sourceCode);
+        freeAST(switchStatementNode);
+        return initASTNode(AST_ERROR, NULL);
+    }
+
+    switchStatementNode->left = parseExpression(parser, sourceCode);
+
+    // Expect an opening curly bracket for the cases
+    if (!matchTokenType(parser, TOKEN_OPENING_CURLY_BRACKET)) {
+        parser->parseError = PARSE_ERROR_MISSING_OPENING_CURLY_BRACKET;
+        parser->diagnosticToken = parser->currentToken;
+
+        reportParseError(parser);
+        escapeParseError(parser, sourceCode);
+        freeAST(switchStatementNode);
+        return initASTNode(AST_ERROR, NULL);
+    }
+
+    // Consume the opening curly bracket
+    parser->currentToken = advanceParser(parser, sourceCode);
+    ASTNode **nextCase = &switchStatementNode->right;
+
+    while (1) {
+        // Skip delimiters, since newline characters between the cases are whitespaces
+        while (matchTokenType(parser, TOKEN_DELIMITER)) {
+            parser->currentToken = advanceParser(parser, sourceCode);
+        }
+
+        // The closing curly bracket ends the cases, which is guaranteed to match by the lexer
+        if (matchTokenType(parser, TOKEN_CLOSING_CURLY_BRACKET) || matchTokenType(parser, TOKEN_EOF)) break;
+
+        if (!matchTokenType(parser, TOKEN_KEYWORD_CASE) && !matchTokenType(parser, TOKEN_KEYWORD_DEFAULT)) {
+            parser->parseError = PARSE_ERROR_MISSING_CASE;
+            parser->diagnosticToken = parser->currentToken;
+
+            reportParseError(parser);
+            escapeSwitchStatement(parser, sourceCode);
+            freeAST(switchStatementNode);
+            return initASTNode(AST_ERROR, NULL);
+        }
+
+        ASTNode *caseNode = initASTNode(AST_SWITCH_CASE, parser->currentToken);
+        *nextCase = caseNode;
+
+        // Consume the 'case' or 'default' keyword token
+        parser->currentToken = advanceParser(parser, sourceCode);
+
+        // A case matches one value or more separated by commas, while the default case matches any other value
+        ASTNode **nextPattern = &caseNode->left;
+
+        while (caseNode->token->tokenType == TOKEN_KEYWORD_CASE) {
+            if (!isExpression(parser)) {
+                parser->parseError = PARSE_ERROR_MISSING_CASE_VALUE;
+                parser->diagnosticToken = caseNode->token;
+
+                reportParseError(parser);
+                escapeSwitchStatement(parser, sourceCode);
+                freeAST(switchStatementNode);
+                return initASTNode(AST_ERROR, NULL);
+            }
+
+            ASTNode *patternNode = initASTNode(AST_SWITCH_PATTERN, NULL);
+            patternNode->left = parseExpression(parser, sourceCode);
+            *nextPattern = patternNode;
+            nextPattern = &patternNode->right;
+
+            if (!matchTokenType(parser, TOKEN_COMMA)) break;
+
+            // Consume the comma token before the next value
+            parser->currentToken = advanceParser(parser, sourceCode);
+        }
+
+        // Expect an opening curly bracket for the body of the case
+        if (!matchTokenType(parser, TOKEN_OPENING_CURLY_BRACKET)) {
+            parser->parseError = PARSE_ERROR_MISSING_OPENING_CURLY_BRACKET;
+            parser->diagnosticToken = parser->currentToken;
+
+            reportParseError(parser);
+            escapeSwitchStatement(parser, sourceCode);
+            freeAST(switchStatementNode);
+            return initASTNode(AST_ERROR, NULL);
+        }
+
+        ASTNode *caseBodyNode = initASTNode(AST_SWITCH_BODY, NULL);
+        caseBodyNode->left = parseCodeBlock(parser, sourceCode);
+        caseNode->right = caseBodyNode;
+        nextCase = &caseBodyNode->right;
+    }
+
+    // Consume the closing curly bracket
+    parser->currentToken = advanceParser(parser, sourceCode);
+    return switchStatementNode;
+}
+
 ASTNode *parseExpression(Parser *parser, FILE *sourceCode) {
     // Entry point for expression parsing, we start at the lowest precedence level (logical equivalence)
     return parseLogicalOr(parser, sourceCode);
@@ -829,6 +1108,9 @@ ASTNode* parseArgumentList(Parser *parser, FILE *sourceCode) {
         
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(argumentListNode);
+        freeAST(argumentNode);
+        freeAST(argumentLabelNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -841,6 +1123,9 @@ ASTNode* parseArgumentList(Parser *parser, FILE *sourceCode) {
 
         reportParseError(parser);
         escapeParseError(parser, sourceCode);
+        freeAST(argumentListNode);
+        freeAST(argumentNode);
+        freeAST(argumentLabelNode);
         return initASTNode(AST_ERROR, NULL);
     }
 
@@ -866,9 +1151,33 @@ int matchTokenType(Parser *parser, TokenType type) {
 
 Token *advanceParser(Parser *parser, FILE *sourceCode) { 
     // Comsume the current token and move to the next token (and unable to move backward)
-    return getNextToken(parser->lexer, sourceCode); 
+    Token *token = getNextToken(parser->lexer, sourceCode);
+    if (!parser->tokens || !token) return token;
+
+    if (parser->tokenCount == parser->tokenCapacity) {
+        int capacity = parser->tokenCapacity * 2;
+        Token **tokens = (Token**) realloc(parser->tokens, capacity * sizeof(Token*));
+
+        if (!tokens) {
+            free(parser->tokens);
+            parser->tokens = NULL;
+            return token;
+        }
+
+        parser->tokens = tokens;
+        parser->tokenCapacity = capacity;
+    }
+
+    parser->tokens[parser->tokenCount++] = token;
+    return token;
 } 
 
+void trackParserTokens(Parser *parser) {
+    parser->tokens = (Token**) malloc(64 * sizeof(Token*));
+    parser->tokenCount = 0;
+    parser->tokenCapacity = parser->tokens ? 64 : 0;
+}
+
 void escapeParseError(Parser *parser, FILE *sourceCode) {
     while (!matchTokenType(parser, TOKEN_DELIMITER) && !matchTokenType(parser, TOKEN_EOF)) {
         parser->currentToken = advanceParser(parser, sourceCode);
@@ -895,6 +1204,10 @@ Parser *initParser() {
     parser->lexer = lexer;
     parser->currentToken = NULL;
     parser->diagnosticToken = NULL;
+    parser->tokens = NULL;
+    parser->tokenCount = 0;
+    parser->tokenCapacity = 0;
+    parser->diagnostics = NULL;
 
     return parser;
 }
@@ -955,6 +1268,8 @@ void displayAST(ASTNode* node, int level) {
         case AST_PARAMETER_LIST:            printf("AST_PARAMETER_LIST\n"); break;
         case AST_PARAMETER_LABEL:           printf("AST_PARAMETER_LABEL (%s)\n", node->token->lexeme); break;
         case AST_FUNCTION_RETURN_TYPE:      printf("AST_FUNCTION_RETURN_TYPE (%s)\n", node->token->lexeme); break;
+        case AST_GENERIC_PARAMETER_LIST:    printf("AST_GENERIC_PARAMETER_LIST\n"); break;
+        case AST_GENERIC_PARAMETER:         printf("AST_GENERIC_PARAMETER (%s)\n", node->token->lexeme); break;
         case AST_FUNCTION_IMPLEMENTATION:   printf("AST_FUNCTION_IMPLEMENTATION\n"); break;
         case AST_CODE_BLOCK:                printf("AST_CODE_BLOCK\n"); break;
         case AST_PARAMETER:                 printf("AST_PARAMETER\n"); break;
@@ -964,6 +1279,11 @@ void displayAST(ASTNode* node, int level) {
         case AST_REPEAT_UNTIL_STATEMENT:    printf("AST_REPEAT_UNTIL_STATEMENT (%s)\n", node->token->lexeme); break;
         case AST_FOR_IN_STATEMENT:          printf("AST_FOR_IN_STATEMENT (%s)\n", node->token->lexeme); break;
         case AST_FOR_IN_CONTEXT:            printf("AST_FOR_IN_CONTEXT\n"); break;
+        case AST_SWITCH_STATEMENT:          printf("AST_SWITCH_STATEMENT (%s)\n", node->token->lexeme); break;
+        case AST_SWITCH_CASE:               printf("AST_SWITCH_CASE (%s)\n", node->token->lexeme); break;
+        case AST_SWITCH_PATTERN:            printf("AST_SWITCH_PATTERN\n"); break;
+        case AST_SWITCH_BODY:               printf("AST_SWITCH_BODY\n"); break;
+        case AST_IMPORT_DECLARATION:        printf("AST_IMPORT_DECLARATION (%s)\n", node->token->lexeme); break;
         case AST_ERROR:                     printf("AST_ERROR (x)\n"); break;
         default:                            printf("UNKNOWN NODE\n"); break;
     }
@@ -973,52 +1293,66 @@ void displayAST(ASTNode* node, int level) {
 }
 
 void reportParseError(Parser *parser) {
-    Token *token = parser->diagnosticToken;
-    printf("Parsing Error at %d:%d\n", token->location.line, token->location.column);
-
     // Return if there is no error to display
     if (parser->parseError == PARSE_ERROR_NONE) return;
 
+    // A node recovered from an earlier error has no token, so the error is located at the current token instead
+    Token *token = parser->diagnosticToken ? parser->diagnosticToken : parser->currentToken;
+    const char *format;
+
+    // Each description might include the lexeme of the token where the error is located
     switch (parser->parseError) {
         case PARSE_ERROR_MISSING_IDENTIFIER:
-            printf("[ERROR] Expecting a name for the variable/constant after '%s'.\n", token->lexeme); break;
+            format = "Expecting a name for the variable/constant after '%s'"; break;
         case PARSE_ERROR_MISSING_TYPE_ANNOTATION:
-            printf("[ERROR] Expecting ':' for the type annotation after '%s'.\n", token->lexeme); break;
+            format = "Expecting ':' for the type annotation after '%s'"; break;
         case PARSE_ERROR_MISSING_TYPE_NAME:
-            printf("[ERROR] Expecting a type name after ':'.\n"); break;
+            format = "Expecting a type name after ':'"; break;
         case PARSE_ERROR_DECLARATION_SYNTAX:
-            printf("[ERROR] Expecting '=' or a newline after '%s'.\n", token->lexeme); break;
+            format = "Expecting '=' or a newline after '%s'"; break;
         case PARSE_ERROR_MISSING_RIGHT_VALUE:
-            printf("[ERROR] Expecting something to be assigned to '%s' after '='.\n", token->lexeme); break;
+            format = "Expecting something to be assigned to '%s' after '='"; break;
         case PARSE_ERROR_UNRESOLVABLE:
-            printf("[ERROR] Unresolvable token for token '%s'.\n", token->lexeme); break;
+            format = "Unresolvable token for token '%s'"; break;
         case PARSE_ERROR_MISSING_ARGUMENT_LABEL:
-            printf("[ERROR] Expecting label for argument %s in the function call.\n", token->lexeme); break;
+            format = "Expecting label for argument %s in the function call"; break;
         case PARSE_ERROR_MISSING_COLON_AFTER_LABEL:
-            printf("[ERROR] Expecting ':' after the label '%s'.\n", token->lexeme); break;
+            format = "Expecting ':' after the label '%s'"; break;
         case PARSE_ERROR_MISSING_FUNCTION_NAME:
-            printf("[ERROR] Expecting a name for the function after '%s'.\n", token->lexeme); break;
+            format = "Expecting a name for the function after '%s'"; break;
         case PARSE_ERROR_MISSING_OPENING_BRACKET:
-            printf("[ERROR] Expecting '(' for defining parameter list after '%s'.\n", token->lexeme); break;
+            format = "Expecting '(' for defining parameter list after '%s'"; break;
         case PARSE_ERROR_MISSING_RIGHT_ARROW:
-            printf("[ERROR] Expecting '->' after ')' for function return type annotation.\n"); break;
+            format = "Expecting '->' after ')' for function return type annotation"; break;
         case PARSE_ERROR_MISSING_RETURN_TYPE:
-            printf("[ERROR] Expecting a type name after '->'.\n"); break;
+            format = "Expecting a type name after '->'"; break;
         case PARSE_ERROR_MISSING_OPENING_CURLY_BRACKET:
-            printf("[ERROR] Expecting '{' to provide a body for the statement.\n"); break;
+            format = "Expecting '{' to provide a body for the statement"; break;
         case PARSE_ERROR_MISSING_UNTIL_CONDITION:
-            printf("[ERROR] Expecting 'until' to provide a termination condition.\n"); break;
+            format = "Expecting 'until' to provide a termination condition"; break;
         case PARSE_ERROR_MISSING_IN_STATEMENT:
-            printf("[ERROR] Expecting 'in' to provide an Iterable after '%s'.\n", token->lexeme); break;
+            format = "Expecting 'in' to provide an Iterable after '%s'"; break;
         case PARSE_ERROR_MISSING_DELIMITER:
-            printf("[ERROR] Expecting a newline after '%s'.\n", token->lexeme); break;
+            format = "Expecting a newline after '%s'"; break;
         case PARSE_ERROR_MISSING_CONDITION:
-            printf("[ERROR] Expecting a condition after '%s'.\n", token->lexeme); break;
+            format = "Expecting a condition after '%s'"; break;
         case PARSE_ERROR_MISSING_OPERAND:
-            printf("[ERROR] Expecting another operand.\n"); break;
+            format = "Expecting another operand"; break;
         case PARSE_ERROR_MISSING_ARGUMENT:
-            printf("[ERROR] Expecting an argument after ':'.\n"); break;
+            format = "Expecting an argument after ':'"; break;
+        case PARSE_ERROR_MISSING_MODULE_NAME:
+            format = "Expecting a module name after '%s'"; break;
+        case PARSE_ERROR_MISSING_TYPE_PARAMETER:
+            format = "Expecting a type parameter rather than '%s'"; break;
+        case PARSE_ERROR_MISSING_CLOSING_ANGLE_BRACKET:
+            format = "Expecting '>' after the type parameters"; break;
+        case PARSE_ERROR_MISSING_CASE:
+            format = "Expecting 'case' or 'default' in the switch statement rather than '%s'"; break;
+        case PARSE_ERROR_MISSING_CASE_VALUE:
+            format = "Expecting a value to match after '%s'"; break;
         default:
-            printf("[ERROR] Unable to generate diagnostic information...\n");
+            format = "Unable to generate diagnostic information";
     }
+
+    reportDiagnostic(parser->diagnostics, token->location, format, token->lexeme);
 }
@@ -0,0 +1,188 @@
+// bytecode.h
+//
+// Bytecode of the virtual machine of the Opus programming language. Once optimized and once its frames have been
+// allocated, the IR of a program is assembled into a flat array of instructions operating on the frame slots of the
+// IR (see frame.h), so a register of the IR becomes a slot of the frame of its function. The blocks of a function
+// are laid out in the order chosen by the optimizer (see cfg.h), or in reverse post-order if it has not laid them
+// out, a jump to the next block falls through, and the operations are specialized by the type of their operands
+// (e.g. VM_ADD_INT and VM_ADD_FLOAT), so the virtual machine never looks at a type. A function, a global and a
+// string are referred to by their index, and a string is an offset into the characters of the string table, so the
+// bytecode holds no pointer at all and could be mapped from a file (see image.h).
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <stdint.h>
+#include "ir.h"
+
+#define VM_INPUT_FUNCTION   "input.value"
+#define VM_NO_SLOT          -1
+
+/// A value held by a frame slot, whose member in use depends on the type of the slot.
+typedef union {
+    int32_t integer;    /// An Int, a Bool (0 or 1), or a String (its index in the string table).
+    float floating;     /// A Float.
+} VMValue;
+
+/// Operation codes of the virtual machine, where 'a' and 'b' are the operands and 'd' is the destination.
+typedef enum {
+    VM_CONSTANT,                  /// d = immediate
+    VM_COPY,                      /// d = a
+    VM_CONVERT,                   /// d = (Float) a
+    VM_CONVERT_UINT,              /// d = (Float) a, for a UInt32
+    VM_INPUT,                     /// d = the value bound to the input immediate.integer
+    VM_LOAD_GLOBAL,               /// d = the slot immediate.integer of the entry frame
+    VM_STORE_GLOBAL,              /// The slot immediate.integer of the entry frame = a
+    VM_ADD_INT,                   /// d = a + b, wrapping around
+    VM_ADD_FLOAT,                 /// d = a + b
+    VM_SUBTRACT_INT,              /// d = a - b, wrapping around
+    VM_SUBTRACT_FLOAT,            /// d = a - b
+    VM_MULTIPLY_INT,              /// d = a * b, wrapping around
+    VM_MULTIPLY_FLOAT,            /// d = a * b
+    VM_DIVIDE_INT,                /// d = a / b, failing if b is 0
+    VM_DIVIDE_FLOAT,              /// d = a / b
+    VM_DIVIDE_UINT,               /// d = a / b for a UInt32, failing if b is 0
+    VM_MODULO_INT,                /// d = a % b, failing if b is 0
+    VM_MODULO_FLOAT,              /// d = fmodf(a, b)
+    VM_MODULO_UINT,               /// d = a % b for a UInt32, failing if b is 0
+    VM_NEGATE_INT,                /// d = -a, wrapping around
+    VM_NEGATE_FLOAT,              /// d = -a
+    VM_NOT,                       /// d = !a
+    VM_FACTORIAL,                 /// d = a!, wrapping around
+    VM_ADD_INT_CHECKED,           /// d = a + b, failing on overflow
+    VM_SUBTRACT_INT_CHECKED,      /// d = a - b, failing on overflow
+    VM_MULTIPLY_INT_CHECKED,      /// d = a * b, failing on overflow
+    VM_DIVIDE_INT_CHECKED,        /// d = a / b, failing if b is 0 or on overflow
+    VM_NEGATE_INT_CHECKED,        /// d = -a, failing on overflow
+    VM_FACTORIAL_CHECKED,         /// d = a!, failing on overflow
+    VM_SHIFT_LEFT,                /// d = a << immediate.integer
+    VM_SHIFT_RIGHT,               /// d = a >> immediate.integer (arithmetic)
+    VM_SHIFT_RIGHT_LOGICAL,       /// d = (unsigned) a >> immediate.integer
+    VM_BITWISE_AND,               /// d = a & immediate.integer
+    VM_MULTIPLY_HIGH,             /// d = the high 32 bits of a * immediate.integer
+    VM_BIT_TEST,                  /// d = bit (a - b) of immediate.integer, or false if a - b is not in [0, 32)
+    VM_STRING_HASH,               /// d = the hash of the string a seeded by immediate.integer (see hashIRString())
+    VM_EQUAL_INT,                 /// d = a == b, for an Int, a Bool or a String
+    VM_EQUAL_FLOAT,               /// d = a == b
+    VM_NOT_EQUAL_INT,             /// d = a != b, for an Int, a Bool or a String
+    VM_NOT_EQUAL_FLOAT,           /// d = a != b
+    VM_LESS_THAN_INT,             /// d = a < b
+    VM_LESS_THAN_FLOAT,           /// d = a < b
+    VM_LESS_THAN_UINT,            /// d = a < b, for a UInt32
+    VM_LESS_OR_EQUAL_INT,         /// d = a <= b
+    VM_LESS_OR_EQUAL_FLOAT,       /// d = a <= b
+    VM_LESS_OR_EQUAL_UINT,        /// d = a <= b, for a UInt32
+    VM_GREATER_THAN_INT,          /// d = a > b
+    VM_GREATER_THAN_FLOAT,        /// d = a > b
+    VM_GREATER_THAN_UINT,         /// d = a > b, for a UInt32
+    VM_GREATER_OR_EQUAL_INT,      /// d = a >= b
+    VM_GREATER_OR_EQUAL_FLOAT,    /// d = a >= b
+    VM_GREATER_OR_EQUAL_UINT,     /// d = a >= b, for a UInt32
+    VM_COMPARE_STRING,            /// d = the comparison immediate.integer (as IR_EQUAL + k) of the strings a and b
+    VM_ARGUMENT,                  /// Passes a as the argument immediate.integer of the following call.
+    VM_CALL,                      /// d = call the function immediate.integer with the arguments.
+    VM_RESULT,                    /// d = the slot immediate.integer past the frame, where the last callee has left
+                                  /// a lane of the vector it returned.
+    VM_JUMP,                      /// Jumps to targets[0].
+    VM_BRANCH,                    /// Jumps to targets[0] if a is true, otherwise to targets[1].
+    VM_SWITCH,                    /// Jumps through the targets[1] jumps following it by a - immediate.integer, or to
+                                  /// targets[0] if the difference is not in [0, targets[1]).
+    VM_RETURN,                    /// Returns a (or nothing if there is no slot).
+} VMOpcode;
+
+/// An instruction of the virtual machine.
+typedef struct {
+    uint16_t opcode;            /// The operation of the instruction (see VMOpcode).
+    uint16_t argumentCount;     /// The number of arguments of a call.
+    int32_t destination;        /// The slot defined by the instruction, or VM_NO_SLOT.
+    int32_t operands[2];        /// The slots used by the instruction, or VM_NO_SLOT.
+    int32_t targets[2];         /// The instructions a jump or a branch goes to, counted from the start of the code.
+    VMValue immediate;          /// The constant, the global slot, the argument, the callee or the input.
+} VMInstruction;
+
+/// A function of the bytecode.
+typedef struct {
+    int32_t name;               /// The index of its name in the string table.
+    int32_t entry;              /// The index of its first instruction in the code.
+    int32_t parameterCount;     /// The number of parameters, which take the first slots of the frame.
+    int32_t frameSize;          /// The number of slots of its frame.
+    int32_t stackSize;          /// The slots it needs on the stack, including the arguments of the functions it calls.
+    int32_t returnType;         /// The type of the returned value (see IRType).
+} VMFunction;
+
+/// A global of the program, that is a slot of the frame of the entry function.
+typedef struct {
+    int32_t name;               /// The index of its name in the string table.
+    int32_t slot;               /// The slot of the entry frame holding it.
+    int32_t type;               /// The type of its value (see IRType).
+    int32_t isMutable;          /// Whether it is declared by 'var'.
+    int32_t input;              /// The index of the input it is bound to, or -1 if it is not an input.
+} VMGlobal;
+
+/// A program assembled into bytecode, where the function 0 is the entry function.
+typedef struct {
+    VMInstruction *code;        /// The instructions of every function.
+    int codeCount;              /// The number of instructions.
+    int codeCapacity;           /// The allocated capacity of the code.
+    Location *locations;        /// The location of each instruction in the source code, for the runtime errors.
+    VMFunction *functions;      /// The functions of the program.
+    int functionCount;          /// The number of functions.
+    VMGlobal *globals;          /// The globals of the program, in the order they are declared.
+    int globalCount;            /// The number of globals.
+    int inputCount;             /// The number of globals that are inputs.
+    char *stringData;           /// The characters of every string, each ending with '\0'.
+    int stringDataLength;       /// The number of characters.
+    int stringDataCapacity;     /// The allocated capacity of the characters.
+    int32_t *stringOffsets;     /// The offset of each string of the string table, holding the literals and the names.
+    int stringCount;            /// The number of strings.
+    int stringCapacity;         /// The allocated capacity of the string offsets.
+    void *image;                /// The image the program is mapped from, or NULL if it has been assembled.
+    size_t imageSize;           /// The size of the image in bytes.
+} VMProgram;
+
+/// Assembles an optimized program into bytecode. The frame of every function must have been allocated, and an input
+/// is a global assigned by calling VM_INPUT_FUNCTION. A call to a function that the program does not implement (e.g.
+/// a function of the runtime) is reported, since the virtual machine could not call it.
+///
+/// @param program The program to assemble.
+/// @return A pointer to the bytecode, or NULL if it could not be assembled (which is reported).
+///
+VMProgram *assembleVMProgram(IRProgram *program);
+
+/// Adds a string to the string table of a program, unless it is already there.
+///
+/// @param program The program owning the string table.
+/// @param string The string to add.
+/// @return The index of the string in the table, or -1 if memory allocation fails.
+///
+int internVMString(VMProgram *program, const char *string);
+
+/// Gets a string of the string table of a program.
+///
+/// @param program The program owning the string table.
+/// @param string The index of the string.
+/// @return The string, or an empty string if the index is out of range.
+///
+const char *getVMString(const VMProgram *program, int string);
+
+/// Gets the name of an operation code for display purposes.
+///
+/// @param opcode The operation code.
+/// @return The name of the operation.
+///
+const char *getVMOpcodeName(VMOpcode opcode);
+
+/// Displays the bytecode of every function of a program.
+/// @param program The program to display.
+///
+void displayVMProgram(const VMProgram *program);
+
+/// Frees all memory associated with a program in bytecode, or unmaps the image it is mapped from.
+/// @param program The program to free.
+///
+void freeVMProgram(VMProgram *program);
+
+#endif
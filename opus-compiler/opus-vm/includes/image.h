@@ -0,0 +1,92 @@
+// image.h
+//
+// Images of programs in bytecode, which are written once and mapped into memory by later launches. An image starts
+// with a header locating each section (the code, the locations, the functions, the globals and the string table)
+// by its offset from the start of the image, and the sections hold the arrays of a VMProgram as they are in memory,
+// so a mapped program points into the image and nothing is read or converted item by item. An image might also hold
+// a snapshot, that is the entry frame once the top-level statements have run, so a later launch restores every
+// global at once rather than running the top-level statements again. An image without a snapshot is a module of
+// bytecode (written by 'Opus --emit-bytecode' as a '.opusc' file), whose sections are only ever read in place.
+//
+// An image is written in the byte order of the machine writing it, and it is only mapped by a machine of the same
+// byte order and by a virtual machine of the same version. An image is checked once when it is mapped, so that the
+// virtual machine runs it without any further check: every section lies within the image, and every instruction
+// only refers to the slots of the frame of its function, to the instructions of its function, and to the functions,
+// globals, inputs and strings of the program.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stddef.h>
+#include "bytecode.h"
+
+#define VM_IMAGE_MAGIC        "OPUSIMG"
+#define VM_IMAGE_VERSION      5
+#define VM_IMAGE_BYTE_ORDER   0x01020304u
+#define VM_IMAGE_ALIGNMENT    8
+
+/// Sections of an image.
+typedef enum {
+    VM_SECTION_CODE,              /// The instructions of every function.
+    VM_SECTION_LOCATIONS,         /// The location of each instruction.
+    VM_SECTION_FUNCTIONS,         /// The functions.
+    VM_SECTION_GLOBALS,           /// The globals.
+    VM_SECTION_STRING_OFFSETS,    /// The offset of each string of the string table.
+    VM_SECTION_STRING_DATA,       /// The characters of every string.
+    VM_SECTION_SNAPSHOT,          /// The slots of the entry frame once the top-level statements have run, if any.
+    VM_SECTION_COUNT,
+} VMImageSectionKind;
+
+/// A section of an image.
+typedef struct {
+    uint32_t offset;    /// The offset of the section from the start of the image.
+    uint32_t count;     /// The number of items (or characters) of the section.
+} VMImageSection;
+
+/// The header at the start of an image.
+typedef struct {
+    char magic[8];                                /// VM_IMAGE_MAGIC.
+    uint32_t version;                             /// VM_IMAGE_VERSION.
+    uint32_t byteOrder;                           /// VM_IMAGE_BYTE_ORDER, as written by the machine.
+    uint64_t size;                                /// The size of the whole image in bytes.
+    uint32_t inputCount;                          /// The number of inputs of the program.
+    uint32_t reserved;                            /// Always 0.
+    VMImageSection sections[VM_SECTION_COUNT];    /// The sections of the image.
+} VMImageHeader;
+
+/// Writes a program in bytecode as an image.
+///
+/// @param program The program to write.
+/// @param snapshot The slots of the entry frame to restore, or NULL if the top-level statements run at each launch.
+/// @param snapshotSlots The number of slots of the snapshot (the frame size of the entry function).
+/// @param path The path of the image.
+/// @return The number of bytes written, or 0 if the image could not be written (which is reported).
+///
+size_t writeVMImage(const VMProgram *program, const VMValue *snapshot, int snapshotSlots, const char *path);
+
+/// Checks if a file starts like an image, whatever its version.
+///
+/// @param path The path of the file.
+/// @return 1 (True) if the file is an image, 0 (False) otherwise.
+///
+int isVMImage(const char *path);
+
+/// Maps an image into memory, where the program points into the image until it is freed by freeVMProgram().
+///
+/// @param path The path of the image.
+/// @param snapshot Receives the snapshot of the image, or NULL if it has none.
+/// @return A pointer to the mapped program, or NULL if the image could not be mapped (which is reported).
+///
+VMProgram *mapVMImage(const char *path, const VMValue **snapshot);
+
+/// Unmaps an image from memory.
+///
+/// @param image The start of the image.
+/// @param size The size of the image in bytes.
+///
+void unmapVMImage(void *image, size_t size);
+
+#endif
@@ -0,0 +1,156 @@
+// prepared.h
+//
+// Prepared programs of the Opus programming language, which are compiled once and executed any number of times with
+// different inputs. An input is a top-level constant declared without a value (e.g. "let price: Float"), that is
+// never assigned by the program, and whose type is Int, Float or Bool. Preparing a program runs the whole pipeline
+// once (parsing, analysis, lowering, optimizations and frame allocation) and assembles the result into bytecode (see
+// bytecode.h), where reading an input is an instruction of its own. An execution binds the inputs by index or by
+// name, runs the bytecode on the virtual machine (see vm.h) and reads the globals of the program as its results.
+//
+// Once executed, a prepared program could be written as an image together with a snapshot of its globals (see
+// image.h), so a later launch maps the image and restores the globals rather than running the top-level statements
+// again, which is worth it for a program computing large constants at the top level.
+//
+// A prepared program is only read once it has been prepared, so it could be executed by any number of threads at
+// once, each with an execution of its own. An execution allocates its memory once, so binding the inputs, running
+// the program and reading its results allocate no memory at all.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef PREPARED_H
+#define PREPARED_H
+
+#include "vm.h"
+#include "cfg.h"
+
+/// A program compiled once, which is only read by its executions.
+typedef struct {
+    VMProgram *bytecode;        /// The program assembled into bytecode.
+    int *inputGlobals;          /// The global bound to each input.
+    const VMValue *snapshot;    /// The entry frame restored by every execution, or NULL if the program runs.
+} PreparedProgram;
+
+/// An execution of a prepared program, which belongs to a single thread at a time.
+typedef struct {
+    const PreparedProgram *program;   /// The program being executed.
+    VMContext context;                /// The state of the virtual machine, holding the globals once executed.
+    VMValue *inputs;                  /// The value bound to each input.
+    unsigned char *isBound;           /// Whether a value has been bound to each input.
+    int boundCount;                   /// The number of inputs that have been bound.
+} PreparedExecution;
+
+/// Compiles an Opus program once for any number of executions. Any error is reported into the list of diagnostics,
+/// including a program importing a module, or calling a function that the program does not implement.
+///
+/// @param sourcePath The path of the source code of the program.
+/// @param level The optimization level of the pass pipeline (see pass.h).
+/// @param isOverflowChecked Whether Int arithmetic fails on overflow at runtime instead of wrapping around.
+/// @param branchProfile The branch counts of a previous run laying out the blocks (see cfg.h), or NULL.
+/// @param diagnostics The list receiving the errors, sorted and located once compiled (see diagnostic.h), or NULL to
+///                    print them.
+/// @return A pointer to the prepared program, or NULL if it could not be compiled.
+///
+PreparedProgram *prepareOpusProgram(const char *sourcePath, int level, int isOverflowChecked,
+                                    const BranchProfile *branchProfile, DiagnosticList *diagnostics);
+
+/// Writes a prepared program as an image, together with a snapshot of the globals left by an execution, whose inputs
+/// are therefore fixed by the snapshot.
+///
+/// @param execution The execution, which must have been executed.
+/// @param path The path of the image.
+/// @return The number of bytes written, or 0 if the image could not be written (which is reported).
+///
+size_t snapshotPreparedProgram(const PreparedExecution *execution, const char *path);
+
+/// Restores a prepared program by mapping an image into memory, where an execution of a program with a snapshot
+/// only restores the globals of the snapshot, and needs no input.
+///
+/// @param path The path of the image.
+/// @return A pointer to the prepared program, or NULL if the image could not be mapped (which is reported).
+///
+PreparedProgram *restorePreparedProgram(const char *path);
+
+/// Finds an input of a prepared program by its name.
+///
+/// @param program The prepared program.
+/// @param name The name of the input.
+/// @return The index of the input, or -1 if the program has no such input.
+///
+int findPreparedInput(const PreparedProgram *program, const char *name);
+
+/// Finds a global of a prepared program by its name, where the last global declared with the name is found.
+///
+/// @param program The prepared program.
+/// @param name The name of the global.
+/// @return The index of the global, or -1 if the program has no such global.
+///
+int findPreparedGlobal(const PreparedProgram *program, const char *name);
+
+/// Initializes an execution of a prepared program, where no input has been bound yet.
+///
+/// @param program The prepared program, which must outlive the execution.
+/// @return A pointer to the execution, or NULL if memory allocation fails.
+///
+PreparedExecution *initPreparedExecution(const PreparedProgram *program);
+
+/// Binds a value to an input, which stays bound for the following executions until another value is bound. The
+/// member of the value in use is given by the type of the input, where a Bool is 1 (True) or 0 (False).
+///
+/// @param execution The execution.
+/// @param input The index of the input.
+/// @param value The value to bind.
+/// @return 1 (True) if the value has been bound, 0 (False) if there is no such input.
+///
+int bindPreparedInput(PreparedExecution *execution, int input, VMValue value);
+
+/// Binds a value to an input given by its name (see bindPreparedInput()).
+///
+/// @param execution The execution.
+/// @param name The name of the input.
+/// @param value The value to bind.
+/// @return 1 (True) if the value has been bound, 0 (False) if there is no such input.
+///
+int bindPreparedInputByName(PreparedExecution *execution, const char *name, VMValue value);
+
+/// Executes a prepared program with the values bound to its inputs, or restores the globals of its snapshot (if it
+/// has been restored from an image with a snapshot). A runtime error is recorded into the context of
+/// the execution (see vm.h), where the error is also recorded if an input has not been bound.
+///
+/// @param execution The execution, whose inputs must all have been bound.
+/// @return 1 (True) if the program has been executed, 0 (False) if there is an error.
+///
+int executePreparedProgram(PreparedExecution *execution);
+
+/// Reads the value of a global once the program has been executed, whose member in use is given by its type.
+///
+/// @param execution The execution.
+/// @param global The index of the global.
+/// @return The value of the global.
+///
+VMValue readPreparedGlobal(const PreparedExecution *execution, int global);
+
+/// Reads the value of a String global once the program has been executed.
+///
+/// @param execution The execution.
+/// @param global The index of the global, whose type must be String.
+/// @return The string, which lives as long as the prepared program.
+///
+const char *readPreparedString(const PreparedExecution *execution, int global);
+
+/// Displays the value of every global once the program has been executed, where an input is marked as such.
+/// @param execution The execution.
+///
+void displayPreparedGlobals(const PreparedExecution *execution);
+
+/// Frees an execution, but not the program it executes.
+/// @param execution The execution to free.
+///
+void freePreparedExecution(PreparedExecution *execution);
+
+/// Frees a prepared program, which must no longer be executed.
+/// @param program The program to free.
+///
+void freePreparedProgram(PreparedProgram *program);
+
+#endif
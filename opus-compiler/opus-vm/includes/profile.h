@@ -0,0 +1,162 @@
+// profile.h
+//
+// Frame profiles of the programs run by the virtual machine of the Opus programming language. An Opus program
+// allocates no memory of its own: the only memory a run takes is the frame of each call on the stack of the virtual
+// machine (see vm.h), so a frame profile records the frames by the Opus call site allocating them. Recording every
+// call would double its cost, so a profile samples a call once the frames allocated since the last sample exceed a
+// random number of bytes (whose mean is the sampling interval), and the sample is scaled by the probability of
+// sampling a frame of its size. A sample records the calls being executed (by the instruction of each call), the
+// number of frames and bytes it stands for, and the time its frame lives until its call returns.
+//
+// A profile is written in the format of pprof (a profile.proto message), holding the frames allocated by each stack
+// of calls and their bytes ('alloc_frames' and 'alloc_frame_bytes') and those still alive when it is written
+// ('inuse_frames' and 'inuse_frame_bytes'), so 'pprof -top', '-sample_index=inuse_frames' and the like read it. The
+// values count frames on the stack of the virtual machine, not allocations on the heap. A profile could also be
+// written while the program runs by sending SIGUSR1 to the process, which is written at the next sample, as a
+// snapshot of the frames alive at that time.
+//
+// A context counting its branches (see vm.h) is summarized into the jumps and branches it has taken, that is those
+// that have not gone on to the next instruction, and its counts are turned into a branch profile (see cfg.h), which
+// lays out the blocks of the program the next time it is compiled.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <signal.h>
+#include "vm.h"
+#include "cfg.h"
+
+#define VM_PROFILE_SAMPLE_BYTES   65536
+#define VM_PROFILE_MAX_DEPTH      64
+#define VM_PROFILE_TOP_SITES      8
+
+/// An instruction of a stack of calls, together with the function holding it.
+typedef struct {
+    int32_t instruction;    /// The entry of the callee, or the instruction of a call.
+    int32_t function;       /// The function holding the instruction.
+} VMFrameLocation;
+
+/// The frames allocated by a stack of calls, as estimated from its samples.
+typedef struct {
+    int32_t stack;              /// The first location of the stack, from the callee to the outermost call.
+    int32_t depth;              /// The number of locations of the stack, or 0 if the slot holds no site.
+    unsigned hash;              /// The hash of the instructions of the stack.
+    long sampleCount;           /// The number of samples of the stack.
+    long allocatedCount;        /// The number of frames allocated.
+    long allocatedBytes;        /// The number of bytes allocated.
+    long liveCount;             /// The number of frames still alive.
+    long liveBytes;             /// The number of bytes still alive.
+    long releasedCount;         /// The number of sampled frames that have been released.
+    double lifetimeSeconds;     /// The time lived by the sampled frames that have been released.
+} VMFrameSite;
+
+/// A sampled frame, which is alive until its call returns.
+typedef struct {
+    int32_t depth;        /// The index of the frame among the call frames.
+    int32_t site;         /// The site of the sample.
+    long count;           /// The number of frames it stands for.
+    long bytes;           /// The number of bytes it stands for.
+    double start;         /// When the frame has been allocated.
+} VMFrameSample;
+
+/// A frame profile of the runs of a context, which belongs to the thread running it.
+struct VMFrameProfile {
+    const VMProgram *program;         /// The program being profiled.
+    const char *sourcePath;           /// The path of its source code, written as the file of each function.
+    long sampleBytes;                 /// The mean number of bytes allocated between two samples.
+    long countdown;                   /// The number of bytes left to allocate before the next sample.
+    uint64_t random;                  /// The state of the generator drawing the number of bytes between samples.
+    VMFrameSite *sites;               /// The stacks of calls that have been sampled, hashed by their instructions.
+    VMFrameLocation *locations;       /// The locations of every stack, one stack after another.
+    int locationCount;                /// The number of locations.
+    int locationCapacity;             /// The allocated capacity of the locations.
+    int siteCount;                    /// The number of sites.
+    int siteCapacity;                 /// The allocated capacity of the sites, which is a power of 2.
+    VMFrameSample *samples;           /// The sampled frames still alive, from the outermost to the innermost.
+    int sampleCount;                  /// The number of sampled frames still alive.
+    int sampleCapacity;               /// The allocated capacity of the sampled frames.
+    const char *dumpPath;             /// The path of the profiles written on SIGUSR1, or NULL.
+    int dumpCount;                    /// The number of profiles written on SIGUSR1.
+    volatile sig_atomic_t isDumpRequested;   /// Whether SIGUSR1 has been received since the last profile.
+};
+
+/// The jumps and branches executed by the runs of a context counting its branches.
+typedef struct {
+    long jumpCount;             /// The number of jumps executed, which are always taken.
+    long branchCount;           /// The number of branches executed.
+    long takenCount;            /// The number of jumps and branches that have not gone on to the next instruction.
+} VMBranchSummary;
+
+/// Initializes a frame profile, which is attached to a context by its field 'frameProfile'.
+///
+/// @param program The program being profiled, which must outlive the profile.
+/// @param sourcePath The path of its source code, or NULL.
+/// @param sampleBytes The mean number of bytes allocated between two samples (e.g. VM_PROFILE_SAMPLE_BYTES).
+/// @return A pointer to the profile, or NULL if memory allocation fails.
+///
+VMFrameProfile *initVMFrameProfile(const VMProgram *program, const char *sourcePath, long sampleBytes);
+
+/// Samples the frame of a call once the countdown of the profile has run out, which is called by the virtual
+/// machine, and writes the profile if SIGUSR1 has been received.
+///
+/// @param profile The profile.
+/// @param context The context running the program.
+/// @param frame The frame of the call, which is the innermost frame of the context.
+///
+void sampleVMFrameCall(VMFrameProfile *profile, const VMContext *context, const VMFrame *frame);
+
+/// Releases the sampled frames from a depth on, once their calls have returned or the run has stopped.
+///
+/// @param profile The profile.
+/// @param depth The index of the outermost frame to release among the call frames.
+///
+void releaseVMSampledFrames(VMFrameProfile *profile, int depth);
+
+/// Writes the profile of this process on SIGUSR1, each time into the path followed by the number of the profile
+/// (e.g. 'frames.pb.1'). A single profile of the process is written on SIGUSR1.
+///
+/// @param profile The profile to write.
+/// @param path The path of the profiles.
+///
+void requestVMFrameDumps(VMFrameProfile *profile, const char *path);
+
+/// Writes a frame profile in the format of pprof.
+///
+/// @param profile The profile.
+/// @param path The path of the profile.
+/// @return The number of bytes written, or 0 if the profile could not be written (which is reported).
+///
+size_t writeVMFrameProfile(const VMFrameProfile *profile, const char *path);
+
+/// Displays the call sites allocating the most bytes and the most frames, together with the time their frames live.
+/// @param profile The profile.
+///
+void displayVMFrameProfile(const VMFrameProfile *profile);
+
+/// Sums the jumps and branches counted by a context, where a branch is taken if it does not go on to the next
+/// instruction.
+///
+/// @param program The program that has been run.
+/// @param branchCounts The counts of the context, two for each instruction of the program.
+/// @param summary Receives the number of jumps, branches and taken ones.
+///
+void summarizeVMBranches(const VMProgram *program, const long *branchCounts, VMBranchSummary *summary);
+
+/// Adds the counts of each branch of a program to a branch profile, by the function and the location of the branch.
+///
+/// @param program The program that has been run.
+/// @param branchCounts The counts of the context, two for each instruction of the program.
+/// @param profile The branch profile.
+/// @return 1 (True) on success, 0 (False) if memory allocation fails.
+///
+int addVMBranchProfile(const VMProgram *program, const long *branchCounts, BranchProfile *profile);
+
+/// Frees a frame profile, which must no longer be attached to a context.
+/// @param profile The profile to free.
+///
+void freeVMFrameProfile(VMFrameProfile *profile);
+
+#endif
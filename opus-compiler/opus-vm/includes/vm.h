@@ -0,0 +1,88 @@
+// vm.h
+//
+// Virtual machine of the Opus programming language, which interprets a program assembled into bytecode (see
+// bytecode.h). The frames are laid out on a single stack of slots: the entry frame is at the bottom (so a global is
+// a fixed slot of the stack), and a callee's frame starts right after its caller's, where the arguments have
+// already been written, so a call copies nothing. The stack and the call frames are allocated once by each context,
+// so running a program allocates no memory, and any number of contexts could run the same program at once, since the
+// bytecode is only read.
+//
+// The stack and the call frames are reserved as address space and only backed by memory once they are reached, so a
+// deep recursion grows them without moving any frame. Each of them is followed by guard pages, so a call checks no
+// bound: it only reads the slot right after the frame of its callee, and running into a guard page is turned into a
+// stack overflow by a signal handler (without guard pages, on Windows, every call checks the bounds instead).
+//
+// A context could be profiled by attaching a frame profile (see profile.h), which samples the frames of its calls, or
+// by attaching two counters per instruction, which count how often each jump and branch goes to each of its targets.
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#ifndef VM_H
+#define VM_H
+
+#ifndef _WIN32
+#include <setjmp.h>
+#endif
+#include "bytecode.h"
+
+#define VM_DEFAULT_STACK_SLOTS   (1 << 24)
+#define VM_MAX_CALL_DEPTH        (1 << 20)
+
+typedef struct VMFrameProfile VMFrameProfile;
+
+/// A call being executed, which is resumed once its callee returns.
+typedef struct {
+    int32_t function;           /// The function being executed.
+    int32_t base;               /// The first slot of its frame on the stack.
+    int32_t returnAddress;      /// The instruction of the caller to resume, or -1 for the entry function.
+    int32_t destination;        /// The slot of the caller receiving the returned value, or VM_NO_SLOT.
+} VMFrame;
+
+/// The state of running a program, which belongs to a single thread at a time.
+typedef struct {
+    const VMProgram *program;         /// The program being run.
+    VMValue *stack;                   /// The slots of every frame, where the entry frame is at the bottom.
+    int stackCapacity;                /// The number of slots of the stack.
+    VMFrame *frames;                  /// The calls being executed, where the entry function is at the bottom.
+    int frameCapacity;                /// The number of calls that could be nested.
+    VMFrame *volatile activeFrame;    /// The call being executed, which is kept for a stack overflow.
+    long callCount;                   /// The number of calls of every run so far.
+    VMFrameProfile *frameProfile;     /// The profile sampling the frames of the calls, or NULL.
+    long *branchCounts;               /// The times each jump and branch has gone to its two targets, or NULL.
+    const char *errorMessage;         /// The reason why the last run failed, or NULL if it succeeded.
+    Location errorLocation;           /// The location of the instruction that failed.
+#ifndef _WIN32
+    char *stackGuard;                 /// The guard pages right after the stack.
+    size_t stackGuardSize;            /// The size of the guard pages of the stack in bytes.
+    char *frameGuard;                 /// The guard page right after the call frames.
+    size_t frameGuardSize;            /// The size of the guard page of the call frames in bytes.
+    sigjmp_buf recovery;              /// Where a run resumes once it has run into a guard page.
+#endif
+} VMContext;
+
+/// Initializes a context running a program, whose stack is reserved once for every run.
+///
+/// @param context The context to initialize.
+/// @param program The program to run, which must outlive the context.
+/// @param stackSlots The number of slots of the stack (e.g. VM_DEFAULT_STACK_SLOTS).
+/// @return 1 (True) if the context has been initialized, 0 (False) if memory could not be reserved.
+///
+int initVMContext(VMContext *context, const VMProgram *program, int stackSlots);
+
+/// Runs the entry function of a program, which leaves the globals in the slots of the entry frame at the bottom of
+/// the stack. A runtime error (e.g. a division by zero, or a stack overflow) stops the run and is recorded into the
+/// context together with the location of the failing instruction.
+///
+/// @param context The context running the program.
+/// @param inputs The value of each input of the program, read by VM_INPUT.
+/// @return 1 (True) if the program has run to the end, 0 (False) if there is a runtime error.
+///
+int runVMProgram(VMContext *context, const VMValue *inputs);
+
+/// Frees the stack and the frames of a context, but not the program it runs.
+/// @param context The context to free.
+///
+void freeVMContext(VMContext *context);
+
+#endif
@@ -0,0 +1,376 @@
+// main.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#include "prepared.h"
+#include "image.h"
+#include "profile.h"
+#include "metrics.h"
+#include "exporter.h"
+#include "pass.h"
+#include "integer.h"
+
+#define RUN_MAX_THREADS   64
+
+/// The executions run by a thread, each binding the inputs again like a new request would.
+typedef struct {
+    const PreparedProgram *program;   /// The program shared by every thread.
+    const VMValue *inputs;            /// The value of each input.
+    long repeatCount;                 /// The number of executions.
+    long callCount;                   /// The number of calls made by every execution.
+    VMFrameProfile *frameProfile;     /// The profile of the frames of every execution, or NULL.
+    long *branchCounts;               /// The counts of the jumps and branches of every execution, or NULL.
+    int result;                       /// Whether every execution has succeeded.
+} RunJob;
+
+// Gets the wall-clock time in seconds, since the executions of several threads overlap
+static double getRunSeconds(void) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double) now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Reads the value of an input given as '<name>=<value>' according to the type of the input
+static int parseRunInput(const PreparedProgram *program, const char *argument, VMValue *inputs,
+                         unsigned char *isGiven) {
+    const char *equal = strchr(argument, '=');
+    char name[LEXEME_LENGTH];
+    if (!equal || equal == argument || (size_t) (equal - argument) >= sizeof(name)) return 0;
+
+    memcpy(name, argument, equal - argument);
+    name[equal - argument] = '\0';
+
+    int input = findPreparedInput(program, name);
+    if (input < 0) {
+        fprintf(stderr, "[RunError]: The program has no input named '%s'.\n", name);
+        return 0;
+    }
+
+    const char *text = equal + 1;
+    char *end = NULL;
+    IRType type = program->bytecode->globals[program->inputGlobals[input]].type;
+
+    if (type == IR_TYPE_FLOAT) inputs[input].floating = strtof(text, &end);
+    else if (getIRIntegerWidth(type)) {
+        long long value = strtoll(text, &end, 10);
+        if (!isIRIntegerInRange(type, value)) end = NULL;
+        else inputs[input].integer = (int32_t) (uint32_t) value;
+    }
+    else if (strcmp(text, "true") == 0 || strcmp(text, "false") == 0) {
+        inputs[input].integer = text[0] == 't';
+        end = (char*) text + strlen(text);
+    }
+
+    if (!end || end == text || *end != '\0') {
+        fprintf(stderr, "[RunError]: Input '%s' expects a value of type %s.\n", name, getIRTypeName(type));
+        return 0;
+    }
+
+    isGiven[input] = 1;
+    return 1;
+}
+
+// Executes the program repeatedly with its own execution, which is allocated once
+static void *runExecutions(void *argument) {
+    RunJob *job = (RunJob*) argument;
+    PreparedExecution *execution = initPreparedExecution(job->program);
+    job->result = execution != NULL;
+    if (execution) execution->context.frameProfile = job->frameProfile;
+    if (execution) execution->context.branchCounts = job->branchCounts;
+
+    for (long repeat = 0; repeat < job->repeatCount && job->result; repeat++) {
+        for (int input = 0; input < job->program->bytecode->inputCount; input++) {
+            bindPreparedInput(execution, input, job->inputs[input]);
+        }
+
+        job->result = executePreparedProgram(execution);
+    }
+
+    if (execution) {
+        job->callCount = execution->context.callCount;
+        execution->context.frameProfile = NULL;
+        execution->context.branchCounts = NULL;
+    }
+
+    if (execution && !job->result) {
+        Location location = execution->context.errorLocation;
+        fprintf(stderr, "[RuntimeError]: %s at location %d:%d.\n", execution->context.errorMessage, location.line,
+                location.column);
+    }
+
+    freePreparedExecution(execution);
+    return NULL;
+}
+
+// Executes the program once to time the startup of the program, then writes its snapshot (if requested)
+static int startRunProgram(const PreparedProgram *program, const VMValue *inputs, double loadSeconds,
+                           const char *snapshotPath) {
+    PreparedExecution *execution = initPreparedExecution(program);
+    if (!execution) return 0;
+
+    double start = getRunSeconds();
+    for (int input = 0; input < program->bytecode->inputCount; input++) {
+        bindPreparedInput(execution, input, inputs[input]);
+    }
+
+    int result = executePreparedProgram(execution);
+    double executeSeconds = getRunSeconds() - start;
+
+    if (!result) {
+        Location location = execution->context.errorLocation;
+        fprintf(stderr, "[RuntimeError]: %s at location %d:%d.\n", execution->context.errorMessage, location.line,
+                location.column);
+    } else printf("[Prepared] Started in %.2f ms, of which the first execution took %.2f ms.\n",
+                  1000.0 * (loadSeconds + executeSeconds), 1000.0 * executeSeconds);
+
+    // The globals are those left by the first execution, with the inputs it has been given
+    if (result && snapshotPath) {
+        size_t size = snapshotPreparedProgram(execution, snapshotPath);
+        if (size > 0) printf("[Snapshot] Wrote %zu bytes into '%s'.\n", size, snapshotPath);
+        result = size > 0;
+    }
+
+    freePreparedExecution(execution);
+    return result;
+}
+
+// Displays the value of every global once the program has been executed
+static void displayRunResults(const PreparedProgram *program, const VMValue *inputs) {
+    PreparedExecution *execution = initPreparedExecution(program);
+    if (!execution) return;
+
+    for (int input = 0; input < program->bytecode->inputCount; input++) {
+        bindPreparedInput(execution, input, inputs[input]);
+    }
+
+    if (executePreparedProgram(execution)) displayPreparedGlobals(execution);
+    freePreparedExecution(execution);
+}
+
+int main(int argc, char *argv[]) {
+    const char *sourcePath = NULL;
+    int level = PASS_DEFAULT_LEVEL;
+    long repeatCount = 1;
+    int threadCount = 1;
+    int isDisplayed = 0;
+    int isOverflowChecked = 0;
+    const char *snapshotPath = NULL;
+    const char *frameProfilePath = NULL;
+    long frameSampleBytes = VM_PROFILE_SAMPLE_BYTES;
+    const char *metricsSocketPath = NULL;
+    int isMetricsDisplayed = 0;
+    const char *branchProfilePath = NULL;
+    int isBranchCounted = 0;
+    int firstInput = argc;
+
+    // Options come before the file to run, and the inputs come after it
+    for (int index = 1; index < argc && !sourcePath; index++) {
+        const char *argument = argv[index];
+
+        if (argument[0] == '-' && argument[1] == 'O' && argument[2] >= '0' && argument[2] <= '0' + PASS_MAX_LEVEL &&
+            argument[3] == '\0') level = argument[2] - '0';
+        else if (strncmp(argument, "--repeat=", 9) == 0 && atol(argument + 9) > 0) repeatCount = atol(argument + 9);
+        else if (strncmp(argument, "--threads=", 10) == 0 && atoi(argument + 10) > 0) threadCount = atoi(argument + 10);
+        else if (strcmp(argument, "--bytecode") == 0) isDisplayed = 1;
+        else if (strcmp(argument, "--checked") == 0) isOverflowChecked = 1;
+        else if (strncmp(argument, "--snapshot=", 11) == 0 && argument[11] != '\0') snapshotPath = argument + 11;
+        else if (strncmp(argument, "--frame-profile=", 16) == 0 && argument[16] != '\0') {
+            frameProfilePath = argument + 16;
+        }
+        else if (strncmp(argument, "--frame-sample=", 15) == 0 && atol(argument + 15) > 0) {
+            frameSampleBytes = atol(argument + 15);
+        }
+        else if (strncmp(argument, "--metrics-socket=", 17) == 0 && argument[17] != '\0') {
+            metricsSocketPath = argument + 17;
+        }
+        else if (strcmp(argument, "--metrics") == 0) isMetricsDisplayed = 1;
+        else if (strcmp(argument, "--branches") == 0) isBranchCounted = 1;
+        else if (strncmp(argument, "--branch-profile=", 17) == 0 && argument[17] != '\0') {
+            branchProfilePath = argument + 17;
+        }
+        else if (argument[0] != '-') {
+            sourcePath = argument;
+            firstInput = index + 1;
+        }
+        else break;
+    }
+
+    if (!sourcePath || threadCount > RUN_MAX_THREADS) {
+        fprintf(stderr, "Usage: %s [-O0|-O1|-O2|-O3] [--repeat=<count>] [--threads=<count>] [--bytecode] "
+                        "[--checked] [--snapshot=<image>] [--frame-profile=<path>] [--frame-sample=<bytes>] "
+                        "[--metrics] [--metrics-socket=<path>] [--branches] [--branch-profile=<path>] "
+                        "<source_file.opus|image> [<input>=<value> ...]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The metrics are served while the program is compiled and executed, and stop being served once it exits
+    MetricsExporter *exporter = metricsSocketPath ? startMetricsExporter(metricsSocketPath) : NULL;
+    if (metricsSocketPath && !exporter) return EXIT_FAILURE;
+
+    // The program is compiled once, which is the cost that every execution saves, unless an image is restored
+    double start = getRunSeconds();
+    int isRestored = isVMImage(sourcePath);
+    DiagnosticList *diagnostics = initDiagnosticList();
+
+    // The branches counted by a previous run lay out the blocks, which are fixed in an image
+    BranchProfile *branchProfile = branchProfilePath && !isRestored ? readBranchProfile(branchProfilePath) : NULL;
+    if (branchProfile) printf("[BranchProfile] Read %d branches from '%s'.\n", branchProfile->branchCount,
+                              branchProfilePath);
+
+    PreparedProgram *program = isRestored ? restorePreparedProgram(sourcePath)
+                                          : prepareOpusProgram(sourcePath, level, isOverflowChecked, branchProfile,
+                                                               diagnostics);
+    double prepareSeconds = getRunSeconds() - start;
+
+    displayDiagnostics(diagnostics);
+    freeDiagnosticList(diagnostics);
+    freeBranchProfile(branchProfile);
+
+    if (!program) {
+        stopMetricsExporter(exporter);
+        return EXIT_FAILURE;
+    }
+
+    VMProgram *bytecode = program->bytecode;
+    VMValue *inputs = (VMValue*) calloc(bytecode->inputCount + 1, sizeof(VMValue));
+    unsigned char *isGiven = (unsigned char*) calloc(bytecode->inputCount + 1, 1);
+    int result = inputs && isGiven;
+
+    // The inputs of a snapshot have been fixed when it has been written
+    if (program->snapshot && firstInput < argc) {
+        fprintf(stderr, "[RunError]: The inputs of '%s' are fixed by its snapshot.\n", sourcePath);
+        result = 0;
+    }
+
+    for (int index = firstInput; index < argc && result; index++) {
+        result = parseRunInput(program, argv[index], inputs, isGiven);
+    }
+
+    for (int input = 0; input < bytecode->inputCount && result && !program->snapshot; input++) {
+        if (isGiven[input]) continue;
+
+        fprintf(stderr, "[RunError]: Input '%s' has not been given a value.\n",
+                getVMString(bytecode, bytecode->globals[program->inputGlobals[input]].name));
+        result = 0;
+    }
+
+    if (result) {
+        printf("[Prepared] %s '%s' in %.2f ms: %d instructions, %d functions, %d inputs.\n",
+               isRestored ? "Restored" : "Compiled", sourcePath, 1000.0 * prepareSeconds, bytecode->codeCount,
+               bytecode->functionCount, bytecode->inputCount);
+        if (isDisplayed) displayVMProgram(bytecode);
+        result = startRunProgram(program, inputs, prepareSeconds, snapshotPath);
+    }
+
+    // Every thread executes the same prepared program, each with an execution of its own, where the threads run the
+    // same executions, so only those of the first thread are profiled
+    RunJob jobs[RUN_MAX_THREADS];
+    VMFrameProfile *frameProfile = result && frameProfilePath ?
+                                   initVMFrameProfile(bytecode, sourcePath, frameSampleBytes) : NULL;
+    if (frameProfile) requestVMFrameDumps(frameProfile, frameProfilePath);
+
+    long *branchCounts = result && (isBranchCounted || branchProfilePath) ?
+                         (long*) calloc(2 * (size_t) bytecode->codeCount + 2, sizeof(long)) : NULL;
+
+    for (int thread = 0; thread < threadCount; thread++) {
+        jobs[thread] = (RunJob) {program, inputs, repeatCount, 0, thread == 0 ? frameProfile : NULL,
+                                 thread == 0 ? branchCounts : NULL, 1};
+    }
+
+    start = getRunSeconds();
+
+    if (result) {
+#ifndef _WIN32
+        pthread_t threads[RUN_MAX_THREADS];
+        int startedCount = 0;
+
+        for (int thread = 1; thread < threadCount; thread++, startedCount++) {
+            if (pthread_create(&threads[thread], NULL, runExecutions, &jobs[thread]) != 0) break;
+        }
+
+        runExecutions(&jobs[0]);
+        for (int thread = 1; thread <= startedCount; thread++) pthread_join(threads[thread], NULL);
+        threadCount = startedCount + 1;
+#else
+        threadCount = 1;
+        runExecutions(&jobs[0]);
+#endif
+    }
+
+    double runSeconds = getRunSeconds() - start;
+    long callCount = 0;
+
+    for (int thread = 0; thread < threadCount && result; thread++) {
+        result = jobs[thread].result;
+        callCount += jobs[thread].callCount;
+    }
+
+    if (result) {
+        double executionCount = (double) repeatCount * threadCount;
+        printf("[Prepared] %.0f executions on %d thread%s in %.2f ms: %.2f us per execution, %.0f executions per "
+               "second.\n", executionCount, threadCount, threadCount == 1 ? "" : "s", 1000.0 * runSeconds,
+               1e6 * runSeconds / executionCount * threadCount, runSeconds > 0 ? executionCount / runSeconds : 0.0);
+
+        // A recursive program spends its time in calls, whose rate is reported on its own
+        if (callCount > 0) {
+            printf("[Prepared] %ld calls in %.2f ms: %.2f ns per call, %.0f calls per second.\n", callCount,
+                   1000.0 * runSeconds, 1e9 * runSeconds / callCount * threadCount,
+                   runSeconds > 0 ? callCount / runSeconds : 0.0);
+        }
+
+        // The layout of the blocks is measured by how often control does not go on to the next instruction
+        if (branchCounts) {
+            VMBranchSummary summary;
+            summarizeVMBranches(bytecode, branchCounts, &summary);
+            long transferCount = summary.branchCount + summary.jumpCount;
+            printf("[Prepared] %ld branches and %ld jumps executed, of which %ld taken (%.1f%%).\n",
+                   summary.branchCount, summary.jumpCount, summary.takenCount,
+                   transferCount > 0 ? 100.0 * summary.takenCount / transferCount : 0.0);
+        }
+
+        displayRunResults(program, inputs);
+    }
+
+    // The branch profile is written at exit, and lays out the blocks of the next compilation of the program
+    BranchProfile *writtenProfile = result && branchCounts && branchProfilePath ? initBranchProfile() : NULL;
+
+    if (writtenProfile && addVMBranchProfile(bytecode, branchCounts, writtenProfile) &&
+        writeBranchProfile(writtenProfile, branchProfilePath)) {
+        printf("[BranchProfile] Wrote %d branches into '%s'.\n", writtenProfile->branchCount, branchProfilePath);
+    }
+
+    // The profile is written at exit, whether the executions have succeeded or not
+    if (frameProfile) {
+        size_t size = writeVMFrameProfile(frameProfile, frameProfilePath);
+        if (size > 0) printf("[FrameProfile] Wrote %zu bytes into '%s'.\n", size, frameProfilePath);
+        displayVMFrameProfile(frameProfile);
+        freeVMFrameProfile(frameProfile);
+    }
+
+    // The metrics are rendered into a buffer of their size, which is measured first
+    size_t metricsLength = isMetricsDisplayed ? renderMetrics(NULL, 0) + 1 : 0;
+    char *metrics = metricsLength > 0 ? (char*) malloc(metricsLength) : NULL;
+
+    if (metrics) {
+        renderMetrics(metrics, metricsLength);
+        fputs(metrics, stdout);
+        free(metrics);
+    }
+
+    stopMetricsExporter(exporter);
+    freeBranchProfile(writtenProfile);
+    free(branchCounts);
+    free(inputs);
+    free(isGiven);
+    freePreparedProgram(program);
+    return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
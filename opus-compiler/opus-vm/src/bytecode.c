@@ -0,0 +1,594 @@
+// bytecode.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bytecode.h"
+#include "image.h"
+#include "dataflow.h"
+#include "integer.h"
+
+/// The state of assembling a function into bytecode.
+typedef struct {
+    IRProgram *ir;              /// The program being assembled.
+    IRFunction *function;       /// The function being assembled.
+    VMProgram *program;         /// The bytecode receiving the instructions.
+    int *globals;               /// The global held by each local of the entry function, or -1.
+    int *blockStarts;           /// The first instruction of each block, or -1 if the block is unreachable.
+    int argumentCount;          /// The number of arguments passed since the last call.
+    int maxArgumentCount;       /// The largest number of arguments passed to a call by the function.
+    int lastCallee;             /// The function called last, whose frame holds the lanes of a returned vector.
+} VMAssembler;
+
+// Appends an instruction whose slots are all unused, which returns NULL if memory allocation fails
+static VMInstruction *emitVMInstruction(VMProgram *program, VMOpcode opcode, Location location) {
+    if (program->codeCount == program->codeCapacity) {
+        int capacity = program->codeCapacity ? 2 * program->codeCapacity : 64;
+        VMInstruction *code = (VMInstruction*) realloc(program->code, capacity * sizeof(VMInstruction));
+        if (!code) return NULL;
+        program->code = code;
+
+        Location *locations = (Location*) realloc(program->locations, capacity * sizeof(Location));
+        if (!locations) return NULL;
+        program->locations = locations;
+        program->codeCapacity = capacity;
+    }
+
+    VMInstruction *instruction = &program->code[program->codeCount];
+    memset(instruction, 0, sizeof(VMInstruction));
+    instruction->opcode = (uint16_t) opcode;
+    instruction->destination = instruction->operands[0] = instruction->operands[1] = VM_NO_SLOT;
+    instruction->targets[0] = instruction->targets[1] = -1;
+    program->locations[program->codeCount++] = location;
+    return instruction;
+}
+
+// Gets the frame slot of a register, or VM_NO_SLOT if there is no register
+static int getVMSlot(IRFunction *function, int reg) {
+    return reg == IR_NO_REGISTER ? VM_NO_SLOT : function->slots[reg];
+}
+
+// Selects the operation specialized for the type of the operands, where a Bool, a String and a sized integer are held
+// like an Int, except that a UInt32 is divided, compared and converted as unsigned
+static VMOpcode selectVMOpcode(IROpcode opcode, IRType type, int isOverflowChecked) {
+    int isFloat = (type == IR_TYPE_FLOAT);
+
+    if (type == IR_TYPE_UINT32) {
+        switch (opcode) {
+            case IR_DIVIDE: return VM_DIVIDE_UINT;
+            case IR_MODULO: return VM_MODULO_UINT;
+            case IR_LESS_THAN: return VM_LESS_THAN_UINT;
+            case IR_LESS_OR_EQUAL: return VM_LESS_OR_EQUAL_UINT;
+            case IR_GREATER_THAN: return VM_GREATER_THAN_UINT;
+            case IR_GREATER_OR_EQUAL: return VM_GREATER_OR_EQUAL_UINT;
+            case IR_CONVERT: return VM_CONVERT_UINT;
+            default: break;
+        }
+    }
+
+    // An Int operation that could overflow has a checked form, which fails instead of wrapping around
+    if (isOverflowChecked && !isFloat) {
+        switch (opcode) {
+            case IR_ADD: return VM_ADD_INT_CHECKED;
+            case IR_SUBTRACT: return VM_SUBTRACT_INT_CHECKED;
+            case IR_MULTIPLY: return VM_MULTIPLY_INT_CHECKED;
+            case IR_DIVIDE: return VM_DIVIDE_INT_CHECKED;
+            case IR_NEGATE: return VM_NEGATE_INT_CHECKED;
+            case IR_FACTORIAL: return VM_FACTORIAL_CHECKED;
+            default: break;
+        }
+    }
+
+    switch (opcode) {
+        case IR_ADD: return isFloat ? VM_ADD_FLOAT : VM_ADD_INT;
+        case IR_SUBTRACT: return isFloat ? VM_SUBTRACT_FLOAT : VM_SUBTRACT_INT;
+        case IR_MULTIPLY: return isFloat ? VM_MULTIPLY_FLOAT : VM_MULTIPLY_INT;
+        case IR_DIVIDE: return isFloat ? VM_DIVIDE_FLOAT : VM_DIVIDE_INT;
+        case IR_MODULO: return isFloat ? VM_MODULO_FLOAT : VM_MODULO_INT;
+        case IR_NEGATE: return isFloat ? VM_NEGATE_FLOAT : VM_NEGATE_INT;
+        case IR_EQUAL: return isFloat ? VM_EQUAL_FLOAT : VM_EQUAL_INT;
+        case IR_NOT_EQUAL: return isFloat ? VM_NOT_EQUAL_FLOAT : VM_NOT_EQUAL_INT;
+        case IR_LESS_THAN: return isFloat ? VM_LESS_THAN_FLOAT : VM_LESS_THAN_INT;
+        case IR_LESS_OR_EQUAL: return isFloat ? VM_LESS_OR_EQUAL_FLOAT : VM_LESS_OR_EQUAL_INT;
+        case IR_GREATER_THAN: return isFloat ? VM_GREATER_THAN_FLOAT : VM_GREATER_THAN_INT;
+        case IR_GREATER_OR_EQUAL: return isFloat ? VM_GREATER_OR_EQUAL_FLOAT : VM_GREATER_OR_EQUAL_INT;
+        case IR_NOT: return VM_NOT;
+        case IR_FACTORIAL: return VM_FACTORIAL;
+        case IR_SHIFT_LEFT: return VM_SHIFT_LEFT;
+        case IR_SHIFT_RIGHT: return VM_SHIFT_RIGHT;
+        case IR_SHIFT_RIGHT_LOGICAL: return VM_SHIFT_RIGHT_LOGICAL;
+        case IR_BITWISE_AND: return VM_BITWISE_AND;
+        case IR_MULTIPLY_HIGH: return VM_MULTIPLY_HIGH;
+        case IR_BIT_TEST: return VM_BIT_TEST;
+        case IR_STRING_HASH: return VM_STRING_HASH;
+        case IR_CONVERT: return VM_CONVERT;
+        default: return VM_COPY;
+    }
+}
+
+// Checks that every value of a function could be held by a slot, that is it has a known type
+static int checkVMFunction(IRProgram *ir, IRFunction *function) {
+    if (!function->slots) {
+        reportDiagnostic(ir->diagnostics, function->location, "The frame of function '%s' has not been allocated",
+                         function->name);
+        return 0;
+    }
+
+    if (function != ir->functions[0] && function->returnType == IR_TYPE_ANY) {
+        reportDiagnostic(ir->diagnostics, function->location, "Function '%s' returns a value of an unknown type",
+                         function->name);
+        return 0;
+    }
+
+    for (int blockIndex = 0; blockIndex < function->blockCount; blockIndex++) {
+        BasicBlock *block = function->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            int isUnknown = instruction->destination >= 0 && instruction->opcode != IR_DECLARE &&
+                            function->registerTypes[instruction->destination] == IR_TYPE_ANY;
+
+            for (int operand = 0; operand < 2; operand++) {
+                int reg = instruction->operands[operand];
+                isUnknown |= reg >= 0 && function->registerTypes[reg] == IR_TYPE_ANY;
+            }
+
+            if (isUnknown) {
+                reportDiagnostic(ir->diagnostics, instruction->location, "Value of an unknown type could not be "
+                                 "executed by the virtual machine");
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+// Assembles an instruction (except a jump), which returns 0 if it could not be assembled
+static int assembleVMInstruction(VMAssembler *assembler, IRInstruction *instruction) {
+    IRFunction *function = assembler->function;
+    VMProgram *program = assembler->program;
+    Location location = instruction->location;
+    int lhs = instruction->operands[0];
+    IRType type = isIRUnsigned(function, instruction) ? IR_TYPE_UINT32
+                : lhs >= 0 ? function->registerTypes[lhs] : instruction->type;
+    int isChecked = assembler->ir->isOverflowChecked && instruction->type == IR_TYPE_INT;
+    VMInstruction *assembled = NULL;
+
+    switch (instruction->opcode) {
+        case IR_DECLARE: return 1;
+
+        case IR_CONSTANT: {
+            assembled = emitVMInstruction(program, VM_CONSTANT, location);
+            if (!assembled) return 0;
+
+            IRConstant constant = instruction->constant;
+            if (instruction->type == IR_TYPE_FLOAT) assembled->immediate.floating = constant.floatingValue;
+            else if (instruction->type == IR_TYPE_BOOL) assembled->immediate.integer = constant.booleanValue != 0;
+            else assembled->immediate.integer = constant.integerValue;
+            break;
+        }
+
+        // A global is a slot of the entry frame, which is always at the bottom of the stack
+        case IR_LOAD_GLOBAL: case IR_STORE_GLOBAL: {
+            VMOpcode opcode = instruction->opcode == IR_LOAD_GLOBAL ? VM_LOAD_GLOBAL : VM_STORE_GLOBAL;
+            assembled = emitVMInstruction(program, opcode, location);
+            if (!assembled) return 0;
+
+            assembled->immediate.integer = assembler->ir->functions[0]->slots[instruction->constant.integerValue];
+            break;
+        }
+
+        // An argument is written right above the frame of the caller, where the frame of the callee starts, which is
+        // where an argument computed right before the call already is (see assignFrameSlots())
+        case IR_ARGUMENT: {
+            int argument = assembler->argumentCount++;
+            if (assembler->argumentCount > assembler->maxArgumentCount) {
+                assembler->maxArgumentCount = assembler->argumentCount;
+            }
+
+            if (getVMSlot(function, lhs) == function->frameSize + argument) return 1;
+
+            assembled = emitVMInstruction(program, VM_ARGUMENT, location);
+            if (!assembled) return 0;
+            assembled->immediate.integer = argument;
+            break;
+        }
+
+        case IR_CALL: {
+            IRProgram *ir = assembler->ir;
+            const char *callee = ir->strings[instruction->constant.stringIndex];
+            int index = findIRFunction(ir, callee);
+            assembler->argumentCount = 0;
+
+            if (strcmp(callee, VM_INPUT_FUNCTION) == 0) {
+                int global = function == ir->functions[0] && instruction->destination >= 0 &&
+                             instruction->destination < function->localCount ?
+                             assembler->globals[instruction->destination] : -1;
+
+                if (global < 0 || program->globals[global].input < 0) {
+                    reportDiagnostic(ir->diagnostics, location, "An input must be a global of the program");
+                    return 0;
+                }
+
+                assembled = emitVMInstruction(program, VM_INPUT, location);
+                if (!assembled) return 0;
+                assembled->immediate.integer = program->globals[global].input;
+                break;
+            }
+
+            if (index <= 0) {
+                reportDiagnostic(ir->diagnostics, location, "Function '%s' could not be called by the virtual "
+                                 "machine, since the program does not implement it", callee);
+                return 0;
+            }
+
+            assembled = emitVMInstruction(program, VM_CALL, location);
+            if (!assembled) return 0;
+
+            assembler->lastCallee = index;
+            assembled->immediate.integer = index;
+            assembled->argumentCount = (uint16_t) instruction->argumentCount;
+            break;
+        }
+
+        // The lanes of a returned vector but its lane 0 are written past the frame of the callee like arguments (see
+        // scalarizeIRProgram()), where the caller reads them once the callee has returned
+        case IR_STORE_RESULT: {
+            assembled = emitVMInstruction(program, VM_ARGUMENT, location);
+            if (!assembled) return 0;
+
+            assembled->immediate.integer = instruction->constant.integerValue - 1;
+            if (instruction->constant.integerValue > assembler->maxArgumentCount) {
+                assembler->maxArgumentCount = instruction->constant.integerValue;
+            }
+            break;
+        }
+
+        case IR_LOAD_RESULT: {
+            assembled = emitVMInstruction(program, VM_RESULT, location);
+            if (!assembled) return 0;
+
+            IRFunction *callee = assembler->ir->functions[assembler->lastCallee];
+            assembled->immediate.integer = callee->frameSize + instruction->constant.integerValue - 1;
+            break;
+        }
+
+        // Strings are interned, so two strings are equal exactly when their indices are, but they are ordered by
+        // their content
+        case IR_LESS_THAN: case IR_LESS_OR_EQUAL: case IR_GREATER_THAN: case IR_GREATER_OR_EQUAL: {
+            if (type == IR_TYPE_STRING) {
+                assembled = emitVMInstruction(program, VM_COMPARE_STRING, location);
+                if (!assembled) return 0;
+                assembled->immediate.integer = instruction->opcode - IR_EQUAL;
+                break;
+            }
+
+            assembled = emitVMInstruction(program, selectVMOpcode(instruction->opcode, type, isChecked), location);
+            break;
+        }
+
+        // The terminators are assembled once the blocks have been laid out
+        case IR_RETURN: {
+            assembled = emitVMInstruction(program, VM_RETURN, location);
+            break;
+        }
+
+        default: {
+            assembled = emitVMInstruction(program, selectVMOpcode(instruction->opcode, type, isChecked), location);
+            if (assembled) assembled->immediate.integer = instruction->constant.integerValue;
+            break;
+        }
+    }
+
+    if (!assembled) return 0;
+    assembled->destination = getVMSlot(function, instruction->destination);
+    assembled->operands[0] = getVMSlot(function, lhs);
+    assembled->operands[1] = getVMSlot(function, instruction->operands[1]);
+    return 1;
+}
+
+// Assembles the reachable blocks of a function in their layout order, where a jump to the next block falls through
+static int assembleVMFunction(VMAssembler *assembler, int functionIndex) {
+    IRFunction *function = assembler->function;
+    VMProgram *program = assembler->program;
+    int *order = (int*) malloc((function->blockCount + 1) * sizeof(int));
+    int *blockStarts = (int*) malloc((function->blockCount + 1) * sizeof(int));
+    int first = program->codeCount;
+    int result = order && blockStarts && checkVMFunction(assembler->ir, function);
+
+    if (!result) {
+        free(order);
+        free(blockStarts);
+        return 0;
+    }
+
+    int orderCount = computeLayoutOrder(function, order);
+    for (int block = 0; block < function->blockCount; block++) blockStarts[block] = -1;
+
+    assembler->blockStarts = blockStarts;
+    assembler->argumentCount = assembler->maxArgumentCount = 0;
+
+    for (int position = 0; position < orderCount && result; position++) {
+        BasicBlock *block = function->blocks[order[position]];
+        int nextBlock = position + 1 < orderCount ? order[position + 1] : IR_NO_BLOCK;
+        blockStarts[block->index] = program->codeCount;
+
+        for (int index = 0; index < block->instructionCount && result; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+
+            if (instruction->opcode == IR_JUMP && instruction->targets[0] == nextBlock) continue;
+
+            if (instruction->opcode == IR_JUMP || instruction->opcode == IR_BRANCH) {
+                VMOpcode opcode = instruction->opcode == IR_JUMP ? VM_JUMP : VM_BRANCH;
+                VMInstruction *assembled = emitVMInstruction(program, opcode, instruction->location);
+                result = assembled != NULL;
+
+                // The targets are blocks until every block has been placed
+                if (assembled) {
+                    assembled->operands[0] = getVMSlot(function, instruction->operands[0]);
+                    assembled->targets[0] = instruction->targets[0];
+                    assembled->targets[1] = instruction->targets[1];
+                }
+            }
+
+            // The table of a switch is a jump for each value, right after it
+            else if (instruction->opcode == IR_SWITCH) {
+                IRSwitchTable *table = &function->switchTables[instruction->constant.integerValue];
+                VMInstruction *assembled = emitVMInstruction(program, VM_SWITCH, instruction->location);
+                result = assembled != NULL;
+
+                if (assembled) {
+                    assembled->operands[0] = getVMSlot(function, instruction->operands[0]);
+                    assembled->immediate.integer = table->low;
+                    assembled->targets[0] = instruction->targets[0];
+                    assembled->targets[1] = table->count;
+                }
+
+                for (int entry = 0; entry < table->count && result; entry++) {
+                    assembled = emitVMInstruction(program, VM_JUMP, instruction->location);
+                    result = assembled != NULL;
+                    if (assembled) assembled->targets[0] = table->targets[entry];
+                }
+            }
+
+            else result = assembleVMInstruction(assembler, instruction);
+        }
+
+        // A block without a terminator only ends a function
+        if (result && !isIRBlockTerminated(block)) {
+            result = emitVMInstruction(program, VM_RETURN, function->location) != NULL;
+        }
+    }
+
+    for (int index = first; index < program->codeCount && result; index++) {
+        VMInstruction *instruction = &program->code[index];
+        if (instruction->opcode != VM_JUMP && instruction->opcode != VM_BRANCH && instruction->opcode != VM_SWITCH) {
+            continue;
+        }
+
+        instruction->targets[0] = blockStarts[instruction->targets[0]];
+        if (instruction->opcode == VM_BRANCH) instruction->targets[1] = blockStarts[instruction->targets[1]];
+    }
+
+    if (result) {
+        VMFunction *assembled = &program->functions[functionIndex];
+        assembled->name = internVMString(program, function->name);
+        assembled->entry = first;
+        assembled->parameterCount = function->parameterCount;
+        assembled->frameSize = function->frameSize;
+        assembled->stackSize = function->frameSize + assembler->maxArgumentCount;
+        assembled->returnType = function->returnType;
+        result = assembled->name >= 0;
+    }
+
+    free(order);
+    free(blockStarts);
+    return result;
+}
+
+// Declares the globals of the program, where a global assigned by calling VM_INPUT_FUNCTION is an input
+static int declareVMGlobals(VMAssembler *assembler) {
+    IRFunction *entry = assembler->ir->functions[0];
+    VMProgram *program = assembler->program;
+    unsigned char *isInput = (unsigned char*) calloc(entry->localCount + 1, 1);
+
+    program->globals = (VMGlobal*) malloc((entry->localCount + 1) * sizeof(VMGlobal));
+    if (!isInput || !program->globals) {
+        free(isInput);
+        return 0;
+    }
+
+    for (int blockIndex = 0; blockIndex < entry->blockCount; blockIndex++) {
+        BasicBlock *block = entry->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            int destination = instruction->destination;
+
+            if (instruction->opcode == IR_CALL && destination >= 0 && destination < entry->localCount &&
+                strcmp(assembler->ir->strings[instruction->constant.stringIndex], VM_INPUT_FUNCTION) == 0) {
+                isInput[destination] = 1;
+            }
+        }
+    }
+
+    // Inputs are numbered in the order they are declared
+    for (int local = 0; local < entry->localCount; local++) {
+        assembler->globals[local] = -1;
+        if (!entry->locals[local].isGlobal) continue;
+
+        VMGlobal *global = &program->globals[program->globalCount];
+        global->name = internVMString(program, entry->locals[local].identifier);
+        global->slot = entry->slots ? entry->slots[local] : 0;
+        global->type = entry->locals[local].type;
+        global->isMutable = entry->locals[local].isMutable;
+        global->input = isInput[local] ? program->inputCount++ : -1;
+
+        if (global->name < 0) {
+            free(isInput);
+            return 0;
+        }
+
+        assembler->globals[local] = program->globalCount++;
+    }
+
+    free(isInput);
+    return 1;
+}
+
+VMProgram *assembleVMProgram(IRProgram *ir) {
+    if (!ir || ir->functionCount == 0) return NULL;
+
+    VMProgram *program = (VMProgram*) calloc(1, sizeof(VMProgram));
+    if (!program) return NULL;
+
+    IRFunction *entry = ir->functions[0];
+    VMAssembler assembler = {ir, NULL, program, NULL, NULL, 0, 0, 0};
+    assembler.globals = (int*) malloc((entry->localCount + 1) * sizeof(int));
+    program->functions = (VMFunction*) calloc(ir->functionCount, sizeof(VMFunction));
+    program->functionCount = ir->functionCount;
+
+    // The string table starts as a copy of the one of the IR, so that a string keeps its index
+    int result = assembler.globals && program->functions;
+    for (int string = 0; string < ir->stringCount && result; string++) {
+        result = internVMString(program, ir->strings[string]) == string;
+    }
+
+    result = result && declareVMGlobals(&assembler);
+
+    for (int function = 0; function < ir->functionCount && result; function++) {
+        assembler.function = ir->functions[function];
+        result = assembleVMFunction(&assembler, function);
+    }
+
+    free(assembler.globals);
+
+    if (!result) {
+        freeVMProgram(program);
+        return NULL;
+    }
+
+    return program;
+}
+
+int internVMString(VMProgram *program, const char *string) {
+    for (int index = 0; index < program->stringCount; index++) {
+        if (strcmp(program->stringData + program->stringOffsets[index], string) == 0) return index;
+    }
+
+    if (program->stringCount == program->stringCapacity) {
+        int capacity = program->stringCapacity ? 2 * program->stringCapacity : 16;
+        int32_t *offsets = (int32_t*) realloc(program->stringOffsets, capacity * sizeof(int32_t));
+        if (!offsets) return -1;
+
+        program->stringOffsets = offsets;
+        program->stringCapacity = capacity;
+    }
+
+    int length = (int) strlen(string) + 1;
+
+    if (program->stringDataLength + length > program->stringDataCapacity) {
+        int capacity = program->stringDataCapacity ? 2 * program->stringDataCapacity : 256;
+        while (capacity < program->stringDataLength + length) capacity *= 2;
+
+        char *data = (char*) realloc(program->stringData, capacity);
+        if (!data) return -1;
+
+        program->stringData = data;
+        program->stringDataCapacity = capacity;
+    }
+
+    memcpy(program->stringData + program->stringDataLength, string, length);
+    program->stringOffsets[program->stringCount] = program->stringDataLength;
+    program->stringDataLength += length;
+    return program->stringCount++;
+}
+
+const char *getVMString(const VMProgram *program, int string) {
+    return string >= 0 && string < program->stringCount ? program->stringData + program->stringOffsets[string] : "";
+}
+
+const char *getVMOpcodeName(VMOpcode opcode) {
+    static const char *names[] = {
+        "const", "copy", "convert", "convert.u", "input", "load", "store", "add.i", "add.f", "sub.i", "sub.f",
+        "mul.i", "mul.f", "div.i", "div.f", "div.u", "mod.i", "mod.f", "mod.u", "neg.i", "neg.f", "not", "fact",
+        "addo.i", "subo.i", "mulo.i", "divo.i", "nego.i", "facto", "shl", "sar", "shr", "and", "mulh", "bt", "hash.s",
+        "eq.i", "eq.f", "ne.i", "ne.f", "lt.i", "lt.f", "lt.u", "le.i", "le.f", "le.u", "gt.i", "gt.f", "gt.u",
+        "ge.i", "ge.f", "ge.u", "cmp.s",
+        "arg", "call", "res", "jmp", "br", "switch", "ret",
+    };
+
+    return opcode <= VM_RETURN ? names[opcode] : "unknown";
+}
+
+void displayVMProgram(const VMProgram *program) {
+    for (int index = 0; index < program->functionCount; index++) {
+        const VMFunction *function = &program->functions[index];
+        int end = index + 1 < program->functionCount ? program->functions[index + 1].entry : program->codeCount;
+
+        printf("[Bytecode] Function '%s' (%d slots, %d on the stack):\n", getVMString(program, function->name),
+               function->frameSize, function->stackSize);
+
+        for (int position = function->entry; position < end; position++) {
+            const VMInstruction *instruction = &program->code[position];
+            printf("    %4d  %-8s", position, getVMOpcodeName((VMOpcode) instruction->opcode));
+
+            if (instruction->destination != VM_NO_SLOT) printf(" s%d =", instruction->destination);
+            if (instruction->operands[0] != VM_NO_SLOT) printf(" s%d", instruction->operands[0]);
+            if (instruction->operands[1] != VM_NO_SLOT) printf(", s%d", instruction->operands[1]);
+
+            switch (instruction->opcode) {
+                case VM_CONSTANT: {
+                    if (instruction->destination >= 0) printf(" #%d", instruction->immediate.integer);
+                    break;
+                }
+
+                case VM_JUMP: printf(" -> %d", instruction->targets[0]); break;
+                case VM_BRANCH: printf(" ? %d : %d", instruction->targets[0], instruction->targets[1]); break;
+
+                case VM_SWITCH: {
+                    printf(" #%d -> %d [%d]", instruction->immediate.integer, instruction->targets[0],
+                           instruction->targets[1]);
+                    break;
+                }
+
+                case VM_CALL: {
+                    const VMFunction *callee = &program->functions[instruction->immediate.integer];
+                    printf(" %s/%d", getVMString(program, callee->name), instruction->argumentCount);
+                    break;
+                }
+
+                case VM_INPUT: case VM_LOAD_GLOBAL: case VM_STORE_GLOBAL: case VM_SHIFT_LEFT: case VM_SHIFT_RIGHT:
+                case VM_SHIFT_RIGHT_LOGICAL: case VM_BITWISE_AND: case VM_MULTIPLY_HIGH: case VM_BIT_TEST:
+                case VM_STRING_HASH: case VM_ARGUMENT: case VM_RESULT: case VM_COMPARE_STRING:
+                    printf(" #%d", instruction->immediate.integer); break;
+                default: break;
+            }
+
+            printf("\n");
+        }
+    }
+}
+
+void freeVMProgram(VMProgram *program) {
+    if (!program) return;
+
+    // A mapped program only points into its image
+    if (program->image) {
+        unmapVMImage(program->image, program->imageSize);
+        free(program);
+        return;
+    }
+
+    free(program->stringData);
+    free(program->stringOffsets);
+    free(program->code);
+    free(program->locations);
+    free(program->functions);
+    free(program->globals);
+    free(program);
+}
@@ -0,0 +1,327 @@
+// image.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "image.h"
+#include "vm.h"
+
+// The size of an item of each section, in the order of the kinds of sections
+static const size_t sectionItemSizes[VM_SECTION_COUNT] = {
+    sizeof(VMInstruction), sizeof(Location), sizeof(VMFunction), sizeof(VMGlobal), sizeof(int32_t), 1,
+    sizeof(VMValue),
+};
+
+// Rounds an offset up to the alignment of every section
+static size_t alignVMImageOffset(size_t offset) {
+    return (offset + VM_IMAGE_ALIGNMENT - 1) / VM_IMAGE_ALIGNMENT * VM_IMAGE_ALIGNMENT;
+}
+
+size_t writeVMImage(const VMProgram *program, const VMValue *snapshot, int snapshotSlots, const char *path) {
+    const void *sources[VM_SECTION_COUNT] = {
+        program->code, program->locations, program->functions, program->globals, program->stringOffsets,
+        program->stringData, snapshot,
+    };
+    int counts[VM_SECTION_COUNT] = {
+        program->codeCount, program->codeCount, program->functionCount, program->globalCount, program->stringCount,
+        program->stringDataLength, snapshot ? snapshotSlots : 0,
+    };
+
+    // Each section starts at an aligned offset after the header, in the order of the kinds of sections
+    VMImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, VM_IMAGE_MAGIC, sizeof(VM_IMAGE_MAGIC));
+    header.version = VM_IMAGE_VERSION;
+    header.byteOrder = VM_IMAGE_BYTE_ORDER;
+    header.inputCount = (uint32_t) program->inputCount;
+
+    size_t size = alignVMImageOffset(sizeof(VMImageHeader));
+
+    for (int section = 0; section < VM_SECTION_COUNT; section++) {
+        header.sections[section].offset = (uint32_t) size;
+        header.sections[section].count = (uint32_t) counts[section];
+        size = alignVMImageOffset(size + counts[section] * sectionItemSizes[section]);
+    }
+
+    header.size = size;
+    unsigned char *image = (unsigned char*) calloc(size, 1);
+    FILE *file = image ? fopen(path, "wb") : NULL;
+
+    if (file) {
+        memcpy(image, &header, sizeof(header));
+
+        for (int section = 0; section < VM_SECTION_COUNT; section++) {
+            if (counts[section] > 0) memcpy(image + header.sections[section].offset, sources[section],
+                                            counts[section] * sectionItemSizes[section]);
+        }
+    }
+
+    int result = file && fwrite(image, 1, size, file) == size;
+    if (file) result = (fclose(file) == 0) && result;
+    if (!result) fprintf(stderr, "[AccessError]: File '%s' could not be written.\n", path);
+
+    free(image);
+    return result ? size : 0;
+}
+
+int isVMImage(const char *path) {
+    char magic[8] = {0};
+    FILE *file = fopen(path, "rb");
+    if (!file) return 0;
+
+    size_t length = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+    return length == sizeof(magic) && memcmp(magic, VM_IMAGE_MAGIC, sizeof(VM_IMAGE_MAGIC)) == 0;
+}
+
+// Maps a whole file read-only, or reads it into memory where it could not be mapped
+static void *mapVMImageFile(const char *path, size_t *size) {
+#ifndef _WIN32
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) return NULL;
+
+    struct stat status;
+    void *image = NULL;
+
+    if (fstat(descriptor, &status) == 0 && status.st_size >= (off_t) sizeof(VMImageHeader)) {
+        *size = (size_t) status.st_size;
+        image = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (image == MAP_FAILED) image = NULL;
+    }
+
+    close(descriptor);
+    return image;
+#else
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    rewind(file);
+
+    void *image = length >= (long) sizeof(VMImageHeader) ? malloc(length) : NULL;
+
+    if (image && fread(image, 1, length, file) != (size_t) length) {
+        free(image);
+        image = NULL;
+    }
+
+    fclose(file);
+    *size = (size_t) length;
+    return image;
+#endif
+}
+
+// The slots an operation reads and writes, as the bits of VM_USES_A, VM_USES_B and VM_USES_D
+#define VM_USES_A   1
+#define VM_USES_B   2
+#define VM_USES_D   4
+
+static int getVMSlotUses(VMOpcode opcode) {
+    switch (opcode) {
+        case VM_CONSTANT: case VM_INPUT: case VM_LOAD_GLOBAL: case VM_RESULT: return VM_USES_D;
+        case VM_STORE_GLOBAL: case VM_ARGUMENT: case VM_BRANCH: case VM_SWITCH: return VM_USES_A;
+        case VM_CALL: case VM_JUMP: case VM_RETURN: return 0;
+
+        case VM_COPY: case VM_CONVERT: case VM_CONVERT_UINT: case VM_NEGATE_INT: case VM_NEGATE_FLOAT: case VM_NOT:
+        case VM_FACTORIAL: case VM_NEGATE_INT_CHECKED: case VM_FACTORIAL_CHECKED: case VM_SHIFT_LEFT:
+        case VM_SHIFT_RIGHT: case VM_SHIFT_RIGHT_LOGICAL: case VM_BITWISE_AND: case VM_MULTIPLY_HIGH:
+        case VM_STRING_HASH: return VM_USES_A | VM_USES_D;
+
+        default: return VM_USES_A | VM_USES_B | VM_USES_D;
+    }
+}
+
+// Checks that an instruction only refers to the slots of the frame of its function, to the instructions of its
+// function, and to the functions, globals and inputs of the program, so a mapped program never runs out of them. An
+// operand is read from the frame, while a destination might also be an argument of the next call, past the frame.
+static int checkVMInstruction(const VMInstruction *code, int index, int start, int end, const VMFunction *functions,
+                              int functionCount, int function, int inputCount, int lastCallee) {
+    const VMInstruction *instruction = &code[index];
+    int frameSize = functions[function].frameSize;
+    int stackSize = functions[function].stackSize;
+    if (instruction->opcode > VM_RETURN) return 0;
+
+    VMOpcode opcode = (VMOpcode) instruction->opcode;
+    int uses = getVMSlotUses(opcode);
+    int32_t slots[3] = {instruction->operands[0], instruction->operands[1], instruction->destination};
+    int32_t limits[3] = {frameSize, frameSize, stackSize};
+
+    for (int slot = 0; slot < 3; slot++) {
+        if (!(uses & (1 << slot))) continue;
+        if (slots[slot] < 0 || slots[slot] >= limits[slot]) return 0;
+    }
+
+    // The returned value and the destination of a call are the only optional slots
+    if (opcode == VM_RETURN && slots[0] != VM_NO_SLOT && (slots[0] < 0 || slots[0] >= frameSize)) return 0;
+    if (opcode == VM_CALL && slots[2] != VM_NO_SLOT && (slots[2] < 0 || slots[2] >= stackSize)) return 0;
+
+    int32_t immediate = instruction->immediate.integer;
+    const int32_t *targets = instruction->targets;
+
+    switch (opcode) {
+        case VM_INPUT: return immediate >= 0 && immediate < inputCount;
+        case VM_LOAD_GLOBAL: case VM_STORE_GLOBAL: return immediate >= 0 && immediate < functions[0].frameSize;
+        case VM_SHIFT_LEFT: case VM_SHIFT_RIGHT: case VM_SHIFT_RIGHT_LOGICAL: return immediate >= 0 && immediate < 32;
+        case VM_COMPARE_STRING: return immediate >= 0 && immediate <= IR_GREATER_OR_EQUAL - IR_EQUAL;
+        case VM_ARGUMENT: return immediate >= 0 && immediate < functions[function].stackSize - frameSize;
+        case VM_CALL: return immediate > 0 && immediate < functionCount;
+
+        // The lanes of a returned vector are read past the frame of the last callee, within its stack
+        case VM_RESULT: {
+            if (lastCallee < 0) return 0;
+            int32_t offset = immediate - functions[lastCallee].frameSize;
+            return offset >= 0 && offset < functions[lastCallee].stackSize - functions[lastCallee].frameSize;
+        }
+
+        case VM_JUMP: return targets[0] >= start && targets[0] < end;
+        case VM_BRANCH: return targets[0] >= start && targets[0] < end && targets[1] >= start && targets[1] < end;
+
+        // The table of a switch is a jump for each value, right after it
+        case VM_SWITCH: {
+            if (targets[0] < start || targets[0] >= end || targets[1] < 0 || targets[1] >= end - index) return 0;
+            for (int entry = 1; entry <= targets[1]; entry++) if (code[index + entry].opcode != VM_JUMP) return 0;
+            return 1;
+        }
+
+        default: return 1;
+    }
+}
+
+// Checks the frame and the instructions of each function, where the functions are laid out one after another from
+// the start of the code, and the last instruction of a function never falls through into the next one
+static int checkVMCode(const VMInstruction *code, int codeCount, const VMFunction *functions, int functionCount,
+                       int inputCount) {
+    for (int function = 0; function < functionCount; function++) {
+        const VMFunction *checked = &functions[function];
+        int start = checked->entry;
+        int end = function + 1 < functionCount ? functions[function + 1].entry : codeCount;
+
+        if ((function == 0 && start != 0) || start >= end || end > codeCount) return 0;
+        if (checked->parameterCount < 0 || checked->parameterCount > checked->frameSize ||
+            checked->frameSize > checked->stackSize || checked->stackSize > VM_DEFAULT_STACK_SLOTS) return 0;
+
+        VMOpcode last = (VMOpcode) code[end - 1].opcode;
+        if (last != VM_JUMP && last != VM_BRANCH && last != VM_RETURN) return 0;
+
+        // A call is followed by the reads of the vector it returns, so the last callee is the one they refer to
+        int lastCallee = -1;
+
+        for (int index = start; index < end; index++) {
+            if (!checkVMInstruction(code, index, start, end, functions, functionCount, function, inputCount,
+                                    lastCallee)) return 0;
+            if (code[index].opcode == VM_CALL) lastCallee = code[index].immediate.integer;
+        }
+    }
+
+    return 1;
+}
+
+// Checks that the sections of an image lie within the image, and that the program they hold is consistent
+static int checkVMImage(const unsigned char *image, size_t size) {
+    const VMImageHeader *header = (const VMImageHeader*) image;
+    if (memcmp(header->magic, VM_IMAGE_MAGIC, sizeof(VM_IMAGE_MAGIC)) != 0 || header->version != VM_IMAGE_VERSION ||
+        header->byteOrder != VM_IMAGE_BYTE_ORDER || header->size != size) return 0;
+
+    for (int section = 0; section < VM_SECTION_COUNT; section++) {
+        uint64_t offset = header->sections[section].offset;
+        uint64_t length = (uint64_t) header->sections[section].count * sectionItemSizes[section];
+        if (offset % VM_IMAGE_ALIGNMENT != 0 || offset + length > size) return 0;
+    }
+
+    const VMImageSection *sections = header->sections;
+    const VMFunction *functions = (const VMFunction*) (image + sections[VM_SECTION_FUNCTIONS].offset);
+    const VMGlobal *globals = (const VMGlobal*) (image + sections[VM_SECTION_GLOBALS].offset);
+    const int32_t *offsets = (const int32_t*) (image + sections[VM_SECTION_STRING_OFFSETS].offset);
+    const char *data = (const char*) (image + sections[VM_SECTION_STRING_DATA].offset);
+    uint32_t codeCount = sections[VM_SECTION_CODE].count;
+    uint32_t dataLength = sections[VM_SECTION_STRING_DATA].count;
+
+    if (sections[VM_SECTION_LOCATIONS].count != codeCount || sections[VM_SECTION_FUNCTIONS].count == 0) return 0;
+    if (dataLength > 0 && data[dataLength - 1] != '\0') return 0;
+
+    for (uint32_t string = 0; string < sections[VM_SECTION_STRING_OFFSETS].count; string++) {
+        if (offsets[string] < 0 || (uint32_t) offsets[string] >= dataLength) return 0;
+    }
+
+    for (uint32_t function = 0; function < sections[VM_SECTION_FUNCTIONS].count; function++) {
+        if (functions[function].entry < 0 || (uint32_t) functions[function].entry >= codeCount) return 0;
+    }
+
+    // The inputs are numbered in the order of their globals, so each input is bound to exactly one global
+    uint32_t inputCount = 0;
+
+    for (uint32_t global = 0; global < sections[VM_SECTION_GLOBALS].count; global++) {
+        if (globals[global].slot < 0 || globals[global].slot >= functions[0].frameSize) return 0;
+        if (globals[global].input >= 0 && (uint32_t) globals[global].input != inputCount++) return 0;
+        if (globals[global].input < -1) return 0;
+    }
+
+    if (inputCount != header->inputCount) return 0;
+
+    uint32_t snapshotSlots = sections[VM_SECTION_SNAPSHOT].count;
+    if (snapshotSlots != 0 && snapshotSlots != (uint32_t) functions[0].frameSize) return 0;
+
+    const VMInstruction *code = (const VMInstruction*) (image + sections[VM_SECTION_CODE].offset);
+    return checkVMCode(code, (int) codeCount, functions, (int) sections[VM_SECTION_FUNCTIONS].count,
+                       (int) header->inputCount);
+}
+
+VMProgram *mapVMImage(const char *path, const VMValue **snapshot) {
+    size_t size = 0;
+    unsigned char *image = (unsigned char*) mapVMImageFile(path, &size);
+
+    if (!image) {
+        fprintf(stderr, "[AccessError]: File '%s' could not be mapped.\n", path);
+        return NULL;
+    }
+
+    VMProgram *program = checkVMImage(image, size) ? (VMProgram*) calloc(1, sizeof(VMProgram)) : NULL;
+
+    if (!program) {
+        fprintf(stderr, "[ImageError]: File '%s' is not a valid image of version %d.\n", path, VM_IMAGE_VERSION);
+        unmapVMImage(image, size);
+        return NULL;
+    }
+
+    // The arrays of the program point right into the image, which is never written
+    const VMImageHeader *header = (const VMImageHeader*) image;
+    const VMImageSection *sections = header->sections;
+
+    program->code = (VMInstruction*) (image + sections[VM_SECTION_CODE].offset);
+    program->codeCount = (int) sections[VM_SECTION_CODE].count;
+    program->locations = (Location*) (image + sections[VM_SECTION_LOCATIONS].offset);
+    program->functions = (VMFunction*) (image + sections[VM_SECTION_FUNCTIONS].offset);
+    program->functionCount = (int) sections[VM_SECTION_FUNCTIONS].count;
+    program->globals = (VMGlobal*) (image + sections[VM_SECTION_GLOBALS].offset);
+    program->globalCount = (int) sections[VM_SECTION_GLOBALS].count;
+    program->inputCount = (int) header->inputCount;
+    program->stringOffsets = (int32_t*) (image + sections[VM_SECTION_STRING_OFFSETS].offset);
+    program->stringCount = (int) sections[VM_SECTION_STRING_OFFSETS].count;
+    program->stringData = (char*) (image + sections[VM_SECTION_STRING_DATA].offset);
+    program->stringDataLength = (int) sections[VM_SECTION_STRING_DATA].count;
+    program->image = image;
+    program->imageSize = size;
+
+    const VMValue *slots = (const VMValue*) (image + sections[VM_SECTION_SNAPSHOT].offset);
+    *snapshot = sections[VM_SECTION_SNAPSHOT].count > 0 ? slots : NULL;
+    return program;
+}
+
+void unmapVMImage(void *image, size_t size) {
+#ifndef _WIN32
+    munmap(image, size);
+#else
+    (void) size;
+    free(image);
+#endif
+}
@@ -0,0 +1,312 @@
+// prepared.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "prepared.h"
+#include "image.h"
+#include "parser.h"
+#include "analyzer.h"
+#include "dataflow.h"
+#include "integer.h"
+#include "vector.h"
+#include "frame.h"
+#include "pass.h"
+#include "metrics.h"
+
+// Reports the imports of a program, since a prepared program is compiled on its own
+static int checkPreparedImports(ASTNode *root, DiagnosticList *diagnostics) {
+    int result = 1;
+
+    for (ASTNode *node = root; node; node = node->right) {
+        ASTNode *statement = node->left;
+        if (!statement || statement->nodeType != AST_IMPORT_DECLARATION) continue;
+
+        const char *module = statement->left && statement->left->token ? statement->left->token->lexeme : "";
+        reportDiagnostic(diagnostics, statement->token->location, "Module '%s' could not be imported by a prepared "
+                         "program", module);
+        result = 0;
+    }
+
+    return result;
+}
+
+// Turns every top-level constant that is declared without a value, and never assigned, into an input of the program,
+// whose declaration reads the value bound to the input instead (before checking the definite assignment)
+static void declarePreparedInputs(IRProgram *program) {
+    IRFunction *entry = program->functions[0];
+    int *assignmentCounts = (int*) calloc(entry->localCount + 1, sizeof(int));
+    if (!assignmentCounts) return;
+
+    for (int function = 0; function < program->functionCount; function++) {
+        IRFunction *current = program->functions[function];
+
+        for (int blockIndex = 0; blockIndex < current->blockCount; blockIndex++) {
+            BasicBlock *block = current->blocks[blockIndex];
+
+            for (int index = 0; index < block->instructionCount; index++) {
+                IRInstruction *instruction = &block->instructions[index];
+                int local = current == entry ? instruction->destination : -1;
+
+                if (instruction->opcode == IR_STORE_GLOBAL) local = instruction->constant.integerValue;
+                else if (instruction->opcode == IR_DECLARE) local = -1;
+                if (local >= 0 && local < entry->localCount) assignmentCounts[local]++;
+            }
+        }
+    }
+
+    int stringIndex = internIRString(program, VM_INPUT_FUNCTION);
+
+    for (int blockIndex = 0; blockIndex < entry->blockCount; blockIndex++) {
+        BasicBlock *block = entry->blocks[blockIndex];
+
+        for (int index = 0; index < block->instructionCount; index++) {
+            IRInstruction *instruction = &block->instructions[index];
+            int local = instruction->destination;
+            if (instruction->opcode != IR_DECLARE || local < 0 || local >= entry->localCount) continue;
+
+            IRLocal *declared = &entry->locals[local];
+            int isValue = getIRIntegerWidth(declared->type) > 0 || declared->type == IR_TYPE_FLOAT ||
+                          declared->type == IR_TYPE_BOOL;
+            if (!declared->isGlobal || declared->isMutable || !isValue || assignmentCounts[local] > 0) continue;
+
+            instruction->opcode = IR_CALL;
+            instruction->type = declared->type;
+            instruction->constant.stringIndex = stringIndex;
+            instruction->argumentCount = 0;
+        }
+    }
+
+    free(assignmentCounts);
+}
+
+// Wraps a program in bytecode into a prepared program, where the bytecode is freed if memory allocation fails
+static PreparedProgram *initPreparedProgram(VMProgram *bytecode, const VMValue *snapshot) {
+    PreparedProgram *prepared = bytecode ? (PreparedProgram*) calloc(1, sizeof(PreparedProgram)) : NULL;
+    if (prepared) prepared->inputGlobals = (int*) malloc((bytecode->inputCount + 1) * sizeof(int));
+
+    if (!prepared || !prepared->inputGlobals) {
+        free(prepared);
+        freeVMProgram(bytecode);
+        return NULL;
+    }
+
+    prepared->bytecode = bytecode;
+    prepared->snapshot = snapshot;
+
+    // A mapped program points into its image, so only the arrays of an assembled program are allocated
+    size_t size = sizeof(PreparedProgram) + (bytecode->inputCount + 1) * sizeof(int);
+    if (!bytecode->image) {
+        size += bytecode->codeCapacity * (sizeof(VMInstruction) + sizeof(Location)) + bytecode->stringDataCapacity +
+                bytecode->functionCount * sizeof(VMFunction) + bytecode->globalCount * sizeof(VMGlobal) +
+                bytecode->stringCount * sizeof(int32_t);
+    }
+
+    addMetricCounter(METRIC_ALLOCATED_BYTES, size);
+
+    for (int global = 0; global < bytecode->globalCount; global++) {
+        if (bytecode->globals[global].input >= 0) prepared->inputGlobals[bytecode->globals[global].input] = global;
+    }
+
+    return prepared;
+}
+
+PreparedProgram *prepareOpusProgram(const char *sourcePath, int level, int isOverflowChecked,
+                                    const BranchProfile *branchProfile, DiagnosticList *diagnostics) {
+    FILE *sourceCode = openOpusSourceCode(sourcePath);
+    if (!sourceCode) return NULL;
+
+    uint64_t start = getMetricNanoseconds();
+    Parser *parser = initParser();
+    parser->diagnostics = parser->lexer->diagnostics = diagnostics;
+    parser->currentToken = advanceParser(parser, sourceCode);
+    ASTNode *root = parseProgram(parser, sourceCode);
+    int result = parser->parseError == PARSE_ERROR_NONE && checkPreparedImports(root, diagnostics);
+    observeMetricSince(METRIC_PARSE_SECONDS, &start);
+
+    SymbolTable *symbolTable = initSymbolTable();
+    Analyzer *analyzer = initAnalyzer(root, symbolTable);
+    IRProgram *program = initIRProgram();
+    analyzer->diagnostics = diagnostics;
+    if (program) program->diagnostics = diagnostics;
+    if (program) program->isOverflowChecked = isOverflowChecked;
+
+    // The pipeline of a compilation, except that the frames are allocated without being displayed
+    PassManager *manager = initPassManager(level);
+    if (manager) manager->branchProfile = branchProfile;
+    result = analyzeProgram(analyzer, root) && program && manager && result;
+    observeMetricSince(METRIC_ANALYZE_SECONDS, &start);
+
+    if (result) lowerIntoIRProgram(program, root, isPassScheduled(manager, "fold"));
+    if (result) declarePreparedInputs(program);
+    result = result && program->errorCount == 0 && analyzeDefiniteAssignment(program);
+
+    // A slot holds a single value, so the vectors are split into their lanes before they are optimized
+    result = result && scalarizeIRProgram(program);
+    if (result) observeMetricSince(METRIC_LOWER_SECONDS, &start);
+
+    if (result) {
+        if (manager->pipelineCount > 0 && manager->pipeline[manager->pipelineCount - 1] == findPass("frame")) {
+            manager->pipelineCount--;
+        }
+
+        runPassManager(manager, program);
+    }
+
+    for (int function = 0; result && function < program->functionCount; function++) {
+        result = allocateFrame(program->functions[function]);
+    }
+
+    if (result) observeMetricSince(METRIC_OPTIMIZE_SECONDS, &start);
+
+    // The IR is no longer needed once it has been assembled
+    VMProgram *bytecode = result ? assembleVMProgram(program) : NULL;
+    PreparedProgram *prepared = initPreparedProgram(bytecode, NULL);
+    if (bytecode) observeMetricSince(METRIC_EMIT_SECONDS, &start);
+
+    addMetricCounter(METRIC_COMPILES, 1);
+    if (!prepared) addMetricCounter(METRIC_COMPILE_FAILURES, 1);
+
+    // The source code is kept open until every phase has reported its errors, whose columns are then located
+    locateDiagnostics(diagnostics, sourceCode);
+    fclose(sourceCode);
+    freePassManager(manager);
+    freeIRProgram(program);
+    freeSymbolTable(symbolTable);
+    free(analyzer);
+    freeAST(root);
+    free(parser->lexer);
+    free(parser);
+    return prepared;
+}
+
+size_t snapshotPreparedProgram(const PreparedExecution *execution, const char *path) {
+    const VMProgram *bytecode = execution->program->bytecode;
+    return writeVMImage(bytecode, execution->context.stack, bytecode->functions[0].frameSize, path);
+}
+
+PreparedProgram *restorePreparedProgram(const char *path) {
+    const VMValue *snapshot = NULL;
+    VMProgram *bytecode = mapVMImage(path, &snapshot);
+    return initPreparedProgram(bytecode, snapshot);
+}
+
+int findPreparedInput(const PreparedProgram *program, const char *name) {
+    int global = findPreparedGlobal(program, name);
+    return global >= 0 ? program->bytecode->globals[global].input : -1;
+}
+
+int findPreparedGlobal(const PreparedProgram *program, const char *name) {
+    const VMProgram *bytecode = program->bytecode;
+
+    for (int global = bytecode->globalCount - 1; global >= 0; global--) {
+        if (strcmp(getVMString(bytecode, bytecode->globals[global].name), name) == 0) return global;
+    }
+
+    return -1;
+}
+
+PreparedExecution *initPreparedExecution(const PreparedProgram *program) {
+    PreparedExecution *execution = (PreparedExecution*) calloc(1, sizeof(PreparedExecution));
+    if (!execution) return NULL;
+
+    int inputCount = program->bytecode->inputCount;
+    execution->program = program;
+    execution->inputs = (VMValue*) calloc(inputCount + 1, sizeof(VMValue));
+    execution->isBound = (unsigned char*) calloc(inputCount + 1, 1);
+
+    if (!execution->inputs || !execution->isBound ||
+        !initVMContext(&execution->context, program->bytecode, VM_DEFAULT_STACK_SLOTS)) {
+        freePreparedExecution(execution);
+        return NULL;
+    }
+
+    // The stack is reserved as address space, which is only backed once it is reached, so it is not counted
+    addMetricCounter(METRIC_ALLOCATED_BYTES, sizeof(PreparedExecution) + (inputCount + 1) * (sizeof(VMValue) + 1));
+
+    return execution;
+}
+
+int bindPreparedInput(PreparedExecution *execution, int input, VMValue value) {
+    const VMProgram *bytecode = execution->program->bytecode;
+    if (input < 0 || input >= bytecode->inputCount) return 0;
+
+    int global = execution->program->inputGlobals[input];
+    if (bytecode->globals[global].type == IR_TYPE_BOOL) value.integer = value.integer != 0;
+
+    execution->inputs[input] = value;
+    if (!execution->isBound[input]) execution->boundCount++;
+    execution->isBound[input] = 1;
+    return 1;
+}
+
+int bindPreparedInputByName(PreparedExecution *execution, const char *name, VMValue value) {
+    return bindPreparedInput(execution, findPreparedInput(execution->program, name), value);
+}
+
+int executePreparedProgram(PreparedExecution *execution) {
+    const PreparedProgram *program = execution->program;
+    uint64_t start = getMetricNanoseconds();
+    int result = 1;
+
+    // The globals of a snapshot are those left by running the top-level statements once
+    if (program->snapshot) {
+        memcpy(execution->context.stack, program->snapshot,
+               program->bytecode->functions[0].frameSize * sizeof(VMValue));
+    } else if (execution->boundCount < program->bytecode->inputCount) {
+        execution->context.errorMessage = "An input has not been bound";
+        execution->context.errorLocation = (Location) {1, 1};
+        result = 0;
+    } else result = runVMProgram(&execution->context, execution->inputs);
+
+    observeMetricSince(METRIC_EXECUTION_SECONDS, &start);
+    addMetricCounter(METRIC_EXECUTIONS, 1);
+    if (!result) addMetricCounter(METRIC_EXECUTION_FAILURES, 1);
+    return result;
+}
+
+VMValue readPreparedGlobal(const PreparedExecution *execution, int global) {
+    return execution->context.stack[execution->program->bytecode->globals[global].slot];
+}
+
+const char *readPreparedString(const PreparedExecution *execution, int global) {
+    return getVMString(execution->program->bytecode, readPreparedGlobal(execution, global).integer);
+}
+
+void displayPreparedGlobals(const PreparedExecution *execution) {
+    const VMProgram *bytecode = execution->program->bytecode;
+
+    for (int global = 0; global < bytecode->globalCount; global++) {
+        const VMGlobal *declared = &bytecode->globals[global];
+        VMValue value = readPreparedGlobal(execution, global);
+
+        printf("[Result] %s %s: %s = ", declared->input >= 0 ? "input" : declared->isMutable ? "var" : "let",
+               getVMString(bytecode, declared->name), getIRTypeName((IRType) declared->type));
+
+        if (declared->type == IR_TYPE_FLOAT) printf("%g\n", value.floating);
+        else if (declared->type == IR_TYPE_BOOL) printf("%s\n", value.integer ? "true" : "false");
+        else if (declared->type == IR_TYPE_STRING) printf("\"%s\"\n", readPreparedString(execution, global));
+        else if (declared->type == IR_TYPE_UINT32) printf("%u\n", (uint32_t) value.integer);
+        else printf("%d\n", value.integer);
+    }
+}
+
+void freePreparedExecution(PreparedExecution *execution) {
+    if (!execution) return;
+
+    freeVMContext(&execution->context);
+    free(execution->inputs);
+    free(execution->isBound);
+    free(execution);
+}
+
+void freePreparedProgram(PreparedProgram *program) {
+    if (!program) return;
+
+    freeVMProgram(program->bytecode);
+    free(program->inputGlobals);
+    free(program);
+}
@@ -0,0 +1,551 @@
+// profile.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "profile.h"
+
+// The strings of a profile that are not the name of a function, in the order of its string table
+enum {
+    PROFILE_STRING_EMPTY,
+    PROFILE_STRING_ALLOC_FRAMES,
+    PROFILE_STRING_ALLOC_FRAME_BYTES,
+    PROFILE_STRING_INUSE_FRAMES,
+    PROFILE_STRING_INUSE_FRAME_BYTES,
+    PROFILE_STRING_COUNT_UNIT,
+    PROFILE_STRING_BYTES_UNIT,
+    PROFILE_STRING_FRAME_BYTES,
+    PROFILE_STRING_LIFETIME,
+    PROFILE_STRING_NANOSECONDS,
+    PROFILE_STRING_FILE,
+    PROFILE_STRING_FUNCTIONS,
+};
+
+static const char *profileStrings[] = {
+    "", "alloc_frames", "alloc_frame_bytes", "inuse_frames", "inuse_frame_bytes", "count", "bytes", "frame_bytes",
+    "lifetime", "nanoseconds",
+};
+
+/// A message of a profile being encoded, which grows as needed.
+typedef struct {
+    unsigned char *bytes;   /// The encoded bytes.
+    size_t length;          /// The number of bytes.
+    size_t capacity;        /// The allocated capacity of the bytes.
+    int isFailed;           /// Whether memory allocation has failed, so the message is incomplete.
+} ProfileBuffer;
+
+#ifndef _WIN32
+// The profile written on SIGUSR1, since a signal handler is given nothing but the signal
+static VMFrameProfile *volatile dumpedProfile = NULL;
+
+static void handleVMFrameDump(int signal) {
+    (void) signal;
+    if (dumpedProfile) dumpedProfile->isDumpRequested = 1;
+}
+#endif
+
+// Gets the time in seconds, which is only read when a frame is sampled or released
+static double getProfileSeconds(void) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double) now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Draws the number of bytes until the next sample from an exponential distribution whose mean is the interval, so
+// that the samples do not follow a pattern of the calls (as a fixed interval would with a recursion)
+static long drawVMFrameInterval(VMFrameProfile *profile) {
+    profile->random ^= profile->random << 13;
+    profile->random ^= profile->random >> 7;
+    profile->random ^= profile->random << 17;
+
+    double uniform = ((profile->random >> 11) + 1) * (1.0 / 9007199254740992.0);
+    long interval = (long) (-log(uniform) * profile->sampleBytes);
+    return interval > 0 ? interval : 1;
+}
+
+VMFrameProfile *initVMFrameProfile(const VMProgram *program, const char *sourcePath, long sampleBytes) {
+    VMFrameProfile *profile = (VMFrameProfile*) calloc(1, sizeof(VMFrameProfile));
+    if (!profile) return NULL;
+
+    profile->program = program;
+    profile->sourcePath = sourcePath;
+    profile->sampleBytes = sampleBytes > 0 ? sampleBytes : VM_PROFILE_SAMPLE_BYTES;
+    profile->random = (uint64_t) (getProfileSeconds() * 1e9) | 1;
+    profile->countdown = drawVMFrameInterval(profile);
+    profile->siteCapacity = 64;
+    profile->sites = (VMFrameSite*) calloc(profile->siteCapacity, sizeof(VMFrameSite));
+
+    if (!profile->sites) {
+        free(profile);
+        return NULL;
+    }
+
+    return profile;
+}
+
+// Hashes the instructions of a stack of calls
+static unsigned hashVMFrameStack(const VMFrameLocation *stack, int depth) {
+    unsigned hash = 2166136261u;
+    for (int index = 0; index < depth; index++) hash = (hash ^ (unsigned) stack[index].instruction) * 16777619u;
+    return hash;
+}
+
+// Finds the slot of a stack of calls among the sites, which is either the site of the stack or an empty slot
+static int findVMFrameSite(const VMFrameProfile *profile, const VMFrameSite *sites, int capacity,
+                           const VMFrameLocation *stack, int depth, unsigned hash) {
+    int slot = (int) (hash & (unsigned) (capacity - 1));
+
+    while (sites[slot].depth > 0 && (sites[slot].hash != hash || sites[slot].depth != depth ||
+           memcmp(&profile->locations[sites[slot].stack], stack, depth * sizeof(VMFrameLocation)) != 0)) {
+        slot = (slot + 1) & (capacity - 1);
+    }
+
+    return slot;
+}
+
+// Doubles the capacity of the sites, where the sampled frames refer to the slots of their sites
+static int growVMFrameSites(VMFrameProfile *profile) {
+    int capacity = profile->siteCapacity * 2;
+    VMFrameSite *sites = (VMFrameSite*) calloc(capacity, sizeof(VMFrameSite));
+    int *slots = (int*) malloc(profile->siteCapacity * sizeof(int));
+
+    if (!sites || !slots) {
+        free(sites);
+        free(slots);
+        return 0;
+    }
+
+    // The stacks of the sites are all different, so a site is moved into the first empty slot from its hash
+    for (int slot = 0; slot < profile->siteCapacity; slot++) {
+        const VMFrameSite *site = &profile->sites[slot];
+        if (site->depth == 0) continue;
+
+        int moved = (int) (site->hash & (unsigned) (capacity - 1));
+        while (sites[moved].depth > 0) moved = (moved + 1) & (capacity - 1);
+
+        slots[slot] = moved;
+        sites[moved] = *site;
+    }
+
+    for (int sample = 0; sample < profile->sampleCount; sample++) {
+        profile->samples[sample].site = slots[profile->samples[sample].site];
+    }
+
+    free(profile->sites);
+    free(slots);
+    profile->sites = sites;
+    profile->siteCapacity = capacity;
+    return 1;
+}
+
+// Makes room for a number of items in an array, which grows by doubling its capacity
+static int reserveVMFrameItems(void **items, int *capacity, int count, size_t itemSize) {
+    if (count <= *capacity) return 1;
+
+    int grown = *capacity ? *capacity : 64;
+    while (grown < count) grown *= 2;
+
+    void *reallocated = realloc(*items, grown * itemSize);
+    if (!reallocated) return 0;
+
+    *items = reallocated;
+    *capacity = grown;
+    return 1;
+}
+
+void sampleVMFrameCall(VMFrameProfile *profile, const VMContext *context, const VMFrame *frame) {
+    const VMProgram *program = profile->program;
+    const VMFunction *callee = &program->functions[frame->function];
+    long size = callee->frameSize * (long) sizeof(VMValue);
+
+    profile->countdown = drawVMFrameInterval(profile);
+
+    // The stack starts with the entry of the callee, then the instruction of each call outwards
+    VMFrameLocation stack[VM_PROFILE_MAX_DEPTH];
+    stack[0] = (VMFrameLocation) {callee->entry, frame->function};
+    int depth = 1;
+
+    for (const VMFrame *call = frame; call > context->frames && depth < VM_PROFILE_MAX_DEPTH; call--) {
+        stack[depth++] = (VMFrameLocation) {call->returnAddress - 1, (call - 1)->function};
+    }
+
+    if ((profile->siteCount + 1) * 4 > profile->siteCapacity * 3 && !growVMFrameSites(profile)) return;
+    if (!reserveVMFrameItems((void**) &profile->samples, &profile->sampleCapacity, profile->sampleCount + 1,
+                             sizeof(VMFrameSample))) return;
+
+    unsigned hash = hashVMFrameStack(stack, depth);
+    int slot = findVMFrameSite(profile, profile->sites, profile->siteCapacity, stack, depth, hash);
+    VMFrameSite *site = &profile->sites[slot];
+
+    if (site->depth == 0) {
+        if (!reserveVMFrameItems((void**) &profile->locations, &profile->locationCapacity,
+                                 profile->locationCount + depth, sizeof(VMFrameLocation))) return;
+
+        memcpy(&profile->locations[profile->locationCount], stack, depth * sizeof(VMFrameLocation));
+        *site = (VMFrameSite) {profile->locationCount, depth, hash, 0, 0, 0, 0, 0, 0, 0.0};
+        profile->locationCount += depth;
+        profile->siteCount++;
+    }
+
+    // A frame is sampled with a probability of 1 - exp(-size / interval), which a sample is scaled by
+    long count = lround(1.0 / (1.0 - exp(-(double) size / profile->sampleBytes)));
+    site->sampleCount++;
+    site->allocatedCount += count;
+    site->allocatedBytes += count * size;
+    site->liveCount += count;
+    site->liveBytes += count * size;
+
+    profile->samples[profile->sampleCount++] = (VMFrameSample) {(int32_t) (frame - context->frames), slot, count,
+                                                                count * size, getProfileSeconds()};
+
+    if (profile->isDumpRequested && profile->dumpPath) {
+        char path[1024];
+        profile->isDumpRequested = 0;
+        snprintf(path, sizeof(path), "%s.%d", profile->dumpPath, ++profile->dumpCount);
+
+        size_t written = writeVMFrameProfile(profile, path);
+        if (written > 0) printf("[FrameProfile] Wrote %zu bytes into '%s'.\n", written, path);
+    }
+}
+
+void releaseVMSampledFrames(VMFrameProfile *profile, int depth) {
+    double now = profile->sampleCount > 0 ? getProfileSeconds() : 0.0;
+
+    while (profile->sampleCount > 0 && profile->samples[profile->sampleCount - 1].depth >= depth) {
+        VMFrameSample *sample = &profile->samples[--profile->sampleCount];
+        VMFrameSite *site = &profile->sites[sample->site];
+
+        site->liveCount -= sample->count;
+        site->liveBytes -= sample->bytes;
+        site->releasedCount++;
+        site->lifetimeSeconds += now - sample->start;
+    }
+}
+
+void requestVMFrameDumps(VMFrameProfile *profile, const char *path) {
+    profile->dumpPath = path;
+
+#ifndef _WIN32
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleVMFrameDump;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+
+    dumpedProfile = profile;
+    sigaction(SIGUSR1, &action, NULL);
+#endif
+}
+
+// Appends bytes to a message, which grows as needed
+static void appendProfileBytes(ProfileBuffer *buffer, const void *bytes, size_t length) {
+    if (buffer->isFailed) return;
+
+    if (buffer->length + length > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+        while (buffer->length + length > capacity) capacity *= 2;
+
+        unsigned char *grown = (unsigned char*) realloc(buffer->bytes, capacity);
+
+        if (!grown) {
+            buffer->isFailed = 1;
+            return;
+        }
+
+        buffer->bytes = grown;
+        buffer->capacity = capacity;
+    }
+
+    if (length > 0) memcpy(buffer->bytes + buffer->length, bytes, length);
+    buffer->length += length;
+}
+
+// Appends a variable-length integer, 7 bits at a time from the lowest ones
+static void appendProfileVarint(ProfileBuffer *buffer, uint64_t value) {
+    unsigned char bytes[10];
+    size_t length = 0;
+
+    do {
+        bytes[length++] = (unsigned char) ((value & 0x7F) | (value > 0x7F ? 0x80 : 0));
+        value >>= 7;
+    } while (value > 0);
+
+    appendProfileBytes(buffer, bytes, length);
+}
+
+// Appends an integer field, where a negative integer is written as its 64-bit two's complement
+static void appendProfileInteger(ProfileBuffer *buffer, int field, int64_t value) {
+    appendProfileVarint(buffer, (uint64_t) field << 3);
+    appendProfileVarint(buffer, (uint64_t) value);
+}
+
+// Appends a field of bytes (a string, a message or packed integers), led by its length
+static void appendProfileField(ProfileBuffer *buffer, int field, const void *bytes, size_t length) {
+    appendProfileVarint(buffer, (uint64_t) field << 3 | 2);
+    appendProfileVarint(buffer, length);
+    appendProfileBytes(buffer, bytes, length);
+}
+
+// Appends a message as a field of another message, then clears it for the next message
+static void appendProfileMessage(ProfileBuffer *buffer, int field, ProfileBuffer *message) {
+    appendProfileField(buffer, field, message->bytes, message->length);
+    buffer->isFailed |= message->isFailed;
+    message->length = 0;
+}
+
+// Appends a ValueType message, which names a value of the samples and its unit
+static void appendProfileValueType(ProfileBuffer *buffer, int field, ProfileBuffer *message, int type, int unit) {
+    appendProfileInteger(message, 1, type);
+    appendProfileInteger(message, 2, unit);
+    appendProfileMessage(buffer, field, message);
+}
+
+size_t writeVMFrameProfile(const VMFrameProfile *profile, const char *path) {
+    const VMProgram *program = profile->program;
+    ProfileBuffer buffer = {0};
+    ProfileBuffer message = {0};
+    ProfileBuffer inner = {0};
+    unsigned char *isLocated = (unsigned char*) calloc(program->codeCount + 1, 1);
+    buffer.isFailed = !isLocated;
+
+    // The values of each sample, which count the frames on the stack of the virtual machine and their bytes
+    appendProfileValueType(&buffer, 1, &message, PROFILE_STRING_ALLOC_FRAMES, PROFILE_STRING_COUNT_UNIT);
+    appendProfileValueType(&buffer, 1, &message, PROFILE_STRING_ALLOC_FRAME_BYTES, PROFILE_STRING_BYTES_UNIT);
+    appendProfileValueType(&buffer, 1, &message, PROFILE_STRING_INUSE_FRAMES, PROFILE_STRING_COUNT_UNIT);
+    appendProfileValueType(&buffer, 1, &message, PROFILE_STRING_INUSE_FRAME_BYTES, PROFILE_STRING_BYTES_UNIT);
+
+    // A sample for each site, whose locations are its instructions from the innermost, identified from 1
+    for (int slot = 0; slot < profile->siteCapacity && isLocated; slot++) {
+        const VMFrameSite *site = &profile->sites[slot];
+        if (site->depth == 0) continue;
+
+        const VMFrameLocation *stack = &profile->locations[site->stack];
+
+        for (int index = 0; index < site->depth; index++) {
+            appendProfileVarint(&inner, (uint64_t) stack[index].instruction + 1);
+            isLocated[stack[index].instruction] = 1;
+        }
+
+        appendProfileMessage(&message, 1, &inner);
+        appendProfileVarint(&inner, (uint64_t) site->allocatedCount);
+        appendProfileVarint(&inner, (uint64_t) site->allocatedBytes);
+        appendProfileVarint(&inner, (uint64_t) site->liveCount);
+        appendProfileVarint(&inner, (uint64_t) site->liveBytes);
+        appendProfileMessage(&message, 2, &inner);
+
+        // The mean lifetime of the frames released so far is a numeric label of the sample
+        if (site->releasedCount > 0) {
+            appendProfileInteger(&inner, 1, PROFILE_STRING_LIFETIME);
+            appendProfileInteger(&inner, 3, (int64_t) (1e9 * site->lifetimeSeconds / site->releasedCount));
+            appendProfileInteger(&inner, 4, PROFILE_STRING_NANOSECONDS);
+            appendProfileMessage(&message, 3, &inner);
+        }
+
+        appendProfileMessage(&buffer, 2, &message);
+    }
+
+    // A single mapping holds the code, whose functions and lines are known, so pprof looks for no binary
+    const char *file = profile->sourcePath ? profile->sourcePath : "";
+    appendProfileInteger(&message, 1, 1);
+    appendProfileInteger(&message, 3, program->codeCount);
+    appendProfileInteger(&message, 5, PROFILE_STRING_FILE);
+    appendProfileInteger(&message, 7, 1);
+    appendProfileInteger(&message, 8, 1);
+    appendProfileInteger(&message, 9, 1);
+    appendProfileMessage(&buffer, 3, &message);
+
+    // A location for each instruction of a sample, whose line belongs to the function holding the instruction
+    for (int slot = 0; slot < profile->siteCapacity && isLocated; slot++) {
+        const VMFrameSite *site = &profile->sites[slot];
+        const VMFrameLocation *stack = &profile->locations[site->stack];
+
+        for (int index = 0; index < site->depth; index++) {
+            int instruction = stack[index].instruction;
+            if (isLocated[instruction] != 1) continue;
+
+            isLocated[instruction] = 2;
+            appendProfileInteger(&inner, 1, stack[index].function + 1);
+            appendProfileInteger(&inner, 2, program->locations[instruction].line);
+            appendProfileInteger(&inner, 3, program->locations[instruction].column);
+            appendProfileInteger(&message, 1, instruction + 1);
+            appendProfileInteger(&message, 2, 1);
+            appendProfileInteger(&message, 3, instruction);
+            appendProfileMessage(&message, 4, &inner);
+            appendProfileMessage(&buffer, 4, &message);
+        }
+    }
+
+    for (int function = 0; function < program->functionCount; function++) {
+        int entry = program->functions[function].entry;
+        appendProfileInteger(&message, 1, function + 1);
+        appendProfileInteger(&message, 2, PROFILE_STRING_FUNCTIONS + function);
+        appendProfileInteger(&message, 3, PROFILE_STRING_FUNCTIONS + function);
+        appendProfileInteger(&message, 4, PROFILE_STRING_FILE);
+        appendProfileInteger(&message, 5, entry < program->codeCount ? program->locations[entry].line : 0);
+        appendProfileMessage(&buffer, 5, &message);
+    }
+
+    // The string table, where the function 'f' is named by the string PROFILE_STRING_FUNCTIONS + f
+    for (int string = 0; string < PROFILE_STRING_FILE; string++) {
+        appendProfileField(&buffer, 6, profileStrings[string], strlen(profileStrings[string]));
+    }
+
+    appendProfileField(&buffer, 6, file, strlen(file));
+
+    for (int function = 0; function < program->functionCount; function++) {
+        const char *name = getVMString(program, program->functions[function].name);
+        appendProfileField(&buffer, 6, name, strlen(name));
+    }
+
+    // The time of the profile, its sampling interval in bytes of frames, and the value shown by default
+    appendProfileInteger(&buffer, 9, (int64_t) (getProfileSeconds() * 1e9));
+    appendProfileValueType(&buffer, 11, &message, PROFILE_STRING_FRAME_BYTES, PROFILE_STRING_BYTES_UNIT);
+    appendProfileInteger(&buffer, 12, profile->sampleBytes);
+    appendProfileInteger(&buffer, 14, PROFILE_STRING_ALLOC_FRAMES);
+
+    int result = !buffer.isFailed && !message.isFailed && !inner.isFailed;
+    FILE *output = result ? fopen(path, "wb") : NULL;
+    result = output && fwrite(buffer.bytes, 1, buffer.length, output) == buffer.length;
+    if (output) result = (fclose(output) == 0) && result;
+    if (!result) fprintf(stderr, "[AccessError]: File '%s' could not be written.\n", path);
+
+    size_t length = buffer.length;
+    free(buffer.bytes);
+    free(message.bytes);
+    free(inner.bytes);
+    free(isLocated);
+    return result ? length : 0;
+}
+
+// Displays the call sites with the largest of the given totals, where a call site is the innermost call of a stack
+static void displayVMFrameSites(const VMFrameProfile *profile, const long *counts, const long *bytes,
+                                const double *lifetimes, const long *releasedCounts, const int32_t *callees,
+                                const long *ranked, long total, const char *order) {
+    const VMProgram *program = profile->program;
+    unsigned char *isShown = (unsigned char*) calloc(program->codeCount + 1, 1);
+    if (!isShown) return;
+
+    printf("[FrameProfile] Top call sites by %s:\n", order);
+
+    for (int rank = 0; rank < VM_PROFILE_TOP_SITES; rank++) {
+        int top = -1;
+
+        for (int call = 0; call < program->codeCount; call++) {
+            if (ranked[call] > 0 && !isShown[call] && (top < 0 || ranked[call] > ranked[top])) top = call;
+        }
+
+        if (top < 0) break;
+
+        isShown[top] = 1;
+        Location location = program->locations[top];
+        const char *callee = getVMString(program, program->functions[callees[top]].name);
+        double lifetime = releasedCounts[top] > 0 ? 1e6 * lifetimes[top] / releasedCounts[top] : 0.0;
+
+        printf("[FrameProfile]   %10.2f KB %5.1f%% %10ld frames  %d:%d calling '%s', living %.2f us on average.\n",
+               bytes[top] / 1024.0, total > 0 ? 100.0 * ranked[top] / total : 0.0, counts[top], location.line,
+               location.column, callee, lifetime);
+    }
+
+    free(isShown);
+}
+
+void displayVMFrameProfile(const VMFrameProfile *profile) {
+    const VMProgram *program = profile->program;
+    int codeCount = program->codeCount + 1;
+    long *counts = (long*) calloc(codeCount, sizeof(long));
+    long *bytes = (long*) calloc(codeCount, sizeof(long));
+    long *releasedCounts = (long*) calloc(codeCount, sizeof(long));
+    double *lifetimes = (double*) calloc(codeCount, sizeof(double));
+    int32_t *callees = (int32_t*) calloc(codeCount, sizeof(int32_t));
+    long totalCount = 0, totalBytes = 0, sampleCount = 0;
+
+    if (!counts || !bytes || !releasedCounts || !lifetimes || !callees) {
+        free(counts); free(bytes); free(releasedCounts); free(lifetimes); free(callees);
+        return;
+    }
+
+    // The sites are merged by their innermost call, whatever the calls around it
+    for (int slot = 0; slot < profile->siteCapacity; slot++) {
+        const VMFrameSite *site = &profile->sites[slot];
+        if (site->depth < 2) continue;
+
+        int call = profile->locations[site->stack + 1].instruction;
+        counts[call] += site->allocatedCount;
+        bytes[call] += site->allocatedBytes;
+        releasedCounts[call] += site->releasedCount;
+        lifetimes[call] += site->lifetimeSeconds;
+        callees[call] = profile->locations[site->stack].function;
+        totalCount += site->allocatedCount;
+        totalBytes += site->allocatedBytes;
+        sampleCount += site->sampleCount;
+    }
+
+    printf("[FrameProfile] %ld frames of %.2f KB in total, estimated from %ld samples taken every %ld bytes.\n",
+           totalCount, totalBytes / 1024.0, sampleCount, profile->sampleBytes);
+    displayVMFrameSites(profile, counts, bytes, lifetimes, releasedCounts, callees, bytes, totalBytes, "bytes");
+    displayVMFrameSites(profile, counts, bytes, lifetimes, releasedCounts, callees, counts, totalCount, "frames");
+
+    free(counts);
+    free(bytes);
+    free(releasedCounts);
+    free(lifetimes);
+    free(callees);
+}
+
+void summarizeVMBranches(const VMProgram *program, const long *branchCounts, VMBranchSummary *summary) {
+    memset(summary, 0, sizeof(VMBranchSummary));
+
+    for (int index = 0; index < program->codeCount; index++) {
+        const VMInstruction *instruction = &program->code[index];
+        const long *counts = &branchCounts[2 * index];
+
+        // A switch is counted as a jump to its default case, and as a jump of its table otherwise
+        if (instruction->opcode == VM_JUMP || instruction->opcode == VM_SWITCH) {
+            summary->jumpCount += counts[0];
+            summary->takenCount += counts[0];
+        } else if (instruction->opcode == VM_BRANCH) {
+            summary->branchCount += counts[0] + counts[1];
+            if (instruction->targets[0] != index + 1) summary->takenCount += counts[0];
+            if (instruction->targets[1] != index + 1) summary->takenCount += counts[1];
+        }
+    }
+}
+
+int addVMBranchProfile(const VMProgram *program, const long *branchCounts, BranchProfile *profile) {
+    int result = 1;
+
+    // The code of each function follows the code of the function before it
+    for (int function = 0; function < program->functionCount && result; function++) {
+        const char *name = getVMString(program, program->functions[function].name);
+        int end = function + 1 < program->functionCount ? program->functions[function + 1].entry : program->codeCount;
+
+        for (int index = program->functions[function].entry; index < end && result; index++) {
+            if (program->code[index].opcode != VM_BRANCH) continue;
+            result = addBranchCount(profile, name, program->locations[index], branchCounts[2 * index],
+                                    branchCounts[2 * index + 1]);
+        }
+    }
+
+    return result;
+}
+
+void freeVMFrameProfile(VMFrameProfile *profile) {
+    if (!profile) return;
+
+#ifndef _WIN32
+    if (dumpedProfile == profile) {
+        signal(SIGUSR1, SIG_DFL);
+        dumpedProfile = NULL;
+    }
+#endif
+
+    free(profile->sites);
+    free(profile->locations);
+    free(profile->samples);
+    free(profile);
+}
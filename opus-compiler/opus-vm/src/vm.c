@@ -0,0 +1,421 @@
+// vm.c
+//
+// Created by Boyan Fan, 2026/10/18
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifndef _WIN32
+#include <signal.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#include "vm.h"
+#include "profile.h"
+
+#ifndef _WIN32
+// The context running on each thread, whose guard pages turn a fault into a stack overflow
+static _Thread_local VMContext *runningContext = NULL;
+
+// The handlers of the signals raised by a guard page before the virtual machine has installed its own
+static const int guardSignals[] = {SIGSEGV, SIGBUS};
+static struct sigaction previousActions[2];
+static atomic_int handlerState = 0;
+
+// Resumes the run hitting a guard page, where any other fault is handled as before once it is raised again
+static void handleVMGuardFault(int signal, siginfo_t *information, void *state) {
+    VMContext *context = runningContext;
+    const char *address = (const char*) information->si_addr;
+    (void) state;
+
+    if (context && ((address >= context->stackGuard && address < context->stackGuard + context->stackGuardSize) ||
+                    (address >= context->frameGuard && address < context->frameGuard + context->frameGuardSize))) {
+        siglongjmp(context->recovery, 1);
+    }
+
+    sigaction(signal, &previousActions[signal == SIGBUS], NULL);
+}
+
+// Installs the handler of the guard pages once for the whole process, however many threads initialize a context
+static void installVMGuardHandler(void) {
+    int expected = 0;
+
+    if (atomic_compare_exchange_strong(&handlerState, &expected, 1)) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = handleVMGuardFault;
+        action.sa_flags = SA_SIGINFO | SA_NODEFER;
+        sigemptyset(&action.sa_mask);
+
+        for (int index = 0; index < 2; index++) sigaction(guardSignals[index], &action, &previousActions[index]);
+        atomic_store(&handlerState, 2);
+    }
+
+    while (atomic_load(&handlerState) != 2) {}
+}
+
+// Reserves the address space of a region followed by its guard pages, where the region is backed once it is reached
+static char *mapVMRegion(size_t size, size_t guardSize) {
+    char *region = (char*) mmap(NULL, size + guardSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS |
+                                MAP_NORESERVE, -1, 0);
+    if (region == MAP_FAILED) return NULL;
+
+    if (mprotect(region + size, guardSize, PROT_NONE) != 0) {
+        munmap(region, size + guardSize);
+        return NULL;
+    }
+
+    return region;
+}
+#endif
+
+int initVMContext(VMContext *context, const VMProgram *program, int stackSlots) {
+    memset(context, 0, sizeof(VMContext));
+    context->program = program;
+    context->stackCapacity = stackSlots > 0 ? stackSlots : 1;
+    context->frameCapacity = VM_MAX_CALL_DEPTH;
+
+#ifndef _WIN32
+    // A call reads the slot right after the frame of its callee, so the guard pages outsize the largest frame
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    size_t largestFrame = 0;
+
+    for (int function = 0; function < program->functionCount; function++) {
+        size_t size = (program->functions[function].stackSize + 1) * sizeof(VMValue);
+        if (size > largestFrame) largestFrame = size;
+    }
+
+    size_t stackSize = (context->stackCapacity * sizeof(VMValue) + pageSize - 1) / pageSize * pageSize;
+    size_t frameSize = (context->frameCapacity * sizeof(VMFrame) + pageSize - 1) / pageSize * pageSize;
+    context->stackGuardSize = (largestFrame + pageSize - 1) / pageSize * pageSize + pageSize;
+    context->frameGuardSize = pageSize;
+
+    installVMGuardHandler();
+    context->stack = (VMValue*) mapVMRegion(stackSize, context->stackGuardSize);
+    context->frames = (VMFrame*) mapVMRegion(frameSize, context->frameGuardSize);
+    if (context->stack) context->stackGuard = (char*) context->stack + stackSize;
+    if (context->frames) context->frameGuard = (char*) context->frames + frameSize;
+#else
+    context->stack = (VMValue*) calloc(context->stackCapacity, sizeof(VMValue));
+    context->frames = (VMFrame*) malloc(context->frameCapacity * sizeof(VMFrame));
+#endif
+
+    if (!context->stack || !context->frames) {
+        freeVMContext(context);
+        return 0;
+    }
+
+    return 1;
+}
+
+// Interprets the program until the entry function returns or an instruction fails
+static int interpretVMProgram(VMContext *context, const VMValue *inputs) {
+    const VMProgram *program = context->program;
+    const VMInstruction *code = program->code;
+    const VMFunction *functions = program->functions;
+    VMValue *stack = context->stack;
+    VMFrame *frame = context->frames;
+    VMFrameProfile *profile = context->frameProfile;
+    long *branchCounts = context->branchCounts;
+#ifdef _WIN32
+    VMFrame *lastFrame = context->frames + context->frameCapacity - 1;
+#endif
+    int pc = functions[0].entry;
+
+    context->errorMessage = NULL;
+
+    // Every run starts from an entry frame cleared of the globals left by the previous run
+    if (functions[0].stackSize > context->stackCapacity) {
+        context->errorMessage = "Stack overflow";
+        context->errorLocation = program->codeCount > 0 ? program->locations[pc] : (Location) {1, 1};
+        return 0;
+    }
+
+    memset(stack, 0, functions[0].frameSize * sizeof(VMValue));
+    *frame = (VMFrame) {0, 0, -1, VM_NO_SLOT};
+    context->activeFrame = frame;
+
+    VMValue *slots = stack;
+    int frameSize = functions[0].frameSize;
+
+    // The slots of the instruction being executed, where 'a' and 'b' are the operands and 'd' is the destination
+    #define A slots[instruction->operands[0]]
+    #define B slots[instruction->operands[1]]
+    #define D slots[instruction->destination]
+    #define IMMEDIATE instruction->immediate.integer
+    #define OVERFLOW "Integer overflow"
+
+    // Stops the run at the instruction being executed
+    #define FAIL(message) do {                                   \
+        context->errorMessage = (message);                       \
+        context->errorLocation = program->locations[pc - 1];     \
+        return 0;                                                \
+    } while (0)
+
+    for (;;) {
+        const VMInstruction *instruction = &code[pc++];
+
+        switch ((VMOpcode) instruction->opcode) {
+            case VM_CONSTANT: D = instruction->immediate; break;
+            case VM_COPY: D = A; break;
+            case VM_CONVERT: D.floating = (float) A.integer; break;
+            case VM_CONVERT_UINT: D.floating = (float) (uint32_t) A.integer; break;
+            case VM_INPUT: D = inputs[IMMEDIATE]; break;
+            case VM_LOAD_GLOBAL: D = stack[IMMEDIATE]; break;
+            case VM_STORE_GLOBAL: stack[IMMEDIATE] = A; break;
+
+            // Int arithmetic wraps around, which is computed on unsigned integers since a signed overflow is undefined
+            case VM_ADD_INT: D.integer = (int32_t) ((uint32_t) A.integer + (uint32_t) B.integer); break;
+            case VM_ADD_FLOAT: D.floating = A.floating + B.floating; break;
+            case VM_SUBTRACT_INT: D.integer = (int32_t) ((uint32_t) A.integer - (uint32_t) B.integer); break;
+            case VM_SUBTRACT_FLOAT: D.floating = A.floating - B.floating; break;
+            case VM_MULTIPLY_INT: D.integer = (int32_t) ((uint32_t) A.integer * (uint32_t) B.integer); break;
+            case VM_MULTIPLY_FLOAT: D.floating = A.floating * B.floating; break;
+
+            case VM_DIVIDE_INT: {
+                if (B.integer == 0) FAIL("Division by zero");
+                D.integer = B.integer == -1 ? (int32_t) (0u - (uint32_t) A.integer) : A.integer / B.integer;
+                break;
+            }
+
+            case VM_MODULO_INT: {
+                if (B.integer == 0) FAIL("Division by zero");
+                D.integer = B.integer == -1 ? 0 : A.integer % B.integer;
+                break;
+            }
+
+            // A UInt32 is held by the bits of an Int, which are divided as unsigned
+            case VM_DIVIDE_UINT: {
+                if (B.integer == 0) FAIL("Division by zero");
+                D.integer = (int32_t) ((uint32_t) A.integer / (uint32_t) B.integer);
+                break;
+            }
+
+            case VM_MODULO_UINT: {
+                if (B.integer == 0) FAIL("Division by zero");
+                D.integer = (int32_t) ((uint32_t) A.integer % (uint32_t) B.integer);
+                break;
+            }
+
+            case VM_DIVIDE_FLOAT: D.floating = A.floating / B.floating; break;
+            case VM_MODULO_FLOAT: D.floating = fmodf(A.floating, B.floating); break;
+            case VM_NEGATE_INT: D.integer = (int32_t) (0u - (uint32_t) A.integer); break;
+            case VM_NEGATE_FLOAT: D.floating = -A.floating; break;
+            case VM_NOT: D.integer = !A.integer; break;
+
+            case VM_FACTORIAL: {
+                uint32_t product = 1;
+                for (int32_t term = 2; term <= A.integer; term++) product *= (uint32_t) term;
+                D.integer = (int32_t) product;
+                break;
+            }
+
+            // A checked Int operation fails on overflow, where the builtins branch on the overflow flag of the machine
+            case VM_ADD_INT_CHECKED: {
+                if (__builtin_add_overflow(A.integer, B.integer, &D.integer)) FAIL(OVERFLOW);
+                break;
+            }
+
+            case VM_SUBTRACT_INT_CHECKED: {
+                if (__builtin_sub_overflow(A.integer, B.integer, &D.integer)) FAIL(OVERFLOW);
+                break;
+            }
+
+            case VM_MULTIPLY_INT_CHECKED: {
+                if (__builtin_mul_overflow(A.integer, B.integer, &D.integer)) FAIL(OVERFLOW);
+                break;
+            }
+
+            case VM_DIVIDE_INT_CHECKED: {
+                if (B.integer == 0) FAIL("Division by zero");
+                if (B.integer == -1 && A.integer == INT32_MIN) FAIL(OVERFLOW);
+                D.integer = A.integer / B.integer;
+                break;
+            }
+
+            case VM_NEGATE_INT_CHECKED: {
+                if (__builtin_sub_overflow(0, A.integer, &D.integer)) FAIL(OVERFLOW);
+                break;
+            }
+
+            case VM_FACTORIAL_CHECKED: {
+                int32_t product = 1;
+
+                for (int32_t term = 2; term <= A.integer; term++) {
+                    if (__builtin_mul_overflow(product, term, &product)) FAIL(OVERFLOW);
+                }
+
+                D.integer = product;
+                break;
+            }
+
+            case VM_SHIFT_LEFT: D.integer = (int32_t) ((uint32_t) A.integer << IMMEDIATE); break;
+            case VM_SHIFT_RIGHT: D.integer = A.integer >> IMMEDIATE; break;
+            case VM_SHIFT_RIGHT_LOGICAL: D.integer = (int32_t) ((uint32_t) A.integer >> IMMEDIATE); break;
+            case VM_BITWISE_AND: D.integer = A.integer & IMMEDIATE; break;
+            case VM_MULTIPLY_HIGH: D.integer = (int32_t) (((int64_t) A.integer * IMMEDIATE) >> 32); break;
+
+            // A value below the first value of the mask wraps around to a large bit, so a single test bounds it
+            case VM_BIT_TEST: {
+                uint32_t bit = (uint32_t) A.integer - (uint32_t) B.integer;
+                D.integer = bit < 32 && ((uint32_t) IMMEDIATE >> bit) & 1;
+                break;
+            }
+
+            case VM_STRING_HASH: D.integer = hashIRString(getVMString(program, A.integer), IMMEDIATE); break;
+
+            case VM_EQUAL_INT: D.integer = A.integer == B.integer; break;
+            case VM_EQUAL_FLOAT: D.integer = A.floating == B.floating; break;
+            case VM_NOT_EQUAL_INT: D.integer = A.integer != B.integer; break;
+            case VM_NOT_EQUAL_FLOAT: D.integer = A.floating != B.floating; break;
+            case VM_LESS_THAN_INT: D.integer = A.integer < B.integer; break;
+            case VM_LESS_THAN_FLOAT: D.integer = A.floating < B.floating; break;
+            case VM_LESS_OR_EQUAL_INT: D.integer = A.integer <= B.integer; break;
+            case VM_LESS_OR_EQUAL_FLOAT: D.integer = A.floating <= B.floating; break;
+            case VM_GREATER_THAN_INT: D.integer = A.integer > B.integer; break;
+            case VM_GREATER_THAN_FLOAT: D.integer = A.floating > B.floating; break;
+            case VM_GREATER_OR_EQUAL_INT: D.integer = A.integer >= B.integer; break;
+            case VM_GREATER_OR_EQUAL_FLOAT: D.integer = A.floating >= B.floating; break;
+            case VM_LESS_THAN_UINT: D.integer = (uint32_t) A.integer < (uint32_t) B.integer; break;
+            case VM_LESS_OR_EQUAL_UINT: D.integer = (uint32_t) A.integer <= (uint32_t) B.integer; break;
+            case VM_GREATER_THAN_UINT: D.integer = (uint32_t) A.integer > (uint32_t) B.integer; break;
+            case VM_GREATER_OR_EQUAL_UINT: D.integer = (uint32_t) A.integer >= (uint32_t) B.integer; break;
+
+            // The comparison is counted from IR_EQUAL, in the same order as the operations of the IR
+            case VM_COMPARE_STRING: {
+                int order = strcmp(getVMString(program, A.integer), getVMString(program, B.integer));
+                int results[] = {order == 0, order != 0, order < 0, order <= 0, order > 0, order >= 0};
+                D.integer = results[IMMEDIATE];
+                break;
+            }
+
+            // An argument is written right after the frame, where the frame of the callee starts, unless it has been
+            // computed right there (see assignFrameSlots()), so only an argument held by a variable is copied
+            case VM_ARGUMENT: slots[frameSize + IMMEDIATE] = A; break;
+
+            // The lanes of a returned vector are left past the frame of the callee, as if they were its arguments
+            case VM_RESULT: D = slots[frameSize + IMMEDIATE]; break;
+
+            case VM_CALL: {
+                const VMFunction *callee = &functions[IMMEDIATE];
+                int base = frame->base + frameSize;
+
+#ifndef _WIN32
+                // Reading past the frame of the callee runs into a guard page once the stack is exhausted
+                (void) *(volatile int32_t*) &stack[base + callee->stackSize].integer;
+#else
+                if (frame == lastFrame || base + callee->stackSize > context->stackCapacity) FAIL("Stack overflow");
+#endif
+
+                *++frame = (VMFrame) {IMMEDIATE, base, pc, instruction->destination};
+                context->activeFrame = frame;
+                context->callCount++;
+                slots = stack + base;
+                frameSize = callee->frameSize;
+                pc = callee->entry;
+
+                // A profiled call is sampled once the frames allocated since the last sample exceed the interval
+                if (profile && (profile->countdown -= frameSize * (long) sizeof(VMValue)) < 0) {
+                    sampleVMFrameCall(profile, context, frame);
+                }
+                break;
+            }
+
+            case VM_JUMP: {
+                if (branchCounts) branchCounts[2 * (pc - 1)]++;
+                pc = instruction->targets[0];
+                break;
+            }
+
+            case VM_BRANCH: {
+                if (branchCounts) branchCounts[2 * (pc - 1) + !A.integer]++;
+                pc = A.integer ? instruction->targets[0] : instruction->targets[1];
+                break;
+            }
+
+            // The jumps of the table follow the switch, and a value outside of the table goes to the default case
+            case VM_SWITCH: {
+                uint32_t entry = (uint32_t) A.integer - (uint32_t) IMMEDIATE;
+                const VMInstruction *target = entry < (uint32_t) instruction->targets[1] ? &code[pc + entry]
+                                                                                          : instruction;
+                if (branchCounts) branchCounts[2 * (target - code)]++;
+                pc = target->targets[0];
+                break;
+            }
+
+            // Returning from the entry function ends the run, leaving the globals at the bottom of the stack
+            case VM_RETURN: {
+                if (frame == context->frames) return 1;
+
+                VMValue value = {0};
+                if (instruction->operands[0] != VM_NO_SLOT) value = A;
+
+                int depth = (int) (frame - context->frames);
+                if (profile && profile->sampleCount > 0 && profile->samples[profile->sampleCount - 1].depth == depth) {
+                    releaseVMSampledFrames(profile, depth);
+                }
+
+                int destination = frame->destination;
+                pc = frame->returnAddress;
+                context->activeFrame = --frame;
+                slots = stack + frame->base;
+                frameSize = functions[frame->function].frameSize;
+                if (destination != VM_NO_SLOT) slots[destination] = value;
+                break;
+            }
+
+            default: FAIL("Invalid instruction");
+        }
+    }
+
+    #undef A
+    #undef B
+    #undef D
+    #undef IMMEDIATE
+    #undef OVERFLOW
+    #undef FAIL
+}
+
+int runVMProgram(VMContext *context, const VMValue *inputs) {
+#ifndef _WIN32
+    // A stack overflow runs into a guard page, which resumes here with the call being executed
+    runningContext = context;
+
+    if (sigsetjmp(context->recovery, 0)) {
+        const VMProgram *program = context->program;
+        int call = context->activeFrame->returnAddress - 1;
+        runningContext = NULL;
+        if (context->frameProfile) releaseVMSampledFrames(context->frameProfile, 0);
+        context->errorMessage = "Stack overflow";
+        context->errorLocation = program->locations[call >= 0 ? call : program->functions[0].entry];
+        return 0;
+    }
+
+    int result = interpretVMProgram(context, inputs);
+    runningContext = NULL;
+#else
+    int result = interpretVMProgram(context, inputs);
+#endif
+
+    // The frames of a run that has failed are released along with it
+    if (context->frameProfile) releaseVMSampledFrames(context->frameProfile, 0);
+    return result;
+}
+
+void freeVMContext(VMContext *context) {
+#ifndef _WIN32
+    if (runningContext == context) runningContext = NULL;
+    char *stack = (char*) context->stack;
+    char *frames = (char*) context->frames;
+    if (stack) munmap(stack, context->stackGuard + context->stackGuardSize - stack);
+    if (frames) munmap(frames, context->frameGuard + context->frameGuardSize - frames);
+#else
+    free(context->stack);
+    free(context->frames);
+#endif
+    context->stack = NULL;
+    context->frames = NULL;
+    context->stackCapacity = context->frameCapacity = 0;
+}